@@ -0,0 +1,178 @@
+/*!
+ *****************************************************************************
+   @file:    adi_ble_beacon.h
+   @brief:   Sensor beacon frames carried in advertising data
+   @details: Frame layout and public function prototypes
+  -----------------------------------------------------------------------------
+
+Copyright (c) 2026 Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  - Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  - Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  - Modified versions of the software must be conspicuously marked as such.
+  - This software is licensed solely and exclusively for use with processors
+    manufactured by or for Analog Devices, Inc.
+  - This software may not be combined or merged with other code in any manner
+    that would cause the software to become subject to terms and conditions
+    which differ from those listed here.
+  - Neither the name of Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+  - The use of this software may or may not infringe the patent rights of one
+    or more patent holders.  This license does not release you from the
+    requirement that you obtain separate licenses from these patent holders
+    to use this software.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. AND CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+TITLE, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+NO EVENT SHALL ANALOG DEVICES, INC. OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, PUNITIVE OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, DAMAGES ARISING OUT OF CLAIMS OF INTELLECTUAL
+PROPERTY RIGHTS INFRINGEMENT; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+/** @addtogroup adi_beacon Sensor Beacon Interface
+ *  @ingroup Utilities
+ *  @{
+ *
+ *  @brief Sensor Beacon Interface
+ *  @details  Sensor readings broadcast without a connection. A frame is
+ *            carried in the service data (UUID ADI_CFG_BEACON_UUID) or in
+ *            the manufacturer specific data (company ADI_CFG_BEACON_COMPANY_ID)
+ *            of an advertising packet:
+ *
+ *            version (high nibble) and number of values (low nibble),
+ *            sequence number, then per value its ADI_BEACON_VALUE_TYPE and
+ *            a signed 16 bit little endian value.
+ *
+ *            The functions do not use the radio, so they can be built and
+ *            exercised on a host. Time is counted in caller defined ticks.
+ */
+
+#ifndef ADI_BLE_BEACON_H
+#define ADI_BLE_BEACON_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*! 16 bit service UUID of the service data frames. */
+#ifndef ADI_CFG_BEACON_UUID
+#define ADI_CFG_BEACON_UUID             (0xFFF0u)
+#endif
+
+/*! Company id of the manufacturer specific data frames, 0xFFFF is reserved for testing. */
+#ifndef ADI_CFG_BEACON_COMPANY_ID
+#define ADI_CFG_BEACON_COMPANY_ID       (0xFFFFu)
+#endif
+
+/*! Version of the frame layout. */
+#define ADI_BEACON_VERSION              (1u)
+/*! Size of the frame header, version and count plus sequence number. */
+#define ADI_BEACON_HEADER_SIZE          (2u)
+/*! Size of one value, type and 16 bit value. */
+#define ADI_BEACON_VALUE_SIZE           (3u)
+/*! Values that fit a legacy 31 byte advertising packet next to the flags. */
+#define ADI_BEACON_MAX_VALUES           (7u)
+
+/*!
+ *  @enum ADI_BEACON_RESULT
+ *
+ *  @brief  Result of the beacon functions.
+ */
+typedef enum
+{
+    ADI_BEACON_SUCCESS   = 0,       /*!< A frame was found and decoded.                   */
+    ADI_BEACON_NO_FRAME  = 1,       /*!< The packet holds no sensor beacon frame.         */
+    ADI_BEACON_MALFORMED = 2        /*!< Bad advertising structure or frame layout.       */
+} ADI_BEACON_RESULT;
+
+/*!
+ *  @enum ADI_BEACON_VALUE_TYPE
+ *
+ *  @brief  Quantity and scale of a value.
+ */
+typedef enum
+{
+    ADI_BEACON_VALUE_TEMPERATURE = 1u,  /*!< Temperature in 0.01 degC.        */
+    ADI_BEACON_VALUE_ACCEL_X     = 2u,  /*!< Acceleration in mg.              */
+    ADI_BEACON_VALUE_ACCEL_Y     = 3u,  /*!< Acceleration in mg.              */
+    ADI_BEACON_VALUE_ACCEL_Z     = 4u,  /*!< Acceleration in mg.              */
+    ADI_BEACON_VALUE_GAS         = 5u,  /*!< Gas concentration in 0.1 ppm.    */
+    ADI_BEACON_VALUE_HUMIDITY    = 6u,  /*!< Relative humidity in 0.01 %.     */
+    ADI_BEACON_VALUE_BATTERY     = 7u   /*!< Supply voltage in mV.            */
+} ADI_BEACON_VALUE_TYPE;
+
+/*!
+ *  @struct ADI_BEACON_VALUE
+ *
+ *  @brief  One reading of a frame.
+ */
+typedef struct
+{
+    uint8_t     nType;              /*!< ADI_BEACON_VALUE_TYPE of the reading.                */
+    int16_t     nValue;             /*!< Reading in the unit of its type.                     */
+} ADI_BEACON_VALUE;
+
+/*!
+ *  @struct ADI_BEACON_FRAME
+ *
+ *  @brief  Decoded sensor beacon frame.
+ */
+typedef struct
+{
+    uint8_t           nSeq;                             /*!< Sequence number, wraps at 256. */
+    uint8_t           nNumValues;                       /*!< Valid entries of aValues.      */
+    ADI_BEACON_VALUE  aValues[ADI_BEACON_MAX_VALUES];   /*!< Readings.                      */
+} ADI_BEACON_FRAME;
+
+/*!
+ *  @struct ADI_BEACON_ADDR
+ *
+ *  @brief  Address of the broadcaster, same layout as ADI_BLER_CONFIG_ADDR.
+ */
+typedef struct
+{
+    uint8_t     aBD_ADDR[6u];       /*!< Bluetooth address.                                   */
+    uint8_t     nAddrType;          /*!< Public or random address.                            */
+} ADI_BEACON_ADDR;
+
+/*!
+ *  @struct ADI_BEACON_SCHED
+ *
+ *  @brief  Update schedule of a broadcaster.
+ */
+typedef struct
+{
+    uint32_t    nInterval;          /*!< Ticks between two updates.                           */
+    uint32_t    nNext;              /*!< Time of the next update.                             */
+    uint32_t    nSkipped;           /*!< Updates dropped because the caller was late.         */
+} ADI_BEACON_SCHED;
+
+ADI_BEACON_RESULT adi_beacon_Decode     (const uint8_t *pAdvData, const uint32_t nLen, ADI_BEACON_FRAME *pFrame);
+uint32_t          adi_beacon_Encode     (const ADI_BEACON_FRAME *pFrame, uint8_t *pData, const uint32_t nSize);
+int16_t           adi_beacon_FromFloat  (const float fValue, const float fLsb);
+void              adi_beacon_SchedInit  (ADI_BEACON_SCHED *pSched, const uint32_t nInterval, const uint32_t nNow);
+uint32_t          adi_beacon_SchedWait  (ADI_BEACON_SCHED *pSched, const uint32_t nNow);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ADI_BLE_BEACON_H */
+/* @} */
@@ -0,0 +1,90 @@
+/*!
+ *****************************************************************************
+   @file:    adi_ble_broadcast.h
+   @brief:   Connectionless broadcast of sensor beacon frames
+   @details: Public function prototypes and configuration
+  -----------------------------------------------------------------------------
+
+Copyright (c) 2026 Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  - Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  - Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  - Modified versions of the software must be conspicuously marked as such.
+  - This software is licensed solely and exclusively for use with processors
+    manufactured by or for Analog Devices, Inc.
+  - This software may not be combined or merged with other code in any manner
+    that would cause the software to become subject to terms and conditions
+    which differ from those listed here.
+  - Neither the name of Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+  - The use of this software may or may not infringe the patent rights of one
+    or more patent holders.  This license does not release you from the
+    requirement that you obtain separate licenses from these patent holders
+    to use this software.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. AND CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+TITLE, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+NO EVENT SHALL ANALOG DEVICES, INC. OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, PUNITIVE OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, DAMAGES ARISING OUT OF CLAIMS OF INTELLECTUAL
+PROPERTY RIGHTS INFRINGEMENT; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+/** @addtogroup adi_broadcast Beacon Broadcast Interface
+ *  @ingroup Utilities
+ *  @{
+ *
+ *  @brief Beacon Broadcast Interface
+ *  @details  Broadcaster role that carries sensor beacon frames in the
+ *            service data of its advertising packets, so readings reach any
+ *            observer without a connection. The sequence number is kept
+ *            here and increments with every update. Between two updates
+ *            the core sleeps on the RTC of adi_RTCInit().
+ */
+
+#ifndef ADI_BLE_BROADCAST_H
+#define ADI_BLE_BROADCAST_H
+
+#include <stdint.h>
+#include <radio/adi_ble_radio.h>
+#include <beacon/adi_ble_beacon.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*! Advertising interval in 0.625 ms slots, 0x00A0 (100 ms) to 0x4000 (10.24 s). */
+#ifndef ADI_CFG_BROADCAST_ADV_INTERVAL
+#define ADI_CFG_BROADCAST_ADV_INTERVAL  (0x0640u)
+#endif
+
+/*! Frequency of the RTC of adi_RTCInit() in Hz, used to convert update periods to ticks. */
+#ifndef ADI_CFG_BROADCAST_TICK_HZ
+#define ADI_CFG_BROADCAST_TICK_HZ       (1024u)
+#endif
+
+ADI_BLER_RESULT adi_broadcast_Start   (ADI_BEACON_FRAME *pFrame, const uint16_t nAdvInterval);
+ADI_BLER_RESULT adi_broadcast_Update  (ADI_BEACON_FRAME *pFrame);
+ADI_BLER_RESULT adi_broadcast_Stop    (void);
+void            adi_broadcast_Sleep   (ADI_BEACON_SCHED *pSched);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ADI_BLE_BROADCAST_H */
+/* @} */
@@ -0,0 +1,140 @@
+/*!
+ *****************************************************************************
+   @file:    adi_ble_observer.h
+   @brief:   Aggregation of sensor beacons received in observer mode
+   @details: Public function prototypes and batch reading layout
+  -----------------------------------------------------------------------------
+
+Copyright (c) 2026 Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  - Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  - Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  - Modified versions of the software must be conspicuously marked as such.
+  - This software is licensed solely and exclusively for use with processors
+    manufactured by or for Analog Devices, Inc.
+  - This software may not be combined or merged with other code in any manner
+    that would cause the software to become subject to terms and conditions
+    which differ from those listed here.
+  - Neither the name of Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+  - The use of this software may or may not infringe the patent rights of one
+    or more patent holders.  This license does not release you from the
+    requirement that you obtain separate licenses from these patent holders
+    to use this software.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. AND CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+TITLE, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+NO EVENT SHALL ANALOG DEVICES, INC. OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, PUNITIVE OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, DAMAGES ARISING OUT OF CLAIMS OF INTELLECTUAL
+PROPERTY RIGHTS INFRINGEMENT; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+/** @addtogroup adi_observer Beacon Observer Interface
+ *  @ingroup Utilities
+ *  @{
+ *
+ *  @brief Beacon Observer Interface
+ *  @details  Fixed size table of the sensor beacons heard by an observer.
+ *            Frames are deduplicated by sequence number, RSSI is averaged
+ *            and readings are averaged per broadcaster until the next batch
+ *            is flushed. Broadcasters that stay silent are expired. Time is
+ *            passed in by the caller, so the table also runs on a host.
+ */
+
+#ifndef ADI_BLE_OBSERVER_H
+#define ADI_BLE_OBSERVER_H
+
+#include <stdint.h>
+#include <beacon/adi_ble_beacon.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*! Number of broadcasters tracked at the same time. */
+#ifndef ADI_CFG_OBSERVER_NUM_ENTRIES
+#define ADI_CFG_OBSERVER_NUM_ENTRIES    (16u)
+#endif
+
+/*! Frequency of the time passed to the observer functions in Hz, the RTC of adi_RTCInit() gives 1024 Hz. */
+#ifndef ADI_CFG_OBSERVER_TICK_HZ
+#define ADI_CFG_OBSERVER_TICK_HZ        (1024u)
+#endif
+
+/*! Seconds without a frame after which a broadcaster is dropped. */
+#ifndef ADI_CFG_OBSERVER_STALE_SEC
+#define ADI_CFG_OBSERVER_STALE_SEC      (60u)
+#endif
+
+/*! Weight of a new RSSI sample in the average, 1 / 2^n. */
+#ifndef ADI_CFG_OBSERVER_RSSI_SHIFT
+#define ADI_CFG_OBSERVER_RSSI_SHIFT     (3u)
+#endif
+
+/*! Minimum size of a GAP_EVENT_OBS_MODE_DATA payload, same as ADI_BLER_OBSERVER_DATA_MIN_SIZE. */
+#define ADI_OBSERVER_EVENT_MIN_SIZE     (9u)
+
+/*!
+ *  @struct ADI_OBSERVER_READING
+ *
+ *  @brief  Summary of one broadcaster, passed to the batch function.
+ */
+typedef struct
+{
+    ADI_BEACON_ADDR   sAddr;                            /*!< Broadcaster address.                    */
+    int8_t            nRssi;                            /*!< Averaged RSSI in dBm.                   */
+    uint8_t           nSeq;                             /*!< Sequence number of the last frame.      */
+    uint16_t          nFrames;                          /*!< New frames in this batch.               */
+    uint16_t          nMissed;                          /*!< Frames lost to sequence gaps.           */
+    uint32_t          nAge;                             /*!< Ticks since the last frame.             */
+    uint8_t           nNumValues;                       /*!< Valid entries of aValues.               */
+    ADI_BEACON_VALUE  aValues[ADI_BEACON_MAX_VALUES];   /*!< Readings averaged over the batch.       */
+} ADI_OBSERVER_READING;
+
+/*!
+ *  @struct ADI_OBSERVER_STATS
+ *
+ *  @brief  Observer counters.
+ */
+typedef struct
+{
+    uint32_t    nReports;           /*!< Advertising reports received.                        */
+    uint32_t    nFrames;            /*!< New sensor beacon frames.                            */
+    uint32_t    nDuplicates;        /*!< Frames received again with the same sequence number. */
+    uint32_t    nForeign;           /*!< Reports without a sensor beacon frame.               */
+    uint32_t    nMalformed;         /*!< Reports with a broken frame.                         */
+    uint32_t    nEvicted;           /*!< Broadcasters dropped to make room for a new one.     */
+    uint32_t    nExpired;           /*!< Broadcasters dropped for being silent.               */
+} ADI_OBSERVER_STATS;
+
+/*! Function receiving the readings of a batch, e.g. a UART print or a Wi-Fi publish. */
+typedef void (*ADI_OBSERVER_BATCH_FN)(const ADI_OBSERVER_READING *pReading, void *pParam);
+
+void adi_observer_Init(void);
+ADI_BEACON_RESULT adi_observer_Report(const ADI_BEACON_ADDR *pAddr, const int8_t nRssi, const uint8_t *pAdvData, const uint32_t nLen, const uint32_t nNow);
+ADI_BEACON_RESULT adi_observer_ReportEvent(const uint8_t *pParam, const uint32_t nLen, const uint32_t nNow);
+uint32_t adi_observer_Expire(const uint32_t nNow);
+uint32_t adi_observer_Flush(ADI_OBSERVER_BATCH_FN pfBatch, void *pParam, const uint32_t nNow);
+void adi_observer_GetStats(ADI_OBSERVER_STATS *pStats);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ADI_BLE_OBSERVER_H */
+/* @} */
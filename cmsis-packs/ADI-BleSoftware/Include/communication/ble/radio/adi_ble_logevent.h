@@ -172,16 +172,14 @@ typedef enum
 
 #if (ADI_CFG_BLE_LOGEVENT == 1)
 #include <stdint.h>
+#include <common/adi_trace.h>
 
 void adi_ble_LogEvent(const ADI_BLE_LOG_ID event);
 void adi_ble_LogEventData(const ADI_BLE_LOG_ID event,const uint32_t data);
 
-#define ADI_BLE_LOGEVENT(event)             adi_ble_LogEvent(event)
-#define ADI_BLE_LOGEVENT_DATA(event,data)   adi_ble_LogEventData(event,data);
-
-static inline uint32_t ADI_BLE_GET_TIMESTAMP()   {
-     return 0;
-   } // FIXME
+/* Trace points go straight to the shared trace buffer */
+#define ADI_BLE_LOGEVENT(event)             adi_trace_Event(ADI_TRACE_MODULE_BLE, (uint16_t)(event), 0u)
+#define ADI_BLE_LOGEVENT_DATA(event,data)   adi_trace_Event(ADI_TRACE_MODULE_BLE, (uint16_t)(event), (data))
 
 #else
 #define ADI_BLE_LOGEVENT(event)
@@ -71,6 +71,7 @@ extern "C" {
 /* Public APIs called through macros */
 void adi_RTCInit(void);
 uint32_t adi_GetRTCTime(void);
+void adi_RTCSleepUntil(const uint32_t nWakeTime);
 
 /*! \endcond */
 #ifdef __cplusplus
@@ -84,5 +85,8 @@ uint32_t adi_GetRTCTime(void);
 /*! Get the current timestamp valu.e */
 #define GET_TIME() adi_GetRTCTime()
 
+/*! Sleep in flexi mode until the timestamp reaches t. */
+#define SLEEP_UNTIL_TIME(t) adi_RTCSleepUntil(t)
+
 #endif /* ADI_TIME_H */
 /* @} */
@@ -0,0 +1,263 @@
+/*!
+ *****************************************************************************
+   @file:    adi_ble_beacon.c
+   @brief:   Sensor Beacon Interface
+   @details: Sensor readings carried in advertising data
+  -----------------------------------------------------------------------------
+
+Copyright (c) 2026 Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  - Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  - Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  - Modified versions of the software must be conspicuously marked as such.
+  - This software is licensed solely and exclusively for use with processors
+    manufactured by or for Analog Devices, Inc.
+  - This software may not be combined or merged with other code in any manner
+    that would cause the software to become subject to terms and conditions
+    which differ from those listed here.
+  - Neither the name of Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+  - The use of this software may or may not infringe the patent rights of one
+    or more patent holders.  This license does not release you from the
+    requirement that you obtain separate licenses from these patent holders
+    to use this software.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. AND CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+TITLE, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+NO EVENT SHALL ANALOG DEVICES, INC. OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, PUNITIVE OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, DAMAGES ARISING OUT OF CLAIMS OF INTELLECTUAL
+PROPERTY RIGHTS INFRINGEMENT; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+/** @addtogroup adi_beacon Sensor Beacon Interface
+ *  @ingroup Utilities
+ *  @{
+ *
+ *  @brief Sensor Beacon Interface
+ *  @details  The advertising data is walked locally instead of with
+ *            adi_radio_ParseAdvData() and adi_radio_FilterAdvData(), which
+ *            are command round trips to the radio for every packet.
+ */
+
+#include <beacon/adi_ble_beacon.h>
+
+/*! \cond PRIVATE */
+
+/* Advertising data types, see ADI_BLE_GAP_ADV_DATA_TYPE */
+#define ADI_BEACON_AD_SERVICEDATA       (0x16u)
+#define ADI_BEACON_AD_VENDORSPECIFIC    (0xFFu)
+
+/* Size of the data type and the UUID or company id of a field */
+#define ADI_BEACON_AD_ID_SIZE           (3u)
+
+static uint16_t GetHalf(const uint8_t *pSrc)
+{
+    return (uint16_t)((uint16_t)pSrc[0] | ((uint16_t)pSrc[1] << 8u));
+}
+
+static void SetHalf(uint8_t *pDst, const uint16_t nValue)
+{
+    pDst[0] = (uint8_t)nValue;
+    pDst[1] = (uint8_t)(nValue >> 8u);
+}
+
+static ADI_BEACON_RESULT DecodeFrame(const uint8_t *pData, const uint32_t nLen, ADI_BEACON_FRAME *pFrame)
+{
+    uint32_t nNumValues;
+    uint32_t i;
+
+    if ((nLen < ADI_BEACON_HEADER_SIZE) || ((pData[0] >> 4u) != ADI_BEACON_VERSION)) {
+        return ADI_BEACON_MALFORMED;
+    }
+
+    nNumValues = pData[0] & 0x0Fu;
+    if ((nNumValues > ADI_BEACON_MAX_VALUES) ||
+        (nLen != (ADI_BEACON_HEADER_SIZE + (nNumValues * ADI_BEACON_VALUE_SIZE)))) {
+        return ADI_BEACON_MALFORMED;
+    }
+
+    pFrame->nSeq       = pData[1];
+    pFrame->nNumValues = (uint8_t)nNumValues;
+    for (i = 0u; i < nNumValues; i++) {
+        const uint8_t *pValue = &pData[ADI_BEACON_HEADER_SIZE + (i * ADI_BEACON_VALUE_SIZE)];
+
+        pFrame->aValues[i].nType  = pValue[0];
+        pFrame->aValues[i].nValue = (int16_t)GetHalf(&pValue[1]);
+    }
+
+    return ADI_BEACON_SUCCESS;
+}
+
+/*! \endcond */
+
+/**
+ * @brief       Finds and decodes the sensor beacon frame of an advertising packet.
+ *
+ * @param [in]  pAdvData :  Advertising data, a list of length, type, data fields.
+ *
+ * @param [in]  nLen :      Bytes at pAdvData.
+ *
+ * @param [out] pFrame :    Decoded frame, valid on ADI_BEACON_SUCCESS.
+ *
+ * @return      ADI_BEACON_RESULT
+ *                  - #ADI_BEACON_SUCCESS a frame was decoded
+ *                  - #ADI_BEACON_NO_FRAME the packet is from another kind of device
+ *                  - #ADI_BEACON_MALFORMED a field overruns the packet or the frame is broken
+ *
+ */
+ADI_BEACON_RESULT adi_beacon_Decode(const uint8_t *pAdvData, const uint32_t nLen, ADI_BEACON_FRAME *pFrame)
+{
+    uint32_t nPos = 0u;
+
+    while (nPos < nLen) {
+        uint32_t       nField = pAdvData[nPos];
+        const uint8_t *pField = &pAdvData[nPos + 1u];
+
+        /* A zero length field ends the significant part */
+        if (nField == 0u) {
+            break;
+        }
+        if ((nPos + 1u + nField) > nLen) {
+            return ADI_BEACON_MALFORMED;
+        }
+
+        if (nField >= ADI_BEACON_AD_ID_SIZE) {
+            if (((pField[0] == ADI_BEACON_AD_SERVICEDATA) && (GetHalf(&pField[1]) == ADI_CFG_BEACON_UUID)) ||
+                ((pField[0] == ADI_BEACON_AD_VENDORSPECIFIC) && (GetHalf(&pField[1]) == ADI_CFG_BEACON_COMPANY_ID))) {
+                return DecodeFrame(&pField[ADI_BEACON_AD_ID_SIZE], nField - ADI_BEACON_AD_ID_SIZE, pFrame);
+            }
+        }
+
+        nPos += 1u + nField;
+    }
+
+    return ADI_BEACON_NO_FRAME;
+}
+
+/**
+ * @brief       Packs a frame for adi_radio_SetServiceDataValue() or adi_radio_SetMfgSpecificData().
+ *
+ * @param [in]  pFrame :    Frame to pack.
+ *
+ * @param [out] pData :     Frame bytes, without the AD field header or the UUID.
+ *
+ * @param [in]  nSize :     Bytes available at pData.
+ *
+ * @return      Bytes written to pData, 0 if the frame has too many values or
+ *              does not fit.
+ *
+ */
+uint32_t adi_beacon_Encode(const ADI_BEACON_FRAME *pFrame, uint8_t *pData, const uint32_t nSize)
+{
+    uint32_t nLen;
+    uint32_t i;
+
+    if (pFrame->nNumValues > ADI_BEACON_MAX_VALUES) {
+        return 0u;
+    }
+    nLen = ADI_BEACON_HEADER_SIZE + ((uint32_t)pFrame->nNumValues * ADI_BEACON_VALUE_SIZE);
+    if (nLen > nSize) {
+        return 0u;
+    }
+
+    pData[0] = (uint8_t)((ADI_BEACON_VERSION << 4u) | pFrame->nNumValues);
+    pData[1] = pFrame->nSeq;
+    for (i = 0u; i < pFrame->nNumValues; i++) {
+        uint8_t *pValue = &pData[ADI_BEACON_HEADER_SIZE + (i * ADI_BEACON_VALUE_SIZE)];
+
+        pValue[0] = pFrame->aValues[i].nType;
+        SetHalf(&pValue[1], (uint16_t)pFrame->aValues[i].nValue);
+    }
+
+    return nLen;
+}
+
+/**
+ * @brief       Converts a reading to the fixed point unit of a value type.
+ *
+ * @param [in]  fValue :    Reading, e.g. 23.456 for a temperature in degC.
+ *
+ * @param [in]  fLsb :      Unit of the value type in the unit of fValue, e.g. 0.01f.
+ *
+ * @return      Rounded value, saturated to the int16_t range.
+ *
+ */
+int16_t adi_beacon_FromFloat(const float fValue, const float fLsb)
+{
+    float fScaled = fValue / fLsb;
+
+    if (fScaled >= 32767.0f) {
+        return INT16_MAX;
+    }
+    if (fScaled <= -32768.0f) {
+        return INT16_MIN;
+    }
+    return (int16_t)((fScaled < 0.0f) ? (fScaled - 0.5f) : (fScaled + 0.5f));
+}
+
+/**
+ * @brief       Starts an update schedule.
+ *
+ * @param [out] pSched :    Schedule to set up.
+ *
+ * @param [in]  nInterval : Ticks between two updates, not 0.
+ *
+ * @param [in]  nNow :      Current time, the first update is due one interval later.
+ *
+ */
+void adi_beacon_SchedInit(ADI_BEACON_SCHED *pSched, const uint32_t nInterval, const uint32_t nNow)
+{
+    pSched->nInterval = nInterval;
+    pSched->nNext     = nNow + nInterval;
+    pSched->nSkipped  = 0u;
+}
+
+/**
+ * @brief       Checks whether the next update is due.
+ *
+ * @details     When an update is due the schedule moves on by one interval.
+ *              If the caller is later than a whole interval the missed
+ *              updates are counted in nSkipped and dropped, so a late
+ *              caller does not send a burst of frames to catch up. The
+ *              time may wrap around.
+ *
+ * @param [in]  pSched :    Schedule set up by adi_beacon_SchedInit().
+ *
+ * @param [in]  nNow :      Current time.
+ *
+ * @return      0 if an update is due now, otherwise the ticks until it is.
+ *
+ */
+uint32_t adi_beacon_SchedWait(ADI_BEACON_SCHED *pSched, const uint32_t nNow)
+{
+    uint32_t nLate = nNow - pSched->nNext;
+    uint32_t nMissed;
+
+    /* Not due yet */
+    if (nLate >= 0x80000000u) {
+        return pSched->nNext - nNow;
+    }
+
+    nMissed           = nLate / pSched->nInterval;
+    pSched->nSkipped += nMissed;
+    pSched->nNext    += (nMissed + 1u) * pSched->nInterval;
+
+    return 0u;
+}
+
+/* @} */
@@ -0,0 +1,190 @@
+/*!
+ *****************************************************************************
+   @file:    adi_ble_broadcast.c
+   @brief:   Beacon Broadcast Interface
+   @details: Broadcaster role sending sensor beacon frames in service data
+  -----------------------------------------------------------------------------
+
+Copyright (c) 2026 Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  - Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  - Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  - Modified versions of the software must be conspicuously marked as such.
+  - This software is licensed solely and exclusively for use with processors
+    manufactured by or for Analog Devices, Inc.
+  - This software may not be combined or merged with other code in any manner
+    that would cause the software to become subject to terms and conditions
+    which differ from those listed here.
+  - Neither the name of Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+  - The use of this software may or may not infringe the patent rights of one
+    or more patent holders.  This license does not release you from the
+    requirement that you obtain separate licenses from these patent holders
+    to use this software.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. AND CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+TITLE, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+NO EVENT SHALL ANALOG DEVICES, INC. OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, PUNITIVE OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, DAMAGES ARISING OUT OF CLAIMS OF INTELLECTUAL
+PROPERTY RIGHTS INFRINGEMENT; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+/** @addtogroup adi_broadcast Beacon Broadcast Interface
+ *  @ingroup Utilities
+ *  @{
+ *
+ *  @brief Beacon Broadcast Interface
+ *  @details  No local name is set, so the flags and a frame of
+ *            ADI_BEACON_MAX_VALUES values fit in one legacy advertising
+ *            packet.
+ */
+
+#include <stddef.h>
+#include <framework/noos/adi_ble_noos.h>
+#include <common/adi_timestamp.h>
+#include <beacon/adi_ble_broadcast.h>
+
+/*! \cond PRIVATE */
+
+/* Service data value limit of adi_radio_SetServiceDataValue() */
+#define ADI_BROADCAST_MAX_DATA  (24u)
+
+/* Sequence number of the next frame */
+static uint8_t nNextSeq;
+
+static void BroadcastCallback(void *pCBParam, uint32_t Event, void *pArg)
+{
+    /* A broadcaster has no connection events to handle */
+}
+
+static ADI_BLER_RESULT SetFrame(ADI_BEACON_FRAME *pFrame)
+{
+    uint8_t  aData[ADI_BROADCAST_MAX_DATA];
+    uint32_t nLen;
+
+    pFrame->nSeq = nNextSeq;
+    nLen = adi_beacon_Encode(pFrame, aData, sizeof(aData));
+    if (nLen == 0u) {
+        return ADI_BLER_FAILURE;
+    }
+
+    nNextSeq++;
+    return adi_radio_SetServiceDataValue(ADI_CFG_BEACON_UUID, aData, (uint8_t)nLen);
+}
+
+/*! \endcond */
+
+/**
+ * @brief       Starts broadcasting a frame.
+ *
+ * @details     Initializes the BLE framework in the broadcaster role. The
+ *              caller only needs to have called adi_RTCInit() before.
+ *
+ * @param [in,out] pFrame :     First frame to broadcast, its sequence number is filled in.
+ *
+ * @param [in]  nAdvInterval :  Advertising interval in 0.625 ms slots, see ADI_CFG_BROADCAST_ADV_INTERVAL.
+ *
+ * @return      ADI_BLER_RESULT
+ *                  - #ADI_BLER_SUCCESS the radio is broadcasting
+ *                  - #ADI_BLER_FAILURE the frame has too many values or a radio command failed
+ *
+ */
+ADI_BLER_RESULT adi_broadcast_Start(ADI_BEACON_FRAME *pFrame, const uint16_t nAdvInterval)
+{
+    ADI_BLER_RESULT eResult;
+
+    nNextSeq = 0u;
+
+    eResult = adi_ble_Init(BroadcastCallback, NULL);
+
+    if (eResult == ADI_BLER_SUCCESS) {
+        eResult = adi_radio_RegisterDevice(ADI_BLE_ROLE_BROADCASTER);
+    }
+    if (eResult == ADI_BLER_SUCCESS) {
+        eResult = SetFrame(pFrame);
+    }
+    if (eResult == ADI_BLER_SUCCESS) {
+        eResult = adi_radio_ApplyBroadcastValue();
+    }
+    if (eResult == ADI_BLER_SUCCESS) {
+        eResult = adi_radio_StartBroadcastProc(nAdvInterval);
+    }
+
+    return eResult;
+}
+
+/**
+ * @brief       Replaces the broadcast frame.
+ *
+ * @details     The new frame goes out with the next advertising event, the
+ *              broadcast keeps running.
+ *
+ * @param [in,out] pFrame :     Frame to broadcast, its sequence number is filled in.
+ *
+ * @return      ADI_BLER_RESULT
+ *                  - #ADI_BLER_SUCCESS the frame is applied
+ *                  - #ADI_BLER_FAILURE the frame has too many values or a radio command failed
+ *
+ */
+ADI_BLER_RESULT adi_broadcast_Update(ADI_BEACON_FRAME *pFrame)
+{
+    ADI_BLER_RESULT eResult;
+
+    eResult = SetFrame(pFrame);
+
+    if (eResult == ADI_BLER_SUCCESS) {
+        eResult = adi_radio_ApplyBroadcastValue();
+    }
+
+    return eResult;
+}
+
+/**
+ * @brief       Stops broadcasting.
+ *
+ * @return      ADI_BLER_RESULT of adi_radio_StopBroadcastProc().
+ *
+ */
+ADI_BLER_RESULT adi_broadcast_Stop(void)
+{
+    return adi_radio_StopBroadcastProc();
+}
+
+/**
+ * @brief       Sleeps until the next update is due.
+ *
+ * @details     The radio keeps advertising the last frame while the core is
+ *              in flexi mode. Updates missed because the caller was late are
+ *              dropped and counted in pSched->nSkipped.
+ *
+ * @param [in,out] pSched :     Schedule set up with adi_beacon_SchedInit() on GET_TIME().
+ *
+ */
+void adi_broadcast_Sleep(ADI_BEACON_SCHED *pSched)
+{
+    uint32_t nNow  = GET_TIME();
+    uint32_t nWait = adi_beacon_SchedWait(pSched, nNow);
+
+    while (nWait != 0u) {
+        SLEEP_UNTIL_TIME(nNow + nWait);
+        nNow  = GET_TIME();
+        nWait = adi_beacon_SchedWait(pSched, nNow);
+    }
+}
+
+/* @} */
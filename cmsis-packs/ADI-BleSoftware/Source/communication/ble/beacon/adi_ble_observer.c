@@ -0,0 +1,353 @@
+/*!
+ *****************************************************************************
+   @file:    adi_ble_observer.c
+   @brief:   Beacon Observer Interface
+   @details: Aggregation table of the sensor beacons heard in observer mode
+  -----------------------------------------------------------------------------
+
+Copyright (c) 2026 Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  - Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  - Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  - Modified versions of the software must be conspicuously marked as such.
+  - This software is licensed solely and exclusively for use with processors
+    manufactured by or for Analog Devices, Inc.
+  - This software may not be combined or merged with other code in any manner
+    that would cause the software to become subject to terms and conditions
+    which differ from those listed here.
+  - Neither the name of Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+  - The use of this software may or may not infringe the patent rights of one
+    or more patent holders.  This license does not release you from the
+    requirement that you obtain separate licenses from these patent holders
+    to use this software.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. AND CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+TITLE, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+NO EVENT SHALL ANALOG DEVICES, INC. OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, PUNITIVE OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, DAMAGES ARISING OUT OF CLAIMS OF INTELLECTUAL
+PROPERTY RIGHTS INFRINGEMENT; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+/** @addtogroup adi_observer Beacon Observer Interface
+ *  @ingroup Utilities
+ *  @{
+ *
+ *  @brief Beacon Observer Interface
+ *  @details  Broadcasters are looked up by address in a small table. A frame
+ *            with the sequence number of the previous one is a repeat of the
+ *            same advertisement and only updates the RSSI. When the table is
+ *            full the broadcaster heard least recently is evicted.
+ */
+
+#include <string.h>
+#include <beacon/adi_ble_observer.h>
+
+/*! \cond PRIVATE */
+
+/* Ticks without a frame after which a broadcaster is dropped */
+#define ADI_OBSERVER_STALE_TICKS    (ADI_CFG_OBSERVER_STALE_SEC * ADI_CFG_OBSERVER_TICK_HZ)
+
+/* Fractional bits of the averaged RSSI */
+#define ADI_OBSERVER_RSSI_FRAC      (4u)
+
+typedef struct
+{
+    ADI_BEACON_ADDR sAddr;
+    uint8_t         bUsed;
+    uint8_t         nSeq;
+    uint8_t         nNumValues;
+    uint8_t         aTypes[ADI_BEACON_MAX_VALUES];
+    int32_t         aSum[ADI_BEACON_MAX_VALUES];
+    int16_t         nRssi;          /* averaged, ADI_OBSERVER_RSSI_FRAC fractional bits */
+    uint16_t        nFrames;
+    uint16_t        nMissed;
+    uint32_t        nLastSeen;
+} ADI_OBSERVER_ENTRY;
+
+static ADI_OBSERVER_ENTRY gObserverTable[ADI_CFG_OBSERVER_NUM_ENTRIES];
+static ADI_OBSERVER_STATS gObserverStats;
+
+static ADI_OBSERVER_ENTRY *FindEntry(const ADI_BEACON_ADDR *pAddr)
+{
+    uint32_t i;
+
+    for (i = 0u; i < ADI_CFG_OBSERVER_NUM_ENTRIES; i++) {
+        ADI_OBSERVER_ENTRY *pEntry = &gObserverTable[i];
+
+        if ((pEntry->bUsed != 0u) && (pEntry->sAddr.nAddrType == pAddr->nAddrType) &&
+            (memcmp(pEntry->sAddr.aBD_ADDR, pAddr->aBD_ADDR, sizeof(pAddr->aBD_ADDR)) == 0)) {
+            return pEntry;
+        }
+    }
+    return NULL;
+}
+
+static ADI_OBSERVER_ENTRY *NewEntry(const ADI_BEACON_ADDR *pAddr, const int8_t nRssi, const uint32_t nNow)
+{
+    ADI_OBSERVER_ENTRY *pEntry = NULL;
+    uint32_t            i;
+
+    /* A free entry, or else the one heard least recently */
+    for (i = 0u; i < ADI_CFG_OBSERVER_NUM_ENTRIES; i++) {
+        if (gObserverTable[i].bUsed == 0u) {
+            pEntry = &gObserverTable[i];
+            break;
+        }
+        if ((pEntry == NULL) || ((nNow - gObserverTable[i].nLastSeen) > (nNow - pEntry->nLastSeen))) {
+            pEntry = &gObserverTable[i];
+        }
+    }
+    if (pEntry->bUsed != 0u) {
+        gObserverStats.nEvicted++;
+    }
+
+    memset(pEntry, 0, sizeof(ADI_OBSERVER_ENTRY));
+    pEntry->sAddr = *pAddr;
+    pEntry->bUsed = 1u;
+    pEntry->nRssi = (int16_t)(nRssi * (1 << ADI_OBSERVER_RSSI_FRAC));
+    return pEntry;
+}
+
+static void UpdateRssi(ADI_OBSERVER_ENTRY *pEntry, const int8_t nRssi)
+{
+    int32_t nDiff = (nRssi * (1 << ADI_OBSERVER_RSSI_FRAC)) - pEntry->nRssi;
+
+    pEntry->nRssi += (int16_t)(nDiff / (1 << ADI_CFG_OBSERVER_RSSI_SHIFT));
+}
+
+/* Round to nearest, away from zero on ties */
+static int32_t Mean(const int32_t nSum, const int32_t nCount)
+{
+    return (nSum >= 0) ? ((nSum + (nCount / 2)) / nCount) : ((nSum - (nCount / 2)) / nCount);
+}
+
+/*! \endcond */
+
+/**
+ * @brief       Clears the table and the counters.
+ *
+ */
+void adi_observer_Init(void)
+{
+    memset(gObserverTable, 0, sizeof(gObserverTable));
+    memset(&gObserverStats, 0, sizeof(gObserverStats));
+}
+
+/**
+ * @brief       Adds an advertising report to the table.
+ *
+ * @param [in]  pAddr :     Address of the broadcaster.
+ *
+ * @param [in]  nRssi :     RSSI of the report in dBm.
+ *
+ * @param [in]  pAdvData :  Advertising data of the report.
+ *
+ * @param [in]  nLen :      Bytes at pAdvData.
+ *
+ * @param [in]  nNow :      Current time in ADI_CFG_OBSERVER_TICK_HZ ticks.
+ *
+ * @return      ADI_BEACON_RESULT of decoding the advertising data.
+ *
+ */
+ADI_BEACON_RESULT adi_observer_Report(const ADI_BEACON_ADDR *pAddr, const int8_t nRssi, const uint8_t *pAdvData, const uint32_t nLen, const uint32_t nNow)
+{
+    ADI_OBSERVER_ENTRY *pEntry;
+    ADI_BEACON_FRAME    sFrame;
+    ADI_BEACON_RESULT   eResult;
+    uint32_t            i;
+
+    gObserverStats.nReports++;
+
+    eResult = adi_beacon_Decode(pAdvData, nLen, &sFrame);
+    if (eResult == ADI_BEACON_NO_FRAME) {
+        gObserverStats.nForeign++;
+        return eResult;
+    }
+    if (eResult != ADI_BEACON_SUCCESS) {
+        gObserverStats.nMalformed++;
+        return eResult;
+    }
+
+    pEntry = FindEntry(pAddr);
+    if (pEntry == NULL) {
+        pEntry = NewEntry(pAddr, nRssi, nNow);
+    } else {
+        uint8_t nDelta = (uint8_t)(sFrame.nSeq - pEntry->nSeq);
+
+        UpdateRssi(pEntry, nRssi);
+        pEntry->nLastSeen = nNow;
+
+        if (nDelta == 0u) {
+            gObserverStats.nDuplicates++;
+            return ADI_BEACON_SUCCESS;
+        }
+        /* A large step back means the broadcaster restarted */
+        if (nDelta < 128u) {
+            pEntry->nMissed += (uint16_t)(nDelta - 1u);
+        }
+    }
+
+    /* Restart the averages when the broadcaster changes its set of values */
+    for (i = 0u; i < sFrame.nNumValues; i++) {
+        if (pEntry->aTypes[i] != sFrame.aValues[i].nType) {
+            break;
+        }
+    }
+    if ((sFrame.nNumValues != pEntry->nNumValues) || (i != sFrame.nNumValues)) {
+        pEntry->nNumValues = sFrame.nNumValues;
+        pEntry->nFrames    = 0u;
+        for (i = 0u; i < sFrame.nNumValues; i++) {
+            pEntry->aTypes[i] = sFrame.aValues[i].nType;
+            pEntry->aSum[i]   = 0;
+        }
+    }
+
+    for (i = 0u; i < sFrame.nNumValues; i++) {
+        pEntry->aSum[i] += sFrame.aValues[i].nValue;
+    }
+    pEntry->nFrames++;
+    pEntry->nSeq      = sFrame.nSeq;
+    pEntry->nLastSeen = nNow;
+    gObserverStats.nFrames++;
+
+    return ADI_BEACON_SUCCESS;
+}
+
+/**
+ * @brief       Adds the payload of a GAP_EVENT_OBS_MODE_DATA event to the table.
+ *
+ * @details     The payload is the address type, the address, the RSSI, the
+ *              length of the advertising data and the data, as parsed by
+ *              adi_ble_GetObserverData(). Recorded events can be replayed
+ *              through this function.
+ *
+ * @param [in]  pParam :    Event payload.
+ *
+ * @param [in]  nLen :      Bytes at pParam.
+ *
+ * @param [in]  nNow :      Current time in ADI_CFG_OBSERVER_TICK_HZ ticks.
+ *
+ * @return      ADI_BEACON_RESULT of decoding the advertising data.
+ *
+ */
+ADI_BEACON_RESULT adi_observer_ReportEvent(const uint8_t *pParam, const uint32_t nLen, const uint32_t nNow)
+{
+    ADI_BEACON_ADDR sAddr;
+
+    if ((nLen < ADI_OBSERVER_EVENT_MIN_SIZE) || ((ADI_OBSERVER_EVENT_MIN_SIZE + pParam[8]) > nLen)) {
+        gObserverStats.nReports++;
+        gObserverStats.nMalformed++;
+        return ADI_BEACON_MALFORMED;
+    }
+
+    sAddr.nAddrType = pParam[0];
+    memcpy(sAddr.aBD_ADDR, &pParam[1], sizeof(sAddr.aBD_ADDR));
+
+    return adi_observer_Report(&sAddr, (int8_t)pParam[7], &pParam[ADI_OBSERVER_EVENT_MIN_SIZE], pParam[8], nNow);
+}
+
+/**
+ * @brief       Drops the broadcasters not heard for ADI_CFG_OBSERVER_STALE_SEC.
+ *
+ * @param [in]  nNow :      Current time in ADI_CFG_OBSERVER_TICK_HZ ticks.
+ *
+ * @return      Number of broadcasters dropped.
+ *
+ */
+uint32_t adi_observer_Expire(const uint32_t nNow)
+{
+    uint32_t nExpired = 0u;
+    uint32_t i;
+
+    for (i = 0u; i < ADI_CFG_OBSERVER_NUM_ENTRIES; i++) {
+        if ((gObserverTable[i].bUsed != 0u) &&
+            ((nNow - gObserverTable[i].nLastSeen) > ADI_OBSERVER_STALE_TICKS)) {
+            gObserverTable[i].bUsed = 0u;
+            nExpired++;
+        }
+    }
+    gObserverStats.nExpired += nExpired;
+
+    return nExpired;
+}
+
+/**
+ * @brief       Passes the readings collected since the last flush to pfBatch.
+ *
+ * @details     One call per broadcaster with new frames. The averages and the
+ *              frame and gap counts of those broadcasters restart afterwards.
+ *
+ * @param [in]  pfBatch :   Function receiving the readings.
+ *
+ * @param [in]  pParam :    Passed to pfBatch.
+ *
+ * @param [in]  nNow :      Current time in ADI_CFG_OBSERVER_TICK_HZ ticks.
+ *
+ * @return      Number of readings passed to pfBatch.
+ *
+ */
+uint32_t adi_observer_Flush(ADI_OBSERVER_BATCH_FN pfBatch, void *pParam, const uint32_t nNow)
+{
+    ADI_OBSERVER_READING sReading;
+    uint32_t             nCount = 0u;
+    uint32_t             i;
+    uint32_t             j;
+
+    for (i = 0u; i < ADI_CFG_OBSERVER_NUM_ENTRIES; i++) {
+        ADI_OBSERVER_ENTRY *pEntry = &gObserverTable[i];
+        int32_t             nRound = (pEntry->nRssi < 0) ? -(1 << (ADI_OBSERVER_RSSI_FRAC - 1u)) : (1 << (ADI_OBSERVER_RSSI_FRAC - 1u));
+
+        if ((pEntry->bUsed == 0u) || (pEntry->nFrames == 0u)) {
+            continue;
+        }
+
+        sReading.sAddr      = pEntry->sAddr;
+        sReading.nRssi      = (int8_t)((pEntry->nRssi + nRound) / (1 << ADI_OBSERVER_RSSI_FRAC));
+        sReading.nSeq       = pEntry->nSeq;
+        sReading.nFrames    = pEntry->nFrames;
+        sReading.nMissed    = pEntry->nMissed;
+        sReading.nAge       = nNow - pEntry->nLastSeen;
+        sReading.nNumValues = pEntry->nNumValues;
+        for (j = 0u; j < pEntry->nNumValues; j++) {
+            sReading.aValues[j].nType  = pEntry->aTypes[j];
+            sReading.aValues[j].nValue = (int16_t)Mean(pEntry->aSum[j], (int32_t)pEntry->nFrames);
+            pEntry->aSum[j] = 0;
+        }
+        pEntry->nFrames = 0u;
+        pEntry->nMissed = 0u;
+
+        pfBatch(&sReading, pParam);
+        nCount++;
+    }
+
+    return nCount;
+}
+
+/**
+ * @brief       Reads the observer counters.
+ *
+ * @param [out] pStats :    Counters since adi_observer_Init().
+ *
+ */
+void adi_observer_GetStats(ADI_OBSERVER_STATS *pStats)
+{
+    *pStats = gObserverStats;
+}
+
+/* @} */
@@ -64,24 +64,11 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  @{
  */
 #include <radio/adi_ble_logevent.h>
-#define ADI_CFG_BLE_NUM_LOGEVENT_ENTRIES    (20u)
-
-
-typedef struct 
-{
-    ADI_BLE_LOG_ID   event;        /*!< log Event */
-    uint32_t         data;         /*!< data associated with the event */
-    uint32_t         timeStamp;    /*!< timestamp */
-
-} ADI_BLE_LOGEVENT_DATA;
-
-static  ADI_BLE_LOGEVENT_DATA gBleLogEvents[ADI_CFG_BLE_NUM_LOGEVENT_ENTRIES];
-static  int32_t gEvtIndx;
 
 /**
- * @brief       Logs the specified event to the event buffer
+ * @brief       Logs the specified event to the trace buffer
  *
- * @details     Logs the specified event to the event buffer with timestamp
+ * @details     Logs the specified event to the trace buffer with timestamp
  *
  * @param [in]  event :  event that needs to be logged
  * 
@@ -90,34 +77,25 @@ static  int32_t gEvtIndx;
  */
 void adi_ble_LogEvent(const ADI_BLE_LOG_ID event)
 {
-   gBleLogEvents[gEvtIndx].event     = event;
-   gBleLogEvents[gEvtIndx].timeStamp = ADI_BLE_GET_TIMESTAMP();
-   gEvtIndx++;
-   if (gEvtIndx >= ADI_CFG_BLE_NUM_LOGEVENT_ENTRIES) gEvtIndx = 0;
+    adi_trace_Event(ADI_TRACE_MODULE_BLE, (uint16_t)event, 0u);
 }
 
 
 /**
  * @brief       Logs the specified event a along with associated event data
  *
- * @details     Logs the specified event to the event buffer, associated data and timestamp
+ * @details     Logs the specified event to the trace buffer, associated data and timestamp
  *
  * @param [in]  event :  event that needs to be logged
  *
- * @param [in]  event :  event that needs to be logged
+ * @param [in]  data :   data associated with the event
  * 
  * @return      none            
  *
  */
 void adi_ble_LogEventData(const ADI_BLE_LOG_ID event,const uint32_t data)
 {
-   gBleLogEvents[gEvtIndx].event      = event;
-   gBleLogEvents[gEvtIndx].data       = data;
-   gBleLogEvents[gEvtIndx].timeStamp  = ADI_BLE_GET_TIMESTAMP();
-
-   gEvtIndx++;
-
-   if (gEvtIndx >= ADI_CFG_BLE_NUM_LOGEVENT_ENTRIES) gEvtIndx = 0;
+    adi_trace_Event(ADI_TRACE_MODULE_BLE, (uint16_t)event, data);
 }
 
 /*@}*/
@@ -127,4 +105,3 @@ void adi_ble_LogEventData(const ADI_BLE_LOG_ID event,const uint32_t data)
 #endif
 
 #endif /* ADI_CFG_BLE_LOGEVENT */
-
@@ -57,9 +57,11 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  @details  Abstraction layer for timestamp implementation.
  */
 
+#include <stddef.h>
 #include <adi_global_config.h>
 #include <common/adi_timestamp.h>
 #include <common/adi_error_handling.h>
+#include <drivers/pwr/adi_pwr.h>
 
 
 /*! Device memory to operate the RTC device */
@@ -75,6 +77,16 @@ static ADI_RTC_HANDLE hDevice;
 /*!  The RTC prescalar can be caluculated using the equation: 1/(32768/2^Prescalar). Set prescalar to 5u for .97 ms precision */
 #define ADI_RTC_PRESCALAR       (5u)
 
+/*! Set by the alarm interrupt to end adi_RTCSleepUntil() */
+static volatile uint32_t nAlarmFlag;
+
+
+static void RTCCallback(void *pCBParam, uint32_t nEvent, void *pArg)
+{
+    if ((nEvent & ADI_RTC_ALARM_INT) != 0u) {
+        nAlarmFlag++;
+    }
+}
 
 /**
  * @brief       Initialize RTC.
@@ -96,6 +108,11 @@ void adi_RTCInit(void)
     {
     	eRTCResult =  adi_rtc_Enable(hDevice, true);
 	}
+
+    if(eRTCResult == ADI_RTC_SUCCESS)
+    {
+    	eRTCResult = adi_rtc_RegisterCallback(hDevice, RTCCallback, NULL);
+	}
 }
 
 /**
@@ -113,4 +130,37 @@ uint32_t adi_GetRTCTime(void)
     return t;
 }
 
+/**
+ * @brief       Sleep until a timestamp.
+ *
+ * @details     Enters flexi mode and wakes up on an RTC alarm. Other interrupts,
+ *              e.g. from the radio, are still serviced while the core sleeps.
+ *              Returns at once if nWakeTime is less than two ticks away, so an
+ *              alarm that is already passed cannot be missed.
+ *
+ * @param [in]  nWakeTime : Timestamp to wake up at, as returned by GET_TIME().
+ *
+ */
+void adi_RTCSleepUntil(const uint32_t nWakeTime)
+{
+    uint32_t nNow;
+
+    if ((adi_rtc_GetCount(hDevice, &nNow) != ADI_RTC_SUCCESS) ||
+        ((int32_t)(nWakeTime - nNow) < 2))
+    {
+        return;
+    }
+
+    nAlarmFlag = 0u;
+    if ((adi_rtc_SetAlarm(hDevice, nWakeTime) == ADI_RTC_SUCCESS) &&
+        (adi_rtc_EnableInterrupts(hDevice, ADI_RTC_ALARM_INT, true) == ADI_RTC_SUCCESS) &&
+        (adi_rtc_EnableAlarm(hDevice, true) == ADI_RTC_SUCCESS))
+    {
+        adi_pwr_EnterLowPowerMode(ADI_PWR_MODE_FLEXI, &nAlarmFlag, 0u);
+    }
+
+    adi_rtc_EnableAlarm(hDevice, false);
+    adi_rtc_EnableInterrupts(hDevice, ADI_RTC_ALARM_INT, false);
+}
+
 /* @} */
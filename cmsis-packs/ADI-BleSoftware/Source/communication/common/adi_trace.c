@@ -0,0 +1,231 @@
+/*!
+ *****************************************************************************
+   @file:    adi_trace.c
+   @brief:   Trace Interface
+   @details: Binary trace buffer shared by the Wi-Fi and Bluetooth drivers
+  -----------------------------------------------------------------------------
+
+Copyright (c) 2026 Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  - Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  - Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  - Modified versions of the software must be conspicuously marked as such.
+  - This software is licensed solely and exclusively for use with processors
+    manufactured by or for Analog Devices, Inc.
+  - This software may not be combined or merged with other code in any manner
+    that would cause the software to become subject to terms and conditions
+    which differ from those listed here.
+  - Neither the name of Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+  - The use of this software may or may not infringe the patent rights of one
+    or more patent holders.  This license does not release you from the
+    requirement that you obtain separate licenses from these patent holders
+    to use this software.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. AND CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+TITLE, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+NO EVENT SHALL ANALOG DEVICES, INC. OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, PUNITIVE OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, DAMAGES ARISING OUT OF CLAIMS OF INTELLECTUAL
+PROPERTY RIGHTS INFRINGEMENT; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+/*****************************************************************************/
+
+/** @addtogroup adi_trace Trace Interface
+ *  @ingroup Utilities
+ *  @{
+ *
+ *  @brief Trace Interface
+ *  @details  A writer claims the next slot with LDREX/STREX, so records can be
+ *            added from interrupts without disabling them. The buffer wraps,
+ *            records that are overwritten before adi_trace_Dump() reads them
+ *            are counted as lost.
+ */
+
+#include <adi_processor.h>
+#include <common/adi_timestamp.h>
+#include <common/adi_trace.h>
+
+#if (ADI_CFG_TRACE_NUM_ENTRIES & (ADI_CFG_TRACE_NUM_ENTRIES - 1u)) != 0u
+#error "ADI_CFG_TRACE_NUM_ENTRIES must be a power of two"
+#endif
+
+/* Stale slots are detected from the 8-bit sequence stored in each record. */
+#if ADI_CFG_TRACE_NUM_ENTRIES > 128u
+#error "ADI_CFG_TRACE_NUM_ENTRIES must not exceed 128"
+#endif
+
+/*! \cond PRIVATE */
+
+/*! Size of the dump frame header, sync bytes included. */
+#define ADI_TRACE_HEADER_SIZE   (24u)
+
+static volatile ADI_TRACE_RECORD gTraceBuf[ADI_CFG_TRACE_NUM_ENTRIES];
+static volatile uint32_t gnTraceHead;      /* sequence number of the next record */
+static uint32_t gnTraceTail;               /* sequence number of the next record to dump */
+static uint32_t gnTraceDumped;
+static uint32_t gnTraceLost;
+
+static void PutWord(uint8_t *pDst, const uint32_t nValue, const uint32_t nSize)
+{
+    uint32_t i;
+
+    for (i = 0u; i < nSize; i++) {
+        pDst[i] = (uint8_t)(nValue >> (8u * i));
+    }
+}
+
+static uint16_t Sum(const uint8_t *pData, const uint32_t nSize)
+{
+    uint16_t nSum = 0u;
+    uint32_t i;
+
+    for (i = 0u; i < nSize; i++) {
+        nSum += pData[i];
+    }
+    return nSum;
+}
+
+/*! \endcond */
+
+/**
+ * @brief       Adds a record to the trace buffer.
+ *
+ * @details     Safe to call from interrupt handlers. An interrupt between the
+ *              exclusive load and store of the head makes the store fail, so
+ *              every writer gets its own slot.
+ *
+ * @param [in]  eModule :  Module logging the event.
+ *
+ * @param [in]  nEvent :   Event id.
+ *
+ * @param [in]  nData :    Data associated with the event.
+ *
+ */
+void adi_trace_Event(const ADI_TRACE_MODULE eModule, const uint16_t nEvent, const uint32_t nData)
+{
+    volatile ADI_TRACE_RECORD *pRec;
+    uint32_t nSeq;
+
+    do {
+        nSeq = __LDREXW(&gnTraceHead);
+    } while (__STREXW(nSeq + 1u, &gnTraceHead) != 0u);
+
+    pRec = &gTraceBuf[nSeq & (ADI_CFG_TRACE_NUM_ENTRIES - 1u)];
+    pRec->nTimeStamp = ADI_CFG_TRACE_GET_TIME();
+    pRec->nEvent     = nEvent;
+    pRec->nModule    = (uint8_t)eModule;
+    pRec->nData      = nData;
+    pRec->nSeq       = (uint8_t)nSeq;
+}
+
+/**
+ * @brief       Sends the records logged since the last dump.
+ *
+ * @details     The frame is made of a header, the records and a checksum:
+ *
+ *              'T', 'R', version, record size, number of records (16 bit),
+ *              buffer size (16 bit), sequence number of the first record,
+ *              records logged, records lost and timestamp frequency (32 bit
+ *              each), the records as ADI_TRACE_RECORD and the 16 bit sum of
+ *              all bytes after the sync bytes. Multi-byte values are little
+ *              endian. Records overwritten while the frame is sent are sent
+ *              with module ADI_TRACE_MODULE_LOST.
+ *
+ * @param [in]  pfWrite :  Function sending the frame.
+ *
+ * @return      Number of records in the frame.
+ *
+ */
+uint32_t adi_trace_Dump(ADI_TRACE_WRITE_FN pfWrite)
+{
+    uint8_t          aHeader[ADI_TRACE_HEADER_SIZE];
+    ADI_TRACE_RECORD sRec;
+    uint32_t         nHead  = gnTraceHead;
+    uint32_t         nFirst = gnTraceTail;
+    uint32_t         nCount;
+    uint32_t         i;
+    uint16_t         nSum;
+
+    if ((nHead - nFirst) > ADI_CFG_TRACE_NUM_ENTRIES) {
+        gnTraceLost += (nHead - nFirst) - ADI_CFG_TRACE_NUM_ENTRIES;
+        nFirst = nHead - ADI_CFG_TRACE_NUM_ENTRIES;
+    }
+    nCount = nHead - nFirst;
+
+    aHeader[0] = ADI_TRACE_SYNC0;
+    aHeader[1] = ADI_TRACE_SYNC1;
+    aHeader[2] = ADI_TRACE_VERSION;
+    aHeader[3] = (uint8_t)sizeof(ADI_TRACE_RECORD);
+    PutWord(&aHeader[4], nCount, 2u);
+    PutWord(&aHeader[6], ADI_CFG_TRACE_NUM_ENTRIES, 2u);
+    PutWord(&aHeader[8], nFirst, 4u);
+    PutWord(&aHeader[12], nHead, 4u);
+    PutWord(&aHeader[16], gnTraceLost, 4u);
+    PutWord(&aHeader[20], ADI_CFG_TRACE_TICK_HZ, 4u);
+    nSum = Sum(&aHeader[2], ADI_TRACE_HEADER_SIZE - 2u);
+    pfWrite(aHeader, ADI_TRACE_HEADER_SIZE);
+
+    for (i = nFirst; i != nHead; i++) {
+        volatile ADI_TRACE_RECORD *pRec = &gTraceBuf[i & (ADI_CFG_TRACE_NUM_ENTRIES - 1u)];
+
+        sRec.nTimeStamp = pRec->nTimeStamp;
+        sRec.nEvent     = pRec->nEvent;
+        sRec.nModule    = pRec->nModule;
+        sRec.nSeq       = pRec->nSeq;
+        sRec.nData      = pRec->nData;
+
+        /* Not written yet, or reused by a writer while it was copied */
+        if ((sRec.nSeq != (uint8_t)i) || ((gnTraceHead - i) > ADI_CFG_TRACE_NUM_ENTRIES)) {
+            sRec.nModule = ADI_TRACE_MODULE_LOST;
+            gnTraceLost++;
+        }
+
+        nSum += Sum((const uint8_t *)&sRec, sizeof(sRec));
+        pfWrite((const uint8_t *)&sRec, sizeof(sRec));
+    }
+
+    gnTraceTail    = nHead;
+    gnTraceDumped += nCount;
+
+    PutWord(aHeader, nSum, 2u);
+    pfWrite(aHeader, 2u);
+
+    return nCount;
+}
+
+/**
+ * @brief       Reads the trace buffer counters.
+ *
+ * @param [out] pStats :  Counters, records not dumped yet that were already
+ *                        overwritten are included in nLost.
+ *
+ */
+void adi_trace_GetStats(ADI_TRACE_STATS *pStats)
+{
+    uint32_t nHead    = gnTraceHead;
+    uint32_t nPending = nHead - gnTraceTail;
+
+    pStats->nLogged = nHead;
+    pStats->nDumped = gnTraceDumped;
+    pStats->nLost   = gnTraceLost;
+    if (nPending > ADI_CFG_TRACE_NUM_ENTRIES) {
+        pStats->nLost += nPending - ADI_CFG_TRACE_NUM_ENTRIES;
+    }
+}
+
+/* @} */
@@ -0,0 +1,165 @@
+/*!
+ *****************************************************************************
+   @file:    test_ble_beacon.c
+   @brief:   Host test of the sensor beacon frames and update schedule
+   @details: Builds with the host compiler, see the Makefile next to it.
+  -----------------------------------------------------------------------------
+
+Copyright (c) 2026 Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  - Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  - Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  - Modified versions of the software must be conspicuously marked as such.
+  - This software is licensed solely and exclusively for use with processors
+    manufactured by or for Analog Devices, Inc.
+  - This software may not be combined or merged with other code in any manner
+    that would cause the software to become subject to terms and conditions
+    which differ from those listed here.
+  - Neither the name of Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+  - The use of this software may or may not infringe the patent rights of one
+    or more patent holders.  This license does not release you from the
+    requirement that you obtain separate licenses from these patent holders
+    to use this software.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. AND CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+TITLE, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+NO EVENT SHALL ANALOG DEVICES, INC. OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, PUNITIVE OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, DAMAGES ARISING OUT OF CLAIMS OF INTELLECTUAL
+PROPERTY RIGHTS INFRINGEMENT; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <beacon/adi_ble_beacon.h>
+
+static int nFailures = 0;
+
+#define CHECK(cond) do {                                                    \
+    if (!(cond)) {                                                          \
+        printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);     \
+        nFailures++;                                                        \
+    }                                                                       \
+} while (0)
+
+/* Flags field followed by the frame as service data or manufacturer data */
+static uint32_t MakeAdvData(uint8_t *pAdv, uint8_t nAdType, uint16_t nId, const uint8_t *pFrame, uint32_t nLen)
+{
+    pAdv[0] = 2u;
+    pAdv[1] = 0x01u;
+    pAdv[2] = 0x06u;
+    pAdv[3] = (uint8_t)(nLen + 3u);
+    pAdv[4] = nAdType;
+    pAdv[5] = (uint8_t)nId;
+    pAdv[6] = (uint8_t)(nId >> 8u);
+    memcpy(&pAdv[7], pFrame, nLen);
+
+    return 7u + nLen;
+}
+
+static void TestFrames(void)
+{
+    ADI_BEACON_FRAME sFrame;
+    ADI_BEACON_FRAME sDecoded;
+    uint8_t aFrame[31];
+    uint8_t aAdv[40];
+    uint32_t nLen;
+    uint32_t nAdvLen;
+    uint32_t i;
+
+    memset(&sFrame, 0, sizeof(sFrame));
+    sFrame.nSeq = 200u;
+    sFrame.nNumValues = ADI_BEACON_MAX_VALUES;
+    for (i = 0u; i < ADI_BEACON_MAX_VALUES; i++) {
+        sFrame.aValues[i].nType = (uint8_t)(i + 1u);
+        sFrame.aValues[i].nValue = (int16_t)(3 - (int32_t)(1000u * i));
+    }
+
+    /* Seven values fill a legacy advertising packet next to the flags */
+    nLen = adi_beacon_Encode(&sFrame, aFrame, sizeof(aFrame));
+    CHECK(nLen == ADI_BEACON_HEADER_SIZE + (ADI_BEACON_MAX_VALUES * ADI_BEACON_VALUE_SIZE));
+    CHECK(adi_beacon_Encode(&sFrame, aFrame, nLen - 1u) == 0u);
+    sFrame.nNumValues = ADI_BEACON_MAX_VALUES + 1u;
+    CHECK(adi_beacon_Encode(&sFrame, aFrame, sizeof(aFrame)) == 0u);
+    sFrame.nNumValues = ADI_BEACON_MAX_VALUES;
+
+    nAdvLen = MakeAdvData(aAdv, 0x16u, ADI_CFG_BEACON_UUID, aFrame, nLen);
+    CHECK(nAdvLen <= 31u);
+    memset(&sDecoded, 0, sizeof(sDecoded));
+    CHECK(adi_beacon_Decode(aAdv, nAdvLen, &sDecoded) == ADI_BEACON_SUCCESS);
+    CHECK(sDecoded.nSeq == 200u);
+    CHECK(sDecoded.nNumValues == ADI_BEACON_MAX_VALUES);
+    for (i = 0u; i < ADI_BEACON_MAX_VALUES; i++) {
+        CHECK(sDecoded.aValues[i].nType == sFrame.aValues[i].nType);
+        CHECK(sDecoded.aValues[i].nValue == sFrame.aValues[i].nValue);
+    }
+
+    /* The same frame as manufacturer specific data */
+    nAdvLen = MakeAdvData(aAdv, 0xFFu, ADI_CFG_BEACON_COMPANY_ID, aFrame, nLen);
+    CHECK(adi_beacon_Decode(aAdv, nAdvLen, &sDecoded) == ADI_BEACON_SUCCESS);
+
+    /* Another service, a field overrunning the packet, a wrong value count */
+    nAdvLen = MakeAdvData(aAdv, 0x16u, 0x180Fu, aFrame, nLen);
+    CHECK(adi_beacon_Decode(aAdv, nAdvLen, &sDecoded) == ADI_BEACON_NO_FRAME);
+    nAdvLen = MakeAdvData(aAdv, 0x16u, ADI_CFG_BEACON_UUID, aFrame, nLen);
+    CHECK(adi_beacon_Decode(aAdv, nAdvLen - 1u, &sDecoded) == ADI_BEACON_MALFORMED);
+    aAdv[7] = (uint8_t)((ADI_BEACON_VERSION << 4u) | 6u);
+    CHECK(adi_beacon_Decode(aAdv, nAdvLen, &sDecoded) == ADI_BEACON_MALFORMED);
+    aAdv[7] = (uint8_t)(((ADI_BEACON_VERSION + 1u) << 4u) | ADI_BEACON_MAX_VALUES);
+    CHECK(adi_beacon_Decode(aAdv, nAdvLen, &sDecoded) == ADI_BEACON_MALFORMED);
+}
+
+static void TestFromFloat(void)
+{
+    CHECK(adi_beacon_FromFloat(23.456f, 0.01f) == 2346);
+    CHECK(adi_beacon_FromFloat(-23.456f, 0.01f) == -2346);
+    CHECK(adi_beacon_FromFloat(1e6f, 0.1f) == 32767);
+    CHECK(adi_beacon_FromFloat(-1e6f, 0.1f) == -32768);
+}
+
+static void TestSchedule(void)
+{
+    ADI_BEACON_SCHED sSched;
+
+    /* Start just before the tick counter wraps */
+    adi_beacon_SchedInit(&sSched, 1024u, 0xFFFFFE00u);
+    CHECK(adi_beacon_SchedWait(&sSched, 0xFFFFFE00u) == 1024u);
+    CHECK(adi_beacon_SchedWait(&sSched, 0xFFFFFF00u) == 768u);
+
+    /* Due after the wrap, the next update is one interval later */
+    CHECK(adi_beacon_SchedWait(&sSched, 0x200u) == 0u);
+    CHECK(sSched.nNext == 0x600u);
+    CHECK(sSched.nSkipped == 0u);
+    CHECK(adi_beacon_SchedWait(&sSched, 0x200u) == 0x400u);
+
+    /* A late caller skips the missed updates instead of bursting them */
+    CHECK(adi_beacon_SchedWait(&sSched, 0x600u + (3u * 1024u) + 5u) == 0u);
+    CHECK(sSched.nSkipped == 3u);
+    CHECK(sSched.nNext == 0x600u + (4u * 1024u));
+}
+
+int main(void)
+{
+    TestFrames();
+    TestFromFloat();
+    TestSchedule();
+
+    printf("%s\n", (nFailures != 0) ? "FAILED" : "OK");
+
+    return (nFailures != 0) ? 1 : 0;
+}
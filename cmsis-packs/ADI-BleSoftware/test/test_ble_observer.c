@@ -0,0 +1,410 @@
+/*!
+ *****************************************************************************
+   @file:    test_ble_observer.c
+   @brief:   Host test of the beacon observer table
+   @details: Replays observer events, builds with the host compiler.
+  -----------------------------------------------------------------------------
+
+Copyright (c) 2026 Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  - Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  - Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  - Modified versions of the software must be conspicuously marked as such.
+  - This software is licensed solely and exclusively for use with processors
+    manufactured by or for Analog Devices, Inc.
+  - This software may not be combined or merged with other code in any manner
+    that would cause the software to become subject to terms and conditions
+    which differ from those listed here.
+  - Neither the name of Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+  - The use of this software may or may not infringe the patent rights of one
+    or more patent holders.  This license does not release you from the
+    requirement that you obtain separate licenses from these patent holders
+    to use this software.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. AND CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+TITLE, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+NO EVENT SHALL ANALOG DEVICES, INC. OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, PUNITIVE OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, DAMAGES ARISING OUT OF CLAIMS OF INTELLECTUAL
+PROPERTY RIGHTS INFRINGEMENT; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <beacon/adi_ble_beacon.h>
+#include <beacon/adi_ble_observer.h>
+
+
+static int nFailures = 0;
+
+#define CHECK(cond) do {                                                    \
+    if (!(cond)) {                                                          \
+        printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);     \
+        nFailures++;                                                        \
+    }                                                                       \
+} while (0)
+
+#define MAX_READINGS    (ADI_CFG_OBSERVER_NUM_ENTRIES + 1u)
+
+/* Readings of the last flush */
+static ADI_OBSERVER_READING aReadings[MAX_READINGS];
+static uint32_t nReadings;
+
+static void Collect(const ADI_OBSERVER_READING *pReading, void *pParam)
+{
+    CHECK(pParam == (void *)aReadings);
+    if (nReadings < MAX_READINGS) {
+        aReadings[nReadings] = *pReading;
+    }
+    nReadings++;
+}
+
+static uint32_t Flush(const uint32_t nNow)
+{
+    uint32_t nCount;
+
+    nReadings = 0u;
+    nCount = adi_observer_Flush(Collect, aReadings, nNow);
+    CHECK(nCount == nReadings);
+
+    return nCount;
+}
+
+/* Reading of broadcaster nDev in the last flush */
+static const ADI_OBSERVER_READING *Reading(const uint8_t nDev)
+{
+    uint32_t i;
+
+    for (i = 0u; (i < nReadings) && (i < MAX_READINGS); i++) {
+        if (aReadings[i].sAddr.aBD_ADDR[0] == nDev) {
+            return &aReadings[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * GAP_EVENT_OBS_MODE_DATA payload as the radio reports it: address type,
+ * address, RSSI, length of the advertising data and the data, made of the
+ * flags and the frame as service data or manufacturer data.
+ */
+static uint32_t MakeEvent(uint8_t *pEvent, const uint8_t nDev, const int8_t nRssi, const ADI_BEACON_FRAME *pFrame, const uint8_t bVendor)
+{
+    const uint16_t nId = (bVendor != 0u) ? ADI_CFG_BEACON_COMPANY_ID : ADI_CFG_BEACON_UUID;
+    uint8_t *pAdv = &pEvent[ADI_OBSERVER_EVENT_MIN_SIZE];
+    uint32_t nLen;
+
+    pEvent[0] = 1u;
+    pEvent[1] = nDev;
+    pEvent[2] = 0x00u;
+    pEvent[3] = 0xADu;
+    pEvent[4] = 0x0Bu;
+    pEvent[5] = 0x00u;
+    pEvent[6] = 0xC0u;
+    pEvent[7] = (uint8_t)nRssi;
+
+    nLen = adi_beacon_Encode(pFrame, &pAdv[7], 31u - 7u);
+    CHECK(nLen != 0u);
+    pAdv[0] = 2u;
+    pAdv[1] = 0x01u;
+    pAdv[2] = 0x06u;
+    pAdv[3] = (uint8_t)(nLen + 3u);
+    pAdv[4] = (bVendor != 0u) ? 0xFFu : 0x16u;
+    pAdv[5] = (uint8_t)nId;
+    pAdv[6] = (uint8_t)(nId >> 8u);
+    pEvent[8] = (uint8_t)(7u + nLen);
+
+    return ADI_OBSERVER_EVENT_MIN_SIZE + pEvent[8];
+}
+
+/* Frame with a temperature and an acceleration */
+static void SetFrame(ADI_BEACON_FRAME *pFrame, const uint8_t nSeq, const int16_t nTemp, const int16_t nAccel)
+{
+    memset(pFrame, 0, sizeof(ADI_BEACON_FRAME));
+    pFrame->nSeq = nSeq;
+    pFrame->nNumValues = 2u;
+    pFrame->aValues[0].nType = ADI_BEACON_VALUE_TEMPERATURE;
+    pFrame->aValues[0].nValue = nTemp;
+    pFrame->aValues[1].nType = ADI_BEACON_VALUE_ACCEL_Z;
+    pFrame->aValues[1].nValue = nAccel;
+}
+
+static ADI_BEACON_RESULT Report(const uint8_t nDev, const int8_t nRssi, const uint8_t nSeq, const int16_t nTemp, const int16_t nAccel, const uint32_t nNow)
+{
+    ADI_BEACON_FRAME sFrame;
+    uint8_t aEvent[ADI_OBSERVER_EVENT_MIN_SIZE + 31u];
+    uint32_t nLen;
+
+    SetFrame(&sFrame, nSeq, nTemp, nAccel);
+    nLen = MakeEvent(aEvent, nDev, nRssi, &sFrame, 0u);
+
+    return adi_observer_ReportEvent(aEvent, nLen, nNow);
+}
+
+/* Repeated frames, both frame formats, foreign and broken packets */
+static void TestReplay(void)
+{
+    static const uint8_t aForeign[] = {
+        0u, 7u, 6u, 5u, 4u, 3u, 2u, (uint8_t)-70, 8u,
+        2u, 0x01u, 0x06u, 4u, 0xFFu, 0x4Cu, 0x00u, 0x02u
+    };
+    static const uint8_t aSeq[] = { 10u, 11u, 13u };
+    const ADI_OBSERVER_READING *pReading;
+    ADI_OBSERVER_STATS sStats;
+    ADI_BEACON_FRAME sFrame;
+    uint8_t aEvent[ADI_OBSERVER_EVENT_MIN_SIZE + 31u];
+    uint32_t nLen;
+    uint32_t nNow = 1000u;
+    uint32_t i;
+    uint32_t j;
+
+    adi_observer_Init();
+
+    /* Three frames, each heard three times, and a gap */
+    for (i = 0u; i < 3u; i++) {
+        for (j = 0u; j < 3u; j++) {
+            CHECK(Report(1u, -60, aSeq[i], (int16_t)(2500 + i), (int16_t)(-100 - (int32_t)i), nNow) == ADI_BEACON_SUCCESS);
+            nNow += 10u;
+        }
+    }
+
+    /* Manufacturer data, the sequence number wraps */
+    SetFrame(&sFrame, 255u, 1, -1);
+    nLen = MakeEvent(aEvent, 2u, -80, &sFrame, 1u);
+    CHECK(adi_observer_ReportEvent(aEvent, nLen, nNow) == ADI_BEACON_SUCCESS);
+    SetFrame(&sFrame, 0u, 2, -2);
+    nLen = MakeEvent(aEvent, 2u, -40, &sFrame, 1u);
+    CHECK(adi_observer_ReportEvent(aEvent, nLen, nNow + 5u) == ADI_BEACON_SUCCESS);
+
+    /* Another beacon format, a short event, a frame overrunning the packet */
+    CHECK(adi_observer_ReportEvent(aForeign, sizeof(aForeign), nNow) == ADI_BEACON_NO_FRAME);
+    CHECK(adi_observer_ReportEvent(aEvent, ADI_OBSERVER_EVENT_MIN_SIZE - 1u, nNow) == ADI_BEACON_MALFORMED);
+    CHECK(adi_observer_ReportEvent(aEvent, nLen - 1u, nNow) == ADI_BEACON_MALFORMED);
+    aEvent[8]--;
+    CHECK(adi_observer_ReportEvent(aEvent, nLen - 1u, nNow) == ADI_BEACON_MALFORMED);
+
+    adi_observer_GetStats(&sStats);
+    CHECK(sStats.nReports == 9u + 2u + 4u);
+    CHECK(sStats.nFrames == 5u);
+    CHECK(sStats.nDuplicates == 6u);
+    CHECK(sStats.nForeign == 1u);
+    CHECK(sStats.nMalformed == 3u);
+
+    CHECK(Flush(nNow + 100u) == 2u);
+    pReading = Reading(1u);
+    CHECK(pReading != NULL);
+    if (pReading != NULL) {
+        CHECK(pReading->sAddr.nAddrType == 1u);
+        CHECK(pReading->sAddr.aBD_ADDR[2] == 0xADu);
+        CHECK(pReading->nRssi == -60);
+        CHECK(pReading->nSeq == 13u);
+        CHECK(pReading->nFrames == 3u);
+        CHECK(pReading->nMissed == 1u);
+        CHECK(pReading->nAge == 110u);
+        CHECK(pReading->nNumValues == 2u);
+        CHECK(pReading->aValues[0].nType == ADI_BEACON_VALUE_TEMPERATURE);
+        CHECK(pReading->aValues[0].nValue == 2501);
+        CHECK(pReading->aValues[1].nType == ADI_BEACON_VALUE_ACCEL_Z);
+        CHECK(pReading->aValues[1].nValue == -101);
+    }
+
+    /* RSSI moves 1/8 of the way, the means of 1, 2 and -1, -2 round away from zero */
+    pReading = Reading(2u);
+    CHECK(pReading != NULL);
+    if (pReading != NULL) {
+        CHECK(pReading->nRssi == -75);
+        CHECK(pReading->nSeq == 0u);
+        CHECK(pReading->nFrames == 2u);
+        CHECK(pReading->nMissed == 0u);
+        CHECK(pReading->nAge == 95u);
+        CHECK(pReading->aValues[0].nValue == 2);
+        CHECK(pReading->aValues[1].nValue == -2);
+    }
+
+    /* Nothing new, nothing to flush; the next batch starts from scratch */
+    CHECK(Flush(nNow + 200u) == 0u);
+    CHECK(Report(1u, -60, 14u, 3000, 0, nNow + 300u) == ADI_BEACON_SUCCESS);
+    CHECK(Report(1u, -60, 14u, 3000, 0, nNow + 310u) == ADI_BEACON_SUCCESS);
+    CHECK(Flush(nNow + 310u) == 1u);
+    pReading = Reading(1u);
+    CHECK((pReading != NULL) && (pReading->nFrames == 1u) && (pReading->nMissed == 0u));
+    CHECK((pReading != NULL) && (pReading->aValues[0].nValue == 3000) && (pReading->nAge == 0u));
+}
+
+/* Sequence gaps across the wrap, restarts and a new set of values */
+static void TestGaps(void)
+{
+    const ADI_OBSERVER_READING *pReading;
+    ADI_BEACON_FRAME sFrame;
+    uint8_t aEvent[ADI_OBSERVER_EVENT_MIN_SIZE + 31u];
+    uint32_t nLen;
+
+    adi_observer_Init();
+    CHECK(Report(3u, -50, 250u, 10, 0, 0u) == ADI_BEACON_SUCCESS);
+    CHECK(Report(3u, -50, 254u, 20, 0, 1u) == ADI_BEACON_SUCCESS);
+    CHECK(Report(3u, -50, 1u, 30, 0, 2u) == ADI_BEACON_SUCCESS);
+    CHECK(Flush(2u) == 1u);
+    pReading = Reading(3u);
+    CHECK((pReading != NULL) && (pReading->nFrames == 3u) && (pReading->nMissed == 3u + 2u));
+    CHECK((pReading != NULL) && (pReading->aValues[0].nValue == 20));
+
+    /* A step back of more than half the sequence space is a restart */
+    CHECK(Report(3u, -50, 200u, 40, 0, 3u) == ADI_BEACON_SUCCESS);
+    CHECK(Report(3u, -50, 201u, 50, 0, 4u) == ADI_BEACON_SUCCESS);
+    CHECK(Flush(4u) == 1u);
+    pReading = Reading(3u);
+    CHECK((pReading != NULL) && (pReading->nFrames == 2u) && (pReading->nMissed == 0u));
+    CHECK((pReading != NULL) && (pReading->nSeq == 201u) && (pReading->aValues[0].nValue == 45));
+
+    /* Other value types restart the averages of the batch */
+    CHECK(Report(3u, -50, 202u, 60, 0, 5u) == ADI_BEACON_SUCCESS);
+    SetFrame(&sFrame, 203u, 0, 0);
+    sFrame.nNumValues = 1u;
+    sFrame.aValues[0].nType = ADI_BEACON_VALUE_BATTERY;
+    sFrame.aValues[0].nValue = 3300;
+    nLen = MakeEvent(aEvent, 3u, -50, &sFrame, 0u);
+    CHECK(adi_observer_ReportEvent(aEvent, nLen, 6u) == ADI_BEACON_SUCCESS);
+    CHECK(Flush(6u) == 1u);
+    pReading = Reading(3u);
+    CHECK((pReading != NULL) && (pReading->nFrames == 1u) && (pReading->nNumValues == 1u));
+    CHECK((pReading != NULL) && (pReading->aValues[0].nType == ADI_BEACON_VALUE_BATTERY));
+    CHECK((pReading != NULL) && (pReading->aValues[0].nValue == 3300));
+
+    /* The same number of values of another type */
+    CHECK(adi_observer_ReportEvent(aEvent, nLen, 7u) == ADI_BEACON_SUCCESS);
+    sFrame.nSeq = 204u;
+    sFrame.aValues[0].nType = ADI_BEACON_VALUE_HUMIDITY;
+    sFrame.aValues[0].nValue = 4500;
+    nLen = MakeEvent(aEvent, 3u, -50, &sFrame, 0u);
+    CHECK(adi_observer_ReportEvent(aEvent, nLen, 8u) == ADI_BEACON_SUCCESS);
+    CHECK(Flush(8u) == 1u);
+    pReading = Reading(3u);
+    CHECK((pReading != NULL) && (pReading->nFrames == 1u));
+    CHECK((pReading != NULL) && (pReading->aValues[0].nType == ADI_BEACON_VALUE_HUMIDITY));
+    CHECK((pReading != NULL) && (pReading->aValues[0].nValue == 4500));
+}
+
+/* A full table evicts the broadcaster heard least recently, across the tick wrap */
+static void TestEviction(void)
+{
+    ADI_OBSERVER_STATS sStats;
+    uint32_t nNow = 0xFFFFFF00u;
+    uint32_t i;
+
+    adi_observer_Init();
+    for (i = 0u; i < ADI_CFG_OBSERVER_NUM_ENTRIES; i++) {
+        CHECK(Report((uint8_t)(10u + i), -40, 0u, (int16_t)i, 0, nNow) == ADI_BEACON_SUCCESS);
+        nNow += 0x20u;
+    }
+
+    /* The first one is heard again, a duplicate counts too */
+    CHECK(Report(10u, -40, 0u, 0, 0, nNow) == ADI_BEACON_SUCCESS);
+    CHECK(Report(10u + ADI_CFG_OBSERVER_NUM_ENTRIES, -40, 0u, 99, 0, nNow + 1u) == ADI_BEACON_SUCCESS);
+    adi_observer_GetStats(&sStats);
+    CHECK(sStats.nEvicted == 1u);
+
+    CHECK(Flush(nNow + 1u) == ADI_CFG_OBSERVER_NUM_ENTRIES);
+    CHECK(Reading(10u) != NULL);
+    CHECK(Reading(11u) == NULL);
+    CHECK(Reading(12u) != NULL);
+    CHECK((Reading(10u + ADI_CFG_OBSERVER_NUM_ENTRIES) != NULL) &&
+          (Reading(10u + ADI_CFG_OBSERVER_NUM_ENTRIES)->aValues[0].nValue == 99));
+
+    /* The evicted broadcaster comes back as a new one, without a gap */
+    CHECK(Report(11u, -40, 5u, 0, 0, nNow + 2u) == ADI_BEACON_SUCCESS);
+    adi_observer_GetStats(&sStats);
+    CHECK(sStats.nEvicted == 2u);
+    CHECK(Flush(nNow + 2u) == 1u);
+    CHECK((Reading(11u) != NULL) && (Reading(11u)->nMissed == 0u));
+    CHECK(Reading(12u) == NULL);
+}
+
+/* Broadcasters silent for ADI_CFG_OBSERVER_STALE_SEC are dropped */
+static void TestExpire(void)
+{
+    const uint32_t nStale = ADI_CFG_OBSERVER_STALE_SEC * ADI_CFG_OBSERVER_TICK_HZ;
+    const uint32_t nStart = 0xFFFFF000u;
+    ADI_OBSERVER_STATS sStats;
+
+    adi_observer_Init();
+    CHECK(Report(20u, -40, 7u, 0, 0, nStart) == ADI_BEACON_SUCCESS);
+    CHECK(Report(21u, -40, 7u, 0, 0, nStart + 100u) == ADI_BEACON_SUCCESS);
+    CHECK(Flush(nStart + 100u) == 2u);
+
+    CHECK(adi_observer_Expire(nStart + nStale) == 0u);
+    CHECK(adi_observer_Expire(nStart + nStale + 1u) == 1u);
+    CHECK(adi_observer_Expire(nStart + nStale + 100u) == 0u);
+    CHECK(adi_observer_Expire(nStart + nStale + 101u) == 1u);
+    adi_observer_GetStats(&sStats);
+    CHECK(sStats.nExpired == 2u);
+    CHECK(sStats.nEvicted == 0u);
+
+    /* Back after a long silence: a new entry, no frames counted as missed */
+    CHECK(Report(20u, -40, 100u, 0, 0, nStart + nStale + 200u) == ADI_BEACON_SUCCESS);
+    CHECK(Flush(nStart + nStale + 200u) == 1u);
+    CHECK((Reading(20u) != NULL) && (Reading(20u)->nMissed == 0u) && (Reading(20u)->nFrames == 1u));
+}
+
+static double Nanoseconds(void)
+{
+    struct timespec sTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+    return ((double)sTime.tv_sec * 1e9) + (double)sTime.tv_nsec;
+}
+
+/* Cost of a report of a busy channel: 16 broadcasters, each frame heard twice */
+static void Bench(void)
+{
+    static uint8_t aEvents[256u][ADI_OBSERVER_EVENT_MIN_SIZE + 31u];
+    static uint32_t aLen[256u];
+    const uint32_t nReports = 4000000u;
+    ADI_BEACON_FRAME sFrame;
+    double fStart;
+    uint32_t i;
+
+    for (i = 0u; i < 256u; i++) {
+        SetFrame(&sFrame, (uint8_t)(i / 32u), (int16_t)i, 0);
+        aLen[i] = MakeEvent(aEvents[i], (uint8_t)(i % 16u), -50, &sFrame, 0u);
+    }
+
+    adi_observer_Init();
+    fStart = Nanoseconds();
+    for (i = 0u; i < nReports; i++) {
+        const uint32_t k = (i / 2u) % 256u;
+
+        (void)adi_observer_ReportEvent(aEvents[k], aLen[k], i);
+    }
+    printf("report: %.1f ns on the host\n", (Nanoseconds() - fStart) / nReports);
+    CHECK(Flush(nReports) == 16u);
+}
+
+int main(void)
+{
+    TestReplay();
+    TestGaps();
+    TestEviction();
+    TestExpire();
+    Bench();
+
+    printf("%s\n", (nFailures != 0) ? "FAILED" : "OK");
+
+    return (nFailures != 0) ? 1 : 0;
+}
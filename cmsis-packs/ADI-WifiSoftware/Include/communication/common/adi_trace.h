@@ -0,0 +1,142 @@
+/*!
+ *****************************************************************************
+   @file:    adi_trace.h
+   @brief:   Binary trace buffer shared by the communication drivers
+   @details: Public function prototypes and trace record layout
+  -----------------------------------------------------------------------------
+
+Copyright (c) 2026 Analog Devices, Inc.
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+  - Redistributions of source code must retain the above copyright notice,
+    this list of conditions and the following disclaimer.
+  - Redistributions in binary form must reproduce the above copyright notice,
+    this list of conditions and the following disclaimer in the documentation
+    and/or other materials provided with the distribution.
+  - Modified versions of the software must be conspicuously marked as such.
+  - This software is licensed solely and exclusively for use with processors
+    manufactured by or for Analog Devices, Inc.
+  - This software may not be combined or merged with other code in any manner
+    that would cause the software to become subject to terms and conditions
+    which differ from those listed here.
+  - Neither the name of Analog Devices, Inc. nor the names of its
+    contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+  - The use of this software may or may not infringe the patent rights of one
+    or more patent holders.  This license does not release you from the
+    requirement that you obtain separate licenses from these patent holders
+    to use this software.
+
+THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES, INC. AND CONTRIBUTORS "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+TITLE, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN
+NO EVENT SHALL ANALOG DEVICES, INC. OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, PUNITIVE OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, DAMAGES ARISING OUT OF CLAIMS OF INTELLECTUAL
+PROPERTY RIGHTS INFRINGEMENT; PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+/*****************************************************************************/
+
+/** @addtogroup adi_trace Trace Interface
+ *  @ingroup Utilities
+ *  @{
+ *
+ *  @brief Trace Interface
+ *  @details  Fixed size binary trace buffer. Each record holds an RTC
+ *            timestamp, the module and event ids and one data word. Records
+ *            can be written from any context, including interrupts, and are
+ *            read out as a binary frame with adi_trace_Dump().
+ */
+
+#ifndef ADI_TRACE_H
+#define ADI_TRACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*! Number of records kept in the trace buffer, a power of two no larger than 128. */
+#ifndef ADI_CFG_TRACE_NUM_ENTRIES
+#define ADI_CFG_TRACE_NUM_ENTRIES       (64u)
+#endif
+
+/*! Timestamp source of the trace records. */
+#ifndef ADI_CFG_TRACE_GET_TIME
+#define ADI_CFG_TRACE_GET_TIME()        adi_GetRTCTime()
+#endif
+
+/*! Frequency of the timestamp source in Hz, the RTC prescaler of adi_RTCInit() gives 1024 Hz. */
+#ifndef ADI_CFG_TRACE_TICK_HZ
+#define ADI_CFG_TRACE_TICK_HZ           (1024u)
+#endif
+
+/*! First byte of a dump frame. */
+#define ADI_TRACE_SYNC0                 (0x54u)
+/*! Second byte of a dump frame. */
+#define ADI_TRACE_SYNC1                 (0x52u)
+/*! Version of the dump frame layout. */
+#define ADI_TRACE_VERSION               (1u)
+/*! Module id of a record that was overwritten while it was being dumped. */
+#define ADI_TRACE_MODULE_LOST           (0xFFu)
+
+/*!
+ *  @enum ADI_TRACE_MODULE
+ *
+ *  @brief  Module ids, used by the decoder to pick the event name table.
+ */
+typedef enum
+{
+    ADI_TRACE_MODULE_APP  = 0u,     /*!< Application events.     */
+    ADI_TRACE_MODULE_WIFI = 1u,     /*!< ADI_WIFI_LOG_ID events. */
+    ADI_TRACE_MODULE_BLE  = 2u      /*!< ADI_BLE_LOG_ID events.  */
+} ADI_TRACE_MODULE;
+
+/*!
+ *  @struct ADI_TRACE_RECORD
+ *
+ *  @brief  One trace record, sent as is (little endian) by adi_trace_Dump().
+ */
+typedef struct
+{
+    uint32_t    nTimeStamp;         /*!< Timestamp in ADI_CFG_TRACE_TICK_HZ ticks.            */
+    uint16_t    nEvent;             /*!< Event id, meaning depends on the module.             */
+    uint8_t     nModule;            /*!< ADI_TRACE_MODULE of the event.                       */
+    uint8_t     nSeq;               /*!< Low byte of the sequence number, written last.       */
+    uint32_t    nData;              /*!< Data associated with the event.                      */
+} ADI_TRACE_RECORD;
+
+/*!
+ *  @struct ADI_TRACE_STATS
+ *
+ *  @brief  Trace buffer counters.
+ */
+typedef struct
+{
+    uint32_t    nLogged;            /*!< Records written since reset.                         */
+    uint32_t    nDumped;            /*!< Records sent by adi_trace_Dump().                    */
+    uint32_t    nLost;              /*!< Records overwritten before they could be dumped.     */
+} ADI_TRACE_STATS;
+
+/*! Function used by adi_trace_Dump() to send the frame, e.g. a blocking UART write. */
+typedef void (*ADI_TRACE_WRITE_FN)(const uint8_t *pData, uint32_t nSize);
+
+void adi_trace_Event(const ADI_TRACE_MODULE eModule, const uint16_t nEvent, const uint32_t nData);
+uint32_t adi_trace_Dump(ADI_TRACE_WRITE_FN pfWrite);
+void adi_trace_GetStats(ADI_TRACE_STATS *pStats);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ADI_TRACE_H */
+/* @} */
@@ -100,16 +100,14 @@ typedef enum
 
 #if (ADI_CFG_WIFI_LOGEVENT == 1)
 #include <stdint.h>
+#include <common/adi_trace.h>
 
 void adi_wifi_LogEvent(const ADI_WIFI_LOG_ID event);
 void adi_wifi_LogEventData(const ADI_WIFI_LOG_ID event,const uint32_t data);
 
-#define ADI_WIFI_LOGEVENT(event)             adi_wifi_LogEvent(event)
-#define ADI_WIFI_LOGEVENT_DATA(event,data)   adi_wifi_LogEventData(event,data);
-
-static inline uint32_t ADI_WIFI_GET_TIMESTAMP()   {
-     return 0;
-   } // FIXME
+/* Trace points go straight to the shared trace buffer */
+#define ADI_WIFI_LOGEVENT(event)             adi_trace_Event(ADI_TRACE_MODULE_WIFI, (uint16_t)(event), 0u)
+#define ADI_WIFI_LOGEVENT_DATA(event,data)   adi_trace_Event(ADI_TRACE_MODULE_WIFI, (uint16_t)(event), (data))
 
 #else
 #define ADI_WIFI_LOGEVENT(event)
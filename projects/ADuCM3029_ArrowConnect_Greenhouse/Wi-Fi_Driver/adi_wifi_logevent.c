@@ -57,46 +57,22 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  @ingroup WiFi
  *  @{
  */
-#include <radio/adi_wifi_logevent.h>
-
-/*! \cond PRIVATE */
-static  ADI_WIFI_LOGEVENT_DATA gWiFiLogEvents[ADI_CFG_WIFI_NUM_LOGEVENT_ENTRIES];
-static  int32_t gEvtIndx;
-/*! \endcond */
-
-/*! Maximum number of entries in the log buffer. */
-#define ADI_CFG_WIFI_NUM_LOGEVENT_ENTRIES    (20u)
+#include <adi_wifi_logevent.h>
 
 /*!
- *  @struct ADI_WIFI_LOGEVENT_DATA
- *
- *  @brief  Data structure for the event logging module.
- *
- */
-typedef struct 
-{
-    ADI_WIFI_LOG_ID  event;       	/*!< Log event id. 						            */
-    uint32_t         data;         	/*!< Data associated with the event. 	    */
-    uint32_t         timeStamp;    	/*!< Time stamp associated with the event.*/
-} ADI_WIFI_LOGEVENT_DATA;
-
-/*!
- * @brief       Logs the specified event to the event buffer with a time stamp.
+ * @brief       Logs the specified event to the trace buffer with a time stamp.
  *
  * @param [in]  eEvent :  Event being logged.
  *
  */
 void adi_wifi_LogEvent(const ADI_WIFI_LOG_ID eEvent)
 {
-   gWiFiLogEvents[gEvtIndx].event     = eEvent;
-   gWiFiLogEvents[gEvtIndx].timeStamp = ADI_WIFI_GET_TIMESTAMP();
-   gEvtIndx++;
-   if (gEvtIndx >= ADI_CFG_WIFI_NUM_LOGEVENT_ENTRIES) gEvtIndx = 0;
+    adi_trace_Event(ADI_TRACE_MODULE_WIFI, (uint16_t)eEvent, 0u);
 }
 
 
 /*!
- * @brief       Logs the specified event to the event buffer with a time stamp and data.
+ * @brief       Logs the specified event to the trace buffer with a time stamp and data.
  *
  * @param [in]  eEvent :  Event being logged.
  *
@@ -105,13 +81,7 @@ void adi_wifi_LogEvent(const ADI_WIFI_LOG_ID eEvent)
  */
 void adi_wifi_LogEventData(const ADI_WIFI_LOG_ID eEvent,const uint32_t nData)
 {
-	gWiFiLogEvents[gEvtIndx].event      = eEvent;
-	gWiFiLogEvents[gEvtIndx].data       = data;
-	gWiFiLogEvents[gEvtIndx].timeStamp  = ADI_WIFI_GET_TIMESTAMP();
-
-   gEvtIndx++;
-
-   if (gEvtIndx >= ADI_CFG_WIFI_NUM_LOGEVENT_ENTRIES) gEvtIndx = 0;
+    adi_trace_Event(ADI_TRACE_MODULE_WIFI, (uint16_t)eEvent, nData);
 }
 
 /*@}*/
@@ -121,4 +91,3 @@ void adi_wifi_LogEventData(const ADI_WIFI_LOG_ID eEvent,const uint32_t nData)
 #endif
 
 #endif /* ADI_CFG_WIFI_LOGEVENT */
-
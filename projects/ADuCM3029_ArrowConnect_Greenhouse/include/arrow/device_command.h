@@ -6,6 +6,17 @@ extern "C" {
 #endif
 
 #include <json/json.h>
+#include <unint.h>
+
+#ifndef CMD_HANDLERS_MAX
+// size of the static command handler table
+#define CMD_HANDLERS_MAX 8
+#endif
+
+#ifndef CMD_HASH_SIZE
+// slots of the name hash, a power of two larger than CMD_HANDLERS_MAX
+#define CMD_HASH_SIZE 16
+#endif
 
 typedef enum {
     failed,
@@ -22,23 +33,43 @@ typedef enum {
 
 typedef int (*fp)(const char *);
 
+// execution statistics of a command
+typedef struct {
+  uint32_t calls;    // callback executions
+  uint32_t failed;   // executions that returned < 0
+  uint32_t limited;  // commands dropped by the rate limit
+  uint32_t max_ms;   // longest execution
+} cmd_stats_t;
+
 typedef struct __cmd_handler {
-  char *name;
+  const char *name;
+  uint32_t hash;
   fp callback;
-  struct __cmd_handler *next;
+  uint32_t min_interval;
+  uint64_t last;
+  cmd_stats_t stats;
 } cmd_handler;
 
 // Find and execute 'name' command handler for this 'payload'
+// on failure 'error' is set to a static message
 int command_handler(const char *name,
                     JsonNode *payload,
-                    JsonNode **error);
+                    const char **error);
 
 // Is there any command handler was added
 int has_cmd_handler(void);
 
 // Add a new command handler ( set the callback )
+// the name is not copied, it must stay valid (a string literal)
+// returns -1 when all CMD_HANDLERS_MAX entries are used
 int add_cmd_handler(const char *name, fp callback);
 
+// execute 'name' at most once per min_interval ms, 0 - no limit
+int set_cmd_handler_rate(const char *name, uint32_t min_interval);
+
+// execution statistics of 'name', NULL if there is no such handler
+const cmd_stats_t *cmd_handler_stats(const char *name);
+
 // erase all command handlers
 void free_cmd_handler(void);
 
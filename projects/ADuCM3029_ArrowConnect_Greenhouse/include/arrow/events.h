@@ -1,18 +1,29 @@
 #if !defined(ARROW_EVENTS_H_)
 #define ARROW_EVENTS_H_
 
+#include <json/json.h>
+
+// the strings point into the parsed event
 typedef struct {
-  char *gateway_hid;
-  char *device_hid;
-  char *name;
+  const char *gateway_hid;
+  const char *device_hid;
+  const char *name;
   int encrypted;
-  char *cmd;
-  char *payload;
+  const char *cmd;
+  const char *payload;
 } mqtt_event_t;
 
 int process_event(const char *str);
 
+// typed access to the members of a parsed event, nothing is copied
+// NULL or -1 if the member is missing or has another type
+const char *event_param_string(JsonNode *node, const char *name);
+int event_param_number(JsonNode *node, const char *name, double *value);
+int event_param_bool(JsonNode *node, const char *name, int *value);
+
+// limits of the canonical parameter string of a signed event
 #define MAX_PARAM_LINE 20
 #define MAX_PARAM_LINE_SIZE 256
+#define MAX_PARAM_SIZE 1024
 
 #endif // ARROW_EVENTS_H_
@@ -17,4 +17,10 @@ int gateway_payload_sign(char *signature,
                          const char *canParString,
                          const char *signatureVersion);
 
+// the same signature from the SHA-256 of the canonical request
+// "hid\nname\nencrypted\ncanParString\n"
+int gateway_payload_sign_hash(char *signature,
+                              const char *hash_canonical_req,
+                              const char *signatureVersion);
+
 #endif // _ARROW_GATEWAY_PAYLOAD_SIGN_H_
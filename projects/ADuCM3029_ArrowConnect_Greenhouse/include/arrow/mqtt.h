@@ -37,6 +37,8 @@ int mqtt_yield(int timeout_ms);
 
 // Send the telemetry data to the cloud
 // there is extremely needed the telemetry_serialize function implementation to serealize 'data' correctly
+// returns BUFFER_OVERFLOW when the outbound queue is full (nothing was sent),
+// any other negative value means the connection is broken
 int mqtt_publish(arrow_device_t *device, void *data);
 
 #if defined(__cplusplus)
@@ -8,6 +8,21 @@ extern "C" {
 #include <arrow/gateway.h>
 #include <arrow/device.h>
 
+#ifndef ARROW_OTA_RESUME_TRIES
+// download attempts in a row without progress before the update fails
+#define ARROW_OTA_RESUME_TRIES 5
+#endif
+
+#ifndef ARROW_OTA_RESUME_DELAY
+// pause before a download is resumed, ms
+#define ARROW_OTA_RESUME_DELAY 2000
+#endif
+
+#ifndef ARROW_OTA_MAX_BOOTS
+// starts of a new image without a cloud connection before it is rolled back
+#define ARROW_OTA_MAX_BOOTS 3
+#endif
+
 typedef int (*__release_cb)(const char *url,
                            const char *chsum,
                            const char *from,
@@ -39,8 +54,20 @@ int arrow_software_releases_trans_success(const char *hid);
 int arrow_software_releases_trans_start(const char *hid);
 
 // DeviceSoftwareRelease event handler
+// without a download callback the file is streamed to the staging slot,
+// resumed after a dropped link and checked against md5checksum
 int ev_DeviceSoftwareRelease(void *_ev, JsonNode *_parameters);
 
+// count the starts of a newly installed image, call once at boot
+// the staged image counts as installed when the bootloader flagged it
+// or when GATEWAY_SOFTWARE_VERSION is the staged version
+// returns -1 when the image has to be rolled back
+int arrow_software_release_boot(void);
+
+// report the result of the last update once the cloud is connected
+// an image that is still only staged is reported as failed
+int arrow_software_release_confirm(void);
+
 int arrow_software_release_download(const char *token, const char *tr_hid);
 
 // set software release download callback
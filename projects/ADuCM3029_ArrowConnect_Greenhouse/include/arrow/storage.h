@@ -32,6 +32,33 @@ typedef struct {
 } flash_mem_t;
 
 
+#define OTA_META_MAGIC 0x4f544131
+
+#ifndef OTA_WRITE_SIZE
+// the image is written to the staging slot in blocks of this size
+#define OTA_WRITE_SIZE 256
+#endif
+
+// state of the staged firmware image
+typedef enum {
+  ota_empty,      // nothing staged
+  ota_staged,     // verified image waiting to be installed by the bootloader
+  ota_trial,      // new image booted but not confirmed yet
+  ota_confirmed,  // new image connected to the cloud
+  ota_rollback,   // new image failed to confirm, the previous one is restored
+  ota_installed   // set by the bootloader once it copied the staged image
+} ota_state_t;
+
+// metadata of the staging slot, shared with the bootloader
+typedef struct {
+  int magic;
+  int state;
+  uint32_t size;
+  int boots;
+  char md5[16];
+  char trans_hid[64];
+  char version[32];
+} ota_meta_t;
 
 int init_flash(void);
 
@@ -55,6 +82,22 @@ int restore_wifi_setting(char *ssid, char *pass, int *sec);
 // save the wifi settings (SSID, password, secure mode)
 void save_wifi_setting(const char *ssid, const char *pass, int sec);
 
+// size of the firmware staging slot
+uint32_t ota_slot_size(void);
+
+// write a block to the staging slot, offset is a multiple of OTA_WRITE_SIZE
+// a flash page is erased when its first block is written
+int ota_slot_write(uint32_t offset, const char *buf, uint32_t size);
+
+// read back the staging slot
+int ota_slot_read(uint32_t offset, char *buf, uint32_t size);
+
+// restore the staging slot metadata
+int ota_meta_restore(ota_meta_t *meta);
+
+// save the staging slot metadata
+int ota_meta_save(const ota_meta_t *meta);
+
 #if defined(__cplusplus)
 }
 #endif
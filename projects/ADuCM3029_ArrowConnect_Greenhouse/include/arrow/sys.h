@@ -1,6 +1,14 @@
 #if !defined(ARROW_SYS_H_)
 #define ARROW_SYS_H_
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
 void reboot(void);
 
+#if defined(__cplusplus)
+}
+#endif
+
 #endif  // ARROW_SYS_H_
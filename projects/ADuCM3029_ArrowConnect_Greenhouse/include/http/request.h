@@ -97,6 +97,7 @@ typedef struct __attribute_packed__ {
 typedef struct {
     int m_httpResponseCode;
     int is_chunked;
+    int content_length;
     http_header_t *header;
     http_header_t content_type;
     http_payload_t payload;
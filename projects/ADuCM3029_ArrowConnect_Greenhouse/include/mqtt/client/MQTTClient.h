@@ -49,6 +49,14 @@
 #define MAX_MESSAGE_HANDLERS 5 /* redefinable - how many subscriptions do you want? */
 #endif
 
+#if !defined(MAX_INFLIGHT_MESSAGES)
+#define MAX_INFLIGHT_MESSAGES 4 /* redefinable - QoS1/QoS2 publishes sent and not yet acknowledged */
+#endif
+
+#if !defined(MAX_QUEUED_MESSAGES)
+#define MAX_QUEUED_MESSAGES 8 /* redefinable - publishes held in the outbound queue, in flight ones included */
+#endif
+
 enum QoS { QOS0, QOS1, QOS2 };
 
 /* all failure return codes must be negative */
@@ -87,6 +95,19 @@ typedef struct MessageData {
 
 typedef void (*messageHandler)(MessageData*);
 
+typedef void (*deliveryHandler)(unsigned short);
+
+enum outboundState { OUTBOUND_QUEUED, OUTBOUND_SENT, OUTBOUND_PUBREL, OUTBOUND_DONE };
+
+/* A serialized PUBLISH packet waiting to be sent or acknowledged */
+typedef struct MQTTOutbound {
+    size_t offset;
+    int len;
+    unsigned short id;
+    unsigned char qos;
+    unsigned char state;
+} MQTTOutbound;
+
 typedef struct MQTTClient {
     unsigned short int next_packetid;
     unsigned int command_timeout_ms;
@@ -106,6 +127,19 @@ typedef struct MQTTClient {
 
     void (*defaultMessageHandler) (MessageData*);
 
+    /* Not touched by MQTTClientInit so that it survives reconnects */
+    struct OutboundQueue
+    {
+        unsigned char *buf;
+        size_t buf_size;
+        size_t end;                                 /* first free byte after the newest packet */
+        int head;                                   /* oldest entry */
+        int count;
+        int inflight;
+        MQTTOutbound entries[MAX_QUEUED_MESSAGES];
+        deliveryHandler fp;
+    } outbound;
+
     Network* ipstack;
     TimerInterval ping_timer;
 #if defined(MQTT_TASK)
@@ -142,6 +176,32 @@ DLLExport int MQTTConnect(MQTTClient* client, MQTTPacket_connectData* options);
  */
 DLLExport int MQTTPublish(MQTTClient* client, const char*, MQTTMessage*);
 
+/** MQTT Outbound Init - give the client a buffer for the outbound queue.  Must be called once,
+ *  before the first connect, and not again on reconnect or the queued messages are lost.
+ *  @param client - the client object to use
+ *  @param buf - storage for the serialized PUBLISH packets
+ *  @param buf_size - size of buf
+ *  @param fp - called with the packet id when a QoS1/QoS2 publish is acknowledged, may be NULL
+ */
+DLLExport void MQTTOutboundInit(MQTTClient* client, unsigned char* buf, size_t buf_size, deliveryHandler fp);
+
+/** MQTT Publish Async - queue an MQTT publish packet and send it without waiting for acks.
+ *  At most MAX_INFLIGHT_MESSAGES QoS1/QoS2 publishes wait for acks at a time, the others stay
+ *  queued. Unacknowledged publishes are sent again with DUP set after MQTTConnect.
+ *  @param client - the client object to use
+ *  @param topic - the topic to publish to
+ *  @param message - the message to send, message->id is set for QoS1/QoS2
+ *  @return packet id for QoS1/QoS2, MQTT_SUCCESS for QoS0, BUFFER_OVERFLOW if the queue is
+ *  full, FAILURE if the client is disconnected or sending failed - the message stays queued
+ */
+DLLExport int MQTTPublishAsync(MQTTClient* client, const char*, MQTTMessage*);
+
+/** MQTT Outbound Pending - number of queued publishes, in flight ones included
+ *  @param client - the client object to use
+ *  @return number of messages
+ */
+DLLExport int MQTTOutboundPending(MQTTClient* client);
+
 /** MQTT Subscribe - send an MQTT subscribe packet and wait for suback before returning.
  *  @param client - the client object to use
  *  @param topicFilter - the topic filter to subscribe to
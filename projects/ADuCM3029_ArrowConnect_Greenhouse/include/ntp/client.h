@@ -72,22 +72,69 @@ NTP Client header file
 ///NTP client results
 enum NTPResult
 {
-  NTP_DNS, ///<Could not resolve name
-  NTP_PRTCL, ///<Protocol error
-  NTP_TIMEOUT, ///<Connection timeout
-  NTP_CONN, ///<Connection error
+  NTP_DNS = -1, ///<Could not resolve name
+  NTP_PRTCL = -2, ///<Protocol error
+  NTP_TIMEOUT = -3, ///<Connection timeout
+  NTP_CONN = -4, ///<Connection error
+  NTP_KOD = -5, ///<Kiss-o'-Death, the server asks not to be used
   NTP_OK = 0, ///<Success
 };
 
+#ifndef NTP_SAMPLES
+///Requests sent per sync, the one with the shortest round trip is used
+#define NTP_SAMPLES 4
+#endif
+
+#ifndef NTP_SAMPLE_GAP_MS
+///Pause between the requests of one sync
+#define NTP_SAMPLE_GAP_MS 2000
+#endif
+
+#ifndef NTP_MAX_DELAY_MS
+///Samples with a longer round trip are not used
+#define NTP_MAX_DELAY_MS 1000
+#endif
+
+#ifndef NTP_FIT_POINTS
+///Syncs kept to fit the frequency of the local clock
+#define NTP_FIT_POINTS 8
+#endif
+
+#ifndef NTP_FIT_SPAN_MS
+///Shortest time between the first and last kept sync for a frequency fit
+#define NTP_FIT_SPAN_MS 600000
+#endif
+
+#ifndef NTP_MAX_FREQ_PPB
+///Largest frequency correction applied to the local clock
+#define NTP_MAX_FREQ_PPB 500000
+#endif
+
+///Result of the last successful sync
+struct NTPStatus
+{
+  int64_t offset; ///<Clock offset of the selected sample in ms
+  int64_t delay; ///<Round trip delay of the selected sample in ms
+  int32_t freq; ///<Frequency correction of the local clock in ppb
+  uint32_t kod; ///<Kiss code of the last Kiss-o'-Death, ASCII, 0 if none
+};
+
 
 /**Get current time (blocking)
   Update the time using the server host
   Blocks until completion
+  Sends NTP_SAMPLES requests, the reply with the shortest round trip
+  is used. Small offsets are slewed in, the frequency of the local clock
+  is fitted over the last NTP_FIT_POINTS syncs.
   @param host NTP server IPv4 address or hostname (will be resolved via DNS)
   @param port port to use; defaults to 123
   @param timeout waiting timeout in ms (osWaitForever for blocking function, not recommended)
-  @return 0 on success, NTP error code (<0) on failure
+  @return 0 on success, NTP error code on failure, NTP_KOD if the server sent a
+  DENY or RSTR kiss or rate limited every request
  */
 int ntp_set_time(const char* host, uint16_t port, uint32_t timeout);
 
+///Result of the last successful sync
+const struct NTPStatus *ntp_status(void);
+
 #endif /* NTPCLIENT_H_ */
@@ -13,6 +13,12 @@
 #define NTP_DEFAULT_SERVER "0.pool.ntp.org"
 #endif
 
+#ifndef NTP_SERVERS
+// servers tried in turn by ntp_set_time_cycle, the next one is used
+// after a failure or a kiss-o'-death
+#define NTP_SERVERS NTP_DEFAULT_SERVER, "1.pool.ntp.org", "2.pool.ntp.org"
+#endif
+
 #ifndef NTP_DEFAULT_PORT
 #define NTP_DEFAULT_PORT 123
 #endif
@@ -29,6 +35,7 @@ extern "C" {
 #include <sys/platform.h>
 
 int ntp_set_time_cycle(void);
+// server NULL: rotate through NTP_SERVERS
 int ntp_set_time_common(const char *server, uint16_t port, int timeout, int try_times);
 
 #if defined(__cplusplus)
@@ -12,4 +12,9 @@
 void sha256(char *shasum, char *buf, int size);
 void hmac256(char *hmacdig, const char *key, int key_size, const char *buf, int buf_size);
 
+// SHA-256 of data passed in pieces
+void sha256_chunk_init(void);
+void sha256_chunk(const char *data, int len);
+void sha256_chunk_hash(char *shasum);
+
 #endif // _ARROW_INCLUDE_CRYPT_SHA256_H_
@@ -6,5 +6,7 @@ int md5sum(char *hash, const char *data, int len);
 void md5_chunk_init();
 void md5_chunk(const char *data, int len);
 void md5_chunk_hash(char *hash);
+// hash of the data so far, the chunk sum can be continued
+void md5_chunk_peek(char *hash);
 
 #endif  // ARROW_MD5SUM_H_
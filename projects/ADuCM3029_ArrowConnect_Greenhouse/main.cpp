@@ -56,6 +56,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <arrow/mqtt.h>
 #include <arrow/storage.h>
 #include <arrow/software_release.h>
+#include <arrow/sys.h>
 #include "sensors_data.h"
 #include <arrow/device_command.h>
 #include <arrow/storage.h>
@@ -252,6 +253,12 @@ int main(int argc, char *argv[])
 
 	RTC_Init();
 
+	/* Count the starts of a new firmware image, roll back an unconfirmed one */
+	if (arrow_software_release_boot() < 0)
+	{
+		reboot();
+	}
+
 	/*Initialize the sensors*/
 	cn0398->setup();
 	cn0398->init();
@@ -287,6 +294,9 @@ int main(int argc, char *argv[])
 	// establish the MQTT connection
 	arrow_mqtt_connect_routine();
 
+	/* The cloud is reachable, report the result of the last update */
+	arrow_software_release_confirm();
+
 	/*set command leds handler*/
 	add_cmd_handler("leds", Leds_Controll);
 
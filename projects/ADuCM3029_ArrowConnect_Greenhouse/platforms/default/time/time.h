@@ -10,11 +10,23 @@
 #define COMMON_TIME_TIME_H_
 
 #include <config.h>
+#include <unint.h>
 #include <time.h>
 #include <sys/time.h>
 
 #if defined(__cplusplus)
 extern "C" {
+#endif
+
+#ifndef CLOCK_STEP_MS
+// offsets larger than this are stepped, smaller ones are slewed
+#define CLOCK_STEP_MS 1000
+#endif
+
+#ifndef CLOCK_SLEW_PPM
+// rate at which an offset is slewed in
+#define CLOCK_SLEW_PPM 500
+#endif
 
 int RTC_Init(void);
 int msleep(int m_sec);
@@ -24,10 +36,16 @@ time_t build_time(void);
 void set_time(time_t t);
 #endif
 
+// free running local clock in ms, provided by the platform
+uint64_t local_time_ms(void);
+// disciplined UTC time in ms of a local_time_ms() reading
+int64_t clock_wall_ms(uint64_t local_ms);
+// the UTC time at local_ms is wall_ms, the local clock runs freq_ppb slow
+void clock_discipline(uint64_t local_ms, int64_t wall_ms, int32_t freq_ppb);
+int32_t clock_freq_ppb(void);
+
 #if defined(__cplusplus)
 }
 #endif
 
-#endif
-
 # endif // COMMON_TIME_TIME_H_
@@ -30,6 +30,22 @@ uint32_t nStartPage, nEndPage, nBlockNum;
 /* Buffer Size */
 #define BUFF_SIZE                (2048u)
 
+/* Flash page size */
+#define FLASH_PAGE_SIZE          (0x800u)
+
+/* Staging slot metadata, the page after the settings */
+#ifndef OTA_META_ADDR
+#define OTA_META_ADDR            (0x20800u)
+#endif
+
+/* Staging slot for the firmware image, up to the last page */
+#ifndef OTA_SLOT_ADDR
+#define OTA_SLOT_ADDR            (0x21000u)
+#endif
+#ifndef OTA_SLOT_SIZE
+#define OTA_SLOT_SIZE            (0x1E000u)
+#endif
+
 flash_mem_t mem;
 
 int init_flash(void)
@@ -142,3 +158,98 @@ int restore_wifi_setting(char *ssid, char *pass, int *sec) {
     // FIXME restore this wifi settings
     return -1;
 }
+
+static int ota_erase_page(uint32_t addr)
+{
+	uint32_t nPage;
+
+	if (fee_handle == NULL)
+	{
+		init_flash();
+	}
+	if (adi_fee_GetPageNumber(fee_handle, addr, &nPage) != ADI_FEE_SUCCESS)
+	{
+		return -1;
+	}
+	if (adi_fee_PageErase(fee_handle, nPage, nPage, &HwErrors) != ADI_FEE_SUCCESS)
+	{
+		return -1;
+	}
+	return 0;
+}
+
+static int ota_program(uint32_t addr, const void *data, uint32_t size)
+{
+	fee_transaction.bUseDma = false;
+	fee_transaction.pWriteAddr = (uint32_t *)addr;
+	fee_transaction.pWriteData = (uint32_t *)data;
+	fee_transaction.nSize = size;
+
+	if (adi_fee_Write(fee_handle, &fee_transaction, &HwErrors) != ADI_FEE_SUCCESS)
+	{
+		return -1;
+	}
+	return 0;
+}
+
+uint32_t ota_slot_size(void)
+{
+	return OTA_SLOT_SIZE;
+}
+
+int ota_slot_write(uint32_t offset, const char *buf, uint32_t size)
+{
+	/* The flash is programmed in double words, pad the last block */
+	static uint32_t block[OTA_WRITE_SIZE / 4];
+
+	if (size > OTA_WRITE_SIZE || offset + size > OTA_SLOT_SIZE)
+	{
+		return -1;
+	}
+	if ((offset % FLASH_PAGE_SIZE) == 0)
+	{
+		if (ota_erase_page(OTA_SLOT_ADDR + offset) < 0)
+		{
+			return -1;
+		}
+	}
+	memset(block, 0xFF, sizeof(block));
+	memcpy(block, buf, size);
+
+	return ota_program(OTA_SLOT_ADDR + offset, block, (size + 7u) & ~7u);
+}
+
+int ota_slot_read(uint32_t offset, char *buf, uint32_t size)
+{
+	if (offset + size > OTA_SLOT_SIZE)
+	{
+		return -1;
+	}
+	return read_from_flash((uint32_t *)buf, OTA_SLOT_ADDR + offset, size);
+}
+
+int ota_meta_restore(ota_meta_t *meta)
+{
+	read_from_flash((uint32_t *)meta, OTA_META_ADDR, sizeof(ota_meta_t));
+
+	if (meta->magic != OTA_META_MAGIC)
+	{
+		memset(meta, 0, sizeof(ota_meta_t));
+		return -1;
+	}
+	return 0;
+}
+
+int ota_meta_save(const ota_meta_t *meta)
+{
+	static uint32_t copy[(sizeof(ota_meta_t) + 7u) / 4];
+
+	if (ota_erase_page(OTA_META_ADDR) < 0)
+	{
+		return -1;
+	}
+	memset(copy, 0xFF, sizeof(copy));
+	memcpy(copy, meta, sizeof(ota_meta_t));
+
+	return ota_program(OTA_META_ADDR, copy, (sizeof(ota_meta_t) + 7u) & ~7u);
+}
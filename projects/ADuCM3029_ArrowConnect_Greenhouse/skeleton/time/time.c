@@ -16,7 +16,10 @@ ADI_RTC_HANDLE hDevRtc  = NULL;
 
 
 /*!  The RTC prescalar can be caluculated using the equation: 1/(32768/2^Prescalar). Set prescalar to 5u for .97 ms precision */
-#define ADI_RTC_PRESCALAR       (15u)
+#define ADI_RTC_PRESCALAR       (5u)
+
+/*! RTC ticks per second with ADI_RTC_PRESCALAR */
+#define ADI_RTC_TICK_HZ         (32768u >> ADI_RTC_PRESCALAR)
 
 /*! Device memory to operate the RTC device */
 static uint8_t aRtcDevMem[ADI_RTC_MEMORY_SIZE];
@@ -40,20 +43,34 @@ int RTC_Init(void)
 	return eRTCResult;
 }
 
+/* The 32 bit RTC count wraps after 48 days, extend it with the number of wraps */
+uint64_t local_time_ms(void) {
+
+	static uint32_t last_count = 0;
+	static uint64_t wraps = 0;
+	uint32_t count;
+
+	if (adi_rtc_GetCount(hDevRtc, &count) != ADI_RTC_SUCCESS)
+		count = last_count;
+
+	if (count < last_count)
+		wraps += 1ull << 32;
+	last_count = count;
+
+	return ((wraps + count) * 1000u) / ADI_RTC_TICK_HZ;
+}
+
 void get_time(char *ts) {
 
-	char buffer[128];
 	struct tm *tmp;
 	int ms;
+	int64_t wall = clock_wall_ms(local_time_ms());
 
-	time_t rawtime;
+	time_t rawtime = (time_t)(wall / 1000);
 
-	/* get the RTC count through the "time" CRTL function */
-	adi_rtc_GetCount(hDevRtc, &rawtime);
 	tmp = gmtime(&rawtime); //fill tmp with coresponding time in UTC
 
-	//need to get the ms from the RTC fraction
-	ms = 0;
+	ms = (int)(wall % 1000);
 
 
 	sprintf(ts, "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", 1900+tmp->tm_year, tmp->tm_mon+1, tmp->tm_mday, tmp->tm_hour, tmp->tm_min, tmp->tm_sec, ms);
@@ -66,20 +83,17 @@ static void get_time_of_day(struct timeval *tval) {
 
 int gettimeofday(struct timeval *__restrict __p,  void *__restrict __tz) {
 
-	//get time of day in seconds and ms
-	adi_rtc_GetCount(hDevRtc, &(__p->tv_sec));
+	int64_t wall = clock_wall_ms(local_time_ms());
 
-	//ms read
-	__p->tv_usec = 0;
+	__p->tv_sec = (time_t)(wall / 1000);
+	__p->tv_usec = (suseconds_t)(wall % 1000) * 1000;
 
     return 0;
 }
 
 time_t time(time_t *timer) {
 
-	time_t rawtime;
-
-	adi_rtc_GetCount(hDevRtc, &rawtime);
+	time_t rawtime = (time_t)(clock_wall_ms(local_time_ms()) / 1000);
 
 	if ( timer ) *timer = rawtime;
 	return rawtime;
@@ -88,8 +102,7 @@ time_t time(time_t *timer) {
 
 int stime(time_t *timer) {
 
-	time_t rawtime = *timer;
-	adi_rtc_SetCount (hDevRtc, *timer);
+	set_time(*timer);
     return 0;
 }
 
@@ -13,77 +13,121 @@
 #include <arrow/events.h>
 #include <debug.h>
 
-static cmd_handler *__handlers = NULL;
+#include <time/time.h>
+
+#if CMD_HASH_SIZE <= CMD_HANDLERS_MAX || (CMD_HASH_SIZE & (CMD_HASH_SIZE - 1))
+# error "CMD_HASH_SIZE must be a power of two larger than CMD_HANDLERS_MAX"
+#endif
+
+static cmd_handler __handlers[CMD_HANDLERS_MAX];
+static int __handlers_count = 0;
+// index + 1 of the handler in __handlers, 0 - empty slot
+static uint8_t __hash_slots[CMD_HASH_SIZE];
+
+// FNV-1a
+static uint32_t cmd_hash(const char *name) {
+  uint32_t h = 2166136261u;
+  while ( *name ) {
+    h ^= (uint8_t)*name++;
+    h *= 16777619u;
+  }
+  return h;
+}
 
-static void __create_cmd_handler(cmd_handler *hd, const char *name, fp callback) {
-  hd->name = malloc(strlen(name)+1);
-  strcpy(hd->name, name);
-  hd->callback = callback;
-  hd->next = NULL;
+// the slot of 'name' or of the empty slot where it goes
+static int cmd_slot(const char *name, uint32_t hash) {
+  int slot = (int)(hash & (CMD_HASH_SIZE - 1));
+  while ( __hash_slots[slot] ) {
+    cmd_handler *h = &__handlers[__hash_slots[slot] - 1];
+    if ( h->hash == hash && strcmp(h->name, name) == 0 ) break;
+    slot = (slot + 1) & (CMD_HASH_SIZE - 1);
+  }
+  return slot;
+}
+
+static cmd_handler *find_cmd_handler(const char *cmd) {
+  int slot = cmd_slot(cmd, cmd_hash(cmd));
+  if ( !__hash_slots[slot] ) return NULL;
+  return &__handlers[__hash_slots[slot] - 1];
 }
 
 // handlers
 int has_cmd_handler(void) {
-	if ( __handlers ) return 0;
+	if ( __handlers_count ) return 0;
 	return -1;
 }
 
 int add_cmd_handler(const char *name, fp callback) {
-  cmd_handler *h = malloc(sizeof(cmd_handler));
-  __create_cmd_handler(h, name, callback);
-  if ( !__handlers ) {
-    __handlers = h;
-  } else {
-    cmd_handler *last = __handlers;
-    while( last->next ) last = last->next;
-    last->next = h;
+  uint32_t hash = cmd_hash(name);
+  int slot = cmd_slot(name, hash);
+  if ( __hash_slots[slot] ) {
+    // replace the callback
+    __handlers[__hash_slots[slot] - 1].callback = callback;
+    return 0;
+  }
+  if ( __handlers_count >= CMD_HANDLERS_MAX ) {
+    DBG("No room for the %s handler", name);
+    return -1;
   }
+  cmd_handler *h = &__handlers[__handlers_count];
+  memset(h, 0x0, sizeof(cmd_handler));
+  h->name = name;
+  h->hash = hash;
+  h->callback = callback;
+  __hash_slots[slot] = (uint8_t)++__handlers_count;
   return 0;
 }
 
+int set_cmd_handler_rate(const char *name, uint32_t min_interval) {
+  cmd_handler *h = find_cmd_handler(name);
+  if ( !h ) return -1;
+  h->min_interval = min_interval;
+  return 0;
+}
+
+const cmd_stats_t *cmd_handler_stats(const char *name) {
+  cmd_handler *h = find_cmd_handler(name);
+  if ( !h ) return NULL;
+  return &h->stats;
+}
+
 void free_cmd_handler(void) {
-  cmd_handler *curr = __handlers;
-  while( curr ) {
-    cmd_handler *rm = curr;
-    curr = curr->next;
-    free(rm->name);
-    free(rm);
-  }
+  memset(__hash_slots, 0x0, sizeof(__hash_slots));
+  __handlers_count = 0;
 }
 
 
 // events
-static char *form_evetns_url(const char *hid, cmd_type ev) {
-    char *uri = (char *)malloc(sizeof(ARROW_API_EVENTS_ENDPOINT) + strlen(hid) + 15);
-    strcpy(uri, ARROW_API_EVENTS_ENDPOINT);
-    strcat(uri, "/");
-    strcat(uri, hid);
+static const char *events_suffix(cmd_type ev) {
     switch(ev) {
-        case failed:    strcat(uri, "/failed"); break;
-        case received:  strcat(uri, "/received"); break;
-        case succeeded: strcat(uri, "/succeeded"); break;
+        case failed:    return "/failed";
+        case received:  return "/received";
+        case succeeded: return "/succeeded";
     }
-    return uri;
+    return "";
 }
 
 typedef struct _event_data {
-	char *hid;
+	const char *hid;
 	cmd_type ev;
-  char *payload; // FIXME property
+  const char *payload;
 } event_data_t;
 
 static void _event_ans_init(http_request_t *request, void *arg) {
     event_data_t *data = (event_data_t *)arg;
-	char *uri = form_evetns_url(data->hid, data->ev);
+  // the request keeps its own copy of the url parts
+	char uri[sizeof(ARROW_API_EVENTS_ENDPOINT) + 80];
+	snprintf(uri, sizeof(uri), "%s/%s%s",
+	         ARROW_API_EVENTS_ENDPOINT, data->hid, events_suffix(data->ev));
   http_request_init(request, PUT, uri);
-	free(uri);
 	if ( data->payload ) {
-    http_request_set_payload(request, p_stack(data->payload));
+    // the payload outlives the request, no copy
+    http_request_set_payload(request, p_const(data->payload));
 	}
 }
 
 int arrow_send_event_ans(const char *hid, cmd_type ev, const char *payload) {
-  event_data_t edata = {(char*)hid, ev, (char *)payload};
+  event_data_t edata = {hid, ev, payload};
 	int ret = __http_routine(_event_ans_init, &edata, NULL, NULL);
 	if ( ret < 0 ) {
 		DBG("Arrow Event answer failed...");
@@ -91,72 +135,60 @@ int arrow_send_event_ans(const char *hid, cmd_type ev, const char *payload) {
 	return ret;
 }
 
-static int fill_string_from_json(JsonNode *_node, const char *name, char **str) __attribute__((used));
-static int fill_string_from_json(JsonNode *_node, const char *name, char **str) {
-  JsonNode *tmp = json_find_member(_node, name);
-  if ( ! tmp || tmp->tag != JSON_STRING ) return -1;
-  *str = malloc(strlen(tmp->string_)+1);
-  strcpy(*str, tmp->string_);
-  return 0;
-}
-
-static fp find_cmd_handler(const char *cmd) {
-  if ( __handlers ) {
-    cmd_handler *h = __handlers;
-    while(h) {
-      if ( strcmp(h->name, cmd) == 0 ) return h->callback;
-      h = h->next;
-    }
-  } else {
-    DBG("No cmd handlers");
-  }
-  return NULL;
-}
-
 int __attribute__((weak)) command_handler(const char *name,
                     JsonNode *payload,
-                    JsonNode **error) {
+                    const char **error) {
   int ret = -1;
-  fp callback = find_cmd_handler(name);
-  if ( callback ) {
-    ret = callback(payload->string_);
-    if ( ret < 0 ) {
-      *error = json_mkobject();
-      json_append_member(*error, "error", json_mkstring("Something went wrong"));
-    }
-  } else {
-    *error = json_mkobject();
-    json_append_member(*error, "error", json_mkstring("there is no a command handler"));
+  cmd_handler *h = find_cmd_handler(name);
+  if ( !h ) {
+    *error = "there is no a command handler";
+    return CMD_NO_HANDLER;
+  }
+  uint64_t now = local_time_ms();
+  if ( h->min_interval && h->stats.calls && now - h->last < h->min_interval ) {
+    h->stats.limited++;
+    *error = "rate limited";
+    return CMD_ERROR;
+  }
+  h->last = now;
+  h->stats.calls++;
+  ret = h->callback(payload->string_);
+  uint32_t elapsed = (uint32_t)(local_time_ms() - now);
+  if ( elapsed > h->stats.max_ms ) h->stats.max_ms = elapsed;
+  if ( ret < 0 ) {
+    h->stats.failed++;
+    *error = "Something went wrong";
   }
   return ret;
 }
 
 int ev_DeviceCommand(void *_ev, JsonNode *_parameters) {
   int ret = -1;
-  JsonNode *_error = NULL;
+  const char *_error = NULL;
   mqtt_event_t *ev = (mqtt_event_t *)_ev;
   arrow_send_event_ans(ev->gateway_hid, received, NULL);
   DBG("start device command processing");
 
-  JsonNode *tmp = json_find_member(_parameters, "deviceHid");
-  if ( !tmp || tmp->tag != JSON_STRING ) return -1;
+  if ( !event_param_string(_parameters, "deviceHid") ) return -1;
 
-  JsonNode *cmd = json_find_member(_parameters, "command");
-  if ( !cmd || cmd->tag != JSON_STRING ) return -1;
-  DBG("ev cmd: %s", cmd->string_);
+  const char *cmd = event_param_string(_parameters, "command");
+  if ( !cmd ) return -1;
+  DBG("ev cmd: %s", cmd);
 
   JsonNode *pay = json_find_member(_parameters, "payload");
   if ( !pay || pay->tag != JSON_STRING ) return -1;
   DBG("ev msg: %s", pay->string_);
 
-  ret = command_handler(cmd->string_, pay, &_error);
+  ret = command_handler(cmd, pay, &_error);
   if ( ret < 0 ) {
       DBG("command_handler fail %d", ret);
   }
 
   if ( _error ) {
-    arrow_send_event_ans(ev->gateway_hid, failed, json_encode(_error));
-    json_delete(_error);
+    // {"error":"<static message>"}
+    static char ans[64];
+    snprintf(ans, sizeof(ans), "{\"error\":\"%s\"}", _error);
+    arrow_send_event_ans(ev->gateway_hid, failed, ans);
   } else {
     arrow_send_event_ans(ev->gateway_hid, succeeded, NULL);
   }
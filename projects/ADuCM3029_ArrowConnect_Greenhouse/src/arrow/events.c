@@ -24,20 +24,37 @@
 #include <json/json.h>
 #include <arrow/mem.h>
 #include <arrow/gateway_payload_sign.h>
+#include <ssl/crypt.h>
 
-static void free_mqtt_event(mqtt_event_t *mq) {
-  if ( mq->gateway_hid ) free(mq->gateway_hid);
-  if ( mq->device_hid ) free(mq->device_hid);
-  if ( mq->cmd ) free(mq->cmd);
-  if ( mq->payload ) free(mq->payload);
-  if ( mq->name ) free(mq->name);
+const char *event_param_string(JsonNode *node, const char *name) {
+  JsonNode *tmp = json_find_member(node, name);
+  if ( !tmp || tmp->tag != JSON_STRING ) return NULL;
+  return tmp->string_;
 }
 
-static int fill_string_from_json(JsonNode *_node, const char *name, char **str) {
-  JsonNode *tmp = json_find_member(_node, name);
-  if ( ! tmp || tmp->tag != JSON_STRING ) return -1;
-  *str = malloc(strlen(tmp->string_)+1);
-  strcpy(*str, tmp->string_);
+int event_param_number(JsonNode *node, const char *name, double *value) {
+  JsonNode *tmp = json_find_member(node, name);
+  if ( !tmp ) return -1;
+#if defined(__XCC__)
+  if ( tmp->type != json_Number ) return -1;
+  *value = tmp->valuedouble;
+#else
+  if ( tmp->tag != JSON_NUMBER ) return -1;
+  *value = tmp->number_;
+#endif
+  return 0;
+}
+
+int event_param_bool(JsonNode *node, const char *name, int *value) {
+  JsonNode *tmp = json_find_member(node, name);
+  if ( !tmp ) return -1;
+#if defined(__XCC__)
+  if ( tmp->type != json_True && tmp->type != json_False ) return -1;
+  *value = tmp->type == json_True ? 1 : 0;
+#else
+  if ( tmp->tag != JSON_BOOL ) return -1;
+  *value = tmp->bool_;
+#endif
   return 0;
 }
 
@@ -57,91 +74,125 @@ sub_t sub_list[] = {
   { "ServerToGateway_GatewaySoftwareRelease", ev_DeviceSoftwareRelease }
 };
 
+// canonical parameter string: sorted "key=value" lines in one buffer
+typedef struct {
+  char buf[MAX_PARAM_SIZE];
+  uint16_t line[MAX_PARAM_LINE];
+  int count;
+} canonical_prm_t;
+
+static canonical_prm_t canonical;
+
 // checker
 
-typedef int(*sign_checker)(const char *, mqtt_event_t *, const char *);
+typedef int(*sign_checker)(const char *, mqtt_event_t *, const canonical_prm_t *);
 struct check_signature_t {
   const char *version;
   sign_checker check;
 };
 
-static int check_sign_1(const char *sign, mqtt_event_t *ev, const char *can) {
+// the time does not depend on where the signatures differ
+static int sign_equal(const char *a, const char *b, int len) {
+  unsigned char diff = 0;
+  int i;
+  for ( i = 0; i < len; i++ ) diff |= (unsigned char)(a[i] ^ b[i]);
+  return diff == 0;
+}
+
+static int check_sign_1(const char *sign, mqtt_event_t *ev, const canonical_prm_t *can) {
+  char hash[34];
   char signature[65];
-  int err = gateway_payload_sign(signature,
-                                 ev->gateway_hid,
-                                 ev->name,
-                                 ev->encrypted,
-                                 can,
-                                 "1");
-  if ( err ) {
+  int i;
+  sha256_chunk_init();
+  sha256_chunk(ev->gateway_hid, (int)strlen(ev->gateway_hid));
+  sha256_chunk("\n", 1);
+  sha256_chunk(ev->name, (int)strlen(ev->name));
+  sha256_chunk("\n", 1);
+  if ( ev->encrypted ) sha256_chunk("true\n", 5);
+  else sha256_chunk("false\n", 6);
+  for ( i = 0; i < can->count; i++ ) {
+    const char *line = can->buf + can->line[i];
+    sha256_chunk(line, (int)strlen(line));
+    if ( i < can->count-1 ) sha256_chunk("\n", 1);
+  }
+  sha256_chunk("\n", 1);
+  sha256_chunk_hash(hash);
+  if ( gateway_payload_sign_hash(signature, hash, "1") ) {
     return -1;
   }
   DBG("cmp { %s, %s }", sign, signature);
-  return ( strcmp(sign, signature) == 0 ? 1 : 0 );
+  if ( strlen(sign) != 64 ) return 0;
+  return sign_equal(sign, signature, 64);
 }
 
 static struct check_signature_t checker_collection[] = {
   {"1", check_sign_1},
 };
 
-static int check_signature(const char *vers, const char *sing, mqtt_event_t *ev, const char *canParamStr) {
+static int check_signature(const char *vers, const char *sing, mqtt_event_t *ev, const canonical_prm_t *can) {
   unsigned int i = 0;
   for ( i = 0; i< sizeof(checker_collection) / sizeof(struct check_signature_t); i++ ) {
     if ( strcmp(vers, checker_collection[i].version ) == 0 ) {
       DBG("check version %s", checker_collection[i].version);
-      return checker_collection[i].check(sing, ev, canParamStr);
+      return checker_collection[i].check(sing, ev, can);
     }
   }
+  DBG("unknown signature version %s", vers);
   return -1;
 }
 
-static int cmpstringp(const void *p1, const void *p2) {
-  return strcmp(* (char * const *) p1, * (char * const *) p2);
-}
-
-#if defined(__XCC__)
-typedef int (*__compar_fn_t) (const void *, const void *);
-extern void qsort(void *__base, size_t __nmemb, size_t __size, __compar_fn_t __compar);
-#endif
-
-static char *form_canonical_prm(JsonNode *param) {
+static int form_canonical_prm(JsonNode *param, canonical_prm_t *can) {
   JsonNode *child;
-  char *canParam = NULL;
-  char *can_list[MAX_PARAM_LINE] = {0};
-  int count = 0;
+  int size = 0;
+  can->count = 0;
   json_foreach(child, param) {
     DBG("get child {%s}", json_key(child));
-    can_list[count] = malloc(MAX_PARAM_LINE_SIZE);
-    unsigned int i;
-    for ( i=0; i<strlen(json_key(child)); i++ ) *(can_list[count]+i) = tolower(json_key(child)[i]);
-    *(can_list[count]+i) = '=';
+    if ( can->count >= MAX_PARAM_LINE ) {
+      DBG("canonical: more than %d parameters", MAX_PARAM_LINE);
+      return -1;
+    }
+    char *line = can->buf + size;
+    int room = MAX_PARAM_SIZE - size;
+    if ( room > MAX_PARAM_LINE_SIZE ) room = MAX_PARAM_LINE_SIZE;
+    const char *key = json_key(child);
+    int i;
+    for ( i = 0; key[i] && i < room; i++ ) line[i] = (char)tolower((unsigned char)key[i]);
+    int n;
     switch(child->tag) {
-      case JSON_STRING: strcpy(can_list[count]+i+1, child->string_); break;
+      case JSON_STRING: n = snprintf(line+i, (size_t)(room-i), "=%s", child->string_); break;
 #if defined(__XCC__)
-      case json_True: strcpy(can_list[count]+i+1, "true"); break;
-      case json_False: strcpy(can_list[count]+i+1, "false"); break;
+      case json_True: n = snprintf(line+i, (size_t)(room-i), "=true"); break;
+      case json_False: n = snprintf(line+i, (size_t)(room-i), "=false"); break;
       default:
-        snprintf(can_list[count]+i+1, 50, "%d", child->valueint);
+        n = snprintf(line+i, (size_t)(room-i), "=%d", child->valueint);
 #else
-      case JSON_BOOL: strcpy(can_list[count]+i+1, (child->bool_?"true":"false")); break;
+      case JSON_BOOL: n = snprintf(line+i, (size_t)(room-i), "=%s", (child->bool_?"true":"false")); break;
       default:
-        snprintf(can_list[count]+i+1, 50, "%f", child->number_);
+        n = snprintf(line+i, (size_t)(room-i), "=%f", child->number_);
 #endif
     }
-    count++;
+    if ( i >= room || n < 0 || n >= room-i ) {
+      if ( room < MAX_PARAM_LINE_SIZE ) {
+        DBG("canonical: parameters longer than %d", MAX_PARAM_SIZE);
+      } else {
+        DBG("canonical: parameter %s longer than %d", key, MAX_PARAM_LINE_SIZE);
+      }
+      return -1;
+    }
+    can->line[can->count++] = (uint16_t)size;
+    size += i + n + 1;
   }
 
-  canParam = malloc(count * MAX_PARAM_LINE_SIZE);
-  *canParam = 0;
-  qsort(can_list, count, sizeof(char *), cmpstringp);
-  int i = 0;
-  for (i=0; i<count; i++) {
-    strcat(canParam, can_list[i]);
-    if ( i < count-1 ) strcat(canParam, "\n");
-    free(can_list[i]);
+  // insertion sort of the line offsets, the strings stay in place
+  int i, j;
+  for ( i = 1; i < can->count; i++ ) {
+    uint16_t cur = can->line[i];
+    for ( j = i; j > 0 && strcmp(can->buf + can->line[j-1], can->buf + cur) > 0; j-- ) {
+      can->line[j] = can->line[j-1];
+    }
+    can->line[j] = cur;
   }
-
-  return canParam;
+  return 0;
 }
 
 
@@ -156,25 +207,22 @@ int process_event(const char *str) {
       return -1;
   }
 
-  if ( fill_string_from_json(_main, "hid", &mqtt_e.gateway_hid) < 0 ) {
+  // the event strings are valid until json_delete
+  mqtt_e.gateway_hid = event_param_string(_main, "hid");
+  if ( !mqtt_e.gateway_hid ) {
     DBG("cannot find HID");
     goto error;
   }
   DBG("ev ghid: %s", mqtt_e.gateway_hid);
 
-  if ( fill_string_from_json(_main, "name", &mqtt_e.name) < 0 ) {
+  mqtt_e.name = event_param_string(_main, "name");
+  if ( !mqtt_e.name ) {
     DBG("cannot find name");
     goto error;
   }
   DBG("ev name: %s", mqtt_e.name);
 
-  JsonNode *_encrypted = json_find_member(_main, "encrypted");
-  if ( !_encrypted ) goto error;
-#if defined(__XCC__)
-  mqtt_e.encrypted = _encrypted->type == json_True? 1 : 0;
-#else
-  mqtt_e.encrypted = _encrypted->bool_;
-#endif
+  if ( event_param_bool(_main, "encrypted", &mqtt_e.encrypted) < 0 ) goto error;
 
   JsonNode *_parameters = json_find_member(_main, "parameters");
   if ( !_parameters ) goto error;
@@ -184,13 +232,11 @@ int process_event(const char *str) {
     DBG("signature vertsion: %s", sign_version->string_);
     JsonNode *sign = json_find_member(_main, "signature");
     if ( !sign ) goto error;
-    char *can = form_canonical_prm(_parameters);
-    if ( !check_signature(sign_version->string_, sign->string_, &mqtt_e, can) ) {
+    if ( form_canonical_prm(_parameters, &canonical) < 0 ) goto error;
+    if ( check_signature(sign_version->string_, sign->string_, &mqtt_e, &canonical) <= 0 ) {
       DBG("Alarm! signature is failed...");
-      free(can);
       goto error;
     }
-    free(can);
   }
 
   submodule current_processor = NULL;
@@ -209,7 +255,6 @@ int process_event(const char *str) {
   }
 
 error:
-  free_mqtt_event(&mqtt_e);
   if ( _main ) json_delete(_main);
   return ret;
 }
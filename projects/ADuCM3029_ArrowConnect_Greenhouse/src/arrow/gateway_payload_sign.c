@@ -12,24 +12,30 @@ int gateway_payload_sign(char *signature,
                          const char *canParString,
                          const char *signatureVersion) {
   // step 1
-  CREATE_CHUNK(canonicalRequest, 512);
-  strcpy(canonicalRequest, hid);
-  strcat(canonicalRequest, "\n");
-  strcat(canonicalRequest, name);
-  strcat(canonicalRequest, "\n");
-  if ( encrypted ) strcat(canonicalRequest, "true\n");
-  else strcat(canonicalRequest, "false\n");
-  strcat(canonicalRequest, canParString);
-  strcat(canonicalRequest, "\n");
-  char hex_hash_canonical_req[66];
   char hash_canonical_req[34];
-  sha256(hash_canonical_req, canonicalRequest, (int)strlen(canonicalRequest));
+  sha256_chunk_init();
+  sha256_chunk(hid, (int)strlen(hid));
+  sha256_chunk("\n", 1);
+  sha256_chunk(name, (int)strlen(name));
+  sha256_chunk("\n", 1);
+  if ( encrypted ) sha256_chunk("true\n", 5);
+  else sha256_chunk("false\n", 6);
+  sha256_chunk(canParString, (int)strlen(canParString));
+  sha256_chunk("\n", 1);
+  sha256_chunk_hash(hash_canonical_req);
+  return gateway_payload_sign_hash(signature, hash_canonical_req, signatureVersion);
+}
+
+int gateway_payload_sign_hash(char *signature,
+                              const char *hash_canonical_req,
+                              const char *signatureVersion) {
+  char hex_hash_canonical_req[66];
   hex_encode(hex_hash_canonical_req, hash_canonical_req, 32);
   hex_hash_canonical_req[64] = '\0';
 //  DBG("can: %s", hex_hash_canonical_req);
 
   // step 2
-  char *stringtoSign = canonicalRequest;
+  CREATE_CHUNK(stringtoSign, 512);
   strcpy(stringtoSign, hex_hash_canonical_req);
   strcat(stringtoSign, "\n");
   strcat(stringtoSign, get_api_key());
@@ -53,7 +59,7 @@ int gateway_payload_sign(char *signature,
   hmac256(tmp, hex_tmp, strlen(hex_tmp), stringtoSign, strlen(stringtoSign));
   hex_encode(signature, tmp, 32);
 //  DBG("sig: [%d]%s", strlen(signature), signature);
-  FREE_CHUNK(canonicalRequest);
+  FREE_CHUNK(stringtoSign);
   FREE_CHUNK(tmp);
   FREE_CHUNK(hex_tmp);
   return 0;
@@ -17,11 +17,14 @@
 #include <arrow/events.h>
 
 #define MQTT_BUF_LEN 600
+#define MQTT_OUTBOUND_LEN 2048
 
 static Network mqtt_net;
 static MQTTClient mqtt_client;
 static unsigned char buf[MQTT_BUF_LEN];
 static unsigned char readbuf[MQTT_BUF_LEN];
+static unsigned char outbound[MQTT_OUTBOUND_LEN];
+static int outbound_init = 0;
 static char s_topic[100];
 static char p_topic[100];
 
@@ -221,6 +224,11 @@ static int mqtt_connect_iot(arrow_gateway_t *gateway) {
 int mqtt_connect(arrow_gateway_t *gateway,
                  arrow_device_t *device,
                  arrow_gateway_config_t *config) {
+  // telemetry not acknowledged yet is kept across reconnects
+  if ( !outbound_init ) {
+    MQTTOutboundInit(&mqtt_client, outbound, MQTT_OUTBOUND_LEN, NULL);
+    outbound_init = 1;
+  }
 #if defined(__IBM__)
   SSP_PARAMETER_NOT_USED(gateway);
   return mqtt_connect_ibm(device, config);
@@ -255,13 +263,18 @@ int mqtt_yield(int timeout_ms) {
 
 int mqtt_publish(arrow_device_t *device, void *d) {
     MQTTMessage msg;
-    msg.qos = QOS0;
+    msg.qos = QOS1;
     msg.retained = 0;
     msg.dup = 0;
     char *payload = telemetry_serialize(device, d);
     msg.payload = payload;
     msg.payloadlen = strlen(payload);
-    int ret = MQTTPublish(&mqtt_client, p_topic, &msg);
+    // the packet is copied to the outbound queue, acks are collected by mqtt_yield
+    int ret = MQTTPublishAsync(&mqtt_client, p_topic, &msg);
     free(payload);
+#if defined(NO_EVENTS)
+    // nobody else reads the socket
+    if ( ret >= 0 ) MQTTYield(&mqtt_client, 100);
+#endif
     return ret;
 }
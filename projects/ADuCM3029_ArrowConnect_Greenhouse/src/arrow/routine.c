@@ -2,6 +2,10 @@
 #define ARROW_RETRY_DELAY 3000
 #endif
 
+#if !defined(TELEMETRY_QUEUE_RETRY)
+#define TELEMETRY_QUEUE_RETRY 3
+#endif
+
 #include "arrow/routine.h"
 #include <config.h>
 #include <debug.h>
@@ -17,6 +21,7 @@
 #include <arrow/api/device/device.h>
 #include <arrow/telemetry_api.h>
 #include <arrow/storage.h>
+#include <mqtt/client/MQTTClient.h>
 
 #define GATEWAY_CONNECT "Gateway connection [%s]"
 #define GATEWAY_CONFIG "Gateway config [%s]"
@@ -149,7 +154,18 @@ void arrow_mqtt_send_telemetry_routine(get_data_cb data_cb, void *data) {
 #endif
     if ( data_cb(data) < 0 ) continue;
     wdt_feed();
-    if ( mqtt_publish(&_device, data) < 0 ) {
+    int ret = mqtt_publish(&_device, data);
+    int retry = 0;
+    // the outbound queue is full: let the pending acks in and try again,
+    // the link itself is fine so there is no reason to reconnect
+    while ( ret == BUFFER_OVERFLOW && retry++ < TELEMETRY_QUEUE_RETRY ) {
+      mqtt_yield(ARROW_RETRY_DELAY);
+      wdt_feed();
+      ret = mqtt_publish(&_device, data);
+    }
+    if ( ret == BUFFER_OVERFLOW ) {
+      DBG(DEVICE_MQTT_TELEMETRY, "queue full, sample dropped");
+    } else if ( ret < 0 ) {
       DBG(DEVICE_MQTT_TELEMETRY, "fail");
       mqtt_disconnect();
       while (mqtt_connect(&_gateway, &_device, &_gateway_config) < 0) { msleep(ARROW_RETRY_DELAY);}
@@ -3,6 +3,11 @@
 #include <debug.h>
 #include <time/watchdog.h>
 #include <arrow/sys.h>
+#include <arrow/storage.h>
+#include <arrow/utf8.h>
+#include <ssl/md5sum.h>
+#include <time/time.h>
+#include <config.h>
 
 #define URI_LEN sizeof(ARROW_API_SOFTWARE_RELEASE_ENDPOINT) + 200
 
@@ -10,6 +15,19 @@ static __release_cb  __release = NULL;
 static __download_payload_cb  __payload = NULL;
 static __download_complete_cb __download = NULL;
 
+// the firmware image being downloaded to the staging slot
+typedef struct _ota_download_ {
+  uint32_t offset;  // bytes received, the last partial block is still in RAM
+  uint32_t total;   // image size, 0 while unknown
+  int answered;     // the current request got its first payload
+  const char *checksum; // expected md5, hex
+  const char *error;
+  uint32_t fill;
+  char block[OTA_WRITE_SIZE];
+} ota_download_t;
+
+static ota_download_t *_ota = NULL;
+
 static char *serialize_software_trans(const char *hid, release_sched_t *rs) {
   JsonNode *_main = json_mkobject();
   json_append_member(_main, "objectHid", json_mkstring(hid));
@@ -149,6 +167,193 @@ int arrow_software_releases_trans_start(const char *hid) {
   STD_ROUTINE(_software_releases_start_init, (void*)hid, NULL, NULL, "Software Trans start fail");
 }
 
+static int ota_payload(http_response_t *res, const char *buf, int size) {
+  ota_download_t *ota = _ota;
+  if ( ota->error ) return -1;
+  if ( !ota->answered ) {
+    ota->answered = 1;
+    if ( res->m_httpResponseCode == 200 && ota->offset ) {
+      // the server ignored the Range header, start over
+      DBG("OTA: restart from 0");
+      md5_chunk_init();
+      ota->offset = 0;
+      ota->fill = 0;
+    }
+    if ( res->content_length >= 0 ) ota->total = ota->offset + (uint32_t)res->content_length;
+    if ( ota->total > ota_slot_size() ) {
+      ota->error = "image too large";
+      return -1;
+    }
+  }
+  if ( ota->offset + (uint32_t)size > ota_slot_size() ) {
+    ota->error = "image too large";
+    return -1;
+  }
+  uint32_t before = ota->offset;
+  md5_chunk(buf, size);
+  while ( size > 0 ) {
+    uint32_t n = OTA_WRITE_SIZE - ota->fill;
+    if ( n > (uint32_t)size ) n = (uint32_t)size;
+    memcpy(ota->block + ota->fill, buf, n);
+    ota->fill += n;
+    ota->offset += n;
+    buf += n;
+    size -= (int)n;
+    if ( ota->fill == OTA_WRITE_SIZE ) {
+      if ( ota_slot_write(ota->offset - ota->fill, ota->block, ota->fill) < 0 ) {
+        ota->error = "flash write";
+        return -1;
+      }
+      ota->fill = 0;
+    }
+  }
+  if ( ota->total && before * 10 / ota->total != ota->offset * 10 / ota->total ) {
+    DBG("OTA: %d%%", (int)(ota->offset * 100 / ota->total));
+  }
+  return 0;
+}
+
+// hash the staging slot again to catch flash write errors
+static int ota_verify(uint32_t size, const char *md5sum) {
+  char sum[16];
+  uint32_t offset = 0;
+  md5_chunk_init();
+  while ( offset < size ) {
+    char buf[OTA_WRITE_SIZE];
+    uint32_t n = size - offset;
+    if ( n > OTA_WRITE_SIZE ) n = OTA_WRITE_SIZE;
+    ota_slot_read(offset, buf, n);
+    md5_chunk(buf, (int)n);
+    offset += n;
+  }
+  md5_chunk_hash(sum);
+  return memcmp(sum, md5sum, sizeof(sum)) ? -1 : 0;
+}
+
+// the data received so far matches the expected checksum
+static int ota_complete(void) {
+  char sum[16];
+  char hex[sizeof(sum) * 2 + 1];
+  md5_chunk_peek(sum);
+  hex_encode(hex, sum, sizeof(sum));
+  return strcasecmp(hex, _ota->checksum) ? 0 : 1;
+}
+
+// download the image to the staging slot, check it and mark it for the bootloader
+static int ota_stage(const char *token, const char *hid,
+                     const char *checksum, const char *to,
+                     const char **error) {
+  char sum[16];
+  char hex[sizeof(sum) * 2 + 1];
+  ota_meta_t meta;
+  int ret = -1;
+
+  _ota = (ota_download_t *)calloc(1, sizeof(ota_download_t));
+  if ( !_ota ) {
+    *error = "out of memory";
+    return -1;
+  }
+  _ota->checksum = checksum;
+  md5_chunk_init();
+  arrow_software_releases_trans_start(hid);
+  ret = arrow_software_release_download(token, hid);
+  if ( ret < 0 ) {
+    *error = _ota->error ? _ota->error : "download interrupted";
+    goto ota_done;
+  }
+  if ( _ota->fill && ota_slot_write(_ota->offset - _ota->fill, _ota->block, _ota->fill) < 0 ) {
+    *error = "flash write";
+    ret = -1;
+    goto ota_done;
+  }
+  md5_chunk_hash(sum);
+  hex_encode(hex, sum, sizeof(sum));
+  if ( strcasecmp(hex, checksum) ) {
+    DBG("OTA: md5 %s expected %s", hex, checksum);
+    *error = "checksum mismatch";
+    ret = -1;
+    goto ota_done;
+  }
+  if ( ota_verify(_ota->offset, sum) < 0 ) {
+    *error = "flash verify";
+    ret = -1;
+    goto ota_done;
+  }
+  memset(&meta, 0x0, sizeof(meta));
+  meta.magic = OTA_META_MAGIC;
+  meta.state = ota_staged;
+  meta.size = _ota->offset;
+  memcpy(meta.md5, sum, sizeof(sum));
+  strncpy(meta.trans_hid, hid, sizeof(meta.trans_hid) - 1);
+  strncpy(meta.version, to, sizeof(meta.version) - 1);
+  if ( ota_meta_save(&meta) < 0 ) {
+    *error = "flash write";
+    ret = -1;
+    goto ota_done;
+  }
+  DBG("OTA: %d bytes staged", (int)meta.size);
+  ret = 0;
+
+ota_done:
+  free(_ota);
+  _ota = NULL;
+  return ret;
+}
+
+int arrow_software_release_boot(void) {
+  ota_meta_t meta;
+  if ( ota_meta_restore(&meta) < 0 ) return 0;
+  switch ( meta.state ) {
+    case ota_staged:
+      // still waiting for a bootloader unless this image is the new version
+      if ( strcmp(meta.version, GATEWAY_SOFTWARE_VERSION) ) return 0;
+      // fall through
+    case ota_installed:
+      // first start after the bootloader installed the image
+      meta.state = ota_trial;
+      meta.boots = 1;
+    break;
+    case ota_trial:
+      if ( ++meta.boots > ARROW_OTA_MAX_BOOTS ) {
+        DBG("OTA: %s never confirmed, roll back", meta.version);
+        meta.state = ota_rollback;
+        ota_meta_save(&meta);
+        return -1;
+      }
+    break;
+    default:
+      return 0;
+  }
+  ota_meta_save(&meta);
+  return 0;
+}
+
+int arrow_software_release_confirm(void) {
+  ota_meta_t meta;
+  int ret;
+  if ( ota_meta_restore(&meta) < 0 ) return 0;
+  switch ( meta.state ) {
+    case ota_staged:
+      // the old firmware runs again, nothing installed the staged image
+      DBG("OTA: %s staged but not installed", meta.version);
+      ret = arrow_software_releases_trans_fail(meta.trans_hid, "staged, not installed");
+      meta.state = ota_empty;
+    break;
+    case ota_trial:
+      ret = arrow_software_releases_trans_success(meta.trans_hid);
+      meta.state = ota_confirmed;
+    break;
+    case ota_rollback:
+      ret = arrow_software_releases_trans_fail(meta.trans_hid, "rollback");
+      meta.state = ota_empty;
+    break;
+    default:
+      return 0;
+  }
+  if ( ret < 0 ) return ret;
+  return ota_meta_save(&meta);
+}
+
 int ev_DeviceSoftwareRelease(void *_ev, JsonNode *_parameters) {
   SSP_PARAMETER_NOT_USED(_ev);
   JsonNode *tmp = json_find_member(_parameters, "softwareReleaseTransHid");
@@ -171,18 +376,25 @@ int ev_DeviceSoftwareRelease(void *_ev, JsonNode *_parameters) {
   if ( !tmp || tmp->tag != JSON_STRING ) return -1;
   char *_checksum = tmp->string_;
   wdt_feed();
-  int ret = arrow_software_release_download(_token, trans_hid);
-  wdt_feed();
-  SSP_PARAMETER_NOT_USED(_checksum);
-  SSP_PARAMETER_NOT_USED(_to);
-  SSP_PARAMETER_NOT_USED(_from);
-//  int ret = arrow_software_release(_token, _checksum, _from, _to);
-  if ( ret < 0 ) {
-    arrow_software_releases_trans_fail(trans_hid, "failed");
+  int ret;
+  if ( __payload ) {
+    // the application processes the file itself
+    ret = arrow_software_release_download(_token, trans_hid);
+    SSP_PARAMETER_NOT_USED(_checksum);
+    if ( ret < 0 ) {
+      arrow_software_releases_trans_fail(trans_hid, "failed");
+    } else {
+      arrow_software_releases_trans_success(trans_hid);
+    }
   } else {
-    arrow_software_releases_trans_success(trans_hid);
-    reboot();
+    const char *error = NULL;
+    ret = ota_stage(_token, trans_hid, _checksum, _to, &error);
+    // success is reported by the new image, see arrow_software_release_confirm
+    if ( ret < 0 ) arrow_software_releases_trans_fail(trans_hid, error);
   }
+  wdt_feed();
+  SSP_PARAMETER_NOT_USED(_from);
+  if ( ret >= 0 ) reboot();
   return ret;
 }
 
@@ -230,6 +442,7 @@ int arrow_software_release_payload_handler(void *r,
                                            int size) {
   http_response_t *res = (http_response_t *)r;
   property_t *response_buffer = &res->payload.buf;
+  if ( _ota ) return ota_payload(res, payload.value, size);
   return __payload(response_buffer, payload.value, size);
 }
 
@@ -244,6 +457,16 @@ static void _software_releases_download_init(http_request_t *request, void *arg)
   http_request_init(request, GET, uri);
   request->_response_payload_meth._p_add_handler = arrow_software_release_payload_handler;
   FREE_CHUNK(uri);
+  if ( _ota ) {
+    _ota->answered = 0;
+    if ( _ota->offset ) {
+      // resume after a dropped link
+      char *range = (char *)malloc(32);
+      snprintf(range, 32, "bytes=%u-", (unsigned int)_ota->offset);
+      http_request_add_header(request, p_const("Range"), p_heap(range));
+      DBG("OTA: resume at %s", range);
+    }
+  }
   wdt_feed();
 }
 
@@ -252,6 +475,26 @@ static int _software_releases_download_proc(http_response_t *response, void *arg
   SSP_PARAMETER_NOT_USED(arg);
   wdt_feed();
 //  if ( IS_EMPTY(response->payload.buf) )  return -1;
+  if ( _ota ) {
+    if ( response->m_httpResponseCode == 416 && !_ota->total ) {
+      // nothing is left past the offset, yet the data does not match
+      _ota->error = "checksum mismatch";
+      return -1;
+    }
+    if ( response->m_httpResponseCode >= 400 && response->m_httpResponseCode < 500 ) {
+      _ota->error = "file request refused";
+      return -1;
+    }
+    if ( response->m_httpResponseCode != 200 &&
+         response->m_httpResponseCode != 206 ) return -1;
+    if ( _ota->error ) return -1;
+    DBG("file size : %d/%d", (int)_ota->offset, (int)_ota->total);
+    // a dropped link ends the body early, without a length only
+    // the checksum tells a complete image from a truncated one
+    if ( _ota->total && _ota->offset < _ota->total ) return -1;
+    if ( !_ota->total && !ota_complete() ) return -1;
+    return 0;
+  }
   DBG("file size : %d", response->payload.size);
   if ( __download ) return __download(&response->payload.buf);
   return 0;
@@ -259,5 +502,20 @@ static int _software_releases_download_proc(http_response_t *response, void *arg
 
 int arrow_software_release_download(const char *token, const char *tr_hid) {
   token_hid_t th = { token, tr_hid };
-  STD_ROUTINE(_software_releases_download_init, &th, _software_releases_download_proc, NULL, "File download fail");
+  if ( !_ota ) {
+    STD_ROUTINE(_software_releases_download_init, &th, _software_releases_download_proc, NULL, "File download fail");
+  }
+  // resume with a Range request until the link stops making progress
+  int tries = 0;
+  do {
+    uint32_t offset = _ota->offset;
+    if ( __http_routine(_software_releases_download_init, &th,
+                        _software_releases_download_proc, NULL) == 0 ) return 0;
+    if ( _ota->error ) break;
+    if ( _ota->offset > offset ) tries = 0;
+    wdt_feed();
+    msleep(ARROW_OTA_RESUME_DELAY);
+  } while ( ++tries < ARROW_OTA_RESUME_TRIES );
+  DBG("Error:File download fail");
+  return -1;
 }
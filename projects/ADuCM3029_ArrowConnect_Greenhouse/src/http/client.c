@@ -324,7 +324,9 @@ int http_client_do(http_client_t *cli, http_request_t *req, http_response_t *res
         DBG("Connection error (%d)", ret);
         return -1;
     }
-    if ( res->m_httpResponseCode != 200 ) goto last_wait;
+    // 206 is the answer to a Range request
+    if ( res->m_httpResponseCode != 200 &&
+         res->m_httpResponseCode != 206 ) goto last_wait;
 
     HTTP_DBG("Reading headers %d", trfLen);
     char *crlfPtr;
@@ -394,6 +396,8 @@ int http_client_do(http_client_t *cli, http_request_t *req, http_response_t *res
         }
     }
 
+    res->content_length = recvContentLength;
+
     uint32_t chunk_len;
     HTTP_DBG("get payload form buf: %d", trfLen);
     HTTP_DBG("get payload form buf: [%s]", buf);
@@ -426,8 +430,8 @@ int http_client_do(http_client_t *cli, http_request_t *req, http_response_t *res
                 uint32_t newTrfLen = 0;
                 HTTP_DBG("get chunk add %d", need_to_read-trfLen);
                 ret = client_recv(buf+trfLen, need_to_read-trfLen, cli);
-                if ( ret >= 0 ) newTrfLen = (uint32_t)ret;
-                else { // ret < 0 - error
+                if ( ret > 0 ) newTrfLen = (uint32_t)ret;
+                else { // ret < 0 - error, 0 - the link was closed
                     need_to_read = trfLen;
                     chunk_len = need_to_read;
                     newTrfLen = 0;
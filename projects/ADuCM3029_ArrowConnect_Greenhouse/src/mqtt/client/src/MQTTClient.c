@@ -28,14 +28,14 @@ static unsigned short getNextPacketId(MQTTClient *c) {
     return c->next_packetid = (unsigned short int)((c->next_packetid == MAX_PACKET_ID) ? 1 : c->next_packetid + 1);
 }
 
-static int sendPacket(MQTTClient* c, int length, TimerInterval* timer)
+static int sendBuffer(MQTTClient* c, unsigned char* buf, int length, TimerInterval* timer)
 {
     int rc = FAILURE,
         sent = 0;
 
     while (sent < length && !TimerIsExpired(timer))
     {
-        rc = c->ipstack->mqttwrite(c->ipstack, &c->buf[sent], length, TimerLeftMS(timer));
+        rc = c->ipstack->mqttwrite(c->ipstack, &buf[sent], length - sent, TimerLeftMS(timer));
         if (rc < 0)  // there was an error writing the data
             break;
         sent += rc;
@@ -51,6 +51,190 @@ static int sendPacket(MQTTClient* c, int length, TimerInterval* timer)
 }
 
 
+static int sendPacket(MQTTClient* c, int length, TimerInterval* timer)
+{
+    return sendBuffer(c, c->buf, length, timer);
+}
+
+
+static MQTTOutbound* outboundEntry(MQTTClient* c, int i)
+{
+    return &c->outbound.entries[(c->outbound.head + i) % MAX_QUEUED_MESSAGES];
+}
+
+
+/* Find room for len bytes after the newest packet, wrapping to the start of the buffer */
+static int outboundAlloc(MQTTClient* c, int len, size_t* offset)
+{
+    struct OutboundQueue* q = &c->outbound;
+    size_t oldest;
+
+    if (q->count == MAX_QUEUED_MESSAGES)
+        return BUFFER_OVERFLOW;
+    if (q->count == 0)
+        q->end = 0;
+    oldest = q->count ? outboundEntry(c, 0)->offset : 0;
+
+    if (q->count == 0 || q->end > oldest)
+    {
+        if (q->buf_size - q->end >= (size_t)len)
+            *offset = q->end;
+        else if (oldest >= (size_t)len)
+            *offset = 0;
+        else
+            return BUFFER_OVERFLOW;
+    }
+    else if (oldest - q->end >= (size_t)len)
+        *offset = q->end;
+    else
+        return BUFFER_OVERFLOW;
+
+    return MQTT_SUCCESS;
+}
+
+
+/* Free the acknowledged entries at the head of the queue */
+static void outboundReclaim(MQTTClient* c)
+{
+    struct OutboundQueue* q = &c->outbound;
+
+    while (q->count && outboundEntry(c, 0)->state == OUTBOUND_DONE)
+    {
+        q->head = (q->head + 1) % MAX_QUEUED_MESSAGES;
+        q->count--;
+    }
+}
+
+
+static MQTTOutbound* outboundFind(MQTTClient* c, unsigned short id, unsigned char state)
+{
+    int i;
+
+    for (i = 0; i < c->outbound.count; ++i)
+    {
+        MQTTOutbound* e = outboundEntry(c, i);
+        if (e->qos != QOS0 && e->id == id && e->state == state)
+            return e;
+    }
+    return NULL;
+}
+
+
+/* MQTTClientInit restarts the packet ids, skip the ones still used by queued publishes */
+static unsigned short outboundNextId(MQTTClient* c)
+{
+    unsigned short id;
+    int i;
+
+    do
+    {
+        id = getNextPacketId(c);
+        for (i = 0; i < c->outbound.count; ++i)
+        {
+            MQTTOutbound* e = outboundEntry(c, i);
+            if (e->qos != QOS0 && e->state != OUTBOUND_DONE && e->id == id)
+                break;
+        }
+    } while (i < c->outbound.count);
+    return id;
+}
+
+
+static void outboundDone(MQTTClient* c, MQTTOutbound* e)
+{
+    e->state = OUTBOUND_DONE;
+    c->outbound.inflight--;
+    if (c->outbound.fp != NULL)
+        c->outbound.fp(e->id);
+    outboundReclaim(c);
+}
+
+
+/* Send the queued publishes in order while the in-flight window allows */
+static int outboundSend(MQTTClient* c, TimerInterval* timer)
+{
+    int i,
+        rc = MQTT_SUCCESS;
+
+    for (i = 0; i < c->outbound.count; ++i)
+    {
+        MQTTOutbound* e = outboundEntry(c, i);
+
+        if (e->state != OUTBOUND_QUEUED)
+            continue;
+        if (e->qos != QOS0 && c->outbound.inflight >= MAX_INFLIGHT_MESSAGES)
+            break;
+        if ((rc = sendBuffer(c, &c->outbound.buf[e->offset], e->len, timer)) != MQTT_SUCCESS)
+            break;
+        if (e->qos == QOS0)
+            e->state = OUTBOUND_DONE;
+        else
+        {
+            e->state = OUTBOUND_SENT;
+            c->outbound.inflight++;
+        }
+    }
+    outboundReclaim(c);
+    return rc;
+}
+
+
+/* After a reconnect: publishes not acknowledged go again with DUP set, PUBRELs are repeated */
+static int outboundResend(MQTTClient* c, TimerInterval* timer)
+{
+    int i,
+        len,
+        rc = MQTT_SUCCESS;
+
+    c->outbound.inflight = 0;
+    for (i = 0; i < c->outbound.count; ++i)
+    {
+        MQTTOutbound* e = outboundEntry(c, i);
+
+        if (e->state == OUTBOUND_SENT)
+        {
+            MQTTHeader header = {0};
+            header.byte = c->outbound.buf[e->offset];
+            header.bits.dup = 1;
+            c->outbound.buf[e->offset] = header.byte;
+            e->state = OUTBOUND_QUEUED;
+        }
+        else if (e->state == OUTBOUND_PUBREL)
+        {
+            c->outbound.inflight++;
+            if ((len = MQTTSerialize_ack(c->buf, (int)c->buf_size, PUBREL, 0, e->id)) <= 0 ||
+                (rc = sendPacket(c, len, timer)) != MQTT_SUCCESS)
+                return FAILURE;
+        }
+    }
+    return outboundSend(c, timer);
+}
+
+
+void MQTTOutboundInit(MQTTClient* c, unsigned char* buf, size_t buf_size, deliveryHandler fp)
+{
+    c->outbound.buf = buf;
+    c->outbound.buf_size = buf_size;
+    c->outbound.end = 0;
+    c->outbound.head = 0;
+    c->outbound.count = 0;
+    c->outbound.inflight = 0;
+    c->outbound.fp = fp;
+}
+
+
+int MQTTOutboundPending(MQTTClient* c)
+{
+    int i,
+        pending = 0;
+
+    for (i = 0; i < c->outbound.count; ++i)
+        if (outboundEntry(c, i)->state != OUTBOUND_DONE)
+            pending++;
+    return pending;
+}
+
+
 void MQTTClientInit(MQTTClient* c, Network* network, unsigned int command_timeout_ms,
     unsigned char* sendbuf, size_t sendbuf_size, unsigned char* readbuf, size_t readbuf_size)
 {
@@ -236,9 +420,18 @@ static int cycle(MQTTClient* c, TimerInterval* timer)
     switch (packet_type)
     {
         case CONNACK:
-        case PUBACK:
         case SUBACK:
             break;
+        case PUBACK:
+        {
+            unsigned short mypacketid;
+            unsigned char dup, type;
+            MQTTOutbound* e;
+            if (MQTTDeserialize_ack(&type, &dup, &mypacketid, c->readbuf, (int)c->readbuf_size) == 1 &&
+                (e = outboundFind(c, mypacketid, OUTBOUND_SENT)) != NULL)
+                outboundDone(c, e);
+            break;
+        }
         case PUBLISH:
         {
             MQTTString topicName = {0,{0,0}};
@@ -272,9 +465,14 @@ static int cycle(MQTTClient* c, TimerInterval* timer)
         {
             unsigned short mypacketid;
             unsigned char dup, type;
+            MQTTOutbound* e;
             if (MQTTDeserialize_ack(&type, &dup, &mypacketid, c->readbuf, (int)c->readbuf_size) != 1)
                 rc = FAILURE;
-            else if ((len = MQTTSerialize_ack(c->buf, (int)c->buf_size, PUBREL, 0, mypacketid)) <= 0)
+            else if ((e = outboundFind(c, mypacketid, OUTBOUND_SENT)) != NULL)
+                e->state = OUTBOUND_PUBREL;
+            if (rc == FAILURE)
+                goto exit;
+            if ((len = MQTTSerialize_ack(c->buf, (int)c->buf_size, PUBREL, 0, mypacketid)) <= 0)
                 rc = FAILURE;
             else if ((rc = sendPacket(c, len, timer)) != MQTT_SUCCESS) // send the PUBREL packet
                 rc = FAILURE; // there was a problem
@@ -283,11 +481,24 @@ static int cycle(MQTTClient* c, TimerInterval* timer)
             break;
         }
         case PUBCOMP:
+        {
+            unsigned short mypacketid;
+            unsigned char dup, type;
+            MQTTOutbound* e;
+            if (MQTTDeserialize_ack(&type, &dup, &mypacketid, c->readbuf, (int)c->readbuf_size) == 1 &&
+                (e = outboundFind(c, mypacketid, OUTBOUND_PUBREL)) != NULL)
+                outboundDone(c, e);
             break;
+        }
         case PINGRESP:
             c->ping_outstanding = 0;
             break;
     }
+    if (c->isconnected && c->outbound.count && outboundSend(c, timer) != MQTT_SUCCESS)
+    {
+        rc = FAILURE;
+        goto exit;
+    }
     keepalive(c);
 exit:
     if (rc == MQTT_SUCCESS)
@@ -401,6 +612,9 @@ int MQTTConnect(MQTTClient* c, MQTTPacket_connectData* options)
     else
         rc = FAILURE;
 
+    if (rc == MQTT_SUCCESS && c->outbound.count && outboundResend(c, &connect_timer) != MQTT_SUCCESS)
+        rc = FAILURE;
+
 exit:
     if (rc == MQTT_SUCCESS)
         c->isconnected = 1;
@@ -507,6 +721,76 @@ exit:
     return rc;
 }
 
+int MQTTPublishAsync(MQTTClient* c, const char* topicName, MQTTMessage* message)
+{
+    int rc = FAILURE;
+    TimerInterval timer;
+    MQTTString topic = MQTTString_initializer;
+    topic.cstring = (char *)topicName;
+    MQTTOutbound* e;
+    size_t offset;
+    int len = 0;
+
+#if defined(MQTT_TASK)
+  MutexLock(&c->mutex);
+#endif
+    if (c->outbound.buf == NULL)
+        goto exit;
+
+    /* the length does not depend on the packet id, size it before taking one */
+    len = MQTTSerialize_publish(c->buf, (int)c->buf_size, 0, message->qos, message->retained, 1,
+              topic, (unsigned char*)message->payload, (int)message->payloadlen);
+    if (len <= 0)
+        goto exit;
+    if ((rc = outboundAlloc(c, len, &offset)) != MQTT_SUCCESS)
+        goto exit;
+
+    if (message->qos == QOS1 || message->qos == QOS2)
+        message->id = outboundNextId(c);
+    len = MQTTSerialize_publish(&c->outbound.buf[offset], len, 0, message->qos, message->retained,
+              message->id, topic, (unsigned char*)message->payload, (int)message->payloadlen);
+
+    e = &c->outbound.entries[(c->outbound.head + c->outbound.count) % MAX_QUEUED_MESSAGES];
+    e->offset = offset;
+    e->len = len;
+    e->id = message->id;
+    e->qos = (unsigned char)message->qos;
+    e->state = OUTBOUND_QUEUED;
+    c->outbound.count++;
+    c->outbound.end = offset + len;
+
+    if (!c->isconnected)
+    {
+        rc = FAILURE;
+        goto exit;
+    }
+
+    TimerInit(&timer);
+    TimerCountdownMS(&timer, c->command_timeout_ms);
+    if ((rc = outboundSend(c, &timer)) == MQTT_SUCCESS && message->qos != QOS0)
+        rc = message->id;
+
+exit:
+#if defined(MQTT_TASK)
+  MutexUnlock(&c->mutex);
+#endif
+    return rc;
+}
+
+
+/* Wait until the queued publish with this id is acknowledged */
+static int waitforDelivery(MQTTClient* c, unsigned short id, enum QoS qos, TimerInterval* timer)
+{
+    while (outboundFind(c, id, OUTBOUND_QUEUED) || outboundFind(c, id, OUTBOUND_SENT) ||
+           (qos == QOS2 && outboundFind(c, id, OUTBOUND_PUBREL)))
+    {
+        if (TimerIsExpired(timer) || cycle(c, timer) == FAILURE)
+            return FAILURE;
+    }
+    return MQTT_SUCCESS;
+}
+
+
 int MQTTPublish(MQTTClient* c, const char* topicName, MQTTMessage* message)
 {
     int rc = FAILURE;
@@ -515,6 +799,15 @@ int MQTTPublish(MQTTClient* c, const char* topicName, MQTTMessage* message)
     topic.cstring = (char *)topicName;
     int len = 0;
 
+    if (c->outbound.buf != NULL)
+    {
+        if ((rc = MQTTPublishAsync(c, topicName, message)) <= MQTT_SUCCESS)
+            return rc;
+        TimerInit(&timer);
+        TimerCountdownMS(&timer, c->command_timeout_ms);
+        return waitforDelivery(c, message->id, message->qos, &timer);
+    }
+
 #if defined(MQTT_TASK)
   MutexLock(&c->mutex);
 #endif
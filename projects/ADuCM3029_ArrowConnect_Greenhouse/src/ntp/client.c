@@ -26,26 +26,175 @@
 
 #define NTP_TIMESTAMP_DELTA 2208988800ull //Diff btw a UNIX timestamp (Starting Jan, 1st 1970) and a NTP timestamp (Starting Jan, 1st 1900)
 
+//Kiss codes, refId of a stratum 0 reply (RFC 5905 7.4)
+#define NTP_KISS(a, b, c, d) (((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) | ((uint32_t)(c) << 8) | (uint32_t)(d))
+#define NTP_KISS_DENY NTP_KISS('D', 'E', 'N', 'Y')
+#define NTP_KISS_RSTR NTP_KISS('R', 'S', 'T', 'R')
+#define NTP_KISS_RATE NTP_KISS('R', 'A', 'T', 'E')
+
+struct ntp_sample {
+  uint64_t local; //local clock when the reply arrived
+  int64_t offset;
+  int64_t delay;
+};
+
+//(local time, UTC) of the last syncs, for the frequency fit
+static struct {
+  uint64_t local;
+  int64_t utc;
+} _fit[NTP_FIT_POINTS];
+static int _fit_count = 0;
+static int _fit_next = 0;
+
+static struct NTPStatus _status;
+
+//UTC ms <-> NTP 32.32 fixed point seconds, valid until 2106
+static void ms_to_ntp(int64_t ms, uint32_t *sec, uint32_t *frac) {
+  *sec = (uint32_t)(ms / 1000 + (int64_t)NTP_TIMESTAMP_DELTA);
+  *frac = (uint32_t)(((uint64_t)(ms % 1000) << 32) / 1000);
+}
+
+static int64_t ntp_to_ms(uint32_t sec, uint32_t frac) {
+  return (int64_t)(uint32_t)(sec - (uint32_t)NTP_TIMESTAMP_DELTA) * 1000 +
+         (int64_t)(((uint64_t)frac * 1000) >> 32);
+}
+
+static int ntp_sample(int udp_sock, struct sockaddr_in *serveraddr,
+                      struct ntp_sample *sample) {
+  struct NTPPacket pkt;
+  socklen_t serverlen = sizeof(*serveraddr);
+  uint32_t orig_s, orig_f;
+  int ret;
+
+  memset(&pkt, 0, sizeof(pkt));
+  pkt.li = 0; //Leap Indicator : No warning
+  pkt.vn = 4; //Version Number : 4
+  pkt.mode = 3; //Client mode
+
+  uint64_t local1 = local_time_ms();
+  int64_t t1 = clock_wall_ms(local1);
+  ms_to_ntp(t1, &orig_s, &orig_f);
+  pkt.txTm_s = _htonl(orig_s); //WARN: We are in LE format, network byte order is BE
+  pkt.txTm_f = _htonl(orig_f);
+
+  ret = sendto(udp_sock, (char*)&pkt, sizeof(struct NTPPacket), 0, (struct sockaddr*)serveraddr, serverlen);
+  if (ret < 0 ) {
+    DBG("Could not send packet");
+    return NTP_CONN;
+  }
+
+  //Read response
+  ret = recvfrom(udp_sock, (char*)&pkt, sizeof(struct NTPPacket), 0, (struct sockaddr*)serveraddr, &serverlen);
+  uint64_t local4 = local_time_ms();
+
+  if(ret < 0) {
+      DBG("Could not receive packet");
+      return NTP_TIMEOUT;
+  }
+
+  //TODO: Accept chunks
+  if ( ret < (int)sizeof(struct NTPPacket) ) {
+    DBG("Receive packet size does not match %d", ret);
+    return NTP_PRTCL;
+  }
+
+  //Kiss of death message : Not good !
+  if( pkt.stratum == 0) {
+      _status.kod = _ntohl(pkt.refId);
+      DBG("Kissed to death! %08x", (unsigned)_status.kod);
+      return NTP_KOD;
+  }
+
+  //Not a reply to this request, or the server is not synchronized
+  if ( pkt.mode != 4 || pkt.li == 3 ||
+       _ntohl(pkt.origTm_s) != orig_s || _ntohl(pkt.origTm_f) != orig_f ||
+       pkt.txTm_s == 0 ) {
+    DBG("Bogus reply");
+    return NTP_PRTCL;
+  }
+
+  //Compute offset and round trip delay, see RFC 4330 p.13
+  int64_t t2 = ntp_to_ms(_ntohl(pkt.rxTm_s), _ntohl(pkt.rxTm_f));
+  int64_t t3 = ntp_to_ms(_ntohl(pkt.txTm_s), _ntohl(pkt.txTm_f));
+  int64_t t4 = clock_wall_ms(local4);
+
+  sample->local = local4;
+  sample->offset = ((t2 - t1) + (t3 - t4)) / 2;
+  sample->delay = (t4 - t1) - (t3 - t2);
+  if ( sample->delay < 0 ) sample->delay = 0;
+
+  return NTP_OK;
+}
+
+//Least squares slope of (UTC - local) over local time, i.e. how much
+//slower than UTC the local clock runs
+static int ntp_fit_freq(int32_t *freq) {
+  double mx = 0, my = 0, sxx = 0, sxy = 0;
+  uint64_t local0 = _fit[(_fit_next + NTP_FIT_POINTS - _fit_count) % NTP_FIT_POINTS].local;
+  uint64_t last = _fit[(_fit_next + NTP_FIT_POINTS - 1) % NTP_FIT_POINTS].local;
+  int i;
+
+  if ( _fit_count < 2 || last - local0 < NTP_FIT_SPAN_MS ) return -1;
+
+  for ( i = 0; i < _fit_count; i++ ) {
+    mx += (double)(int64_t)(_fit[i].local - local0);
+    my += (double)(_fit[i].utc - (int64_t)_fit[i].local);
+  }
+  mx /= _fit_count;
+  my /= _fit_count;
+  for ( i = 0; i < _fit_count; i++ ) {
+    double dx = (double)(int64_t)(_fit[i].local - local0) - mx;
+    double dy = (double)(_fit[i].utc - (int64_t)_fit[i].local) - my;
+    sxx += dx * dx;
+    sxy += dx * dy;
+  }
+
+  double ppb = sxy / sxx * 1e9;
+  if ( ppb > NTP_MAX_FREQ_PPB ) ppb = NTP_MAX_FREQ_PPB;
+  if ( ppb < -NTP_MAX_FREQ_PPB ) ppb = -NTP_MAX_FREQ_PPB;
+  *freq = (int32_t)ppb;
+  return 0;
+}
+
+static void ntp_discipline(const struct ntp_sample *sample) {
+  int64_t utc = clock_wall_ms(sample->local) + sample->offset;
+  int32_t freq = clock_freq_ppb();
+
+  //UTC at a local time does not depend on earlier corrections, so
+  //the points stay valid across steps and frequency changes
+  _fit[_fit_next].local = sample->local;
+  _fit[_fit_next].utc = utc;
+  _fit_next = (_fit_next + 1) % NTP_FIT_POINTS;
+  if ( _fit_count < NTP_FIT_POINTS ) _fit_count++;
+  ntp_fit_freq(&freq);
+
+  clock_discipline(sample->local, utc, freq);
+
+  _status.offset = sample->offset;
+  _status.delay = sample->delay;
+  _status.freq = freq;
+  DBG("NTP offset %d ms delay %d ms freq %d ppb", (int)sample->offset, (int)sample->delay, (int)freq);
+}
+
+const struct NTPStatus *ntp_status(void) {
+  return &_status;
+}
+
 int ntp_set_time(
         const char* host,
         uint16_t port,
         uint32_t wait_option) {
-#ifdef DEBUG
-  time_t ctTime;
-  ctTime = time(NULL);
-  DBG("Time is set to (UTC): %s", ctime(&ctTime));
-#endif
-  struct NTPPacket pkt;
-
+  struct ntp_sample best, sample;
   int udp_sock;
-  socklen_t serverlen;
   struct sockaddr_in serveraddr;
   struct hostent *server;
+  int ret = NTP_TIMEOUT;
+  int i;
 
   udp_sock = socket(AF_INET, SOCK_DGRAM, 0);
   if (udp_sock < 0) {
       DBG("ERROR opening socket %d", udp_sock);
-      return -1;
+      return NTP_CONN;
   }
   DBG("udp socket open %d", (int)udp_sock);
 
@@ -73,75 +222,27 @@ int ntp_set_time(
   bcopy((char *)server->h_addr,
           (char *)&serveraddr.sin_addr.s_addr, (size_t)server->h_length);
   serveraddr.sin_port = htons(port);
-  serverlen = sizeof(serveraddr);
-
-  //Now ping the server and wait for response
-  //Prepare NTP Packet:
-  pkt.li = 0; //Leap Indicator : No warning
-  pkt.vn = 4; //Version Number : 4
-  pkt.mode = 3; //Client mode
-  pkt.stratum = 0; //Not relevant here
-  pkt.poll = 0; //Not significant as well
-  pkt.precision = 0; //Neither this one is
-
-  pkt.rootDelay = 0; //Or this one
-  pkt.rootDispersion = 0; //Or that one
-  pkt.refId = 0; //...
-
-  pkt.refTm_s = 0;
-  pkt.origTm_s = 0;
-  pkt.rxTm_s = 0;
-  time_t now1 = time(NULL);
-  DBG("get time %d", (int)now1);
-  DBG("ctime %s", ctime(&now1));
 
-  pkt.txTm_s = _htonl( (uint32_t)NTP_TIMESTAMP_DELTA + (uint32_t)time(NULL) ); //WARN: We are in LE format, network byte order is BE
-  pkt.refTm_f = pkt.origTm_f = pkt.rxTm_f = pkt.txTm_f = 0;
-
-  //Set timeout, non-blocking and wait using select
-  int ret;
-  ret = sendto(udp_sock, (char*)&pkt, sizeof(struct NTPPacket), 0, (struct sockaddr*)&serveraddr, serverlen);
-  if (ret < 0 ) {
-    DBG("Could not send packet");
-    soc_close(udp_sock);
-    return NTP_CONN;
+  best.delay = -1;
+  for ( i = 0; i < NTP_SAMPLES; i++ ) {
+    if ( i ) msleep(NTP_SAMPLE_GAP_MS);
+    ret = ntp_sample(udp_sock, &serveraddr, &sample);
+    if ( ret == NTP_KOD ) {
+      //RATE: stop asking and use what we have, DENY/RSTR: drop this server
+      if ( _status.kod != NTP_KISS_RATE ) best.delay = -1;
+      break;
+    }
+    if ( ret == NTP_OK && sample.delay <= NTP_MAX_DELAY_MS &&
+         ( best.delay < 0 || sample.delay < best.delay ) ) {
+      best = sample;
+    }
   }
-
-  //Read response
-  ret = recvfrom(udp_sock, (char*)&pkt, sizeof(struct NTPPacket), 0, (struct sockaddr*)&serveraddr, &serverlen);
   soc_close(udp_sock);
 
-  if(ret < 0) {
-      DBG("Could not receive packet");
-      return NTP_CONN;
+  if ( best.delay < 0 ) {
+    return ret == NTP_OK ? NTP_PRTCL : ret;
   }
 
-  //TODO: Accept chunks
-  if ( ret < (int)sizeof(struct NTPPacket) ) {
-    DBG("Receive packet size does not match %d", ret);
-    return NTP_PRTCL;
-  }
-
-  //Kiss of death message : Not good !
-  if( pkt.stratum == 0) {
-      DBG("Kissed to death!");
-      return NTP_PRTCL;
-  }
-
-  //Correct Endianness
-  pkt.refTm_s = _ntohl( pkt.refTm_s );
-  pkt.refTm_f = _ntohl( pkt.refTm_f );
-  pkt.origTm_s = _ntohl( pkt.origTm_s );
-  pkt.origTm_f = _ntohl( pkt.origTm_f );
-  pkt.rxTm_s = _ntohl( pkt.rxTm_s );
-  pkt.rxTm_f = _ntohl( pkt.rxTm_f );
-  pkt.txTm_s = _ntohl( pkt.txTm_s );
-  pkt.txTm_f = _ntohl( pkt.txTm_f );
-
-  //Compute offset, see RFC 4330 p.13
-  uint32_t destTm_s = (uint32_t)NTP_TIMESTAMP_DELTA + (uint32_t)time(NULL);
-  int64_t offset = ( (int64_t)( pkt.rxTm_s - pkt.origTm_s ) + (int64_t) ( pkt.txTm_s - destTm_s ) ) >> 1; //Avoid overflow
-  set_time((time_t)offset + time(NULL));
-
+  ntp_discipline(&best);
   return NTP_OK;
 }
@@ -16,8 +16,13 @@
 //#endif
 
 
+static const char *_ntp_servers[] = { NTP_SERVERS };
+#define NTP_SERVERS_NUM (int)(sizeof(_ntp_servers) / sizeof(_ntp_servers[0]))
+// keep the last good server for the next sync
+static int _ntp_server = 0;
+
 int ntp_set_time_cycle(void) {
-    return ntp_set_time_common(NTP_DEFAULT_SERVER, NTP_DEFAULT_PORT, NTP_DEFAULT_TIMEOUT, -1);
+    return ntp_set_time_common(NULL, NTP_DEFAULT_PORT, NTP_DEFAULT_TIMEOUT, -1);
 }
 
 int ntp_set_time_common(
@@ -27,10 +32,17 @@ int ntp_set_time_common(
         int try_times) {
     wdt_feed();
     int i=0;
+    int ret;
     do {
-        while( ntp_set_time(server, port, (uint32_t)timeout) != NTP_OK ) {
-            DBG("NTP set time fail...");
+        while( (ret = ntp_set_time(server ? server : _ntp_servers[_ntp_server],
+                                   port, (uint32_t)timeout)) != NTP_OK ) {
+            DBG("NTP set time fail %d...", ret);
+            if ( !server ) {
+                _ntp_server = (_ntp_server + 1) % NTP_SERVERS_NUM;
+                DBG("NTP next server %s", _ntp_servers[_ntp_server]);
+            }
             msleep(1000);
+            wdt_feed();
             if ( try_times >= 0 && i++ >= try_times ) return -1;
         }
         DBG(" time diff %d %d ", (int)time(NULL), (int)build_time());
@@ -20,6 +20,20 @@ void __attribute__((weak)) sha256(char *shasum, char *buf, int size) {
   wc_Sha256Final(&sh, (byte*)shasum);
 }
 
+static Sha256 sha_chunk;
+
+void __attribute__((weak)) sha256_chunk_init(void) {
+  wc_InitSha256(&sha_chunk);
+}
+
+void __attribute__((weak)) sha256_chunk(const char *data, int len) {
+  wc_Sha256Update(&sha_chunk, (const byte*)data, (word32)len);
+}
+
+void __attribute__((weak)) sha256_chunk_hash(char *shasum) {
+  wc_Sha256Final(&sha_chunk, (byte*)shasum);
+}
+
 void __attribute__((weak)) hmac256(char *hmacdig, const char *key, int key_size, const char *buf, int buf_size) {
   Hmac hmac;
   wc_HmacSetKey(&hmac, SHA256, (const byte*)key, (word32)key_size);
@@ -22,9 +22,49 @@ time_t build_time(void) {
   return 0;
 }
 
+// UTC = _clk_wall + elapsed * (1 + _clk_freq) + the part of _clk_slew
+// slewed in so far, elapsed counted in local ms from _clk_local
+static uint64_t _clk_local = 0;
+static int64_t _clk_wall = 0;
+static int32_t _clk_freq = 0;
+static int64_t _clk_slew = 0;
+
+int64_t clock_wall_ms(uint64_t local_ms) {
+  int64_t elapsed = (int64_t)(local_ms - _clk_local);
+  int64_t slewed = elapsed * CLOCK_SLEW_PPM / 1000000;
+  int64_t wall = _clk_wall + elapsed + elapsed * _clk_freq / 1000000000;
+
+  if ( _clk_slew > slewed ) wall += slewed;
+  else if ( _clk_slew < -slewed ) wall -= slewed;
+  else wall += _clk_slew;
+  return wall;
+}
+
+void clock_discipline(uint64_t local_ms, int64_t wall_ms, int32_t freq_ppb) {
+  int64_t now = clock_wall_ms(local_ms);
+  int64_t err = wall_ms - now;
+
+  _clk_local = local_ms;
+  _clk_freq = freq_ppb;
+  if ( err > CLOCK_STEP_MS || err < -CLOCK_STEP_MS ) {
+    _clk_wall = wall_ms;
+    _clk_slew = 0;
+  } else {
+    // never step back, the offset is slewed in at CLOCK_SLEW_PPM
+    _clk_wall = now;
+    _clk_slew = err;
+  }
+}
+
+int32_t clock_freq_ppb(void) {
+  return _clk_freq;
+}
+
 #if !defined(TARGET_NUCLEO_F401RE)
 void set_time(time_t t) {
-    stime(&t);
+  _clk_local = local_time_ms();
+  _clk_wall = (int64_t)t * 1000;
+  _clk_slew = 0;
 }
 #endif
 
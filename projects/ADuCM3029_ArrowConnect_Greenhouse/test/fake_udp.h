@@ -0,0 +1,25 @@
+/* Routes the NTP client socket calls to the server model of test_ntp.c */
+
+#ifndef TEST_FAKE_UDP_H_
+#define TEST_FAKE_UDP_H_
+
+#include <bsd/socket.h>
+
+#define socket(d, t, p) fake_socket(d, t, p)
+#define setsockopt(s, l, o, v, n) fake_setsockopt(s, l, o, v, n)
+#define gethostbyname(h) fake_gethostbyname(h)
+#define sendto(s, b, n, f, a, l) fake_sendto(s, b, n, f, a, l)
+#define recvfrom(s, b, n, f, a, l) fake_recvfrom(s, b, n, f, a, l)
+#undef soc_close
+#define soc_close(s) fake_close(s)
+
+int fake_socket(int domain, int type, int protocol);
+int fake_setsockopt(int sock, int level, int opt, const void *val, socklen_t len);
+struct hostent *fake_gethostbyname(const char *host);
+ssize_t fake_sendto(int sock, const void *buf, size_t len, int flags,
+                    const struct sockaddr *addr, socklen_t addrlen);
+ssize_t fake_recvfrom(int sock, void *buf, size_t len, int flags,
+                      struct sockaddr *addr, socklen_t *addrlen);
+int fake_close(int sock);
+
+#endif  // TEST_FAKE_UDP_H_
@@ -0,0 +1,105 @@
+"""Write signed Arrow events for test_events, one per line.
+
+Each line is the expected result (1 if the event must reach its processor,
+0 if it must be rejected), a tab and the event payload. The signatures are
+made here with hashlib and hmac following the Arrow signature version 1,
+independently of gateway_payload_sign.c:
+
+    canonical = sorted lines "lowercase key=value", numbers as "%f"
+    request   = hid, name, "true" or "false", canonical, each ending in "\n"
+    to sign   = hex SHA-256 of request, api key and version, "\n" between
+    key       = hex HMAC(version, hex HMAC(api key, secret key))
+    signature = hex HMAC(key, to sign)
+
+Usage:
+    python3 sign_events.py > events.tsv
+"""
+
+import hashlib
+import hmac
+import json
+
+API_KEY = 'd91434042d67c6f0fa7897eaefca0141dfd25b134369220ee9e8c36f022a891b'
+SECRET_KEY = 'iwZILgQuUmmk6Cz3wQ7JeGPhg5JuCF0i1osTM2Qy4o8='
+HID = '3c7d1a5e0f2b4d6a8c9e1f3a5b7d9e0c2a4b6d8f'
+
+
+def value(v):
+    """Format a parameter value as the canonical string does."""
+    if isinstance(v, bool):
+        return 'true' if v else 'false'
+    if isinstance(v, str):
+        return v
+    return '%f' % v
+
+
+def hmac_hex(key, msg):
+    """Return the hex HMAC-SHA256 of msg."""
+    return hmac.new(key.encode(), msg.encode(), hashlib.sha256).hexdigest()
+
+
+def sign(name, params, encrypted=False, version='1'):
+    """Return the signature of an event."""
+    canonical = '\n'.join(sorted(k.lower() + '=' + value(v)
+                                 for k, v in params.items()))
+    request = '\n'.join([HID, name, 'true' if encrypted else 'false',
+                         canonical]) + '\n'
+    to_sign = '\n'.join([hashlib.sha256(request.encode()).hexdigest(),
+                         API_KEY, version])
+    key = hmac_hex(version, hmac_hex(API_KEY, SECRET_KEY))
+    return hmac_hex(key, to_sign)
+
+
+def event(name, params, encrypted=False, version='1', signature=None):
+    """Return the payload of a signed event."""
+    if signature is None:
+        signature = sign(name, params, encrypted)
+    return json.dumps({'hid': HID, 'name': name, 'encrypted': encrypted,
+                       'parameters': params, 'signatureVersion': version,
+                       'signature': signature})
+
+
+def main():
+    """Print the events with their expected result."""
+    command = 'ServerToGateway_DeviceCommand'
+    cmd = {'deviceHid': 'a1b2c3d4e5f6', 'command': 'leds',
+           'payload': '{"red":10,"green":20,"blue":30}'}
+    release = {'softwareReleaseTransHid': 'T7', 'tempToken': 'tok',
+               'fromSoftwareVersion': '1.0', 'toSoftwareVersion': '1.1',
+               'md5checksum': '0123456789abcdef0123456789abcdef',
+               'softwareReleaseScheduleHid': 'S1'}
+    # numbers, bools, upper case keys and keys that sort on a shared prefix
+    state = {'deviceHid': 'a1b2', 'transHid': 'X', 'payload': '{}',
+             'Retries': 3, 'Force': True, 'ab': '1', 'a_b': '2', 'A': '0'}
+    good = sign(command, cmd)
+    tampered = dict(cmd, command='ledz')
+    wrong = good[:63] + ('1' if good[63] == '0' else '0')
+    many = dict(('p%02d' % i, 'v') for i in range(20))
+    more = dict(('p%02d' % i, 'v') for i in range(21))
+    long_lines = dict(('p%02d' % i, 'y' * 200) for i in range(6))
+
+    events = [
+        (1, event(command, cmd)),
+        (1, event('ServerToGateway_DeviceSoftwareRelease', release)),
+        (1, event('ServerToGateway_DeviceStateRequest', state)),
+        (1, event(command, cmd, encrypted=True)),
+        (0, event(command, tampered, signature=good)),
+        (0, event(command, cmd, signature=wrong)),
+        (0, event(command, cmd, signature=good[:40])),
+        (0, event(command, cmd, encrypted=True, signature=good)),
+        # MAX_PARAM_LINE members
+        (1, event(command, many)),
+        (0, event(command, more)),
+        # MAX_PARAM_LINE_SIZE for one line
+        (1, event(command, dict(cmd, payload='x' * 240))),
+        (0, event(command, dict(cmd, payload='x' * 300))),
+        # MAX_PARAM_SIZE for all lines
+        (0, event(command, long_lines)),
+        (0, event(command, cmd, version='2')),
+    ]
+    for expect, payload in events:
+        print('%d\t%s' % (expect, payload))
+
+
+if __name__ == '__main__':
+    main()
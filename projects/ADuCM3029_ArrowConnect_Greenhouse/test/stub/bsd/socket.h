@@ -0,0 +1,15 @@
+/* Host sockets in place of the Wi-Fi driver ones, for the tests only */
+
+#ifndef TEST_BSD_SOCKET_H_
+#define TEST_BSD_SOCKET_H_
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+
+#define soc_close close
+
+#endif  // TEST_BSD_SOCKET_H_
@@ -0,0 +1,2 @@
+/* The newlib header is named differently on the host */
+#include <features.h>
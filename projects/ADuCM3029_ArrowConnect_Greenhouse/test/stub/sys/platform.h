@@ -0,0 +1 @@
+/* Nothing of the ADuCM3029 platform header is needed on the host */
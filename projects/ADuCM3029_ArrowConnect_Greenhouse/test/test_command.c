@@ -0,0 +1,301 @@
+/* Host test of the device command registry
+ *
+ * Names are picked so that they collide in the open addressing hash of
+ * device_command.c, including the wrap at the last slot and two names with
+ * the same 32 bit hash. The registry is
+ * checked for replaced callbacks, a full table, the rate limit and the
+ * statistics, ev_DeviceCommand for the answers it sends. The time is
+ * virtual, a callback can make it advance.
+ *
+ * The test also prints the cost of a dispatch.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <json/json.h>
+#include <http/routine.h>
+#include <arrow/events.h>
+#include <arrow/device_command.h>
+
+static int failures;
+
+#define CHECK(cond) do { \
+  if ( !(cond) ) { \
+    printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+    failures++; \
+  } \
+} while (0)
+
+void dbg_line(const char *fmt, ...) {
+  (void)fmt;
+}
+
+/* time */
+static uint64_t now_ms;
+
+uint64_t local_time_ms(void) {
+  return now_ms;
+}
+
+// the device command event reads its strings with this only
+const char *event_param_string(JsonNode *node, const char *name) {
+  JsonNode *tmp = json_find_member(node, name);
+  if ( !tmp || tmp->tag != JSON_STRING ) return NULL;
+  return tmp->string_;
+}
+
+/* answers sent by arrow_send_event_ans */
+static char ans_uri[8][128];
+static char ans_payload[8][64];
+static int ans_const[8];
+static int answers;
+
+int __http_routine(response_init_f req_init, void *arg_init,
+                   response_proc_f resp_proc, void *arg_proc) {
+  http_request_t req;
+  (void)resp_proc; (void)arg_proc;
+  memset(&req, 0, sizeof(req));
+  req_init(&req, arg_init);
+  CHECK(!req.is_corrupt && answers < 8);
+  if ( answers < 8 ) {
+    snprintf(ans_uri[answers], sizeof(ans_uri[0]), "%s", P_VALUE(req.uri));
+    snprintf(ans_payload[answers], sizeof(ans_payload[0]), "%s",
+             req.payload.buf.value ? req.payload.buf.value : "");
+    ans_const[answers] = !req.payload.buf.value || (req.payload.buf.flags & is_const);
+  }
+  answers++;
+  http_request_close(&req);
+  return 0;
+}
+
+/* callbacks */
+#define NAMES 12
+
+static int calls[NAMES];
+static const char *last_payload;
+static int cb_delay;
+
+#define CALLBACK(n) \
+static int cb##n(const char *payload) { \
+  calls[n]++; \
+  last_payload = payload; \
+  now_ms += cb_delay; \
+  return 0; \
+}
+
+CALLBACK(0) CALLBACK(1) CALLBACK(2) CALLBACK(3) CALLBACK(4) CALLBACK(5)
+CALLBACK(6) CALLBACK(7) CALLBACK(8) CALLBACK(9) CALLBACK(10) CALLBACK(11)
+
+static fp cb[NAMES] = { cb0, cb1, cb2, cb3, cb4, cb5, cb6, cb7, cb8, cb9, cb10, cb11 };
+
+static int cb_fail(const char *payload) {
+  (void)payload;
+  return -1;
+}
+
+// the FNV-1a of device_command.c
+static uint32_t hash(const char *name) {
+  uint32_t h = 2166136261u;
+  while ( *name ) {
+    h ^= (uint8_t)*name++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+// NAMES names: 0-3 share slot 5, 4 has slot 6 taken by them, 5-6 share the
+// last slot and wrap, the others go anywhere
+static char names[NAMES][16];
+
+static void pick_names(void) {
+  static const int home[NAMES] = { 5, 5, 5, 5, 6, CMD_HASH_SIZE - 1, CMD_HASH_SIZE - 1, -1, -1, -1, -1, -1 };
+  int i, n = 0;
+  for ( i = 0; i < NAMES; i++ ) {
+    do {
+      snprintf(names[i], sizeof(names[0]), "cmd%d", n++);
+    } while ( home[i] >= 0 && (int)(hash(names[i]) & (CMD_HASH_SIZE - 1)) != home[i] );
+  }
+}
+
+static int run(const char *name, const char **error) {
+  JsonNode pay;
+  memset(&pay, 0, sizeof(pay));
+  pay.tag = JSON_STRING;
+  pay.string_ = "{\"on\":1}";
+  *error = NULL;
+  return command_handler(name, &pay, error);
+}
+
+static void test_collisions(void) {
+  const char *error;
+  int i;
+  free_cmd_handler();
+  CHECK(has_cmd_handler() < 0);
+  for ( i = 0; i < 7; i++ ) CHECK(add_cmd_handler(names[i], cb[i]) == 0);
+  CHECK(has_cmd_handler() == 0);
+
+  // every name finds its own callback along the probe sequence
+  memset(calls, 0, sizeof(calls));
+  for ( i = 6; i >= 0; i-- ) {
+    CHECK(run(names[i], &error) == 0 && error == NULL);
+    CHECK(calls[i] == 1);
+    CHECK(last_payload && strcmp(last_payload, "{\"on\":1}") == 0);
+  }
+
+  // an unknown name on an occupied probe sequence
+  CHECK(run(names[8], &error) == CMD_NO_HANDLER && error != NULL);
+  CHECK(cmd_handler_stats(names[8]) == NULL);
+  CHECK(set_cmd_handler_rate(names[8], 10) < 0);
+
+  // a duplicate replaces the callback of its entry only
+  CHECK(add_cmd_handler(names[2], cb[9]) == 0);
+  CHECK(run(names[2], &error) == 0);
+  CHECK(calls[9] == 1 && calls[2] == 1);
+  CHECK(run(names[3], &error) == 0 && calls[3] == 2);
+  CHECK(cmd_handler_stats(names[2])->calls == 2);
+
+  // the same 32 bit hash, told apart by the name
+  CHECK(hash("cmd60608") == hash("cmd890692"));
+  free_cmd_handler();
+  CHECK(add_cmd_handler("cmd60608", cb[10]) == 0);
+  CHECK(run("cmd890692", &error) == CMD_NO_HANDLER);
+  CHECK(add_cmd_handler("cmd890692", cb[11]) == 0);
+  CHECK(run("cmd890692", &error) == 0 && calls[11] == 1 && calls[10] == 0);
+  CHECK(run("cmd60608", &error) == 0 && calls[10] == 1);
+}
+
+static void test_full(void) {
+  const char *error;
+  int i;
+  free_cmd_handler();
+  for ( i = 0; i < CMD_HANDLERS_MAX; i++ ) CHECK(add_cmd_handler(names[i], cb[i]) == 0);
+  CHECK(add_cmd_handler(names[CMD_HANDLERS_MAX], cb[0]) < 0);
+  CHECK(run(names[CMD_HANDLERS_MAX], &error) == CMD_NO_HANDLER);
+
+  // replacing still works in a full table
+  memset(calls, 0, sizeof(calls));
+  CHECK(add_cmd_handler(names[0], cb[11]) == 0);
+  CHECK(run(names[0], &error) == 0 && calls[11] == 1 && calls[0] == 0);
+
+  // and the table is empty again after free
+  free_cmd_handler();
+  CHECK(run(names[0], &error) == CMD_NO_HANDLER);
+  CHECK(add_cmd_handler(names[CMD_HANDLERS_MAX], cb[0]) == 0);
+}
+
+static void test_rate(void) {
+  const cmd_stats_t *stats;
+  const char *error;
+  free_cmd_handler();
+  CHECK(add_cmd_handler(names[0], cb[0]) == 0);
+  CHECK(add_cmd_handler(names[1], cb_fail) == 0);
+  CHECK(set_cmd_handler_rate(names[0], 1000) == 0);
+  memset(calls, 0, sizeof(calls));
+
+  now_ms = 5000;
+  cb_delay = 7;
+  CHECK(run(names[0], &error) == 0 && calls[0] == 1);
+  cb_delay = 3;
+  now_ms = 5500;
+  CHECK(run(names[0], &error) == CMD_ERROR && calls[0] == 1);
+  CHECK(error && strcmp(error, "rate limited") == 0);
+  now_ms = 5999;
+  CHECK(run(names[0], &error) == CMD_ERROR && calls[0] == 1);
+  now_ms = 6000;
+  CHECK(run(names[0], &error) == 0 && error == NULL && calls[0] == 2);
+  cb_delay = 0;
+
+  // the interval starts at the last executed command, not the dropped ones
+  now_ms = 7003;
+  CHECK(run(names[0], &error) == 0 && calls[0] == 3);
+
+  stats = cmd_handler_stats(names[0]);
+  CHECK(stats && stats->calls == 3 && stats->limited == 2);
+  CHECK(stats->failed == 0 && stats->max_ms == 7);
+
+  // a failing callback, no rate limit
+  CHECK(run(names[1], &error) == -1 && error != NULL);
+  CHECK(run(names[1], &error) == -1);
+  stats = cmd_handler_stats(names[1]);
+  CHECK(stats && stats->calls == 2 && stats->failed == 2 && stats->limited == 0);
+}
+
+static int event(const char *parameters) {
+  mqtt_event_t ev;
+  JsonNode *node = json_decode(parameters);
+  int ret;
+  memset(&ev, 0, sizeof(ev));
+  ev.gateway_hid = "a1b2c3";
+  answers = 0;
+  ret = ev_DeviceCommand(&ev, node);
+  json_delete(node);
+  return ret;
+}
+
+static int ends_with(const char *s, const char *end) {
+  size_t n = strlen(s), m = strlen(end);
+  return n >= m && strcmp(s + n - m, end) == 0;
+}
+
+static void test_event(void) {
+  char parameters[128];
+  free_cmd_handler();
+  CHECK(add_cmd_handler(names[0], cb[0]) == 0);
+  CHECK(set_cmd_handler_rate(names[0], 1000) == 0);
+  memset(calls, 0, sizeof(calls));
+  now_ms = 10000;
+
+  snprintf(parameters, sizeof(parameters),
+           "{\"deviceHid\":\"d1\",\"command\":\"%s\",\"payload\":\"{}\"}", names[0]);
+  CHECK(event(parameters) == 0 && answers == 2 && calls[0] == 1);
+  CHECK(ends_with(ans_uri[0], "/a1b2c3/received") && ans_payload[0][0] == '\0');
+  CHECK(ends_with(ans_uri[1], "/a1b2c3/succeeded") && ans_payload[1][0] == '\0');
+
+  CHECK(event(parameters) == 0 && answers == 2 && calls[0] == 1);
+  CHECK(ends_with(ans_uri[1], "/a1b2c3/failed"));
+  CHECK(strcmp(ans_payload[1], "{\"error\":\"rate limited\"}") == 0);
+  CHECK(ans_const[0] && ans_const[1]);
+
+  CHECK(event("{\"deviceHid\":\"d1\",\"command\":\"none\",\"payload\":\"{}\"}") == 0);
+  CHECK(answers == 2 && ends_with(ans_uri[1], "/failed"));
+  CHECK(strcmp(ans_payload[1], "{\"error\":\"there is no a command handler\"}") == 0);
+
+  // malformed events are answered as received only
+  CHECK(event("{\"deviceHid\":\"d1\",\"payload\":\"{}\"}") < 0 && answers == 1);
+  CHECK(event("{\"deviceHid\":\"d1\",\"command\":\"x\",\"payload\":1}") < 0 && answers == 1);
+}
+
+static double ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void bench(void) {
+  const int n = 10000000;
+  const char *error;
+  JsonNode pay;
+  double t0;
+  int i;
+  free_cmd_handler();
+  for ( i = 0; i < CMD_HANDLERS_MAX; i++ ) add_cmd_handler(names[i], cb[i]);
+  memset(&pay, 0, sizeof(pay));
+  pay.string_ = "{}";
+  t0 = ns();
+  for ( i = 0; i < n; i++ ) command_handler(names[i % CMD_HANDLERS_MAX], &pay, &error);
+  printf("dispatch: %.1f ns on the host\n", (ns() - t0) / n);
+  CHECK(calls[0] >= n / CMD_HANDLERS_MAX);
+}
+
+int main(void) {
+  pick_names();
+  test_collisions();
+  test_full();
+  test_rate();
+  test_event();
+  bench();
+  printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
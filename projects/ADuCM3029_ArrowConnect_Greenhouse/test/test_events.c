@@ -0,0 +1,177 @@
+/* Host test of the signature check of the Arrow events
+ *
+ * process_event runs on events signed by sign_events.py, an independent
+ * implementation of the Arrow signature version 1 on hashlib and hmac. The
+ * hashes come from the wolfCrypt SHA-256 and HMAC of the SDK. Good events
+ * must reach their processor, tampered ones, those over the canonical
+ * string limits and unknown signature versions must not.
+ *
+ * malloc and json_decode are wrapped to measure the heap high-water of every
+ * event and to check that nothing is allocated once the event is parsed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <json/json.h>
+#include <arrow/events.h>
+#include <arrow/gateway_payload_sign.h>
+
+static int failures;
+
+#define CHECK(cond) do { \
+  if ( !(cond) ) { \
+    printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+    failures++; \
+  } \
+} while (0)
+
+// the keys sign_events.py signs with
+char *get_api_key(void) {
+  return "d91434042d67c6f0fa7897eaefca0141dfd25b134369220ee9e8c36f022a891b";
+}
+
+char *get_secret_key(void) {
+  return "iwZILgQuUmmk6Cz3wQ7JeGPhg5JuCF0i1osTM2Qy4o8=";
+}
+
+void dbg_line(const char *fmt, ...) {
+  (void)fmt;
+}
+
+/* heap */
+void *__real_malloc(size_t size);
+void __real_free(void *p);
+
+typedef union {
+  size_t size;
+  long double align;
+} block_t;
+
+static long heap, heap_peak, heap_decoded, decoded_peak;
+
+void *__wrap_malloc(size_t size) {
+  block_t *b = __real_malloc(sizeof(block_t) + size);
+  if ( !b ) return NULL;
+  b->size = size;
+  heap += (long)size;
+  if ( heap > heap_peak ) heap_peak = heap;
+  if ( heap > decoded_peak ) decoded_peak = heap;
+  return b + 1;
+}
+
+void __wrap_free(void *p) {
+  block_t *b = (block_t *)p - 1;
+  if ( !p ) return;
+  heap -= (long)b->size;
+  __real_free(b);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+  void *p = __wrap_malloc(n * size);
+  if ( p ) memset(p, 0, n * size);
+  return p;
+}
+
+void *__wrap_realloc(void *p, size_t size) {
+  void *q = __wrap_malloc(size);
+  if ( q && p ) {
+    block_t *b = (block_t *)p - 1;
+    memcpy(q, p, b->size < size ? b->size : size);
+    __wrap_free(p);
+  }
+  return q;
+}
+
+JsonNode *__real_json_decode(const char *json);
+
+JsonNode *__wrap_json_decode(const char *json) {
+  JsonNode *node = __real_json_decode(json);
+  heap_decoded = decoded_peak = heap;
+  return node;
+}
+
+/* event processors */
+static int dispatched;
+
+// the signature check between json_decode and here must not allocate
+static int dispatch(void) {
+  dispatched++;
+  CHECK(heap == heap_decoded && decoded_peak == heap_decoded);
+  return 0;
+}
+
+int ev_DeviceCommand(void *ev, JsonNode *node) {
+  (void)ev; (void)node;
+  return dispatch();
+}
+
+int ev_DeviceStateRequest(void *ev, JsonNode *node) {
+  (void)ev; (void)node;
+  return dispatch();
+}
+
+int ev_GatewaySoftwareUpdate(void *ev, JsonNode *node) {
+  (void)ev; (void)node;
+  return dispatch();
+}
+
+int ev_DeviceSoftwareRelease(void *ev, JsonNode *node) {
+  (void)ev; (void)node;
+  return dispatch();
+}
+
+// gateway_payload_sign takes the canonical string the event check streams
+static void test_payload_sign(const char *event) {
+  JsonNode *root = json_decode(event);
+  const char *sign;
+  char signature[65];
+  CHECK(root != NULL);
+  if ( !root ) return;
+  sign = event_param_string(root, "signature");
+  CHECK(gateway_payload_sign(signature, "3c7d1a5e0f2b4d6a8c9e1f3a5b7d9e0c2a4b6d8f",
+                             "ServerToGateway_DeviceCommand", 0,
+                             "command=leds\n"
+                             "devicehid=a1b2c3d4e5f6\n"
+                             "payload={\"red\":10,\"green\":20,\"blue\":30}",
+                             "1") == 0);
+  CHECK(sign && strcmp(sign, signature) == 0);
+  json_delete(root);
+}
+
+int main(int argc, char **argv) {
+  static char line[8192];
+  const char *path = argc > 1 ? argv[1] : "events.tsv";
+  FILE *f = fopen(path, "r");
+  long worst = 0;
+  int n = 0;
+
+  CHECK(f != NULL);
+  if ( !f ) return 1;
+  while ( fgets(line, sizeof(line), f) ) {
+    char *event = strchr(line, '\t');
+    int expect = atoi(line);
+    CHECK(event != NULL);
+    if ( !event ) continue;
+    event++;
+    event[strcspn(event, "\n")] = '\0';
+    if ( n == 0 ) test_payload_sign(event);
+
+    dispatched = 0;
+    heap = heap_peak = 0;
+    process_event(event);
+    n++;
+    if ( dispatched != expect ) {
+      printf("event %d: expected %s: %.100s\n", n, expect ? "dispatch" : "reject", event);
+      failures++;
+    }
+    CHECK(heap == 0);
+    if ( heap_peak > worst ) worst = heap_peak;
+  }
+  fclose(f);
+  CHECK(n == 14);
+
+  printf("%d events, heap high-water %ld bytes\n", n, worst);
+  printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,618 @@
+/* Host test of the MQTT client outbound queue
+ *
+ * The network is a scripted broker: it parses what the client writes,
+ * answers CONNECT, PINGREQ and PUBREL and holds the PUBACKs, PUBRECs and
+ * PUBCOMPs until the test releases them, in any order. The link can be
+ * dropped, then reads and writes fail and the held acks are lost until the
+ * client connects again. Every payload carries its sequence number and a
+ * pattern the broker checks. Time only moves while the client waits for
+ * data, so the test runs instantly.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mqtt/client/MQTTClient.h>
+#include <mqtt/packet/MQTTPublish.h>
+
+#define TOPIC "t/x"
+#define MAX_SEQ 8192
+#define COMMAND_TIMEOUT_MS 1000
+
+static int failures;
+
+#define CHECK(cond) do { \
+  if ( !(cond) ) { \
+    printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+    failures++; \
+  } \
+} while (0)
+
+// virtual time in ms since the start of the test
+static unsigned long long vt;
+static uint32_t seed = 1;
+
+static uint32_t rnd(void) {
+  seed = seed * 1103515245u + 12345u;
+  return seed >> 16;
+}
+
+void TimerInit(TimerInterval *t) {
+  t->end_time.tv_sec = 0;
+  t->end_time.tv_usec = 0;
+}
+
+void TimerCountdownMS(TimerInterval *t, unsigned int ms) {
+  unsigned long long end = vt + ms;
+  t->end_time.tv_sec = end / 1000;
+  t->end_time.tv_usec = (end % 1000) * 1000;
+}
+
+void TimerCountdown(TimerInterval *t, unsigned int s) {
+  TimerCountdownMS(t, s * 1000);
+}
+
+int TimerLeftMS(TimerInterval *t) {
+  unsigned long long end = (unsigned long long)t->end_time.tv_sec * 1000 + t->end_time.tv_usec / 1000;
+  return end > vt ? (int)(end - vt) : 0;
+}
+
+char TimerIsExpired(TimerInterval *t) {
+  return TimerLeftMS(t) == 0;
+}
+
+/* messages, indexed by sequence number */
+static struct {
+  int accepted;             // queued by MQTTPublishAsync
+  int qos;
+  unsigned short id;        // given by the client
+  int received;             // PUBLISH packets seen by the broker
+  int dups;                 // ... with DUP set
+  int delivered;            // delivery handler calls
+} msg[MAX_SEQ];
+static int nseq;
+static int delivery_log[MAX_SEQ];
+static int ndelivered;
+
+/* broker */
+static int link_up;
+static int auto_ack;
+static unsigned char rx[4096];
+static int rx_len, rx_pos;
+static unsigned char wr[4096];
+static int wr_len;
+// ack the broker owes or waits for, per packet id
+static unsigned char id_state[MAX_PACKET_ID + 1];
+static struct {
+  unsigned char type;
+  unsigned short id;
+} held[64];
+static int nheld;
+static int last_first_seq;
+
+static int connects, pubrels, id_clashes, bad_payloads, resent_without_dup, out_of_order,
+    spurious_deliveries;
+
+static void push(const unsigned char *p, int len) {
+  memcpy(&rx[rx_len], p, len);
+  rx_len += len;
+}
+
+static void send_ack(unsigned char type, unsigned short id) {
+  unsigned char p[4];
+
+  MQTTSerialize_ack(p, sizeof(p), type, 0, id);
+  push(p, sizeof(p));
+  // after a PUBREC the broker waits for the PUBREL
+  id_state[id] = type == PUBREC ? PUBREL : 0;
+}
+
+static void reply(unsigned char type, unsigned short id) {
+  id_state[id] = type;
+  if ( auto_ack ) {
+    send_ack(type, id);
+  } else {
+    held[nheld].type = type;
+    held[nheld].id = id;
+    nheld++;
+  }
+}
+
+// send the held ack at index i
+static void release(int i) {
+  send_ack(held[i].type, held[i].id);
+  nheld--;
+  memmove(&held[i], &held[i + 1], (nheld - i) * sizeof(held[0]));
+}
+
+static void release_id(unsigned short id) {
+  int i;
+
+  for (i = 0; i < nheld; i++) {
+    if ( held[i].id == id ) {
+      release(i);
+      return;
+    }
+  }
+  CHECK(!"no held ack");
+}
+
+static void fill(char *p, int seq, int len) {
+  int i;
+
+  sprintf(p, "%08d", seq);
+  for (i = 8; i < len; i++)
+    p[i] = (char)('a' + (seq + i) % 26);
+}
+
+static int payload_seq(const unsigned char *p, int len) {
+  char expected[64];
+  char digits[9];
+  int seq;
+
+  if ( len < 8 || len > (int)sizeof(expected) )
+    return 0;
+  memcpy(digits, p, 8);
+  digits[8] = 0;
+  seq = atoi(digits);
+  if ( seq <= 0 || seq > nseq )
+    return 0;
+  fill(expected, seq, len);
+  return memcmp(expected, p, len) == 0 ? seq : 0;
+}
+
+static void broker_publish(unsigned char *p, int len) {
+  unsigned char dup, retained;
+  unsigned short id;
+  int qos, plen, seq;
+  MQTTString topic;
+  unsigned char *payload;
+
+  if ( MQTTDeserialize_publish(&dup, &qos, &retained, &id, &topic, &payload, &plen, p, len) != 1 ||
+       (seq = payload_seq(payload, plen)) == 0 ) {
+    bad_payloads++;
+    return;
+  }
+  if ( ++msg[seq].received == 1 ) {
+    // publishes go out in the order they were queued
+    if ( seq < last_first_seq )
+      out_of_order++;
+    last_first_seq = seq;
+  }
+  if ( dup )
+    msg[seq].dups++;
+  else if ( msg[seq].received > 1 )
+    resent_without_dup++;
+  if ( qos == QOS0 )
+    return;
+  if ( !dup && id_state[id] )
+    id_clashes++;
+  if ( msg[seq].received == 1 )
+    msg[seq].id = id;
+  else if ( msg[seq].id != id )
+    id_clashes++;
+  reply(qos == QOS1 ? PUBACK : PUBREC, id);
+}
+
+static void broker_packet(unsigned char *p, int len) {
+  static const unsigned char connack[] = { 0x20, 2, 0, 0 };
+  static const unsigned char pingresp[] = { 0xD0, 0 };
+  unsigned char type, dup;
+  unsigned short id;
+
+  switch (p[0] >> 4) {
+    case CONNECT:
+      connects++;
+      push(connack, sizeof(connack));
+      break;
+    case PUBLISH:
+      broker_publish(p, len);
+      break;
+    case PUBREL:
+      MQTTDeserialize_ack(&type, &dup, &id, p, len);
+      pubrels++;
+      reply(PUBCOMP, id);
+      break;
+    case PINGREQ:
+      push(pingresp, sizeof(pingresp));
+      break;
+  }
+}
+
+static int net_write(Network *n, unsigned char *p, int len, int timeout_ms) {
+  int rem_len, hdr, mult;
+
+  if ( !link_up )
+    return -1;
+  memcpy(&wr[wr_len], p, len);
+  wr_len += len;
+  while ( wr_len >= 2 ) {
+    rem_len = 0;
+    mult = 1;
+    hdr = 1;
+    do {
+      rem_len += (wr[hdr] & 127) * mult;
+      mult *= 128;
+    } while ( wr[hdr++] & 128 && hdr < wr_len );
+    if ( wr_len < hdr + rem_len )
+      break;
+    broker_packet(wr, hdr + rem_len);
+    wr_len -= hdr + rem_len;
+    memmove(wr, &wr[hdr + rem_len], wr_len);
+  }
+  return len;
+}
+
+// an idle or dead link returns when the timeout is over
+static int net_read(Network *n, unsigned char *p, int len, int timeout_ms) {
+  int avail = rx_len - rx_pos;
+
+  if ( !link_up || avail == 0 ) {
+    if ( timeout_ms > 0 )
+      vt += timeout_ms;
+    return link_up ? 0 : -1;
+  }
+  if ( len > avail )
+    len = avail;
+  memcpy(p, &rx[rx_pos], len);
+  rx_pos += len;
+  if ( rx_pos == rx_len )
+    rx_pos = rx_len = 0;
+  return len;
+}
+
+static void drop_link(void) {
+  link_up = 0;
+  rx_len = rx_pos = 0;
+  wr_len = 0;
+  nheld = 0;
+}
+
+// a stale or repeated ack for an id the broker does not owe anything for
+static void stray_ack(unsigned short id) {
+  unsigned char p[4];
+
+  if ( id_state[id] )
+    return;
+  MQTTSerialize_ack(p, sizeof(p), PUBACK, 0, id);
+  push(p, sizeof(p));
+}
+
+/* client */
+static MQTTClient c;
+static Network net;
+static unsigned char sendbuf[256];
+static unsigned char readbuf[256];
+static unsigned char outbuf[2048];
+
+static void on_delivery(unsigned short id) {
+  int i, seq = 0;
+
+  for (i = 1; i <= nseq; i++) {
+    if ( msg[i].accepted && msg[i].qos != QOS0 && !msg[i].delivered && msg[i].id == id ) {
+      if ( seq )
+        id_clashes++;
+      seq = i;
+    }
+  }
+  if ( seq == 0 || msg[seq].received == 0 ) {
+    spurious_deliveries++;
+    return;
+  }
+  msg[seq].delivered++;
+  delivery_log[ndelivered++] = seq;
+}
+
+static void reconnect(void) {
+  MQTTPacket_connectData options = MQTTPacket_connectData_initializer;
+
+  options.cleansession = 0;
+  link_up = 1;
+  MQTTClientInit(&c, &net, COMMAND_TIMEOUT_MS, sendbuf, sizeof(sendbuf), readbuf, sizeof(readbuf));
+  CHECK(MQTTConnect(&c, &options) == MQTT_SUCCESS);
+}
+
+static void start(size_t outbuf_size) {
+  memset(msg, 0, sizeof(msg));
+  memset(id_state, 0, sizeof(id_state));
+  nseq = ndelivered = nheld = last_first_seq = 0;
+  connects = pubrels = 0;
+  auto_ack = 1;
+  net.mqttread = net_read;
+  net.mqttwrite = net_write;
+  drop_link();
+  MQTTOutboundInit(&c, outbuf, outbuf_size, on_delivery);
+  reconnect();
+}
+
+// publish the next sequence number with a payload of len bytes
+static int publish_len(int qos, int len, int sync) {
+  char payload[64];
+  MQTTMessage m;
+  int seq = ++nseq;
+  int rc;
+
+  fill(payload, seq, len);
+  memset(&m, 0, sizeof(m));
+  m.qos = (enum QoS)qos;
+  m.payload = payload;
+  m.payloadlen = len;
+  // MQTTPublish delivers before it returns
+  msg[seq].accepted = 1;
+  msg[seq].qos = qos;
+  rc = sync ? MQTTPublish(&c, TOPIC, &m) : MQTTPublishAsync(&c, TOPIC, &m);
+  if ( rc == BUFFER_OVERFLOW ) {
+    msg[seq].accepted = 0;
+  } else {
+    // the broker may have seen it already
+    CHECK(msg[seq].received == 0 || qos == QOS0 || msg[seq].id == m.id);
+    msg[seq].id = m.id;
+  }
+  return rc;
+}
+
+static int publish(int qos) {
+  return publish_len(qos, 20, 0);
+}
+
+static MQTTOutbound *newest(void) {
+  return &c.outbound.entries[(c.outbound.head + c.outbound.count - 1) % MAX_QUEUED_MESSAGES];
+}
+
+static void drain(void) {
+  int i;
+
+  auto_ack = 1;
+  while ( nheld )
+    release(0);
+  for (i = 0; i < 100 && MQTTOutboundPending(&c); i++)
+    MQTTYield(&c, 10);
+}
+
+static void check_all(void) {
+  int i, lost = 0, repeated = 0, rejected_sent = 0;
+
+  for (i = 1; i <= nseq; i++) {
+    if ( !msg[i].accepted ) {
+      rejected_sent += msg[i].received != 0;
+      continue;
+    }
+    lost += msg[i].received == 0;
+    if ( msg[i].qos != QOS0 )
+      repeated += msg[i].delivered != 1;
+  }
+  CHECK(lost == 0);
+  CHECK(repeated == 0);
+  CHECK(rejected_sent == 0);
+  CHECK(id_clashes == 0);
+  CHECK(bad_payloads == 0);
+  CHECK(resent_without_dup == 0);
+  CHECK(out_of_order == 0);
+  CHECK(spurious_deliveries == 0);
+  CHECK(MQTTOutboundPending(&c) == 0);
+  CHECK(c.outbound.count == 0);
+  CHECK(c.outbound.inflight == 0);
+}
+
+static void test_window(void) {
+  int i;
+
+  start(sizeof(outbuf));
+  auto_ack = 0;
+  for (i = 0; i < 6; i++)
+    CHECK(publish(QOS1) > 0);
+  CHECK(nheld == MAX_INFLIGHT_MESSAGES);
+  CHECK(c.outbound.inflight == MAX_INFLIGHT_MESSAGES);
+  CHECK(MQTTOutboundPending(&c) == 6);
+  CHECK(msg[5].received == 0);
+
+  // acks out of order move the window on
+  release_id(msg[3].id);
+  release_id(msg[1].id);
+  MQTTYield(&c, 10);
+  CHECK(ndelivered == 2 && delivery_log[0] == 3 && delivery_log[1] == 1);
+  CHECK(msg[5].received == 1 && msg[6].received == 1);
+  CHECK(MQTTOutboundPending(&c) == 4);
+  // message 3 is done but its room waits for message 2
+  CHECK(c.outbound.count == 5);
+
+  // a repeated ack is ignored
+  stray_ack(msg[1].id);
+  stray_ack(msg[3].id);
+  MQTTYield(&c, 10);
+  CHECK(ndelivered == 2);
+  CHECK(c.outbound.inflight == MAX_INFLIGHT_MESSAGES);
+
+  while ( nheld )
+    release(nheld - 1);
+  MQTTYield(&c, 10);
+  CHECK(ndelivered == 6 && delivery_log[2] == 6 && delivery_log[5] == 2);
+  check_all();
+}
+
+static void test_dropped_link(void) {
+  start(sizeof(outbuf));
+  auto_ack = 0;
+  CHECK(publish(QOS1) > 0);
+  CHECK(publish(QOS1) > 0);
+  CHECK(publish(QOS2) > 0);
+  release_id(msg[3].id);
+  MQTTYield(&c, 10);
+  // the PUBREL went, the PUBCOMP is held with the two PUBACKs
+  CHECK(pubrels == 1 && nheld == 3);
+
+  drop_link();
+  MQTTYield(&c, 100);
+  // sending fails, the messages stay queued
+  CHECK(publish(QOS1) == FAILURE);
+  CHECK(publish(QOS0) == FAILURE);
+  CHECK(MQTTOutboundPending(&c) == 5);
+  CHECK(msg[4].received == 0 && msg[5].received == 0);
+
+  // after the reconnect the unacknowledged publishes go again with DUP set and
+  // the PUBREL is repeated, the queued ones go for the first time
+  auto_ack = 1;
+  reconnect();
+  MQTTYield(&c, 10);
+  CHECK(connects == 2);
+  CHECK(msg[1].received == 2 && msg[1].dups == 1);
+  CHECK(msg[2].received == 2 && msg[2].dups == 1);
+  CHECK(msg[3].received == 1 && pubrels == 2);
+  CHECK(msg[4].received == 1 && msg[4].dups == 0);
+  CHECK(msg[5].received == 1 && msg[5].dups == 0);
+  check_all();
+}
+
+static void test_id_reuse(void) {
+  int i, j;
+
+  start(sizeof(outbuf));
+  auto_ack = 0;
+  for (i = 0; i < 3; i++)
+    CHECK(publish(QOS1) > 0);
+
+  // MQTTClientInit restarts the packet ids, the ones still in flight are skipped
+  drop_link();
+  reconnect();
+  MQTTYield(&c, 10);
+  CHECK(nheld == 3);
+  for (i = 0; i < 3; i++)
+    CHECK(publish(QOS1) > 0);
+  for (i = 1; i <= 6; i++)
+    for (j = 1; j < i; j++)
+      CHECK(msg[i].id != msg[j].id);
+  CHECK(id_clashes == 0);
+
+  // each ack completes its own message
+  while ( nheld ) {
+    i = held[rnd() % nheld].id;
+    release_id(i);
+    MQTTYield(&c, 10);
+    CHECK(msg[delivery_log[ndelivered - 1]].id == i);
+  }
+  drain();
+  CHECK(ndelivered == 6);
+
+  // the ids wrap at MAX_PACKET_ID and skip the ones in flight
+  c.next_packetid = 0;
+  CHECK(publish(QOS1) == 1);
+  CHECK(publish(QOS1) == 2);
+  c.next_packetid = MAX_PACKET_ID - 1;
+  CHECK(publish(QOS1) == MAX_PACKET_ID);
+  CHECK(publish(QOS1) == 3);
+  drain();
+  check_all();
+}
+
+static void test_alloc_wrap(void) {
+  int i;
+
+  // a 40 byte payload makes a 49 byte PUBLISH, 5 fit in 256 bytes
+  start(256);
+  auto_ack = 0;
+  for (i = 0; i < 5; i++)
+    CHECK(publish_len(QOS1, 40, 0) > 0);
+  CHECK(newest()->len == 49);
+  CHECK(publish_len(QOS1, 40, 0) == BUFFER_OVERFLOW);
+  CHECK(c.outbound.count == 5);
+
+  release_id(msg[1].id);
+  release_id(msg[2].id);
+  MQTTYield(&c, 10);
+  CHECK(c.outbound.count == 3 && msg[5].received == 1);
+
+  // 11 bytes are left at the end, the next packets go to the start
+  CHECK(publish_len(QOS1, 40, 0) > 0);
+  CHECK(newest()->offset == 0);
+  CHECK(publish_len(QOS1, 40, 0) > 0);
+  CHECK(newest()->offset == 49);
+  // nothing left before the oldest packet
+  CHECK(publish_len(QOS1, 40, 0) == BUFFER_OVERFLOW);
+  CHECK(publish_len(QOS1, 8, 0) == BUFFER_OVERFLOW);
+
+  // the packets on both sides of the wrap are sent again intact
+  drop_link();
+  auto_ack = 1;
+  reconnect();
+  drain();
+  CHECK(msg[3].dups == 1 && msg[5].dups == 1);
+  CHECK(msg[7].dups == 1 && msg[8].received == 1);
+  check_all();
+
+  // the number of entries is bounded too
+  start(sizeof(outbuf));
+  auto_ack = 0;
+  for (i = 0; i < MAX_QUEUED_MESSAGES; i++)
+    CHECK(publish(QOS1) > 0);
+  CHECK(publish(QOS0) == BUFFER_OVERFLOW);
+  drain();
+  check_all();
+}
+
+static void test_blocking(void) {
+  unsigned long long t0;
+
+  start(sizeof(outbuf));
+  CHECK(publish_len(QOS1, 20, 1) == MQTT_SUCCESS);
+  CHECK(msg[1].delivered == 1);
+  CHECK(publish_len(QOS2, 20, 1) == MQTT_SUCCESS);
+  CHECK(msg[2].delivered == 1 && pubrels == 1);
+  CHECK(publish_len(QOS0, 20, 1) == MQTT_SUCCESS);
+  CHECK(msg[3].received == 1);
+
+  // no ack within the command timeout, the message stays queued
+  auto_ack = 0;
+  t0 = vt;
+  CHECK(publish_len(QOS1, 20, 1) == FAILURE);
+  CHECK(vt - t0 >= COMMAND_TIMEOUT_MS);
+  CHECK(MQTTOutboundPending(&c) == 1);
+  drain();
+  check_all();
+}
+
+// random publishes, acks in any order, repeated acks and dropped links
+static void test_soak(void) {
+  int step, r, overflows = 0, drops = 0;
+
+  start(512);
+  auto_ack = 0;
+  seed = 4321;
+  for (step = 0; step < 20000; step++) {
+    r = rnd() % 100;
+    if ( r < 30 ) {
+      if ( publish_len(rnd() % 10 ? QOS1 : (rnd() % 2 ? QOS2 : QOS0), 8 + rnd() % 40, 0) ==
+           BUFFER_OVERFLOW )
+        overflows++;
+    } else if ( r < 60 ) {
+      if ( nheld )
+        release(rnd() % nheld);
+    } else if ( r < 61 ) {
+      drop_link();
+      MQTTYield(&c, 50);
+      reconnect();
+      drops++;
+    } else if ( r < 63 ) {
+      stray_ack(1 + rnd() % 16);
+    }
+    MQTTYield(&c, 1 + rnd() % 5);
+  }
+  drain();
+  CHECK(drops > 100);
+  CHECK(overflows > 100);
+  CHECK(nseq - overflows > 3000);
+  check_all();
+  printf("%d publishes, %d rejected, %d dropped links\n", nseq, overflows, drops);
+}
+
+int main(void) {
+  test_window();
+  test_dropped_link();
+  test_id_reuse();
+  test_alloc_wrap();
+  test_blocking();
+  test_soak();
+
+  printf(failures ? "FAILED\n" : "OK\n");
+
+  return failures ? 1 : 0;
+}
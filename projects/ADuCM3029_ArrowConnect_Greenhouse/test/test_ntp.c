@@ -0,0 +1,200 @@
+/* Host test of the SNTP client and the clock discipline
+ *
+ * The network and the clocks are simulated: the local clock runs
+ * LOCAL_SKEW_PPM slow, the server replies after asymmetric random delays
+ * and can send a Kiss-o'-Death or stay silent. Time only moves when the
+ * client sleeps or waits for a reply, so the test runs instantly.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time/time.h>
+#include <ntp/client.h>
+#include "fake_udp.h"
+
+#define LOCAL_SKEW_PPM 300.0
+#define UTC_BASE_MS 1700000000000.0
+#define SYNC_PERIOD_MS 120000
+#define TIMEOUT_MS 500
+
+#define KISS(a, b, c, d) (((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) | ((uint32_t)(c) << 8) | (uint32_t)(d))
+
+static int failures;
+
+#define CHECK(cond) do { \
+  if ( !(cond) ) { \
+    printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+    failures++; \
+  } \
+} while (0)
+
+// virtual time in ms since the start of the test
+static double vt;
+static uint32_t seed = 1;
+
+static double true_utc_ms(void) {
+  return UTC_BASE_MS + vt;
+}
+
+uint64_t local_time_ms(void) {
+  return (uint64_t)(vt * (1.0 - LOCAL_SKEW_PPM * 1e-6)) + 5000;
+}
+
+int msleep(int ms) {
+  vt += ms;
+  return 0;
+}
+
+void dbg_line(const char *fmt, ...) {
+  (void)fmt;
+}
+
+// network delay of one direction, 5..45 ms
+static double net_delay(void) {
+  seed = seed * 1103515245u + 12345u;
+  return 5.0 + (double)((seed >> 16) % 4000) / 100.0;
+}
+
+static void put_ntp(uint32_t *s, uint32_t *f, double utc_ms) {
+  double sec = utc_ms / 1000.0;
+  uint64_t whole = (uint64_t)sec;
+  *s = htonl((uint32_t)(whole + 2208988800ull));
+  *f = htonl((uint32_t)((sec - (double)whole) * 4294967296.0));
+}
+
+/* server model */
+static struct NTPPacket reply;
+static int reply_pending;
+static double reply_at;
+static uint32_t kiss_next;
+static int kiss_after;
+static int silent;
+
+int fake_socket(int domain, int type, int protocol) {
+  (void)domain; (void)type; (void)protocol;
+  return 3;
+}
+
+int fake_setsockopt(int sock, int level, int opt, const void *val, socklen_t len) {
+  (void)sock; (void)level; (void)opt; (void)val; (void)len;
+  return 0;
+}
+
+struct hostent *fake_gethostbyname(const char *host) {
+  static char addr[4] = { 127, 0, 0, 1 };
+  static char *list[2] = { addr, NULL };
+  static struct hostent h;
+  (void)host;
+  h.h_addrtype = AF_INET;
+  h.h_length = 4;
+  h.h_addr_list = list;
+  return &h;
+}
+
+ssize_t fake_sendto(int sock, const void *buf, size_t len, int flags,
+                    const struct sockaddr *addr, socklen_t addrlen) {
+  const struct NTPPacket *req = (const struct NTPPacket *)buf;
+  double rx;
+  (void)sock; (void)flags; (void)addr; (void)addrlen;
+
+  reply_pending = !silent;
+  if ( !reply_pending ) return (ssize_t)len;
+  memset(&reply, 0, sizeof(reply));
+  reply.li = 0;
+  reply.vn = 4;
+  reply.mode = 4;
+  reply.stratum = 2;
+  reply.origTm_s = req->txTm_s;
+  reply.origTm_f = req->txTm_f;
+  rx = vt + net_delay();
+  put_ntp(&reply.rxTm_s, &reply.rxTm_f, UTC_BASE_MS + rx);
+  put_ntp(&reply.txTm_s, &reply.txTm_f, UTC_BASE_MS + rx + 0.2);
+  reply_at = rx + 0.2 + net_delay();
+  if ( kiss_next && kiss_after-- == 0 ) {
+    reply.stratum = 0;
+    reply.refId = htonl(kiss_next);
+    kiss_next = 0;
+  }
+  return (ssize_t)len;
+}
+
+ssize_t fake_recvfrom(int sock, void *buf, size_t len, int flags,
+                      struct sockaddr *addr, socklen_t *addrlen) {
+  (void)sock; (void)flags; (void)addr; (void)addrlen;
+  if ( !reply_pending ) {
+    vt += TIMEOUT_MS;
+    return -1;
+  }
+  reply_pending = 0;
+  vt = reply_at;
+  memcpy(buf, &reply, len < sizeof(reply) ? len : sizeof(reply));
+  return (ssize_t)sizeof(reply);
+}
+
+int fake_close(int sock) {
+  (void)sock;
+  return 0;
+}
+
+static double clock_error_ms(void) {
+  return (double)clock_wall_ms(local_time_ms()) - true_utc_ms();
+}
+
+int main(void) {
+  const struct NTPStatus *st;
+  double err, before;
+  int i, ret;
+
+  // the first sync steps the clock from 0 to UTC
+  ret = ntp_set_time("pool.ntp.org", 123, TIMEOUT_MS);
+  CHECK(ret == NTP_OK);
+  CHECK(fabs(clock_error_ms()) < 50.0);
+
+  for ( i = 1; i < 30; i++ ) {
+    msleep(SYNC_PERIOD_MS);
+    before = (double)clock_wall_ms(local_time_ms());
+    if ( i == 10 ) {
+      // rate limited on the second request, the first one is used
+      kiss_next = KISS('R', 'A', 'T', 'E');
+      kiss_after = 1;
+    }
+    if ( i == 20 ) {
+      kiss_next = KISS('D', 'E', 'N', 'Y');
+      kiss_after = 0;
+    }
+    ret = ntp_set_time("pool.ntp.org", 123, TIMEOUT_MS);
+    st = ntp_status();
+    err = clock_error_ms();
+    if ( i == 20 ) {
+      CHECK(ret == NTP_KOD);
+      CHECK(st->kod == KISS('D', 'E', 'N', 'Y'));
+    } else {
+      CHECK(ret == NTP_OK);
+      if ( i == 10 ) CHECK(st->kod == KISS('R', 'A', 'T', 'E'));
+      // small offsets are slewed, the clock never goes back
+      CHECK((double)clock_wall_ms(local_time_ms()) >= before);
+    }
+    CHECK(fabs(err) < 50.0);
+    if ( i >= 10 ) {
+      CHECK(st->freq > 0.9 * LOCAL_SKEW_PPM * 1000.0);
+      CHECK(st->freq < 1.1 * LOCAL_SKEW_PPM * 1000.0);
+    }
+  }
+
+  // a silent server is reported as a timeout
+  silent = 1;
+  ret = ntp_set_time("pool.ntp.org", 123, TIMEOUT_MS);
+  CHECK(ret == NTP_TIMEOUT);
+  silent = 0;
+
+  // the fitted frequency keeps the clock close without syncs
+  msleep(3600000);
+  err = clock_error_ms();
+  printf("error after 1 h without sync %.1f ms, freq %d ppb\n", err, (int)ntp_status()->freq);
+  CHECK(fabs(err) < 50.0);
+
+  printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
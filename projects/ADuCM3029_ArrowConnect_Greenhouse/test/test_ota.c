@@ -0,0 +1,337 @@
+/* Host test of the OTA download to the staging slot and of the boot states
+ *
+ * ev_DeviceSoftwareRelease runs against an HTTP server on the loopback
+ * (ARROW_PORT of the plain HTTP build) that can drop the link, ignore the
+ * Range header, answer with chunked bodies or corrupt a byte. The flash
+ * slot and its metadata are simulated in RAM.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <bsd/socket.h>
+#include <config.h>
+#include <json/json.h>
+#include <http/request.h>
+#include <arrow/storage.h>
+#include <arrow/software_release.h>
+#include <ssl/md5sum.h>
+
+#define IMAGE_SIZE 100000
+#define SLOT_SIZE (120 * 1024)
+#define PAGE_SIZE 2048
+
+static int failures;
+
+#define CHECK(cond) do { \
+  if ( !(cond) ) { \
+    printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+    failures++; \
+  } \
+} while (0)
+
+/* platform */
+static int reboots;
+
+void reboot(void) {
+  reboots++;
+}
+
+int wdt_feed(void) {
+  return 0;
+}
+
+int msleep(int ms) {
+  (void)ms;
+  return 0;
+}
+
+void sign_request(http_request_t *req) {
+  (void)req;
+}
+
+void dbg_line(const char *fmt, ...) {
+  (void)fmt;
+}
+
+// the plain HTTP build never uses TLS
+int ssl_connect(int sock) { (void)sock; return -1; }
+int ssl_recv(int sock, char *data, int len) { (void)sock; (void)data; (void)len; return -1; }
+int ssl_send(int sock, char *data, int len) { (void)sock; (void)data; (void)len; return -1; }
+int ssl_close(int sock) { (void)sock; return 0; }
+
+// every Arrow host is the loopback server
+struct hostent *gethostbyname(const char *name) {
+  static char addr[4] = { 127, 0, 0, 1 };
+  static char *list[2] = { addr, NULL };
+  static struct hostent h;
+  (void)name;
+  h.h_addrtype = AF_INET;
+  h.h_length = 4;
+  h.h_addr_list = list;
+  return &h;
+}
+
+/* flash */
+static unsigned char slot[SLOT_SIZE];
+static int erased[SLOT_SIZE / PAGE_SIZE];
+static ota_meta_t meta;
+static int meta_valid;
+
+uint32_t ota_slot_size(void) {
+  return SLOT_SIZE;
+}
+
+int ota_slot_write(uint32_t offset, const char *buf, uint32_t size) {
+  uint32_t i;
+  CHECK(offset % OTA_WRITE_SIZE == 0);
+  CHECK(size <= OTA_WRITE_SIZE && offset + size <= SLOT_SIZE);
+  if ( offset % PAGE_SIZE == 0 ) {
+    memset(slot + offset, 0xff, PAGE_SIZE);
+    erased[offset / PAGE_SIZE] = 1;
+  }
+  CHECK(erased[offset / PAGE_SIZE]);
+  for ( i = 0; i < size; i++ ) slot[offset + i] &= (unsigned char)buf[i];
+  return 0;
+}
+
+int ota_slot_read(uint32_t offset, char *buf, uint32_t size) {
+  memcpy(buf, slot + offset, size);
+  return 0;
+}
+
+int ota_meta_restore(ota_meta_t *m) {
+  if ( !meta_valid ) {
+    memset(m, 0, sizeof(*m));
+    return -1;
+  }
+  *m = meta;
+  return 0;
+}
+
+int ota_meta_save(const ota_meta_t *m) {
+  meta = *m;
+  meta_valid = 1;
+  return 0;
+}
+
+/* server */
+static unsigned char image[IMAGE_SIZE];
+static int drop_at[4];
+static int drops;
+static int ignore_range;
+static int chunked;
+static int early_end;
+static int corrupt_at = -1;
+static int always_drop;
+static char trans_log[256];
+
+static void send_body(int c, const unsigned char *body, int len, int stop) {
+  char head[16];
+  int sent = 0;
+  while ( sent < stop ) {
+    int n = stop - sent > 1460 ? 1460 : stop - sent;
+    if ( chunked ) send(c, head, (size_t)sprintf(head, "%X\r\n", n), MSG_NOSIGNAL);
+    if ( send(c, body + sent, (size_t)n, MSG_NOSIGNAL) <= 0 ) return;
+    if ( chunked ) send(c, "\r\n", 2, MSG_NOSIGNAL);
+    sent += n;
+  }
+  // a premature last chunk looks like a complete body
+  if ( chunked && (stop == len || early_end) ) send(c, "0\r\n\r\n", 5, MSG_NOSIGNAL);
+}
+
+static void serve_file(int c, const char *req) {
+  const char *range = strstr(req, "Range: bytes=");
+  int partial = range && !ignore_range;
+  int from = partial ? atoi(range + 13) : 0;
+  int len = IMAGE_SIZE - from;
+  int stop = len;
+  char head[256];
+  int n, i;
+
+  if ( chunked ) {
+    n = sprintf(head, "HTTP/1.1 %s\r\nTransfer-Encoding: chunked\r\n\r\n",
+                partial ? "206 Partial Content" : "200 OK");
+  } else if ( partial ) {
+    n = sprintf(head, "HTTP/1.1 206 Partial Content\r\nContent-Length: %d\r\n"
+                "Content-Range: bytes %d-%d/%d\r\n\r\n", len, from, IMAGE_SIZE - 1, IMAGE_SIZE);
+  } else {
+    n = sprintf(head, "HTTP/1.1 200 OK\r\nContent-Length: %d\r\n\r\n", len);
+  }
+  send(c, head, (size_t)n, 0);
+
+  if ( always_drop ) stop = 0;
+  for ( i = 0; i < drops; i++ ) {
+    if ( drop_at[i] > from && drop_at[i] < from + len ) {
+      stop = drop_at[i] - from;
+      drop_at[i] = -1;
+      break;
+    }
+  }
+  unsigned char *body = (unsigned char *)malloc((size_t)len);
+  memcpy(body, image + from, (size_t)len);
+  if ( corrupt_at >= from && corrupt_at < from + len ) body[corrupt_at - from] ^= 0x5a;
+  send_body(c, body, len, stop);
+  free(body);
+}
+
+// transaction updates are logged by their last path element
+static void serve_trans(int c, const char *req) {
+  const char *sp = strchr(req, ' ');
+  const char *end = sp ? strchr(sp + 1, ' ') : NULL;
+  if ( end ) {
+    const char *last = end;
+    while ( last > sp && last[-1] != '/' ) last--;
+    strncat(trans_log, last, (size_t)(end - last));
+    strcat(trans_log, " ");
+  }
+  send(c, "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\n{}", 40, 0);
+}
+
+static void *server(void *arg) {
+  int s = *(int *)arg;
+  for (;;) {
+    char req[4096];
+    int n = 0;
+    int c = accept(s, NULL, NULL);
+    while ( n < (int)sizeof(req) - 1 ) {
+      int r = (int)recv(c, req + n, sizeof(req) - 1 - (size_t)n, 0);
+      if ( r <= 0 ) break;
+      n += r;
+      req[n] = 0;
+      if ( strstr(req, "\r\n\r\n") ) break;
+    }
+    if ( strstr(req, "/file") ) serve_file(c, req);
+    else serve_trans(c, req);
+    shutdown(c, SHUT_RDWR);
+    close(c);
+  }
+  return NULL;
+}
+
+static void start_server(void) {
+  static int s;
+  int one = 1;
+  struct sockaddr_in addr;
+  pthread_t th;
+
+  s = socket(AF_INET, SOCK_STREAM, 0);
+  setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(ARROW_PORT);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if ( bind(s, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(s, 4) < 0 ) {
+    perror("server");
+    exit(2);
+  }
+  pthread_create(&th, NULL, server, &s);
+}
+
+/* deliver a DeviceSoftwareRelease event, returns 1 when the image is staged */
+static int release(const char *to) {
+  char md5[16], hex[33], ev[512];
+  int i, ret, staged;
+  JsonNode *params;
+
+  md5sum(md5, (const char *)image, IMAGE_SIZE);
+  for ( i = 0; i < 16; i++ ) sprintf(hex + 2 * i, "%02x", (unsigned char)md5[i]);
+  sprintf(ev, "{\"softwareReleaseTransHid\":\"T1\",\"tempToken\":\"tok\","
+              "\"fromSoftwareVersion\":\"1.0\",\"toSoftwareVersion\":\"%s\","
+              "\"md5checksum\":\"%s\"}", to, hex);
+  params = json_decode(ev);
+  trans_log[0] = 0;
+  reboots = 0;
+  meta_valid = 0;
+  memset(slot, 0, sizeof(slot));
+  memset(erased, 0, sizeof(erased));
+
+  ret = ev_DeviceSoftwareRelease(NULL, params);
+  json_delete(params);
+
+  staged = ret == 0 && meta_valid && meta.state == ota_staged &&
+           meta.size == IMAGE_SIZE && !memcmp(slot, image, IMAGE_SIZE) &&
+           !memcmp(meta.md5, md5, sizeof(md5));
+  // only a staged image restarts the device, a failure is reported
+  CHECK(reboots == staged);
+  CHECK(staged || strstr(trans_log, "failed"));
+  return staged;
+}
+
+static const char *confirm(void) {
+  trans_log[0] = 0;
+  arrow_software_release_confirm();
+  return trans_log;
+}
+
+int main(void) {
+  int i;
+
+  srand(7);
+  for ( i = 0; i < IMAGE_SIZE; i++ ) image[i] = (unsigned char)rand();
+  start_server();
+
+  CHECK(release("1.1"));
+
+  drops = 3;
+  drop_at[0] = 12345;
+  drop_at[1] = 50000;
+  drop_at[2] = 99999;
+  CHECK(release("1.1"));
+
+  // the server answers 200 to the Range request, the download restarts
+  drops = 1;
+  drop_at[0] = 70001;
+  ignore_range = 1;
+  CHECK(release("1.1"));
+  ignore_range = 0;
+
+  chunked = 1;
+  CHECK(release("1.1"));
+  drops = 2;
+  drop_at[0] = 30000;
+  drop_at[1] = 99999;
+  CHECK(release("1.1"));
+  // without a length only the checksum shows the body was cut short
+  drops = 1;
+  drop_at[0] = 40000;
+  early_end = 1;
+  CHECK(release("1.1"));
+  early_end = 0;
+  corrupt_at = 4242;
+  CHECK(!release("1.1"));
+  chunked = 0;
+  CHECK(!release("1.1"));
+  corrupt_at = -1;
+
+  always_drop = 1;
+  CHECK(!release("1.1"));
+  always_drop = 0;
+
+  // no bootloader installed the image, the old firmware starts again
+  CHECK(release("1.1"));
+  CHECK(arrow_software_release_boot() == 0 && meta.state == ota_staged);
+  CHECK(strstr(confirm(), "failed") && meta.state == ota_empty);
+
+  // the bootloader flags the image it installed
+  CHECK(release("1.1"));
+  meta.state = ota_installed;
+  CHECK(arrow_software_release_boot() == 0 && meta.state == ota_trial);
+  CHECK(strstr(confirm(), "succeeded") && meta.state == ota_confirmed);
+
+  // the running firmware is the staged version
+  CHECK(release(GATEWAY_SOFTWARE_VERSION));
+  CHECK(arrow_software_release_boot() == 0 && meta.state == ota_trial);
+  CHECK(strstr(confirm(), "succeeded") && meta.state == ota_confirmed);
+
+  // the new image never reaches the cloud
+  CHECK(release("1.1"));
+  meta.state = ota_installed;
+  for ( i = 0; i < ARROW_OTA_MAX_BOOTS; i++ ) CHECK(arrow_software_release_boot() == 0);
+  CHECK(arrow_software_release_boot() < 0 && meta.state == ota_rollback);
+  CHECK(strstr(confirm(), "failed") && meta.state == ota_empty);
+
+  printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
@@ -50,6 +50,7 @@
 #include <radio/adi_ble_radio.h>
 #include <common/adi_error_handling.h>
 #include <framework/noos/adi_ble_noos.h>
+#include <common/adi_trace.h>
 
 /*
                     Baudrate divider for PCLK-26000000
@@ -112,12 +113,24 @@
 #define PERIPHERAL_MODE      ((ADI_BLE_GAP_MODE)(ADI_BLE_GAP_MODE_CONNECTABLE |  \
 		ADI_BLE_GAP_MODE_DISCOVERABLE))
 
+/* UART command sending the trace buffer, decoded by scripts/trace_decode.py */
+#define UART_CMD_TRACE_DUMP 't'
+
+/* Application events in the trace buffer, module ADI_TRACE_MODULE_APP */
+enum app_trace_id {
+	APP_TRACE_ADXL372_INT = 1,
+	APP_TRACE_BURST = 2,
+	APP_TRACE_BLE_SEND_ERROR = 3,
+	APP_TRACE_GATEWAY_BATCH = 4,
+};
+
 extern ADI_BLE_GAP_MODE   gGapMode;
 
 void UART_Init(void);
 int UART_WriteChar(char data);
 int UART_WriteString(char *string);
 void AppPrintf(const char *fmt, ...);
+bool UART_ProcessCmd(void);
 void configure_ble_radio(void);
 void SetAdvertisingMode(void);
 
@@ -159,6 +159,10 @@
 #define ADXL372_FIFO_CTL_SAMPLES_MSK		BIT(1)
 #define ADXL372_FIFO_CTL_SAMPLES_MODE(x)	(((x) > 0xFF) ? 1 : 0)
 
+/* ADXL372_FIFO_DATA */
+#define ADXL372_FIFO_SIZE			512
+#define ADXL372_FIFO_SERIES_START(x)		((x) & 0x1)
+
 /* ADXL372_STATUS_1 */
 #define ADXL372_STATUS_1_DATA_RDY(x)		(((x) >> 0) & 0x1)
 #define ADXL372_STATUS_1_FIFO_RDY(x)		(((x) >> 1) & 0x1)
@@ -334,6 +338,20 @@ typedef struct {
 	uint16_t z;
 } adxl372_xyz_accel_data;
 
+/*
+ * Ring of unpacked sample sets filled by adxl372_fifo_drain(). The storage is
+ * provided by the caller, size must be a power of two. head and tail are free
+ * running indexes.
+ */
+typedef struct {
+	adxl372_xyz_accel_data	*buf;
+	uint16_t		size;
+	uint16_t		head;
+	uint16_t		tail;
+	uint32_t		overruns;
+	uint32_t		resyncs;
+} adxl372_sample_ring;
+
 typedef struct {
 	bool data_rdy;
 	bool fifo_rdy;
@@ -437,6 +455,22 @@ int32_t adxl372_get_fifo_xyz_data(adxl372_dev *dev,
 int32_t adxl372_service_fifo_ev(adxl372_dev *dev,
 				adxl372_xyz_accel_data *fifo_data,
 				uint16_t *fifo_entries);
+uint16_t adxl372_fifo_unpack(adxl372_fifo_format format,
+			     const uint8_t **raw,
+			     uint16_t *words,
+			     adxl372_xyz_accel_data *samples,
+			     uint16_t max_sets,
+			     uint32_t *resyncs);
+int32_t adxl372_ring_init(adxl372_sample_ring *ring,
+			  adxl372_xyz_accel_data *buf,
+			  uint16_t size);
+uint16_t adxl372_ring_count(adxl372_sample_ring *ring);
+uint16_t adxl372_ring_read(adxl372_sample_ring *ring,
+			   adxl372_xyz_accel_data *samples,
+			   uint16_t cnt);
+void adxl372_ring_flush(adxl372_sample_ring *ring);
+int32_t adxl372_fifo_drain(adxl372_dev *dev,
+			   adxl372_sample_ring *ring);
 int32_t adxl372_get_highest_peak_data(adxl372_dev *dev,
 				      adxl372_xyz_accel_data *max_peak);
 int32_t adxl372_get_accel_data(adxl372_dev *dev,
@@ -0,0 +1,83 @@
+/***************************************************************************//**
+ *   @file   vib_features.h
+ *   @brief  Header file for the vibration feature extraction.
+********************************************************************************
+ * Copyright 2018(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef VIB_FEATURES_H_
+#define VIB_FEATURES_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define VIB_AXES	3
+#define VIB_FFT_LOG2	7
+#define VIB_FFT_SIZE	(1 << VIB_FFT_LOG2)
+#define VIB_BANDS	4
+#define VIB_LSB_G	0.1f	/* 100 mg/LSB */
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+typedef struct {
+	float rms;		/* RMS of the AC part [G] */
+	float peak;		/* Largest deviation from the mean [G] */
+	float crest;		/* Peak / RMS */
+	float kurtosis;		/* 3 for gaussian noise, higher for impacts */
+	float dominant_freq;	/* Frequency of the largest spectral line [Hz] */
+} vib_axis_features;
+
+typedef struct {
+	vib_axis_features axis[VIB_AXES];
+	/* Energy of the three axes in equal bands from 0 to ODR / 2 [G^2] */
+	float band_energy[VIB_BANDS];
+	/* Number of XYZ samples used for the time domain features */
+	uint16_t samples;
+	/* 1 if the spectral features were computed */
+	uint8_t spectrum;
+} vib_features;
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+int32_t vib_features_compute(const uint16_t *data, uint16_t count,
+			     uint32_t odr_hz, vib_features *feat);
+
+#endif /* VIB_FEATURES_H_ */
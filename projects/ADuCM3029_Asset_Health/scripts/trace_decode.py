@@ -0,0 +1,146 @@
+"""Decode the binary trace frames sent by the 't' UART command.
+
+Frames are read either from a serial port or from a file holding a
+recorded capture, and printed as a timeline, one line per record. Event
+names are taken from the enums of the Wi-Fi, BLE and application headers.
+
+Usage:
+    python trace_decode.py COM5          (sends 't' and decodes the answer)
+    python trace_decode.py capture.bin
+"""
+
+import os
+import re
+import struct
+import sys
+
+SYNC = b'TR'
+HDR = struct.Struct('<BBHHIIII')   # version, record size, count, buffer size,
+                                   # first seq, logged, lost, tick Hz
+REC = struct.Struct('<IHBBI')      # timestamp, event, module, seq, data
+CSUM = struct.Struct('<H')
+VERSION = 1
+MODULE_LOST = 0xFF
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+PACKS = os.path.join(HERE, '..', '..', '..', 'cmsis-packs')
+HEADERS = {
+    0: [os.path.join(HERE, '..', 'include', 'Communication.h')],
+    1: [os.path.join(PACKS, 'ADI-WifiSoftware', 'Include', 'communication',
+                     'wifi', 'radio', 'adi_wifi_logevent.h')],
+    2: [os.path.join(PACKS, 'ADI-BleSoftware', 'Include', 'communication',
+                     'ble', 'radio', 'adi_ble_logevent.h')],
+}
+MODULES = {0: 'APP', 1: 'WIFI', 2: 'BLE'}
+
+
+def enum_names(path):
+    """Return {value: name} for the enum members declared in a C header."""
+    names = {}
+    try:
+        with open(path) as header:
+            text = header.read()
+    except IOError:
+        return names
+    text = re.sub(r'/\*.*?\*/|//[^\n]*', '', text, flags=re.S)
+    for body in re.findall(r'enum\s*\w*\s*\{(.*?)\}', text, flags=re.S):
+        value = -1
+        for member in body.split(','):
+            match = re.match(r'\s*(\w+)\s*(?:=\s*([^,]+))?', member)
+            if not match or not match.group(1):
+                continue
+            if match.group(2):
+                value = int(match.group(2).strip().rstrip('uUlL'), 0)
+            else:
+                value += 1
+            names.setdefault(value, match.group(1))
+    return names
+
+
+def decode_frames(data):
+    """Yield (header, records, end) for every valid frame in data."""
+    pos = data.find(SYNC)
+    while pos >= 0 and pos + len(SYNC) + HDR.size <= len(data):
+        header = HDR.unpack_from(data, pos + len(SYNC))
+        version, rec_size, count = header[:3]
+        if version != VERSION or rec_size != REC.size:
+            pos = data.find(SYNC, pos + 1)
+            continue
+        end = pos + len(SYNC) + HDR.size + count * REC.size + CSUM.size
+        if end > len(data):
+            break
+        body = data[pos + len(SYNC):end - CSUM.size]
+        (csum,) = CSUM.unpack_from(data, end - CSUM.size)
+        if sum(body) & 0xFFFF != csum:
+            pos = data.find(SYNC, pos + 1)
+            continue
+        off = pos + len(SYNC) + HDR.size
+        records = [REC.unpack_from(data, off + i * REC.size)
+                   for i in range(count)]
+        yield header, records, end
+        pos = data.find(SYNC, end)
+
+
+def print_frames(data, names):
+    """Print all frames in data as a timeline and return the unused tail."""
+    consumed = 0
+    for header, records, end in decode_frames(data):
+        first, logged, lost, tick_hz = header[4:]
+        print('Trace: %d records from #%d, %d logged, %d lost' %
+              (len(records), first, logged, lost))
+        print('Seq, Time [s], Delta [ms], Module, Event, Data')
+        start = prev = None
+        wraps = 0
+        for seq, (stamp, event, module, rec_seq, value) in enumerate(records,
+                                                                    first):
+            # the low byte of the sequence number is stored in each record
+            if module == MODULE_LOST or rec_seq != seq & 0xFF:
+                print('%d, -, -, LOST, -, -' % seq)
+                continue
+            if prev is not None and stamp < prev:
+                wraps += 1
+            prev = stamp
+            ticks = stamp + (wraps << 32)
+            if start is None:
+                start = last = ticks
+            name = names.get(module, {}).get(event, '0x%04X' % event)
+            print('%d, %.3f, %.1f, %s, %s, 0x%08X' %
+                  (seq, float(ticks - start) / tick_hz,
+                   1000.0 * (ticks - last) / tick_hz,
+                   MODULES.get(module, str(module)), name, value))
+            last = ticks
+        consumed = end
+    return data[consumed:]
+
+
+def main():
+    """Decode a capture file or dump the trace buffer over a serial port."""
+    if len(sys.argv) != 2:
+        print(__doc__)
+        sys.exit(1)
+
+    names = {}
+    for module, paths in HEADERS.items():
+        names[module] = {}
+        for path in paths:
+            names[module].update(enum_names(path))
+
+    if os.path.isfile(sys.argv[1]):
+        with open(sys.argv[1], 'rb') as capture:
+            print_frames(capture.read(), names)
+        return
+
+    import serial
+    port = serial.Serial(sys.argv[1], 9600, timeout=2)
+    port.write(b't')
+    data = b''
+    while True:
+        chunk = port.read(1024)
+        if not chunk:
+            break
+        data += chunk
+    print_frames(data, names)
+
+
+if __name__ == '__main__':
+    main()
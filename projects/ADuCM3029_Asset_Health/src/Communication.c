@@ -59,6 +59,9 @@ uint8_t UartDeviceMem[ADI_UART_MEMORY_SIZE] __attribute__ ((aligned (4)));
 
 ADI_BLE_GAP_MODE   gGapMode;
 
+/* Receive buffer of the one character UART commands */
+static uint8_t u8UartCmd;
+
 /************************* Functions Definitions ******************************/
 void adi_DataExchange_Callback(void *pParam, uint32_t Event, void *pData);
 
@@ -87,6 +90,11 @@ void UART_Init()
 	if((eUartResult = adi_uart_ConfigBaudRate(hUartDevice, UART_DIV_C, UART_DIV_M,
 			  UART_DIV_N, UART_OSR)) != ADI_UART_SUCCESS) // 9600 baud rate
 		DEBUG_MESSAGE("UART device baud rate configuration failed");
+
+	/* Wait for the first command character */
+	if((eUartResult = adi_uart_SubmitRxBuffer(hUartDevice, &u8UartCmd, 1u,
+			  false)) != ADI_UART_SUCCESS)
+		DEBUG_MESSAGE("UART receive buffer submit failed");
 }
 
 /**
@@ -153,6 +161,54 @@ void AppPrintf(const char *fmt, ...)
 	UART_WriteString(buff);
 }
 
+/**
+  @brief Sends the trace frame to UART.
+
+  @param pData - frame bytes.
+
+  @param nSize - number of bytes.
+
+  @return none
+
+**/
+static void UART_WriteTrace(const uint8_t *pData, uint32_t nSize)
+{
+	uint32_t u32HwError;
+
+	adi_uart_Write(hUartDevice, (void *)pData, nSize, false, &u32HwError);
+}
+
+/**
+  @brief Handles a command character received over UART.
+
+  UART_CMD_TRACE_DUMP sends the records logged since the last dump as a
+  binary frame, see adi_trace_Dump(). The UART is polled, so in low power
+  mode the command is answered when the next accelerometer burst wakes the
+  core.
+
+  @return true if a command was received.
+
+**/
+bool UART_ProcessCmd(void)
+{
+	bool     bAvailable = false;
+	void     *pBuffer;
+	uint32_t u32HwError;
+
+	if((adi_uart_IsRxBufferAvailable(hUartDevice, &bAvailable) != ADI_UART_SUCCESS)
+	    || !bAvailable)
+		return false;
+
+	adi_uart_GetRxBuffer(hUartDevice, &pBuffer, &u32HwError);
+
+	if(u8UartCmd == UART_CMD_TRACE_DUMP)
+		adi_trace_Dump(UART_WriteTrace);
+
+	adi_uart_SubmitRxBuffer(hUartDevice, &u8UartCmd, 1u, false);
+
+	return true;
+}
+
 /**
  * @brief Configure the BLE radio.
  * @return None.
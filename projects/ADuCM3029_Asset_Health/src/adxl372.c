@@ -48,6 +48,12 @@
 #include "platform_drivers.h"
 #include "adxl372.h"
 
+/******************************************************************************/
+/*************************** Variables Definitions ****************************/
+/******************************************************************************/
+/* Command byte followed by a full FIFO worth of data */
+static uint8_t adxl372_xfer_buf[1 + ADXL372_FIFO_SIZE * 2];
+
 /******************************************************************************/
 /************************** Functions Implementation **************************/
 /******************************************************************************/
@@ -88,17 +94,17 @@ int32_t adxl372_spi_reg_read_multiple(adxl372_dev *dev,
 				      uint8_t *reg_data,
 				      uint16_t count)
 {
-	uint8_t buf[1024];
-	uint16_t i;
 	int32_t ret;
 
-	buf[0] = ADXL372_REG_READ(reg_addr);
-	memset(&buf[1], 0x00, count);
+	if (count > ADXL372_FIFO_SIZE * 2)
+		return -1;
 
-	ret = spi_write_and_read(dev->spi_desc, buf, count + 1);
+	adxl372_xfer_buf[0] = ADXL372_REG_READ(reg_addr);
+	memset(&adxl372_xfer_buf[1], 0x00, count);
 
-	for (i = 0; i <= count; i++)
-		reg_data[i] = buf[i+1];
+	ret = spi_write_and_read(dev->spi_desc, adxl372_xfer_buf, count + 1);
+
+	memcpy(reg_data, &adxl372_xfer_buf[1], count);
 
 	return ret;
 }
@@ -547,6 +553,20 @@ int32_t adxl372_configure_fifo(adxl372_dev *dev,
 	return ret;
 }
 
+/**
+ * Get the axes stored in the FIFO for a given format.
+ * @param format - FIFO Format.
+ * @return Mask of the stored axes, bit 0 = X, bit 1 = Y, bit 2 = Z.
+ */
+static uint8_t adxl372_fifo_axes(adxl372_fifo_format format)
+{
+	/* X, Y and Z are bits 0 to 2 of the format, except for XYZ and peak */
+	if (format == ADXL372_XYZ_FIFO || format == ADXL372_XYZ_PEAK_FIFO)
+		return 0x7;
+
+	return format & 0x7;
+}
+
 /**
  * Retrieve data stored in FIFO. Can be used in polling mode,
  * but works best when interrupts are used
@@ -563,6 +583,7 @@ int32_t adxl372_service_fifo_ev(adxl372_dev *dev,
 				uint16_t *fifo_entries)
 {
 	uint8_t status1, status2;
+	uint8_t axes, n;
 	int32_t ret;
 
 	ret = adxl372_get_status(dev, &status1, &status2, fifo_entries);
@@ -577,13 +598,19 @@ int32_t adxl372_service_fifo_ev(adxl372_dev *dev,
 	if (dev->fifo_config.fifo_mode != ADXL372_FIFO_BYPASSED) {
 		if ((ADXL372_STATUS_1_FIFO_RDY(status1)) ||
 		    (ADXL372_STATUS_1_FIFO_FULL(status1))) {
+			axes = adxl372_fifo_axes(dev->fifo_config.fifo_format);
+			n = (axes & 1) + ((axes >> 1) & 1) + (axes >> 2);
 			/*
 			 * When reading data from multiple axes from the FIFO,
 			 * to ensure that data is not overwritten and stored out
 			 * of order, at least one sample set must be left in the
 			 * FIFO after every read.
 			 */
-			*fifo_entries -= 3;
+			if (*fifo_entries < 2 * n) {
+				*fifo_entries = 0;
+				return 0;
+			}
+			*fifo_entries = (*fifo_entries / n - 1) * n;
 			ret = adxl372_get_fifo_xyz_data(dev, fifo_data,
 							*fifo_entries);
 		}
@@ -592,6 +619,91 @@ int32_t adxl372_service_fifo_ev(adxl372_dev *dev,
 	return ret;
 }
 
+/**
+ * Unpack raw FIFO words into sample sets.
+ * Each FIFO word holds 12 bits of data, MSB first, and has bit 0 set on the
+ * first axis of a set. A set is only accepted when the tags of all its words
+ * are in order, otherwise words are skipped until the next start of a set,
+ * so the unpacker resynchronises after a FIFO overrun or a partial read.
+ * Axes not stored in the FIFO are returned as 0.
+ * @param format - FIFO Format the words were captured with.
+ * @param raw - pointer to the raw data, advanced past the consumed words.
+ * @param words - number of raw words, decremented by the consumed words.
+ * @param samples - array where the sample sets will be stored.
+ * @param max_sets - maximum number of sets to store.
+ * @param resyncs - incremented each time the unpacker lost the set alignment.
+ * @return Number of sample sets stored.
+ */
+uint16_t adxl372_fifo_unpack(adxl372_fifo_format format,
+			     const uint8_t **raw,
+			     uint16_t *words,
+			     adxl372_xyz_accel_data *samples,
+			     uint16_t max_sets,
+			     uint32_t *resyncs)
+{
+	const uint8_t *p = *raw;
+	uint16_t left = *words;
+	uint16_t sets = 0;
+	const adxl372_xyz_accel_data zero = {0, 0, 0};
+	uint16_t *val;
+	uint8_t slot[3];
+	uint8_t axes, n, k, bad;
+	bool lost = false;
+
+	axes = adxl372_fifo_axes(format);
+	n = 0;
+	for (k = 0; k < 3; k++)
+		if (axes & (1 << k))
+			slot[n++] = k;
+
+	while (left >= n && sets < max_sets) {
+		if (n == 3) {
+			/* Three axis formats, straight line */
+			bad = ~p[1] | p[3] | p[5];
+			if (!ADXL372_FIFO_SERIES_START(bad)) {
+				samples->x = (p[0] << 4) | (p[1] >> 4);
+				samples->y = (p[2] << 4) | (p[3] >> 4);
+				samples->z = (p[4] << 4) | (p[5] >> 4);
+				samples++;
+				sets++;
+				p += 6;
+				left -= 3;
+				lost = false;
+				continue;
+			}
+		} else {
+			bad = ~p[1];
+			for (k = 1; k < n; k++)
+				bad |= p[2 * k + 1];
+			if (!ADXL372_FIFO_SERIES_START(bad)) {
+				*samples = zero;
+				val = &samples->x;
+				for (k = 0; k < n; k++)
+					val[slot[k]] = (p[2 * k] << 4) |
+						       (p[2 * k + 1] >> 4);
+				samples++;
+				sets++;
+				p += 2 * n;
+				left -= n;
+				lost = false;
+				continue;
+			}
+		}
+
+		/* Out of order, drop one word and look for the next set */
+		if (!lost && resyncs)
+			(*resyncs)++;
+		lost = true;
+		p += 2;
+		left--;
+	}
+
+	*raw = p;
+	*words = left;
+
+	return sets;
+}
+
 /**
  * Get the data stored in FIFO.
  * @param dev - The device structure.
@@ -603,32 +715,170 @@ int32_t adxl372_get_fifo_xyz_data(adxl372_dev *dev,
 				  adxl372_xyz_accel_data *samples,
 				  uint16_t cnt)
 {
-	uint8_t buf[1024];
-	uint16_t i;
+	const uint8_t *raw = &adxl372_xfer_buf[1];
+	uint8_t axes, n;
 	int32_t ret;
 
-
-	if (cnt > 512)
+	if (cnt > ADXL372_FIFO_SIZE)
 		return -1;
+
+	axes = adxl372_fifo_axes(dev->fifo_config.fifo_format);
+	n = (axes & 1) + ((axes >> 1) & 1) + (axes >> 2);
+
+	adxl372_xfer_buf[0] = ADXL372_REG_READ(ADXL372_FIFO_DATA);
+	memset(&adxl372_xfer_buf[1], 0x00, cnt * 2);
+
 	/*
 	 * The FIFO can hold up to 512 samples.
 	 * Each sample is 2 bytes, that's why we read (cnt * 2) bytes
 	 */
-	ret = adxl372_spi_reg_read_multiple(dev,
-					    ADXL372_FIFO_DATA,
-					    buf,
-					    cnt * 2);
-
-	for (i = 0; i < cnt * 2; i += 6) {
-		samples->x = ((buf[i] << 4) | (buf[i+1] >> 4));
-		samples->y = ((buf[i+2] << 4) | (buf[i+3] >> 4));
-		samples->z = ((buf[i+4] << 4) | (buf[i+5] >> 4));
-		samples++;
-	}
+	ret = spi_write_and_read(dev->spi_desc, adxl372_xfer_buf, cnt * 2 + 1);
+	if (ret)
+		return -1;
+
+	/* The caller sized samples for cnt words, at most cnt / n sets */
+	adxl372_fifo_unpack(dev->fifo_config.fifo_format, &raw, &cnt,
+			    samples, cnt / n, NULL);
 
 	return ret;
 }
 
+/**
+ * Initialize a sample ring.
+ * @param ring - The ring structure.
+ * @param buf - storage for the ring, size sample sets.
+ * @param size - number of sample sets, must be a power of two.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t adxl372_ring_init(adxl372_sample_ring *ring,
+			  adxl372_xyz_accel_data *buf,
+			  uint16_t size)
+{
+	if (!buf || !size || (size & (size - 1)) || size > 0x8000)
+		return -1;
+
+	ring->buf = buf;
+	ring->size = size;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->overruns = 0;
+	ring->resyncs = 0;
+
+	return 0;
+}
+
+/**
+ * Get the number of sample sets waiting in the ring.
+ * @param ring - The ring structure.
+ * @return Number of sample sets.
+ */
+uint16_t adxl372_ring_count(adxl372_sample_ring *ring)
+{
+	return (uint16_t)(ring->head - ring->tail);
+}
+
+/**
+ * Take the oldest sample sets out of the ring.
+ * @param ring - The ring structure.
+ * @param samples - array where the sample sets will be copied.
+ * @param cnt - maximum number of sample sets to copy.
+ * @return Number of sample sets copied.
+ */
+uint16_t adxl372_ring_read(adxl372_sample_ring *ring,
+			   adxl372_xyz_accel_data *samples,
+			   uint16_t cnt)
+{
+	uint16_t idx, chunk, done = 0;
+
+	if (cnt > adxl372_ring_count(ring))
+		cnt = adxl372_ring_count(ring);
+
+	while (done < cnt) {
+		idx = ring->tail & (ring->size - 1);
+		chunk = ring->size - idx;
+		if (chunk > cnt - done)
+			chunk = cnt - done;
+		memcpy(&samples[done], &ring->buf[idx], chunk * sizeof(*samples));
+		ring->tail += chunk;
+		done += chunk;
+	}
+
+	return done;
+}
+
+/**
+ * Drop all sample sets waiting in the ring.
+ * @param ring - The ring structure.
+ * @return None.
+ */
+void adxl372_ring_flush(adxl372_sample_ring *ring)
+{
+	ring->tail = ring->head;
+}
+
+/**
+ * Move the FIFO content into a sample ring. Meant to be called when the FIFO
+ * watermark (FIFO_FULL) interrupt fires. The data is read with a single SPI
+ * transfer and unpacked straight into the ring, one sample set is left in the
+ * FIFO as required by the datasheet. When the ring is full the remaining data
+ * stays in the FIFO.
+ * @param dev - The device structure.
+ * @param ring - The ring structure.
+ * @return Number of sample sets added to the ring, negative error code
+ *	   otherwise.
+ */
+int32_t adxl372_fifo_drain(adxl372_dev *dev,
+			   adxl372_sample_ring *ring)
+{
+	const uint8_t *raw = &adxl372_xfer_buf[1];
+	uint8_t status1, status2;
+	uint16_t entries, space, idx, first;
+	uint16_t sets;
+	uint8_t axes, n;
+	int32_t ret;
+
+	ret = adxl372_get_status(dev, &status1, &status2, &entries);
+	if (ret)
+		return -1;
+
+	if (ADXL372_STATUS_1_FIFO_OVR(status1))
+		ring->overruns++;
+
+	axes = adxl372_fifo_axes(dev->fifo_config.fifo_format);
+	n = (axes & 1) + ((axes >> 1) & 1) + (axes >> 2);
+	if (entries < 2 * n)
+		return 0;
+	entries = (entries / n - 1) * n;
+
+	space = ring->size - adxl372_ring_count(ring);
+	if (entries > space * n)
+		entries = space * n;
+	if (!entries)
+		return 0;
+
+	adxl372_xfer_buf[0] = ADXL372_REG_READ(ADXL372_FIFO_DATA);
+	memset(&adxl372_xfer_buf[1], 0x00, entries * 2);
+	ret = spi_write_and_read(dev->spi_desc, adxl372_xfer_buf,
+				 entries * 2 + 1);
+	if (ret)
+		return -1;
+
+	/* Unpack up to the end of the ring, then wrap around */
+	idx = ring->head & (ring->size - 1);
+	first = ring->size - idx;
+	if (first > space)
+		first = space;
+	sets = adxl372_fifo_unpack(dev->fifo_config.fifo_format, &raw, &entries,
+				   &ring->buf[idx], first, &ring->resyncs);
+	if (sets == first && entries)
+		sets += adxl372_fifo_unpack(dev->fifo_config.fifo_format, &raw,
+					    &entries, ring->buf, space - first,
+					    &ring->resyncs);
+	ring->head += sets;
+
+	return sets;
+}
+
 /**
  * Retrieve the highest magnitude (x, y, z) sample recorded since the last
  * read of the MAXPEAK registers
@@ -0,0 +1,156 @@
+/***************************************************************************//**
+ *   @file   ble_gateway.c
+ *   @brief  BLE observer gateway for the sensor beacons of other boards.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <string.h>
+#include <common/adi_timestamp.h>
+#include "common.h"
+
+#include "Communication.h"
+#include "ble_gateway.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief BLE callback of the gateway, feeds the advertising reports to the
+ *        observer table.
+ * @param pParam - pointer to parameters.
+ * @param Event  - event that is serviced by the callback.
+ * @param pData  - data pointer.
+ * @return None.
+ */
+static void gateway_callback(void *pParam, uint32_t Event, void *pData)
+{
+	ADI_BLER_OBSERVER_DATA obs;
+	ADI_BEACON_ADDR addr;
+
+	if (Event != GAP_EVENT_OBS_MODE_DATA)
+		return;
+
+	/* The report is only valid inside the callback */
+	adi_ble_GetObserverData(&obs);
+	addr.nAddrType = obs.sRemoteAddress.nAddrType;
+	memcpy(addr.aBD_ADDR, obs.sRemoteAddress.aBD_ADDR, sizeof(addr.aBD_ADDR));
+
+	adi_observer_Report(&addr, obs.nRssi, obs.sBuffer.pData,
+			    obs.sBuffer.nDataLen, adi_GetRTCTime());
+}
+
+/**
+ * @brief Prints the readings of one broadcaster over UART.
+ * @param reading - readings averaged over the batch.
+ * @param param - not used.
+ * @return None.
+ */
+void gateway_uart_forward(const ADI_OBSERVER_READING *reading, void *param)
+{
+	uint8_t i;
+
+	AppPrintf("%02X:%02X:%02X:%02X:%02X:%02X, %d dBm, seq %u, %u frames, %u missed",
+		  reading->sAddr.aBD_ADDR[5], reading->sAddr.aBD_ADDR[4],
+		  reading->sAddr.aBD_ADDR[3], reading->sAddr.aBD_ADDR[2],
+		  reading->sAddr.aBD_ADDR[1], reading->sAddr.aBD_ADDR[0],
+		  reading->nRssi, reading->nSeq, reading->nFrames,
+		  reading->nMissed);
+	for (i = 0; i < reading->nNumValues; i++)
+		AppPrintf(", %u=%d", reading->aValues[i].nType,
+			  reading->aValues[i].nValue);
+	AppPrintf("\n\r");
+}
+
+/**
+ * @brief Scans for sensor beacons and forwards them in batches.
+ *
+ * The radio observes without duplicate filtering, the repeats of an
+ * advertisement are dropped by the observer table but still feed the RSSI
+ * average. Every GATEWAY_BATCH_SEC the silent broadcasters are expired and
+ * the readings averaged since the previous batch are passed to forward, one
+ * call per broadcaster. Does not return.
+ *
+ * @param forward - function receiving the readings, e.g. gateway_uart_forward
+ *                  or a Wi-Fi publish.
+ * @param param - passed to forward.
+ * @return None.
+ */
+void gateway_run(ADI_OBSERVER_BATCH_FN forward, void *param)
+{
+	ADI_BLER_RESULT eResult;
+	ADI_BLER_CONFIG_SCAN scan = {GATEWAY_SCAN_INTERVAL, GATEWAY_SCAN_WINDOW};
+	ADI_OBSERVER_STATS stats;
+	uint32_t next, now, count;
+
+	adi_observer_Init();
+
+	eResult = adi_ble_Init(gateway_callback, NULL);
+	DEBUG_RESULT("Error initializing the radio.\r\n", eResult, ADI_BLER_SUCCESS);
+
+	eResult = adi_radio_RegisterDevice(ADI_BLE_ROLE_OBSERVER);
+	DEBUG_RESULT("Error registering the radio.\r\n", eResult, ADI_BLER_SUCCESS);
+
+	eResult = adi_radio_StartObsvProc(false, &scan);
+	DEBUG_RESULT("Error starting the observation.\r\n", eResult, ADI_BLER_SUCCESS);
+
+	AppPrintf("BLE gateway, batch every %u s\n\r", GATEWAY_BATCH_SEC);
+
+	next = adi_GetRTCTime() + GATEWAY_BATCH_SEC * ADI_CFG_OBSERVER_TICK_HZ;
+	while(1) {
+		eResult = adi_ble_DispatchEvents(GATEWAY_DISPATCH_MS);
+		DEBUG_RESULT("Error dispatching events to the callback.\r\n", eResult,
+			     ADI_BLER_SUCCESS);
+
+		/* Commands received over UART */
+		UART_ProcessCmd();
+
+		now = adi_GetRTCTime();
+		if ((int32_t)(now - next) < 0)
+			continue;
+		next += GATEWAY_BATCH_SEC * ADI_CFG_OBSERVER_TICK_HZ;
+
+		adi_observer_Expire(now);
+		adi_observer_GetStats(&stats);
+		AppPrintf("Batch: %u reports, %u frames, %u duplicates, %u foreign\n\r",
+			  stats.nReports, stats.nFrames, stats.nDuplicates,
+			  stats.nForeign);
+		count = adi_observer_Flush(forward, param, now);
+		adi_trace_Event(ADI_TRACE_MODULE_APP, APP_TRACE_GATEWAY_BATCH, count);
+	}
+}
@@ -49,20 +49,31 @@
 
 #include "Communication.h"
 #include "Timer.h"
+#include "vib_features.h"
+#include "ble_gateway.h"
 
 #include "math.h"
 
 /************************** Variable Definitions ******************************/
 #define PEAK_ACCELERATION
 
+/* Scan for the sensor beacons of other boards and forward them over UART */
+//#define BLE_GATEWAY
+
 #define GENERIC_SENSOR_TYPE 0
 #define CURRENT_DATE_TIME 0 //25 May 2017 12:34 PM
 
+#define ADXL372_ODR_HZ 6400
+#define FIFO_XYZ_SAMPLES 170
+#define SAMPLE_RING_SIZE 256
+
 uint8_t ui8Status2, ui8Status;
 bool boInterruptFlag = false;
 uint32_t LowPwrExitFlag;
 
 static bool               gConnected, reg_flag;
+/* Set when the central asks for the raw samples of the next burst */
+static bool               raw_request;
 ADI_BLER_CONN_INFO connInfo = {0};
 ADI_BLER_EVENT BleEvent;
 
@@ -103,6 +114,31 @@ struct FieldNamePacket name_pkt1_full = {0x05, 1, "Y axis [G]"};
 struct FieldNamePacket name_pkt2_full = {0x05, 2, "Z axis [G]"};
 struct DataPacket data_pkt_full = {0x06, 0, 0, 0, 0};
 
+/*Structures for the vibration features of each FIFO burst*/
+struct RegistrationPacket reg_pkt_feat[] = {
+	{0x08, 4, 5, "X features"},
+	{0x0C, 4, 5, "Y features"},
+	{0x10, 4, 5, "Z features"},
+	{0x14, 4, 5, "Band energy"},
+	{0x18, 3, 5, "Dominant freq"},
+};
+struct FieldNamePacket name_pkt_feat[][4] = {
+	{{0x09, 0, "X RMS [G]"}, {0x09, 1, "X peak [G]"},
+		{0x09, 2, "X crest"}, {0x09, 3, "X kurtosis"}},
+	{{0x0D, 0, "Y RMS [G]"}, {0x0D, 1, "Y peak [G]"},
+		{0x0D, 2, "Y crest"}, {0x0D, 3, "Y kurtosis"}},
+	{{0x11, 0, "Z RMS [G]"}, {0x11, 1, "Z peak [G]"},
+		{0x11, 2, "Z crest"}, {0x11, 3, "Z kurtosis"}},
+	{{0x15, 0, "0-800Hz [G2]"}, {0x15, 1, "800-1600Hz [G2]"},
+		{0x15, 2, "1600-2400Hz [G2]"}, {0x15, 3, "2400-3200Hz [G2]"}},
+	{{0x19, 0, "X [Hz]"}, {0x19, 1, "Y [Hz]"}, {0x19, 2, "Z [Hz]"}},
+};
+struct DataPacket data_pkt_feat = {0x00, 0, 0, 0, 0};
+
+/* Sample sets drained from the FIFO on the watermark interrupt */
+adxl372_xyz_accel_data sample_ring_buf[SAMPLE_RING_SIZE];
+adxl372_sample_ring sample_ring;
+
 adxl372_init_param adxl372_default_init_param = {
 	{GENERIC_SPI, 0, 10000000, SPI_MODE_0, ADI_SPI_CS1},    // spi_init
 	1, 2,                // gpio_int1, gpio_int2
@@ -117,9 +153,10 @@ adxl372_init_param adxl372_default_init_param = {
 	0,                // activity_time
 	0,                // inactivity_time
 	ADXL372_FILTER_SETTLE_16,    // filter_settle
-	{ADXL372_FIFO_OLD_SAVED, ADXL372_XYZ_FIFO, 20},    // fifo_config
+	/* One set more than a frame, adxl372_fifo_drain() leaves a set in the FIFO */
+	{ADXL372_FIFO_OLD_SAVED, ADXL372_XYZ_FIFO, (VIB_FFT_SIZE + 1) * VIB_AXES},    // fifo_config
 	/* data_rdy, fifo_rdy, fifo_full, fifo_ovr, inactivity, activity, awake, low_operation */
-	{false, false, false, false, false, false, true, true},
+	{false, false, true, false, false, false, false, true},
 	{false, false, false, false, false, false, false, false},
 	ADXL372_FULL_BW_MEASUREMENT,    // op_mode
 };
@@ -128,6 +165,9 @@ adxl372_init_param adxl372_default_init_param = {
 
 /************************* Functions Definitions ******************************/
 int16_t sign_extend16(uint16_t data);
+void send_fifo_data(adxl372_xyz_accel_data *fifo_data, uint16_t data_count);
+void register_features(void);
+void send_features(vib_features *feat);
 
 /**
  * @brief Interrupt pin event Callback function.
@@ -140,6 +180,7 @@ void pinIntCallback(void* pCBParam, uint32_t Port,  void* PinIntData)
 {
 	boInterruptFlag = true;
 	LowPwrExitFlag++;
+	adi_trace_Event(ADI_TRACE_MODULE_APP, APP_TRACE_ADXL372_INT, Port);
 }
 
 /**
@@ -171,6 +212,8 @@ void adi_DataExchange_Callback(void *pParam, uint32_t Event, void *pData)
 		break;
 	case DATA_EXCHANGE_RX_EVENT:
 		DEBUG_MESSAGE("Data received!\r\n");
+		/* Any data from the central requests one raw capture */
+		raw_request = true;
 		break;
 	case BLE_RADIO_ERROR_READING:
 		reg_flag = 0;
@@ -192,12 +235,17 @@ int main(int argc, char *argv[])
 	uint32_t u32RTCTime;
 
 	adxl372_dev *adxl372 = malloc(sizeof(adxl372_dev));
+#ifdef PEAK_ACCELERATION
 	adxl372_xyz_accel_data max_peak;
 
 	uint8_t status1;
 	uint8_t status2;
+#endif
 	uint16_t fifo_entries;
-	adxl372_xyz_accel_data fifo_samples[170];
+	adxl372_xyz_accel_data fifo_samples[FIFO_XYZ_SAMPLES];
+#ifndef PEAK_ACCELERATION
+	vib_features features;
+#endif
 
 	timer_start(); // Start timer
 
@@ -211,6 +259,9 @@ int main(int argc, char *argv[])
 	init_gpio();
 
 	adxl372_init(&adxl372, adxl372_default_init_param);
+#ifndef PEAK_ACCELERATION
+	adxl372_ring_init(&sample_ring, sample_ring_buf, SAMPLE_RING_SIZE);
+#endif
 	timer_sleep(16);
 	adxl372_set_op_mode(adxl372, ADXL372_INSTANT_ON);
 
@@ -221,6 +272,9 @@ int main(int argc, char *argv[])
 	/*Initialize RTC*/
 	adi_RTCInit();
 
+#ifdef BLE_GATEWAY
+	gateway_run(gateway_uart_forward, NULL);
+#endif
 	configure_ble_radio();
 
 	while(1) {
@@ -259,6 +313,8 @@ int main(int argc, char *argv[])
 				timer_sleep(10);
 				eResult = adi_radio_DE_SendData(connInfo.nConnHandle,
 								sizeof(name_pkt2_full),(uint8_t*)&name_pkt2_full);
+				timer_sleep(10);
+				register_features();
 #endif
 			}
 		} else {
@@ -268,14 +324,30 @@ int main(int argc, char *argv[])
 			}
 		}
 
+		/* Commands received over UART */
+		UART_ProcessCmd();
+
 		/* Measurement mode */
 		if (boInterruptFlag) {
 			/*Read data from accelerometer*/
+#ifdef PEAK_ACCELERATION
 			timer_sleep (100);
 			adxl372_get_status(adxl372, &status1, &status2, &fifo_entries);
 			adxl372_get_highest_peak_data(adxl372, &max_peak);
 
+			if (fifo_entries > FIFO_XYZ_SAMPLES * 3)
+				fifo_entries = FIFO_XYZ_SAMPLES * 3;
+
 			adxl372_get_fifo_xyz_data(adxl372, fifo_samples, fifo_entries);
+#else
+			/* The watermark interrupt fired, the capture is in the FIFO */
+			adxl372_fifo_drain(adxl372, &sample_ring);
+			fifo_entries = adxl372_ring_read(&sample_ring, fifo_samples,
+							 VIB_FFT_SIZE) * 3;
+			adxl372_ring_flush(&sample_ring);
+#endif
+			adi_trace_Event(ADI_TRACE_MODULE_APP, APP_TRACE_BURST,
+					fifo_entries);
 
 			/*Print data over UART*/
 			u32RTCTime = CURRENT_DATE_TIME + adi_GetRTCTime();
@@ -299,10 +371,20 @@ int main(int argc, char *argv[])
 #ifdef PEAK_ACCELERATION
 				eResult = adi_radio_DE_SendData(connInfo.nConnHandle,
 								sizeof(data_pkt),(uint8_t*)&data_pkt);
+				if (eResult != ADI_BLER_SUCCESS)
+					adi_trace_Event(ADI_TRACE_MODULE_APP,
+							APP_TRACE_BLE_SEND_ERROR, eResult);
 				timer_sleep(10);
 #else
-
-				send_fifo_data(fifo_samples, 40);
+				/* Send the features of the burst, raw data only on request */
+				if (vib_features_compute((uint16_t *)fifo_samples,
+							 fifo_entries / 3, ADXL372_ODR_HZ,
+							 &features) == 0)
+					send_features(&features);
+				if (raw_request) {
+					send_fifo_data(fifo_samples, fifo_entries);
+					raw_request = false;
+				}
 				adxl372_configure_fifo(adxl372,
 						       ADXL372_FIFO_BYPASSED,
 						       adxl372_default_init_param.fifo_config.fifo_format,
@@ -353,6 +435,73 @@ void send_fifo_data(adxl372_xyz_accel_data *fifo_data, uint16_t data_count)
 #endif
 }
 
+/**
+ * @brief Function for registering the vibration feature sensors.
+ * @return None.
+ */
+void register_features(void)
+{
+#ifndef PEAK_ACCELERATION
+	uint8_t i, j;
+
+	for (i = 0; i < sizeof(reg_pkt_feat) / sizeof(reg_pkt_feat[0]); i++) {
+		adi_radio_DE_SendData(connInfo.nConnHandle, sizeof(reg_pkt_feat[i]),
+				      (uint8_t*)&reg_pkt_feat[i]);
+		timer_sleep(10);
+		for (j = 0; j < reg_pkt_feat[i].numFields; j++) {
+			adi_radio_DE_SendData(connInfo.nConnHandle,
+					      sizeof(name_pkt_feat[i][j]),
+					      (uint8_t*)&name_pkt_feat[i][j]);
+			timer_sleep(10);
+		}
+	}
+#endif
+}
+
+/**
+ * @brief Function for sending the vibration features of a FIFO burst.
+ * @param feat - features computed over the burst.
+ * @return None.
+ */
+void send_features(vib_features *feat)
+{
+#ifndef PEAK_ACCELERATION
+	uint8_t i;
+
+	for (i = 0; i < VIB_AXES; i++) {
+		data_pkt_feat.pktTypeSensorId = reg_pkt_feat[i].pktTypeSensorId + 2;
+		data_pkt_feat.Sensor_Data1.fValue = feat->axis[i].rms;
+		data_pkt_feat.Sensor_Data2.fValue = feat->axis[i].peak;
+		data_pkt_feat.Sensor_Data3.fValue = feat->axis[i].crest;
+		data_pkt_feat.Sensor_Data4.fValue = feat->axis[i].kurtosis;
+		adi_radio_DE_SendData(connInfo.nConnHandle, sizeof(data_pkt_feat),
+				      (uint8_t*)&data_pkt_feat);
+		timer_sleep(10);
+	}
+
+	if (!feat->spectrum)
+		return;
+
+	data_pkt_feat.pktTypeSensorId = reg_pkt_feat[VIB_AXES].pktTypeSensorId + 2;
+	data_pkt_feat.Sensor_Data1.fValue = feat->band_energy[0];
+	data_pkt_feat.Sensor_Data2.fValue = feat->band_energy[1];
+	data_pkt_feat.Sensor_Data3.fValue = feat->band_energy[2];
+	data_pkt_feat.Sensor_Data4.fValue = feat->band_energy[3];
+	adi_radio_DE_SendData(connInfo.nConnHandle, sizeof(data_pkt_feat),
+			      (uint8_t*)&data_pkt_feat);
+	timer_sleep(10);
+
+	data_pkt_feat.pktTypeSensorId = reg_pkt_feat[VIB_AXES + 1].pktTypeSensorId + 2;
+	data_pkt_feat.Sensor_Data1.fValue = feat->axis[0].dominant_freq;
+	data_pkt_feat.Sensor_Data2.fValue = feat->axis[1].dominant_freq;
+	data_pkt_feat.Sensor_Data3.fValue = feat->axis[2].dominant_freq;
+	data_pkt_feat.Sensor_Data4.fValue = 0;
+	adi_radio_DE_SendData(connInfo.nConnHandle, sizeof(data_pkt_feat),
+			      (uint8_t*)&data_pkt_feat);
+	timer_sleep(10);
+#endif
+}
+
 /**
  * @brief Sign extension function.
  * @param data - data to extend sign.
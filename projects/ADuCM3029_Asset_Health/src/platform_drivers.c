@@ -126,7 +126,7 @@ int32_t spi_remove(spi_desc *desc)
  */
 int32_t spi_write_and_read(spi_desc *desc,
 			   uint8_t *data,
-			   uint8_t bytes_number)
+			   uint16_t bytes_number)
 {
 	ADI_SPI_RESULT eResult = ADI_SPI_SUCCESS;  /* assume the best */
 	ADI_SPI_TRANSCEIVER  transceive;
@@ -146,8 +146,8 @@ int32_t spi_write_and_read(spi_desc *desc,
 	transceive.bDMA = false;
 	transceive.bRD_CTL = false;
 
-	//eResult = adi_spi_MasterReadWrite(hSPI0MasterDev, &transceive);
-	eResult = adi_spi_MasterSubmitBuffer (hSPI0MasterDev, &transceive);
+	/* Wait for the transfer, the caller reads the result from data */
+	eResult = adi_spi_MasterReadWrite(hSPI0MasterDev, &transceive);
 
 	return eResult;
 }
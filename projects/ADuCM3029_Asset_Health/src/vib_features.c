@@ -0,0 +1,258 @@
+/***************************************************************************//**
+ *   @file   vib_features.c
+ *   @brief  Vibration feature extraction over ADXL372 FIFO bursts.
+********************************************************************************
+ * Copyright 2018(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <math.h>
+#include "vib_features.h"
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+/* sin(2 * pi * k / VIB_FFT_SIZE) in Q15 for k = 0 .. VIB_FFT_SIZE / 4 */
+static const int16_t vib_sin_q15[VIB_FFT_SIZE / 4 + 1] = {
+	0, 1608, 3212, 4808, 6393, 7962, 9512, 11039,
+	12540, 14010, 15447, 16846, 18205, 19520, 20788, 22006,
+	23170, 24279, 25330, 26320, 27246, 28106, 28899, 29622,
+	30274, 30853, 31357, 31786, 32138, 32413, 32610, 32729,
+	32767,
+};
+
+static int16_t vib_re[VIB_FFT_SIZE];
+static int16_t vib_im[VIB_FFT_SIZE];
+static uint32_t vib_power[VIB_FFT_SIZE / 2];
+
+/******************************************************************************/
+/************************** Functions Implementation **************************/
+/******************************************************************************/
+/**
+ * Sign extend a 12 bit ADXL372 sample.
+ * @param data - Raw sample.
+ * @return The signed sample.
+ */
+static int16_t vib_sign_extend(uint16_t data)
+{
+	return (int16_t)(data << 4) >> 4;
+}
+
+/**
+ * Get cos and sin of 2 * pi * k / VIB_FFT_SIZE in Q15.
+ * @param k - Index, 0 .. VIB_FFT_SIZE / 2.
+ * @param c - Cosine.
+ * @param s - Sine.
+ * @return None.
+ */
+static void vib_twiddle(uint16_t k, int32_t *c, int32_t *s)
+{
+	if (k <= VIB_FFT_SIZE / 4) {
+		*c = vib_sin_q15[VIB_FFT_SIZE / 4 - k];
+		*s = vib_sin_q15[k];
+	} else {
+		*c = -vib_sin_q15[k - VIB_FFT_SIZE / 4];
+		*s = vib_sin_q15[VIB_FFT_SIZE / 2 - k];
+	}
+}
+
+/**
+ * Halve a value, rounding half to even. Plain truncation or rounding half up
+ * would add the same bias at every FFT stage.
+ * @param x - Value.
+ * @return x / 2, rounded.
+ */
+static int32_t vib_half(int32_t x)
+{
+	return (x + ((x >> 1) & 1)) >> 1;
+}
+
+/**
+ * In place radix-2 decimation in time FFT in Q15. Every stage is scaled by 1/2
+ * so the output is the DFT divided by VIB_FFT_SIZE and cannot overflow.
+ * @param re - Real part.
+ * @param im - Imaginary part.
+ * @return None.
+ */
+static void vib_fft_q15(int16_t *re, int16_t *im)
+{
+	uint16_t i, j, k, len, half, bit;
+	int32_t c, s, tr, ti, ur, ui;
+	int16_t tmp;
+
+	/* Bit reversed reordering */
+	for (i = 1, j = 0; i < VIB_FFT_SIZE; i++) {
+		for (bit = VIB_FFT_SIZE >> 1; j & bit; bit >>= 1)
+			j ^= bit;
+		j |= bit;
+		if (i < j) {
+			tmp = re[i];
+			re[i] = re[j];
+			re[j] = tmp;
+			tmp = im[i];
+			im[i] = im[j];
+			im[j] = tmp;
+		}
+	}
+
+	for (len = 2; len <= VIB_FFT_SIZE; len <<= 1) {
+		half = len >> 1;
+		for (j = 0; j < half; j++) {
+			vib_twiddle(j * (VIB_FFT_SIZE / len), &c, &s);
+			for (i = j; i < VIB_FFT_SIZE; i += len) {
+				k = i + half;
+				/* (re + j im) * (c - j s) */
+				tr = (re[k] * c + im[k] * s + 0x4000) >> 15;
+				ti = (im[k] * c - re[k] * s + 0x4000) >> 15;
+				ur = re[i];
+				ui = im[i];
+				re[i] = vib_half(ur + tr);
+				im[i] = vib_half(ui + ti);
+				re[k] = vib_half(ur - tr);
+				im[k] = vib_half(ui - ti);
+			}
+		}
+	}
+}
+
+/**
+ * Compute the time domain features of one axis.
+ * @param data - Interleaved XYZ raw samples.
+ * @param count - Number of XYZ samples.
+ * @param feat - Features of the axis.
+ * @return The mean of the axis in LSB.
+ */
+static int32_t vib_time_features(const uint16_t *data, uint16_t count,
+				 vib_axis_features *feat)
+{
+	int64_t sum2 = 0, sum4 = 0;
+	int32_t sum = 0, mean, d, peak = 0;
+	uint16_t i;
+	float ms;
+
+	for (i = 0; i < count; i++)
+		sum += vib_sign_extend(data[i * VIB_AXES]);
+	mean = (sum + ((sum >= 0) ? count / 2 : -(count / 2))) / count;
+
+	for (i = 0; i < count; i++) {
+		d = vib_sign_extend(data[i * VIB_AXES]) - mean;
+		sum2 += d * d;
+		sum4 += (int64_t)(d * d) * (d * d);
+		if (d < 0)
+			d = -d;
+		if (d > peak)
+			peak = d;
+	}
+
+	ms = (float)sum2 / count;
+	feat->rms = sqrtf(ms) * VIB_LSB_G;
+	feat->peak = peak * VIB_LSB_G;
+	feat->crest = (sum2) ? (peak / sqrtf(ms)) : 0;
+	feat->kurtosis = (sum2) ? ((float)sum4 / count) / (ms * ms) : 0;
+
+	return mean;
+}
+
+/**
+ * Compute the vibration features of a burst of ADXL372 FIFO samples.
+ *
+ * The time domain features use all the samples, with the mean of each axis
+ * removed. The spectrum of each axis is computed with a Hann windowed fixed
+ * point FFT over the first VIB_FFT_SIZE samples, so it is only available when
+ * the burst is long enough.
+ * @param data - Interleaved XYZ raw 12 bit samples, as read from the FIFO.
+ * @param count - Number of XYZ samples.
+ * @param odr_hz - Output data rate of each axis.
+ * @param feat - Computed features.
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t vib_features_compute(const uint16_t *data, uint16_t count,
+			     uint32_t odr_hz, vib_features *feat)
+{
+	uint64_t band[VIB_BANDS] = {0};
+	uint16_t axis, i, dominant;
+	int32_t mean, c, s, x;
+
+	if (!count)
+		return -1;
+
+	feat->samples = count;
+	feat->spectrum = (count >= VIB_FFT_SIZE);
+
+	for (axis = 0; axis < VIB_AXES; axis++) {
+		mean = vib_time_features(&data[axis], count, &feat->axis[axis]);
+		feat->axis[axis].dominant_freq = 0;
+		if (!feat->spectrum)
+			continue;
+
+		for (i = 0; i < VIB_FFT_SIZE; i++) {
+			/* Hann window: (1 - cos(2 * pi * i / N)) / 2 */
+			vib_twiddle((i <= VIB_FFT_SIZE / 2) ? i : VIB_FFT_SIZE - i,
+				    &c, &s);
+			/* 12 bit samples, 3 bits of headroom are used */
+			x = (vib_sign_extend(data[i * VIB_AXES + axis]) - mean) << 3;
+			if (x > 32767)
+				x = 32767;
+			else if (x < -32768)
+				x = -32768;
+			vib_re[i] = (x * ((32768 - c) >> 1)) >> 15;
+			vib_im[i] = 0;
+		}
+
+		vib_fft_q15(vib_re, vib_im);
+
+		dominant = 1;
+		for (i = 1; i < VIB_FFT_SIZE / 2; i++) {
+			vib_power[i] = vib_re[i] * vib_re[i] + vib_im[i] * vib_im[i];
+			band[(i * VIB_BANDS) / (VIB_FFT_SIZE / 2)] += vib_power[i];
+			if (vib_power[i] > vib_power[dominant])
+				dominant = i;
+		}
+		feat->axis[axis].dominant_freq = (float)dominant * odr_hz /
+						 VIB_FFT_SIZE;
+	}
+
+	/*
+	 * One sided mean square of the input: 2 * |X[k]|^2, undo the 3 bits of
+	 * headroom and the 3/8 power loss of the Hann window.
+	 */
+	for (i = 0; i < VIB_BANDS; i++)
+		feat->band_energy[i] = (feat->spectrum) ? 2.0f * band[i] *
+				       (VIB_LSB_G * VIB_LSB_G) /
+				       (64.0f * 0.375f) : 0;
+
+	return 0;
+}
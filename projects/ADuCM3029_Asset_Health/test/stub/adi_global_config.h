@@ -0,0 +1 @@
+/* Host replacement of the global configuration included by adi_timestamp.h */
@@ -0,0 +1,7 @@
+/* Host replacement of the processor header included by adi_trace.c, the
+ * exclusive access intrinsics are defined by test_trace.c */
+
+#include <stdint.h>
+
+uint32_t __LDREXW(volatile uint32_t *addr);
+uint32_t __STREXW(uint32_t value, volatile uint32_t *addr);
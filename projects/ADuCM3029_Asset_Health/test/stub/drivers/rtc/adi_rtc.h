@@ -0,0 +1 @@
+/* Host replacement of the RTC driver header included by adi_timestamp.h */
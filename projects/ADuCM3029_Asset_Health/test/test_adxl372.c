@@ -0,0 +1,410 @@
+/* Host test of the ADXL372 FIFO unpacking and draining
+ *
+ * FIFO words are built the way the ADXL372 stores them: 12 bits of data in
+ * bits 15..4 and the series start tag in bit 0 of the first word of a set.
+ * Every FIFO format is unpacked from clean streams and from streams with
+ * single words dropped at random, which must only lose the sets the dropped
+ * words belonged to. adxl372_fifo_drain() then runs against a model of the device
+ * FIFO behind spi_write_and_read().
+ *
+ * The test also prints the unpacking cost per FIFO word for every format,
+ * next to the plain XYZ loop without tag checks the driver used before.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "platform_drivers.h"
+#include "adxl372.h"
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+#define MAX_SETS	512
+
+static uint32_t seed = 1;
+
+static uint32_t rnd(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8) & 0xFFFFFF;
+}
+
+/* Axes stored by each format, in FIFO order */
+static const uint8_t format_axes[] = {
+	[ADXL372_XYZ_FIFO] = 0x7,
+	[ADXL372_X_FIFO] = 0x1,
+	[ADXL372_Y_FIFO] = 0x2,
+	[ADXL372_XY_FIFO] = 0x3,
+	[ADXL372_Z_FIFO] = 0x4,
+	[ADXL372_XZ_FIFO] = 0x5,
+	[ADXL372_YZ_FIFO] = 0x6,
+	[ADXL372_XYZ_PEAK_FIFO] = 0x7,
+};
+
+static const char *const format_name[] = {
+	"XYZ", "X", "Y", "XY", "Z", "XZ", "YZ", "XYZ peak"
+};
+
+static uint8_t format_words(adxl372_fifo_format format)
+{
+	uint8_t axes = format_axes[format];
+
+	return (axes & 1) + ((axes >> 1) & 1) + (axes >> 2);
+}
+
+/* Random sets holding only the axes of the format */
+static void make_sets(adxl372_fifo_format format, adxl372_xyz_accel_data *sets,
+		      uint16_t cnt)
+{
+	uint8_t axes = format_axes[format];
+	uint16_t i;
+
+	for (i = 0; i < cnt; i++) {
+		sets[i].x = (axes & 1) ? rnd() & 0xFFF : 0;
+		sets[i].y = (axes & 2) ? rnd() & 0xFFF : 0;
+		sets[i].z = (axes & 4) ? rnd() & 0xFFF : 0;
+	}
+}
+
+/* FIFO words of the sets, the set of every word goes in owner */
+static uint16_t pack_words(adxl372_fifo_format format,
+			   const adxl372_xyz_accel_data *sets, uint16_t cnt,
+			   uint16_t *words, uint16_t *owner)
+{
+	uint8_t axes = format_axes[format];
+	const uint16_t *val;
+	uint16_t i, n = 0;
+	uint8_t k;
+	bool first;
+
+	for (i = 0; i < cnt; i++) {
+		val = &sets[i].x;
+		first = true;
+		for (k = 0; k < 3; k++) {
+			if (!(axes & (1 << k)))
+				continue;
+			words[n] = (val[k] << 4) | first;
+			if (owner)
+				owner[n] = i;
+			n++;
+			first = false;
+		}
+	}
+
+	return n;
+}
+
+/* FIFO data register bytes, MSB first */
+static void to_bytes(const uint16_t *words, uint16_t cnt, uint8_t *raw)
+{
+	uint16_t i;
+
+	for (i = 0; i < cnt; i++) {
+		raw[2 * i] = words[i] >> 8;
+		raw[2 * i + 1] = words[i] & 0xFF;
+	}
+}
+
+static bool same_set(const adxl372_xyz_accel_data *a,
+		     const adxl372_xyz_accel_data *b)
+{
+	return a->x == b->x && a->y == b->y && a->z == b->z;
+}
+
+static void test_clean(adxl372_fifo_format format)
+{
+	static adxl372_xyz_accel_data sets[MAX_SETS], out[MAX_SETS];
+	static uint16_t words[3 * MAX_SETS];
+	static uint8_t raw[6 * MAX_SETS];
+	const uint8_t *p = raw;
+	uint8_t n = format_words(format);
+	uint16_t cnt = 510 / n, total, left, got, i;
+	uint32_t resyncs = 0;
+
+	make_sets(format, sets, cnt);
+	total = pack_words(format, sets, cnt, words, NULL);
+	to_bytes(words, total, raw);
+
+	/* All sets */
+	left = total;
+	got = adxl372_fifo_unpack(format, &p, &left, out, MAX_SETS, &resyncs);
+	CHECK(got == cnt && left == 0 && p == raw + 2 * total);
+	CHECK(resyncs == 0);
+	for (i = 0; i < got; i++)
+		CHECK(same_set(&out[i], &sets[i]));
+
+	/* Bounded by max_sets, the rest stays for the next call */
+	p = raw;
+	left = total;
+	got = adxl372_fifo_unpack(format, &p, &left, out, 7, &resyncs);
+	CHECK(got == 7 && left == total - 7 * n && p == raw + 14 * n);
+	got = adxl372_fifo_unpack(format, &p, &left, out, MAX_SETS, &resyncs);
+	CHECK(got == cnt - 7 && left == 0 && same_set(&out[0], &sets[7]));
+
+	/* A partial set at the end is not consumed */
+	p = raw;
+	left = 2 * n + n - 1;
+	got = adxl372_fifo_unpack(format, &p, &left, out, MAX_SETS, &resyncs);
+	CHECK(got == 2 && left == n - 1 && p == raw + 4 * n);
+	CHECK(resyncs == 0);
+}
+
+static void test_drops(adxl372_fifo_format format)
+{
+	static adxl372_xyz_accel_data sets[MAX_SETS], out[MAX_SETS];
+	static uint16_t words[3 * MAX_SETS], owner[3 * MAX_SETS];
+	static uint8_t raw[6 * MAX_SETS];
+	static bool damaged[MAX_SETS];
+	const uint8_t *p;
+	uint8_t n = format_words(format);
+	uint16_t cnt = 510 / n, total, kept, left, got, i, j, run, expect;
+	uint32_t resyncs;
+
+	for (run = 0; run < 200; run++) {
+		make_sets(format, sets, cnt);
+		total = pack_words(format, sets, cnt, words, owner);
+
+		/*
+		 * Drop about one word in 30, at least a set apart. Only the
+		 * tags are checked, so words lost across two sets could leave
+		 * words of both that look like one set.
+		 */
+		memset(damaged, 0, sizeof(damaged));
+		for (i = 0, kept = 0, j = 0; i < total; i++) {
+			if (j == 0 && rnd() % 30 == 0) {
+				damaged[owner[i]] = true;
+				j = n;
+				continue;
+			}
+			if (j)
+				j--;
+			words[kept] = words[i];
+			owner[kept] = owner[i];
+			kept++;
+		}
+		to_bytes(words, kept, raw);
+
+		p = raw;
+		left = kept;
+		resyncs = 0;
+		got = adxl372_fifo_unpack(format, &p, &left, out, MAX_SETS,
+					  &resyncs);
+		CHECK(left < n);
+
+		/* Every intact set comes out, in order, nothing else */
+		expect = 0;
+		for (i = 0, j = 0; i < cnt; i++) {
+			if (damaged[i])
+				continue;
+			expect++;
+			if (j < got && same_set(&out[j], &sets[i]))
+				j++;
+		}
+		/* The last set may stay behind a dropped word as a partial
+		 * one */
+		if (left && !damaged[cnt - 1])
+			expect--;
+		CHECK(got == expect && j == got);
+		if (n > 1)
+			CHECK(resyncs <= cnt - expect);
+		else
+			CHECK(resyncs == 0);
+	}
+}
+
+/* Device FIFO model behind the SPI transfers */
+static uint16_t fifo[ADXL372_FIFO_SIZE];
+static uint16_t fifo_cnt;
+static uint32_t reads;
+
+int32_t spi_write_and_read(spi_desc *desc, uint8_t *data, uint16_t bytes)
+{
+	uint16_t i;
+
+	CHECK((data[0] & 1) == 1);
+	if (data[0] == ADXL372_REG_READ(ADXL372_STATUS_1)) {
+		CHECK(bytes == 5);
+		data[1] = (fifo_cnt >= 256) ? 0x06 : 0x02;
+		data[2] = 0;
+		data[3] = fifo_cnt >> 8;
+		data[4] = fifo_cnt & 0xFF;
+	} else if (data[0] == ADXL372_REG_READ(ADXL372_FIFO_DATA)) {
+		CHECK(bytes - 1 <= 2 * fifo_cnt);
+		for (i = 0; i < (bytes - 1) / 2; i++) {
+			data[1 + 2 * i] = fifo[i] >> 8;
+			data[2 + 2 * i] = fifo[i] & 0xFF;
+		}
+		fifo_cnt -= i;
+		memmove(fifo, &fifo[i], fifo_cnt * 2);
+		reads++;
+	} else {
+		CHECK(0);
+	}
+
+	return 0;
+}
+
+void mdelay(uint32_t msecs)
+{
+}
+
+int32_t spi_init(spi_desc **desc, spi_init_param param)
+{
+	return -1;
+}
+
+int32_t gpio_get(gpio_desc **desc, uint8_t gpio_number)
+{
+	return -1;
+}
+
+int32_t gpio_direction_input(gpio_desc *desc)
+{
+	return -1;
+}
+
+#define STREAM_SETS	2000
+
+static void test_drain(adxl372_fifo_format format)
+{
+	static adxl372_xyz_accel_data sets[STREAM_SETS], buf[256], out[256];
+	adxl372_sample_ring ring;
+	adxl372_dev dev = { 0 };
+	uint8_t n = format_words(format);
+	uint16_t fed = 0, next = 0, got, i, loops = 0;
+	int32_t ret;
+
+	dev.fifo_config.fifo_format = format;
+	CHECK(adxl372_ring_init(&ring, buf, 100) != 0);
+	CHECK(adxl372_ring_init(&ring, buf, 256) == 0);
+	make_sets(format, sets, STREAM_SETS);
+	fifo_cnt = 0;
+
+	/*
+	 * The device keeps filling the FIFO while the ring is drained by
+	 * random amounts, so the unpacking wraps round the ring and sometimes
+	 * stops on a full ring.
+	 */
+	while (next < STREAM_SETS && loops++ < 10000) {
+		while (fed < STREAM_SETS && fifo_cnt + n <= ADXL372_FIFO_SIZE &&
+		       rnd() % 8 != 0)
+			fifo_cnt += pack_words(format, &sets[fed++], 1,
+					       &fifo[fifo_cnt], NULL);
+		if (fed == STREAM_SETS && fifo_cnt == n)
+			/* Flush the set the drain leaves behind */
+			fifo_cnt += pack_words(format, sets, 1,
+					       &fifo[fifo_cnt], NULL);
+
+		ret = adxl372_fifo_drain(&dev, &ring);
+		CHECK(ret >= 0);
+		/* One set stays in the FIFO, unless the ring is full */
+		CHECK(fifo_cnt <= n || adxl372_ring_count(&ring) == 256);
+
+		got = adxl372_ring_read(&ring, out, rnd() % 200);
+		for (i = 0; i < got && next < STREAM_SETS; i++)
+			CHECK(same_set(&out[i], &sets[next++]));
+	}
+	CHECK(next == STREAM_SETS);
+	CHECK(ring.resyncs == 0 && ring.overruns == 0);
+
+	/* Less than two sets: nothing is read */
+	fifo_cnt = n;
+	reads = 0;
+	CHECK(adxl372_fifo_drain(&dev, &ring) == 0 && reads == 0);
+	adxl372_ring_flush(&ring);
+	CHECK(adxl372_ring_count(&ring) == 0);
+}
+
+/* The XYZ loop without tag checks the driver used before */
+static void unpack_unchecked(const uint8_t *p, uint16_t words,
+			     adxl372_xyz_accel_data *samples)
+{
+	uint16_t i;
+
+	for (i = 0; i < words / 3; i++) {
+		samples[i].x = (p[6 * i] << 4) | (p[6 * i + 1] >> 4);
+		samples[i].y = (p[6 * i + 2] << 4) | (p[6 * i + 3] >> 4);
+		samples[i].z = (p[6 * i + 4] << 4) | (p[6 * i + 5] >> 4);
+	}
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#define BENCH_LOOPS	20000
+
+static void bench(void)
+{
+	static adxl372_xyz_accel_data sets[MAX_SETS], out[MAX_SETS];
+	static uint16_t words[3 * MAX_SETS];
+	static uint8_t raw[6 * MAX_SETS];
+	adxl372_fifo_format format;
+	const uint8_t *p;
+	uint16_t total, left;
+	uint32_t i, sum = 0;
+	double start;
+
+	printf("FIFO unpacking cost per word:\n");
+	for (format = ADXL372_XYZ_FIFO; format <= ADXL372_XYZ_PEAK_FIFO;
+	     format++) {
+		make_sets(format, sets, 510 / format_words(format));
+		total = pack_words(format, sets, 510 / format_words(format),
+				   words, NULL);
+		to_bytes(words, total, raw);
+		start = now_ns();
+		for (i = 0; i < BENCH_LOOPS; i++) {
+			p = raw;
+			left = total;
+			sum += adxl372_fifo_unpack(format, &p, &left, out,
+						   MAX_SETS, NULL);
+			sum += out[i % 100].x;
+		}
+		printf("  %-9s %.2f ns\n", format_name[format],
+		       (now_ns() - start) / BENCH_LOOPS / total);
+		if (format == ADXL372_XYZ_FIFO) {
+			start = now_ns();
+			for (i = 0; i < BENCH_LOOPS; i++) {
+				unpack_unchecked(raw, total, out);
+				sum += out[i % 100].x;
+			}
+			printf("  %-9s %.2f ns\n", "XYZ, old",
+			       (now_ns() - start) / BENCH_LOOPS / total);
+		}
+	}
+	/* Keep the results alive */
+	if (sum == 0)
+		printf("\n");
+}
+
+int main(void)
+{
+	adxl372_fifo_format format;
+
+	for (format = ADXL372_XYZ_FIFO; format <= ADXL372_XYZ_PEAK_FIFO;
+	     format++) {
+		test_clean(format);
+		test_drops(format);
+		test_drain(format);
+	}
+	bench();
+
+	printf(failures ? "FAILED\n" : "OK\n");
+
+	return failures ? 1 : 0;
+}
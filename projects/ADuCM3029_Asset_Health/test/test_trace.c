@@ -0,0 +1,345 @@
+/* Host test of the trace buffer and of its dump frames
+ *
+ * adi_trace.c of the BLE pack runs with host versions of the exclusive
+ * access intrinsics. They can take an "interrupt" between LDREX and STREX:
+ * the interrupt logs its own record and the STREX fails, as on the
+ * Cortex-M3. The timestamp source can start a dump, like an interrupt that
+ * preempts a writer after it claimed its slot, and the write function can log
+ * records while a dump is sent. Every frame is checked byte by byte.
+ *
+ * The frames of the first scenario are written to trace.bin, or to the file
+ * given on the command line, test_trace_decode.py decodes them with
+ * trace_decode.py.
+ *
+ * The test also prints the cost of a trace point.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <common/adi_trace.h>
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+#define ENTRIES		ADI_CFG_TRACE_NUM_ENTRIES
+#define HEADER_SIZE	24
+#define REC_SIZE	12
+
+/* Event ids the decoder test looks up in the headers */
+#define BLE_SET_MODE	0x204	/* LOGID_CMD_BLEGAP_SET_MODE */
+#define APP_BURST	2	/* APP_TRACE_BURST */
+
+/* Timestamp source, an "interrupt" can dump from inside it */
+static uint32_t now;
+static int dump_in_time;
+
+/* Interrupt between LDREX and STREX */
+static int strex_irq;
+
+/* Records logged by the write function during a dump */
+static int log_in_write;
+
+/* Frames */
+static uint8_t frame[HEADER_SIZE + ENTRIES * REC_SIZE + 2];
+static uint32_t frame_len;
+static uint8_t nested[sizeof(frame)];
+static uint32_t nested_len;
+static FILE *capture;
+
+static void write_frame(const uint8_t *p, uint32_t n)
+{
+	CHECK(frame_len + n <= sizeof(frame));
+	if (frame_len + n <= sizeof(frame)) {
+		memcpy(&frame[frame_len], p, n);
+		frame_len += n;
+	}
+	while (log_in_write > 0) {
+		log_in_write--;
+		adi_trace_Event(ADI_TRACE_MODULE_APP, 0xAAAA, 0);
+	}
+}
+
+static void write_nested(const uint8_t *p, uint32_t n)
+{
+	memcpy(&nested[nested_len], p, n);
+	nested_len += n;
+}
+
+uint32_t adi_GetRTCTime(void)
+{
+	if (dump_in_time) {
+		dump_in_time = 0;
+		nested_len = 0;
+		adi_trace_Dump(write_nested);
+	}
+
+	return now;
+}
+
+uint32_t __LDREXW(volatile uint32_t *addr)
+{
+	return *addr;
+}
+
+uint32_t __STREXW(uint32_t value, volatile uint32_t *addr)
+{
+	if (strex_irq) {
+		strex_irq = 0;
+		adi_trace_Event(ADI_TRACE_MODULE_APP, 0xBEEF, 1);
+		return 1;
+	}
+	*addr = value;
+
+	return 0;
+}
+
+static uint32_t get(const uint8_t *p, int size)
+{
+	uint32_t v = 0;
+
+	while (size--)
+		v = (v << 8) | p[size];
+
+	return v;
+}
+
+struct rec {
+	uint32_t time;
+	uint16_t event;
+	uint8_t module;
+	uint8_t seq;
+	uint32_t data;
+};
+
+/* Check the frame layout, return the number of records */
+static uint32_t parse(const uint8_t *p, uint32_t len, uint32_t *first,
+		      uint32_t *logged, uint32_t *lost, struct rec *recs)
+{
+	uint32_t count, i;
+	uint16_t sum = 0;
+
+	CHECK(len >= HEADER_SIZE + 2);
+	if (len < HEADER_SIZE + 2)
+		return 0;
+	CHECK(p[0] == 'T' && p[1] == 'R');
+	CHECK(p[2] == ADI_TRACE_VERSION);
+	CHECK(p[3] == REC_SIZE && sizeof(ADI_TRACE_RECORD) == REC_SIZE);
+	count = get(&p[4], 2);
+	CHECK(get(&p[6], 2) == ENTRIES);
+	*first = get(&p[8], 4);
+	*logged = get(&p[12], 4);
+	*lost = get(&p[16], 4);
+	CHECK(get(&p[20], 4) == ADI_CFG_TRACE_TICK_HZ);
+	CHECK(len == HEADER_SIZE + count * REC_SIZE + 2);
+	CHECK(count <= ENTRIES);
+	if (len != HEADER_SIZE + count * REC_SIZE + 2 || count > ENTRIES)
+		return 0;
+	for (i = 2; i < len - 2; i++)
+		sum += p[i];
+	CHECK(get(&p[len - 2], 2) == sum);
+
+	for (i = 0; i < count; i++) {
+		const uint8_t *r = &p[HEADER_SIZE + i * REC_SIZE];
+
+		recs[i].time = get(r, 4);
+		recs[i].event = get(&r[4], 2);
+		recs[i].module = r[6];
+		recs[i].seq = r[7];
+		recs[i].data = get(&r[8], 4);
+	}
+
+	return count;
+}
+
+static uint32_t dump(uint32_t *first, uint32_t *logged, uint32_t *lost,
+		     struct rec *recs)
+{
+	uint32_t n;
+
+	frame_len = 0;
+	n = adi_trace_Dump(write_frame);
+	CHECK(parse(frame, frame_len, first, logged, lost, recs) == n);
+
+	return n;
+}
+
+/* Records of the three modules with a timestamp wrapping at 32 bits */
+static void test_frame(void)
+{
+	static const uint8_t garbage[] = {'T', 'x', 'T', 'R', 1};
+	static struct rec recs[ENTRIES];
+	uint32_t first, logged, lost, i, n;
+
+	now = 0xFFFFFF00u;
+	for (i = 0; i < 10; i++) {
+		adi_trace_Event(ADI_TRACE_MODULE_BLE, BLE_SET_MODE, i);
+		now += 3;
+	}
+	adi_trace_Event(ADI_TRACE_MODULE_WIFI, 5, 0x12345678);
+	now += 496;
+	adi_trace_Event(ADI_TRACE_MODULE_APP, APP_BURST, 7);
+
+	n = dump(&first, &logged, &lost, recs);
+	CHECK(n == 12 && first == 0 && logged == 12 && lost == 0);
+	for (i = 0; i < n; i++) {
+		CHECK(recs[i].seq == i);
+		CHECK(recs[i].module != ADI_TRACE_MODULE_LOST);
+	}
+	CHECK(recs[0].time == 0xFFFFFF00u && recs[9].data == 9);
+	CHECK(recs[10].module == ADI_TRACE_MODULE_WIFI &&
+	      recs[10].data == 0x12345678);
+	CHECK(recs[11].module == ADI_TRACE_MODULE_APP &&
+	      recs[11].event == APP_BURST && recs[11].time == 0x0000010Eu);
+
+	/* The decoder skips bytes before a frame, false sync bytes and a frame
+	 * with a bad checksum */
+	if (capture) {
+		fwrite(garbage, 1, sizeof(garbage), capture);
+		fwrite(frame, 1, frame_len, capture);
+		frame[HEADER_SIZE + 8] ^= 0x01;
+		fwrite(frame, 1, frame_len, capture);
+		frame[HEADER_SIZE + 8] ^= 0x01;
+	}
+
+	/* Nothing new */
+	n = dump(&first, &logged, &lost, recs);
+	CHECK(n == 0 && first == 12 && logged == 12);
+	if (capture)
+		fwrite(frame, 1, frame_len, capture);
+}
+
+/* Records overwritten before the dump are counted as lost */
+static void test_wrap(void)
+{
+	static struct rec recs[ENTRIES];
+	ADI_TRACE_STATS stats;
+	uint32_t first, logged, lost, i, n;
+
+	for (i = 0; i < ENTRIES + 72; i++)
+		adi_trace_Event(ADI_TRACE_MODULE_APP, 3, i);
+	adi_trace_GetStats(&stats);
+	CHECK(stats.nLogged == 12 + ENTRIES + 72 && stats.nLost == 72);
+
+	n = dump(&first, &logged, &lost, recs);
+	CHECK(n == ENTRIES && first == 12 + 72 && lost == 72);
+	for (i = 0; i < n; i++) {
+		CHECK(recs[i].seq == (uint8_t)(first + i));
+		CHECK(recs[i].data == 72 + i);
+	}
+	adi_trace_GetStats(&stats);
+	CHECK(stats.nDumped == 12 + ENTRIES && stats.nLost == 72);
+}
+
+/* An interrupt between LDREX and STREX gets the slot, the writer retries */
+static void test_strex(void)
+{
+	static struct rec recs[ENTRIES];
+	uint32_t first, logged, lost, n;
+
+	strex_irq = 1;
+	adi_trace_Event(ADI_TRACE_MODULE_APP, 0x1111, 2);
+	n = dump(&first, &logged, &lost, recs);
+	CHECK(n == 2 && lost == 72);
+	CHECK(recs[0].event == 0xBEEF && recs[1].event == 0x1111);
+	CHECK(recs[0].seq == (uint8_t)first &&
+	      recs[1].seq == (uint8_t)(first + 1));
+}
+
+/* A dump preempting a writer finds the stale sequence byte of the slot it
+ * claimed, the record of the previous lap is not sent as valid */
+static void test_preempted_writer(void)
+{
+	static struct rec recs[ENTRIES];
+	uint32_t first, logged, lost, n;
+
+	dump_in_time = 1;
+	adi_trace_Event(ADI_TRACE_MODULE_APP, 0x2222, 3);
+	n = parse(nested, nested_len, &first, &logged, &lost, recs);
+	CHECK(n == 1);
+	CHECK(recs[0].module == ADI_TRACE_MODULE_LOST);
+	CHECK(recs[0].seq == (uint8_t)(first - ENTRIES));
+
+	/* The header was sent before the record was found lost */
+	CHECK(lost == 72);
+
+	/* The record is complete once the writer returns, it was already
+	 * reported */
+	n = dump(&first, &logged, &lost, recs);
+	CHECK(n == 0 && lost == 73);
+}
+
+/* Records logged while a full buffer is sent overwrite slots not sent yet */
+static void test_overwrite_during_dump(void)
+{
+	static struct rec recs[ENTRIES];
+	uint32_t first, logged, lost, i, n, bad = 0;
+
+	for (i = 0; i < ENTRIES; i++)
+		adi_trace_Event(ADI_TRACE_MODULE_BLE, BLE_SET_MODE, i);
+	log_in_write = 5;
+	n = dump(&first, &logged, &lost, recs);
+	CHECK(n == ENTRIES);
+	for (i = 0; i < n; i++) {
+		if (i < 5)
+			CHECK(recs[i].module == ADI_TRACE_MODULE_LOST);
+		else
+			bad += recs[i].module != ADI_TRACE_MODULE_BLE ||
+			       recs[i].data != i;
+	}
+	CHECK(bad == 0);
+
+	/* The 5 new records come with the next dump */
+	n = dump(&first, &logged, &lost, recs);
+	CHECK(n == 5 && lost == 73 + 5);
+	for (i = 0; i < n; i++)
+		CHECK(recs[i].event == 0xAAAA && recs[i].seq == (uint8_t)(first + i));
+}
+
+static double ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void bench(void)
+{
+	const uint32_t n = 10000000;
+	uint32_t i;
+	double t0;
+
+	t0 = ns();
+	for (i = 0; i < n; i++)
+		adi_trace_Event(ADI_TRACE_MODULE_APP, 1, i);
+	printf("trace point: %.1f ns on the host\n", (ns() - t0) / n);
+}
+
+int main(int argc, char **argv)
+{
+	capture = fopen(argc > 1 ? argv[1] : "trace.bin", "wb");
+	CHECK(capture != NULL);
+
+	test_frame();
+	if (capture)
+		fclose(capture);
+	test_wrap();
+	test_strex();
+	test_preempted_writer();
+	test_overwrite_during_dump();
+	bench();
+
+	printf(failures ? "FAILED\n" : "OK\n");
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,99 @@
+"""Decode the frames written by test_trace with trace_decode.py.
+
+The capture holds a few bytes of noise, a frame of 12 records whose
+timestamps wrap at 32 bits, the same frame with a bad checksum and an empty
+frame. A copy of the first frame with a wrong sequence byte in one record
+checks the decoder's own sequence check.
+
+Usage:
+    python3 test_trace_decode.py capture.bin
+"""
+
+import contextlib
+import io
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                '..', 'scripts'))
+import trace_decode  # noqa: E402
+
+failures = 0
+
+
+def check(cond, what):
+    """Count and report a failed check."""
+    global failures
+    if not cond:
+        print('check failed: %s' % what)
+        failures += 1
+
+
+def decode(data):
+    """Return the timeline printed for data as a list of lines."""
+    names = {}
+    for module, paths in trace_decode.HEADERS.items():
+        names[module] = {}
+        for path in paths:
+            names[module].update(trace_decode.enum_names(path))
+    out = io.StringIO()
+    with contextlib.redirect_stdout(out):
+        tail = trace_decode.print_frames(data, names)
+    check(tail == b'', 'whole capture consumed')
+    return out.getvalue().splitlines()
+
+
+def main():
+    """Check the frames and the timeline of the capture."""
+    with open(sys.argv[1], 'rb') as capture:
+        data = capture.read()
+
+    frames = list(trace_decode.decode_frames(data))
+    check(len(frames) == 2, 'noise and bad checksum skipped')
+    header, records, _ = frames[0]
+    check(header[2] == 12 and len(records) == 12, '12 records')
+    check(header[4:] == (0, 12, 0, 1024), 'first, logged, lost, tick Hz')
+    check(all(rec[3] == seq for seq, rec in enumerate(records)),
+          'sequence bytes')
+    check(frames[1][0][2] == 0 and frames[1][0][4:6] == (12, 12),
+          'empty frame')
+
+    lines = decode(data)
+    check(lines[0] == 'Trace: 12 records from #0, 12 logged, 0 lost',
+          'frame line: %s' % lines[0])
+    fields = [line.split(', ') for line in lines[2:14]]
+    check(fields[0] == ['0', '0.000', '0.0', 'BLE',
+                        'LOGID_CMD_BLEGAP_SET_MODE', '0x00000000'],
+          'first record: %s' % fields[0])
+    check(fields[10][3] == 'WIFI' and fields[10][5] == '0x12345678',
+          'Wi-Fi record: %s' % fields[10])
+    # 0xFFFFFF00 to 0x0000010E is 526 ticks of 1/1024 s, 496 after the
+    # Wi-Fi record
+    check(fields[11] == ['11', '0.514', '484.4', 'APP', 'APP_TRACE_BURST',
+                         '0x00000007'], 'wrapped timestamp: %s' % fields[11])
+    check(lines[14] == 'Trace: 0 records from #12, 12 logged, 0 lost',
+          'empty frame line: %s' % lines[14])
+    check(not any('LOST' in line for line in lines), 'no lost records')
+
+    # A record whose sequence byte does not follow is shown as lost
+    end = frames[0][2]
+    size = len(trace_decode.SYNC) + trace_decode.HDR.size + \
+        12 * trace_decode.REC.size + trace_decode.CSUM.size
+    frame = bytearray(data[end - size:end])
+    rec3 = len(trace_decode.SYNC) + trace_decode.HDR.size + \
+        3 * trace_decode.REC.size
+    frame[rec3 + 7] ^= 0x80
+    struct.pack_into('<H', frame, len(frame) - 2,
+                     sum(frame[2:-2]) & 0xFFFF)
+    lines = decode(bytes(frame))
+    check(lines[2 + 3] == '3, -, -, LOST, -, -',
+          'stale record: %s' % lines[2 + 3])
+    check(sum('LOST' in line for line in lines) == 1, 'one lost record')
+
+    print('FAILED' if failures else 'OK')
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
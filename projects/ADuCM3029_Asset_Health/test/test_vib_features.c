@@ -0,0 +1,291 @@
+/* Host test of the vibration features against a double precision reference
+ *
+ * vib_features.c is included so the fixed point FFT and the twiddle table,
+ * which are static, can be checked on their own. The FFT is compared with a
+ * direct DFT of the same Q15 input, then the features of whole bursts (Hann
+ * window, band energies, dominant frequency and the time domain features) are
+ * compared with the same computation done in double precision on the 12 bit
+ * samples.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "vib_features.c"
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+#define N	VIB_FFT_SIZE
+#define ODR	6400
+#define BURST	170
+
+static uint32_t seed = 1;
+
+static uint32_t rnd(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8) & 0xFFFFFF;
+}
+
+/* Uniform in -1 .. 1 */
+static double rnd_unit(void)
+{
+	return rnd() / (double)0x800000 - 1.0;
+}
+
+static double rel_err(double val, double ref)
+{
+	return fabs(val - ref) / fabs(ref);
+}
+
+static void test_twiddle(void)
+{
+	int32_t c, s;
+	double err = 0;
+	uint16_t k;
+
+	for (k = 0; k <= N / 2; k++) {
+		vib_twiddle(k, &c, &s);
+		err = fmax(err, fabs(c - 32768.0 * cos(2 * M_PI * k / N)));
+		err = fmax(err, fabs(s - 32768.0 * sin(2 * M_PI * k / N)));
+	}
+	CHECK(err <= 1.0);
+}
+
+/* Direct DFT / N */
+static void dft(const double *x, double *re, double *im)
+{
+	uint16_t k, i;
+
+	for (k = 0; k < N; k++) {
+		re[k] = im[k] = 0;
+		for (i = 0; i < N; i++) {
+			re[k] += x[i] * cos(2 * M_PI * k * i / N) / N;
+			im[k] -= x[i] * sin(2 * M_PI * k * i / N) / N;
+		}
+	}
+}
+
+static void test_fft(void)
+{
+	double x[N], re[N], im[N], err, max_err = 0;
+	int16_t fre[N], fim[N];
+	uint16_t run, i, k;
+
+	for (run = 0; run < 200; run++) {
+		for (i = 0; i < N; i++) {
+			/* Full scale noise, a tone or both */
+			x[i] = 0;
+			if (run % 3 != 1)
+				x[i] += 16000 * rnd_unit();
+			if (run % 3 != 0)
+				x[i] += 16000 * cos(2 * M_PI * (run % (N / 2)) *
+						    i / N + run);
+			fre[i] = (int16_t)lround(x[i]);
+			fim[i] = 0;
+			x[i] = fre[i];
+		}
+		vib_fft_q15(fre, fim);
+		dft(x, re, im);
+		for (k = 0; k < N; k++) {
+			err = hypot(fre[k] - re[k], fim[k] - im[k]);
+			if (err > max_err)
+				max_err = err;
+		}
+	}
+	/* Every stage rounds by up to half an LSB, later stages halve it */
+	CHECK(max_err < 3);
+	printf("FFT: largest error %.2f LSB of the output\n", max_err);
+}
+
+/* Spectrum of the last reference burst */
+static double ref_power[VIB_AXES][N / 2];
+
+/* Features of one burst in double precision */
+static void reference(const uint16_t *data, uint16_t count, vib_features *ref)
+{
+	double v[BURST], x, re[N], im[N], w[N], mean, sum2, sum4, peak, ms;
+	double band[VIB_BANDS] = {0}, *power, best;
+	uint16_t axis, i, k;
+
+	for (axis = 0; axis < VIB_AXES; axis++) {
+		mean = 0;
+		for (i = 0; i < count; i++) {
+			v[i] = vib_sign_extend(data[i * VIB_AXES + axis]);
+			mean += v[i] / count;
+		}
+		sum2 = sum4 = peak = 0;
+		for (i = 0; i < count; i++) {
+			x = v[i] - mean;
+			sum2 += x * x;
+			sum4 += x * x * x * x;
+			peak = fmax(peak, fabs(x));
+		}
+		ms = sum2 / count;
+		ref->axis[axis].rms = sqrt(ms) * VIB_LSB_G;
+		ref->axis[axis].peak = peak * VIB_LSB_G;
+		ref->axis[axis].crest = peak / sqrt(ms);
+		ref->axis[axis].kurtosis = sum4 / count / (ms * ms);
+
+		for (i = 0; i < N; i++)
+			w[i] = (v[i] - mean) * 0.5 * (1 - cos(2 * M_PI * i / N));
+		dft(w, re, im);
+		power = ref_power[axis];
+		best = 0;
+		for (k = 1; k < N / 2; k++) {
+			power[k] = re[k] * re[k] + im[k] * im[k];
+			band[k * VIB_BANDS / (N / 2)] += power[k];
+			if (power[k] > best) {
+				best = power[k];
+				ref->axis[axis].dominant_freq = (double)k * ODR / N;
+			}
+		}
+	}
+	for (i = 0; i < VIB_BANDS; i++)
+		ref->band_energy[i] = 2 * band[i] * VIB_LSB_G * VIB_LSB_G /
+				      0.375;
+}
+
+/* Interleaved 12 bit samples: tones on every axis, noise and an offset */
+static void make_burst(uint16_t *data, const double *freq, double amp,
+		       double noise, double impulse)
+{
+	uint16_t axis, i;
+	double x;
+	long v;
+
+	for (i = 0; i < BURST; i++) {
+		for (axis = 0; axis < VIB_AXES; axis++) {
+			x = 10 * axis - 5 + amp * sin(2 * M_PI * freq[axis] *
+						      i / ODR + axis) +
+			    noise * rnd_unit();
+			if (i == 40 + axis)
+				x += impulse;
+			v = lround(x / VIB_LSB_G);
+			if (v > 2047)
+				v = 2047;
+			if (v < -2048)
+				v = -2048;
+			data[i * VIB_AXES + axis] = (uint16_t)v & 0xFFF;
+		}
+	}
+}
+
+static void test_features(void)
+{
+	static const double tones[][VIB_AXES] = {
+		{ 100, 800, 2500 },
+		{ 50 * 20, 50 * 3, 50 * 60 },
+		{ 310, 1760, 2960 },
+	};
+	uint16_t data[BURST * VIB_AXES];
+	vib_features feat, ref;
+	vib_axis_features *f, *r;
+	double err_rms = 0, err_kurt = 0, err_peak = 0, err_band = 0, total;
+	uint16_t run, axis, i;
+
+	for (run = 0; run < 30; run++) {
+		make_burst(data, tones[run % 3], 5 + run % 10 * 4,
+			   run % 7 * 2.0, (run % 5 == 0) ? 60 : 0);
+		CHECK(vib_features_compute(data, BURST, ODR, &feat) == 0);
+		reference(data, BURST, &ref);
+		CHECK(feat.samples == BURST && feat.spectrum);
+
+		for (axis = 0; axis < VIB_AXES; axis++) {
+			f = &feat.axis[axis];
+			r = &ref.axis[axis];
+			err_rms = fmax(err_rms, rel_err(f->rms, r->rms));
+			err_kurt = fmax(err_kurt, rel_err(f->kurtosis,
+							  r->kurtosis));
+			/* The mean is removed in whole LSB, so the peak may
+			 * move by half an LSB, and the crest factor with it */
+			err_peak = fmax(err_peak, fabs(f->peak - r->peak) /
+					VIB_LSB_G);
+			CHECK(fabs(f->crest - r->crest) <=
+			      (0.5 * VIB_LSB_G + 1e-4) / r->rms);
+			/* Without a clear tone, the line picked only has to be
+			 * as strong as the largest one within rounding */
+			CHECK(ref_power[axis][lround(f->dominant_freq * N / ODR)] >
+			      0.95 * ref_power[axis][lround(r->dominant_freq *
+							   N / ODR)]);
+		}
+
+		/* Bands are compared to the total, a quiet band only holds the
+		 * rounding noise of the fixed point path */
+		total = 0;
+		for (i = 0; i < VIB_BANDS; i++)
+			total += ref.band_energy[i];
+		for (i = 0; i < VIB_BANDS; i++)
+			err_band = fmax(err_band, fabs(feat.band_energy[i] -
+						       ref.band_energy[i]) / total);
+	}
+	CHECK(err_rms < 1e-3);
+	CHECK(err_kurt < 1e-2);
+	CHECK(err_peak <= 0.5 + 1e-3);
+	CHECK(err_band < 0.01);
+	printf("Features: largest error %.2g rms, %.2g kurtosis, %.2f LSB peak, "
+	       "%.2g band energy\n", err_rms, err_kurt, err_peak, err_band);
+}
+
+static void test_tone(void)
+{
+	static const double freq[VIB_AXES] = { 50 * 10, 50 * 10, 50 * 10 };
+	uint16_t data[BURST * VIB_AXES];
+	vib_features feat;
+	double total = 0;
+	uint16_t i;
+
+	/* A bin centred tone of 20 G on the three axes: 3 * 20^2 / 2 G^2, all
+	 * in the first band */
+	make_burst(data, freq, 20, 0, 0);
+	CHECK(vib_features_compute(data, BURST, ODR, &feat) == 0);
+	for (i = 0; i < VIB_BANDS; i++)
+		total += feat.band_energy[i];
+	CHECK(rel_err(total, 600) < 0.02);
+	CHECK(feat.band_energy[0] > 0.99 * total);
+	for (i = 0; i < VIB_AXES; i++) {
+		CHECK(feat.axis[i].dominant_freq == 500);
+		CHECK(rel_err(feat.axis[i].rms, 20 / sqrt(2)) < 0.01);
+		CHECK(rel_err(feat.axis[i].crest, sqrt(2)) < 0.02);
+		CHECK(rel_err(feat.axis[i].kurtosis, 1.5) < 0.01);
+	}
+}
+
+static void test_short_burst(void)
+{
+	static const double freq[VIB_AXES] = { 100, 200, 300 };
+	uint16_t data[BURST * VIB_AXES];
+	vib_features feat;
+	uint16_t i;
+
+	make_burst(data, freq, 10, 1, 0);
+	CHECK(vib_features_compute(data, N - 1, ODR, &feat) == 0);
+	CHECK(feat.samples == N - 1 && !feat.spectrum);
+	for (i = 0; i < VIB_BANDS; i++)
+		CHECK(feat.band_energy[i] == 0);
+	for (i = 0; i < VIB_AXES; i++)
+		CHECK(feat.axis[i].dominant_freq == 0 && feat.axis[i].rms > 0);
+
+	CHECK(vib_features_compute(data, 0, ODR, &feat) != 0);
+}
+
+int main(void)
+{
+	test_twiddle();
+	test_fft();
+	test_features();
+	test_tone();
+	test_short_burst();
+
+	printf(failures ? "FAILED\n" : "OK\n");
+
+	return failures ? 1 : 0;
+}
@@ -9,6 +9,7 @@
 #include "telemetry.h"
 #include <json.h>
 #include "sensors_data.h"
+#include "wifi_supervisor.h"
 
 
 static char tmpdata[50];
@@ -28,6 +29,23 @@ char *telemetry_serialize(void *d) {
   json_append_member(_node, TELEMETRY_BLUE_CONCENTRATION, json_mknumber(data->blue_concentration));
 
 
+  char *tmp = json_encode(_node);
+  json_delete(_node);
+  return tmp;
+}
+
+char *link_telemetry_serialize(void *s) {
+  supervisor_stats_t *stats = (supervisor_stats_t *)s;
+  JsonNode *_node = json_mkobject();
+  json_append_member(_node, TELEMETRY_RECONNECTS, json_mknumber(stats->reconnects));
+  json_append_member(_node, TELEMETRY_OFFLINE, json_mknumber(stats->offline_ms / 1000));
+  json_append_member(_node, TELEMETRY_FAIL_AP, json_mknumber(stats->failures[SUPERVISOR_FAIL_AP]));
+  json_append_member(_node, TELEMETRY_FAIL_TCP, json_mknumber(stats->failures[SUPERVISOR_FAIL_TCP]));
+  json_append_member(_node, TELEMETRY_FAIL_MQTT, json_mknumber(stats->failures[SUPERVISOR_FAIL_MQTT]));
+  json_append_member(_node, TELEMETRY_FAIL_PING, json_mknumber(stats->failures[SUPERVISOR_FAIL_PING]));
+  json_append_member(_node, TELEMETRY_FAIL_PUBLISH, json_mknumber(stats->failures[SUPERVISOR_FAIL_PUBLISH]));
+  json_append_member(_node, TELEMETRY_LAST_FAIL, json_mknumber(stats->last_failure));
+
   char *tmp = json_encode(_node);
   json_delete(_node);
   return tmp;
@@ -15,8 +15,18 @@ extern "C" {
 #define TELEMETRY_RED_CONCENTRATION   "red_concentration"
 #define TELEMETRY_GREEN_CONCENTRATION "green_concentration"
 #define TELEMETRY_BLUE_CONCENTRATION  "blue_concentration"
+
+#define TELEMETRY_RECONNECTS          "reconnects"
+#define TELEMETRY_OFFLINE             "offline_s"
+#define TELEMETRY_FAIL_AP             "fail_ap"
+#define TELEMETRY_FAIL_TCP            "fail_tcp"
+#define TELEMETRY_FAIL_MQTT           "fail_mqtt"
+#define TELEMETRY_FAIL_PING           "fail_ping"
+#define TELEMETRY_FAIL_PUBLISH        "fail_publish"
+#define TELEMETRY_LAST_FAIL           "last_fail"
     
 char *telemetry_serialize(void *data);
+char *link_telemetry_serialize(void *stats);
 
 #if defined(__cplusplus)
 }
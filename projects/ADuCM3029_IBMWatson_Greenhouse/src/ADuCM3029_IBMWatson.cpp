@@ -51,6 +51,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //#include <common/adi_timestamp.h>
 
 #include <adi_timestamp.h>
+#include "wifi_supervisor.h"
+#include "Timer.h"
 
 /*Circuit note includes*/
 #include "adi_cn0398.h"
@@ -105,6 +107,14 @@ static ADI_WIFI_SUBSCRIBE_CONFIG    gSubscribeConfig = {
 													   .nQos = ADI_WIFI_MQTT_PUBLISER_QOS,
 													   .nPacketId = 1};
 
+static const supervisor_config_t    gSupervisorConfig = {
+													   .ssid = aWifiSSID,
+													   .password = aWifiPassword,
+													   .tcp = &gTCPConnect,
+													   .mqtt = &gMQTTConnect,
+													   .subscribe = &gSubscribeConfig,
+													   .ping_ms = ADI_WIFI_MQTT_PING_TIMEOUT};
+
 
 
 /************************* Functions Definitions ******************************/
@@ -115,7 +125,7 @@ extern "C" int32_t adi_initpinmux(void);
 /* Local Wi-Fi functions */
 static void            InitWiFiConnection(void);
 static void            adi_wifi_AplicationCallback(void * pCBParam, uint32_t nEvent, void * pArg);
-static void            RepairConnection();
+static ADI_WIFI_RESULT PublishLinkHealth(void);
 
 /*!
  * @brief      Application Callback
@@ -216,12 +226,7 @@ void InitWiFiConnection()
 	eResult = adi_wifi_radio_DisconnectFromAP();
     DEBUG_RESULT("Error disconnecting from access point.\r\n", eResult, ADI_WIFI_SUCCESS);
 
-	eResult = adi_wifi_radio_ConnectToAP(aWifiSSID, aWifiPassword,  NULL);
-    DEBUG_RESULT("Error connecting to access point.\r\n", eResult, ADI_WIFI_SUCCESS);
-
-	eResult = adi_wifi_radio_EstablishTCPConnection(&gTCPConnect);
-    DEBUG_RESULT("Error establishing a tcp connection.\r\n", eResult, ADI_WIFI_SUCCESS);
-
+    /* The AP, TCP and MQTT connections are made by the supervisor */
 }
 
 /**
@@ -252,30 +257,53 @@ int Leds_Controll(const char *str)
 	return 0;
 }
 
+/*!
+ * @brief      Publishes the connection health counters on their own topic.
+ *
+ * @details    Kept out of the sensor payload, which is close to the size of the
+ *             Wi-Fi driver MQTT packet buffer.
+ */
+static ADI_WIFI_RESULT PublishLinkHealth(void)
+{
+	ADI_WIFI_PUBLISH_CONFIG sLinkConfig = gPublishConfig;
+	ADI_WIFI_RESULT eResult;
+
+	char *payload = link_telemetry_serialize(
+			(void *)supervisor_get_stats(ui32timer_counter));
+
+	sLinkConfig.pTopic = aMQTTLinkTopicName;
+	sLinkConfig.pMQTTData = (uint8_t *)payload;
+	sLinkConfig.nMQTTDataSize = strlen(payload);
+
+	eResult = adi_wifi_radio_MQTTPublish(&sLinkConfig);
+	free(payload);
+
+	return eResult;
+}
+
 /*!
  * @brief      ESP8266 MQTT publisher demo using ADXL362 accelerometer data.
  *
- * @details    Publishes data over Wi-Fi to the broker.
+ * @details    Publishes data over Wi-Fi to the broker. The connection is kept
+ *             up by the supervisor, between publishes the loop only waits for
+ *             subscribed data until the next publish or supervisor action.
  */
 static void MQTTPublish(void)
 {
-	ADI_WIFI_RESULT eResult;
-    uint32_t        nTime = 0u;
-    uint32_t        nPacketId = 0u;
-    uint8_t         nConnectionFailFlag;
+	uint32_t        nNow, nWait;
+	uint32_t        nNextPublish;
+	uint32_t        nReconnects = 0u;
+	uint32_t        nPublishCount = 0u;
 
-    /* Initialize the ESP8266 Wi-Fi module and establish a TCP connection */
+    /* Initialize the ESP8266 Wi-Fi module */
     InitWiFiConnection();
 
-    /* Send MQTT "CONNECT" message to broker */
-    eResult = adi_wifi_radio_MQTTConnect(&gMQTTConnect);
-    //DEBUG_RESULT("Error connecting to the MQTT broker.\r\n", eResult, ADI_WIFI_SUCCESS);
-
-    eResult = adi_wifi_radio_MQTTSubscribe(&gSubscribeConfig);
+    supervisor_init(&gSupervisorConfig, ui32timer_counter);
+    nNextPublish = ui32timer_counter;
 
     DEBUG_MESSAGE("Starting to Publish\n");
 
-    gPublishConfig.nPacketId = nPacketId;
+    gPublishConfig.nPacketId = 0u;
 
     /*enable wdt*/
     adi_wdt_Enable	(	true, NULL	);
@@ -283,32 +311,11 @@ static void MQTTPublish(void)
     while(1)
     {
     	adi_wdt_Kick();
-    	nConnectionFailFlag = 0;
-
-    	/* If ping timer has expired */
-    	if (adi_wifi_IsTimerDone(1u) == 1u)
-    	{
-    		/* Send MQTT "PINGREQ" message to broker to keep the connection alive. */
-    		eResult = adi_wifi_radio_MQTTPing(ADI_WIFI_CONNECTION_ID);
 
-    		/* Restart the ping timer */
-    		if((adi_wifi_StopTimer(1u) == ADI_WIFI_SUCCESS) && (eResult == ADI_WIFI_SUCCESS))
-    		{
-    			if(adi_wifi_StartTimer(ADI_WIFI_MQTT_PING_TIMEOUT, 1u) != ADI_WIFI_SUCCESS)
-    			{
-    				DEBUG_MESSAGE("Failed to start ping timer\n");
+    	nWait = supervisor_poll(ui32timer_counter);
+    	nNow = ui32timer_counter;
 
-    			}
-    		}
-    		else
-    		{
-    			DEBUG_MESSAGE("Failed to ping broker\n");
-    			nConnectionFailFlag = 1;
-    		}
-    	}
-
-    	/* If we did not fail to ping the broker, publish data */
-    	if(nConnectionFailFlag == 0u)
+    	if(supervisor_online() && ((int32_t)(nNow - nNextPublish) >= 0))
     	{
     		DEBUG_MESSAGE("Publishing data..\n");
 
@@ -319,106 +326,41 @@ static void MQTTPublish(void)
     		gPublishConfig.pMQTTData = (uint8_t *)payload;
     		gPublishConfig.nMQTTDataSize = strlen(payload);
 
-
     		if(adi_wifi_radio_MQTTPublish(&gPublishConfig) == ADI_WIFI_FAILURE)
     		{
-    			nConnectionFailFlag = 1u;
+    			DEBUG_MESSAGE("Troubleshooting failed connection..\n");
+    			supervisor_failure(SUPERVISOR_FAIL_PUBLISH, ui32timer_counter);
+    		}
+    		else
+    		{
+    			supervisor_sent(ui32timer_counter);
+
+    			/* Health counters after every reconnect and every few publishes */
+    			if((supervisor_get_stats(nNow)->reconnects != nReconnects) ||
+    			   (++nPublishCount % ADI_WIFI_LINK_TELEMETRY_PERIOD == 0u))
+    			{
+    				nReconnects = supervisor_get_stats(nNow)->reconnects;
+    				if(PublishLinkHealth() == ADI_WIFI_FAILURE)
+    					supervisor_failure(SUPERVISOR_FAIL_PUBLISH, ui32timer_counter);
+    			}
     		}
     		free(payload);
-    		adi_wifi_DispatchEvents(6000);
-    	}
 
-    	/* If we failed to ping the broker or failed to publish data, check the connection */
-    	if(nConnectionFailFlag == 1u)
-    	{
-    		DEBUG_MESSAGE("Troubleshooting failed connection..\n");
-    		RepairConnection();
+    		gPublishConfig.nPacketId++;
+    		nNextPublish = nNow + ADI_WIFI_PUBLISH_PERIOD;
+    		continue;
     	}
 
-    	gPublishConfig.nPacketId++;
+    	/* Wait for subscribed data until something is due */
+    	if(supervisor_online() && (nNextPublish - nNow) < nWait)
+    		nWait = nNextPublish - nNow;
+    	if(nWait > ADI_WIFI_PUBLISH_PERIOD)
+    		nWait = ADI_WIFI_PUBLISH_PERIOD;
+    	if(nWait != 0u)
+    		adi_wifi_DispatchEvents(nWait);
     }
 }
 
-/*!
- * @brief      Troubleshoot and attempt to fix connection
- *
- * @details    This function is called if the ESP8266 has failed to communicate with the AP or broker.
- *             It will attempt to diagnose and repair the connectivity problem.
- */
-static void RepairConnection()
-{
-	uint8_t         nConnectionStatus;
-
-	adi_wifi_radio_GetConnectionStatus(&nConnectionStatus);
-
-
-	switch(nConnectionStatus)
-	{
-	/*The  Station is connected to an AP and its IP is obtained, so try to connect to broker. */
-	case 2:
-	{
-		/* Send MQTT "CONNECT" message to broker */
-		if(adi_wifi_radio_MQTTConnect(&gMQTTConnect) != ADI_WIFI_SUCCESS)
-		{
-			DEBUG_MESSAGE("Failed to do MQTT Connect\n");
-		}
-		break;
-	}
-
-	/* The  Station has created a TCP or UDP transmission so you should try to publish again. */
-	case 3:
-		break;
-
-		/* The TCP or UDP transmission of Station is disconnected. So try to establish a TCP
-		 * connection and then connect to the broker.
-		 */
-	case 4:
-	{
-		if(adi_wifi_radio_EstablishTCPConnection(&gTCPConnect) == ADI_WIFI_SUCCESS)
-		{
-			if(adi_wifi_radio_MQTTConnect(&gMQTTConnect) != ADI_WIFI_SUCCESS)
-			{
-				DEBUG_MESSAGE("Failed to do MQTT Connect\n");
-			}
-		}
-		else
-		{
-			DEBUG_MESSAGE("Failed to establish connection to broker\n");
-		}
-		break;
-	}
-	/*The  Station does NOT connect to an AP. So try to connect to the AP. */
-	case 5:
-	{
-		if(adi_wifi_radio_ConnectToAP(aWifiSSID, aWifiPassword,  NULL) == ADI_WIFI_SUCCESS)
-		{
-			if(adi_wifi_radio_EstablishTCPConnection(&gTCPConnect) == ADI_WIFI_SUCCESS)
-			{
-				if(adi_wifi_radio_MQTTConnect(&gMQTTConnect) != ADI_WIFI_SUCCESS)
-				{
-					DEBUG_MESSAGE("Failed to do MQTT Connect\n");
-				}
-			}
-			else
-			{
-				DEBUG_MESSAGE("Failed to establish connection to broker\n");
-			}
-
-		}
-		else
-		{
-			DEBUG_MESSAGE("Failed to Connect to AP\n");
-		}
-		break;
-	}
-	default:
-	{
-		break;
-	}
-	}
-
-}
-
 int main(int argc, char *argv[])
 {
 	/**
@@ -80,6 +80,9 @@ uint8_t aMQTTPublisherName[] = "d:0qqed7:C_Client:ADI_GreenHouse";
 uint8_t aMQTTTopicName[] = "iot-2/evt/ADI_GreenHouse_data/fmt/json";
 
 uint8_t aMQTTSubscribeTopic[] = "iot-2/cmd/ADI_GreenHouse_cmd/fmt/json";
+
+/*! Topic of the connection health counters. */
+uint8_t aMQTTLinkTopicName[] = "iot-2/evt/ADI_GreenHouse_link/fmt/json";
                               // iot-2/type/C_Client/id/ADI_GreenHouse/cmd/ADI_GreenHouse_cmd/fmt/json
 
 /*MQTT username*/
@@ -103,4 +106,10 @@ uint8_t aMQTTPassword[] = "KObjoe*OOEOcTEgQvx";
 /*! MQTT publisher <-> broker PING command timeout. */
 #define ADI_WIFI_MQTT_PING_TIMEOUT                 (ADI_WIFI_MQTT_PUBLISHER_KEEPALIVE - 1000u)
 
+/*! Sensor data publish period [ms]. */
+#define ADI_WIFI_PUBLISH_PERIOD                    (6000u)
+
+/*! The connection health counters are published every this many sensor publishes. */
+#define ADI_WIFI_LINK_TELEMETRY_PERIOD             (10u)
+
 #endif /* __ADUCM3029_IBMWATSON_H__ */
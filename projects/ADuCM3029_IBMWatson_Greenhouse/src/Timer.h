@@ -46,7 +46,20 @@
 #ifndef TIMER_H_
 #define TIMER_H_
 
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Milliseconds since timer_start() */
+extern volatile uint32_t ui32timer_counter;
+
 void start_esp_timer_ms(void);
 uint32_t get_esp_timer_ms(void);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* TIMER_H_ */
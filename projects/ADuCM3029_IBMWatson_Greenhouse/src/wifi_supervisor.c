@@ -0,0 +1,300 @@
+/**
+******************************************************************************
+*   @file     wifi_supervisor.c
+*   @brief    Supervises the Wi-Fi, TCP and MQTT connection layers.
+*   @version  V0.1
+*   @author   ADI
+*   @date     October 2026
+*
+*
+*******************************************************************************
+* Copyright 2026(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*********************************************************************************/
+
+#include <stddef.h>
+#include "wifi_supervisor.h"
+
+static const supervisor_config_t *cfg;
+static supervisor_state_t state;
+static supervisor_stats_t stats;
+
+static uint32_t next_attempt;	/* next connect attempt or ping [ms] */
+static uint32_t last_sent;		/* last packet sent to the broker [ms] */
+static uint32_t offline_since;
+static uint32_t backoff;		/* current retry delay without jitter [ms] */
+static uint8_t  retries;		/* failed attempts on the current layer */
+static uint32_t rand_state = 0x2545F491u;
+
+/* Signed difference, correct across the wrap of the ms counter */
+#define TIME_BEFORE(a, b)	((int32_t)((a) - (b)) < 0)
+
+/**
+ * @brief Pseudo random number for the backoff jitter (xorshift32)
+ */
+static uint32_t supervisor_rand(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+/**
+ * @brief Schedule the next attempt after a failure
+ *
+ * The delay doubles after every failure and is drawn from [delay / 2, delay]
+ * so boards that lost the same AP do not retry in lockstep.
+ */
+static void supervisor_backoff(uint32_t now)
+{
+	uint32_t delay;
+
+	if(backoff == 0u)
+		backoff = SUPERVISOR_BACKOFF_MIN_MS;
+	else if(backoff < SUPERVISOR_BACKOFF_MAX_MS / 2u)
+		backoff *= 2u;
+	else
+		backoff = SUPERVISOR_BACKOFF_MAX_MS;
+
+	delay = backoff / 2u + supervisor_rand() % (backoff / 2u + 1u);
+	next_attempt = now + delay;
+}
+
+/**
+ * @brief Record a failure and find the layer to restart from
+ *
+ * AT+CIPSTATUS tells which layer is actually down. After
+ * SUPERVISOR_MAX_RETRIES failures on the same layer the layer below is
+ * restarted too.
+ */
+static void supervisor_fail(supervisor_fail_t cause, uint32_t now)
+{
+	supervisor_state_t layer;
+	uint8_t status;
+
+	stats.failures[cause]++;
+	stats.last_failure = cause;
+
+	if(state == SUPERVISOR_ONLINE)
+		offline_since = now;
+
+	/* 2: got IP, 3: TCP connected, 4: TCP disconnected, 5: no AP */
+	if(adi_wifi_radio_GetConnectionStatus(&status) != ADI_WIFI_SUCCESS)
+		layer = SUPERVISOR_WIFI_DOWN;
+	else if(status == 3u)
+		layer = SUPERVISOR_MQTT_DOWN;
+	else if(status == 2u || status == 4u)
+		layer = SUPERVISOR_TCP_DOWN;
+	else
+		layer = SUPERVISOR_WIFI_DOWN;
+
+	/* A failed attempt leaves the state on the layer that was tried */
+	if(layer > state && state != SUPERVISOR_ONLINE)
+		layer = state;
+
+	if(layer == state) {
+		if(++retries >= SUPERVISOR_MAX_RETRIES && layer > SUPERVISOR_WIFI_DOWN) {
+			layer--;
+			retries = 0u;
+		}
+	} else {
+		retries = 0u;
+	}
+
+	/* Close what is left of the layers above, the broker closes the TCP
+	 * connection on DISCONNECT */
+	if(state == SUPERVISOR_ONLINE ||
+	   (state == SUPERVISOR_MQTT_DOWN && layer < SUPERVISOR_MQTT_DOWN))
+		adi_wifi_radio_MQTTDisconnect(cfg->tcp->nLinkID);
+	if(layer == SUPERVISOR_WIFI_DOWN)
+		adi_wifi_radio_DisconnectFromAP();
+
+	state = layer;
+	supervisor_backoff(now);
+}
+
+/**
+ * @brief Bring up the next layer
+ *
+ * @return ADI_WIFI_SUCCESS if the layer came up
+ */
+static ADI_WIFI_RESULT supervisor_connect(uint32_t now)
+{
+	ADI_WIFI_RESULT eResult = ADI_WIFI_FAILURE;
+
+	switch(state) {
+	case SUPERVISOR_WIFI_DOWN:
+		eResult = adi_wifi_radio_ConnectToAP(cfg->ssid, cfg->password, NULL);
+		if(eResult != ADI_WIFI_SUCCESS)
+			supervisor_fail(SUPERVISOR_FAIL_AP, now);
+		break;
+	case SUPERVISOR_TCP_DOWN:
+		eResult = adi_wifi_radio_EstablishTCPConnection(cfg->tcp);
+		if(eResult != ADI_WIFI_SUCCESS)
+			supervisor_fail(SUPERVISOR_FAIL_TCP, now);
+		break;
+	case SUPERVISOR_MQTT_DOWN:
+		eResult = adi_wifi_radio_MQTTConnect(cfg->mqtt);
+		if(eResult == ADI_WIFI_SUCCESS && cfg->subscribe != NULL)
+			eResult = adi_wifi_radio_MQTTSubscribe(cfg->subscribe);
+		if(eResult != ADI_WIFI_SUCCESS)
+			supervisor_fail(SUPERVISOR_FAIL_MQTT, now);
+		break;
+	default:
+		break;
+	}
+
+	if(eResult == ADI_WIFI_SUCCESS) {
+		state = (supervisor_state_t)(state + 1);
+		retries = 0u;
+		next_attempt = now;
+		if(state == SUPERVISOR_ONLINE) {
+			if(stats.last_failure != SUPERVISOR_FAIL_NONE)
+				stats.reconnects++;
+			stats.offline_ms += now - offline_since;
+			backoff = 0u;
+			last_sent = now;
+		}
+	}
+
+	return eResult;
+}
+
+/**
+ * @brief Start supervising, the first poll joins the access point
+ *
+ * @param config - connection parameters, must stay valid
+ * @param now - current time [ms]
+ */
+void supervisor_init(const supervisor_config_t *config, uint32_t now)
+{
+	uint8_t i;
+
+	cfg = config;
+	state = SUPERVISOR_WIFI_DOWN;
+	retries = 0u;
+	backoff = 0u;
+	next_attempt = now;
+	offline_since = now;
+	rand_state ^= now;
+
+	stats.reconnects = 0u;
+	stats.offline_ms = 0u;
+	for(i = 0u; i < SUPERVISOR_FAIL_NB; i++)
+		stats.failures[i] = 0u;
+	stats.last_failure = SUPERVISOR_FAIL_NONE;
+}
+
+/**
+ * @brief Run the connection attempt or keep-alive ping that is due
+ *
+ * @param now - current time [ms]
+ *
+ * @return time until the next scheduled action [ms]
+ */
+uint32_t supervisor_poll(uint32_t now)
+{
+	/* Bring up all layers whose turn has come */
+	while(state != SUPERVISOR_ONLINE && !TIME_BEFORE(now, next_attempt))
+		if(supervisor_connect(now) != ADI_WIFI_SUCCESS)
+			break;
+
+	if(state == SUPERVISOR_ONLINE) {
+		next_attempt = last_sent + cfg->ping_ms;
+		if(!TIME_BEFORE(now, next_attempt)) {
+			if(adi_wifi_radio_MQTTPing(cfg->mqtt->nLinkID) == ADI_WIFI_SUCCESS)
+				supervisor_sent(now);
+			else
+				supervisor_fail(SUPERVISOR_FAIL_PING, now);
+		}
+	}
+
+	return TIME_BEFORE(now, next_attempt) ? next_attempt - now : 0u;
+}
+
+/**
+ * @brief Check if the MQTT session is up
+ */
+uint8_t supervisor_online(void)
+{
+	return state == SUPERVISOR_ONLINE;
+}
+
+/**
+ * @brief Get the current layer
+ */
+supervisor_state_t supervisor_state(void)
+{
+	return state;
+}
+
+/**
+ * @brief Report a packet sent to the broker, it postpones the next ping
+ *
+ * @param now - current time [ms]
+ */
+void supervisor_sent(uint32_t now)
+{
+	last_sent = now;
+	next_attempt = now + cfg->ping_ms;
+}
+
+/**
+ * @brief Report a failure seen by the application, e.g. a failed publish
+ *
+ * @param cause - failure cause
+ * @param now - current time [ms]
+ */
+void supervisor_failure(supervisor_fail_t cause, uint32_t now)
+{
+	supervisor_fail(cause, now);
+}
+
+/**
+ * @brief Get the health counters, offline time included up to now
+ *
+ * @param now - current time [ms]
+ */
+const supervisor_stats_t *supervisor_get_stats(uint32_t now)
+{
+	static supervisor_stats_t snapshot;
+
+	snapshot = stats;
+	if(state != SUPERVISOR_ONLINE)
+		snapshot.offline_ms += now - offline_since;
+
+	return &snapshot;
+}
@@ -0,0 +1,110 @@
+/**
+******************************************************************************
+*   @file     wifi_supervisor.h
+*   @brief    Header file for the Wi-Fi, TCP and MQTT connection supervisor.
+*   @version  V0.1
+*   @author   ADI
+*   @date     October 2026
+*
+*
+*******************************************************************************
+* Copyright 2026(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*********************************************************************************/
+
+#ifndef __wifi_supervisor_h
+#define __wifi_supervisor_h
+
+#include <stdint.h>
+#include <adi_wifi.h>
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* First retry delay after a failure [ms] */
+#define SUPERVISOR_BACKOFF_MIN_MS      1000u
+/* The retry delay doubles up to this value [ms] */
+#define SUPERVISOR_BACKOFF_MAX_MS      60000u
+/* Failed attempts on a layer before the layer below is restarted */
+#define SUPERVISOR_MAX_RETRIES         3u
+
+/* Connection layers, a layer is only attempted once the one below is up */
+typedef enum {
+	SUPERVISOR_WIFI_DOWN = 0,	/* not joined to the access point */
+	SUPERVISOR_TCP_DOWN,		/* joined, no TCP connection to the broker */
+	SUPERVISOR_MQTT_DOWN,		/* TCP connected, no MQTT session */
+	SUPERVISOR_ONLINE
+} supervisor_state_t;
+
+/* Failure causes */
+typedef enum {
+	SUPERVISOR_FAIL_NONE = 0,
+	SUPERVISOR_FAIL_AP,			/* AP join refused or lost */
+	SUPERVISOR_FAIL_TCP,		/* TCP connect failed or connection reset */
+	SUPERVISOR_FAIL_MQTT,		/* broker refused the MQTT connect */
+	SUPERVISOR_FAIL_PING,		/* keep-alive ping failed */
+	SUPERVISOR_FAIL_PUBLISH,	/* publish failed */
+	SUPERVISOR_FAIL_NB
+} supervisor_fail_t;
+
+/* Health counters, published as telemetry */
+typedef struct {
+	uint32_t reconnects;		/* returns to online after a failure */
+	uint32_t offline_ms;		/* total time spent not online */
+	uint32_t failures[SUPERVISOR_FAIL_NB];	/* failures by cause */
+	uint8_t  last_failure;		/* supervisor_fail_t */
+} supervisor_stats_t;
+
+typedef struct {
+	const uint8_t *ssid;
+	const uint8_t *password;
+	ADI_WIFI_TCP_CONNECT_CONFIG *tcp;
+	ADI_WIFI_MQTT_CONNECT_CONFIG *mqtt;
+	ADI_WIFI_SUBSCRIBE_CONFIG *subscribe;	/* NULL if nothing to subscribe */
+	uint32_t ping_ms;			/* PINGREQ after this idle time [ms] */
+} supervisor_config_t;
+
+void supervisor_init(const supervisor_config_t *config, uint32_t now);
+uint32_t supervisor_poll(uint32_t now);
+uint8_t supervisor_online(void);
+supervisor_state_t supervisor_state(void);
+void supervisor_sent(uint32_t now);
+void supervisor_failure(supervisor_fail_t cause, uint32_t now);
+const supervisor_stats_t *supervisor_get_stats(uint32_t now);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* __wifi_supervisor_h */
@@ -0,0 +1,70 @@
+/**
+******************************************************************************
+*   @file     adi_wifi.h
+*   @brief    Host stand-in for the ESP8266 driver API used by the supervisor.
+*   @version  V0.1
+*   @author   ADI
+*   @date     October 2026
+*
+*
+*******************************************************************************
+* Copyright 2026(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*********************************************************************************/
+
+#ifndef __adi_wifi_h
+#define __adi_wifi_h
+
+#include <stdint.h>
+
+typedef enum {
+	ADI_WIFI_SUCCESS,
+	ADI_WIFI_FAILURE
+} ADI_WIFI_RESULT;
+
+typedef struct { uint32_t nLinkID; } ADI_WIFI_TCP_CONNECT_CONFIG;
+typedef struct { uint32_t nLinkID; } ADI_WIFI_MQTT_CONNECT_CONFIG;
+typedef struct { uint32_t nLinkID; } ADI_WIFI_SUBSCRIBE_CONFIG;
+
+ADI_WIFI_RESULT adi_wifi_radio_GetConnectionStatus(uint8_t *pStatus);
+ADI_WIFI_RESULT adi_wifi_radio_ConnectToAP(const uint8_t * const pSSID,
+		const uint8_t * const pPassword, const uint8_t * const pMacAddress);
+ADI_WIFI_RESULT adi_wifi_radio_DisconnectFromAP(void);
+ADI_WIFI_RESULT adi_wifi_radio_EstablishTCPConnection(ADI_WIFI_TCP_CONNECT_CONFIG *pConfig);
+ADI_WIFI_RESULT adi_wifi_radio_MQTTConnect(ADI_WIFI_MQTT_CONNECT_CONFIG *pConfig);
+ADI_WIFI_RESULT adi_wifi_radio_MQTTSubscribe(ADI_WIFI_SUBSCRIBE_CONFIG *pConfig);
+ADI_WIFI_RESULT adi_wifi_radio_MQTTDisconnect(uint32_t nLinkID);
+ADI_WIFI_RESULT adi_wifi_radio_MQTTPing(uint32_t nLinkID);
+
+#endif /* __adi_wifi_h */
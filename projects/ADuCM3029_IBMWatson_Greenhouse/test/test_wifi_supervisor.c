@@ -0,0 +1,269 @@
+/**
+******************************************************************************
+*   @file     test_wifi_supervisor.c
+*   @brief    Host test of the connection supervisor against an ESP8266 model.
+*   @version  V0.1
+*   @author   ADI
+*   @date     October 2026
+*
+*
+*******************************************************************************
+* Copyright 2026(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+* SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*********************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "wifi_supervisor.h"
+
+/* AT commands that fail wait for the driver timeout [ms] */
+#define AT_TIMEOUT_MS		10000u
+/* Publish period of the application [ms] */
+#define PUBLISH_MS			6000u
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+/******************************** ESP8266 model *******************************/
+
+static uint32_t now;
+static uint32_t at_cmds;
+static uint8_t ap_available = 1, broker_refuses;
+static uint8_t ap_joined, tcp_open, mqtt_open;
+
+static ADI_WIFI_RESULT at_cmd(uint32_t duration, uint8_t ok)
+{
+	at_cmds++;
+	now += ok ? duration : AT_TIMEOUT_MS;
+
+	return ok ? ADI_WIFI_SUCCESS : ADI_WIFI_FAILURE;
+}
+
+ADI_WIFI_RESULT adi_wifi_radio_GetConnectionStatus(uint8_t *pStatus)
+{
+	/* CIPSTATUS: 3 connected, 4 disconnected, 5 not joined */
+	*pStatus = !ap_joined ? 5 : tcp_open ? 3 : 4;
+
+	return at_cmd(20, 1);
+}
+
+ADI_WIFI_RESULT adi_wifi_radio_ConnectToAP(const uint8_t * const pSSID,
+		const uint8_t * const pPassword, const uint8_t * const pMacAddress)
+{
+	ap_joined = ap_available;
+
+	return at_cmd(3000, ap_joined);
+}
+
+ADI_WIFI_RESULT adi_wifi_radio_DisconnectFromAP(void)
+{
+	ap_joined = tcp_open = mqtt_open = 0;
+
+	return at_cmd(50, 1);
+}
+
+ADI_WIFI_RESULT adi_wifi_radio_EstablishTCPConnection(ADI_WIFI_TCP_CONNECT_CONFIG *pConfig)
+{
+	uint8_t ok = ap_joined && !tcp_open;
+
+	if (ok)
+		tcp_open = 1;
+
+	return at_cmd(400, ok);
+}
+
+ADI_WIFI_RESULT adi_wifi_radio_MQTTConnect(ADI_WIFI_MQTT_CONNECT_CONFIG *pConfig)
+{
+	uint8_t ok = tcp_open && !broker_refuses;
+
+	if (ok)
+		mqtt_open = 1;
+	else if (broker_refuses)
+		tcp_open = 0;	/* the broker closes the socket */
+
+	return at_cmd(300, ok);
+}
+
+ADI_WIFI_RESULT adi_wifi_radio_MQTTSubscribe(ADI_WIFI_SUBSCRIBE_CONFIG *pConfig)
+{
+	return at_cmd(200, mqtt_open);
+}
+
+ADI_WIFI_RESULT adi_wifi_radio_MQTTDisconnect(uint32_t nLinkID)
+{
+	tcp_open = mqtt_open = 0;
+
+	return at_cmd(50, 1);
+}
+
+ADI_WIFI_RESULT adi_wifi_radio_MQTTPing(uint32_t nLinkID)
+{
+	return at_cmd(100, mqtt_open);
+}
+
+/****************************** Application model *****************************/
+
+static ADI_WIFI_TCP_CONNECT_CONFIG tcp_config;
+static ADI_WIFI_MQTT_CONNECT_CONFIG mqtt_config;
+static ADI_WIFI_SUBSCRIBE_CONFIG subscribe_config;
+static const supervisor_config_t config = {
+	(const uint8_t *)"ssid", (const uint8_t *)"password",
+	&tcp_config, &mqtt_config, &subscribe_config, 6200
+};
+static uint32_t next_publish, last_published;
+
+/* Publish loop of the greenhouse application, waits as told by the supervisor */
+static void run_until(uint32_t end)
+{
+	uint32_t wait;
+
+	while ((int32_t)(now - end) < 0) {
+		wait = supervisor_poll(now);
+		if (supervisor_online() && (int32_t)(now - next_publish) >= 0) {
+			at_cmds++;
+			if (mqtt_open) {
+				now += 150;
+				supervisor_sent(now);
+				last_published = now;
+			} else {
+				now += AT_TIMEOUT_MS;
+				supervisor_failure(SUPERVISOR_FAIL_PUBLISH, now);
+			}
+			next_publish = now + PUBLISH_MS;
+			continue;
+		}
+		if (supervisor_online() && next_publish - now < wait)
+			wait = next_publish - now;
+		if (wait > PUBLISH_MS)
+			wait = PUBLISH_MS;
+		now += wait;
+	}
+}
+
+/* Run an outage, returns the time from the repair to the next publish [ms] */
+static uint32_t outage(void (*inject)(void), void (*repair)(void), uint32_t duration)
+{
+	uint32_t repaired;
+
+	run_until(now + 30000);
+	inject();
+	run_until(now + duration);
+	if (repair)
+		repair();
+	repaired = now;
+	while (!(supervisor_online() && (int32_t)(last_published - repaired) > 0))
+		run_until(now + 100);
+
+	return last_published - repaired;
+}
+
+static void ap_lost(void)
+{
+	ap_available = 0;
+	ap_joined = tcp_open = mqtt_open = 0;
+}
+
+static void ap_back(void)
+{
+	ap_available = 1;
+}
+
+static void tcp_reset(void)
+{
+	tcp_open = mqtt_open = 0;
+}
+
+static void broker_refusing(void)
+{
+	broker_refuses = 1;
+	tcp_open = mqtt_open = 0;
+}
+
+static void broker_accepting(void)
+{
+	broker_refuses = 0;
+}
+
+int main(void)
+{
+	const supervisor_stats_t *stats;
+	uint32_t back, cmds, ap_failures;
+
+	supervisor_init(&config, now);
+	run_until(20000);
+	CHECK(supervisor_online());
+	CHECK(supervisor_state() == SUPERVISOR_ONLINE);
+
+	/* A short AP loss is repaired from the Wi-Fi layer up */
+	back = outage(ap_lost, ap_back, 60000);
+	stats = supervisor_get_stats(now);
+	CHECK(back < SUPERVISOR_BACKOFF_MAX_MS);
+	CHECK(stats->reconnects == 1);
+	CHECK(stats->failures[SUPERVISOR_FAIL_AP] > 0);
+
+	/* A TCP reset is found by the next publish and repaired quickly */
+	ap_failures = stats->failures[SUPERVISOR_FAIL_AP];
+	back = outage(tcp_reset, NULL, 1);
+	stats = supervisor_get_stats(now);
+	CHECK(back < 2 * PUBLISH_MS);
+	CHECK(stats->reconnects == 2);
+	CHECK(stats->failures[SUPERVISOR_FAIL_AP] == ap_failures);
+
+	/* A refusing broker is retried at the MQTT layer */
+	outage(broker_refusing, broker_accepting, 45000);
+	stats = supervisor_get_stats(now);
+	CHECK(stats->reconnects == 3);
+	CHECK(stats->failures[SUPERVISOR_FAIL_MQTT] > 0);
+	CHECK(stats->last_failure != SUPERVISOR_FAIL_NONE);
+
+	/* A long AP loss is retried at the maximum backoff, not in a busy loop */
+	cmds = at_cmds;
+	back = outage(ap_lost, ap_back, 600000);
+	stats = supervisor_get_stats(now);
+	CHECK(at_cmds - cmds < 100);
+	CHECK(back < SUPERVISOR_BACKOFF_MAX_MS);
+	CHECK(stats->reconnects == 4);
+	CHECK(stats->offline_ms >= 600000);
+	CHECK(stats->offline_ms < now);
+
+	printf("%s\n", failures ? "FAILED" : "OK");
+
+	return failures ? 1 : 0;
+}
@@ -68,6 +68,21 @@ int32_t ad5592r_base_reg_read(struct ad5592r_dev *dev, uint8_t reg,
 	return dev->ops->reg_read(dev, reg, value);
 }
 
+/**
+ * Read a sequence of ADC channels.
+ *
+ * @param dev - The device structure.
+ * @param chan_mask - Mask of the channels to be converted.
+ * @param values - Array of 8 elements, indexed by channel number, where the
+ *                 ADC codes are stored.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t ad5592r_base_read_adc_seq(struct ad5592r_dev *dev, uint8_t chan_mask,
+				  uint16_t *values)
+{
+	return dev->ops->read_adc_seq(dev, chan_mask, values);
+}
+
 /**
  * Get GPIO value
  *
@@ -74,6 +74,10 @@ enum ad5592r_registers {
 };
 
 #define AD5592R_REG_PD_EN_REF		BIT(9)
+#define AD5592R_REG_ADC_SEQ_REP		BIT(9)
+#define AD5592R_REG_ADC_SEQ_TEMP_READBACK	BIT(8)
+#define AD5592R_REG_ADC_SEQ_CODE_MSK(x)	((x) & 0x0FFF)
+#define AD5592R_REG_ADC_SEQ_CHAN(x)	(((x) >> 12) & 0x07)
 #define AD5592R_REG_CTRL_ADC_RANGE	BIT(5)
 #define AD5592R_REG_CTRL_DAC_RANGE	BIT(4)
 
@@ -89,6 +93,8 @@ struct ad5592r_rw_ops {
 	int32_t (*reg_read)(struct ad5592r_dev *dev, uint8_t reg,
 			    uint16_t *value);
 	int32_t (*gpio_read)(struct ad5592r_dev *dev, uint8_t *value);
+	int32_t (*read_adc_seq)(struct ad5592r_dev *dev, uint8_t chan_mask,
+				uint16_t *values);
 };
 
 struct ad5592r_init_param {
@@ -103,6 +109,7 @@ struct ad5592r_dev {
 	uint8_t num_channels;
 	uint16_t cached_dac[8];
 	uint16_t cached_gp_ctrl;
+	uint16_t cached_adc_seq;
 	uint8_t channel_modes[8];
 	uint8_t channel_offstate[8];
 	uint8_t gpio_map;
@@ -115,6 +122,8 @@ int32_t ad5592r_base_reg_write(struct ad5592r_dev *dev, uint8_t reg,
 			       uint16_t value);
 int32_t ad5592r_base_reg_read(struct ad5592r_dev *dev, uint8_t reg,
 			      uint16_t *value);
+int32_t ad5592r_base_read_adc_seq(struct ad5592r_dev *dev, uint8_t chan_mask,
+				  uint16_t *values);
 int32_t ad5592r_gpio_get(struct ad5592r_dev *dev, uint8_t offset);
 int32_t ad5592r_gpio_set(struct ad5592r_dev *dev, uint8_t offset,
 			 int32_t value);
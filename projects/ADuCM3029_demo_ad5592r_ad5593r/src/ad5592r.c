@@ -46,6 +46,7 @@ const struct ad5592r_rw_ops ad5592r_rw_ops = {
 	.reg_write = ad5592r_reg_write,
 	.reg_read = ad5592r_reg_read,
 	.gpio_read = ad5592r_gpio_read,
+	.read_adc_seq = ad5592r_read_adc_seq,
 };
 
 /**
@@ -84,6 +85,7 @@ int32_t ad5592r_write_dac(struct ad5592r_dev *dev, uint8_t chan,
 	if (!dev)
 		return FAILURE;
 
+	dev->cached_adc_seq = 0;
 	dev->spi_msg = swab16( BIT(15) | (uint16_t)(chan << 12) | value);
 
 	return spi_write_and_read(dev->spi, (uint8_t *)&dev->spi_msg,
@@ -106,6 +108,7 @@ int32_t ad5592r_read_adc(struct ad5592r_dev *dev, uint8_t chan,
 	if (!dev)
 		return FAILURE;
 
+	dev->cached_adc_seq = 0;
 	dev->spi_msg = swab16((uint16_t)(AD5592R_REG_ADC_SEQ << 11) |
 			      BIT(chan));
 
@@ -131,6 +134,69 @@ int32_t ad5592r_read_adc(struct ad5592r_dev *dev, uint8_t chan,
 	return 0;
 }
 
+/**
+ * Read a sequence of ADC channels.
+ *
+ * The ADC sequence register is programmed once with all the channels in the
+ * mask and the REP bit set, so every following NOP frame returns the next
+ * conversion of the sequence. The register is only written again when the
+ * channel mask changes or another command broke the running sequence.
+ * Results are placed in the output array by the channel tag of each frame.
+ *
+ * @param dev - The device structure.
+ * @param chan_mask - Mask of the channels to be converted.
+ * @param values - Array of 8 elements, indexed by channel number, where the
+ *                 12-bit ADC codes are stored.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t ad5592r_read_adc_seq(struct ad5592r_dev *dev, uint8_t chan_mask,
+			     uint16_t *values)
+{
+	int32_t ret;
+	uint16_t seq = AD5592R_REG_ADC_SEQ_REP | chan_mask;
+	uint8_t i, nr_chan = 0;
+
+	if (!dev || !values || !chan_mask)
+		return FAILURE;
+
+	if (dev->cached_adc_seq != seq) {
+		dev->spi_msg = swab16((uint16_t)(AD5592R_REG_ADC_SEQ << 11) |
+				      seq);
+
+		ret = spi_write_and_read(dev->spi, (uint8_t *)&dev->spi_msg,
+					 sizeof(dev->spi_msg));
+		if (ret < 0)
+			return ret;
+
+		/*
+		 * Invalid data:
+		 * See Figure 41. Multichannel ADC Conversion Sequence
+		 */
+		ret = ad5592r_spi_wnop_r16(dev, &dev->spi_msg);
+		if (ret < 0)
+			return ret;
+
+		dev->cached_adc_seq = seq;
+	}
+
+	for (i = 0; i < 8; i++)
+		if (chan_mask & BIT(i))
+			nr_chan++;
+
+	for (i = 0; i < nr_chan; i++) {
+		ret = ad5592r_spi_wnop_r16(dev, &dev->spi_msg);
+		if (ret < 0) {
+			dev->cached_adc_seq = 0;
+			return ret;
+		}
+
+		values[AD5592R_REG_ADC_SEQ_CHAN(dev->spi_msg)] =
+			AD5592R_REG_ADC_SEQ_CODE_MSK(dev->spi_msg);
+	}
+
+	return 0;
+}
+
 /**
  * Write register.
  *
@@ -144,6 +210,7 @@ int32_t ad5592r_reg_write(struct ad5592r_dev *dev, uint8_t reg, uint16_t value)
 	if (!dev)
 		return FAILURE;
 
+	dev->cached_adc_seq = 0;
 	dev->spi_msg = swab16((reg << 11) | value);
 
 	return spi_write_and_read(dev->spi, (uint8_t *)&dev->spi_msg,
@@ -165,6 +232,7 @@ int32_t ad5592r_reg_read(struct ad5592r_dev *dev, uint8_t reg, uint16_t *value)
 	if (!dev)
 		return FAILURE;
 
+	dev->cached_adc_seq = 0;
 	dev->spi_msg = swab16((AD5592R_REG_LDAC << 11) |
 			      AD5592R_LDAC_READBACK_EN | (reg << 2));
 
@@ -54,6 +54,7 @@ const struct ad5592r_rw_ops ad5593r_rw_ops = {
 	.reg_write = ad5593r_reg_write,
 	.reg_read = ad5593r_reg_read,
 	.gpio_read = ad5593r_gpio_read,
+	.read_adc_seq = ad5593r_read_adc_seq,
 };
 
 /**
@@ -97,6 +98,7 @@ int32_t ad5593r_read_adc(struct ad5592r_dev *dev, uint8_t chan,
 	if (!dev)
 		return FAILURE;
 
+	dev->cached_adc_seq = 0;
 	temp = BIT(chan);
 
 	data[0] = AD5593R_MODE_CONF | AD5592R_REG_ADC_SEQ;
@@ -121,6 +123,66 @@ int32_t ad5593r_read_adc(struct ad5592r_dev *dev, uint8_t chan,
 	return 0;
 }
 
+/**
+ * Read a sequence of ADC channels.
+ *
+ * The ADC sequence register is programmed with all the channels in the mask
+ * and the REP bit set only when the mask changes. The whole sequence is then
+ * read back in a single I2C read transaction. Results are placed in the
+ * output array by the channel tag of each conversion word.
+ *
+ * @param dev - The device structure.
+ * @param chan_mask - Mask of the channels to be converted.
+ * @param values - Array of 8 elements, indexed by channel number, where the
+ *                 12-bit ADC codes are stored.
+ * @return 0 in case of success, negative error code otherwise
+ */
+int32_t ad5593r_read_adc_seq(struct ad5592r_dev *dev, uint8_t chan_mask,
+			     uint16_t *values)
+{
+	int32_t ret;
+	uint8_t data[16];
+	uint16_t seq = AD5592R_REG_ADC_SEQ_REP | chan_mask;
+	uint16_t sample;
+	uint8_t i, nr_chan = 0;
+
+	if (!dev || !values || !chan_mask)
+		return FAILURE;
+
+	if (dev->cached_adc_seq != seq) {
+		data[0] = AD5593R_MODE_CONF | AD5592R_REG_ADC_SEQ;
+		data[1] = seq >> 8;
+		data[2] = seq & 0xFF;
+
+		ret = i2c_write(dev->i2c, data, 3, 0);
+		if (ret < 0)
+			return ret;
+
+		dev->cached_adc_seq = seq;
+	}
+
+	for (i = 0; i < 8; i++)
+		if (chan_mask & BIT(i))
+			nr_chan++;
+
+	data[0] = AD5593R_MODE_ADC_READBACK;
+	ret = i2c_write(dev->i2c, data, 1, 0);
+	if (ret < 0)
+		return ret;
+
+	ret = i2c_read(dev->i2c, data, nr_chan * 2, 0);
+	if (ret < 0)
+		return ret;
+
+	for (i = 0; i < nr_chan; i++) {
+		sample = (uint16_t)(data[2 * i] << 8) + data[2 * i + 1];
+		values[AD5592R_REG_ADC_SEQ_CHAN(sample)] =
+			AD5592R_REG_ADC_SEQ_CODE_MSK(sample);
+	}
+
+	return 0;
+}
+
 /**
  * Write register.
  *
@@ -137,6 +199,7 @@ int32_t ad5593r_reg_write(struct ad5592r_dev *dev, uint8_t reg,
 	if (!dev)
 		return FAILURE;
 
+	dev->cached_adc_seq = 0;
 	data[0] = AD5593R_MODE_CONF | reg;
 	data[1] = value >> 8;
 	data[2] = value;
@@ -46,6 +46,8 @@ int32_t ad5593r_write_dac(struct ad5592r_dev *dev, uint8_t chan,
 			  uint16_t value);
 int32_t ad5593r_read_adc(struct ad5592r_dev *dev, uint8_t chan,
 			 uint16_t *value);
+int32_t ad5593r_read_adc_seq(struct ad5592r_dev *dev, uint8_t chan_mask,
+			     uint16_t *values);
 int32_t ad5593r_reg_write(struct ad5592r_dev *dev, uint8_t reg,
 			  uint16_t value);
 int32_t ad5593r_reg_read(struct ad5592r_dev *dev, uint8_t reg,
@@ -286,6 +286,7 @@ static inline int32_t aiodio_detect_device(struct aiodio_dev *dev,
 	temp->reg_read = ad5592r_rw_ops.reg_read;
 	temp->reg_write = ad5592r_rw_ops.reg_write;
 	temp->write_dac = ad5592r_rw_ops.write_dac;
+	temp->read_adc_seq = ad5592r_rw_ops.read_adc_seq;
 	dev->read_adc = &ad5592r_read_adc;
 	dev->write_dac = &ad5592r_write_dac;
 
@@ -300,6 +301,7 @@ static inline int32_t aiodio_detect_device(struct aiodio_dev *dev,
 	temp->reg_read = ad5593r_rw_ops.reg_read;
 	temp->reg_write = ad5593r_rw_ops.reg_write;
 	temp->write_dac = ad5593r_rw_ops.write_dac;
+	temp->read_adc_seq = ad5593r_rw_ops.read_adc_seq;
 	dev->read_adc = &ad5593r_read_adc;
 	dev->write_dac = &ad5593r_write_dac;
 
@@ -744,12 +746,17 @@ static inline int32_t aiodio_help_mode_commands(struct aiodio_dev *dev,
 			return ret;
 		ret = usr_uart_write_string(dev->board_cli->uart_device,
 					    (uint8_t*)
-					    " analog_in_stream <ch_no> - Start ADC streaming mode. It streams data from the selected channel.\n");
+					    " analog_in_stream <ch_no> [rate] - Start ADC streaming mode. It streams data from the selected channel.\n");
+		if(ret != 0)
+			return ret;
+		ret = usr_uart_write_string(dev->board_cli->uart_device,
+					    (uint8_t*)
+					    "                            <ch_no> - Number of the channel to be streamed or 'a' to stream all channels.\n");
 		if(ret != 0)
 			return ret;
 		return usr_uart_write_string(dev->board_cli->uart_device,
 					     (uint8_t*)
-					     "                            <ch_no> - Number of the channel to be streamed or 'a' to stream all channels.\n");
+					     "                            [rate] - Scan rate in Hz (0-1000, 0 = as fast as possible). Default is 2 Hz.\n");
 	} else {
 		ret = usr_uart_write_string(dev->board_cli->uart_device,
 					    (uint8_t*)
@@ -816,12 +823,17 @@ static inline int32_t aiodio_help_mode_commands(struct aiodio_dev *dev,
 			return ret;
 		ret = usr_uart_write_string(dev->board_cli->uart_device,
 					    (uint8_t*)
-					    " ais <ch_no>     - Start ADC streaming mode. It streams data from the selected channel.\n");
+					    " ais <ch_no> [rate] - Start ADC streaming mode. It streams data from the selected channel.\n");
+		if(ret != 0)
+			return ret;
+		ret = usr_uart_write_string(dev->board_cli->uart_device,
+					    (uint8_t*)
+					    "                   <ch_no> - Number of the channel to be streamed or 'a' to stream all channels.\n");
 		if(ret != 0)
 			return ret;
 		return usr_uart_write_string(dev->board_cli->uart_device,
 					     (uint8_t*)
-					     "                   <ch_no> - Number of the channel to be streamed or 'a' to stream all channels.\n");
+					     "                   [rate] - Scan rate in Hz (0-1000, 0 = as fast as possible). Default is 2 Hz.\n");
 	}
 }
 
@@ -1578,13 +1590,9 @@ int32_t aiodio_process(struct aiodio_dev *dev)
 {
 	int32_t ret;
 
-	NVIC_DisableIRQ(TMR0_INT);
-	NVIC_DisableIRQ(TMR1_INT);
 	ret = cli_process(dev->board_cli);
 	if(ret != 0)
 		return ret;
-	NVIC_EnableIRQ(TMR0_INT);
-	NVIC_EnableIRQ(TMR1_INT);
 
 	if(dev->mirror_mode && mode_timer_flag) {
 		ret = aiodio_process_mirror(dev);
@@ -1602,24 +1610,114 @@ int32_t aiodio_process(struct aiodio_dev *dev)
 }
 
 /**
- * Stream input data from all ADC inputs.
+ * Check if the user requested to stop streaming.
  *
- * If and input is not ADC it will place "N/A" in the place if its values.
+ * aiodio_analog_in_stream() helper function.
  *
  * @param [in] dev - The device structure.
  *
+ * @return true if 'q' was received, false otherwise.
+ */
+static bool aiodio_stream_abort(struct aiodio_dev *dev)
+{
+	uint8_t exit_char, rdy;
+
+	usr_uart_read_char(dev->board_cli->uart_device, &exit_char,
+			   &rdy, UART_NON_BLOCKING);
+
+	return (rdy && (exit_char == 'q'));
+}
+
+/**
+ * Wait for the time slot of the next scan.
+ *
+ * The deadline is computed from the start of the stream and the number of
+ * scans done so far, so rounding of the period does not accumulate. A rate of
+ * 0 means that the scans are done back to back.
+ * aiodio_analog_in_stream() helper function.
+ *
+ * @param [in] dev   - The device structure.
+ * @param [in] rate  - Scan rate in Hz.
+ * @param [in] start - Stream start time in miliseconds.
+ * @param [in] scans - Number of scans done so far.
+ *
+ * @return true if the user aborted the stream while waiting, false otherwise.
+ */
+static bool aiodio_stream_wait(struct aiodio_dev *dev, uint32_t rate,
+			       uint32_t start, uint32_t scans)
+{
+	uint32_t deadline;
+
+	if(rate == 0)
+		return aiodio_stream_abort(dev);
+
+	deadline = start + (uint32_t)(((uint64_t)scans * 1000) / rate);
+	do {
+		if(aiodio_stream_abort(dev))
+			return true;
+	} while((int32_t)(timer_get_ms() - deadline) < 0);
+
+	return false;
+}
+
+/**
+ * Display the achieved scan rate at the end of a stream.
+ *
+ * aiodio_analog_in_stream() helper function.
+ *
+ * @param [in] dev     - The device structure.
+ * @param [in] start   - Stream start time in miliseconds.
+ * @param [in] scans   - Number of scans done.
+ * @param [in] dropped - Number of scans not displayed because the UART
+ *                       transmit buffer was full.
+ *
  * @return 0 in case of success, negative error code otherwise.
  */
-static int32_t aiodio_analog_in_stream_all(struct aiodio_dev *dev)
+static int32_t aiodio_stream_report(struct aiodio_dev *dev, uint32_t start,
+				    uint32_t scans, uint32_t dropped)
 {
-	uint8_t i = 0, exit_char, rdy;
-	uint8_t buff[20];
-	uint16_t adc_val;
+	uint8_t buff[100];
+	uint32_t elapsed = timer_get_ms() - start;
+	float rate = 0;
+
+	if(elapsed != 0)
+		rate = (float)scans * 1000 / elapsed;
+
+	sprintf((char *)buff,
+		"\nUser abort. %lu scans in %lu ms (%.2f Hz), %lu not displayed.\n",
+		scans, elapsed, rate, dropped);
+
+	return usr_uart_write_string(dev->board_cli->uart_device, buff);
+}
+
+/**
+ * Stream input data from all ADC inputs.
+ *
+ * All ADC channels are converted in a single sequence per scan. If and input
+ * is not ADC it will place "N/A" in the place if its values. Each scan is
+ * displayed as one line queued without waiting for the UART, so a slow
+ * terminal drops lines instead of slowing down the scan rate.
+ *
+ * @param [in] dev  - The device structure.
+ * @param [in] rate - Scan rate in Hz, 0 for back to back scans.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t aiodio_analog_in_stream_all(struct aiodio_dev *dev,
+		uint32_t rate)
+{
+	int32_t ret;
+	uint8_t i, chan_mask = 0;
+	uint8_t buff[20], line[AIODIO_STREAM_LINE_SIZE];
+	uint16_t adc_val[8] = {0};
+	uint32_t start, scans = 0, dropped = 0, len;
 	float lsb_val = AD5592_3_INTERNAL_REFERENCE /
 			pow(2, AD5592_3_RESOLUTION_BITS);
 	float volt_val;
 
 	for(i = 0; i < 8; i++) {
+		if(dev->board_device->channel_modes[i] == CH_MODE_ADC)
+			chan_mask |= BIT(i);
 		itoa(i, (char *)buff, 10);
 		usr_uart_write_string(dev->board_cli->uart_device, (uint8_t*)"CH");
 		usr_uart_write_string(dev->board_cli->uart_device, buff);
@@ -1627,30 +1725,32 @@ static int32_t aiodio_analog_in_stream_all(struct aiodio_dev *dev)
 	}
 	usr_uart_write_string(dev->board_cli->uart_device, (uint8_t*)"\n");
 
-	i = 0;
+	start = timer_get_ms();
 	while(1) {
-		if(dev->board_device->channel_modes[i] != CH_MODE_ADC) {
-			usr_uart_write_string(dev->board_cli->uart_device,
-					      (uint8_t*)"N/A ");
-		} else {
-			dev->read_adc(dev->board_device, i, &adc_val);
-			adc_val &= 0xfff;
-			volt_val = lsb_val * adc_val;
-			sprintf((char *)buff, "%.8f", volt_val);
-			usr_uart_write_string(dev->board_cli->uart_device, buff);
-			usr_uart_write_string(dev->board_cli->uart_device, (uint8_t*)" ");
+		if(chan_mask) {
+			ret = ad5592r_base_read_adc_seq(dev->board_device,
+							chan_mask, adc_val);
+			if(ret != 0)
+				return ret;
 		}
-		i++;
-		if(i >= 8) {
-			i = 0;
-			usr_uart_write_string(dev->board_cli->uart_device, (uint8_t*)"\n");
-			mdelay(500);
+		scans++;
+
+		len = 0;
+		for(i = 0; i < 8; i++) {
+			if(!(chan_mask & BIT(i))) {
+				len += sprintf((char *)line + len, "N/A ");
+				continue;
+			}
+			volt_val = lsb_val * adc_val[i];
+			len += sprintf((char *)line + len, "%.8f ", volt_val);
 		}
-		usr_uart_read_char(dev->board_cli->uart_device, &exit_char,
-				   &rdy, UART_NON_BLOCKING);
-		if((rdy) && (exit_char == 'q'))
-			return usr_uart_write_string(dev->board_cli->uart_device,
-						     (uint8_t*)"\nUser abort.\n");
+		sprintf((char *)line + len, "\n");
+		if(usr_uart_write_string_nonblocking(dev->board_cli->uart_device,
+						     line) == UART_NO_TX_SPACE)
+			dropped++;
+
+		if(aiodio_stream_wait(dev, rate, start, scans))
+			return aiodio_stream_report(dev, start, scans, dropped);
 	}
 }
 
@@ -1661,15 +1761,17 @@ static int32_t aiodio_analog_in_stream_all(struct aiodio_dev *dev)
  *
  * @param [in] dev     - The device structure.
  * @param [in] chan_no - Channel number.
+ * @param [in] rate    - Scan rate in Hz, 0 for back to back scans.
  *
  * @return 0 in case of success, negative error code otherwise.
  */
 static int32_t aiodio_analog_in_stream_chan(struct aiodio_dev *dev,
-		uint8_t chan_no)
+		uint8_t chan_no, uint32_t rate)
 {
-	uint8_t exit_char, rdy;
+	int32_t ret;
 	uint8_t buff[20];
-	uint16_t adc_val;
+	uint16_t adc_val[8] = {0};
+	uint32_t start, scans = 0, dropped = 0;
 	float lsb_val = AD5592_3_INTERNAL_REFERENCE /
 			pow(2, AD5592_3_RESOLUTION_BITS);
 	float volt_val;
@@ -1683,20 +1785,22 @@ static int32_t aiodio_analog_in_stream_chan(struct aiodio_dev *dev,
 	usr_uart_write_string(dev->board_cli->uart_device, buff);
 	usr_uart_write_string(dev->board_cli->uart_device, (uint8_t*)"\n");
 
+	start = timer_get_ms();
 	while(1) {
-		dev->read_adc(dev->board_device, chan_no, &adc_val);
-		adc_val &= 0xfff;
-		volt_val = lsb_val * adc_val;
-		sprintf((char *)buff, "%.8f", volt_val);
-		usr_uart_write_string(dev->board_cli->uart_device, buff);
-		usr_uart_write_string(dev->board_cli->uart_device, (uint8_t*)"\n");
+		ret = ad5592r_base_read_adc_seq(dev->board_device, BIT(chan_no),
+						adc_val);
+		if(ret != 0)
+			return ret;
+		scans++;
 
-		usr_uart_read_char(dev->board_cli->uart_device, &exit_char,
-				   &rdy, UART_NON_BLOCKING);
-		if((rdy) && (exit_char == 'q'))
-			return usr_uart_write_string(dev->board_cli->uart_device,
-						     (uint8_t*)"\nUser abort.\n");
-		mdelay(500);
+		volt_val = lsb_val * adc_val[chan_no];
+		sprintf((char *)buff, "%.8f\n", volt_val);
+		if(usr_uart_write_string_nonblocking(dev->board_cli->uart_device,
+						     buff) == UART_NO_TX_SPACE)
+			dropped++;
+
+		if(aiodio_stream_wait(dev, rate, start, scans))
+			return aiodio_stream_report(dev, start, scans, dropped);
 	}
 }
 
@@ -1704,7 +1808,9 @@ static int32_t aiodio_analog_in_stream_chan(struct aiodio_dev *dev,
  * Stream input data from the ADC inputs.
  *
  * @param [in] dev - The device structure.
- * @param [in] arg - The number of the channel (0-7) all (a).
+ * @param [in] arg - The number of the channel (0-7) all (a), optionally
+ *                   followed by the scan rate in Hz (0 for back to back
+ *                   scans).
  *
  * @return 0 in case of success, negative error code otherwise.
  */
@@ -1712,15 +1818,29 @@ int32_t aiodio_analog_in_stream(struct aiodio_dev *dev, uint8_t *arg)
 {
 	int32_t ret;
 	uint8_t chan_no;
+	uint32_t rate = AIODIO_STREAM_DEFAULT_RATE;
+	char *rate_arg;
+
+	if(!arg)
+		return usr_uart_write_string(dev->board_cli->uart_device,
+					     (uint8_t *)"Input must be between 0 and 7 or 'a' for all.\n");
+
+	rate_arg = strchr((char *)arg, ' ');
+	if(rate_arg) {
+		rate = atoi(rate_arg + 1);
+		if(rate > AIODIO_STREAM_MAX_RATE)
+			return usr_uart_write_string(dev->board_cli->uart_device,
+						     (uint8_t *)"Rate must be between 0 and 1000 Hz.\n");
+	}
 
 	usr_uart_write_string(dev->board_cli->uart_device,
 			      (uint8_t*)"Columns correspond to the following channels: ");
 
-	if(!strcmp((char *)arg, "a")) {
-		ret = aiodio_analog_in_stream_all(dev);
+	if((arg[0] == 'a') && ((arg[1] == 0) || (arg[1] == ' '))) {
+		ret = aiodio_analog_in_stream_all(dev, rate);
 	} else if(*arg >= '0' && *arg <= '7') {
 		chan_no = atoi((char *)arg);
-		ret = aiodio_analog_in_stream_chan(dev, chan_no);
+		ret = aiodio_analog_in_stream_chan(dev, chan_no, rate);
 	} else {
 		return usr_uart_write_string(dev->board_cli->uart_device,
 					     (uint8_t *)"Input must be between 0 and 7 or 'a' for all.\n");
@@ -64,6 +64,10 @@
 #define AD5592_3_INTERNAL_REFERENCE (float)2.5
 #define AD5592_3_RESOLUTION_BITS 12
 
+#define AIODIO_STREAM_DEFAULT_RATE 2
+#define AIODIO_STREAM_MAX_RATE 1000
+#define AIODIO_STREAM_LINE_SIZE 100
+
 typedef int32_t (*adc_read_ptr)(struct ad5592r_dev *, uint8_t, uint16_t *);
 typedef int32_t (*dac_write_ptr)(struct ad5592r_dev *, uint8_t, uint16_t);
 
@@ -42,6 +42,7 @@
 /******************************************************************************/
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include "timer.h"
 #include "platform_drivers.h"
 #include <drivers/dma/adi_dma.h>
@@ -69,7 +70,15 @@ uint8_t uart_pong_flag = 0;
 volatile uint8_t ping, pong;
 volatile uint8_t *ping_ptr = &ping;
 volatile uint8_t *pong_ptr = &pong;
-static volatile int8_t tx_done = 0;
+/* UART transmit ring, drained by the UART callback */
+static uint8_t uart_tx_ring[UART_TX_RING_SIZE];
+static volatile uint16_t uart_tx_head = 0; /* Written by the application */
+static volatile uint16_t uart_tx_tail = 0; /* Written by the callback */
+static volatile uint16_t uart_tx_pending = 0; /* Bytes owned by the driver */
+/* UART receive ring, filled by the UART callback */
+static uint8_t uart_rx_ring[UART_RX_RING_SIZE];
+static volatile uint16_t uart_rx_head = 0; /* Written by the callback */
+static volatile uint16_t uart_rx_tail = 0; /* Written by the application */
 
 /* Master SPI device handle */
 ADI_SPI_HANDLE h_spi_device;
@@ -90,6 +99,138 @@ uint8_t gpio_init_flag = 0;
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+/**
+ * Get the free space in the UART transmit ring.
+ *
+ * @return Number of bytes that can be queued.
+ */
+static inline uint16_t uart_tx_free(void)
+{
+	return (uart_tx_tail - uart_tx_head - 1) & (UART_TX_RING_SIZE - 1);
+}
+
+/**
+ * Submit the next contiguous chunk of the transmit ring to the UART driver.
+ *
+ * Called from the UART callback when the previous chunk was sent and from the
+ * application, with the UART interrupt disabled, when new data is queued.
+ *
+ * @return 0 in case of success or if a chunk is already in flight,
+ *         UART_FAILURE if the driver refused the chunk.
+ */
+static int32_t uart_tx_kick(void)
+{
+	uint16_t head = uart_tx_head;
+
+	if(uart_tx_pending != 0 || head == uart_tx_tail)
+		return UART_SUCCESS;
+
+	if(head > uart_tx_tail)
+		uart_tx_pending = head - uart_tx_tail;
+	else
+		uart_tx_pending = UART_TX_RING_SIZE - uart_tx_tail;
+
+	if(adi_uart_SubmitTxBuffer((ADI_UART_HANDLE const)h_uart_device,
+				   &uart_tx_ring[uart_tx_tail], uart_tx_pending,
+				   DMA_NOT_USE) != ADI_UART_SUCCESS) {
+		uart_tx_pending = 0;
+		return UART_FAILURE;
+	}
+
+	return UART_SUCCESS;
+}
+
+/**
+ * Submit the transmit ring from the application.
+ *
+ * After a refused submission nothing is in flight and no callback will drain
+ * the ring, so every wait for space goes through here to retry it.
+ *
+ * @return 0 in case of success, UART_FAILURE if the driver refused the chunk.
+ */
+static int32_t uart_tx_restart(void)
+{
+	int32_t ret;
+
+	NVIC_DisableIRQ(UART_INT);
+	ret = uart_tx_kick();
+	NVIC_EnableIRQ(UART_INT);
+
+	return ret;
+}
+
+/**
+ * Copy data in the UART transmit ring and start the transmission.
+ *
+ * @param [in] data - Data to be queued.
+ * @param [in] len  - Number of bytes.
+ *
+ * @return 0 in case of success, UART_NO_TX_SPACE if the data does not fit,
+ *         UART_FAILURE if the driver refused to transmit the ring.
+ */
+static int32_t uart_tx_push(uint8_t *data, uint16_t len)
+{
+	uint16_t head = uart_tx_head;
+
+	if(uart_tx_free() < len) {
+		if(uart_tx_restart() != UART_SUCCESS)
+			return UART_FAILURE;
+		return UART_NO_TX_SPACE;
+	}
+
+	while(len--) {
+		uart_tx_ring[head] = *data++;
+		head = (head + 1) & (UART_TX_RING_SIZE - 1);
+	}
+	uart_tx_head = head;
+
+	return uart_tx_restart();
+}
+
+/**
+ * Get a character from the UART receive ring.
+ *
+ * @param [out] data - Pointer to data container.
+ *
+ * @return 1 if a character was available, 0 otherwise.
+ */
+static uint8_t uart_rx_pop(uint8_t *data)
+{
+	uint16_t tail = uart_rx_tail;
+
+	if(tail == uart_rx_head)
+		return 0;
+
+	*data = uart_rx_ring[tail];
+	uart_rx_tail = (tail + 1) & (UART_RX_RING_SIZE - 1);
+
+	return 1;
+}
+
+/**
+ * Store a received character in the UART receive ring and give the buffer
+ * back to the driver.
+ *
+ * If the ring is full the character is dropped.
+ *
+ * @param [in] buff - Driver buffer that was filled.
+ *
+ * @return void
+ */
+static void uart_rx_push(volatile uint8_t *buff)
+{
+	uint16_t head = uart_rx_head;
+	uint16_t next = (head + 1) & (UART_RX_RING_SIZE - 1);
+
+	if(next != uart_rx_tail) {
+		uart_rx_ring[head] = *buff;
+		uart_rx_head = next;
+	}
+
+	adi_uart_SubmitRxBuffer((ADI_UART_HANDLE const)h_uart_device,
+				(void *)buff, 1, DMA_NOT_USE);
+}
+
 /**
  * UART callback function.
  *
@@ -103,12 +244,10 @@ static void uart_callback(void *cb_param, uint32_t event, void *arg)
 {
 	switch(event) {
 	case ADI_UART_EVENT_RX_BUFFER_PROCESSED:
-		if(arg == (void *)&ping) {
-			uart_ping_flag = 2;
-		}
-		if(arg == (void *)&pong) {
-			uart_pong_flag = 2;
-		}
+		if(arg == (void *)&ping)
+			uart_rx_push(ping_ptr);
+		if(arg == (void *)&pong)
+			uart_rx_push(pong_ptr);
 		break;
 	case ADI_UART_EVENT_NO_RX_BUFFER_EVENT:
 		if (uart_ping_flag == 0) {
@@ -123,7 +262,10 @@ static void uart_callback(void *cb_param, uint32_t event, void *arg)
 		}
 		break;
 	case ADI_UART_EVENT_TX_BUFFER_PROCESSED:
-		tx_done--;
+		uart_tx_tail = (uart_tx_tail + uart_tx_pending) &
+			       (UART_TX_RING_SIZE - 1);
+		uart_tx_pending = 0;
+		(void)uart_tx_kick();
 		break;
 	default:
 		break;
@@ -778,7 +920,8 @@ int32_t usr_uart_remove(struct uart_desc *desc)
  * Write a character trought UART in a blocking call.
  *
  * usr_uart_write_char() helper function. The blocking call differs depending
- * on the existence of a callback function.
+ * on the existence of a callback function. With a callback the character is
+ * queued in the transmit ring and the call only waits if the ring is full.
  *
  * @param [in] desc - User UART device structure descriptor.
  * @param [in] data - Data to be transmitted.
@@ -787,21 +930,16 @@ int32_t usr_uart_remove(struct uart_desc *desc)
  */
 static int32_t usr_uart_write_block(struct uart_desc *desc, uint8_t data)
 {
-	int32_t ret;
 	const uint32_t buf_size = 1;
 	uint32_t hw_error;
+	int32_t ret;
 
 	if(desc->has_callback) {
-		ret = adi_uart_SubmitTxBuffer((ADI_UART_HANDLE const)h_uart_device,
-					      &data, buf_size, DMA_NOT_USE);
-		if(ret != ADI_UART_SUCCESS)
-			return ret;
-		tx_done++;
-		while(tx_done > 0);
-		if(tx_done == 0)
-			return 0;
-		else
-			return -1;
+		do {
+			ret = uart_tx_push(&data, 1);
+		} while(ret == UART_NO_TX_SPACE);
+
+		return ret;
 	} else {
 		return adi_uart_Write((ADI_UART_HANDLE const)h_uart_device, &data,
 				      buf_size, DMA_NOT_USE, &hw_error);
@@ -829,6 +967,8 @@ int32_t usr_uart_write_char(struct uart_desc *desc, uint8_t data,
 		ret = usr_uart_write_block(desc, data);
 		break;
 	case UART_NON_BLOCKING:
+		if(desc->has_callback)
+			return uart_tx_push(&data, 1);
 		ret = adi_uart_IsTxBufferAvailable((ADI_UART_HANDLE const)h_uart_device,
 						   (bool* const)&tx_available);
 		if(ret != ADI_UART_SUCCESS)
@@ -858,10 +998,31 @@ int32_t usr_uart_write_char(struct uart_desc *desc, uint8_t data,
 int32_t usr_uart_write_string(struct uart_desc *desc, uint8_t *string)
 {
 	int32_t ret = 0;
+	uint16_t len, free_space;
 
 	if(string == NULL)
 		return ret;
 
+	if(desc->has_callback) {
+		while(*string != '\0') {
+			/* Queue as much of the string as fits in the ring */
+			free_space = uart_tx_free();
+			for(len = 0; len < free_space && string[len] != '\0'; len++);
+			if(len == 0) {
+				ret = uart_tx_restart();
+				if(ret < 0)
+					break;
+				continue;
+			}
+			ret = uart_tx_push(string, len);
+			if(ret < 0)
+				break;
+			string += len;
+		}
+
+		return ret;
+	}
+
 	while(*string != '\0') {
 		ret = usr_uart_write_char(desc, *string++, UART_BLOCKING);
 
@@ -872,6 +1033,36 @@ int32_t usr_uart_write_string(struct uart_desc *desc, uint8_t *string)
 	return ret;
 }
 
+/**
+ * Queue a whole string of characters to the UART without waiting.
+ *
+ * The string is either queued entirely or not at all, so streamed lines are
+ * never truncated. Only available when the UART has a callback.
+ *
+ * @param [in] desc   - User UART device structure descriptor.
+ * @param [in] string - Pointer to the data array to be transmitted.
+ *
+ * @return 0 in case of success, UART_NO_TX_SPACE if the string does not fit
+ *         in the transmit ring, negative error code otherwise.
+ */
+int32_t usr_uart_write_string_nonblocking(struct uart_desc *desc,
+		uint8_t *string)
+{
+	size_t len;
+
+	if(string == NULL)
+		return 0;
+
+	if(!desc->has_callback)
+		return usr_uart_write_string(desc, string);
+
+	len = strlen((char *)string);
+	if(len >= UART_TX_RING_SIZE)
+		return UART_NO_TX_SPACE;
+
+	return uart_tx_push(string, len);
+}
+
 /**
  * Read a character through UART in a blocking call.
  *
@@ -896,15 +1087,7 @@ static int32_t usr_uart_read_block(struct uart_desc *desc, uint8_t *data)
 		return adi_uart_GetRxBuffer((ADI_UART_HANDLE const)h_uart_device,
 					    (void **)&data, &error);
 	} else {
-		while(uart_ping_flag != 2 && uart_pong_flag != 2);
-		if(uart_ping_flag == 2) {
-			*data = *ping_ptr;
-			uart_ping_flag = 0;
-		}
-		if(uart_pong_flag == 2) {
-			*data = *pong_ptr;
-			uart_pong_flag = 0;
-		}
+		while(!uart_rx_pop(data));
 
 		return 0;
 	}
@@ -938,16 +1121,7 @@ static int32_t usr_uart_read_nonblock(struct uart_desc *desc, uint8_t *data,
 		return adi_uart_GetRxBuffer((ADI_UART_HANDLE const)h_uart_device,
 					    (void **)&data, &error);
 	} else {
-		if(uart_ping_flag == 2) {
-			*data = *ping_ptr;
-			*rdy = 1;
-			uart_ping_flag = 0;
-		}
-		if(uart_pong_flag == 2) {
-			*data = *pong_ptr;
-			*rdy = 1;
-			uart_pong_flag = 0;
-		}
+		*rdy = uart_rx_pop(data);
 
 		return 0;
 	}
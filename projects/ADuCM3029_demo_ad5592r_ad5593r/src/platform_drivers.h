@@ -80,6 +80,11 @@
 #define RX_INT SYS_GPIO_INTA_IRQn
 #define UART_INT UART_EVT_IRQn
 
+/* Software ring buffers used by the UART when it has a callback. The sizes
+ * must be powers of 2. */
+#define UART_TX_RING_SIZE	512
+#define UART_RX_RING_SIZE	64
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -256,6 +261,10 @@ int32_t usr_uart_write_char(struct uart_desc *desc, uint8_t data,
 /* Write a string of characters to the UART */
 int32_t usr_uart_write_string(struct uart_desc *desc, uint8_t *string);
 
+/* Queue a whole string of characters to the UART without waiting */
+int32_t usr_uart_write_string_nonblocking(struct uart_desc *desc,
+		uint8_t *string);
+
 /* Read one character from the UART */
 int32_t usr_uart_read_char(struct uart_desc *desc, uint8_t *data, uint8_t *rdy,
 			   enum uart_comm_mode mode);
@@ -57,6 +57,7 @@
 /******************************************************************************/
 
 static volatile  uint32_t timer_delay_count = 0;
+static volatile  uint32_t timer_ms_count = 0;
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
@@ -104,6 +105,21 @@ void timer_sleep(uint32_t ticks)
 	while (timer_delay_count != 0u);
 }
 
+/**
+ * Get the number of miliseconds elapsed since timer_start().
+ *
+ * The counter wraps around after about 49 days, so use unsigned differences
+ * when measuring intervals.
+ *
+ * @params void
+ *
+ * @return Number of miliseconds.
+ */
+uint32_t timer_get_ms(void)
+{
+	return timer_ms_count;
+}
+
 /**
  * Callback function for SysTick timer.
  *
@@ -115,6 +131,8 @@ void timer_sleep(uint32_t ticks)
  */
 void SysTick_Handler(void)
 {
+	timer_ms_count++;
+
 	/* Decrement to zero the counter used by the delay routine. */
 	if (timer_delay_count != 0u)
 		--timer_delay_count;
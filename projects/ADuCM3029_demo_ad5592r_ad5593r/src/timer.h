@@ -84,6 +84,9 @@ int32_t timer_start(void);
 /* Delay function of 1ms or more. */
 void timer_sleep(uint32_t ticks);
 
+/* Get the number of miliseconds elapsed since timer_start(). */
+uint32_t timer_get_ms(void);
+
 /* Initializes a timer with a callback. */
 int32_t timer_counter_setup(struct timer_counter_desc **device,
 			    struct timer_counter_init *init_param);
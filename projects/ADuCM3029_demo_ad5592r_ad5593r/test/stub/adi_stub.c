@@ -0,0 +1,30 @@
+/* Host versions of the device drivers the CLI test does not exercise */
+
+#include <adi_stub.h>
+
+void timer_sleep(uint32_t ticks) { (void)ticks; }
+
+int adi_gpio_Init(void *mem, uint32_t size) { (void)mem; (void)size; return 0; }
+int adi_gpio_UnInit(void) { return 0; }
+int adi_gpio_DriveStrengthEnable(uint8_t port, ADI_GPIO_DATA pins, bool enable) { (void)port; (void)pins; (void)enable; return 0; }
+int adi_gpio_InputEnable(uint8_t port, ADI_GPIO_DATA pins, bool enable) { (void)port; (void)pins; (void)enable; return 0; }
+int adi_gpio_OutputEnable(uint8_t port, ADI_GPIO_DATA pins, bool enable) { (void)port; (void)pins; (void)enable; return 0; }
+int adi_gpio_SetHigh(uint8_t port, ADI_GPIO_DATA pins) { (void)port; (void)pins; return 0; }
+int adi_gpio_SetLow(uint8_t port, ADI_GPIO_DATA pins) { (void)port; (void)pins; return 0; }
+int adi_gpio_GetData(uint8_t port, ADI_GPIO_DATA pins, uint16_t *value) { (void)port; (void)pins; *value = 0; return 0; }
+
+int adi_i2c_Open(uint32_t id, void *mem, uint32_t size, ADI_I2C_HANDLE *handle) { (void)id; (void)mem; (void)size; *handle = mem; return 0; }
+int adi_i2c_Close(ADI_I2C_HANDLE handle) { (void)handle; return 0; }
+int adi_i2c_SetBitRate(ADI_I2C_HANDLE handle, uint32_t rate) { (void)handle; (void)rate; return 0; }
+int adi_i2c_SetSlaveAddress(ADI_I2C_HANDLE handle, uint16_t address) { (void)handle; (void)address; return 0; }
+int adi_i2c_ReadWrite(ADI_I2C_HANDLE handle, ADI_I2C_TRANSACTION *trans, uint32_t *error) { (void)handle; (void)trans; *error = 0; return 0; }
+
+int adi_spi_Open(uint32_t id, void *mem, uint32_t size, ADI_SPI_HANDLE *handle) { (void)id; (void)size; *handle = mem; return 0; }
+int adi_spi_Close(ADI_SPI_HANDLE handle) { (void)handle; return 0; }
+int adi_spi_SetBitrate(ADI_SPI_HANDLE handle, uint32_t rate) { (void)handle; (void)rate; return 0; }
+int adi_spi_SetChipSelect(ADI_SPI_HANDLE handle, uint8_t cs) { (void)handle; (void)cs; return 0; }
+int adi_spi_SetContinuousMode(ADI_SPI_HANDLE handle, bool enable) { (void)handle; (void)enable; return 0; }
+int adi_spi_SetIrqmode(ADI_SPI_HANDLE handle, uint8_t mode) { (void)handle; (void)mode; return 0; }
+int adi_spi_SetClockPolarity(ADI_SPI_HANDLE handle, bool polarity) { (void)handle; (void)polarity; return 0; }
+int adi_spi_SetClockPhase(ADI_SPI_HANDLE handle, bool phase) { (void)handle; (void)phase; return 0; }
+int adi_spi_MasterReadWrite(ADI_SPI_HANDLE handle, ADI_SPI_TRANSCEIVER *trans) { (void)handle; (void)trans; return 0; }
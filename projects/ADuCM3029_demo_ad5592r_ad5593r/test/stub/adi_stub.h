@@ -0,0 +1,147 @@
+/* Host declarations of the ADuCM3029 device drivers used by platform_drivers.c */
+
+#ifndef ADI_STUB_H_
+#define ADI_STUB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SUCCESS		0
+#define FAILURE		-1
+
+typedef enum {
+	UART_EVT_IRQn,
+	TMR0_EVT_IRQn,
+	TMR1_EVT_IRQn,
+	TMR2_EVT_IRQn,
+	SYS_GPIO_INTA_IRQn,
+	SYS_GPIO_INTB_IRQn
+} IRQn_Type;
+
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+
+typedef void (*ADI_CALLBACK)(void *cb_param, uint32_t event, void *arg);
+
+/* GPIO */
+#define ADI_GPIO_MEMORY_SIZE	16
+#define ADI_GPIO_PORT0		0
+#define ADI_GPIO_PIN_4		(1 << 4)
+#define ADI_GPIO_PIN_5		(1 << 5)
+
+typedef uint16_t ADI_GPIO_DATA;
+
+int adi_gpio_Init(void *mem, uint32_t size);
+int adi_gpio_UnInit(void);
+int adi_gpio_DriveStrengthEnable(uint8_t port, ADI_GPIO_DATA pins, bool enable);
+int adi_gpio_InputEnable(uint8_t port, ADI_GPIO_DATA pins, bool enable);
+int adi_gpio_OutputEnable(uint8_t port, ADI_GPIO_DATA pins, bool enable);
+int adi_gpio_SetHigh(uint8_t port, ADI_GPIO_DATA pins);
+int adi_gpio_SetLow(uint8_t port, ADI_GPIO_DATA pins);
+int adi_gpio_GetData(uint8_t port, ADI_GPIO_DATA pins, uint16_t *value);
+
+/* I2C */
+#define ADI_I2C_MEMORY_SIZE	16
+
+typedef void *ADI_I2C_HANDLE;
+
+typedef struct {
+	uint8_t *pPrologue;
+	uint16_t nPrologueSize;
+	uint8_t *pData;
+	uint16_t nDataSize;
+	bool bReadNotWrite;
+	bool bRepeatStart;
+} ADI_I2C_TRANSACTION;
+
+int adi_i2c_Open(uint32_t id, void *mem, uint32_t size, ADI_I2C_HANDLE *handle);
+int adi_i2c_Close(ADI_I2C_HANDLE handle);
+int adi_i2c_SetBitRate(ADI_I2C_HANDLE handle, uint32_t rate);
+int adi_i2c_SetSlaveAddress(ADI_I2C_HANDLE handle, uint16_t address);
+int adi_i2c_ReadWrite(ADI_I2C_HANDLE handle, ADI_I2C_TRANSACTION *trans,
+		      uint32_t *error);
+
+/* SPI */
+#define ADI_SPI_MEMORY_SIZE	16
+#define ADI_SPI_CS0		1
+#define ADI_SPI_CS1		2
+
+typedef void *ADI_SPI_HANDLE;
+
+typedef struct {
+	uint8_t *pTransmitter;
+	uint8_t *pReceiver;
+	uint16_t TransmitterBytes;
+	uint16_t ReceiverBytes;
+	uint8_t nTxIncrement;
+	uint8_t nRxIncrement;
+	bool bDMA;
+	bool bRD_CTL;
+} ADI_SPI_TRANSCEIVER;
+
+int adi_spi_Open(uint32_t id, void *mem, uint32_t size, ADI_SPI_HANDLE *handle);
+int adi_spi_Close(ADI_SPI_HANDLE handle);
+int adi_spi_SetBitrate(ADI_SPI_HANDLE handle, uint32_t rate);
+int adi_spi_SetChipSelect(ADI_SPI_HANDLE handle, uint8_t cs);
+int adi_spi_SetContinuousMode(ADI_SPI_HANDLE handle, bool enable);
+int adi_spi_SetIrqmode(ADI_SPI_HANDLE handle, uint8_t mode);
+int adi_spi_SetClockPolarity(ADI_SPI_HANDLE handle, bool polarity);
+int adi_spi_SetClockPhase(ADI_SPI_HANDLE handle, bool phase);
+int adi_spi_MasterReadWrite(ADI_SPI_HANDLE handle, ADI_SPI_TRANSCEIVER *trans);
+
+/* UART, modeled by the test */
+#define ADI_UART_BIDIR_MEMORY_SIZE	16
+
+typedef void *ADI_UART_HANDLE;
+
+enum {
+	ADI_UART_SUCCESS,
+	ADI_UART_FAILED
+};
+
+enum {
+	ADI_UART_DIR_BIDIRECTION
+};
+
+enum {
+	ADI_UART_NO_PARITY
+};
+
+enum {
+	ADI_UART_ONE_STOPBIT
+};
+
+enum {
+	ADI_UART_WORDLEN_5BITS,
+	ADI_UART_WORDLEN_6BITS,
+	ADI_UART_WORDLEN_7BITS,
+	ADI_UART_WORDLEN_8BITS
+};
+
+enum {
+	ADI_UART_EVENT_RX_BUFFER_PROCESSED = 40,
+	ADI_UART_EVENT_TX_BUFFER_PROCESSED,
+	ADI_UART_EVENT_NO_RX_BUFFER_EVENT
+};
+
+int adi_uart_Open(uint32_t id, int dir, void *mem, uint32_t size,
+		  ADI_UART_HANDLE *handle);
+int adi_uart_Close(ADI_UART_HANDLE handle);
+int adi_uart_SetConfiguration(ADI_UART_HANDLE handle, int parity, int stop,
+			      int wordlen);
+int adi_uart_ConfigBaudRate(ADI_UART_HANDLE handle, uint16_t divc,
+			    uint8_t divm, uint16_t divn, uint8_t osr);
+int adi_uart_RegisterCallback(ADI_UART_HANDLE handle, ADI_CALLBACK cb,
+			      void *cb_param);
+int adi_uart_SubmitTxBuffer(ADI_UART_HANDLE handle, void *buf, uint32_t size,
+			    bool dma);
+int adi_uart_SubmitRxBuffer(ADI_UART_HANDLE handle, void *buf, uint32_t size,
+			    bool dma);
+int adi_uart_GetRxBuffer(ADI_UART_HANDLE handle, void **buf, uint32_t *error);
+int adi_uart_IsTxBufferAvailable(ADI_UART_HANDLE handle, bool *available);
+int adi_uart_IsRxBufferAvailable(ADI_UART_HANDLE handle, bool *available);
+int adi_uart_Write(ADI_UART_HANDLE handle, void *buf, uint32_t size, bool dma,
+		   uint32_t *error);
+
+#endif /* ADI_STUB_H_ */
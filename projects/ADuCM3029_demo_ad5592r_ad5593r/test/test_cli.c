@@ -0,0 +1,416 @@
+/* Host test of the CLI core and the UART rings over a pseudo-terminal
+ *
+ * The UART driver is replaced by a model that moves bytes between the driver
+ * buffers and the slave side of a pseudo-terminal, and that runs the driver
+ * callback whenever the UART interrupt is enabled. The test types on the
+ * master side as a terminal would and reads back what the CLI prints.
+ */
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "cli.h"
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+uint8_t *app_name = (uint8_t *)"CLI test";
+
+/* UART model */
+static int term;
+static int line;
+static ADI_CALLBACK uart_cb;
+static void *rx_buf[2];
+static int rx_bufs;
+static void *tx_buf;
+static uint32_t tx_len;
+static int irq_enabled = 1;
+static int in_irq;
+/* Transmitted chunks are not completed */
+static int tx_stalled;
+/* Submissions are refused */
+static int tx_refused;
+
+static void uart_irq(void)
+{
+	uint8_t c;
+	void *buf;
+
+	if (!irq_enabled || in_irq)
+		return;
+	in_irq = 1;
+	while (tx_len && !tx_stalled) {
+		buf = tx_buf;
+		CHECK(write(line, buf, tx_len) == (ssize_t)tx_len);
+		tx_len = 0;
+		uart_cb(NULL, ADI_UART_EVENT_TX_BUFFER_PROCESSED, buf);
+	}
+	while (rx_bufs && read(line, &c, 1) == 1) {
+		buf = rx_buf[0];
+		rx_buf[0] = rx_buf[1];
+		rx_bufs--;
+		*(uint8_t *)buf = c;
+		uart_cb(NULL, ADI_UART_EVENT_RX_BUFFER_PROCESSED, buf);
+	}
+	in_irq = 0;
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq)
+{
+	if (irq != UART_EVT_IRQn)
+		return;
+	irq_enabled = 1;
+	uart_irq();
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq)
+{
+	if (irq == UART_EVT_IRQn)
+		irq_enabled = 0;
+}
+
+int adi_uart_Open(uint32_t id, int dir, void *mem, uint32_t size,
+		  ADI_UART_HANDLE *handle)
+{
+	*handle = mem;
+	return ADI_UART_SUCCESS;
+}
+
+int adi_uart_Close(ADI_UART_HANDLE handle)
+{
+	return ADI_UART_SUCCESS;
+}
+
+int adi_uart_SetConfiguration(ADI_UART_HANDLE handle, int parity, int stop,
+			      int wordlen)
+{
+	return ADI_UART_SUCCESS;
+}
+
+int adi_uart_ConfigBaudRate(ADI_UART_HANDLE handle, uint16_t divc,
+			    uint8_t divm, uint16_t divn, uint8_t osr)
+{
+	return ADI_UART_SUCCESS;
+}
+
+int adi_uart_RegisterCallback(ADI_UART_HANDLE handle, ADI_CALLBACK cb,
+			      void *cb_param)
+{
+	uart_cb = cb;
+	return ADI_UART_SUCCESS;
+}
+
+int adi_uart_SubmitTxBuffer(ADI_UART_HANDLE handle, void *buf, uint32_t size,
+			    bool dma)
+{
+	/* the ring owns one chunk at a time */
+	CHECK(tx_len == 0);
+	if (tx_refused)
+		return ADI_UART_FAILED;
+	tx_buf = buf;
+	tx_len = size;
+	return ADI_UART_SUCCESS;
+}
+
+int adi_uart_SubmitRxBuffer(ADI_UART_HANDLE handle, void *buf, uint32_t size,
+			    bool dma)
+{
+	CHECK(rx_bufs < 2 && size == 1);
+	rx_buf[rx_bufs++] = buf;
+	return ADI_UART_SUCCESS;
+}
+
+int adi_uart_GetRxBuffer(ADI_UART_HANDLE handle, void **buf, uint32_t *error)
+{
+	return ADI_UART_FAILED;
+}
+
+int adi_uart_IsTxBufferAvailable(ADI_UART_HANDLE handle, bool *available)
+{
+	return ADI_UART_FAILED;
+}
+
+int adi_uart_IsRxBufferAvailable(ADI_UART_HANDLE handle, bool *available)
+{
+	return ADI_UART_FAILED;
+}
+
+int adi_uart_Write(ADI_UART_HANDLE handle, void *buf, uint32_t size, bool dma,
+		   uint32_t *error)
+{
+	return ADI_UART_FAILED;
+}
+
+/* terminal */
+static char out[8192];
+
+/* read what the CLI printed until the terminal is quiet */
+static const char *term_read(void)
+{
+	struct pollfd p = { .fd = term, .events = POLLIN };
+	size_t n = 0;
+	ssize_t r;
+
+	while (n < sizeof(out) - 1 && poll(&p, 1, 50) > 0) {
+		r = read(term, out + n, sizeof(out) - 1 - n);
+		if (r <= 0)
+			break;
+		n += (size_t)r;
+	}
+	out[n] = '\0';
+
+	return out;
+}
+
+/* commands */
+static int calls;
+static int32_t (*last_cmd)(void *, uint8_t *);
+static char last_arg[64];
+
+static int32_t cmd_help(void *dev, uint8_t *arg)
+{
+	calls++;
+	last_cmd = cmd_help;
+	last_arg[0] = '\0';
+	return 0;
+}
+
+static int32_t cmd_read(void *dev, uint8_t *arg)
+{
+	calls++;
+	last_cmd = cmd_read;
+	snprintf(last_arg, sizeof(last_arg), "%s", (char *)arg);
+	return 0;
+}
+
+static int32_t cmd_write_reg(void *dev, uint8_t *arg)
+{
+	calls++;
+	last_cmd = cmd_write_reg;
+	snprintf(last_arg, sizeof(last_arg), "%s", (char *)arg);
+	return 0;
+}
+
+static char *cmd_calls[] = {
+	"help",
+	"h",
+	"read ",
+	"r ",
+	"write_reg ",
+	"wr ",
+	""
+};
+
+static cmd_func cmd_funcs[] = {
+	cmd_help,
+	cmd_read,
+	cmd_write_reg,
+	NULL
+};
+
+static uint8_t cmd_sizes[] = {5, 2, 5, 2, 10, 3, 1};
+
+/* type a line and run the CLI until it is handled */
+static const char *type(struct cli_desc *cli, const char *keys)
+{
+	int i;
+
+	CHECK(write(term, keys, strlen(keys)) == (ssize_t)strlen(keys));
+	for (i = 0; i < 50; i++) {
+		NVIC_EnableIRQ(UART_EVT_IRQn);
+		CHECK(cli_process(cli) == 0);
+		usleep(1000);
+	}
+
+	return term_read();
+}
+
+static void test_commands(struct cli_desc *cli)
+{
+	const char *o;
+
+	o = type(cli, "\r");
+	CHECK(strstr(o, "Type <help> or <h> to see available commands..."));
+	CHECK(o[strlen(o) - 1] == '>');
+
+	type(cli, "read 3\r");
+	CHECK(last_cmd == cmd_read && !strcmp(last_arg, "3"));
+	type(cli, "r 4\r");
+	CHECK(last_cmd == cmd_read && !strcmp(last_arg, "4"));
+	type(cli, "help\r");
+	CHECK(last_cmd == cmd_help);
+	last_cmd = NULL;
+	type(cli, "h\r");
+	CHECK(last_cmd == cmd_help);
+	type(cli, "write_reg 1 2\r");
+	CHECK(last_cmd == cmd_write_reg && !strcmp(last_arg, "1 2"));
+	type(cli, "wr 5 6\r");
+	CHECK(last_cmd == cmd_write_reg && !strcmp(last_arg, "5 6"));
+
+	/* the previous line comes back on <TAB> */
+	type(cli, "\t\r");
+	CHECK(last_cmd == cmd_write_reg && !strcmp(last_arg, "5 6"));
+	/* <BACKSPACE> edits the line */
+	type(cli, "r 89\b7\r");
+	CHECK(last_cmd == cmd_read && !strcmp(last_arg, "87"));
+
+	/* a name alone, a prefix or an extension of a name is unknown */
+	calls = 0;
+	CHECK(strstr(type(cli, "read\r"), "Unknown command!"));
+	CHECK(strstr(type(cli, "helpme\r"), "Unknown command!"));
+	CHECK(strstr(type(cli, "wri 1\r"), "Unknown command!"));
+	CHECK(strstr(type(cli, "rr 1\r"), "Unknown command!"));
+	CHECK(calls == 0);
+}
+
+static void test_table_size(struct cli_desc *cli)
+{
+	static char names[CLI_HASH_SIZE][8];
+	static char *big_calls[CLI_HASH_SIZE + 1];
+	static cmd_func big_funcs[CLI_HASH_SIZE / 2 + 1];
+	static uint8_t big_sizes[CLI_HASH_SIZE + 1];
+	cmd_func func;
+	int i;
+
+	for (i = 0; i < CLI_HASH_SIZE; i++) {
+		big_sizes[i] = (uint8_t)sprintf(names[i], "c%d ", i);
+		big_calls[i] = names[i];
+		big_funcs[i / 2] = i == 7 ? cmd_read : cmd_help;
+	}
+	cli_load_command_calls(cli, big_calls);
+	cli_load_command_sizes(cli, big_sizes);
+	cli_load_command_vector(cli, big_funcs);
+
+	/* one slot must stay free to end the probing */
+	big_funcs[CLI_HASH_SIZE / 2 - 1] = NULL;
+	func = NULL;
+	CHECK(cli_find_command(cli, (uint8_t *)"c7 x", &func) == 0);
+	CHECK(func == cmd_read);
+	func = NULL;
+	CHECK(cli_find_command(cli, (uint8_t *)"c6 x", &func) == 0);
+	CHECK(func == cmd_read);
+	func = NULL;
+	CHECK(cli_find_command(cli, (uint8_t *)"c62 x", &func) == 0);
+	CHECK(func == NULL);
+
+	/* a table that fills the lookup is refused, not silently cut */
+	big_funcs[CLI_HASH_SIZE / 2 - 1] = cmd_help;
+	cli_load_command_vector(cli, big_funcs);
+	CHECK(cli_find_command(cli, (uint8_t *)"c7 x", &func) < 0);
+
+	cli_load_command_calls(cli, cmd_calls);
+	cli_load_command_sizes(cli, cmd_sizes);
+	cli_load_command_vector(cli, cmd_funcs);
+}
+
+static void test_stream(struct cli_desc *cli)
+{
+	char text[64];
+	int queued = 0, sent = 0, i;
+	const char *o;
+
+	/* a busy line does not block the writer, lines are kept whole */
+	tx_stalled = 1;
+	for (i = 0; i < 100; i++) {
+		sprintf(text, "line %02d 0123456789\n", i);
+		if (usr_uart_write_string_nonblocking(cli->uart_device,
+						      (uint8_t *)text) == 0)
+			queued++;
+		else
+			break;
+	}
+	CHECK(queued > 0 && queued < 100);
+	CHECK(usr_uart_write_string_nonblocking(cli->uart_device,
+						(uint8_t *)text) == UART_NO_TX_SPACE);
+	tx_stalled = 0;
+	NVIC_EnableIRQ(UART_EVT_IRQn);
+	o = term_read();
+	for (i = 0; i < queued; i++) {
+		sprintf(text, "line %02d 0123456789\n", i);
+		if (!strncmp(o, text, strlen(text))) {
+			o += strlen(text);
+			sent++;
+		}
+	}
+	CHECK(sent == queued && *o == '\0');
+}
+
+static void test_refused(struct cli_desc *cli)
+{
+	char text[64];
+	int i;
+	const char *o;
+
+	/* nothing is in flight after a refused submission, the writers must
+	 * give up instead of waiting for a callback that never comes */
+	tx_refused = 1;
+	memset(text, 'x', 49);
+	text[49] = '\n';
+	text[50] = '\0';
+	for (i = 0; i < 10; i++)
+		CHECK(usr_uart_write_string_nonblocking(cli->uart_device,
+							(uint8_t *)text) == UART_FAILURE);
+	CHECK(usr_uart_write_string(cli->uart_device,
+				    (uint8_t *)"0123456789012345678901234567890123456789") == UART_FAILURE);
+	CHECK(usr_uart_write_char(cli->uart_device, 'y', UART_BLOCKING) == UART_FAILURE);
+
+	/* the next write submits everything that was queued */
+	tx_refused = 0;
+	CHECK(usr_uart_write_string(cli->uart_device, (uint8_t *)"ok\n") == 0);
+	o = term_read();
+	CHECK(strlen(o) > 10 * 50);
+	CHECK(strstr(o, "ok\n") != NULL);
+}
+
+int main(void)
+{
+	struct cli_init_param init = {
+		.uart_init = {
+			.baudrate = bd115200,
+			.bits_no = 8,
+			.has_callback = true
+		}
+	};
+	struct cli_desc *cli;
+	struct termios tio;
+
+	/* a hang fails the test */
+	alarm(20);
+
+	term = posix_openpt(O_RDWR | O_NOCTTY);
+	CHECK(term >= 0 && grantpt(term) == 0 && unlockpt(term) == 0);
+	line = open(ptsname(term), O_RDWR | O_NOCTTY | O_NONBLOCK);
+	CHECK(line >= 0);
+	tcgetattr(line, &tio);
+	cfmakeraw(&tio);
+	tcsetattr(line, TCSANOW, &tio);
+
+	CHECK(cli_setup(&cli, &init) == 0);
+	cli_load_command_calls(cli, cmd_calls);
+	cli_load_command_sizes(cli, cmd_sizes);
+	cli_load_command_vector(cli, cmd_funcs);
+	cli_load_descriptor_pointer(cli, cli);
+
+	test_commands(cli);
+	test_table_size(cli);
+	test_stream(cli);
+	test_refused(cli);
+
+	cli_remove(cli);
+
+	printf("%s\n", failures ? "FAILED" : "OK");
+	return failures ? 1 : 0;
+}
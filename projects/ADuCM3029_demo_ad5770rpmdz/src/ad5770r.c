@@ -470,6 +470,100 @@ int32_t ad5770r_set_dac_input(struct ad5770r_dev *dev,
 	return ret;
 };
 
+/**
+ * Write the input registers of all channels in one burst and commit them.
+ *
+ * With descending addresses the burst starts at CH5_INPUT_MSB and the
+ * SW_LDAC register (0x37) directly follows CH0_INPUT_LSB, so a software
+ * update of all six channels is a single SPI transaction. With ascending
+ * addresses the SW_LDAC write is a second transaction. The burst needs
+ * streaming, so single_instruction must be off and stream_mode_length must
+ * be 0 or cover the whole burst.
+ * @param dev - The device structure.
+ * @param dac_input - Six input values, channel 0 first.
+ * @param ldac - How the new values are moved to the DAC outputs.
+ * @return SUCCESS in case of success, negative error code otherwise.
+ */
+int32_t ad5770r_set_dac_multichannel(struct ad5770r_dev *dev,
+				     const uint16_t *dac_input,
+				     enum ad5770r_ldac_mode ldac)
+{
+	/* Instruction, six input registers and SW_LDAC */
+	uint8_t data[2 * AD5770R_CH_NUMBER + 2];
+	uint8_t count = 2 * AD5770R_CH_NUMBER + 1;
+	uint8_t hw_mask;
+	uint16_t code;
+	int32_t ret;
+	uint8_t i;
+
+	if (!dev || !dac_input)
+		return FAILURE;
+	if ((ldac == AD5770R_LDAC_HW) && !dev->nldac)
+		return FAILURE;
+	if (dev->dev_spi_settings.single_instruction ||
+	    (dev->dev_spi_settings.stream_mode_length &&
+	     (dev->dev_spi_settings.stream_mode_length < count)))
+		return FAILURE;
+
+	if (dev->dev_spi_settings.addr_ascension) {
+		data[0] = AD5770R_REG_WRITE(AD5770R_CH0_INPUT_LSB);
+		for (i = 0; i < AD5770R_CH_NUMBER; i++) {
+			code = dac_input[i];
+			data[1 + 2 * i] = (uint8_t)AD5770R_CH_DAC_INPUT_DATA_LSB(code);
+			data[2 + 2 * i] = (uint8_t)((code & 0x3FC0) >> 6);
+		}
+	} else {
+		data[0] = AD5770R_REG_WRITE(AD5770R_CH5_INPUT_MSB);
+		for (i = 0; i < AD5770R_CH_NUMBER; i++) {
+			code = dac_input[AD5770R_CH5 - i];
+			data[1 + 2 * i] = (uint8_t)((code & 0x3FC0) >> 6);
+			data[2 + 2 * i] = (uint8_t)AD5770R_CH_DAC_INPUT_DATA_LSB(code);
+		}
+		if (ldac == AD5770R_LDAC_SW)
+			data[count++] = AD5770R_SW_LDAC_ALL;
+	}
+
+	ret = spi_write_and_read(dev->spi_desc, data, count);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < AD5770R_CH_NUMBER; i++)
+		dev->input_value[i] = dac_input[i];
+
+	switch (ldac) {
+	case AD5770R_LDAC_SW:
+		if (dev->dev_spi_settings.addr_ascension) {
+			ret = ad5770r_spi_reg_write(dev, AD5770R_SW_LDAC,
+						    AD5770R_SW_LDAC_ALL);
+			if (ret)
+				return ret;
+		}
+		for (i = 0; i < AD5770R_CH_NUMBER; i++)
+			dev->dac_value[i] = dac_input[i];
+		break;
+	case AD5770R_LDAC_HW:
+		/* The GPIO calls take longer than the minimum nLDAC pulse */
+		ret = gpio_set_value(dev->nldac, GPIO_LOW);
+		ret |= gpio_set_value(dev->nldac, GPIO_HIGH);
+		if (ret)
+			return ret;
+		hw_mask = AD5770R_HW_LDAC_MASK_CH(dev->mask_hw_ldac.en0, AD5770R_CH0) |
+			  AD5770R_HW_LDAC_MASK_CH(dev->mask_hw_ldac.en1, AD5770R_CH1) |
+			  AD5770R_HW_LDAC_MASK_CH(dev->mask_hw_ldac.en2, AD5770R_CH2) |
+			  AD5770R_HW_LDAC_MASK_CH(dev->mask_hw_ldac.en3, AD5770R_CH3) |
+			  AD5770R_HW_LDAC_MASK_CH(dev->mask_hw_ldac.en4, AD5770R_CH4) |
+			  AD5770R_HW_LDAC_MASK_CH(dev->mask_hw_ldac.en5, AD5770R_CH5);
+		for (i = 0; i < AD5770R_CH_NUMBER; i++)
+			if (!((hw_mask >> i) & BIT(0)))
+				dev->dac_value[i] = dac_input[i];
+		break;
+	default:
+		break;
+	}
+
+	return SUCCESS;
+}
+
 /**
  * Set page mask for dac value and input.
  * @param dev - The device structure.
@@ -220,6 +220,10 @@
 
 /* AD5770R_SW_LDAC */
 #define AD5770R_SW_LDAC_CH(x, channel)				(((x) & 0x1) << (channel))
+#define AD5770R_SW_LDAC_ALL					0x3F
+
+/* Number of DAC channels */
+#define AD5770R_CH_NUMBER					6
 
 
 #define AD5770R_REG_READ(x)					(((x) & 0x7F) | 0x80)
@@ -250,6 +254,15 @@ enum ad5770r_channels {
 	AD5770R_CH5
 };
 
+enum ad5770r_ldac_mode {
+	/* Only write the input registers */
+	AD5770R_LDAC_NONE,
+	/* Commit all channels through the SW_LDAC register */
+	AD5770R_LDAC_SW,
+	/* Commit the channels not masked in HW_LDAC with the nLDAC pin */
+	AD5770R_LDAC_HW
+};
+
 enum ad5770r_reference_voltage {
 	AD5770R_EXT_REF_2_5_V = 0,
 	AD5770R_INT_REF_1_25_V_OUT_ON,
@@ -387,6 +400,9 @@ int32_t ad5770r_set_dac_value(struct ad5770r_dev *dev,
 			      uint16_t dac_value, enum ad5770r_channels channel);
 int32_t ad5770r_set_dac_input(struct ad5770r_dev *dev,
 			      uint16_t dac_input, enum ad5770r_channels channel);
+int32_t ad5770r_set_dac_multichannel(struct ad5770r_dev *dev,
+				     const uint16_t *dac_input,
+				     enum ad5770r_ldac_mode ldac);
 int32_t ad5770r_set_page_mask(struct ad5770r_dev *dev,
 			      const struct ad5770r_dac_page_mask *page_mask);
 int32_t ad5770r_set_mask_channel(struct ad5770r_dev *dev,
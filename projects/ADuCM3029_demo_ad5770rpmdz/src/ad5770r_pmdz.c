@@ -61,6 +61,10 @@ static cmd_func ad5770r_fnc_ptr[] = {
 	(cmd_func)ad5770r_pmdz_set_chan,
 	(cmd_func)ad5770r_pmdz_set_range,
 	(cmd_func)ad5770r_pmdz_prod_test,
+	(cmd_func)ad5770r_pmdz_set_profile,
+	(cmd_func)ad5770r_pmdz_set_slew,
+	(cmd_func)ad5770r_pmdz_run_profile,
+	(cmd_func)ad5770r_pmdz_stop_profile,
 	NULL
 };
 
@@ -78,18 +82,125 @@ static char *ad5770r_fnc_calls[] = {
 	"sr ",
 	"prod_test",
 	"t",
+	"set_profile ",
+	"spr ",
+	"set_slew ",
+	"ssl ",
+	"run_profile",
+	"rpr",
+	"stop_profile",
+	"hpr",
 	""
 };
 
 /* Command size vector */
 static uint8_t ad5770r_fnc_call_size[] = {
-	5, 2, 11, 4, 11, 3, 9, 3, 10, 3, 10, 2, 1
+	5, 2, 11, 4, 11, 3, 9, 3, 10, 3, 10, 2, 12, 4, 9, 4, 12, 4, 13, 4, 1
+};
+
+/* Current profile commands help, long and short */
+static const char *ad5770r_profile_help[] = {
+	" set_profile <chan> <type> <code> <ms> [<period>] - Set the current profile of a DAC channel.\n",
+	"                             <chan> = c0 to c5;\n",
+	"                             <type> = hold, step, ramp or pulse;\n",
+	"                             <code> = step, ramp end or pulse code; between 0 and 16383;\n",
+	"                             <ms> = step delay, ramp length or pulse width in ms;\n",
+	"                             <period> = pulse period in ms; a single pulse if missing.\n",
+	"                             Example: set_profile c0 ramp 16383 500\n",
+	" set_slew <chan> <rate>    - Limit the output change of a channel to <rate> codes per ms; 0 for no limit.\n",
+	"                             Example: set_slew c0 20\n",
+	" run_profile               - Start the profiles of all channels from the present outputs.\n",
+	"                             All channels are updated together, with one LDAC, every ms.\n",
+	"                             Example: run_profile\n",
+	" stop_profile              - Stop the profiles and keep the present outputs.\n",
+	"                             Example: stop_profile\n",
+	NULL
+};
+
+static const char *ad5770r_profile_help_short[] = {
+	" spr <chan> <type> <code> <ms> [<period>] - Set the current profile of a DAC channel.\n",
+	"                      Example: spr c0 pulse 8192 5 100\n",
+	" ssl <chan> <rate>  - Limit the output change of a channel to <rate> codes per ms.\n",
+	"                      Example: ssl c0 20\n",
+	" rpr                - Start the profiles of all channels.\n",
+	"                      Example: rpr\n",
+	" hpr                - Stop the profiles.\n",
+	"                      Example: hpr\n",
+	NULL
 };
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+/**
+ * Current profile timer callback.
+ *
+ * Only counts the profile ticks; the SPI transfers are blocking, so the
+ * channels are updated from ad5770r_pmdz_process().
+ *
+ * @param [in] param - The device structure.
+ * @param [in] event - Timer event.
+ * @param [in] arg   - Not used.
+ *
+ * @return void
+ */
+static void ad5770r_pmdz_profile_callback(void *param, uint32_t event,
+		void *arg)
+{
+	struct ad5770r_pmdz_dev *dev = param;
+
+	if(++dev->profile_prescaler_cnt < dev->profile_timer->sw_prescaler)
+		return;
+	dev->profile_prescaler_cnt = 0;
+
+	dev->profile_ticks++;
+}
+
+/**
+ * Apply the profile ticks counted since the last call.
+ *
+ * All channels are written in one burst and updated with one LDAC.
+ *
+ * @param [in] dev - The device structure.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad5770r_pmdz_profile_service(struct ad5770r_pmdz_dev *dev)
+{
+	uint32_t ticks;
+	int32_t ret;
+
+	if(!dev->profile_running)
+		return SUCCESS;
+
+	ticks = dev->profile_ticks - dev->profile_ticks_done;
+	if(!ticks)
+		return SUCCESS;
+	dev->profile_ticks_done += ticks;
+
+	if(ad5770r_profile_next(&dev->profile, ticks)) {
+		ret = ad5770r_set_dac_multichannel(dev->ad770r_device,
+						   dev->profile.code,
+						   dev->ad770r_device->nldac ?
+						   AD5770R_LDAC_HW : AD5770R_LDAC_SW);
+		if(ret != SUCCESS) {
+			ad5770r_pmdz_stop_profile(dev, NULL);
+			return ret;
+		}
+	}
+
+	if(!dev->profile.done)
+		return SUCCESS;
+
+	ret = ad5770r_pmdz_stop_profile(dev, NULL);
+	if(ret != SUCCESS)
+		return ret;
+
+	return usr_uart_write_string(dev->cli_device->uart_device,
+				     (uint8_t*)"Profile done.\n");
+}
+
 /**
  * Help command helper function. Display help function prompt.
  *
@@ -478,6 +589,34 @@ static int32_t ad5770r_pmdz_help_dac(struct ad5770r_pmdz_dev *dev,
 	}
 }
 
+/**
+ * Display current profile specific functions.
+ *
+ * ad5770r_pmdz_help() helper function.
+ *
+ * @param [in] dev	 	 	 - The device structure.
+ * @param [in] short_command - True to display the long command prompt,
+ *                             false to display the short command prompt.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t ad5770r_pmdz_help_profile(struct ad5770r_pmdz_dev *dev,
+					 bool short_command)
+{
+	const char **help = short_command ? ad5770r_profile_help_short :
+			    ad5770r_profile_help;
+	int32_t ret;
+
+	while(*help) {
+		ret = usr_uart_write_string(dev->cli_device->uart_device,
+					    (uint8_t *)*help++);
+		if(ret != SUCCESS)
+			return ret;
+	}
+
+	return SUCCESS;
+}
+
 /**
  * Display help options in the CLI.
  *
@@ -500,11 +639,19 @@ int32_t ad5770r_pmdz_help(struct ad5770r_pmdz_dev *dev, uint8_t *arg)
 	if(ret != SUCCESS)
 		return ret;
 
+	ret = ad5770r_pmdz_help_profile(dev, HELP_LONG_COMMAND);
+	if(ret != SUCCESS)
+		return ret;
+
 	ret = ad5770r_pmdz_help_prompt(dev, HELP_SHORT_COMMAND);
 	if(ret != SUCCESS)
 		return ret;
 
-	return ad5770r_pmdz_help_dac(dev, HELP_SHORT_COMMAND);
+	ret = ad5770r_pmdz_help_dac(dev, HELP_SHORT_COMMAND);
+	if(ret != SUCCESS)
+		return ret;
+
+	return ad5770r_pmdz_help_profile(dev, HELP_SHORT_COMMAND);
 }
 
 /**
@@ -743,6 +890,218 @@ int32_t ad5770r_pmdz_set_range(struct ad5770r_pmdz_dev *dev, uint8_t *arg)
 	return ad5770r_set_output_mode(dev->ad770r_device, &range, chan_index);
 }
 
+/**
+ * Get the index of a DAC channel from its name.
+ *
+ * @param [in] chan - Channel name, c0 to c5.
+ *
+ * @return The channel index, -1 if the name is not valid.
+ */
+static int8_t ad5770r_pmdz_get_chan(char *chan)
+{
+	if(!chan || (strlen(chan) != 2) || (chan[0] != 'c') ||
+	    (chan[1] < '0') || (chan[1] >= '0' + AD5770R_CH_NUMBER))
+		return -1;
+
+	return chan[1] - '0';
+}
+
+/**
+ * Display error message and tooltip for the "set_profile" command.
+ *
+ * ad5770r_pmdz_set_profile() helper function.
+ *
+ * @param [in] dev - Application software handler.
+ *
+ * @return void
+ */
+static void ad5770r_pmdz_set_profile_err(struct ad5770r_pmdz_dev *dev)
+{
+	usr_uart_write_string(dev->cli_device->uart_device,
+			      (uint8_t*)"Set Profile command has the following syntax:\n");
+	usr_uart_write_string(dev->cli_device->uart_device,
+			      (uint8_t*)"\tspr <chan> <type> <code> <ms> [<period>]\n");
+	usr_uart_write_string(dev->cli_device->uart_device,
+			      (uint8_t*)"Where:\n");
+	usr_uart_write_string(dev->cli_device->uart_device,
+			      (uint8_t*)"<chan> is the DAC channel, c0 to c5;\n");
+	usr_uart_write_string(dev->cli_device->uart_device,
+			      (uint8_t*)"<type> is hold, step, ramp or pulse;\n");
+	usr_uart_write_string(dev->cli_device->uart_device,
+			      (uint8_t*)"<code> is the step, ramp end or pulse code and must be between 0 and 16383;\n");
+	usr_uart_write_string(dev->cli_device->uart_device,
+			      (uint8_t*)"<ms> is the step delay, ramp length or pulse width in ms;\n");
+	usr_uart_write_string(dev->cli_device->uart_device,
+			      (uint8_t*)"<period> is the pulse period in ms, only for pulse.\n");
+	usr_uart_write_string(dev->cli_device->uart_device,
+			      (uint8_t*)"Example: spr c0 ramp 16383 500\n");
+}
+
+/**
+ * Set the current profile of a DAC channel.
+ *
+ * The profile starts from the channel output when run_profile is called.
+ *
+ * @param [in] dev - Application software handler.
+ * @param [in] arg - Pointer to the profile arguments.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad5770r_pmdz_set_profile(struct ad5770r_pmdz_dev *dev, uint8_t *arg)
+{
+	/* Same order as enum ad5770r_profile_type */
+	char *type_tab[] = {"hold", "step", "ramp", "pulse", 0};
+	struct ad5770r_profile_chan *prof;
+	char *chan, *type, *code, *time, *period;
+	int8_t chan_index;
+	uint8_t type_index = 0;
+
+	if(dev->profile_running)
+		return usr_uart_write_string(dev->cli_device->uart_device,
+					     (uint8_t*)"Stop the profile first.\n");
+
+	if(!arg) {
+		ad5770r_pmdz_set_profile_err(dev);
+		return SUCCESS;
+	}
+
+	chan = strtok((char *)arg, " ");
+	type = strtok(NULL, " ");
+	code = strtok(NULL, " ");
+	time = strtok(NULL, " ");
+	period = strtok(NULL, " ");
+
+	chan_index = ad5770r_pmdz_get_chan(chan);
+	while(type && type_tab[type_index] != 0) {
+		if(strcmp(type, type_tab[type_index]) == 0)
+			break;
+		type_index++;
+	}
+	if((chan_index < 0) || !type || !type_tab[type_index] ||
+	    ((type_index != AD5770R_PROFILE_HOLD) && (!code || !time)) ||
+	    (code && (atoi(code) < 0 || atoi(code) > AD5770R_PROFILE_CODE_MAX))) {
+		ad5770r_pmdz_set_profile_err(dev);
+		return SUCCESS;
+	}
+
+	prof = &dev->profile.chan[chan_index];
+	prof->type = (enum ad5770r_profile_type)type_index;
+	if(prof->type == AD5770R_PROFILE_HOLD)
+		return SUCCESS;
+
+	prof->end = atoi(code);
+	prof->duration = atoi(time);
+	if((prof->type == AD5770R_PROFILE_PULSE) && period)
+		prof->period = atoi(period);
+	else
+		prof->period = 0;
+
+	return SUCCESS;
+}
+
+/**
+ * Set the slew rate limit of a DAC channel.
+ *
+ * @param [in] dev - Application software handler.
+ * @param [in] arg - Pointer to the channel and rate arguments.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad5770r_pmdz_set_slew(struct ad5770r_pmdz_dev *dev, uint8_t *arg)
+{
+	char *chan, *rate;
+	int8_t chan_index;
+
+	if(!arg)
+		chan = rate = NULL;
+	else {
+		chan = strtok((char *)arg, " ");
+		rate = strtok(NULL, " ");
+	}
+
+	chan_index = ad5770r_pmdz_get_chan(chan);
+	if((chan_index < 0) || !rate || (atoi(rate) < 0) ||
+	    (atoi(rate) > AD5770R_PROFILE_CODE_MAX)) {
+		usr_uart_write_string(dev->cli_device->uart_device,
+				      (uint8_t*)"Set Slew command has the following syntax:\n");
+		usr_uart_write_string(dev->cli_device->uart_device,
+				      (uint8_t*)"\tssl <chan> <rate>\n");
+		usr_uart_write_string(dev->cli_device->uart_device,
+				      (uint8_t*)"Where <chan> is c0 to c5 and <rate> is the largest change in codes per ms, 0 for no limit.\n");
+		return usr_uart_write_string(dev->cli_device->uart_device,
+					     (uint8_t*)"Example: ssl c0 20\n");
+	}
+
+	dev->profile.chan[chan_index].slew = atoi(rate);
+
+	return SUCCESS;
+}
+
+/**
+ * Start the current profiles of all channels.
+ *
+ * Every channel starts from its present output. The timer only counts ticks;
+ * the channels are updated from ad5770r_pmdz_process().
+ *
+ * @param [in] dev - The device structure.
+ * @param [in] arg - Not used in this case. It exists to keep the function
+ *                   prototype compatible with the other functions that can be
+ *                   called from the CLI.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad5770r_pmdz_run_profile(struct ad5770r_pmdz_dev *dev, uint8_t *arg)
+{
+	struct timer_counter_init timer_init;
+	int32_t ret;
+	uint8_t i;
+
+	ret = ad5770r_pmdz_stop_profile(dev, NULL);
+	if(ret != SUCCESS)
+		return ret;
+
+	for(i = 0; i < AD5770R_CH_NUMBER; i++)
+		dev->profile.chan[i].start = dev->ad770r_device->dac_value[i];
+	ad5770r_profile_start(&dev->profile, dev->ad770r_device->dac_value);
+	dev->profile_ticks = 0;
+	dev->profile_ticks_done = 0;
+	dev->profile_prescaler_cnt = 0;
+
+	if(!dev->profile_timer) {
+		timer_init.f_update = AD5770R_PMDZ_PROFILE_RATE;
+		timer_init.update_timer = AD5770R_PMDZ_PROFILE_TIMER;
+		timer_init.callback_func_ptr = ad5770r_pmdz_profile_callback;
+		timer_init.callback_param = dev;
+		ret = timer_counter_setup(&dev->profile_timer, &timer_init);
+		if(ret != SUCCESS)
+			return ret;
+	}
+
+	dev->profile_running = true;
+
+	return timer_counter_activate(dev->profile_timer, true);
+}
+
+/**
+ * Stop the current profiles and keep the present outputs.
+ *
+ * @param [in] dev - The device structure.
+ * @param [in] arg - Not used in this case. It exists to keep the function
+ *                   prototype compatible with the other functions that can be
+ *                   called from the CLI.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t ad5770r_pmdz_stop_profile(struct ad5770r_pmdz_dev *dev, uint8_t *arg)
+{
+	if(!dev->profile_running)
+		return SUCCESS;
+
+	dev->profile_running = false;
+
+	return timer_counter_activate(dev->profile_timer, false);
+}
+
 /**
  * Production test routine.
  *
@@ -921,7 +1280,7 @@ void ad5770r_pmdz_get_config(struct ad5770r_pmdz_init_param *init_param)
 /**
  * Application main process.
  *
- * Runs the Command Line Interpretor.
+ * Updates the running current profile and runs the Command Line Interpretor.
  *
  * @param [in] dev - Pointer to the application handler.
  *
@@ -929,6 +1288,12 @@ void ad5770r_pmdz_get_config(struct ad5770r_pmdz_init_param *init_param)
  */
 int32_t ad5770r_pmdz_process(struct ad5770r_pmdz_dev *dev)
 {
+	int32_t ret;
+
+	ret = ad5770r_pmdz_profile_service(dev);
+	if(ret != SUCCESS)
+		return ret;
+
 	return cli_process(dev->cli_device);
 }
 
@@ -997,6 +1362,15 @@ int32_t ad5770r_pmdz_remove(struct ad5770r_pmdz_dev *dev)
 	if(!dev)
 		return FAILURE;
 
+	if(dev->profile_timer) {
+		ret = ad5770r_pmdz_stop_profile(dev, NULL);
+		if(ret != SUCCESS)
+			return ret;
+		ret = timer_counter_remove(dev->profile_timer);
+		if(ret != SUCCESS)
+			return ret;
+	}
+
 	ret = ad5770r_remove(dev->ad770r_device);
 	if(ret != SUCCESS)
 		return ret;
@@ -45,7 +45,9 @@
 /******************************************************************************/
 
 #include "ad5770r.h"
+#include "ad5770r_profile.h"
 #include "cli.h"
+#include "timer.h"
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -54,6 +56,10 @@
 #define HELP_SHORT_COMMAND true
 #define HELP_LONG_COMMAND false
 
+/* GP timer and tick rate of the current profiles; one tick is 1 ms */
+#define AD5770R_PMDZ_PROFILE_TIMER	1
+#define AD5770R_PMDZ_PROFILE_RATE	1000
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -66,6 +72,13 @@ struct ad5770r_pmdz_init_param {
 struct ad5770r_pmdz_dev {
 	struct ad5770r_dev *ad770r_device;
 	struct cli_desc *cli_device;
+	struct timer_counter_desc *profile_timer;
+	struct ad5770r_profile profile;
+	/* Ticks counted by the timer and ticks applied by the main loop */
+	volatile uint32_t profile_ticks;
+	uint32_t profile_ticks_done;
+	uint8_t profile_prescaler_cnt;
+	bool profile_running;
 };
 
 /******************************************************************************/
@@ -87,6 +100,18 @@ int32_t ad5770r_pmdz_set_chan(struct ad5770r_pmdz_dev *dev, uint8_t *arg);
 /* Set output range for a channel. */
 int32_t ad5770r_pmdz_set_range(struct ad5770r_pmdz_dev *dev, uint8_t *arg);
 
+/* Set the current profile of a channel. */
+int32_t ad5770r_pmdz_set_profile(struct ad5770r_pmdz_dev *dev, uint8_t *arg);
+
+/* Set the slew rate limit of a channel. */
+int32_t ad5770r_pmdz_set_slew(struct ad5770r_pmdz_dev *dev, uint8_t *arg);
+
+/* Start the current profiles of all channels. */
+int32_t ad5770r_pmdz_run_profile(struct ad5770r_pmdz_dev *dev, uint8_t *arg);
+
+/* Stop the current profiles. */
+int32_t ad5770r_pmdz_stop_profile(struct ad5770r_pmdz_dev *dev, uint8_t *arg);
+
 /* Production test routine. */
 int32_t ad5770r_pmdz_prod_test(struct ad5770r_pmdz_dev *dev, uint8_t *arg);
 
@@ -0,0 +1,175 @@
+/***************************************************************************//**
+ *   @file   ad5770r_profile.c
+ *   @brief  Time-sequenced current profiles for the AD5770R channels.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include "ad5770r_profile.h"
+
+/******************************************************************************/
+/************************** Functions Implementation **************************/
+/******************************************************************************/
+/**
+ * Code a channel profile asks for at a given time.
+ * @param chan - The channel profile.
+ * @param tick - Ticks since the profile was started.
+ * @param code - The current code, kept by AD5770R_PROFILE_HOLD.
+ * @param final - Set to false while the profile still changes the target.
+ * @return The target code.
+ */
+static uint16_t ad5770r_profile_target(const struct ad5770r_profile_chan *chan,
+				       uint32_t tick, uint16_t code, bool *final)
+{
+	uint32_t phase;
+	int32_t span;
+
+	*final = true;
+
+	switch (chan->type) {
+	case AD5770R_PROFILE_STEP:
+		if (tick >= chan->duration)
+			return chan->end;
+		*final = false;
+		return chan->start;
+	case AD5770R_PROFILE_RAMP:
+		if (tick >= chan->duration)
+			return chan->end;
+		*final = false;
+		span = (int32_t)chan->end - (int32_t)chan->start;
+		return (uint16_t)(chan->start +
+				  (int64_t)span * tick / chan->duration);
+	case AD5770R_PROFILE_PULSE:
+		if (chan->period) {
+			*final = false;
+			phase = tick % chan->period;
+		} else {
+			if (tick >= chan->duration)
+				return chan->start;
+			*final = false;
+			phase = tick;
+		}
+		return (phase < chan->duration) ? chan->end : chan->start;
+	default:
+		return code;
+	}
+}
+
+/**
+ * Move a code towards its target by no more than the slew limit.
+ * @param code - The current code.
+ * @param target - The target code.
+ * @param limit - Largest change, 0 for no limit.
+ * @return The new code.
+ */
+static uint16_t ad5770r_profile_slew(uint16_t code, uint16_t target,
+				     uint32_t limit)
+{
+	if (!limit)
+		return target;
+
+	if (target > code)
+		return ((uint32_t)(target - code) > limit) ?
+		       (uint16_t)(code + limit) : target;
+
+	return ((uint32_t)(code - target) > limit) ?
+	       (uint16_t)(code - limit) : target;
+}
+
+/**
+ * Start a profile from the current channel codes.
+ * @param profile - The profile, with the channel profiles filled in.
+ * @param code - Six codes the channels are at, channel 0 first.
+ * @return void
+ */
+void ad5770r_profile_start(struct ad5770r_profile *profile,
+			   const uint16_t *code)
+{
+	uint8_t i;
+
+	profile->tick = 0;
+	profile->done = false;
+	for (i = 0; i < AD5770R_CH_NUMBER; i++)
+		profile->code[i] = code[i];
+}
+
+/**
+ * Advance a profile and compute the codes of all channels.
+ *
+ * If the caller falls behind, several ticks can be passed at once: the
+ * profile stays on time and the slew limit scales with the elapsed ticks.
+ * @param profile - The profile started with ad5770r_profile_start().
+ * @param ticks - Ticks since the last call.
+ * @return true if any code in profile->code changed.
+ */
+bool ad5770r_profile_next(struct ad5770r_profile *profile, uint32_t ticks)
+{
+	const struct ad5770r_profile_chan *chan;
+	uint16_t target, code;
+	uint32_t limit;
+	bool changed = false;
+	bool final;
+	uint8_t i;
+
+	profile->tick += ticks;
+	profile->done = true;
+
+	/* A larger change than the full scale is no limit */
+	if (ticks > AD5770R_PROFILE_CODE_MAX)
+		ticks = AD5770R_PROFILE_CODE_MAX;
+
+	for (i = 0; i < AD5770R_CH_NUMBER; i++) {
+		chan = &profile->chan[i];
+
+		target = ad5770r_profile_target(chan, profile->tick,
+						profile->code[i], &final);
+		if (target > AD5770R_PROFILE_CODE_MAX)
+			target = AD5770R_PROFILE_CODE_MAX;
+
+		limit = (uint32_t)chan->slew * ticks;
+		code = ad5770r_profile_slew(profile->code[i], target, limit);
+
+		if (!final || (code != target))
+			profile->done = false;
+		if (code != profile->code[i]) {
+			profile->code[i] = code;
+			changed = true;
+		}
+	}
+
+	return changed;
+}
@@ -0,0 +1,98 @@
+/***************************************************************************//**
+ *   @file   ad5770r_profile.h
+ *   @brief  Header file for the AD5770R current profiles.
+********************************************************************************
+ * Copyright 2026(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef AD5770R_PROFILE_H_
+#define AD5770R_PROFILE_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "ad5770r.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+/* Largest 14-bit DAC code */
+#define AD5770R_PROFILE_CODE_MAX	0x3FFF
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+enum ad5770r_profile_type {
+	/* Keep the current code */
+	AD5770R_PROFILE_HOLD,
+	/* Jump from start to end after duration ticks */
+	AD5770R_PROFILE_STEP,
+	/* Go linearly from start to end in duration ticks */
+	AD5770R_PROFILE_RAMP,
+	/* Go to end for duration ticks, every period ticks */
+	AD5770R_PROFILE_PULSE
+};
+
+struct ad5770r_profile_chan {
+	enum ad5770r_profile_type	type;
+	uint16_t			start;
+	uint16_t			end;
+	/* Step delay, ramp length or pulse width in ticks */
+	uint32_t			duration;
+	/* Pulse period in ticks, 0 for a single pulse */
+	uint32_t			period;
+	/* Largest code change per tick, 0 for no limit */
+	uint16_t			slew;
+};
+
+struct ad5770r_profile {
+	struct ad5770r_profile_chan	chan[AD5770R_CH_NUMBER];
+	/* Ticks since ad5770r_profile_start() */
+	uint32_t			tick;
+	/* Codes of the last update */
+	uint16_t			code[AD5770R_CH_NUMBER];
+	/* All channels are at their final code */
+	bool				done;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+void ad5770r_profile_start(struct ad5770r_profile *profile,
+			   const uint16_t *code);
+bool ad5770r_profile_next(struct ad5770r_profile *profile, uint32_t ticks);
+
+#endif /* AD5770R_PROFILE_H_ */
@@ -0,0 +1,245 @@
+/* Host test of the AD5770R multichannel update and the current profiles
+ *
+ * The SPI and GPIO drivers are replaced by a model of the part: it decodes
+ * write streams into a register file, follows the address direction of the
+ * device settings, and copies the input registers to the DAC registers on a
+ * software LDAC write or on a rising edge of the LDAC pin.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "error.h"
+#include "ad5770r.h"
+#include "ad5770r_profile.h"
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+/* part model */
+static uint8_t regs[128];
+static int spi_transfers;
+static int gpio_writes;
+static int ldac_pulses;
+static uint8_t ldac_level = 1;
+static struct ad5770r_dev *model_dev;
+
+static void load_dac(uint8_t mask)
+{
+	int ch;
+
+	for (ch = 0; ch < AD5770R_CH_NUMBER; ch++) {
+		if (!(mask & (1 << ch)))
+			continue;
+		regs[AD5770R_CH0_DAC_LSB + 2 * ch] = regs[AD5770R_CH0_INPUT_LSB + 2 * ch];
+		regs[AD5770R_CH0_DAC_MSB + 2 * ch] = regs[AD5770R_CH0_INPUT_LSB + 2 * ch + 1];
+	}
+}
+
+static uint16_t dac_code(int ch)
+{
+	return (uint16_t)((regs[AD5770R_CH0_DAC_MSB + 2 * ch] << 6) |
+			  (regs[AD5770R_CH0_DAC_LSB + 2 * ch] >> 2));
+}
+
+static uint16_t input_code(int ch)
+{
+	return (uint16_t)((regs[AD5770R_CH0_INPUT_LSB + 2 * ch + 1] << 6) |
+			  (regs[AD5770R_CH0_INPUT_LSB + 2 * ch] >> 2));
+}
+
+int32_t spi_write_and_read(spi_desc *desc, uint8_t *data, uint8_t bytes_number)
+{
+	int addr = data[0] & 0x7F;
+	int i;
+
+	spi_transfers++;
+	/* only writes are expected */
+	CHECK(!(data[0] & 0x80));
+	for (i = 1; i < bytes_number; i++) {
+		regs[addr] = data[i];
+		if (addr == AD5770R_SW_LDAC)
+			load_dac(data[i]);
+		addr += model_dev->dev_spi_settings.addr_ascension ? 1 : -1;
+	}
+
+	return SUCCESS;
+}
+
+int32_t gpio_set_value(struct gpio_desc *desc, uint8_t value)
+{
+	gpio_writes++;
+	if (!ldac_level && value) {
+		ldac_pulses++;
+		load_dac(~regs[AD5770R_HW_LDAC] & AD5770R_SW_LDAC_ALL);
+	}
+	ldac_level = value;
+
+	return SUCCESS;
+}
+
+int32_t spi_init(spi_desc **desc, const spi_init_param *param)
+{
+	return SUCCESS;
+}
+
+int32_t spi_remove(spi_desc *desc)
+{
+	return SUCCESS;
+}
+
+int32_t gpio_get_optional(struct gpio_desc **desc,
+			  const struct gpio_init_param *param)
+{
+	return SUCCESS;
+}
+
+int32_t gpio_remove(struct gpio_desc *desc)
+{
+	return SUCCESS;
+}
+
+int32_t gpio_direction_input(struct gpio_desc *desc)
+{
+	return SUCCESS;
+}
+
+int32_t gpio_direction_output(struct gpio_desc *desc, uint8_t value)
+{
+	return SUCCESS;
+}
+
+static void test_multichannel(void)
+{
+	struct ad5770r_dev dev;
+	uint16_t v[AD5770R_CH_NUMBER] = {1, 0x3FFF, 0x2000, 123, 4567, 16000};
+	uint16_t w[AD5770R_CH_NUMBER] = {10, 20, 30, 40, 50, 60};
+	int ch;
+
+	memset(&dev, 0, sizeof(dev));
+	model_dev = &dev;
+
+	/* descending addresses: inputs and software LDAC in one stream */
+	spi_transfers = 0;
+	CHECK(ad5770r_set_dac_multichannel(&dev, v, AD5770R_LDAC_SW) == SUCCESS);
+	CHECK(spi_transfers == 1);
+	for (ch = 0; ch < AD5770R_CH_NUMBER; ch++) {
+		CHECK(input_code(ch) == v[ch] && dac_code(ch) == v[ch]);
+		CHECK(dev.dac_value[ch] == v[ch]);
+	}
+
+	/* inputs only, the outputs keep their codes */
+	spi_transfers = 0;
+	CHECK(ad5770r_set_dac_multichannel(&dev, w, AD5770R_LDAC_NONE) == SUCCESS);
+	CHECK(spi_transfers == 1);
+	for (ch = 0; ch < AD5770R_CH_NUMBER; ch++) {
+		CHECK(input_code(ch) == w[ch] && dac_code(ch) == v[ch]);
+		CHECK(dev.input_value[ch] == w[ch] && dev.dac_value[ch] == v[ch]);
+	}
+
+	/* ascending addresses: the LDAC register needs its own write */
+	dev.dev_spi_settings.addr_ascension = true;
+	spi_transfers = 0;
+	CHECK(ad5770r_set_dac_multichannel(&dev, w, AD5770R_LDAC_SW) == SUCCESS);
+	CHECK(spi_transfers == 2);
+	for (ch = 0; ch < AD5770R_CH_NUMBER; ch++)
+		CHECK(dac_code(ch) == w[ch]);
+
+	/* hardware LDAC needs the pin, masked channels keep their codes */
+	CHECK(ad5770r_set_dac_multichannel(&dev, v, AD5770R_LDAC_HW) == FAILURE);
+	dev.nldac = (struct gpio_desc *)1;
+	regs[AD5770R_HW_LDAC] = AD5770R_HW_LDAC_MASK_CH(1, AD5770R_CH2);
+	dev.mask_hw_ldac.en2 = true;
+	spi_transfers = 0;
+	gpio_writes = 0;
+	ldac_pulses = 0;
+	CHECK(ad5770r_set_dac_multichannel(&dev, v, AD5770R_LDAC_HW) == SUCCESS);
+	CHECK(spi_transfers == 1 && gpio_writes == 2 && ldac_pulses == 1);
+	for (ch = 0; ch < AD5770R_CH_NUMBER; ch++) {
+		CHECK(dac_code(ch) == (ch == AD5770R_CH2 ? w[ch] : v[ch]));
+		CHECK(dev.dac_value[ch] == (ch == AD5770R_CH2 ? w[ch] : v[ch]));
+	}
+
+	/* settings that cannot stream all channels */
+	dev.dev_spi_settings.single_instruction = true;
+	CHECK(ad5770r_set_dac_multichannel(&dev, v, AD5770R_LDAC_SW) == FAILURE);
+	dev.dev_spi_settings.single_instruction = false;
+	dev.dev_spi_settings.stream_mode_length = 4;
+	CHECK(ad5770r_set_dac_multichannel(&dev, v, AD5770R_LDAC_SW) == FAILURE);
+}
+
+static void test_profile(void)
+{
+	struct ad5770r_profile p;
+	uint16_t code[AD5770R_CH_NUMBER] = {0, 1000, 0, 500, 0, 0};
+	uint32_t t;
+
+	memset(&p, 0, sizeof(p));
+	p.chan[0] = (struct ad5770r_profile_chan) {
+		AD5770R_PROFILE_RAMP, 0, 1000, 10, 0, 0
+	};
+	p.chan[1] = (struct ad5770r_profile_chan) {
+		AD5770R_PROFILE_STEP, 1000, 3000, 5, 0, 100
+	};
+	p.chan[2] = (struct ad5770r_profile_chan) {
+		AD5770R_PROFILE_PULSE, 0, 800, 2, 5, 0
+	};
+	p.chan[4] = (struct ad5770r_profile_chan) {
+		AD5770R_PROFILE_PULSE, 0, 900, 3, 0, 0
+	};
+	ad5770r_profile_start(&p, code);
+	for (t = 1; t <= 40; t++) {
+		ad5770r_profile_next(&p, 1);
+		if (t == 5)
+			CHECK(p.code[0] == 500 && p.code[1] == 1100);
+		if (t == 10)
+			CHECK(p.code[0] == 1000);
+		if (t < 5)
+			CHECK(p.code[1] == 1000);
+		/* periodic pulse, then a single one */
+		CHECK(p.code[2] == ((t % 5) < 2 ? 800 : 0));
+		CHECK(p.code[3] == 500);
+		CHECK(p.code[4] == (t < 3 ? 900 : 0));
+	}
+	/* the slew limited step reaches its end at tick 24 */
+	CHECK(p.code[1] == 3000);
+	/* a periodic pulse never ends */
+	CHECK(!p.done);
+	p.chan[2].type = AD5770R_PROFILE_HOLD;
+	ad5770r_profile_next(&p, 1);
+	CHECK(p.done);
+
+	/* a late caller keeps the time and the slew scales with the ticks */
+	memset(&p, 0, sizeof(p));
+	p.chan[0] = (struct ad5770r_profile_chan) {
+		AD5770R_PROFILE_STEP, 0, AD5770R_PROFILE_CODE_MAX, 0, 0, 10
+	};
+	ad5770r_profile_start(&p, code);
+	ad5770r_profile_next(&p, 3);
+	CHECK(p.code[0] == 30);
+	ad5770r_profile_next(&p, 100000);
+	CHECK(p.code[0] == AD5770R_PROFILE_CODE_MAX && p.done);
+
+	/* long ramp down */
+	memset(&p, 0, sizeof(p));
+	p.chan[5] = (struct ad5770r_profile_chan) {
+		AD5770R_PROFILE_RAMP, 16000, 0, 4000000, 0, 0
+	};
+	ad5770r_profile_start(&p, code);
+	ad5770r_profile_next(&p, 2000000);
+	CHECK(p.code[5] == 8000);
+}
+
+int main(void)
+{
+	test_multichannel();
+	test_profile();
+
+	printf("%s\n", failures ? "FAILED" : "OK");
+	return failures ? 1 : 0;
+}
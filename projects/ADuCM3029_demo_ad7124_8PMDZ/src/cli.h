@@ -44,6 +44,7 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 
+#include <stdbool.h>
 #include "uart.h"
 
 /******************************************************************************/
@@ -58,6 +59,10 @@
 
 #define CLI_WIDTH 80
 
+/** Size of the command lookup table. Must be a power of 2 and greater than
+ * the number of command calls (long and short names). */
+#define CLI_HASH_SIZE 64
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -90,6 +95,10 @@ struct cli_desc {
 	cmd_func		*v_cmd_fun;
 	/** CLI command function table. */
 	uint8_t			*command_size;
+	/** Command lookup table, see cli_build_hash(). */
+	uint8_t			cmd_hash[CLI_HASH_SIZE];
+	/** The lookup table matches the loaded command tables. */
+	bool			cmd_hash_valid;
 };
 
 /******************************************************************************/
@@ -116,8 +125,8 @@ int32_t cli_parse(struct cli_desc *dev, uint8_t c);
 int32_t cli_process(struct cli_desc *dev);
 
 /** Get the CLI commands and correlate them to functions. */
-void cli_find_command(struct cli_desc *dev, uint8_t *command,
-		      cmd_func* function);
+int32_t cli_find_command(struct cli_desc *dev, uint8_t *command,
+			 cmd_func* function);
 
 /** Display command prompt for the user on the CLI at the beginning of the
  *  program. */
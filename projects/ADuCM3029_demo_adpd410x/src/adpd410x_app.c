@@ -49,6 +49,13 @@
 #include "no_os_delay.h"
 #include "no_os_util.h"
 
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+#define ADPD410X_APP_REG_FIFO_STATUS	0x0000
+#define ADPD410X_APP_CLEAR_FIFO		0x8000
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -443,3 +450,73 @@ int32_t adpd410x_app_remove(struct adpd410x_app_dev *dev)
 
 	return 0;
 }
+
+/**
+ * @brief Clear the FIFO and start sampling.
+ * @param [in] dev - The application handler.
+ * @param [in] mask - Unused, all time slots are sampled.
+ * @return 0 in case of success, negative code otherwise.
+ */
+int32_t adpd410x_app_stream_start(void *dev, uint32_t mask)
+{
+	struct adpd410x_app_dev *app = dev;
+	int32_t ret;
+	int8_t i;
+
+	app->set_bytes = 0;
+	for (i = 0; i < ADPD410X_ACTIVE_TIMESLOTS; i++)
+		app->set_bytes += ts_init_tab[i].byte_no *
+				  (ts_init_tab[i].enable_ch2 ? 2 : 1);
+
+	ret = adpd410x_set_opmode(app->adpd4100_handler, ADPD410X_STANDBY);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	ret = adpd410x_reg_write(app->adpd4100_handler,
+				 ADPD410X_APP_REG_FIFO_STATUS,
+				 ADPD410X_APP_CLEAR_FIFO);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	return adpd410x_set_opmode(app->adpd4100_handler, ADPD410X_GOMODE);
+}
+
+/**
+ * @brief Stop sampling.
+ * @param [in] dev - The application handler.
+ * @return 0 in case of success, negative code otherwise.
+ */
+int32_t adpd410x_app_stream_stop(void *dev)
+{
+	struct adpd410x_app_dev *app = dev;
+
+	return adpd410x_set_opmode(app->adpd4100_handler, ADPD410X_STANDBY);
+}
+
+/**
+ * @brief Read one sample set if it is in the FIFO.
+ *
+ * adpd410x_get_data() waits for a full set, so the FIFO byte count is checked
+ * first to keep the producer interrupt short.
+ * @param [in] dev - The application handler.
+ * @param [out] set - One word for each enabled channel of each time slot.
+ * @return 1 if a set was read, 0 if none is ready, negative code otherwise.
+ */
+int32_t adpd410x_app_stream_poll(void *dev, uint32_t *set)
+{
+	struct adpd410x_app_dev *app = dev;
+	uint16_t bytes;
+	int32_t ret;
+
+	ret = adpd410x_get_fifo_bytecount(app->adpd4100_handler, &bytes);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+	if (bytes < app->set_bytes)
+		return 0;
+
+	ret = adpd410x_get_data(app->adpd4100_handler, set);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	return 1;
+}
@@ -60,6 +60,8 @@ struct adpd410x_app_dev {
 	struct adpd410x_dev *adpd4100_handler;
 	/** Chip id */
 	uint16_t chip_id;
+	/** Bytes of a sample set in the FIFO, set by adpd410x_app_stream_start() */
+	uint16_t set_bytes;
 };
 
 /******************************************************************************/
@@ -72,4 +74,13 @@ int32_t adpd410x_app_init(struct adpd410x_app_dev **device);
 /** Free memory allocated by adpd410x_app_init(). */
 int32_t adpd410x_app_remove(struct adpd410x_app_dev *dev);
 
+/** Clear the FIFO and start sampling. */
+int32_t adpd410x_app_stream_start(void *dev, uint32_t mask);
+
+/** Stop sampling. */
+int32_t adpd410x_app_stream_stop(void *dev);
+
+/** Read one sample set if it is in the FIFO. */
+int32_t adpd410x_app_stream_poll(void *dev, uint32_t *set);
+
 #endif /* ADPD410X_APP_H_ */
@@ -0,0 +1,625 @@
+/***************************************************************************//**
+ *   @file   iio_stream.c
+ *   @brief  Buffered IIO streaming implementation
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/platform.h>
+#include <drivers/tmr/adi_tmr.h>
+#include <drivers/pwr/adi_pwr.h>
+#include "iio_stream.h"
+#include "no_os_error.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** GP timer 0 is used by the delay functions */
+#define IIO_STREAM_TMR		ADI_TMR_DEVICE_GP1
+#define IIO_STREAM_TMR_IRQ	TMR1_EVT_IRQn
+/** HFOSC divided by the timer prescaler */
+#define IIO_STREAM_TMR_CLK	(26000000u / 16u)
+#define IIO_STREAM_MIN_HZ	25
+#define IIO_STREAM_MAX_HZ	1000
+
+/** Stream attributes appended to the device ones */
+#define IIO_STREAM_NB_ATTR	3
+
+enum iio_stream_attr {
+	IIO_STREAM_ATTR_OVERRUNS,
+	IIO_STREAM_ATTR_DROPPED,
+	IIO_STREAM_ATTR_TIMESTAMP
+};
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/** The IIO callbacks only get the device, so one stream is supported */
+static struct iio_stream *active_stream;
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Get the time in microseconds from the cycle counter.
+ * @param [in] stream - The stream structure.
+ * @return Timestamp in microseconds.
+ */
+static uint32_t iio_stream_timestamp(struct iio_stream *stream)
+{
+	uint32_t cycles = DWT->CYCCNT;
+
+	/* Called at least each 40 ms, much more often than the counter wraps */
+	if (cycles < stream->cycles_last)
+		stream->cycles_hi++;
+	stream->cycles_last = cycles;
+
+	return (((uint64_t)stream->cycles_hi << 32) | cycles) /
+	       stream->cycles_per_us;
+}
+
+/**
+ * @brief Producer timer callback.
+ * @param [in] param - The stream structure.
+ * @param [in] event - Unused.
+ * @param [in] arg - Unused.
+ */
+static void iio_stream_tmr_callback(void *param, uint32_t event, void *arg)
+{
+	struct iio_stream *stream = param;
+
+	iio_stream_produce(stream, iio_stream_timestamp(stream));
+}
+
+/**
+ * @brief Show a stream attribute.
+ * @param [in] device - Unused.
+ * @param [out] buf - Buffer where the value is written.
+ * @param [in] len - Size of buf.
+ * @param [in] channel - Unused.
+ * @param [in] priv - Attribute id.
+ * @return Length of the value, negative code otherwise.
+ */
+static int iio_stream_attr_show(void *device, char *buf, uint32_t len,
+				const struct iio_ch_info *channel,
+				intptr_t priv)
+{
+	struct iio_stream *stream = active_stream;
+	uint32_t val;
+
+	switch (priv) {
+	case IIO_STREAM_ATTR_OVERRUNS:
+		val = stream->overruns;
+		break;
+	case IIO_STREAM_ATTR_DROPPED:
+		val = stream->dropped;
+		break;
+	case IIO_STREAM_ATTR_TIMESTAMP:
+		/* First sample set of the half the client reads from */
+		val = stream->timestamp[stream->rd_half];
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return snprintf(buf, len, "%"PRIu32, val);
+}
+
+/**
+ * @brief Show a device or channel attribute while the producer is stopped.
+ *
+ * The producer interrupt runs SPI transfers on the device, so the device is
+ * not accessed from the IIO server while a stream is running.
+ * @param [in] device - The device passed to the attribute.
+ * @param [out] buf - Buffer where the value is written.
+ * @param [in] len - Size of buf.
+ * @param [in] channel - Channel of the attribute.
+ * @param [in] priv - Index of the attribute in stream->dev_attr.
+ * @return Length of the value, negative code otherwise.
+ */
+static int iio_stream_dev_show(void *device, char *buf, uint32_t len,
+			       const struct iio_ch_info *channel,
+			       intptr_t priv)
+{
+	struct iio_attribute *attr = active_stream->dev_attr[priv];
+
+	if (active_stream->running)
+		return -EBUSY;
+
+	return attr->show(device, buf, len, channel, attr->priv);
+}
+
+/**
+ * @brief Store a device or channel attribute while the producer is stopped.
+ * @param [in] device - The device passed to the attribute.
+ * @param [in] buf - Value to store.
+ * @param [in] len - Length of the value.
+ * @param [in] channel - Channel of the attribute.
+ * @param [in] priv - Index of the attribute in stream->dev_attr.
+ * @return Length of the value, negative code otherwise.
+ */
+static int iio_stream_dev_store(void *device, char *buf, uint32_t len,
+				const struct iio_ch_info *channel,
+				intptr_t priv)
+{
+	struct iio_attribute *attr = active_stream->dev_attr[priv];
+
+	if (active_stream->running)
+		return -EBUSY;
+
+	return attr->store(device, buf, len, channel, attr->priv);
+}
+
+/**
+ * @brief IIO debug_reg_read callback, refused while the producer runs.
+ * @param [in] dev - The device.
+ * @param [in] reg - Register address.
+ * @param [out] readval - Register value.
+ * @return 0 in case of success, negative code otherwise.
+ */
+static int32_t iio_stream_debug_reg_read(void *dev, uint32_t reg,
+		uint32_t *readval)
+{
+	if (active_stream->running)
+		return -EBUSY;
+
+	return active_stream->debug_reg_read(dev, reg, readval);
+}
+
+/**
+ * @brief IIO debug_reg_write callback, refused while the producer runs.
+ * @param [in] dev - The device.
+ * @param [in] reg - Register address.
+ * @param [in] writeval - Register value.
+ * @return 0 in case of success, negative code otherwise.
+ */
+static int32_t iio_stream_debug_reg_write(void *dev, uint32_t reg,
+		uint32_t writeval)
+{
+	if (active_stream->running)
+		return -EBUSY;
+
+	return active_stream->debug_reg_write(dev, reg, writeval);
+}
+
+/**
+ * @brief Count the attributes of a NULL name terminated list.
+ * @param [in] attr - The attribute list, may be NULL.
+ * @return Number of attributes.
+ */
+static uint32_t iio_stream_attr_count(struct iio_attribute *attr)
+{
+	uint32_t nb = 0;
+
+	if (attr)
+		while (attr[nb].name)
+			nb++;
+
+	return nb;
+}
+
+/**
+ * @brief Copy a device attribute list with the show and store wrapped.
+ * @param [in] s - The stream structure.
+ * @param [out] dst - Where the wrapped attributes are written.
+ * @param [in] src - The device attributes, may be NULL.
+ * @param [in, out] idx - Next free index in s->dev_attr.
+ * @return Number of attributes copied.
+ */
+static uint32_t iio_stream_attr_wrap(struct iio_stream *s,
+				     struct iio_attribute *dst,
+				     struct iio_attribute *src,
+				     uint32_t *idx)
+{
+	uint32_t i, nb = iio_stream_attr_count(src);
+
+	for (i = 0; i < nb; i++) {
+		dst[i] = src[i];
+		dst[i].priv = *idx;
+		if (src[i].show)
+			dst[i].show = iio_stream_dev_show;
+		if (src[i].store)
+			dst[i].store = iio_stream_dev_store;
+		s->dev_attr[(*idx)++] = &src[i];
+	}
+
+	return nb;
+}
+
+/**
+ * @brief IIO read_dev callback, reads from the double buffer.
+ * @param [in] dev - Unused.
+ * @param [out] buff - Buffer where the samples are written.
+ * @param [in] nb_samples - Number of samples per channel.
+ * @return Number of samples read, negative code otherwise.
+ */
+static int32_t iio_stream_read_dev(void *dev, void *buff, uint32_t nb_samples)
+{
+	return iio_stream_read(active_stream, buff, nb_samples);
+}
+
+/**
+ * @brief IIO prepare_transfer callback, starts the producer.
+ * @param [in] dev - Unused.
+ * @param [in] mask - Channels enabled by the client.
+ * @return 0 in case of success, negative code otherwise.
+ */
+static int32_t iio_stream_prepare_transfer(void *dev, uint32_t mask)
+{
+	return iio_stream_start(active_stream, mask);
+}
+
+/**
+ * @brief IIO end_transfer callback, stops the producer.
+ * @param [in] dev - Unused.
+ * @return 0 in case of success, negative code otherwise.
+ */
+static int32_t iio_stream_end_transfer(void *dev)
+{
+	return iio_stream_stop(active_stream);
+}
+
+/**
+ * @brief Allocate a stream and its double buffer.
+ *
+ * The device descriptor is copied to stream->descriptor with the buffer
+ * callbacks replaced and the overruns, dropped and timestamp attributes
+ * added. The device and channel attributes and the register access are
+ * wrapped to return -EBUSY while the stream runs, since the producer
+ * interrupt uses the same SPI device. stream->descriptor must be registered
+ * to IIO instead of the device descriptor.
+ * @param [out] stream - Pointer to the stream handler.
+ * @param [in] param - Pointer to the initialization structure.
+ * @return 0 in case of success, negative code otherwise.
+ */
+int32_t iio_stream_init(struct iio_stream **stream,
+			struct iio_stream_init_param *param)
+{
+	struct iio_device *desc;
+	struct iio_attribute *ch_attr;
+	struct iio_stream *s;
+	uint32_t nb_attr, nb_ch_attr = 0, idx = 0;
+	uint32_t hclk;
+	uint32_t i;
+
+	if (!stream || !param || !param->descriptor || !param->poll ||
+	    !param->nb_ch || param->nb_ch > IIO_STREAM_MAX_CH ||
+	    !param->half_size || param->poll_hz < IIO_STREAM_MIN_HZ ||
+	    param->poll_hz > IIO_STREAM_MAX_HZ || active_stream)
+		return -EINVAL;
+
+	s = (struct iio_stream *)calloc(1, sizeof(*s));
+	if (!s)
+		return -ENOMEM;
+
+	s->half[0] = (uint32_t *)calloc(2 * param->half_size * param->nb_ch,
+					sizeof(uint32_t));
+	if (!s->half[0])
+		goto error_stream;
+	s->half[1] = s->half[0] + param->half_size * param->nb_ch;
+
+	desc = param->descriptor;
+	nb_attr = iio_stream_attr_count(desc->attributes);
+	for (i = 0; i < desc->num_ch; i++)
+		nb_ch_attr += iio_stream_attr_count(desc->channels[i].attributes);
+
+	s->dev_attr = (struct iio_attribute **)calloc(nb_attr + nb_ch_attr + 1,
+			sizeof(*s->dev_attr));
+	if (!s->dev_attr)
+		goto error_buff;
+	s->channels = (struct iio_channel *)calloc(desc->num_ch + 1,
+			sizeof(*s->channels));
+	if (!s->channels)
+		goto error_dev_attr;
+	/* Each channel list keeps its NULL name terminator */
+	s->ch_attributes = (struct iio_attribute *)calloc(nb_ch_attr +
+			   desc->num_ch + 1, sizeof(*s->ch_attributes));
+	if (!s->ch_attributes)
+		goto error_channels;
+	s->attributes = (struct iio_attribute *)calloc(nb_attr +
+			IIO_STREAM_NB_ATTR + 1, sizeof(*s->attributes));
+	if (!s->attributes)
+		goto error_ch_attr;
+
+	ch_attr = s->ch_attributes;
+	for (i = 0; i < desc->num_ch; i++) {
+		s->channels[i] = desc->channels[i];
+		if (!desc->channels[i].attributes)
+			continue;
+		s->channels[i].attributes = ch_attr;
+		ch_attr += iio_stream_attr_wrap(s, ch_attr,
+						desc->channels[i].attributes,
+						&idx) + 1;
+	}
+
+	i = iio_stream_attr_wrap(s, s->attributes, desc->attributes, &idx);
+	s->attributes[i].name = "stream_overruns";
+	s->attributes[i].priv = IIO_STREAM_ATTR_OVERRUNS;
+	s->attributes[i++].show = iio_stream_attr_show;
+	s->attributes[i].name = "stream_dropped";
+	s->attributes[i].priv = IIO_STREAM_ATTR_DROPPED;
+	s->attributes[i++].show = iio_stream_attr_show;
+	s->attributes[i].name = "stream_timestamp_us";
+	s->attributes[i].priv = IIO_STREAM_ATTR_TIMESTAMP;
+	s->attributes[i++].show = iio_stream_attr_show;
+
+	s->descriptor = *desc;
+	s->descriptor.channels = s->channels;
+	s->descriptor.attributes = s->attributes;
+	s->debug_reg_read = desc->debug_reg_read;
+	s->debug_reg_write = desc->debug_reg_write;
+	if (desc->debug_reg_read)
+		s->descriptor.debug_reg_read = iio_stream_debug_reg_read;
+	if (desc->debug_reg_write)
+		s->descriptor.debug_reg_write = iio_stream_debug_reg_write;
+	s->descriptor.read_dev = iio_stream_read_dev;
+	s->descriptor.prepare_transfer = iio_stream_prepare_transfer;
+	s->descriptor.end_transfer = iio_stream_end_transfer;
+
+	s->dev = param->dev;
+	s->start = param->start;
+	s->stop = param->stop;
+	s->poll = param->poll;
+	s->nb_ch = param->nb_ch;
+	s->half_size = param->half_size;
+	s->poll_hz = param->poll_hz;
+	s->state[0] = IIO_STREAM_FREE;
+	s->state[1] = IIO_STREAM_FREE;
+
+	/* Cycle counter used for the timestamps */
+	if (adi_pwr_GetClockFrequency(ADI_CLOCK_HCLK, &hclk) != ADI_PWR_SUCCESS)
+		hclk = 26000000;
+	s->cycles_per_us = hclk / 1000000;
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	s->cycles_last = DWT->CYCCNT;
+
+	if (adi_tmr_Init(IIO_STREAM_TMR, iio_stream_tmr_callback, s, true) !=
+	    ADI_TMR_SUCCESS)
+		goto error_attr;
+	/* Let the SPI, I2C and UART interrupts preempt the producer */
+	NVIC_SetPriority(IIO_STREAM_TMR_IRQ, (1 << __NVIC_PRIO_BITS) - 1);
+
+	active_stream = s;
+	*stream = s;
+
+	return 0;
+
+error_attr:
+	free(s->attributes);
+error_ch_attr:
+	free(s->ch_attributes);
+error_channels:
+	free(s->channels);
+error_dev_attr:
+	free(s->dev_attr);
+error_buff:
+	free(s->half[0]);
+error_stream:
+	free(s);
+
+	return -ENOMEM;
+}
+
+/**
+ * @brief Free memory allocated by iio_stream_init().
+ * @param [in] stream - The stream structure.
+ * @return 0 in case of success, negative code otherwise.
+ */
+int32_t iio_stream_remove(struct iio_stream *stream)
+{
+	if (!stream)
+		return -EINVAL;
+
+	iio_stream_stop(stream);
+	active_stream = NULL;
+	free(stream->attributes);
+	free(stream->ch_attributes);
+	free(stream->channels);
+	free(stream->dev_attr);
+	free(stream->half[0]);
+	free(stream);
+
+	return 0;
+}
+
+/**
+ * @brief Start the producer on the channels in mask.
+ * @param [in] stream - The stream structure.
+ * @param [in] mask - Channels enabled by the client.
+ * @return 0 in case of success, negative code otherwise.
+ */
+int32_t iio_stream_start(struct iio_stream *stream, uint32_t mask)
+{
+	ADI_TMR_CONFIG tmr_conf;
+	int32_t ret;
+
+	if (!stream)
+		return -EINVAL;
+
+	iio_stream_stop(stream);
+
+	stream->mask = mask & ((1u << stream->nb_ch) - 1);
+	stream->state[0] = IIO_STREAM_FREE;
+	stream->state[1] = IIO_STREAM_FREE;
+	stream->wr_half = 0;
+	stream->wr_pos = 0;
+	stream->rd_half = 0;
+	stream->rd_pos = 0;
+	stream->overruns = 0;
+	stream->dropped = 0;
+	stream->errors = 0;
+
+	if (stream->start) {
+		ret = stream->start(stream->dev, stream->mask);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
+
+	tmr_conf.bCountingUp = false;
+	tmr_conf.bPeriodic = true;
+	tmr_conf.ePrescaler = ADI_TMR_PRESCALER_16;
+	tmr_conf.eClockSource = ADI_TMR_CLOCK_HFOSC;
+	tmr_conf.nLoad = IIO_STREAM_TMR_CLK / stream->poll_hz;
+	tmr_conf.nAsyncLoad = tmr_conf.nLoad;
+	tmr_conf.bReloading = true;
+	tmr_conf.bSyncBypass = true;
+	while (ADI_TMR_DEVICE_BUSY == adi_tmr_ConfigTimer(IIO_STREAM_TMR,
+			&tmr_conf));
+
+	stream->running = true;
+	while (ADI_TMR_DEVICE_BUSY == adi_tmr_Enable(IIO_STREAM_TMR, true));
+
+	return 0;
+}
+
+/**
+ * @brief Stop the producer.
+ * @param [in] stream - The stream structure.
+ * @return 0 in case of success, negative code otherwise.
+ */
+int32_t iio_stream_stop(struct iio_stream *stream)
+{
+	if (!stream)
+		return -EINVAL;
+
+	if (!stream->running)
+		return 0;
+
+	while (ADI_TMR_DEVICE_BUSY == adi_tmr_Enable(IIO_STREAM_TMR, false));
+	stream->running = false;
+
+	if (stream->stop)
+		return stream->stop(stream->dev);
+
+	return 0;
+}
+
+/**
+ * @brief Move the sample sets ready in the device to the double buffer.
+ *
+ * Runs in the producer interrupt. When the half being filled is full it is
+ * handed to the consumer and filling goes on in the other half. If the
+ * consumer still holds the other half, the device is drained anyway and the
+ * sample sets are dropped until it is released.
+ * @param [in] stream - The stream structure.
+ * @param [in] timestamp - Time in microseconds the sets are collected at.
+ */
+void iio_stream_produce(struct iio_stream *stream, uint32_t timestamp)
+{
+	uint32_t set[IIO_STREAM_MAX_CH];
+	uint32_t h;
+	int32_t ret;
+
+	while (stream->running) {
+		ret = stream->poll(stream->dev, set);
+		if (ret <= 0) {
+			if (ret < 0)
+				stream->errors++;
+			return;
+		}
+
+		h = stream->wr_half;
+		if (stream->state[h] == IIO_STREAM_FREE) {
+			stream->state[h] = IIO_STREAM_FILLING;
+			stream->wr_pos = 0;
+		}
+		if (stream->state[h] != IIO_STREAM_FILLING) {
+			stream->dropped++;
+			continue;
+		}
+
+		if (!stream->wr_pos)
+			stream->timestamp[h] = timestamp;
+		memcpy(&stream->half[h][stream->wr_pos * stream->nb_ch], set,
+		       stream->nb_ch * sizeof(uint32_t));
+		if (++stream->wr_pos == stream->half_size) {
+			stream->state[h] = IIO_STREAM_READY;
+			stream->wr_half = h ^ 1;
+			if (stream->state[h ^ 1] != IIO_STREAM_FREE)
+				stream->overruns++;
+		}
+	}
+}
+
+/**
+ * @brief Copy sample sets of the enabled channels to buff.
+ *
+ * Waits for the producer when no half is ready. Each enabled channel takes
+ * one 32 bit word, in channel order.
+ * @param [in] stream - The stream structure.
+ * @param [out] buff - Buffer where the samples are written.
+ * @param [in] nb_samples - Number of sample sets to read.
+ * @return Number of sample sets read, negative code otherwise.
+ */
+int32_t iio_stream_read(struct iio_stream *stream, uint32_t *buff,
+			uint32_t nb_samples)
+{
+	uint32_t *set;
+	uint32_t i, ch;
+
+	if (!stream || !buff)
+		return -EINVAL;
+
+	for (i = 0; i < nb_samples; i++) {
+		while (stream->state[stream->rd_half] != IIO_STREAM_READY)
+			if (!stream->running)
+				return -EIO;
+
+		set = &stream->half[stream->rd_half][stream->rd_pos *
+						     stream->nb_ch];
+		for (ch = 0; ch < stream->nb_ch; ch++)
+			if (stream->mask & (1u << ch))
+				*buff++ = set[ch];
+
+		if (++stream->rd_pos == stream->half_size) {
+			stream->rd_pos = 0;
+			stream->state[stream->rd_half] = IIO_STREAM_FREE;
+			stream->rd_half ^= 1;
+		}
+	}
+
+	return nb_samples;
+}
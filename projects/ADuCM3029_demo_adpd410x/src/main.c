@@ -45,6 +45,7 @@
 #include "adi_initialize.h"
 
 #include "adpd410x_app.h"
+#include "iio_stream.h"
 #include "no_os_error.h"
 #include "iio_adpd410x.h"
 #include "iio_app.h"
@@ -56,11 +57,16 @@ static uint32_t in_buff[MAX_SIZE_BASE_ADDR];
 
 #define ADPD410X_BASEADDR		((uint32_t)in_buff)
 
+/** Sample sets in each half of the stream double buffer */
+#define STREAM_HALF_SIZE		64
+/** Producer rate, a few times the output data rate to keep the FIFO low */
+#define STREAM_POLL_HZ			200
+
 int main(int argc, char *argv[])
 {
 	int32_t ret;
 	struct adpd410x_app_dev *adpd410x_app;
-	uint32_t data[8];
+	struct iio_stream *stream;
 
 	ret = platform_init();
 	if (NO_OS_IS_ERR_VALUE(ret))
@@ -70,6 +76,21 @@ int main(int argc, char *argv[])
 	if (NO_OS_IS_ERR_VALUE(ret))
 		return ret;
 
+	struct iio_stream_init_param stream_param = {
+		.dev = adpd410x_app,
+		.descriptor = &adpd410x_iio_descriptor,
+		.nb_ch = 8,
+		.half_size = STREAM_HALF_SIZE,
+		.poll_hz = STREAM_POLL_HZ,
+		.start = adpd410x_app_stream_start,
+		.stop = adpd410x_app_stream_stop,
+		.poll = adpd410x_app_stream_poll
+	};
+
+	ret = iio_stream_init(&stream, &stream_param);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
 	struct iio_data_buffer rd_buf = {
 		.buff = (void *)ADPD410X_BASEADDR,
 		.size = MAX_SIZE_BASE_ADDR
@@ -77,7 +98,7 @@ int main(int argc, char *argv[])
 
 	struct iio_app_device devices[] = {
 		IIO_APP_DEVICE("adpd410x", adpd410x_app->adpd4100_handler,
-			       &adpd410x_iio_descriptor,
+			       &stream->descriptor,
 			       &rd_buf, NULL),
 	};
 
@@ -0,0 +1,41 @@
+/* Host replacement of the no-OS IIO types, with the fields iio_stream.c uses */
+
+#ifndef IIO_TYPES_H_
+#define IIO_TYPES_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+struct iio_ch_info {
+	int16_t ch_num;
+	bool ch_out;
+};
+
+struct iio_attribute {
+	const char *name;
+	intptr_t priv;
+	int (*show)(void *device, char *buf, uint32_t len,
+		    const struct iio_ch_info *channel, intptr_t priv);
+	int (*store)(void *device, char *buf, uint32_t len,
+		     const struct iio_ch_info *channel, intptr_t priv);
+};
+
+struct iio_channel {
+	const char *name;
+	int32_t channel;
+	bool ch_out;
+	struct iio_attribute *attributes;
+};
+
+struct iio_device {
+	uint16_t num_ch;
+	struct iio_channel *channels;
+	struct iio_attribute *attributes;
+	int32_t (*prepare_transfer)(void *dev, uint32_t mask);
+	int32_t (*end_transfer)(void *dev);
+	int32_t (*read_dev)(void *dev, void *buff, uint32_t nb_samples);
+	int32_t (*debug_reg_read)(void *dev, uint32_t reg, uint32_t *readval);
+	int32_t (*debug_reg_write)(void *dev, uint32_t reg, uint32_t writeval);
+};
+
+#endif
@@ -0,0 +1,12 @@
+/* Host replacement of the no-OS error header */
+
+#ifndef NO_OS_ERROR_H_
+#define NO_OS_ERROR_H_
+
+#include <errno.h>
+
+#define SUCCESS			0
+#define FAILURE			-1
+#define NO_OS_IS_ERR_VALUE(x)	((x) < 0)
+
+#endif
@@ -0,0 +1,416 @@
+/* Host loopback test of the IIO stream double buffer with an ADPD410x model
+ *
+ * The device is a model of the ADPD410x FIFO filled at the output data rate,
+ * read by the poll callback like adpd410x_app_stream_poll() does. The
+ * producer runs from the GP timer callback at the rate programmed in the
+ * timer, with a model of the DWT cycle counter for the timestamps. The client
+ * reads one half of the double buffer at a time through read_dev, then spends
+ * the time the UART needs to send it.
+ *
+ * Every sample set carries its sequence number, so the test checks that the
+ * client gets the sets in order and that every set missing is counted in
+ * stream_dropped. It prints the throughput for a few data rates and baud
+ * rates: below the UART capacity nothing may be lost.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/platform.h>
+#include <drivers/tmr/adi_tmr.h>
+#include <drivers/pwr/adi_pwr.h>
+#include "no_os_error.h"
+#include "iio_stream.h"
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+#define HCLK		26000000u
+/* Same settings as main.c */
+#define NB_CH		8
+#define HALF_SIZE	64
+#define POLL_HZ		200
+/* ADPD410x FIFO and bytes of one sample set in it */
+#define FIFO_BYTES	256
+#define SET_BYTES	8
+/* IIO command and response header around each block, in bytes */
+#define BLOCK_OVERHEAD	40
+
+DWT_Type dwt_model;
+CoreDebug_Type core_debug_model;
+
+/* Simulated time in microseconds, it goes on from one test to the next */
+static uint64_t now;
+
+ADI_PWR_RESULT adi_pwr_GetClockFrequency(ADI_CLOCK_ID clock, uint32_t *freq)
+{
+	*freq = HCLK;
+
+	return ADI_PWR_SUCCESS;
+}
+
+/* GP timer model */
+static ADI_CALLBACK tmr_callback;
+static void *tmr_param;
+static uint32_t tmr_period_us;
+static bool tmr_enabled;
+
+ADI_TMR_RESULT adi_tmr_Init(ADI_TMR_DEVICE eDevice, ADI_CALLBACK pfCallback,
+			    void *pCBParam, bool bEnableInt)
+{
+	CHECK(eDevice == ADI_TMR_DEVICE_GP1);
+	tmr_callback = pfCallback;
+	tmr_param = pCBParam;
+
+	return ADI_TMR_SUCCESS;
+}
+
+ADI_TMR_RESULT adi_tmr_ConfigTimer(ADI_TMR_DEVICE eDevice,
+				   ADI_TMR_CONFIG *pConfig)
+{
+	CHECK(pConfig->ePrescaler == ADI_TMR_PRESCALER_16 &&
+	      pConfig->eClockSource == ADI_TMR_CLOCK_HFOSC);
+	tmr_period_us = pConfig->nLoad * 16 / (HCLK / 1000000);
+
+	return ADI_TMR_SUCCESS;
+}
+
+ADI_TMR_RESULT adi_tmr_Enable(ADI_TMR_DEVICE eDevice, bool bEnable)
+{
+	tmr_enabled = bEnable;
+
+	return ADI_TMR_SUCCESS;
+}
+
+/* ADPD410x model */
+struct device {
+	uint32_t fifo_sets;
+	/* Sequence number of the oldest set in the FIFO and of the next one */
+	uint32_t fifo_seq;
+	uint32_t seq;
+	bool sampling;
+	uint32_t overflows;
+	uint32_t reg;
+};
+
+static int32_t dev_start(void *dev, uint32_t mask)
+{
+	struct device *d = dev;
+
+	d->fifo_sets = 0;
+	d->fifo_seq = d->seq;
+	d->sampling = true;
+
+	return 0;
+}
+
+static int32_t dev_stop(void *dev)
+{
+	struct device *d = dev;
+
+	d->sampling = false;
+
+	return 0;
+}
+
+static int32_t dev_poll(void *dev, uint32_t *set)
+{
+	struct device *d = dev;
+	uint32_t ch;
+
+	if (!d->fifo_sets)
+		return 0;
+
+	for (ch = 0; ch < NB_CH; ch++)
+		set[ch] = d->fifo_seq * NB_CH + ch;
+	d->fifo_seq++;
+	d->fifo_sets--;
+
+	return 1;
+}
+
+static void dev_sample(struct device *d)
+{
+	if (!d->sampling)
+		return;
+
+	if ((d->fifo_sets + 1) * SET_BYTES > FIFO_BYTES) {
+		/* The oldest set is lost */
+		d->overflows++;
+		d->fifo_seq++;
+		d->fifo_sets--;
+	}
+	d->fifo_sets++;
+	d->seq++;
+}
+
+static int dev_attr_show(void *device, char *buf, uint32_t len,
+			 const struct iio_ch_info *channel, intptr_t priv)
+{
+	return snprintf(buf, len, "%d", (int)priv);
+}
+
+static int dev_attr_store(void *device, char *buf, uint32_t len,
+			  const struct iio_ch_info *channel, intptr_t priv)
+{
+	return len;
+}
+
+static int32_t dev_reg_read(void *dev, uint32_t reg, uint32_t *readval)
+{
+	*readval = ((struct device *)dev)->reg;
+
+	return 0;
+}
+
+static struct iio_attribute dev_attributes[] = {
+	{ .name = "sampling_frequency", .priv = 7, .show = dev_attr_show,
+	  .store = dev_attr_store },
+	{ .name = NULL }
+};
+
+static struct iio_attribute ch_attributes[] = {
+	{ .name = "raw", .priv = 9, .show = dev_attr_show },
+	{ .name = NULL }
+};
+
+static struct iio_channel channels[NB_CH];
+
+static struct iio_device descriptor = {
+	.num_ch = NB_CH,
+	.channels = channels,
+	.attributes = dev_attributes,
+	.debug_reg_read = dev_reg_read,
+};
+
+static struct device device;
+
+static struct iio_stream *stream_init(void)
+{
+	struct iio_stream_init_param param = {
+		.dev = &device,
+		.descriptor = &descriptor,
+		.nb_ch = NB_CH,
+		.half_size = HALF_SIZE,
+		.poll_hz = POLL_HZ,
+		.start = dev_start,
+		.stop = dev_stop,
+		.poll = dev_poll
+	};
+	struct iio_stream *stream = NULL;
+	uint32_t i;
+
+	for (i = 0; i < NB_CH; i++) {
+		channels[i].channel = i;
+		channels[i].attributes = ch_attributes;
+	}
+	CHECK(iio_stream_init(&stream, &param) == 0);
+
+	return stream;
+}
+
+static struct iio_attribute *find_attr(struct iio_attribute *attr,
+				       const char *name)
+{
+	for (; attr->name; attr++)
+		if (!strcmp(attr->name, name))
+			return attr;
+
+	return NULL;
+}
+
+static uint32_t read_attr(struct iio_stream *stream, const char *name)
+{
+	struct iio_attribute *attr = find_attr(stream->descriptor.attributes,
+					       name);
+	char buf[16];
+
+	CHECK(attr && attr->show(&device, buf, sizeof(buf), NULL,
+				 attr->priv) > 0);
+
+	return attr ? strtoul(buf, NULL, 10) : 0;
+}
+
+struct result {
+	uint32_t generated;
+	uint32_t delivered;
+	uint32_t dropped;
+	uint32_t overruns;
+	uint32_t missing;
+	uint32_t disorder;
+	uint32_t bad_stamps;
+};
+
+/*
+ * Stream for seconds at odr sample sets per second to a client reading the
+ * channels in mask over a UART at baud.
+ */
+static void loopback(struct iio_stream *stream, uint32_t odr, uint32_t baud,
+		     uint32_t mask, uint32_t seconds, struct result *res)
+{
+	static uint32_t buff[HALF_SIZE * NB_CH];
+	struct iio_device *desc = &stream->descriptor;
+	uint64_t t, end = now + seconds * 1000000ull;
+	uint64_t next_sample = now, next_tick, client_free = now;
+	uint32_t nb_en = __builtin_popcount(mask);
+	uint32_t expect = device.seq, stamp, last_stamp = 0;
+	uint32_t i, ch, seq, block_us;
+	double sample_us = 1e6 / odr, sample_t = now;
+
+	memset(res, 0, sizeof(*res));
+	CHECK(desc->prepare_transfer(&device, mask) == 0);
+	CHECK(tmr_enabled && tmr_period_us == 1000000 / POLL_HZ);
+	next_tick = now + tmr_period_us;
+	block_us = (uint64_t)(HALF_SIZE * nb_en * 4 + BLOCK_OVERHEAD) * 10 *
+		   1000000 / baud;
+
+	for (t = now; t < end; t++) {
+		dwt_model.CYCCNT = (uint32_t)(t * (HCLK / 1000000));
+		if (t == next_sample) {
+			dev_sample(&device);
+			res->generated++;
+			sample_t += sample_us;
+			next_sample = (uint64_t)(sample_t + 0.5);
+		}
+		if (t == next_tick) {
+			if (tmr_enabled)
+				tmr_callback(tmr_param, 0, NULL);
+			next_tick += tmr_period_us;
+		}
+		if (t < client_free ||
+		    stream->state[stream->rd_half] != IIO_STREAM_READY)
+			continue;
+
+		/* The client takes one half and sends it */
+		stamp = read_attr(stream, "stream_timestamp_us");
+		if (stamp < last_stamp || stamp > t || stamp + 2000000 < t)
+			res->bad_stamps++;
+		last_stamp = stamp;
+		CHECK(desc->read_dev(&device, buff, HALF_SIZE) == HALF_SIZE);
+		for (i = 0; i < HALF_SIZE; i++) {
+			seq = buff[i * nb_en] / NB_CH;
+			for (ch = 0; ch < NB_CH; ch++)
+				if (mask & (1u << ch))
+					res->disorder += *(buff + i * nb_en +
+						__builtin_popcount(mask &
+						((1u << ch) - 1))) !=
+						seq * NB_CH + ch;
+			if (seq < expect)
+				res->disorder++;
+			else
+				res->missing += seq - expect;
+			expect = seq + 1;
+		}
+		res->delivered += HALF_SIZE;
+		client_free = t + block_us;
+	}
+
+	now = end;
+	res->dropped = read_attr(stream, "stream_dropped");
+	res->overruns = read_attr(stream, "stream_overruns");
+	CHECK(desc->end_transfer(&device) == 0);
+	CHECK(!tmr_enabled && !device.sampling);
+
+	/*
+	 * Every set missing at the client was counted as dropped, and the
+	 * sets polled after the last one delivered were dropped or are still
+	 * buffered
+	 */
+	CHECK(res->missing <= res->dropped);
+	CHECK(device.fifo_seq - expect >= res->dropped - res->missing);
+	CHECK(device.fifo_seq - expect - (res->dropped - res->missing) <=
+	      2 * HALF_SIZE);
+	CHECK(res->disorder == 0 && res->bad_stamps == 0);
+	CHECK(device.overflows == 0);
+	CHECK(stream->errors == 0);
+}
+
+static void test_throughput(struct iio_stream *stream)
+{
+	static const uint32_t odrs[] = {100, 1000, 3000};
+	static const uint32_t bauds[] = {115200, 1000000};
+	struct result res;
+	uint32_t i, j, need;
+
+	printf("   ODR     baud  delivered/s  dropped  overruns\n");
+	for (i = 0; i < sizeof(odrs) / sizeof(odrs[0]); i++) {
+		for (j = 0; j < sizeof(bauds) / sizeof(bauds[0]); j++) {
+			loopback(stream, odrs[i], bauds[j], 0x3, 10, &res);
+			printf("%6u %8u %12.1f %8u %9u\n", odrs[i], bauds[j],
+			       res.delivered / 10.0, res.dropped,
+			       res.overruns);
+
+			/* UART bits per second the stream needs */
+			need = odrs[i] * (2 * 4 + BLOCK_OVERHEAD / HALF_SIZE) *
+			       10;
+			if (need < bauds[j]) {
+				CHECK(res.dropped == 0 && res.overruns == 0);
+				CHECK(res.delivered + 2 * HALF_SIZE >=
+				      res.generated - FIFO_BYTES / SET_BYTES);
+			} else {
+				/* The client gets what the UART can carry */
+				CHECK(res.dropped > 0 && res.overruns > 0);
+				CHECK(res.delivered * (uint64_t)need >=
+				      res.generated * 0.9 * bauds[j]);
+			}
+		}
+	}
+}
+
+static void test_access(struct iio_stream *stream)
+{
+	struct iio_device *desc = &stream->descriptor;
+	struct iio_attribute *attr;
+	uint32_t val;
+	char buf[16];
+
+	/* Stream attributes are appended to the device ones */
+	attr = find_attr(desc->attributes, "sampling_frequency");
+	CHECK(attr != NULL);
+	CHECK(find_attr(desc->attributes, "stream_overruns") != NULL);
+	CHECK(find_attr(desc->channels[3].attributes, "raw") != NULL);
+	if (!attr)
+		return;
+
+	/* The device is reached while stopped only */
+	CHECK(attr->show(&device, buf, sizeof(buf), NULL, attr->priv) > 0);
+	CHECK(strcmp(buf, "7") == 0);
+	device.reg = 0x55;
+	CHECK(desc->debug_reg_read(&device, 0, &val) == 0 && val == 0x55);
+
+	CHECK(desc->prepare_transfer(&device, 0x1) == 0);
+	CHECK(attr->show(&device, buf, sizeof(buf), NULL, attr->priv) ==
+	      -EBUSY);
+	CHECK(attr->store(&device, buf, 1, NULL, attr->priv) == -EBUSY);
+	CHECK(desc->debug_reg_read(&device, 0, &val) == -EBUSY);
+	attr = find_attr(desc->channels[3].attributes, "raw");
+	CHECK(attr->show(&device, buf, sizeof(buf), NULL, attr->priv) ==
+	      -EBUSY);
+	CHECK(desc->end_transfer(&device) == 0);
+	CHECK(attr->show(&device, buf, sizeof(buf), NULL, attr->priv) > 0);
+	CHECK(strcmp(buf, "9") == 0);
+
+	/* read_dev does not wait for a stopped stream */
+	CHECK(desc->read_dev(&device, buf, 1) == -EIO);
+}
+
+int main(void)
+{
+	struct iio_stream *stream = stream_init();
+
+	if (stream) {
+		test_access(stream);
+		test_throughput(stream);
+		CHECK(iio_stream_remove(stream) == 0);
+	}
+
+	printf(failures ? "FAILED\n" : "OK\n");
+
+	return failures ? 1 : 0;
+}
@@ -57,10 +57,19 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <radio/adi_ble_radio.h>
 #include <common/adi_error_handling.h>
 #include <framework/noos/adi_ble_noos.h>
-
-/* Macro to enable or disable Bluetooth */
+#include <beacon/adi_ble_broadcast.h>
+
+/*
+ * Macro to enable or disable Bluetooth
+ *      - 0: Printf used to display the temperature
+ *      - 1: Temperature sent to the connected host
+ *      - 2: Temperature broadcast in sensor beacon frames, no connection
+ */
 #define ADI_APP_USE_BLUETOOTH   (1u)
 
+/* Broadcast mode: seconds between two temperature updates */
+#define ADI_APP_BROADCAST_PERIOD (5u)
+
 /* Accelerometer instance ID */
 #define ADI_TEMPERATURE_ID    (1u)
 
@@ -72,6 +72,8 @@ static void ApplicationCallback(void * pCBParam, uint32_t Event, void * pArg);
 static void InitBluetoothLowEnergy(void);
 static void SetAdvertisingMode(void);
 static void TempBluetoothMode(Temperature *pTemp);
+#elif (ADI_APP_USE_BLUETOOTH == 2u)
+static void TempBroadcastMode(Temperature *pTemp);
 #else
 static void TempStandaloneMode(Temperature *pTemp);
 #endif
@@ -117,6 +119,8 @@ int main(int argc, char *argv[])
 
 #if(ADI_APP_USE_BLUETOOTH == 1u)
     TempBluetoothMode(pTemp);
+#elif(ADI_APP_USE_BLUETOOTH == 2u)
+    TempBroadcastMode(pTemp);
 #else
     TempStandaloneMode(pTemp);
 #endif
@@ -362,6 +366,45 @@ static void ApplicationCallback(void * pCBParam, uint32_t Event, void * pArg)
             break;
     }
 }
+#elif (ADI_APP_USE_BLUETOOTH == 2u)
+/*!
+ * @brief      Broadcast Temperature demo
+ *
+ * @details    Broadcasts the temperature to any observer without a connection.
+ *             The core sleeps between two updates while the radio keeps
+ *             advertising the last reading.
+ */
+static void TempBroadcastMode(Temperature *pTemp)
+{
+    ADI_BLER_RESULT     eResult;
+    ADI_BEACON_FRAME    sFrame;
+    ADI_BEACON_SCHED    sSched;
+    float               nTempCel;
+    SENSOR_RESULT       eSensorResult;
+
+    sFrame.nNumValues         = 1u;
+    sFrame.aValues[0u].nType  = ADI_BEACON_VALUE_TEMPERATURE;
+    sFrame.aValues[0u].nValue = 0;
+
+    eResult = adi_broadcast_Start(&sFrame, ADI_CFG_BROADCAST_ADV_INTERVAL);
+    DEBUG_RESULT("Error starting the broadcast.\r\n", eResult, ADI_BLER_SUCCESS);
+
+    adi_beacon_SchedInit(&sSched, ADI_APP_BROADCAST_PERIOD * ADI_CFG_BROADCAST_TICK_HZ, GET_TIME());
+
+    /* WHILE(forever) */
+    while(1u) {
+        eSensorResult = pTemp->getTemperatureInCelsius(&nTempCel);
+
+        if(eSensorResult == SENSOR_ERROR_NONE) {
+            sFrame.aValues[0u].nValue = adi_beacon_FromFloat(nTempCel, 0.01f);
+
+            eResult = adi_broadcast_Update(&sFrame);
+            DEBUG_RESULT("Error updating the broadcast.\r\n", eResult, ADI_BLER_SUCCESS);
+        }
+
+        adi_broadcast_Sleep(&sSched);
+    } /* ENDWHILE */
+}
 #else
 /*!
  * @brief      Standalone Temperature demo
@@ -59,6 +59,7 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <radio/adi_ble_radio.h>
 #include <common/adi_error_handling.h>
 #include <framework/noos/adi_ble_noos.h>
+#include <beacon/adi_ble_broadcast.h>
 
 /*
  * Macro to enable or disable bluetooth functionality. If bluetooth is disabled the sensor
@@ -69,9 +70,15 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  ADI_APP_USE_BLUETOOTH 0 - Disables bluetooth and sensor data is printed to console with
  *                            debug build. In case of release build console output is redirected
  *                            to UART.
+ *
+ *  ADI_APP_USE_BLUETOOTH 2 - Sensor data is broadcast in sensor beacon frames to any observer,
+ *                            no connection is needed and the core sleeps between updates
  */
 #define ADI_APP_USE_BLUETOOTH   (1u)
 
+/* Broadcast mode: seconds between two accelerometer updates */
+#define ADI_APP_BROADCAST_PERIOD (1u)
+
 /* Accelerometer instance ID */
 #define ADI_ACCELEROMETER_ID    (1u)
 
@@ -71,6 +71,8 @@ static void ApplicationCallback(void * pCBParam, uint32_t Event, void * pArg);
 static void InitBluetoothLowEnergy(void);
 static void SetAdvertisingMode(void);
 static void AxlBluetoothMode(Accelerometer *pAxl);
+#elif (ADI_APP_USE_BLUETOOTH == 2u)
+static void AxlBroadcastMode(Accelerometer *pAxl);
 #else
 static void AxlStandaloneMode(Accelerometer *pAxl);
 #endif
@@ -116,6 +118,8 @@ int main(int argc, char *argv[])
 
 #if(ADI_APP_USE_BLUETOOTH == 1u)
     AxlBluetoothMode(pAxl);
+#elif(ADI_APP_USE_BLUETOOTH == 2u)
+    AxlBroadcastMode(pAxl);
 #else
     AxlStandaloneMode(pAxl);
 #endif
@@ -356,6 +360,51 @@ static void ApplicationCallback(void * pCBParam, uint32_t Event, void * pArg)
             break;
     }
 }
+#elif (ADI_APP_USE_BLUETOOTH == 2u)
+/*!
+ * @brief      Broadcast Accelerometer demo
+ *
+ * @details    Broadcasts the x,y,z values to any observer without a connection.
+ *             The raw values are 1 mg/LSB in the 2 g range of the default
+ *             configuration. The core sleeps between two updates.
+ */
+static void AxlBroadcastMode(Accelerometer *pAxl)
+{
+    ADI_BLER_RESULT     eResult;
+    ADI_BEACON_FRAME    sFrame;
+    ADI_BEACON_SCHED    sSched;
+    int16_t             x, y, z;
+
+    sFrame.nNumValues         = 3u;
+    sFrame.aValues[0u].nType  = ADI_BEACON_VALUE_ACCEL_X;
+    sFrame.aValues[0u].nValue = 0;
+    sFrame.aValues[1u].nType  = ADI_BEACON_VALUE_ACCEL_Y;
+    sFrame.aValues[1u].nValue = 0;
+    sFrame.aValues[2u].nType  = ADI_BEACON_VALUE_ACCEL_Z;
+    sFrame.aValues[2u].nValue = 0;
+
+    eResult = adi_broadcast_Start(&sFrame, ADI_CFG_BROADCAST_ADV_INTERVAL);
+    DEBUG_RESULT("Error starting the broadcast.\r\n", eResult, ADI_BLER_SUCCESS);
+
+    adi_beacon_SchedInit(&sSched, ADI_APP_BROADCAST_PERIOD * ADI_CFG_BROADCAST_TICK_HZ, GET_TIME());
+
+    /* WHILE(forever) */
+    while(1u) {
+        /* Get x,y,x accelerometer data */
+        pAxl->getX((uint8_t*)&x, 2u);
+        pAxl->getY((uint8_t*)&y, 2u);
+        pAxl->getZ((uint8_t*)&z, 2u);
+
+        sFrame.aValues[0u].nValue = x;
+        sFrame.aValues[1u].nValue = y;
+        sFrame.aValues[2u].nValue = z;
+
+        eResult = adi_broadcast_Update(&sFrame);
+        DEBUG_RESULT("Error updating the broadcast.\r\n", eResult, ADI_BLER_SUCCESS);
+
+        adi_broadcast_Sleep(&sSched);
+    } /* ENDWHILE */
+}
 #else
 /*!
  * @brief      Standalone Accelerometer demo
@@ -62,6 +62,13 @@ typedef enum {
     CAL_SYS_FULL_MODE
 } enMode;
 
+/* Calibration coefficients of one channel */
+typedef struct {
+    uint32_t ui32offset;
+    uint32_t ui32fullscale;
+    uint8_t  ui8valid;
+} stCalibration;
+
 /*************************** Functions prototypes *****************************/
 
 void AD7793_Init(void);
@@ -70,7 +77,10 @@ uint32_t AD7793_ReadRegister( uint8_t ui8address);
 void AD7793_WriteRegister( uint8_t ui8address, uint32_t ui32data);
 void AD7793_SelectChannel(uint8_t ui8channel);
 uint32_t AD7793_Scan(enMode mode,  uint8_t channel);
-void AD7793_Calibrate(uint8_t ui8channel, enMode mode);
+int8_t AD7793_Calibrate(uint8_t ui8channel, enMode mode);
+int8_t AD7793_CalibrateChannel(uint8_t ui8channel);
+void AD7793_RestoreCalibration(void);
+uint32_t AD7793_GetResult(uint8_t ui8channel);
 float AD7793_ConvertToVolts(uint32_t u32adcValue);
 
 /****************************** Internal defines ******************************/
@@ -94,6 +104,7 @@ float AD7793_ConvertToVolts(uint32_t u32adcValue);
 #define AD7793_COMM_ADR(x)   (((x) & 0x07) << 3)
 
 #define AD7793_MODE_MSK    (~(0x07 << 13))
+#define AD7793_MODE_SEL(x)  (((x) & 0x07) << 13)
 #define AD7793_CONF_MSK     (~(0x07))
 
 /* RDY bit AD7793 STATUS reg - b7*/
@@ -118,9 +129,16 @@ float AD7793_ConvertToVolts(uint32_t u32adcValue);
 #define AD7793_CH_AIN1M_AIN1M 3 /* AIN1(-) - AIN1(-) */
 #define AD7793_CH_TEMP        6 /* Temp Sensor */
 #define AD7793_CH_AVDD_MONITOR 7 /* AVDD Monitor */
+#define AD7793_NB_CH          3 /* Differential channels with own calibration */
+
+/* DOUT/RDY is shared with SPI1 MISO (P1.7) */
+#define AD7793_RDY_PORT       ADI_GPIO_PORT1
+#define AD7793_RDY_PIN        ADI_GPIO_PIN_7
 
 /**************************** Configuration parameters ************************/
 #define AD7793_GAIN              AD7793_GAIN_1
+/* Longest wait for DOUT/RDY [ms], above a calibration at the slowest rate */
+#define AD7793_RDY_TIMEOUT       1000
 
 
 #endif /* AD7793_H_ */
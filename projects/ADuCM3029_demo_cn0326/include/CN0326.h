@@ -54,6 +54,7 @@ typedef  void (*cmdFunc)(uint8_t *);
 /*************************** Functions prototypes *****************************/
 
 void CN0326_Init(void);
+int8_t CN0326_CalibrateAll(void);
 void CN0326_Interrupt(void);
 float CN0326_CalculateTemp(void);
 float CN0326_CalculatePH(void);
@@ -101,5 +102,7 @@ void CN0326_GetArgv(char *dst, uint8_t *args);
  * */
 #define  USE_IOUT2 NO
 #define  TOLERANCE 0 /* Set a tolerance value for pH calculation */
+/* Calibrate again when the temperature moved more than this [˚C] */
+#define  CAL_DRIFT_TEMP 5
 
 #endif /* CN0326_H_ */
@@ -47,6 +47,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef _COMMUNICATION_H_
 #define _COMMUNICATION_H_
 
+#include <stdbool.h>
 
 /******************************** Internal defines ****************************/
 #define UART_TX_BUFFER_SIZE      1024       // UART transmit buffer size
@@ -165,6 +166,7 @@ int8_t SPI_Init(void);
 //uint32_t SPI_Read(uint8_t ui8address, enum en_spi_read enRegs);
 uint32_t SPI_Read(uint8_t ui8address, uint8_t ui8bytes);
 int8_t SPI_Write(uint8_t ui8address, uint32_t ui32data, uint8_t ui8bytes);
+void SPI_HoldCS(bool hold);
 int8_t UART_Init(enum uart_baudrate baudrate,
                  uint8_t iBits);
 int8_t UART_ReadChar(uint8_t *data);
@@ -57,6 +57,73 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 const uint8_t reg_size[8] = {1, 2, 2, 3, 1, 1, 3, 3};
 
+#define AD7793_NO_CH    0xFF
+
+/* Cached calibration coefficients of AIN1..AIN3 */
+static stCalibration calibration[AD7793_NB_CH];
+/* Last conversion result of AIN1..AIN3 */
+static uint32_t ui32results[AD7793_NB_CH];
+/* CONF register, kept here to switch channels with a single write */
+static uint32_t ui32conf;
+/* Channel converting in continuous mode or AD7793_NO_CH */
+static uint8_t ui8conv_channel = AD7793_NO_CH;
+static volatile uint8_t ui8rdy_flag;
+
+
+/***************************** Local functions ********************************/
+
+/**
+   @brief DOUT/RDY falling edge, a conversion is ready
+
+   @return none
+**/
+static void AD7793_RdyCallback(void *pCBParam, uint32_t Port, void *PinIntData)
+{
+    /* Masked until the result is read, SPI traffic toggles the pin */
+    adi_gpio_SetGroupInterruptPins(AD7793_RDY_PORT, ADI_GPIO_INTA_IRQ, 0);
+    ui8rdy_flag = 1;
+}
+
+/**
+   @brief Wait for DOUT/RDY to go low, CS must be held low
+
+   @return int8_t - 0 when a result is ready, -1 on timeout
+**/
+static int8_t AD7793_WaitReady(void)
+{
+    uint16_t ui16level;
+
+    ui8rdy_flag = 0;
+    adi_gpio_SetGroupInterruptPins(AD7793_RDY_PORT, ADI_GPIO_INTA_IRQ,
+                                   AD7793_RDY_PIN);
+
+    /* The result may have been ready before the interrupt was unmasked */
+    adi_gpio_GetData(AD7793_RDY_PORT, AD7793_RDY_PIN, &ui16level);
+    if(!ui16level)
+        ui8rdy_flag = 1;
+
+    timer_delayCount = AD7793_RDY_TIMEOUT;
+    while(!ui8rdy_flag && timer_delayCount != 0u);
+
+    adi_gpio_SetGroupInterruptPins(AD7793_RDY_PORT, ADI_GPIO_INTA_IRQ, 0);
+
+    return ui8rdy_flag ? 0 : -1;
+}
+
+/**
+   @brief Write the configuration lost on reset
+
+   @return none
+**/
+static void AD7793_Configure(void)
+{
+    /* Set configuration options */
+    AD7793_WriteRegister(AD7793_REG_CONF, ui32conf);
+
+    /* Set IOUT2 to 210 uA */
+    AD7793_WriteRegister(AD7793_REG_IO, 0x02);
+}
+
 
 /***************************** Global functions *******************************/
 
@@ -67,7 +134,7 @@ const uint8_t reg_size[8] = {1, 2, 2, 3, 1, 1, 3, 3};
 **/
 void AD7793_Init(void)
 {
-    uint32_t ui32reg_value;
+    uint16_t ui16polarity;
 
     /* SPI initialization */
     SPI_Init();
@@ -75,17 +142,20 @@ void AD7793_Init(void)
     /* Reset ADC converter */
     AD7793_Reset();
 
-    ui32reg_value = (uint32_t)(AD7793_GAIN << 8); /* Set ADC gain */
-    ui32reg_value |= (uint32_t)AD7793_REFSEL; /* Select internal reference
-											   * source */
-    ui32reg_value |= (uint32_t)AD7793_BUF; /* Configure buffered mode of
-											* operation */
-
-    /* Set configuration options */
-    AD7793_WriteRegister(AD7793_REG_CONF, ui32reg_value);
-
-    /* Set IOUT2 to 210 uA */
-    AD7793_WriteRegister(AD7793_REG_IO, 0x02);
+    ui32conf = (uint32_t)(AD7793_GAIN << 8); /* Set ADC gain */
+    ui32conf |= (uint32_t)AD7793_REFSEL; /* Select internal reference
+										  * source */
+    ui32conf |= (uint32_t)AD7793_BUF; /* Configure buffered mode of
+									   * operation */
+    AD7793_Configure();
+
+    /* DOUT/RDY notification */
+    adi_gpio_InputEnable(AD7793_RDY_PORT, AD7793_RDY_PIN, true);
+    /* Falling edge on P1.7 only, the other port 1 pins keep their polarity */
+    adi_gpio_GetGroupInterruptPolarity(AD7793_RDY_PORT, &ui16polarity);
+    ui16polarity &= ~AD7793_RDY_PIN;
+    adi_gpio_SetGroupInterruptPolarity(AD7793_RDY_PORT, ui16polarity);
+    adi_gpio_RegisterCallback(ADI_GPIO_INTA_IRQ, AD7793_RdyCallback, NULL);
 }
 
 /**
@@ -95,11 +165,15 @@ void AD7793_Init(void)
 **/
 void AD7793_Reset(void)
 {
+    /* Leave continuous mode */
+    SPI_HoldCS(false);
+    ui8conv_channel = AD7793_NO_CH;
+
     /* Write 4 bytes = 0xFF */
     SPI_Write(0, 0, 4);
 
     /* Wait time before accessing any registers after reset */
-    timer_sleep(0.05);
+    timer_sleep(1);
 }
 
 
@@ -142,6 +216,11 @@ void AD7793_WriteRegister(uint8_t ui8address, uint32_t ui32data)
 /**
    @brief Read ADC conversion results
 
+   The channel must have been calibrated with AD7793_CalibrateChannel(). In
+   continuous mode the converter keeps running on the channel, so repeated
+   reads of the same channel only wait for the next result. A channel change
+   restarts the filter and the first result is already settled.
+
    @param mode - conversion mode: SINGLE_CONV or CONTINUOUS_CONV
    @param ui8channel - ADC channel to scan
 
@@ -150,27 +229,60 @@ void AD7793_WriteRegister(uint8_t ui8address, uint32_t ui32data)
 uint32_t AD7793_Scan(enMode mode,  uint8_t ui8channel)
 {
     uint32_t ui32reg_value;
+    uint16_t ui16level;
 
-    AD7793_Calibrate(ui8channel, CAL_INT_FULL_MODE);
-
-    /* Select channel to scan */
-    AD7793_SelectChannel(ui8channel);
-
-    /* Check if single conversion mode is wanted */
-    if(mode == SINGLE_CONV) {
-        ui32reg_value =  AD7793_ReadRegister(AD7793_REG_MODE);
+    if(mode != CONTINUOUS_CONV || ui8conv_channel == AD7793_NO_CH) {
+        /* Select channel to scan */
+        AD7793_SelectChannel(ui8channel);
 
+        ui32reg_value = AD7793_ReadRegister(AD7793_REG_MODE);
         ui32reg_value &= AD7793_MODE_MSK;
+        ui32reg_value |= AD7793_MODE_SEL(mode);
 
-        /* Set single mode operation */
-        ui32reg_value |= (uint32_t)(mode << 13);
-
+        /* DOUT/RDY is only driven while CS is low */
+        SPI_HoldCS(true);
         AD7793_WriteRegister(AD7793_REG_MODE, ui32reg_value);
+    } else if(ui8conv_channel != ui8channel) {
+        /* An unread result of the previous channel holds DOUT/RDY low */
+        adi_gpio_GetData(AD7793_RDY_PORT, AD7793_RDY_PIN, &ui16level);
+        if(!ui16level) {
+            ui32reg_value = AD7793_ReadRegister(AD7793_REG_DATA);
+            if(ui8conv_channel < AD7793_NB_CH)
+                ui32results[ui8conv_channel] = ui32reg_value;
+        }
+        AD7793_SelectChannel(ui8channel);
+    }
+
+    ui8conv_channel = (mode == CONTINUOUS_CONV) ? ui8channel : AD7793_NO_CH;
+
+    if(AD7793_WaitReady() != 0) {
+        /* Start over on the next call */
+        SPI_HoldCS(false);
+        ui8conv_channel = AD7793_NO_CH;
+        return (ui8channel < AD7793_NB_CH) ? ui32results[ui8channel] : 0;
     }
 
-    while ((AD7793_ReadRegister(AD7793_REG_STAT) & RDY_BIT) == RDY_BIT);
+    ui32reg_value = AD7793_ReadRegister(AD7793_REG_DATA);
+    if(ui8channel < AD7793_NB_CH)
+        ui32results[ui8channel] = ui32reg_value;
+
+    if(mode != CONTINUOUS_CONV)
+        SPI_HoldCS(false);
+
+    return ui32reg_value;
+}
+
+
+/**
+   @brief Get the last result of a channel without a new conversion
+
+   @param ui8channel - input channel
 
-    return AD7793_ReadRegister(AD7793_REG_DATA);
+   @return uint32_t - conversion result
+**/
+uint32_t AD7793_GetResult(uint8_t ui8channel)
+{
+    return (ui8channel < AD7793_NB_CH) ? ui32results[ui8channel] : 0;
 }
 
 
@@ -183,15 +295,11 @@ uint32_t AD7793_Scan(enMode mode,  uint8_t ui8channel)
 **/
 void AD7793_SelectChannel(uint8_t ui8channel)
 {
-    uint32_t ui32reg_value;
-
-    /* Read CONF register */
-    ui32reg_value = AD7793_ReadRegister(AD7793_REG_CONF);
-    ui32reg_value &= AD7793_CONF_MSK;
-    /* Set set channel */
-    ui32reg_value |= (uint32_t)ui8channel;
+    /* Set channel */
+    ui32conf &= AD7793_CONF_MSK;
+    ui32conf |= (uint32_t)ui8channel;
     /* Write CONF register */
-    AD7793_WriteRegister(AD7793_REG_CONF, ui32reg_value);
+    AD7793_WriteRegister(AD7793_REG_CONF, ui32conf);
 }
 
 /**
@@ -201,28 +309,97 @@ void AD7793_SelectChannel(uint8_t ui8channel)
    @param mode - calibration mode: CAL_INT_ZERO_MODE, CAL_INT_FULL_MODE,
    	   	   	   	   	   	   	   	   CAL_SYS_ZERO_MODE, CAL_SYS_FULL_MODE
 
-   @return none
+   @return int8_t - 0 when the calibration is done, -1 on timeout
 **/
-void AD7793_Calibrate(uint8_t ui8channel, enMode mode)
+int8_t AD7793_Calibrate(uint8_t ui8channel, enMode mode)
 {
-    uint32_t ui32reg_value, back_up;
+    uint32_t ui32reg_value;
+    int8_t i8rc;
 
     /* Select channel */
     AD7793_SelectChannel(ui8channel);
 
     /* Read MODE register */
-    ui32reg_value = back_up = AD7793_ReadRegister(AD7793_REG_MODE);
+    ui32reg_value = AD7793_ReadRegister(AD7793_REG_MODE);
 
     ui32reg_value &= AD7793_MODE_MSK;
 
     /* Set mode */
-    ui32reg_value |= (uint32_t)(mode << 13);
+    ui32reg_value |= AD7793_MODE_SEL(mode);
 
-    /* Write MODE register */
+    /* Write MODE register, the calibration stops continuous conversions */
+    SPI_HoldCS(true);
+    ui8conv_channel = AD7793_NO_CH;
     AD7793_WriteRegister(AD7793_REG_MODE, ui32reg_value);
 
-    /* Wait until RDY bit from STATUS register is high */
-    while ((AD7793_ReadRegister(AD7793_REG_STAT) & RDY_BIT) == RDY_BIT);
+    /* Wait until DOUT/RDY goes low */
+    i8rc = AD7793_WaitReady();
+    SPI_HoldCS(false);
+
+    return i8rc;
+}
+
+/**
+   @brief Run the internal zero-scale and full-scale calibrations of a channel
+   and cache the resulting coefficients
+
+   A calibration that times out leaves the coefficient registers undefined,
+   the cache then keeps the coefficients of the last good calibration.
+
+   @param ui8channel - input channel: AIN1, AIN2 or AIN3
+
+   @return int8_t - 0 when the coefficients are cached, -1 on timeout or
+   invalid channel
+**/
+int8_t AD7793_CalibrateChannel(uint8_t ui8channel)
+{
+    if(ui8channel >= AD7793_NB_CH)
+        return -1;
+
+    if(AD7793_Calibrate(ui8channel, CAL_INT_ZERO_MODE) != 0 ||
+       AD7793_Calibrate(ui8channel, CAL_INT_FULL_MODE) != 0)
+        return -1;
+
+    /* Each channel has its own offset and full-scale registers */
+    calibration[ui8channel].ui32offset =
+        AD7793_ReadRegister(AD7793_REG_OFFSET);
+    calibration[ui8channel].ui32fullscale =
+        AD7793_ReadRegister(AD7793_REG_FULLSCALE);
+    calibration[ui8channel].ui8valid = 1;
+
+    return 0;
+}
+
+/**
+   @brief Write back the configuration and the cached calibration coefficients
+   after a reset, without running the calibrations again
+
+   @return none
+**/
+void AD7793_RestoreCalibration(void)
+{
+    uint8_t ui8channel;
+    uint32_t ui32reg_value;
+
+    AD7793_Configure();
+
+    /* The reset leaves the ADC converting continuously, the coefficient
+     * registers must only be written while it is idle */
+    ui32reg_value = AD7793_ReadRegister(AD7793_REG_MODE);
+    ui32reg_value &= AD7793_MODE_MSK;
+    ui32reg_value |= AD7793_MODE_SEL(IDLE_MODE);
+    AD7793_WriteRegister(AD7793_REG_MODE, ui32reg_value);
+    ui8conv_channel = AD7793_NO_CH;
+
+    for(ui8channel = 0; ui8channel < AD7793_NB_CH; ui8channel++) {
+        if(!calibration[ui8channel].ui8valid)
+            continue;
+        AD7793_SelectChannel(ui8channel);
+        AD7793_WriteRegister(AD7793_REG_OFFSET,
+                             calibration[ui8channel].ui32offset);
+        AD7793_WriteRegister(AD7793_REG_FULLSCALE,
+                             calibration[ui8channel].ui32fullscale);
+    }
 }
 
 
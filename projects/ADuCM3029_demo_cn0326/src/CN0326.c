@@ -63,6 +63,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 float iout2_calibration;   /* [mA]  */
 #endif
 
+/* Temperature of the last calibration [˚C] */
+static float cal_temp;
+static uint8_t cal_temp_valid = 0;
+
 /************************** Variable Definitions ******************************/
 /* Available commands */
 char *CmdCommands[] = {
@@ -102,18 +106,35 @@ void CN0326_Init(void)
     /* UART initialization */
     UART_Init(bd9600, uart_bits_nr);
 
-    AD7793_Calibrate(AD7793_CH_AIN1P_AIN1M, CAL_INT_ZERO_MODE);
-    AD7793_Calibrate(AD7793_CH_AIN1P_AIN1M, CAL_INT_FULL_MODE);
-    AD7793_Calibrate(AD7793_CH_AIN2P_AIN2M, CAL_INT_ZERO_MODE);
-    AD7793_Calibrate(AD7793_CH_AIN2P_AIN2M, CAL_INT_FULL_MODE);
-    AD7793_Calibrate(AD7793_CH_AIN3P_AIN3M, CAL_INT_ZERO_MODE);
-    AD7793_Calibrate(AD7793_CH_AIN3P_AIN3M, CAL_INT_FULL_MODE);
+    if(CN0326_CalibrateAll() != 0)
+        printf("Calibration timed out!\n");
 
 #if(USE_IOUT2 == YES)
     ui32result = AD7793_Scan(SINGLE_CONV, AD7793_CH_AIN3P_AIN3M);
     i32voltage = AD7793_ConvertToVolts(ui32result);
     iout2_calibration = i32voltage / (float)5000;
 #endif
+
+    /* Reference for the temperature drift check */
+    cal_temp = CN0326_CalculateTemp();
+    cal_temp_valid = 1;
+}
+
+/**
+   @brief Calibrate all channels, the coefficients are cached by the driver
+
+   @return int8_t - 0 on success, -1 if a calibration timed out
+**/
+int8_t CN0326_CalibrateAll(void)
+{
+    uint8_t ui8channel;
+    int8_t i8rc = 0;
+
+    for(ui8channel = 0; ui8channel < AD7793_NB_CH; ui8channel++)
+        if(AD7793_CalibrateChannel(ui8channel) != 0)
+            i8rc = -1;
+
+    return i8rc;
 }
 
 /**
@@ -133,7 +154,7 @@ float CN0326_CalculateTemp(void)
     f32current = I_EXC;
 #endif
     /* Read ADC output value */
-    ui32adcValue = AD7793_Scan(SINGLE_CONV, AD7793_CH_AIN2P_AIN2M);
+    ui32adcValue = AD7793_Scan(CONTINUOUS_CONV, AD7793_CH_AIN2P_AIN2M);
 
     /* Convert ADC output value to voltage */
     f32voltage = AD7793_ConvertToVolts(ui32adcValue);
@@ -144,6 +165,14 @@ float CN0326_CalculateTemp(void)
     /* Calculate temperature value */
     temp = ((res - RMIN) / (TEMP_COEFF * RMIN));
 
+    /* Calibrate again on a temperature drift, the next reads use it. After
+     * a timeout the reference is kept so the next read tries again. */
+    if(cal_temp_valid && ((temp > cal_temp + CAL_DRIFT_TEMP) ||
+                          (temp < cal_temp - CAL_DRIFT_TEMP))) {
+        if(CN0326_CalibrateAll() == 0)
+            cal_temp = temp;
+    }
+
     return temp;
 }
 
@@ -162,7 +191,7 @@ float CN0326_CalculatePH(void)
     temp = CN0326_CalculateTemp();
 
     /* Read ADC output value */
-    ui32adcValue = AD7793_Scan(SINGLE_CONV, AD7793_CH_AIN1P_AIN1M);
+    ui32adcValue = AD7793_Scan(CONTINUOUS_CONV, AD7793_CH_AIN1P_AIN1M);
 
     /* Convert ADC output value to voltage */
     i32voltage = AD7793_ConvertToVolts(ui32adcValue);
@@ -240,7 +269,7 @@ void CN0326_CmdCalibration(uint8_t *args)
 
     uint8_t *p = args;
     char    arg[5];
-    uint8_t ui8channel;
+    int8_t  i8rc;
 
     /* Check if this function gets an argument */
     while (*(p = CN0326_FindArgv(p)) != '\0') {
@@ -249,36 +278,33 @@ void CN0326_CmdCalibration(uint8_t *args)
     }
 
     if(strncmp(arg, "AIN1", 5) == 0) {
-        AD7793_Calibrate(AD7793_CH_AIN1P_AIN1M, CAL_INT_ZERO_MODE);
-        AD7793_Calibrate(AD7793_CH_AIN1P_AIN1M, CAL_INT_FULL_MODE);
+        i8rc = AD7793_CalibrateChannel(AD7793_CH_AIN1P_AIN1M);
 
         timer_sleep(300);
 
-        printf("Calibration completed for %s channel!\n", arg);
+        printf("Calibration %s for %s channel!\n",
+               i8rc ? "timed out" : "completed", arg);
     } else if(strncmp(arg, "AIN2", 5) == 0) {
-        AD7793_Calibrate(AD7793_CH_AIN2P_AIN2M, CAL_INT_ZERO_MODE);
-        AD7793_Calibrate(AD7793_CH_AIN2P_AIN2M, CAL_INT_FULL_MODE);
+        i8rc = AD7793_CalibrateChannel(AD7793_CH_AIN2P_AIN2M);
 
         timer_sleep(300);
 
-        printf("Calibration completed for %s channel!\n", arg);
+        printf("Calibration %s for %s channel!\n",
+               i8rc ? "timed out" : "completed", arg);
     } else if(strncmp(arg, "AIN3", 5) == 0) {
-        AD7793_Calibrate(AD7793_CH_AIN3P_AIN3M, CAL_INT_ZERO_MODE);
-        AD7793_Calibrate(AD7793_CH_AIN3P_AIN3M, CAL_INT_FULL_MODE);
+        i8rc = AD7793_CalibrateChannel(AD7793_CH_AIN3P_AIN3M);
 
         timer_sleep(300);
 
-        printf("Calibration completed for %s channel!\n", arg);
+        printf("Calibration %s for %s channel!\n",
+               i8rc ? "timed out" : "completed", arg);
     } else if(strncmp(arg, "all", 4) == 0) {
-        for(ui8channel = 0; ui8channel <= 2; ui8channel++) {
-
-            AD7793_Calibrate(ui8channel, CAL_INT_ZERO_MODE);
-            AD7793_Calibrate(ui8channel, CAL_INT_FULL_MODE);
-        }
+        i8rc = CN0326_CalibrateAll();
 
         timer_sleep(300);
 
-        printf("Calibration completed for %s channels!\n", arg);
+        printf("Calibration %s for %s channels!\n",
+               i8rc ? "timed out" : "completed", arg);
     } else {
         printf("Incorrect channel!Try again!\n");
     }
@@ -344,6 +370,9 @@ void CN0326_CmdReset(uint8_t *args)
 
     timer_sleep(500);
 
+    /* The cached coefficients save the calibrations */
+    AD7793_RestoreCalibration();
+
     printf("AD7793 reset completed!\n");
 }
 #pragma GCC diagnostic pop
@@ -47,6 +47,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 /***************************** Include Files **********************************/
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "ADuCM3029.h"
 #include "drivers/spi/adi_spi.h"
@@ -89,7 +90,13 @@ uint8_t			spi_device_memory[ADI_SPI_MEMORY_SIZE];
 ADI_SPI_TRANSCEIVER spi_telegram;
 
 #define SPI_DEVICE_NR SPI_PMOD
-#define SPI_CS_PIN_NR ADI_SPI_CS0 /* CS pin for the PMOD connector */
+#define SPI_CS_PORT   ADI_GPIO_PORT1 /* CS pin for the PMOD connector, P1.9 */
+#define SPI_CS_PIN    ADI_GPIO_PIN_9
+
+/* Memory for the GPIO driver */
+uint8_t			gpio_device_memory[ADI_GPIO_MEMORY_SIZE];
+/* CS is left low between transfers */
+static bool		spi_cs_hold = false;
 
 /************************* Functions Definitions ******************************/
 
@@ -103,6 +110,12 @@ int8_t SPI_Init(void)
 {
     ADI_SPI_RESULT status;
 
+    /* CS is a GPIO so it can stay low while the ADC signals DOUT/RDY */
+    if(adi_gpio_Init(gpio_device_memory, ADI_GPIO_MEMORY_SIZE) != ADI_GPIO_SUCCESS)
+        return SPI_FAILURE;
+    adi_gpio_OutputEnable(SPI_CS_PORT, SPI_CS_PIN, true);
+    adi_gpio_SetHigh(SPI_CS_PORT, SPI_CS_PIN);
+
     /* Open SPI module */
     status = adi_spi_Open(SPI_DEVICE_NR,
                           spi_device_memory,
@@ -154,15 +167,33 @@ int8_t SPI_Init(void)
     if(status != ADI_SPI_SUCCESS)
         return SPI_FAILURE;
 
-    /* Configure SPI for Arduino connectors */
+    /* CS is driven as GPIO, see SPI_HoldCS() */
     status = adi_spi_SetChipSelect(p_spi_device_handler,
-                                   ADI_SPI_CS0);
+                                   ADI_SPI_CS_NONE);
     if(status != ADI_SPI_SUCCESS)
         return SPI_FAILURE;
 
     return SPI_SUCCESS;
 }
 
+/**
+   @brief Keep CS low between transfers
+
+   @param hold - true to keep CS low, false to release it after each transfer
+
+   @return none
+
+**/
+void SPI_HoldCS(bool hold)
+{
+    spi_cs_hold = hold;
+
+    if(hold)
+        adi_gpio_SetLow(SPI_CS_PORT, SPI_CS_PIN);
+    else
+        adi_gpio_SetHigh(SPI_CS_PORT, SPI_CS_PIN);
+}
+
 /**
    @brief Reads a specified register address in the converter via SPI.
 
@@ -195,8 +226,11 @@ uint32_t SPI_Read(uint8_t ui8address, uint8_t ui8bytes)
     spi_telegram.bRD_CTL 			= false; /* Full-duplex */
 
     /* Transmit register address and receive the read */
+    adi_gpio_SetLow(SPI_CS_PORT, SPI_CS_PIN);
     status = adi_spi_MasterReadWrite(p_spi_device_handler,
                                      &spi_telegram);
+    if(!spi_cs_hold)
+        adi_gpio_SetHigh(SPI_CS_PORT, SPI_CS_PIN);
     if(status != ADI_SPI_SUCCESS)
         return SPI_FAILURE;
 
@@ -234,6 +268,8 @@ int8_t SPI_Write(uint8_t ui8address, uint32_t ui32data, uint8_t ui8bytes)
     spi_telegram.bDMA 				= false; /* No DMA */
     spi_telegram.bRD_CTL 			= false; /* Full-duplex */
 
+    adi_gpio_SetLow(SPI_CS_PORT, SPI_CS_PIN);
+
     /* Separate data into 8 bits values */
     if(ui8bytes != 4) {
         ui8write[0] = ui8address;
@@ -245,8 +281,6 @@ int8_t SPI_Write(uint8_t ui8address, uint32_t ui32data, uint8_t ui8bytes)
         /* Transmit data */
         status = adi_spi_MasterReadWrite(p_spi_device_handler,
                                          &spi_telegram);
-        if(status != ADI_SPI_SUCCESS)
-            return SPI_FAILURE;
 
         /* Transmit 4 0xFF bytes */
     } else {
@@ -256,9 +290,13 @@ int8_t SPI_Write(uint8_t ui8address, uint32_t ui32data, uint8_t ui8bytes)
         /* Transmit data */
         status = adi_spi_MasterReadWrite(p_spi_device_handler,
                                          &spi_telegram);
-        if(status != ADI_SPI_SUCCESS)
-            return SPI_FAILURE;
     }
+
+    if(!spi_cs_hold)
+        adi_gpio_SetHigh(SPI_CS_PORT, SPI_CS_PIN);
+    if(status != ADI_SPI_SUCCESS)
+        return SPI_FAILURE;
+
     return SPI_SUCCESS;
 }
 
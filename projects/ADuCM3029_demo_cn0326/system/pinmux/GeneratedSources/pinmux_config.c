@@ -46,7 +46,7 @@ int32_t adi_initpinmux(void) {
 	     | SPI0_MISO_PORTP0_MUX | I2C0_SCL0_PORTP0_MUX | I2C0_SDA0_PORTP0_MUX
 	     | UART0_TX_PORTP0_MUX | UART0_RX_PORTP0_MUX | UART0_UART_SOUT_EN_PORTP0_MUX;
 	*((volatile uint32_t *)REG_GPIO1_CFG) = SPI0_CS_1_PORTP1_MUX | SPI1_SCLK_PORTP1_MUX
-	     | SPI1_MISO_PORTP1_MUX | SPI1_MOSI_PORTP1_MUX | SPI1_CS_0_PORTP1_MUX
+	     | SPI1_MISO_PORTP1_MUX | SPI1_MOSI_PORTP1_MUX
 	     | SPI2_SCLK_PORTP1_MUX | SPI2_MISO_PORTP1_MUX | SPI2_MOSI_PORTP1_MUX
 	     | SPI2_CS_0_PORTP1_MUX;
 	*((volatile uint32_t *)REG_GPIO2_CFG) = SYS_CLK_CLOCK_OUT_PORTP2_MUX;
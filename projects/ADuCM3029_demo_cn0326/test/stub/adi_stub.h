@@ -0,0 +1,46 @@
+/* Host declarations of the ADuCM3029 GPIO driver used by the AD7793 driver */
+
+#ifndef ADI_STUB_H_
+#define ADI_STUB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef void (*ADI_CALLBACK)(void *cb_param, uint32_t event, void *arg);
+
+#define ADI_GPIO_PIN_7		(1 << 7)
+
+typedef enum {
+	ADI_GPIO_SUCCESS,
+	ADI_GPIO_FAILURE
+} ADI_GPIO_RESULT;
+
+typedef enum {
+	ADI_GPIO_PORT0,
+	ADI_GPIO_PORT1,
+	ADI_GPIO_PORT2,
+	ADI_GPIO_NUM_PORTS
+} ADI_GPIO_PORT;
+
+typedef enum {
+	ADI_GPIO_INTA_IRQ,
+	ADI_GPIO_INTB_IRQ
+} ADI_GPIO_IRQ;
+
+ADI_GPIO_RESULT adi_gpio_InputEnable(ADI_GPIO_PORT Port, uint16_t Pins,
+				     bool bFlag);
+ADI_GPIO_RESULT adi_gpio_GetData(ADI_GPIO_PORT Port, uint16_t Pins,
+				 uint16_t *pValue);
+ADI_GPIO_RESULT adi_gpio_SetGroupInterruptPins(ADI_GPIO_PORT Port,
+					       ADI_GPIO_IRQ eIrq,
+					       uint16_t Pins);
+ADI_GPIO_RESULT adi_gpio_GetGroupInterruptPolarity(ADI_GPIO_PORT Port,
+						   uint16_t *pPins);
+ADI_GPIO_RESULT adi_gpio_SetGroupInterruptPolarity(ADI_GPIO_PORT Port,
+						   uint16_t Pins);
+ADI_GPIO_RESULT adi_gpio_RegisterCallback(ADI_GPIO_IRQ eIrq,
+					  ADI_CALLBACK pfCallback,
+					  void *pCBParam);
+
+#endif /* ADI_STUB_H_ */
@@ -0,0 +1,511 @@
+/* Host test of the AD7793 driver on a register model
+ *
+ * The model follows the AD7793 data sheet at the 16.7 Hz update rate: a
+ * conversion takes 60 ms, the first one after a channel or mode change and
+ * each internal calibration take 120 ms. DOUT/RDY is only driven while CS is
+ * low and toggles with the SPI data, a falling edge calls the GPIO group
+ * interrupt when it is enabled. The offset and full-scale registers of each
+ * channel scale the results, they must not be written while the converter
+ * runs. A stalled converter never finishes a conversion or a calibration and
+ * leaves the coefficient registers it was calibrating undefined.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "Communication.h"
+#include "AD7793.h"
+#include "Timer.h"
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+#define T_CONV_US	60000.0
+#define T_SETTLE_US	(2 * T_CONV_US)
+#define T_RESET_US	500.0
+#define SPI_BYTE_US	2.0	/* 4 MHz */
+#define SPI_XFER_US	5.0
+
+/* Converter model */
+static double now_us;
+static double next_tick_us = 1000.0;
+static volatile timer_ticks_t delay_count;
+
+static uint32_t mode_reg, conf_reg, io_reg;
+static uint32_t offset_reg[AD7793_NB_CH], fullscale_reg[AD7793_NB_CH];
+static uint32_t data_reg;
+static bool rdy;		/* RDY bit, true when a result is waiting */
+static bool busy;
+static double done_us;
+static double reset_us = -1e9;
+static bool stalled;
+
+/* Chip errors the calibrations measure, inputs in codes */
+static const uint32_t chip_offset[AD7793_NB_CH] = {0x800123, 0x7FFF40, 0x800310};
+static const uint32_t chip_fullscale[AD7793_NB_CH] = {0x53A000, 0x541200, 0x549800};
+static const int32_t input[AD7793_NB_CH] = {-120000, 2500000, 4100000};
+
+/* Pins and interrupts */
+static bool cs_low;
+static bool pin_low;
+static uint16_t irq_pins;
+static uint16_t polarity = 0xFFFF;
+static ADI_CALLBACK rdy_cb;
+
+/* Counters */
+static uint32_t spi_xfers, spi_bytes, status_polls, violations, coef_writes;
+
+#define MD(m)		(((m) >> 13) & 7)
+#define CH()		(conf_reg & 7)
+
+static uint32_t code(uint8_t ch, uint32_t offset, uint32_t fullscale)
+{
+	int64_t raw = (int64_t)input[ch] * chip_fullscale[ch] / 0x500000 +
+		      ((int64_t)chip_offset[ch] - 0x800000);
+
+	return (uint32_t)(0x800000 + (raw - ((int64_t)offset - 0x800000)) *
+			  0x500000 / fullscale) & 0xFFFFFF;
+}
+
+static uint32_t result(uint8_t ch)
+{
+	return code(ch, offset_reg[ch], fullscale_reg[ch]);
+}
+
+/* Result with the coefficients of the calibrations */
+static uint32_t expected(uint8_t ch)
+{
+	return code(ch, chip_offset[ch], chip_fullscale[ch]);
+}
+
+static void update_pin(void)
+{
+	bool low = cs_low && rdy;
+
+	if (low && !pin_low && (irq_pins & ADI_GPIO_PIN_7) &&
+	    !(polarity & ADI_GPIO_PIN_7) && rdy_cb)
+		rdy_cb(NULL, ADI_GPIO_PORT1, NULL);
+	pin_low = low;
+}
+
+static void complete(void)
+{
+	uint8_t ch = CH();
+
+	switch (MD(mode_reg)) {
+	case CONTINUOUS_CONV:
+		data_reg = result(ch);
+		done_us += T_CONV_US;
+		break;
+	case SINGLE_CONV:
+		data_reg = result(ch);
+		mode_reg = (mode_reg & AD7793_MODE_MSK) | AD7793_MODE_SEL(IDLE_MODE);
+		busy = false;
+		break;
+	case CAL_INT_ZERO_MODE:
+		offset_reg[ch] = chip_offset[ch];
+		mode_reg = (mode_reg & AD7793_MODE_MSK) | AD7793_MODE_SEL(IDLE_MODE);
+		busy = false;
+		break;
+	case CAL_INT_FULL_MODE:
+		fullscale_reg[ch] = chip_fullscale[ch];
+		mode_reg = (mode_reg & AD7793_MODE_MSK) | AD7793_MODE_SEL(IDLE_MODE);
+		busy = false;
+		break;
+	}
+	rdy = true;
+	update_pin();
+}
+
+static void advance(double us)
+{
+	now_us += us;
+	while (now_us >= next_tick_us) {
+		next_tick_us += 1000.0;
+		if (delay_count)
+			delay_count--;
+	}
+	while (busy && !stalled && now_us >= done_us)
+		complete();
+}
+
+/* The driver polls the delay counter, each poll takes 1 us */
+volatile timer_ticks_t *model_delay(void)
+{
+	advance(1.0);
+
+	return &delay_count;
+}
+
+void timer_sleep(timer_ticks_t ticks)
+{
+	advance(ticks * 1000.0);
+}
+
+static void power_on(void)
+{
+	uint8_t ch;
+
+	mode_reg = 0x000A;
+	conf_reg = 0x0710;
+	io_reg = 0;
+	for (ch = 0; ch < AD7793_NB_CH; ch++) {
+		offset_reg[ch] = 0x800000;
+		fullscale_reg[ch] = 0x500000;
+	}
+	rdy = false;
+	/* Power-on mode is continuous conversion */
+	busy = true;
+	done_us = now_us + T_SETTLE_US;
+	reset_us = now_us;
+}
+
+static void start(void)
+{
+	rdy = false;
+	switch (MD(mode_reg)) {
+	case CONTINUOUS_CONV:
+	case SINGLE_CONV:
+	case CAL_INT_ZERO_MODE:
+	case CAL_INT_FULL_MODE:
+		busy = true;
+		done_us = now_us + T_SETTLE_US;
+		break;
+	default:
+		busy = false;
+		break;
+	}
+	if (stalled && MD(mode_reg) == CAL_INT_ZERO_MODE)
+		offset_reg[CH()] = 0x123456;
+	if (stalled && MD(mode_reg) == CAL_INT_FULL_MODE)
+		fullscale_reg[CH()] = 0x0000FF;
+	update_pin();
+}
+
+/* Time of a transfer, DOUT/RDY toggles with the data while CS is low */
+static void xfer(uint8_t bytes)
+{
+	spi_xfers++;
+	spi_bytes += bytes;
+	if (now_us - reset_us < T_RESET_US)
+		violations++;
+	if (cs_low && (irq_pins & ADI_GPIO_PIN_7) && rdy_cb)
+		rdy_cb(NULL, ADI_GPIO_PORT1, NULL);
+	advance(SPI_XFER_US + bytes * SPI_BYTE_US);
+}
+
+int8_t SPI_Init(void)
+{
+	return SPI_SUCCESS;
+}
+
+void SPI_HoldCS(bool hold)
+{
+	cs_low = hold;
+	update_pin();
+}
+
+uint32_t SPI_Read(uint8_t ui8address, uint8_t ui8bytes)
+{
+	uint8_t reg = (ui8address >> 3) & 7;
+	uint32_t value = 0;
+
+	xfer(1 + ui8bytes);
+	switch (reg) {
+	case AD7793_REG_STAT:
+		status_polls++;
+		value = (rdy ? 0 : RDY_BIT) | 0x08 | CH();
+		break;
+	case AD7793_REG_MODE:
+		value = mode_reg;
+		break;
+	case AD7793_REG_CONF:
+		value = conf_reg;
+		break;
+	case AD7793_REG_DATA:
+		value = data_reg;
+		rdy = false;
+		update_pin();
+		break;
+	case AD7793_REG_ID:
+		value = 0x4B;
+		break;
+	case AD7793_REG_IO:
+		value = io_reg;
+		break;
+	case AD7793_REG_OFFSET:
+		value = CH() < AD7793_NB_CH ? offset_reg[CH()] : 0;
+		break;
+	case AD7793_REG_FULLSCALE:
+		value = CH() < AD7793_NB_CH ? fullscale_reg[CH()] : 0;
+		break;
+	}
+
+	return value;
+}
+
+int8_t SPI_Write(uint8_t ui8address, uint32_t ui32data, uint8_t ui8bytes)
+{
+	uint8_t reg = (ui8address >> 3) & 7;
+	uint8_t ch;
+
+	/* 32 ones reset the serial interface and the registers */
+	if (ui8bytes == 4) {
+		spi_xfers++;
+		spi_bytes += 4;
+		advance(SPI_XFER_US + 4 * SPI_BYTE_US);
+		power_on();
+		return SPI_SUCCESS;
+	}
+
+	xfer(1 + ui8bytes);
+	switch (reg) {
+	case AD7793_REG_MODE:
+		mode_reg = ui32data & 0xFFFF;
+		start();
+		break;
+	case AD7793_REG_CONF:
+		ch = CH();
+		conf_reg = ui32data & 0xFFFF;
+		/* A channel change restarts the filter */
+		if (CH() != ch && busy && MD(mode_reg) == CONTINUOUS_CONV)
+			done_us = now_us + T_SETTLE_US;
+		break;
+	case AD7793_REG_IO:
+		io_reg = ui32data & 0xFF;
+		break;
+	case AD7793_REG_OFFSET:
+	case AD7793_REG_FULLSCALE:
+		if (busy)
+			violations++;
+		coef_writes++;
+		if (CH() >= AD7793_NB_CH)
+			break;
+		if (reg == AD7793_REG_OFFSET)
+			offset_reg[CH()] = ui32data & 0xFFFFFF;
+		else
+			fullscale_reg[CH()] = ui32data & 0xFFFFFF;
+		break;
+	}
+
+	return SPI_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_InputEnable(ADI_GPIO_PORT Port, uint16_t Pins,
+				     bool bFlag)
+{
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_GetData(ADI_GPIO_PORT Port, uint16_t Pins,
+				 uint16_t *pValue)
+{
+	*pValue = pin_low ? 0 : Pins;
+
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_SetGroupInterruptPins(ADI_GPIO_PORT Port,
+					       ADI_GPIO_IRQ eIrq,
+					       uint16_t Pins)
+{
+	irq_pins = Pins;
+
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_GetGroupInterruptPolarity(ADI_GPIO_PORT Port,
+						   uint16_t *pPins)
+{
+	*pPins = polarity;
+
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_SetGroupInterruptPolarity(ADI_GPIO_PORT Port,
+						   uint16_t Pins)
+{
+	polarity = Pins;
+
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_RegisterCallback(ADI_GPIO_IRQ eIrq,
+					  ADI_CALLBACK pfCallback,
+					  void *pCBParam)
+{
+	rdy_cb = pfCallback;
+
+	return ADI_GPIO_SUCCESS;
+}
+
+/* Reset and restore the cached coefficients, as the reset command does */
+static void reset_restore(void)
+{
+	AD7793_Reset();
+	AD7793_RestoreCalibration();
+}
+
+static void test_init(void)
+{
+	AD7793_Init();
+	CHECK(violations == 0);
+	/* Only the DOUT/RDY pin of port 1 changes polarity */
+	CHECK(polarity == (uint16_t)~ADI_GPIO_PIN_7);
+	CHECK(rdy_cb != NULL);
+	CHECK((conf_reg & 0x7F8) == ((AD7793_GAIN << 8) | AD7793_REFSEL |
+				    AD7793_BUF));
+	CHECK(io_reg == 0x02);
+}
+
+/* A calibration that times out caches nothing */
+static void test_timeout(void)
+{
+	double t0;
+
+	stalled = true;
+	t0 = now_us;
+	CHECK(AD7793_CalibrateChannel(AD7793_CH_AIN1P_AIN1M) == -1);
+	CHECK(now_us - t0 >= (AD7793_RDY_TIMEOUT - 1) * 1000.0);
+	CHECK(now_us - t0 < 2.5 * AD7793_RDY_TIMEOUT * 1000.0);
+	CHECK(!cs_low);
+	stalled = false;
+
+	/* The undefined registers are not restored after a reset */
+	coef_writes = 0;
+	reset_restore();
+	CHECK(coef_writes == 0);
+	CHECK(offset_reg[0] == 0x800000 && fullscale_reg[0] == 0x500000);
+	CHECK(AD7793_CalibrateChannel(3) == -1);
+	CHECK(violations == 0);
+}
+
+static void test_calibrate(void)
+{
+	uint8_t ch;
+	double t0;
+
+	for (ch = 0; ch < AD7793_NB_CH; ch++) {
+		/* Calibrated results are within a code of the input */
+		CHECK(expected(ch) - (0x800000 + input[ch]) + 1 <= 2);
+		CHECK(code(ch, 0x800000, 0x500000) != expected(ch));
+		t0 = now_us;
+		CHECK(AD7793_CalibrateChannel(ch) == 0);
+		CHECK(offset_reg[ch] == chip_offset[ch]);
+		CHECK(fullscale_reg[ch] == chip_fullscale[ch]);
+		/* Two calibrations, 120 ms each */
+		CHECK(now_us - t0 >= 2 * T_SETTLE_US &&
+		      now_us - t0 < 2 * T_SETTLE_US + 1000.0);
+	}
+	CHECK(violations == 0);
+	CHECK(status_polls == 0);
+}
+
+static void test_scan(void)
+{
+	uint32_t xfers, polls;
+	double t0, settle, next;
+	int i;
+
+	/* First continuous result of a channel after the filter settled */
+	t0 = now_us;
+	CHECK(AD7793_Scan(CONTINUOUS_CONV, AD7793_CH_AIN2P_AIN2M) ==
+	      expected(1));
+	settle = now_us - t0;
+	CHECK(settle >= T_SETTLE_US && settle < T_SETTLE_US + 1000.0);
+	CHECK(cs_low);
+
+	/* The next results of the same channel come every conversion and
+	 * each takes one data read */
+	xfers = spi_xfers;
+	t0 = now_us;
+	for (i = 0; i < 10; i++)
+		CHECK(AD7793_Scan(CONTINUOUS_CONV, AD7793_CH_AIN2P_AIN2M) ==
+		      expected(1));
+	next = (now_us - t0) / 10;
+	CHECK(next > T_CONV_US - 1000.0 && next < T_CONV_US + 1000.0);
+	CHECK(spi_xfers - xfers == 10);
+
+	/* pH reading: temperature and pH channels */
+	t0 = now_us;
+	for (i = 0; i < 5; i++) {
+		CHECK(AD7793_Scan(CONTINUOUS_CONV, AD7793_CH_AIN2P_AIN2M) ==
+		      expected(1));
+		CHECK(AD7793_Scan(CONTINUOUS_CONV, AD7793_CH_AIN1P_AIN1M) ==
+		      expected(0));
+	}
+	CHECK(AD7793_GetResult(AD7793_CH_AIN2P_AIN2M) == expected(1));
+	printf("continuous: first %.1f ms, next %.1f ms, pH pair %.1f ms\n",
+	       settle / 1000, next / 1000, (now_us - t0) / 5000);
+
+	/* A single conversion releases CS */
+	polls = status_polls;
+	CHECK(AD7793_Scan(SINGLE_CONV, AD7793_CH_AIN3P_AIN3M) == expected(2));
+	CHECK(!cs_low);
+	CHECK(status_polls == polls);
+	CHECK(violations == 0);
+}
+
+static void test_restore(void)
+{
+	uint8_t ch;
+
+	/* A reset loses the coefficients, the cached ones come back without
+	 * calibrating again */
+	reset_restore();
+	for (ch = 0; ch < AD7793_NB_CH; ch++) {
+		CHECK(offset_reg[ch] == chip_offset[ch]);
+		CHECK(fullscale_reg[ch] == chip_fullscale[ch]);
+	}
+	CHECK(AD7793_Scan(CONTINUOUS_CONV, AD7793_CH_AIN2P_AIN2M) ==
+	      expected(1));
+	CHECK(AD7793_Scan(SINGLE_CONV, AD7793_CH_AIN1P_AIN1M) == expected(0));
+
+	/* A calibration timing out later keeps the last good coefficients */
+	stalled = true;
+	CHECK(AD7793_CalibrateChannel(AD7793_CH_AIN2P_AIN2M) == -1);
+	stalled = false;
+	CHECK(offset_reg[1] != chip_offset[1]);
+	reset_restore();
+	CHECK(offset_reg[1] == chip_offset[1]);
+	CHECK(fullscale_reg[1] == chip_fullscale[1]);
+	CHECK(AD7793_Scan(CONTINUOUS_CONV, AD7793_CH_AIN2P_AIN2M) ==
+	      expected(1));
+	CHECK(violations == 0);
+}
+
+/* A conversion timing out returns the last result and the next scan starts
+ * over */
+static void test_scan_timeout(void)
+{
+	stalled = true;
+	CHECK(AD7793_Scan(CONTINUOUS_CONV, AD7793_CH_AIN1P_AIN1M) ==
+	      expected(0));
+	CHECK(!cs_low);
+	stalled = false;
+	CHECK(AD7793_Scan(CONTINUOUS_CONV, AD7793_CH_AIN1P_AIN1M) ==
+	      expected(0));
+	CHECK(violations == 0);
+}
+
+int main(void)
+{
+	power_on();
+	test_init();
+	test_timeout();
+	test_calibrate();
+	test_scan();
+	test_restore();
+	test_scan_timeout();
+
+	printf(failures ? "FAILED\n" : "OK\n");
+
+	return failures ? 1 : 0;
+}
@@ -57,13 +57,17 @@ POSSIBILITY OF SUCH DAMAGE.
  * Enable Bluetooth
  *      - 0: Printf used to display the sensor readings
  *      - 1: Bluetooth used to send the sensor readings to the host
+ *      - 2: Sensor readings broadcast in sensor beacon frames, no connection
  *
  */
 #define ADI_APP_USE_BLUETOOTH (1u)
 
+/* Broadcast mode: seconds between two gas readings */
+#define ADI_APP_BROADCAST_PERIOD (2u)
+
 /*********** Macro Validation *********/
-#if ADI_APP_USE_BLUETOOTH != 0u && ADI_APP_USE_BLUETOOTH != 1u
-#error "ADI_APP_USE_BLUETOOTH must be set to 0 or 1"
+#if ADI_APP_USE_BLUETOOTH != 0u && ADI_APP_USE_BLUETOOTH != 1u && ADI_APP_USE_BLUETOOTH != 2u
+#error "ADI_APP_USE_BLUETOOTH must be set to 0, 1 or 2"
 #endif
 
 typedef union {
@@ -54,6 +54,7 @@ POSSIBILITY OF SUCH DAMAGE.
 #include <gas/cn0357/adi_cn0357.h>
 #include <common/adi_error_handling.h>
 #include <framework/noos/adi_ble_noos.h>
+#include <beacon/adi_ble_broadcast.h>
 #include <base_sensor/adi_sensor_packet.h>
 #include <base_sensor/adi_sensor_errors.h>
 
@@ -78,6 +79,8 @@ static void ApplicationCallback(void * pCBParam, uint32_t Event, void * pArg);
 static void SetAdvertisingMode(void);
 static void InitBluetooth(void);
 static uint8_t GasSensorBluetoothMode(Gas *gas);
+#elif ADI_APP_USE_BLUETOOTH == 2u
+static uint8_t GasSensorBroadcastMode(Gas *gas);
 #else
 static uint8_t GasSensorStandaloneMode(Gas *gas);
 #endif
@@ -109,6 +112,11 @@ int main(void)
 	if(GasSensorBluetoothMode(gas) == 1u)
 		return (1u);
 
+#elif (ADI_APP_USE_BLUETOOTH == 2u)
+
+	if(GasSensorBroadcastMode(gas) == 1u)
+		return (1u);
+
 #else
 
 	if(GasSensorStandaloneMode(gas) == 1u)
@@ -368,6 +376,57 @@ static void InitBluetooth(void)
 	/* Now enter infinite loop waiting for connection and then data exchange events */
 	DEBUG_MESSAGE("Waiting for connection. Initiate connection on central device please.\r\n");
 }
+#elif ADI_APP_USE_BLUETOOTH == 2u
+
+/*!
+ * @brief      Broadcast C0 gas demo.
+ *
+ * @details    Broadcasts the CO ppm values to any observer without a
+ *             connection. The core sleeps between two readings while the
+ *             radio keeps advertising the last one. The radio is started
+ *             after the CN0357 is opened, see InitBluetooth().
+ */
+uint8_t GasSensorBroadcastMode(Gas *gas)
+{
+	ADI_BLER_RESULT  eResult;
+	ADI_BEACON_FRAME sFrame;
+	ADI_BEACON_SCHED sSched;
+	float            fConcentration;
+	SENSOR_RESULT    eSensorResult;
+
+	/* Init timestamping */
+	INIT_TIME();
+
+	sFrame.nNumValues         = 1u;
+	sFrame.aValues[0u].nType  = ADI_BEACON_VALUE_GAS;
+	sFrame.aValues[0u].nValue = 0;
+
+	eResult = adi_broadcast_Start(&sFrame, ADI_CFG_BROADCAST_ADV_INTERVAL);
+	DEBUG_RESULT("Error starting the broadcast.\r\n", eResult,
+		     ADI_BLER_SUCCESS);
+
+	adi_beacon_SchedInit(&sSched,
+			     ADI_APP_BROADCAST_PERIOD * ADI_CFG_BROADCAST_TICK_HZ,
+			     GET_TIME());
+
+	while(1u) {
+		/* Read gas sensor */
+		eSensorResult = gas->getPPM(&fConcentration);
+
+		if(eSensorResult != SENSOR_ERROR_NONE) {
+			PRINT_SENSOR_ERROR(DEBUG_MESSAGE, eSensorResult);
+			return (1u);
+		}
+
+		sFrame.aValues[0u].nValue = adi_beacon_FromFloat(fConcentration, 0.1f);
+
+		eResult = adi_broadcast_Update(&sFrame);
+		DEBUG_RESULT("Error updating the broadcast.\r\n", eResult,
+			     ADI_BLER_SUCCESS);
+
+		adi_broadcast_Sleep(&sSched);
+	}
+}
 #else
 /*!
  * @brief      Standalone C0 gas demo.
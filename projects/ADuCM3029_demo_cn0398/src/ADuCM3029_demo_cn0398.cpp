@@ -261,8 +261,8 @@ static void MQTTPublishCN0398(CN0398 pCn)
 				DEBUG_MESSAGE("Publishing data..\n");
 
 				timer_sleep(500);
-				pCn.set_data();
-				pCn.display_data();
+				if(pCn.set_data() == SENSOR_ERROR_NONE)
+					pCn.display_data();
 			}
 
 			/* If we failed to ping the broker or failed to publish data,
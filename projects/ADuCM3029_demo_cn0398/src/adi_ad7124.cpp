@@ -333,6 +333,47 @@ int32_t AD7124::ReadData( int32_t* pData)
 	return ret;
 }
 
+/**************************************************************************//**
+ * @brief Reads the conversion result and the status byte appended to it when
+ *        DATA_STATUS is set in the ADC control register.
+ *
+ * @param pData - Pointer to store the read data.
+ * @param pStatus - Pointer to store the status, it holds the channel the
+ *                  result belongs to.
+ *
+ * @return Returns 0 for success or negative error code.
+ *****************************************************************************/
+int32_t AD7124::ReadDataWithStatus(int32_t* pData, uint8_t* pStatus)
+{
+	int32_t ret       = 0;
+	uint8_t buffer[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	uint8_t i         = 0;
+	ad7124_st_reg *pReg;
+
+	if(!pData || !pStatus)
+		return INVALID_VAL;
+
+	pReg = &regs[AD7124_Data];
+
+	/* Build the Command word */
+	buffer[0] = AD7124_COMM_REG_WEN | AD7124_COMM_REG_RD |
+	            AD7124_COMM_REG_RA(pReg->addr);
+
+	ret = SPI_Read(buffer, pReg->size + 2);
+	if(ret < 0)
+		return ret;
+
+	/* Build the result */
+	*pData = 0;
+	for(i = 1; i < pReg->size + 1; i++) {
+		*pData <<= 8;
+		*pData += buffer[i];
+	}
+	*pStatus = buffer[pReg->size + 1];
+
+	return ret;
+}
+
 /**************************************************************************//**
  * @brief Computes the CRC checksum for a data buffer.
  *
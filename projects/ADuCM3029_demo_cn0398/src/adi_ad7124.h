@@ -38,6 +38,10 @@
 #define AD7124_SPI_CS_PORT ADI_GPIO_PORT1
 #define AD7124_SPI_CS_PIN  ADI_GPIO_PIN_10
 
+/* DOUT/RDY is shared with SPI0 MISO */
+#define AD7124_RDY_PORT ADI_GPIO_PORT0
+#define AD7124_RDY_PIN  ADI_GPIO_PIN_2
+
 /* Communication Register bits */
 #define AD7124_COMM_REG_WEN    (0 << 7)
 #define AD7124_COMM_REG_WR     (0 << 6)
@@ -522,6 +526,9 @@ public:
 	/*! Reads the conversion result from the device. */
 	int32_t ReadData(int32_t* pData);
 
+	/*! Reads the conversion result and the status appended to it. */
+	int32_t ReadDataWithStatus(int32_t* pData, uint8_t* pStatus);
+
 	/*! Computes the CRC checksum for a data buffer. */
 	uint8_t ComputeCRC8(uint8_t* pBuf, uint8_t bufSize);
 
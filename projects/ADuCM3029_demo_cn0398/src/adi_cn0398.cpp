@@ -21,12 +21,29 @@ namespace adi_sensor_swpack
 
 #define ms_delay (1)
 
+/* Callendar-Van Dusen coefficients */
+#define CVD_A (3.9083e-3f)
+#define CVD_B (-5.775e-7f)
+
+/* ADC control: continuous conversion, full power, status appended to data */
+#define ADC_CONTROL_CONTINUOUS (AD7124_ADC_CTRL_REG_DATA_STATUS | \
+								AD7124_ADC_CTRL_REG_REF_EN | \
+								AD7124_ADC_CTRL_REG_POWER_MODE(2) | \
+								AD7124_ADC_CTRL_REG_MODE(0))
+/* ADC control: standby, as left by init() */
+#define ADC_CONTROL_STANDBY (AD7124_ADC_CTRL_REG_DATA_STATUS | \
+							 AD7124_ADC_CTRL_REG_REF_EN | \
+							 AD7124_ADC_CTRL_REG_POWER_MODE(2) | \
+							 AD7124_ADC_CTRL_REG_MODE(2))
+
 float temperature, pH, voltage[2], moisture;
 
 uint8_t mem_gpio_handler[ADI_GPIO_MEMORY_SIZE];
 
 int32_t adcValue[3];
 
+static volatile bool rdy_flag = false;
+
 ADI_WIFI_PUBLISH_CONFIG gPublishConfig = {
 	.pMQTTData = NULL,
 	.nMQTTDataSize = 0,
@@ -134,13 +151,20 @@ void CN0398::calibrate_ph_offset()
 	set_digital_output(P2, false);
 }
 
-float CN0398::read_rtd()
+/**
+ * @brief: DOUT/RDY falling edge, a sequencer result is ready
+ */
+static void ad7124_rdy_callback(void *pCBParam, uint32_t Port,
+								void *PinIntData)
 {
-	float temperature = 0;
-
-	int32_t data;
+	/* Masked until the result is read, SPI traffic toggles the pin */
+	adi_gpio_SetGroupInterruptPins(AD7124_RDY_PORT, ADI_GPIO_INTB_IRQ, 0);
+	rdy_flag = true;
+}
 
-	adcValue[RTD_CHANNEL] = data = read_channel(RTD_CHANNEL);
+float CN0398::rtd_to_temperature(int32_t data)
+{
+	float temperature = 0;
 
 	float resistance = ((static_cast<float>(data) - _2_23) * RREF) /
 					   (TEMP_GAIN * _2_23);
@@ -148,21 +172,26 @@ float CN0398::read_rtd()
 #ifdef USE_LINEAR_TEMP_EQ
 	temperature = PT100_RESISTANCE_TO_TEMP(resistance);
 #else
-
-#define A (3.9083*pow(10,-3))
-#define B (-5.775*pow(10,-7))
 	if(resistance < R0)
-		temperature = -242.02 + 2.228 * resistance + (2.5859 * pow(10, -3)) *
-					  pow(resistance, 2) - (48260.0 * pow(10, -6)) *
-					  pow(resistance, 3) - (2.8183 * pow(10, -3)) *
-					  pow(resistance, 4) + (1.5243 * pow(10, -10)) *
-					  pow(resistance, 5);
+		/* Inverse Callendar-Van Dusen fit, Horner form */
+		temperature = -242.02f + resistance * (2.2228f + resistance *
+					  (2.5859e-3f + resistance * (-4.8260e-6f + resistance *
+					  (-2.8183e-8f + resistance * 1.5243e-10f))));
 	else
-		temperature = ((-A + sqrt(double(pow(A, 2) - 4 * B *
-					  (1 - resistance / R0))) ) / (2 * B));
+		temperature = (-CVD_A + sqrtf(CVD_A * CVD_A - 4 * CVD_B *
+					  (1 - resistance / static_cast<float>(R0)))) /
+					  (2 * CVD_B);
 #endif
 	return temperature;
+}
+
+float CN0398::read_rtd()
+{
+	int32_t data;
+
+	adcValue[RTD_CHANNEL] = data = read_channel(RTD_CHANNEL);
 
+	return rtd_to_temperature(data);
 }
 
 int32_t CN0398::read_channel(uint8_t ch)
@@ -209,6 +238,19 @@ float CN0398::read_ph(float temperature)
 	float volt = voltage[PH_CHANNEL - 1] =
 				 data_to_voltage_bipolar(data, 1, 3.3);
 
+	ph = voltage_to_ph(volt, temperature);
+
+	set_digital_output(P2, false);
+
+#endif
+	return ph;
+
+}
+
+float CN0398::voltage_to_ph(float volt, float temperature)
+{
+	float ph;
+
 	if(use_nernst) {
 		ph  = PH_ISO -((volt - ZERO_POINT_TOLERANCE) /
 			  ((2.303 * AVOGADRO * (temperature + KELVIN_OFFSET)) /
@@ -220,11 +262,7 @@ float CN0398::read_ph(float temperature)
 			 calibration_ph[1][0];
 	}
 
-	set_digital_output(P2, false);
-
-#endif
 	return ph;
-
 }
 
 float CN0398::read_moisture()
@@ -246,6 +284,18 @@ float CN0398::read_moisture()
 																		 1,
 																		 3.3);
 
+	moisture = voltage_to_moisture(volt);
+#endif
+
+	set_digital_output(P3, false);
+
+	return moisture;
+}
+
+float CN0398::voltage_to_moisture(float volt)
+{
+	float moisture = 0;
+
 #ifdef USE_MANUFACTURER_MOISTURE_EQ
 	if(volt <= 1.1) {
 		moisture = 10 * volt - 1;
@@ -257,16 +307,13 @@ float CN0398::read_moisture()
 		moisture = 26.32 * volt - 7.89;
 	}
 #else
-	moisture = -1.18467 + 21.5371 * volt - 110.996 * (pow(volt, 2)) + 397.025 *
-			   (pow(volt, 3)) - 666.986 * (pow(volt, 4)) + 569.236 *
-			   (pow(volt, 5)) - 246.005 * (pow(volt, 6)) + 49.4867 *
-			   (pow(volt, 7)) - 3.37077 * (pow(volt, 8));
+	/* Horner form of the 8th order fit */
+	moisture = -1.18467f + volt * (21.5371f + volt * (-110.996f + volt *
+			   (397.025f + volt * (-666.986f + volt * (569.236f + volt *
+			   (-246.005f + volt * (49.4867f + volt * -3.37077f)))))));
 #endif
 	if(moisture > 100) moisture = 100;
 	if(moisture < 0 ) moisture = 0;
-#endif
-
-	set_digital_output(P3, false);
 
 	return moisture;
 }
@@ -567,13 +614,185 @@ SENSOR_RESULT CN0398::init()
 	return SENSOR_ERROR_NONE;
 }
 
-void CN0398::set_data(void)
+/**
+ * @brief: Starts continuous conversions on all channels in the sequencer
+ *
+ * The pH and moisture excitations are switched on first and settle while the
+ * other channels convert.
+ */
+void CN0398::start_sequence(void)
 {
+	seq_mask = (1 << RTD_CHANNEL);
+#ifdef PH_SENSOR_PRESENT
+	seq_mask |= (1 << PH_CHANNEL);
+	set_digital_output(P2, true);
+#endif
+#ifdef MOISTURE_SENSOR_PRESENT
+	seq_mask |= (1 << MOISTURE_CHANNEL);
+	adi_gpio_OutputEnable(ADP7118_PORT, ADP7118_PIN, true);
+	adi_gpio_SetHigh(ADP7118_PORT, ADP7118_PIN);
+	set_digital_output(P3, true);
+#endif
+	seq_start_ms = ui32timer_counter;
+	seq_done = 0;
+
+	for(uint8_t ch = 0; ch < CHANNELS_NUMBER; ch++)
+		if(seq_mask & (1 << ch))
+			enable_channel(ch);
+
+	adi_gpio_InputEnable(AD7124_RDY_PORT, AD7124_RDY_PIN, true);
+	adi_gpio_SetGroupInterruptPolarity(AD7124_RDY_PORT, ~AD7124_RDY_PIN);
+	adi_gpio_RegisterCallback(ADI_GPIO_INTB_IRQ, ad7124_rdy_callback, NULL);
+
+	ad7124.WriteDeviceRegister(AD7124::AD7124_ADC_Control,
+							   ADC_CONTROL_CONTINUOUS);
+	seq_last_rdy_ms = ui32timer_counter;
+
+	/* DOUT/RDY only signals conversions while CS is low */
+	convFlag = 1;
+	adi_gpio_SetLow(AD7124_SPI_CS_PORT, AD7124_SPI_CS_PIN);
+	rdy_flag = false;
+	adi_gpio_SetGroupInterruptPins(AD7124_RDY_PORT, ADI_GPIO_INTB_IRQ,
+								   AD7124_RDY_PIN);
+}
+
+/**
+ * @brief: Collects the result signaled by DOUT/RDY, if any
+ *
+ * A result is kept only if its conversion started after the excitation of its
+ * channel settled, that is after the previous result of any channel.
+ *
+ * @return 1 when all channels have a result, 0 if not, negative on error
+ */
+int32_t CN0398::service_sequence(void)
+{
+	const uint16_t settling[CHANNELS_NUMBER] = {
+		0, PH_SETTLING_TIME, SENSOR_SETTLING_TIME
+	};
+	uint32_t now;
+	uint16_t level;
+	int32_t data;
+	uint8_t status, ch;
+
+	if(!rdy_flag)
+		return 0;
+	rdy_flag = false;
+	now = ui32timer_counter;
+
+	/* Edges latched during SPI traffic leave the pin high */
+	adi_gpio_GetData(AD7124_RDY_PORT, AD7124_RDY_PIN, &level);
+	if(!level) {
+		if(ad7124.ReadDataWithStatus(&data, &status) < 0)
+			return -1;
+
+		ch = AD7124_STATUS_REG_CH_ACTIVE(status);
+		if(ch < CHANNELS_NUMBER && (seq_mask & (1 << ch)) &&
+		   !(seq_done & (1 << ch)) &&
+		   seq_last_rdy_ms - seq_start_ms >= settling[ch]) {
+			seq_data[ch] = data;
+			seq_done |= (1 << ch);
+		}
+		seq_last_rdy_ms = now;
+	}
+
+	if(seq_done == seq_mask)
+		return 1;
+
+	adi_gpio_SetGroupInterruptPins(AD7124_RDY_PORT, ADI_GPIO_INTB_IRQ,
+								   AD7124_RDY_PIN);
+	/* Do not miss a result that came while the interrupt was masked */
+	adi_gpio_GetData(AD7124_RDY_PORT, AD7124_RDY_PIN, &level);
+	if(!level)
+		rdy_flag = true;
+
+	return 0;
+}
+
+/**
+ * @brief: Stops the sequencer and switches the excitations off
+ */
+void CN0398::stop_sequence(void)
+{
+	adi_gpio_SetGroupInterruptPins(AD7124_RDY_PORT, ADI_GPIO_INTB_IRQ, 0);
+	adi_gpio_SetHigh(AD7124_SPI_CS_PORT, AD7124_SPI_CS_PIN);
+	convFlag = 0;
+
+	ad7124.WriteDeviceRegister(AD7124::AD7124_ADC_Control,
+							   ADC_CONTROL_STANDBY);
+
+	for(uint8_t ch = 0; ch < CHANNELS_NUMBER; ch++)
+		if(seq_mask & (1 << ch))
+			disable_channel(ch);
+
+#ifdef MOISTURE_SENSOR_PRESENT
+	adi_gpio_SetLow(ADP7118_PORT, ADP7118_PIN);
+	set_digital_output(P3, false);
+#endif
+#ifdef PH_SENSOR_PRESENT
+	set_digital_output(P2, false);
+#endif
+}
+
+/**
+ * @brief: Reads all channels in one sequence
+ *
+ * @param timeout - ms to wait for all the results
+ */
+SENSOR_RESULT CN0398::read_sequence(uint32_t timeout)
+{
+	int32_t ret;
+
+	start_sequence();
+	do {
+		ret = service_sequence();
+	} while(!ret && ui32timer_counter - seq_start_ms < timeout);
+	stop_sequence();
+
+	return (ret == 1) ? SENSOR_ERROR_NONE : SENSOR_ERROR_ADC;
+}
+
+/**
+ * @brief: Reads all sensors and updates the values shown by display_data()
+ *
+ * @return SENSOR_ERROR_NONE, or SENSOR_ERROR_ADC if the AD7124 did not give
+ *         all results in time. The previous values are then left unchanged
+ *         and must not be displayed.
+ */
+SENSOR_RESULT CN0398::set_data(void)
+{
+#ifdef USE_SEQUENCER
+	uint8_t ui8S[200];
+
+	if(read_sequence(SEQUENCE_TIMEOUT) != SENSOR_ERROR_NONE) {
+		sprintf((char *)ui8S,"TIMEOUT\n");
+		gPublishConfig.pMQTTData = ui8S;
+		gPublishConfig.nMQTTDataSize = strlen((char *)ui8S);
+		adi_wifi_radio_MQTTPublish(&gPublishConfig);
+		return SENSOR_ERROR_ADC;
+	}
+
+	adcValue[RTD_CHANNEL] = seq_data[RTD_CHANNEL];
+	temperature = rtd_to_temperature(seq_data[RTD_CHANNEL]);
+#ifdef PH_SENSOR_PRESENT
+	adcValue[PH_CHANNEL] = seq_data[PH_CHANNEL];
+	voltage[PH_CHANNEL - 1] = data_to_voltage_bipolar(seq_data[PH_CHANNEL],
+													  1, 3.3);
+	pH = voltage_to_ph(voltage[PH_CHANNEL - 1], temperature);
+#endif
+#ifdef MOISTURE_SENSOR_PRESENT
+	adcValue[MOISTURE_CHANNEL] = seq_data[MOISTURE_CHANNEL];
+	voltage[MOISTURE_CHANNEL - 1] =
+		data_to_voltage_bipolar(seq_data[MOISTURE_CHANNEL], 1, 3.3);
+	moisture = voltage_to_moisture(voltage[MOISTURE_CHANNEL - 1]);
+#endif
+#else
 	temperature = read_rtd();
 
 	pH = read_ph(temperature);
 
 	moisture = read_moisture();
+#endif
+	return SENSOR_ERROR_NONE;
 }
 
 void CN0398::display_data(void)
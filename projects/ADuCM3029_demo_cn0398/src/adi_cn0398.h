@@ -14,6 +14,7 @@
 #define RTD_CHANNEL        0
 #define PH_CHANNEL         1
 #define MOISTURE_CHANNEL   2
+#define CHANNELS_NUMBER    3
 
 
 #define R0        100.0
@@ -159,6 +160,8 @@ extern "C" {
 	int UART_WriteString(char *string);
 	void AppPrintf(const char *fmt, ...);
 	void UART_Interrupt(void);
+
+	extern volatile uint32_t ui32timer_counter;
 }
 
 namespace adi_sensor_swpack
@@ -190,6 +193,14 @@ public:
 	float read_ph(float temperature = 25.0);
 	float read_moisture();
 
+	float rtd_to_temperature(int32_t data);
+	float voltage_to_ph(float volt, float temperature);
+	float voltage_to_moisture(float volt);
+
+	void start_sequence(void);
+	int32_t service_sequence(void);
+	void stop_sequence(void);
+	SENSOR_RESULT read_sequence(uint32_t timeout);
 
 
 	int32_t read_channel(uint8_t ch);
@@ -209,7 +220,7 @@ public:
 	void reset();
 	void setup();
 	SENSOR_RESULT init();
-	void set_data(void);
+	SENSOR_RESULT set_data(void);
 	void display_data(void);
 	void calibrate_ph(void);
 	void print_calibration_solutions(void);
@@ -219,11 +230,19 @@ public:
 	bool use_nernst = false;
 	const float default_offset_voltage = 0;
 	const uint16_t SENSOR_SETTLING_TIME = 400; /*in ms*/
+	const uint16_t PH_SETTLING_TIME = 100; /*in ms*/
 	float offset_voltage;
 	float default_calibration_ph[2][2] = {{4, 0.169534}, {10,  -0.134135}};
 	float calibration_ph[2][2];
 	uint8_t solution0,solution1;
 
+	/* Sequencer acquisition state */
+	uint8_t seq_mask;
+	uint8_t seq_done;
+	int32_t seq_data[CHANNELS_NUMBER];
+	uint32_t seq_start_ms;
+	uint32_t seq_last_rdy_ms;
+
 };
 
 }
@@ -26,5 +26,11 @@
 /* comment if you don't want to use it */
 //#define USE_LINEAR_TEMP_EQ
 
+/* convert all channels in one AD7124 sequence, comment to read them one by
+ * one */
+#define USE_SEQUENCER
+/* ms, give up on a sequence that did not complete */
+#define SEQUENCE_TIMEOUT 2000
+
 
 #endif /* _ADI_CN0398_CFG_H_ */
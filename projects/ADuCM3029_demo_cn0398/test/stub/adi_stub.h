@@ -0,0 +1,116 @@
+/* Host declarations of the ADuCM3029 drivers and Wi-Fi framework used by the
+ * CN0398 and AD7124 sources */
+
+#ifndef ADI_STUB_H_
+#define ADI_STUB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+typedef void (*ADI_CALLBACK)(void *cb_param, uint32_t event, void *arg);
+
+/* GPIO */
+#define ADI_GPIO_MEMORY_SIZE	16
+#define ADI_GPIO_PIN_2		(1 << 2)
+#define ADI_GPIO_PIN_9		(1 << 9)
+#define ADI_GPIO_PIN_10		(1 << 10)
+
+typedef enum {
+	ADI_GPIO_SUCCESS,
+	ADI_GPIO_FAILURE
+} ADI_GPIO_RESULT;
+
+typedef enum {
+	ADI_GPIO_PORT0,
+	ADI_GPIO_PORT1,
+	ADI_GPIO_PORT2,
+	ADI_GPIO_NUM_PORTS
+} ADI_GPIO_PORT;
+
+typedef enum {
+	ADI_GPIO_INTA_IRQ,
+	ADI_GPIO_INTB_IRQ
+} ADI_GPIO_IRQ;
+
+ADI_GPIO_RESULT adi_gpio_Init(void *pMemory, uint32_t MemorySize);
+ADI_GPIO_RESULT adi_gpio_OutputEnable(ADI_GPIO_PORT Port, uint16_t Pins,
+				      bool bFlag);
+ADI_GPIO_RESULT adi_gpio_InputEnable(ADI_GPIO_PORT Port, uint16_t Pins,
+				     bool bFlag);
+ADI_GPIO_RESULT adi_gpio_PullUpEnable(ADI_GPIO_PORT Port, uint16_t Pins,
+				      bool bFlag);
+ADI_GPIO_RESULT adi_gpio_SetHigh(ADI_GPIO_PORT Port, uint16_t Pins);
+ADI_GPIO_RESULT adi_gpio_SetLow(ADI_GPIO_PORT Port, uint16_t Pins);
+ADI_GPIO_RESULT adi_gpio_GetData(ADI_GPIO_PORT Port, uint16_t Pins,
+				 uint16_t *pValue);
+ADI_GPIO_RESULT adi_gpio_SetGroupInterruptPins(ADI_GPIO_PORT Port,
+					       ADI_GPIO_IRQ eIrq,
+					       uint16_t Pins);
+ADI_GPIO_RESULT adi_gpio_SetGroupInterruptPolarity(ADI_GPIO_PORT Port,
+						   uint16_t Pins);
+ADI_GPIO_RESULT adi_gpio_RegisterCallback(ADI_GPIO_IRQ eIrq,
+					  ADI_CALLBACK pfCallback,
+					  void *pCBParam);
+
+/* SPI */
+#define ADI_SPI_MEMORY_SIZE	16
+
+typedef void *ADI_SPI_HANDLE;
+
+typedef enum {
+	ADI_SPI_SUCCESS,
+	ADI_SPI_FAILURE,
+	ADI_SPI_HW_ERROR_OCCURRED
+} ADI_SPI_RESULT;
+
+typedef enum {
+	ADI_SPI_CS_NONE,
+	ADI_SPI_CS0,
+	ADI_SPI_CS1
+} ADI_SPI_CHIP_SELECT;
+
+typedef struct {
+	uint8_t *pTransmitter;
+	uint8_t *pReceiver;
+	uint16_t TransmitterBytes;
+	uint16_t ReceiverBytes;
+	uint8_t nTxIncrement;
+	uint8_t nRxIncrement;
+	bool bDMA;
+	bool bRD_CTL;
+} ADI_SPI_TRANSCEIVER;
+
+ADI_SPI_RESULT adi_spi_Open(uint32_t nDeviceNum, void *pDevMemory,
+			    uint32_t nMemorySize, ADI_SPI_HANDLE *phDevice);
+ADI_SPI_RESULT adi_spi_SetMasterMode(ADI_SPI_HANDLE hDevice, bool bFlag);
+ADI_SPI_RESULT adi_spi_SetBitrate(ADI_SPI_HANDLE hDevice, uint32_t Hertz);
+ADI_SPI_RESULT adi_spi_SetChipSelect(ADI_SPI_HANDLE hDevice,
+				     ADI_SPI_CHIP_SELECT eChipSelect);
+ADI_SPI_RESULT adi_spi_SetClockPolarity(ADI_SPI_HANDLE hDevice, bool bFlag);
+ADI_SPI_RESULT adi_spi_SetClockPhase(ADI_SPI_HANDLE hDevice, bool bFlag);
+ADI_SPI_RESULT adi_spi_SetContinuousMode(ADI_SPI_HANDLE hDevice, bool bFlag);
+ADI_SPI_RESULT adi_spi_MasterReadWrite(ADI_SPI_HANDLE hDevice,
+				       ADI_SPI_TRANSCEIVER *pXfr);
+
+/* Wi-Fi */
+typedef enum {
+	ADI_WIFI_SUCCESS,
+	ADI_WIFI_FAILURE
+} ADI_WIFI_RESULT;
+
+typedef struct {
+	uint8_t *pMQTTData;
+	uint32_t nMQTTDataSize;
+	uint8_t *pTopic;
+	uint8_t nLinkID;
+	uint8_t nQos;
+	uint8_t nPacketId;
+} ADI_WIFI_PUBLISH_CONFIG;
+
+ADI_WIFI_RESULT adi_wifi_radio_MQTTPublish(
+	ADI_WIFI_PUBLISH_CONFIG * const pPublishConfig);
+ADI_WIFI_RESULT adi_wifi_DispatchEvents(uint32_t nTime);
+
+#endif /* ADI_STUB_H_ */
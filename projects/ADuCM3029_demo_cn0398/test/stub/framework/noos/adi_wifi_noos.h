@@ -0,0 +1 @@
+#include <adi_stub.h>
@@ -0,0 +1,598 @@
+/* Host test of the CN0398 acquisition on a timing model of the AD7124
+ *
+ * The SPI and GPIO drivers are replaced by a model of the AD7124 register
+ * interface: single and continuous conversion modes, the channel sequencer,
+ * the status byte appended to the data and the DOUT/RDY pin, which follows
+ * the RDY bit while CS is low and raises the GPIO group interrupt on its
+ * falling edge. A settled sinc4 conversion takes 4 / ODR with the filter and
+ * power mode programmed, and SPI transfers take their time at 1 MHz.
+ *
+ * The pH and moisture probes read 0 V until their excitation has been on for
+ * the settling time, so a result taken too early shows in the values. The
+ * test reads the sensors one channel at a time and with the sequencer, checks
+ * both give the settled values and prints the time each takes. The ADC is
+ * then made to stop converting, set_data() must report the timeout and leave
+ * the previous values alone.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "adi_cn0398_cfg.h"
+#include "adi_cn0398.h"
+
+namespace adi_sensor_swpack
+{
+/* Values set_data() updates for display_data() */
+extern float temperature, pH, moisture;
+}
+
+using namespace adi_sensor_swpack;
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+#define NEVER			UINT64_MAX
+/* One turn of a polling loop on the 26 MHz core */
+#define LOOP_US			2
+#define SPI_HZ			1000000
+/* Driver time around each SPI transfer */
+#define SPI_OVERHEAD_US		5
+
+/* Probe inputs once settled */
+#define RTD_OHM			108.4
+#define PH_VOLT			0.05
+#define MOISTURE_VOLT		0.9
+/* Excitation time before the moisture probe reads right */
+#define MOISTURE_SETTLE_US	400000
+
+/* Simulated time in microseconds */
+static uint64_t now;
+/* Excitation time before the pH probe reads right, read_ph() waits for none */
+static uint64_t ph_settle_us = 1000;
+
+/* AD7124 model */
+static struct {
+	uint32_t reg[0x39];
+	/* RDY bit clear, a result is waiting */
+	bool rdy;
+	uint8_t data_ch;
+	uint32_t data;
+	/* Conversion in progress, mode 0 continuous, 1 single, else idle */
+	uint8_t mode;
+	uint8_t conv_ch;
+	uint64_t conv_start;
+	uint64_t conv_end;
+	/* Time the pH and moisture excitations were switched on */
+	uint64_t ph_on;
+	uint64_t moisture_on;
+	/* No conversion ever completes */
+	bool dead;
+	uint32_t conversions;
+	uint32_t transfers;
+	uint32_t status_polls;
+} adc;
+
+/* GPIO model */
+static uint16_t gpio_out[ADI_GPIO_NUM_PORTS];
+static uint16_t int_pins;
+static uint16_t int_polarity;
+static ADI_CALLBACK int_callback;
+static bool rdy_pin = true;
+static uint32_t interrupts;
+
+static char published[8][200];
+static uint32_t nb_published;
+
+static uint8_t reg_size(uint8_t addr)
+{
+	if (addr == 0x00 || addr == 0x05 || addr == 0x08)
+		return 1;
+	if (addr == 0x01 || addr == 0x04 || (addr >= 0x09 && addr <= 0x20))
+		return 2;
+
+	return 3;
+}
+
+static uint32_t code_of(double volt)
+{
+	return (uint32_t)((volt / 3.3 + 1) * (0xFFFFFF / 2) + 0.5);
+}
+
+/* Result of a conversion on ch started at start */
+static uint32_t adc_result(uint8_t ch, uint64_t start)
+{
+	switch (ch) {
+	case RTD_CHANNEL:
+		return (uint32_t)(RTD_OHM * 16 * (1 << 23) / 5000 + (1 << 23) +
+				  0.5);
+	case PH_CHANNEL:
+		if (adc.ph_on == NEVER || start < adc.ph_on + ph_settle_us)
+			return code_of(0);
+		return code_of(PH_VOLT);
+	case MOISTURE_CHANNEL:
+		if (adc.moisture_on == NEVER ||
+		    start < adc.moisture_on + MOISTURE_SETTLE_US)
+			return code_of(0);
+		return code_of(MOISTURE_VOLT);
+	default:
+		return 0;
+	}
+}
+
+/* Settled sinc4 conversion time of ch */
+static uint64_t conv_us(uint8_t ch)
+{
+	static const uint32_t mclk[4] = {76800, 153600, 614400, 614400};
+	uint8_t setup = (adc.reg[0x09 + ch] >> 12) & 0x7;
+	uint32_t fs = adc.reg[0x21 + setup] & 0x7FF;
+	uint32_t clk = mclk[(adc.reg[0x01] >> 6) & 0x3];
+
+	return (uint64_t)4 * 32 * (fs ? fs : 1) * 1000000 / clk;
+}
+
+static int adc_next_ch(int ch)
+{
+	int i;
+
+	for (i = ch + 1; i < 16; i++)
+		if (adc.reg[0x09 + i] & AD7124_CH_MAP_REG_CH_ENABLE)
+			return i;
+
+	return -1;
+}
+
+static void adc_start(uint8_t ch)
+{
+	adc.conv_ch = ch;
+	adc.conv_start = now;
+	adc.conv_end = adc.dead ? NEVER : now + conv_us(ch);
+}
+
+static void pin_update(void)
+{
+	bool level = !(adc.rdy && !(gpio_out[ADI_GPIO_PORT1] &
+				    ADI_GPIO_PIN_10));
+
+	if (rdy_pin && !level && (int_pins & ADI_GPIO_PIN_2) &&
+	    !(int_polarity & ADI_GPIO_PIN_2) && int_callback) {
+		interrupts++;
+		rdy_pin = level;
+		int_callback(NULL, ADI_GPIO_PORT0, NULL);
+	}
+	rdy_pin = level;
+}
+
+static void adc_complete(void)
+{
+	int next;
+
+	adc.conversions++;
+	adc.data = adc_result(adc.conv_ch, adc.conv_start);
+	adc.data_ch = adc.conv_ch;
+	/* DOUT/RDY pulses high before a result that was not read */
+	adc.rdy = false;
+	pin_update();
+	adc.rdy = true;
+	adc.conv_end = NEVER;
+	if (adc.mode == 0) {
+		next = adc_next_ch(adc.conv_ch);
+		if (next < 0)
+			next = adc_next_ch(-1);
+		adc_start(next);
+	} else {
+		adc.mode = 3;
+	}
+	pin_update();
+}
+
+static void advance(uint64_t us)
+{
+	uint64_t end = now + us;
+
+	while (adc.conv_end <= end) {
+		now = adc.conv_end;
+		adc_complete();
+	}
+	now = end;
+}
+
+static void excitation_update(void)
+{
+	bool ph = adc.reg[0x03] &
+		  (AD7124_8_IO_CTRL1_REG_GPIO_DAT1 << CN0398::P2);
+	bool moisture = (adc.reg[0x03] &
+			 (AD7124_8_IO_CTRL1_REG_GPIO_DAT1 << CN0398::P3)) &&
+			(gpio_out[ADI_GPIO_PORT0] & ADP7118_PIN);
+
+	if (!ph)
+		adc.ph_on = NEVER;
+	else if (adc.ph_on == NEVER)
+		adc.ph_on = now;
+	if (!moisture)
+		adc.moisture_on = NEVER;
+	else if (adc.moisture_on == NEVER)
+		adc.moisture_on = now;
+}
+
+static void adc_write(uint8_t addr, uint32_t value)
+{
+	int ch;
+
+	adc.reg[addr] = value;
+	if (addr == 0x03)
+		excitation_update();
+	if (addr != 0x01)
+		return;
+
+	/* A mode write restarts the conversions */
+	adc.rdy = false;
+	adc.conv_end = NEVER;
+	adc.mode = (value >> 2) & 0xF;
+	ch = adc_next_ch(-1);
+	if (adc.mode <= 1 && ch >= 0)
+		adc_start(ch);
+}
+
+static void adc_reset(void)
+{
+	memset(adc.reg, 0, sizeof(adc.reg));
+	adc.reg[0x05] = AD7124_ID_VALUE;
+	adc.reg[0x09] = 0x8001;
+	for (int i = 0x0A; i <= 0x18; i++)
+		adc.reg[i] = 0x0001;
+	for (int i = 0x19; i <= 0x20; i++)
+		adc.reg[i] = 0x0860;
+	for (int i = 0x21; i <= 0x28; i++)
+		adc.reg[i] = 0x060180;
+	adc.rdy = false;
+	adc.mode = 3;
+	adc.conv_end = NEVER;
+	excitation_update();
+}
+
+ADI_SPI_RESULT adi_spi_MasterReadWrite(ADI_SPI_HANDLE hDevice,
+				       ADI_SPI_TRANSCEIVER *pXfr)
+{
+	uint8_t *tx = pXfr->pTransmitter, *rx = pXfr->pReceiver;
+	uint16_t n = pXfr->TransmitterBytes, i;
+	uint8_t addr = tx[0] & 0x3F, size = reg_size(addr);
+	uint32_t value = 0;
+
+	adc.transfers++;
+	for (i = 0; i < n && tx[i] == 0xFF; i++)
+		;
+	if (i == n && n >= 8) {
+		adc_reset();
+	} else if (tx[0] & 0x40) {
+		/* Read, the data register may be followed by the status */
+		uint8_t status = (adc.rdy ? 0 : AD7124_STATUS_REG_RDY) |
+				 adc.data_ch;
+
+		if (addr == 0x00)
+			adc.status_polls++;
+		value = addr == 0x02 ? adc.data :
+			addr == 0x00 ? status : adc.reg[addr];
+		rx[0] = 0xFF;
+		for (i = 1; i < n; i++) {
+			if (i <= size)
+				rx[i] = value >> (8 * (size - i));
+			else
+				rx[i] = status;
+		}
+		if (addr == 0x02)
+			adc.rdy = false;
+	} else {
+		for (i = 1; i <= size && i < n; i++)
+			value = (value << 8) | tx[i];
+		adc_write(addr, value);
+	}
+	pin_update();
+	advance(n * 8 * 1000000 / SPI_HZ + SPI_OVERHEAD_US);
+
+	return ADI_SPI_SUCCESS;
+}
+
+ADI_SPI_RESULT adi_spi_Open(uint32_t nDeviceNum, void *pDevMemory,
+			    uint32_t nMemorySize, ADI_SPI_HANDLE *phDevice)
+{
+	*phDevice = pDevMemory;
+
+	return ADI_SPI_SUCCESS;
+}
+
+ADI_SPI_RESULT adi_spi_SetMasterMode(ADI_SPI_HANDLE hDevice, bool bFlag)
+{
+	return ADI_SPI_SUCCESS;
+}
+
+ADI_SPI_RESULT adi_spi_SetBitrate(ADI_SPI_HANDLE hDevice, uint32_t Hertz)
+{
+	CHECK(Hertz == SPI_HZ);
+
+	return ADI_SPI_SUCCESS;
+}
+
+ADI_SPI_RESULT adi_spi_SetChipSelect(ADI_SPI_HANDLE hDevice,
+				     ADI_SPI_CHIP_SELECT eChipSelect)
+{
+	return ADI_SPI_SUCCESS;
+}
+
+ADI_SPI_RESULT adi_spi_SetClockPolarity(ADI_SPI_HANDLE hDevice, bool bFlag)
+{
+	return ADI_SPI_SUCCESS;
+}
+
+ADI_SPI_RESULT adi_spi_SetClockPhase(ADI_SPI_HANDLE hDevice, bool bFlag)
+{
+	return ADI_SPI_SUCCESS;
+}
+
+ADI_SPI_RESULT adi_spi_SetContinuousMode(ADI_SPI_HANDLE hDevice, bool bFlag)
+{
+	return ADI_SPI_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_Init(void *pMemory, uint32_t MemorySize)
+{
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_OutputEnable(ADI_GPIO_PORT Port, uint16_t Pins,
+				      bool bFlag)
+{
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_InputEnable(ADI_GPIO_PORT Port, uint16_t Pins,
+				     bool bFlag)
+{
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_PullUpEnable(ADI_GPIO_PORT Port, uint16_t Pins,
+				      bool bFlag)
+{
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_SetHigh(ADI_GPIO_PORT Port, uint16_t Pins)
+{
+	gpio_out[Port] |= Pins;
+	excitation_update();
+	pin_update();
+
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_SetLow(ADI_GPIO_PORT Port, uint16_t Pins)
+{
+	gpio_out[Port] &= ~Pins;
+	excitation_update();
+	pin_update();
+
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_GetData(ADI_GPIO_PORT Port, uint16_t Pins,
+				 uint16_t *pValue)
+{
+	CHECK(Port == AD7124_RDY_PORT && Pins == AD7124_RDY_PIN);
+	*pValue = rdy_pin ? Pins : 0;
+
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_SetGroupInterruptPins(ADI_GPIO_PORT Port,
+					       ADI_GPIO_IRQ eIrq,
+					       uint16_t Pins)
+{
+	CHECK(Port == AD7124_RDY_PORT && eIrq == ADI_GPIO_INTB_IRQ);
+	int_pins = Pins;
+
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_SetGroupInterruptPolarity(ADI_GPIO_PORT Port,
+						   uint16_t Pins)
+{
+	int_polarity = Pins;
+
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_GPIO_RESULT adi_gpio_RegisterCallback(ADI_GPIO_IRQ eIrq,
+					  ADI_CALLBACK pfCallback,
+					  void *pCBParam)
+{
+	int_callback = pfCallback;
+
+	return ADI_GPIO_SUCCESS;
+}
+
+ADI_WIFI_RESULT adi_wifi_radio_MQTTPublish(
+	ADI_WIFI_PUBLISH_CONFIG * const pPublishConfig)
+{
+	if (nb_published < 8)
+		snprintf(published[nb_published++], sizeof(published[0]),
+			 "%.*s", (int)pPublishConfig->nMQTTDataSize,
+			 (char *)pPublishConfig->pMQTTData);
+
+	return ADI_WIFI_SUCCESS;
+}
+
+ADI_WIFI_RESULT adi_wifi_DispatchEvents(uint32_t nTime)
+{
+	return ADI_WIFI_SUCCESS;
+}
+
+uint8_t *payload_ptr;
+
+extern "C" {
+
+	char Value;
+	bool charReceived;
+
+	void timer_sleep(uint32_t ticks)
+	{
+		advance((uint64_t)ticks * 1000);
+	}
+
+	/* ui32timer_counter, the SysTick millisecond count */
+	volatile uint32_t sim_ms(void)
+	{
+		advance(LOOP_US);
+
+		return now / 1000;
+	}
+}
+
+struct reading {
+	float temperature;
+	float ph;
+	float moisture;
+	double ms;
+	uint32_t transfers;
+	uint32_t status_polls;
+	uint32_t conversions;
+};
+
+static void count_start(struct reading *r)
+{
+	r->ms = now / 1000.0;
+	r->transfers = adc.transfers;
+	r->status_polls = adc.status_polls;
+	r->conversions = adc.conversions;
+}
+
+static void count_end(struct reading *r)
+{
+	r->ms = now / 1000.0 - r->ms;
+	r->transfers = adc.transfers - r->transfers;
+	r->status_polls = adc.status_polls - r->status_polls;
+	r->conversions = adc.conversions - r->conversions;
+}
+
+/* The sequencer left the ADC idle and the excitations off */
+static void check_stopped(void)
+{
+	CHECK(adc.mode > 1 && adc.conv_end == NEVER);
+	CHECK(!(adc.reg[0x09] & AD7124_CH_MAP_REG_CH_ENABLE));
+	CHECK(!(adc.reg[0x0A] & AD7124_CH_MAP_REG_CH_ENABLE));
+	CHECK(!(adc.reg[0x0B] & AD7124_CH_MAP_REG_CH_ENABLE));
+	CHECK(adc.ph_on == NEVER && adc.moisture_on == NEVER);
+	CHECK(gpio_out[ADI_GPIO_PORT1] & ADI_GPIO_PIN_10);
+	CHECK(!(int_pins & ADI_GPIO_PIN_2));
+	CHECK(convFlag == 0);
+}
+
+static void test_read(CN0398 &cn)
+{
+	struct reading single, seq;
+	double r, t;
+
+	/* One channel at a time */
+	count_start(&single);
+	single.temperature = cn.read_rtd();
+	single.ph = cn.read_ph(single.temperature);
+	single.moisture = cn.read_moisture();
+	count_end(&single);
+
+	/* Callendar-Van Dusen above 0 C */
+	for (t = 0, r = 0; fabs(r - RTD_OHM) > 1e-9; ) {
+		r = 100 * (1 + 3.9083e-3 * t - 5.775e-7 * t * t);
+		t -= (r - RTD_OHM) / (100 * (3.9083e-3 - 2 * 5.775e-7 * t));
+	}
+	CHECK(fabs(single.temperature - t) < 0.01);
+	CHECK(single.ph == cn.voltage_to_ph(cn.data_to_voltage_bipolar(
+			   code_of(PH_VOLT), 1, 3.3), single.temperature));
+	CHECK(single.moisture == cn.voltage_to_moisture(
+			   cn.data_to_voltage_bipolar(code_of(MOISTURE_VOLT),
+						      1, 3.3)));
+	CHECK(single.moisture > 0 && single.moisture < 100);
+
+	/* All channels in one sequence */
+	temperature = pH = moisture = 0;
+	nb_published = 0;
+	interrupts = 0;
+	count_start(&seq);
+	CHECK(cn.set_data() == SENSOR_ERROR_NONE);
+	count_end(&seq);
+	CHECK(nb_published == 0);
+	CHECK(temperature == single.temperature);
+	CHECK(pH == single.ph);
+	CHECK(moisture == single.moisture);
+	check_stopped();
+
+	/* Results come on DOUT/RDY, the status register is not polled */
+	CHECK(seq.status_polls == 0);
+	CHECK(interrupts >= seq.conversions - 1);
+	/* The moisture probe settling sets the pace */
+	CHECK(seq.ms < 400 + 2 * conv_us(MOISTURE_CHANNEL) / 1000.0 + 20);
+	CHECK(seq.ms < single.ms * 0.75);
+
+	/* A slower pH probe is still read once settled, the sequencer waits
+	 * PH_SETTLING_TIME for it */
+	ph_settle_us = cn.PH_SETTLING_TIME * 1000;
+	pH = 0;
+	CHECK(cn.set_data() == SENSOR_ERROR_NONE);
+	CHECK(pH == single.ph);
+	ph_settle_us = 1000;
+
+	printf("one by one: %.1f ms, %u conversions, %u SPI transfers, "
+	       "%u status polls\n", single.ms, single.conversions,
+	       single.transfers, single.status_polls);
+	printf("sequencer:  %.1f ms, %u conversions, %u SPI transfers, "
+	       "%u status polls\n", seq.ms, seq.conversions, seq.transfers,
+	       seq.status_polls);
+}
+
+static void test_timeout(CN0398 &cn)
+{
+	double start;
+
+	temperature = 12.5f;
+	pH = 6.5f;
+	moisture = 42.0f;
+	nb_published = 0;
+	adc.dead = true;
+	start = now / 1000.0;
+	CHECK(cn.set_data() == SENSOR_ERROR_ADC);
+	CHECK(now / 1000.0 - start >= SEQUENCE_TIMEOUT);
+	CHECK(now / 1000.0 - start < SEQUENCE_TIMEOUT + 50);
+	adc.dead = false;
+
+	/* The timeout is reported and the values are left alone */
+	CHECK(nb_published == 1 && strstr(published[0], "TIMEOUT"));
+	CHECK(temperature == 12.5f && pH == 6.5f && moisture == 42.0f);
+	check_stopped();
+
+	/* The next update works again */
+	CHECK(cn.set_data() == SENSOR_ERROR_NONE);
+	CHECK(moisture != 42.0f);
+	check_stopped();
+}
+
+int main(void)
+{
+	CN0398 cn;
+
+	adc_reset();
+	gpio_out[ADI_GPIO_PORT1] = ADI_GPIO_PIN_10;
+	CHECK(cn.open() == SENSOR_ERROR_NONE);
+	CHECK(adc.mode > 1);
+
+	test_read(cn);
+	test_timeout(cn);
+
+	printf(failures ? "FAILED\n" : "OK\n");
+
+	return failures ? 1 : 0;
+}
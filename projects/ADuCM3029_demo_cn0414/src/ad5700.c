@@ -184,5 +184,12 @@ int32_t ad5700_transmit(struct ad5700_dev *dev, uint8_t *data, uint32_t size)
 
 	mdelay(6);
 
-	return gpio_set_value(dev->gpio_nrts, GPIO_HIGH);
+	ret = gpio_set_value(dev->gpio_nrts, GPIO_HIGH);
+	if(ret != AD5700_SUCCESS)
+		return ret;
+
+	/* Drop anything the software UART picked up during the transmission */
+	swuart_rx_flush(dev->swuart_desc);
+
+	return AD5700_SUCCESS;
 }
@@ -222,6 +222,18 @@ static uint8_t *cmd_commands[] = {
 	(uint8_t *)"hpt",
 	(uint8_t *)"test_routine",
 	(uint8_t *)"tr",
+	(uint8_t *)"hart_read_pv",
+	(uint8_t *)"hrpv",
+	(uint8_t *)"hart_read_current",
+	(uint8_t *)"hrc",
+	(uint8_t *)"hart_read_vars",
+	(uint8_t *)"hrv",
+	(uint8_t *)"hart_read_status",
+	(uint8_t *)"hrs",
+	(uint8_t *)"hart_set_address ",
+	(uint8_t *)"hsa ",
+	(uint8_t *)"hart_burst",
+	(uint8_t *)"hb",
 	(uint8_t *)""
 };
 
@@ -251,19 +263,39 @@ static cmd_func v_cmd_fun[] = {
 	cn0414_adc_open_wire_disable,
 	cn0414_hart_phy_test,
 	cn0414_system_test_routine,
+	cn0414_hart_read_pv,
+	cn0414_hart_read_current,
+	cn0414_hart_read_vars,
+	cn0414_hart_read_status,
+	cn0414_hart_set_address,
+	cn0414_hart_burst,
 	NULL
 };
 
 /* CLI command sizes */
 static uint8_t command_size[] = {
 	5, 2, 5, 2, 12, 3, 13, 3, 20, 4, 14, 3, 13, 3, 13, 4, 14, 4, 16, 4, 12, 4,
-	13, 4, 16, 4, 7, 5, 17, 4, 16, 4, 17, 4, 19, 5, 15, 3, 18, 4, 21, 5, 22, 5,
-	14, 4, 13, 3, 1
+	13, 4, 16, 4, 7, 5, 17, 4, 16, 4, 17, 4, 19, 5, 16, 3, 18, 4, 21, 5, 22, 5,
+	14, 4, 13, 3, 13, 5, 18, 4, 15, 4, 17, 4, 17, 4, 11, 3, 1
 };
 
+/* Command lookup table, built on the first search */
+static uint8_t cmd_hash[CMD_HASH_SIZE];
+static bool cmd_hash_valid = false;
+
 /* HART Command zero */
 static uint8_t hart_command_zero[] = {0x02, 0x80, 0x00, 0x00, 0x82};
 
+/* HART link layer access to the AD5700 */
+static const struct hart_phy_ops hart_phy_ops = {
+	.transmit = cn0414_hart_phy_transmit,
+	.get_char = cn0414_hart_phy_get_char,
+	.get_ms = timer_get_ms
+};
+
+/* Names of the dynamic variables */
+static const char *hart_var_names[] = {"PV", "SV", "TV", "QV"};
+
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
@@ -371,6 +403,7 @@ int32_t cn0414_setup(struct cn0414_dev **device,
 {
 	int32_t ret;
 	struct cn0414_dev *dev;
+	struct hart_init_param hart_init_param;
 	uint32_t i;
 
 	dev = calloc(1, sizeof *dev );
@@ -386,6 +419,7 @@ int32_t cn0414_setup(struct cn0414_dev **device,
 		dev->hart_buffer[i] = 0xaa;
 	dev->hart_buffer[0] = 0;
 	dev->hart_rec_size = 0;
+	dev->hart_rec_active = 0;
 	dev->open_wire_detect_enable = OPEN_WIRE_DETECT_DISABLED;
 	dev->open_wire_first_done = 0;
 
@@ -400,6 +434,14 @@ int32_t cn0414_setup(struct cn0414_dev **device,
 		goto error;
 	NVIC_DisableIRQ(HART_CD_INT);
 
+	hart_init_param.ops = &hart_phy_ops;
+	hart_init_param.phy = dev;
+	hart_init_param.preamble_size = HART_DEFAULT_PREAMBLE;
+	hart_init_param.retries = HART_DEFAULT_RETRIES;
+	ret = hart_init(&dev->hart_device, &hart_init_param);
+	if(ret != CN0414_SUCCESS)
+		goto error;
+
 	ret = AD717X_Init(&dev->ad4111_device, init_param->ad4111_ini);
 	if(ret != CN0414_SUCCESS)
 		goto error;
@@ -456,6 +498,9 @@ int32_t cn0414_remove(struct cn0414_dev *dev)
 	if(ret != CN0414_SUCCESS)
 		return ret;
 	ret = ad5700_remove(dev->ad5700_device);
+	if(ret != CN0414_SUCCESS)
+		return ret;
+	ret = hart_remove(dev->hart_device);
 	if(ret != CN0414_SUCCESS)
 		return ret;
 	ret = AD717X_remove(dev->ad4111_device);
@@ -725,6 +770,35 @@ static int32_t cn0414_help_hart_commands(struct cn0414_dev *dev,
 		if(ret != CN0414_SUCCESS)
 			return ret;
 
+		ret = usr_uart_write_string(dev->uart_descriptor,
+					    (uint8_t*)" hart_read_pv               - Read the primary variable (command 1).\n");
+		if(ret != CN0414_SUCCESS)
+			return ret;
+		ret = usr_uart_write_string(dev->uart_descriptor,
+					    (uint8_t*)" hart_read_current          - Read the loop current and percent of range (command 2).\n");
+		if(ret != CN0414_SUCCESS)
+			return ret;
+		ret = usr_uart_write_string(dev->uart_descriptor,
+					    (uint8_t*)" hart_read_vars             - Read the dynamic variables and loop current (command 3).\n");
+		if(ret != CN0414_SUCCESS)
+			return ret;
+		ret = usr_uart_write_string(dev->uart_descriptor,
+					    (uint8_t*)" hart_read_status           - Read the additional device status (command 48).\n");
+		if(ret != CN0414_SUCCESS)
+			return ret;
+		ret = usr_uart_write_string(dev->uart_descriptor,
+					    (uint8_t*)" hart_set_address <addr>    - Address the device with short frames.\n");
+		if(ret != CN0414_SUCCESS)
+			return ret;
+		ret = usr_uart_write_string(dev->uart_descriptor,
+					    (uint8_t*)"                              <addr> = polling address, 0 to 63.\n");
+		if(ret != CN0414_SUCCESS)
+			return ret;
+		ret = usr_uart_write_string(dev->uart_descriptor,
+					    (uint8_t*)" hart_burst                 - Display the last burst frame received.\n");
+		if(ret != CN0414_SUCCESS)
+			return ret;
+
 		return usr_uart_write_string(dev->uart_descriptor,
 					     (uint8_t*)
 					     " hart_phy_test              - Enter HART physical test mode. Press '1' and '0' to cycle frequencies and 'q' to quit mode.\n");
@@ -774,6 +848,35 @@ static int32_t cn0414_help_hart_commands(struct cn0414_dev *dev,
 		if(ret != CN0414_SUCCESS)
 			return ret;
 
+		ret = usr_uart_write_string(dev->uart_descriptor,
+					    (uint8_t*)" hrpv            - Read the primary variable (command 1).\n");
+		if(ret != CN0414_SUCCESS)
+			return ret;
+		ret = usr_uart_write_string(dev->uart_descriptor,
+					    (uint8_t*)" hrc             - Read the loop current and percent of range (command 2).\n");
+		if(ret != CN0414_SUCCESS)
+			return ret;
+		ret = usr_uart_write_string(dev->uart_descriptor,
+					    (uint8_t*)" hrv             - Read the dynamic variables and loop current (command 3).\n");
+		if(ret != CN0414_SUCCESS)
+			return ret;
+		ret = usr_uart_write_string(dev->uart_descriptor,
+					    (uint8_t*)" hrs             - Read the additional device status (command 48).\n");
+		if(ret != CN0414_SUCCESS)
+			return ret;
+		ret = usr_uart_write_string(dev->uart_descriptor,
+					    (uint8_t*)" hsa <addr>      - Address the device with short frames.\n");
+		if(ret != CN0414_SUCCESS)
+			return ret;
+		ret = usr_uart_write_string(dev->uart_descriptor,
+					    (uint8_t*)"                   <addr> = polling address, 0 to 63.\n");
+		if(ret != CN0414_SUCCESS)
+			return ret;
+		ret = usr_uart_write_string(dev->uart_descriptor,
+					    (uint8_t*)" hb              - Display the last burst frame received.\n");
+		if(ret != CN0414_SUCCESS)
+			return ret;
+
 		return usr_uart_write_string(dev->uart_descriptor,
 					     (uint8_t*)
 					     " hpt             - Enter HART physical test mode. Press '1' and '0' to cycle frequencies and 'q' to quit mode.\n");
@@ -1740,8 +1843,7 @@ int32_t cn0414_hart_transmit(struct cn0414_dev *dev, uint8_t* arg)
 
 	size = strlen((char *)arg);
 
-	/* Disable interrupts to avoid hanging */
-	NVIC_DisableIRQ(TMR0_INT);
+	/* Ignore CD during the transmission */
 	NVIC_DisableIRQ(HART_CD_INT);
 
 	ret = ad5700_transmit(dev->ad5700_device, arg, size);
@@ -1749,8 +1851,6 @@ int32_t cn0414_hart_transmit(struct cn0414_dev *dev, uint8_t* arg)
 		usr_uart_write_string(dev->uart_descriptor,
 				      (uint8_t*)"Transmission failed!\n");
 
-	/* Enable interrupts */
-	NVIC_EnableIRQ(TMR0_INT);
 	NVIC_EnableIRQ(HART_CD_INT);
 
 	return cn0414_hart_enable_modulator(dev, false);
@@ -1804,38 +1904,52 @@ finish:
 /**
  * Process function helper. Receive HART transmission on CD interrupt.
  *
+ * The software UART receives in the background, so this only moves the
+ * characters waiting in its FIFO to the HART buffer and returns. The
+ * transmission ends when CD is deasserted and no character is left in the
+ * software UART.
+ *
  * @param [in] dev - The device structure.
  *
- * @return 0 in case of success, negative error code otherwise.
+ * @return 0 when the transmission is complete, HART_RECEIVE_PENDING while it is
+ *         still in progress, negative error code otherwise.
  */
 static int32_t cn0414_process_hart_int_rec(struct cn0414_dev *dev)
 {
-	uint8_t i = 1;
 	int32_t ret;
 	uint16_t cd_val;
+	bool done;
+	struct swuart_dev *swuart = dev->ad5700_device->swuart_desc;
 
-	/* Disable interrupts to avoid hanging */
-	NVIC_DisableIRQ(TMR0_INT);
-	NVIC_DisableIRQ(HART_CD_INT);
+	if(!dev->hart_rec_active) {
+		dev->hart_rec_size = 1;
+		dev->hart_rec_active = 1;
+	}
 
-	do {
-		ret = swuart_read_char(dev->ad5700_device->swuart_desc,
-				       &dev->hart_buffer[i]);
-		gpio_get_value(dev->ad5700_device->gpio_cd, &cd_val);
+	ret = gpio_get_value(dev->ad5700_device->gpio_cd, &cd_val);
+	if(ret != CN0414_SUCCESS)
+		return ret;
+	done = (cd_val == 0) && !swuart_rx_busy(swuart);
+
+	/* Characters with parity or framing errors are dropped */
+	while(dev->hart_rec_size < HART_BUFF_SIZE) {
+		ret = swuart_get_char(swuart, &dev->hart_buffer[dev->hart_rec_size]);
+		if(ret == SWUART_NO_DATA)
+			break;
 		if(ret == 0)
-			i++;
-	} while((i < 256) && (cd_val != 0));
-	dev->hart_rec_size = i;
+			dev->hart_rec_size++;
+	}
+
+	if(!done && (dev->hart_rec_size < HART_BUFF_SIZE))
+		return HART_RECEIVE_PENDING;
+
+	dev->hart_rec_active = 0;
 	ret = usr_uart_write_string(dev->uart_descriptor,
 				    (uint8_t*)"\nReceived HART transmission.\n");
 	dev->hart_buffer[0] = 1;
 
 	modem_rec_flag = false;
 
-	/* Enable interrupts */
-	NVIC_EnableIRQ(TMR0_INT);
-	NVIC_EnableIRQ(HART_CD_INT);
-
 	return ret;
 }
 
@@ -1863,7 +1977,9 @@ static int32_t cn0414_hart_receive_and_parse(struct cn0414_dev *dev,
 	if(timeout == 0)
 		return 0;
 
-	ret = cn0414_process_hart_int_rec(dev);
+	do {
+		ret = cn0414_process_hart_int_rec(dev);
+	} while(ret == HART_RECEIVE_PENDING);
 	if(ret != CN0414_SUCCESS)
 		return ret;
 
@@ -1882,72 +1998,173 @@ static int32_t cn0414_hart_receive_and_parse(struct cn0414_dev *dev,
 }
 
 /**
- * Receive and parse the response of a command zero.
+ * Transmit a frame for the HART link layer. Enable the modulator, transmit the
+ * frame through the AD5700 and disable the modulator to listen for the
+ * response.
+ *
+ * @param [in] phy  - The application descriptor.
+ * @param [in] data - The frame.
+ * @param [in] size - Size of the frame.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t cn0414_hart_phy_transmit(void *phy, uint8_t *data, uint32_t size)
+{
+	struct cn0414_dev *dev = phy;
+	int32_t ret;
+
+	ret = cn0414_hart_enable_modulator(dev, true);
+	if(ret != CN0414_SUCCESS)
+		return ret;
+
+	/* Ignore CD during the transmission */
+	NVIC_DisableIRQ(HART_CD_INT);
+
+	ret = ad5700_transmit(dev->ad5700_device, data, size);
+
+	NVIC_EnableIRQ(HART_CD_INT);
+
+	if(ret != CN0414_SUCCESS)
+		return ret;
+
+	return cn0414_hart_enable_modulator(dev, false);
+}
+
+/**
+ * Get a character received on the HART link.
+ *
+ * @param [in] phy   - The application descriptor.
+ * @param [out] byte - The received character.
+ *
+ * @return 0 in case of success, HART_PHY_NO_DATA if nothing was received,
+ *         negative error code if the character has errors.
+ */
+int32_t cn0414_hart_phy_get_char(void *phy, uint8_t *byte)
+{
+	struct cn0414_dev *dev = phy;
+	int32_t ret;
+
+	ret = swuart_get_char(dev->ad5700_device->swuart_desc, byte);
+	if(ret == SWUART_NO_DATA)
+		return HART_PHY_NO_DATA;
+
+	return ret;
+}
+
+/**
+ * HART command helper. The response of a link layer transaction was already
+ * consumed, so make sure the CD interrupt of the transaction does not start
+ * a new reception in the process function.
  *
  * @param [in] dev - The device structure.
  *
+ * @return none
+ */
+static void cn0414_hart_transaction_done(struct cn0414_dev *dev)
+{
+	modem_rec_flag = false;
+	dev->hart_rec_active = 0;
+}
+
+/**
+ * HART command helper. Display the result of a failed link layer transaction.
+ *
+ * @param [in] dev   - The device structure.
+ * @param [in] error - The error returned by the link layer.
+ *
  * @return 0 in case of success, negative error code otherwise.
  */
-static int32_t cn0414_hart_display_cmd_zero_response(struct cn0414_dev *dev,
-		uint8_t *response)
+static int32_t cn0414_hart_display_error(struct cn0414_dev *dev, int32_t error)
 {
-	uint8_t buff[20], id_lsb = 0;
-	uint32_t long_address = 0;
+	uint8_t buff[64];
 
-	if(dev->hart_buffer[0] != 1)
+	switch(error) {
+	case HART_ERR_TIMEOUT:
 		return usr_uart_write_string(dev->uart_descriptor,
 					     (uint8_t*)"No response.\n");
+	case HART_ERR_CHECKSUM:
+		return usr_uart_write_string(dev->uart_descriptor,
+					     (uint8_t*)"Response checksum error.\n");
+	case HART_ERR_FRAME:
+		return usr_uart_write_string(dev->uart_descriptor,
+					     (uint8_t*)"Response corrupted or truncated.\n");
+	case HART_ERR_SIZE:
+		return usr_uart_write_string(dev->uart_descriptor,
+					     (uint8_t*)"Response too short.\n");
+	case HART_ERR_COMM:
+	case HART_ERR_RESPONSE:
+		sprintf((char *)buff, "Device response: %s.\n",
+			hart_response_str(&dev->hart_device->response));
+		return usr_uart_write_string(dev->uart_descriptor, buff);
+	default:
+		return usr_uart_write_string(dev->uart_descriptor,
+					     (uint8_t*)"Transmission failed!\n");
+	}
+}
 
-	usr_uart_write_string(dev->uart_descriptor,
-			      (uint8_t*)"\nProtocol version: ");
-	itoa(response[4], (char *)buff, 10);
-	usr_uart_write_string(dev->uart_descriptor, buff);
-	usr_uart_write_string(dev->uart_descriptor, (uint8_t*)"\n");
+/**
+ * HART command helper. Display the status bytes of the last response if they
+ * are not all clear.
+ *
+ * @param [in] dev - The device structure.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t cn0414_hart_display_status(struct cn0414_dev *dev)
+{
+	struct hart_frame *response = &dev->hart_device->response;
+	uint8_t buff[64];
 
-	usr_uart_write_string(dev->uart_descriptor,
-			      (uint8_t*)"Preamble size: ");
-	itoa(response[3], (char *)buff, 10);
+	if((response->data[0] == HART_RC_SUCCESS) && (response->data[1] == 0))
+		return 0;
+
+	sprintf((char *)buff, "Device response: %s, device status: 0x%02x\n",
+		hart_response_str(response), response->data[1]);
+
+	return usr_uart_write_string(dev->uart_descriptor, buff);
+}
+
+/**
+ * Display the response of a command zero.
+ *
+ * @param [in] dev - The device structure.
+ * @param [in] id  - The decoded response.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t cn0414_hart_display_cmd_zero_response(struct cn0414_dev *dev,
+		struct hart_unique_id *id)
+{
+	uint8_t buff[64];
+
+	sprintf((char *)buff, "\nProtocol version: %d\n", id->universal_rev);
 	usr_uart_write_string(dev->uart_descriptor, buff);
-	usr_uart_write_string(dev->uart_descriptor, (uint8_t*)"\n");
 
-	usr_uart_write_string(dev->uart_descriptor,
-			      (uint8_t*)"Manufacturer ID code: 0x");
-	itoa(response[1], (char *)buff, 16);
-	if(strlen((char *)buff) < 2)
-		usr_uart_write_string(dev->uart_descriptor, (uint8_t*)"0");
+	sprintf((char *)buff, "Preamble size: %d\n", id->preambles);
 	usr_uart_write_string(dev->uart_descriptor, buff);
-	usr_uart_write_string(dev->uart_descriptor, (uint8_t*)"\n");
-	id_lsb = response[1] & 0x3F;
 
-	usr_uart_write_string(dev->uart_descriptor,
-			      (uint8_t*)"Manufacturer device type: ");
-	itoa(response[2], (char *)buff, 10);
+	sprintf((char *)buff, "Manufacturer ID code: 0x%02x\n",
+		id->manufacturer_id);
 	usr_uart_write_string(dev->uart_descriptor, buff);
-	usr_uart_write_string(dev->uart_descriptor, (uint8_t*)"\n");
 
-	long_address = id_lsb;
-	usr_uart_write_string(dev->uart_descriptor,
-			      (uint8_t*)"Long address: 0x");
-	itoa(long_address, (char *)buff, 16);
-	if(strlen((char *)buff) < 2)
-		usr_uart_write_string(dev->uart_descriptor, (uint8_t*)"0");
+	sprintf((char *)buff, "Manufacturer device type: %d\n", id->device_type);
 	usr_uart_write_string(dev->uart_descriptor, buff);
-	long_address = 0;
-	long_address |= (response[1] << (3 * 8));
-	long_address |= (response[9] << (2 * 8));
-	long_address |= (response[10] << (1 * 8));
-	long_address |= (response[11] << (0 * 8));
-	itoa(long_address, (char *)buff, 16);
-	if(strlen((char *)buff) < 8)
-		usr_uart_write_string(dev->uart_descriptor, (uint8_t*)"0");
+
+	sprintf((char *)buff, "Device ID: 0x%06lx\n",
+		(unsigned long)id->device_id);
 	usr_uart_write_string(dev->uart_descriptor, buff);
-	usr_uart_write_string(dev->uart_descriptor, (uint8_t*)"\n");
 
-	return 0;
+	sprintf((char *)buff, "Long address: 0x%02x%02x%02x%02x%02x\n",
+		id->long_address[0], id->long_address[1], id->long_address[2],
+		id->long_address[3], id->long_address[4]);
+
+	return usr_uart_write_string(dev->uart_descriptor, buff);
 }
 
 /**
- * Send HART command zero.
+ * Send HART command zero. The device at the selected polling address is
+ * addressed with a short frame and the following commands use its long
+ * address.
  *
  * @param [in] dev - The device structure.
  * @param [in] arg - Size of the preamble.
@@ -1956,8 +2173,8 @@ static int32_t cn0414_hart_display_cmd_zero_response(struct cn0414_dev *dev,
  */
 int32_t cn0414_hart_send_command_zero(struct cn0414_dev *dev, uint8_t* arg)
 {
-	uint8_t preamb_size, *telegram, i, size;
-	uint16_t rec_size;
+	struct hart_unique_id id;
+	uint8_t preamb_size;
 	int32_t ret;
 
 	preamb_size = atoi((char *)arg);
@@ -1967,52 +2184,208 @@ int32_t cn0414_hart_send_command_zero(struct cn0414_dev *dev, uint8_t* arg)
 					     (uint8_t*)"Preambule must be within 3 and 20 bytes.\n");
 	}
 
-	size = preamb_size + HART_COMMAND_ZERO_SIZE;
+	dev->hart_device->preamble_size = preamb_size;
+	hart_set_poll_address(dev->hart_device, dev->hart_device->poll_address);
 
-	ret = cn0414_hart_enable_modulator(dev, true);
+	ret = hart_read_unique_id(dev->hart_device, &id);
+	cn0414_hart_transaction_done(dev);
+	if(ret != HART_SUCCESS)
+		return cn0414_hart_display_error(dev, ret);
+
+	ret = cn0414_hart_display_cmd_zero_response(dev, &id);
 	if(ret != CN0414_SUCCESS)
 		return ret;
 
-	telegram = calloc(size, sizeof(uint8_t));
-	if (!telegram)
-		return -1;
+	return cn0414_hart_display_status(dev);
+}
 
-	for(i = 0; i < preamb_size; i++)
-		telegram[i] = 0xFF;
-	for(i = 0; i < HART_COMMAND_ZERO_SIZE; i++)
-		telegram[i + preamb_size] = hart_command_zero[i];
+/**
+ * Read the primary variable of the HART device (command 1).
+ *
+ * @param [in] dev - The device structure.
+ * @param [in] arg - Not used in this case. It exists to keep the function
+ *                   prototype compatible with the other functions that can be
+ *                   called from the CLI.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t cn0414_hart_read_pv(struct cn0414_dev *dev, uint8_t* arg)
+{
+	uint8_t buff[64], units;
+	float value;
+	int32_t ret;
 
-	/* Disable interrupts to avoid hanging */
-	NVIC_DisableIRQ(TMR0_INT);
-	NVIC_DisableIRQ(HART_CD_INT);
+	ret = hart_read_pv(dev->hart_device, &units, &value);
+	cn0414_hart_transaction_done(dev);
+	if(ret != HART_SUCCESS)
+		return cn0414_hart_display_error(dev, ret);
 
-	/* Transmit without the "\n" character */
-	ret = ad5700_transmit(dev->ad5700_device, telegram, size);
+	sprintf((char *)buff, "PV: %f (units code %d)\n", value, units);
+	ret = usr_uart_write_string(dev->uart_descriptor, buff);
 	if(ret != CN0414_SUCCESS)
-		usr_uart_write_string(dev->uart_descriptor,
-				      (uint8_t*)"Transmission failed!\n");
+		return ret;
 
-	/* Enable interrupts */
-	NVIC_EnableIRQ(TMR0_INT);
-	NVIC_EnableIRQ(HART_CD_INT);
+	return cn0414_hart_display_status(dev);
+}
 
-	free(telegram);
+/**
+ * Read the loop current and percent of range of the HART device (command 2).
+ *
+ * @param [in] dev - The device structure.
+ * @param [in] arg - Not used in this case. It exists to keep the function
+ *                   prototype compatible with the other functions that can be
+ *                   called from the CLI.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t cn0414_hart_read_current(struct cn0414_dev *dev, uint8_t* arg)
+{
+	uint8_t buff[64];
+	float current, percent;
+	int32_t ret;
 
-	ret = cn0414_hart_enable_modulator(dev, false);
+	ret = hart_read_current_percent(dev->hart_device, &current, &percent);
+	cn0414_hart_transaction_done(dev);
+	if(ret != HART_SUCCESS)
+		return cn0414_hart_display_error(dev, ret);
+
+	sprintf((char *)buff, "Loop current: %f mA\nPercent of range: %f %%\n",
+		current, percent);
+	ret = usr_uart_write_string(dev->uart_descriptor, buff);
 	if(ret != CN0414_SUCCESS)
 		return ret;
 
-	ret = cn0414_hart_receive_and_parse(dev, &telegram, &rec_size);
+	return cn0414_hart_display_status(dev);
+}
+
+/**
+ * Read the dynamic variables and loop current of the HART device (command 3).
+ *
+ * @param [in] dev - The device structure.
+ * @param [in] arg - Not used in this case. It exists to keep the function
+ *                   prototype compatible with the other functions that can be
+ *                   called from the CLI.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t cn0414_hart_read_vars(struct cn0414_dev *dev, uint8_t* arg)
+{
+	struct hart_dynamic_vars vars;
+	uint8_t buff[64], i;
+	int32_t ret;
+
+	ret = hart_read_dynamic_vars(dev->hart_device, &vars);
+	cn0414_hart_transaction_done(dev);
+	if(ret != HART_SUCCESS)
+		return cn0414_hart_display_error(dev, ret);
+
+	sprintf((char *)buff, "Loop current: %f mA\n", vars.current);
+	ret = usr_uart_write_string(dev->uart_descriptor, buff);
 	if(ret != CN0414_SUCCESS)
 		return ret;
 
-	ret = cn0414_hart_display_cmd_zero_response(dev, telegram);
+	for(i = 0; i < vars.count; i++) {
+		sprintf((char *)buff, "%s: %f (units code %d)\n", hart_var_names[i],
+			vars.value[i], vars.units[i]);
+		ret = usr_uart_write_string(dev->uart_descriptor, buff);
+		if(ret != CN0414_SUCCESS)
+			return ret;
+	}
+
+	return cn0414_hart_display_status(dev);
+}
+
+/**
+ * Read the additional status of the HART device (command 48).
+ *
+ * @param [in] dev - The device structure.
+ * @param [in] arg - Not used in this case. It exists to keep the function
+ *                   prototype compatible with the other functions that can be
+ *                   called from the CLI.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t cn0414_hart_read_status(struct cn0414_dev *dev, uint8_t* arg)
+{
+	struct hart_additional_status status;
+	uint8_t buff[8], i;
+	int32_t ret;
+
+	ret = hart_read_additional_status(dev->hart_device, &status);
+	cn0414_hart_transaction_done(dev);
+	if(ret != HART_SUCCESS)
+		return cn0414_hart_display_error(dev, ret);
+
+	usr_uart_write_string(dev->uart_descriptor,
+			      (uint8_t*)"Additional status:");
+	for(i = 0; i < status.size; i++) {
+		sprintf((char *)buff, " %02x", status.data[i]);
+		ret = usr_uart_write_string(dev->uart_descriptor, buff);
+		if(ret != CN0414_SUCCESS)
+			return ret;
+	}
+	usr_uart_write_string(dev->uart_descriptor, (uint8_t*)"\n");
+
+	return cn0414_hart_display_status(dev);
+}
+
+/**
+ * Select the polling address of the HART device. The device is addressed with
+ * short frames until the next command zero.
+ *
+ * @param [in] dev - The device structure.
+ * @param [in] arg - The polling address.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t cn0414_hart_set_address(struct cn0414_dev *dev, uint8_t* arg)
+{
+	int32_t address;
+
+	address = atoi((char *)arg);
+	if((address < 0) || (address > HART_ADDR_MASK))
+		return usr_uart_write_string(dev->uart_descriptor,
+					     (uint8_t*)"Address must be within 0 and 63.\n");
+
+	hart_set_poll_address(dev->hart_device, address);
+
+	return 0;
+}
+
+/**
+ * Display the last burst frame received on the HART link.
+ *
+ * @param [in] dev - The device structure.
+ * @param [in] arg - Not used in this case. It exists to keep the function
+ *                   prototype compatible with the other functions that can be
+ *                   called from the CLI.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t cn0414_hart_burst(struct cn0414_dev *dev, uint8_t* arg)
+{
+	struct hart_frame *burst = &dev->hart_device->burst;
+	uint8_t buff[64], i;
+	int32_t ret;
+
+	if(dev->hart_device->burst_frames == 0)
+		return usr_uart_write_string(dev->uart_descriptor,
+					     (uint8_t*)"No burst frame received.\n");
+
+	sprintf((char *)buff, "Burst frames: %lu, last command: %d, data:",
+		(unsigned long)dev->hart_device->burst_frames, burst->command);
+	ret = usr_uart_write_string(dev->uart_descriptor, buff);
 	if(ret != CN0414_SUCCESS)
 		return ret;
 
-	dev->hart_buffer[0] = 0;
+	for(i = 0; i < burst->byte_count; i++) {
+		sprintf((char *)buff, " %02x", burst->data[i]);
+		ret = usr_uart_write_string(dev->uart_descriptor, buff);
+		if(ret != CN0414_SUCCESS)
+			return ret;
+	}
 
-	return ret;
+	return usr_uart_write_string(dev->uart_descriptor, (uint8_t*)"\n");
 }
 
 /**
@@ -3122,7 +3495,9 @@ int32_t cn0414_process(struct cn0414_dev *dev)
 			uart_previous_line[i] = uart_current_line[i];
 		} while(uart_current_line[i++] != '\0');
 		/* Find needed function based on typed command */
-		cn0414_find_command(dev, uart_current_line, &func);
+		ret = cn0414_find_command(dev, uart_current_line, &func);
+		if(ret != CN0414_SUCCESS)
+			return ret;
 
 		/* Check if there is a valid command */
 		if (func) {
@@ -3143,6 +3518,9 @@ int32_t cn0414_process(struct cn0414_dev *dev)
 		cn0414_cmd_prompt(dev);
 	}
 
+	/* Advance the queued EEPROM jobs */
+	memory_process(dev->memory_device);
+
 	if((adc_channel_flag == 1) &&
 	    (adc_sw_prescaler >= dev->adc_update_desc->sw_prescaler)) {
 		ret = cn0414_process_update_adc(dev);
@@ -3153,11 +3531,17 @@ int32_t cn0414_process(struct cn0414_dev *dev)
 
 	if(modem_rec_flag == true) {
 		ret = cn0414_process_hart_int_rec(dev);
-		if(ret != CN0414_SUCCESS)
-			usr_uart_write_string(dev->uart_descriptor,
-					      (uint8_t*)"\nHART receive error.\n");
-		cn0414_process_hart_detect_command_zero(dev);
-		usr_uart_write_string(dev->uart_descriptor, (uint8_t*)">");
+		if(ret != HART_RECEIVE_PENDING) {
+			if(ret != CN0414_SUCCESS)
+				usr_uart_write_string(dev->uart_descriptor,
+						      (uint8_t*)"\nHART receive error.\n");
+			else if(hart_capture(dev->hart_device, &dev->hart_buffer[1],
+					     dev->hart_rec_size - 1) == HART_SUCCESS)
+				usr_uart_write_string(dev->uart_descriptor,
+						      (uint8_t*)"HART burst frame received.\n");
+			cn0414_process_hart_detect_command_zero(dev);
+			usr_uart_write_string(dev->uart_descriptor, (uint8_t*)">");
+		}
 	}
 
 	if (dev->open_wire_detect_enable == 1) {
@@ -3177,9 +3561,62 @@ int32_t cn0414_process(struct cn0414_dev *dev)
 	return 0;
 }
 
+/**
+ * Compute the lookup table slot of a command.
+ *
+ * Only the command name is hashed, up to the first space, so a typed line
+ * with arguments lands in the same slot as its command call.
+ *
+ * @param [in] command - Command name or typed line.
+ *
+ * @return Slot index in the lookup table.
+ */
+static uint8_t cn0414_cmd_hash(uint8_t *command)
+{
+	uint32_t hash = 5381;
+
+	while(*command != '\0' && *command != ' ')
+		hash = (hash * 33) ^ *command++;
+
+	return hash & (CMD_HASH_SIZE - 1);
+}
+
+/**
+ * Build the command lookup table from the command calls.
+ *
+ * Open addressing with linear probing. Each used slot holds the index of the
+ * command call plus one, so 0 marks an empty slot.
+ *
+ * @return 0 in case of success, negative error code if there are more command
+ *         calls than CMD_HASH_SIZE - 1.
+ */
+static int32_t cn0414_build_cmd_hash(void)
+{
+	uint8_t i, slot;
+
+	memset(cmd_hash, 0, sizeof(cmd_hash));
+
+	for(i = 0; v_cmd_fun[i / 2] != NULL; i++) {
+		/* Keep at least one slot empty to end the probing */
+		if(i >= CMD_HASH_SIZE - 1)
+			return ERROR;
+		slot = cn0414_cmd_hash(cmd_commands[i]);
+		while(cmd_hash[slot] != 0)
+			slot = (slot + 1) & (CMD_HASH_SIZE - 1);
+		cmd_hash[slot] = i + 1;
+	}
+
+	cmd_hash_valid = true;
+
+	return CN0414_SUCCESS;
+}
+
 /**
  * Get the CLI commands and correlate them to functions.
  *
+ * The command is looked up in a hash table built from the command calls the
+ * first time a command is searched.
+ *
  * @param [in] dev       - The device structure.
  * @param [in] command   - Command received from the CLI.
  * @param [out] function - Pointer to the corresponding function.
@@ -3189,24 +3626,27 @@ int32_t cn0414_process(struct cn0414_dev *dev)
 int32_t cn0414_find_command(struct cn0414_dev *dev, uint8_t *command,
 			    cmd_func* function)
 {
-	uint8_t i = 0;
+	uint8_t slot, i;
+	int32_t ret;
 
-	while (v_cmd_fun[i/2] != NULL) {
-		if(strncmp((char *)command,
-			   (char *)cmd_commands[i],
-			   command_size[i]) == 0 ||
-		    strncmp((char *)command,
-			    (char *)cmd_commands[i + 1],
-			    command_size[i+1]) == 0) {
-			if(command_size == 0)
-				break;
+	if(!cmd_hash_valid) {
+		ret = cn0414_build_cmd_hash();
+		if(ret != CN0414_SUCCESS)
+			return ret;
+	}
+
+	slot = cn0414_cmd_hash(command);
+	while(cmd_hash[slot] != 0) {
+		i = cmd_hash[slot] - 1;
+		if(strncmp((char *)command, (char *)cmd_commands[i],
+			   command_size[i]) == 0) {
 			*function = v_cmd_fun[i / 2];
 			break;
 		}
-		i += 2;
+		slot = (slot + 1) & (CMD_HASH_SIZE - 1);
 	}
 
-	return 0;
+	return CN0414_SUCCESS;
 }
 
 /**
@@ -3417,7 +3857,6 @@ int32_t cn0414_mem_discover(struct cn0414_dev *dev, uint8_t start_addr,
 		memory_read(dev->memory_device, 0x0000, &backup, 1);
 		/* Test write */
 		memory_write(dev->memory_device, 0x0000, &test, 1);
-		mdelay(5);
 		/* Test read */
 		memory_read(dev->memory_device, 0x0000, &temp, 1);
 		if(temp == test) {
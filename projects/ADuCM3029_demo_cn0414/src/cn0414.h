@@ -46,6 +46,7 @@
 #include "platform_drivers.h"
 #include "swuart.h"
 #include "ad5700.h"
+#include "hart.h"
 #include "adc_update_timer.h"
 #include "memory.h"
 #include "ad717x.h"
@@ -66,10 +67,15 @@
 #define _TB 9
 #define _SP 32
 
+/* Size of the command lookup table. Must be a power of 2 and greater than
+ * the number of command calls (long and short names). */
+#define CMD_HASH_SIZE 64
+
 #define HART_BUFF_SIZE 256
 #define HART_COMMAND_ZERO_SIZE 5
 #define HART_TERMINATOR_CHARACTER_SIZE 1
 #define HART_NOTHING_RECEIVED 1
+#define HART_RECEIVE_PENDING 2
 #define HART_PREAMBLE_CHAR 0xFF
 #define HART_SHORT_ADDR_RESPONSE 0x06
 #define HART_LONG_ADDR_RESPONSE 0x86
@@ -151,6 +157,7 @@ struct cn0414_ini_param {
 struct cn0414_dev {
 	/* Device peripheral */
 	struct ad5700_dev 	   *ad5700_device;
+	struct hart_dev 	   *hart_device;
 	struct modbus_slave    *slavemb_desc;
 	struct uart_desc 	   *uart_descriptor;
 	struct adc_update_desc *adc_update_desc;
@@ -168,6 +175,7 @@ struct cn0414_dev {
 	uint8_t open_wire_detect_enable; /* Open-Wire Detection enable flag */
 	uint8_t hart_buffer[HART_BUFF_SIZE]; /* HART receive buffer */
 	uint16_t hart_rec_size; /* Size of the last received HART transmission */
+	uint8_t hart_rec_active; /* A HART transmission is being received */
 };
 
 typedef  int32_t (*cmd_func)(struct cn0414_dev*, uint8_t*);
@@ -214,6 +222,31 @@ int32_t cn0414_hart_get_rec(struct cn0414_dev *dev, uint8_t* arg);
 /* Send HART command zero. */
 int32_t cn0414_hart_send_command_zero(struct cn0414_dev *dev, uint8_t* arg);
 
+/* Read the primary variable of the HART device (command 1). */
+int32_t cn0414_hart_read_pv(struct cn0414_dev *dev, uint8_t* arg);
+
+/* Read the loop current and percent of range of the HART device
+ * (command 2). */
+int32_t cn0414_hart_read_current(struct cn0414_dev *dev, uint8_t* arg);
+
+/* Read the dynamic variables of the HART device (command 3). */
+int32_t cn0414_hart_read_vars(struct cn0414_dev *dev, uint8_t* arg);
+
+/* Read the additional status of the HART device (command 48). */
+int32_t cn0414_hart_read_status(struct cn0414_dev *dev, uint8_t* arg);
+
+/* Select the polling address of the HART device. */
+int32_t cn0414_hart_set_address(struct cn0414_dev *dev, uint8_t* arg);
+
+/* Display the last burst frame received on the HART link. */
+int32_t cn0414_hart_burst(struct cn0414_dev *dev, uint8_t* arg);
+
+/* Transmit a frame for the HART link layer. */
+int32_t cn0414_hart_phy_transmit(void *phy, uint8_t *data, uint32_t size);
+
+/* Get a character received on the HART link. */
+int32_t cn0414_hart_phy_get_char(void *phy, uint8_t *byte);
+
 /* This method sends the provided test byte through the HART link continuously
  * until stopped by pressing q. Function used to test the HART physical
  * layer. */
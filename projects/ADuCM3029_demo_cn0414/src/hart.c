@@ -0,0 +1,768 @@
+/***************************************************************************//**
+*   @file   hart.c
+*   @brief  HART master data link layer source.
+********************************************************************************
+* Copyright 2019(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "hart.h"
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * Initialize the HART master link layer.
+ *
+ * The field device is addressed with short frames and polling address 0 until
+ * hart_read_unique_id() or hart_set_long_address() is called.
+ *
+ * @param [out] device    - The device structure.
+ * @param [in] init_param - Pointer to the structure that contains the device
+ *                          initial parameters.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t hart_init(struct hart_dev **device, struct hart_init_param *init_param)
+{
+	struct hart_dev *dev;
+
+	if(!init_param->ops || !init_param->ops->transmit ||
+	    !init_param->ops->get_char || !init_param->ops->get_ms)
+		return -1;
+
+	dev = calloc(1, sizeof *dev);
+	if (!dev)
+		return -1;
+
+	dev->ops = init_param->ops;
+	dev->phy = init_param->phy;
+	dev->preamble_size = init_param->preamble_size;
+	if((dev->preamble_size < HART_MIN_PREAMBLE) ||
+	    (dev->preamble_size > HART_MAX_PREAMBLE))
+		dev->preamble_size = HART_DEFAULT_PREAMBLE;
+	dev->retries = init_param->retries;
+	dev->master = HART_ADDR_PRIMARY_MASTER;
+	hart_set_poll_address(dev, 0);
+	hart_parser_reset(&dev->parser);
+
+	*device = dev;
+
+	return HART_SUCCESS;
+}
+
+/**
+ * Free the resources allocated by hart_init().
+ *
+ * @param [in] dev - The device structure.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t hart_remove(struct hart_dev *dev)
+{
+	free(dev);
+
+	return HART_SUCCESS;
+}
+
+/**
+ * Address the field device with short frames and the given polling address.
+ *
+ * @param [in] dev          - The device structure.
+ * @param [in] poll_address - Polling address of the field device.
+ *
+ * @return none
+ */
+void hart_set_poll_address(struct hart_dev *dev, uint8_t poll_address)
+{
+	dev->poll_address = poll_address & HART_ADDR_MASK;
+	dev->long_frame = 0;
+}
+
+/**
+ * Address the field device with long frames and the given unique address.
+ *
+ * @param [in] dev          - The device structure.
+ * @param [in] long_address - The 5 byte unique address of the field device.
+ *
+ * @return none
+ */
+void hart_set_long_address(struct hart_dev *dev, uint8_t *long_address)
+{
+	memcpy(dev->long_address, long_address, HART_LONG_ADDR_SIZE);
+	dev->long_address[0] &= HART_ADDR_MASK;
+	dev->long_frame = 1;
+}
+
+/**
+ * Reset the frame parser to hunt for a new preamble.
+ *
+ * @param [in] parser - The frame parser.
+ *
+ * @return none
+ */
+void hart_parser_reset(struct hart_parser *parser)
+{
+	parser->state = HART_PARSE_PREAMBLE;
+	parser->preamble_count = 0;
+	parser->index = 0;
+	parser->checksum = 0;
+}
+
+/**
+ * Feed one received byte to the frame parser.
+ *
+ * At least HART_MIN_PREAMBLE preamble bytes must precede a valid delimiter for
+ * a frame to start. The checksum is the exclusive OR of all the bytes from the
+ * delimiter to the last data byte.
+ *
+ * @param [in] parser - The frame parser.
+ * @param [out] frame - The frame being received.
+ * @param [in] byte   - The received byte.
+ *
+ * @return HART_PENDING until the frame is complete, 0 for a valid frame,
+ *         HART_ERR_CHECKSUM if the checksum does not match.
+ */
+int32_t hart_parse_byte(struct hart_parser *parser, struct hart_frame *frame,
+			uint8_t byte)
+{
+	uint8_t type;
+
+	switch(parser->state) {
+	case HART_PARSE_PREAMBLE:
+		if(byte == HART_PREAMBLE_BYTE) {
+			if(parser->preamble_count < HART_MIN_PREAMBLE)
+				parser->preamble_count++;
+			return HART_PENDING;
+		}
+		type = HART_DELIM_FRAME_TYPE(byte);
+		if((parser->preamble_count < HART_MIN_PREAMBLE) ||
+		    (HART_DELIM_PHY_TYPE(byte) != 0) ||
+		    ((type != HART_FRAME_BACK) && (type != HART_FRAME_STX) &&
+		     (type != HART_FRAME_ACK))) {
+			parser->preamble_count = 0;
+			return HART_PENDING;
+		}
+		frame->delimiter = byte;
+		parser->checksum = 0;
+		parser->index = 0;
+		parser->state = HART_PARSE_ADDRESS;
+		break;
+	case HART_PARSE_ADDRESS:
+		frame->address[parser->index++] = byte;
+		if((frame->delimiter & HART_DELIM_LONG_ADDR) &&
+		    (parser->index < HART_LONG_ADDR_SIZE))
+			break;
+		parser->index = 0;
+		if(HART_DELIM_EXP_BYTES(frame->delimiter) != 0)
+			parser->state = HART_PARSE_EXPANSION;
+		else
+			parser->state = HART_PARSE_COMMAND;
+		break;
+	case HART_PARSE_EXPANSION:
+		parser->index++;
+		if(parser->index == HART_DELIM_EXP_BYTES(frame->delimiter))
+			parser->state = HART_PARSE_COMMAND;
+		break;
+	case HART_PARSE_COMMAND:
+		frame->command = byte;
+		parser->state = HART_PARSE_BYTE_COUNT;
+		break;
+	case HART_PARSE_BYTE_COUNT:
+		frame->byte_count = byte;
+		parser->index = 0;
+		if(byte != 0)
+			parser->state = HART_PARSE_DATA;
+		else
+			parser->state = HART_PARSE_CHECKSUM;
+		break;
+	case HART_PARSE_DATA:
+		frame->data[parser->index++] = byte;
+		if(parser->index == frame->byte_count)
+			parser->state = HART_PARSE_CHECKSUM;
+		break;
+	case HART_PARSE_CHECKSUM:
+		type = parser->checksum;
+		hart_parser_reset(parser);
+		if(byte != type)
+			return HART_ERR_CHECKSUM;
+
+		return HART_SUCCESS;
+	}
+
+	parser->checksum ^= byte;
+
+	return HART_PENDING;
+}
+
+/**
+ * Build a frame from the master to the field device, using the current
+ * addressing mode and preamble size.
+ *
+ * @param [in] dev      - The device structure.
+ * @param [in] command  - Command number.
+ * @param [in] data     - Request data.
+ * @param [in] size     - Request data size.
+ * @param [out] buff    - Buffer for the frame.
+ *
+ * @return The size of the frame.
+ */
+uint32_t hart_build_frame(struct hart_dev *dev, uint8_t command, uint8_t *data,
+			  uint8_t size, uint8_t *buff)
+{
+	uint32_t len = 0, start, i;
+	uint8_t checksum = 0;
+
+	for(i = 0; i < dev->preamble_size; i++)
+		buff[len++] = HART_PREAMBLE_BYTE;
+	start = len;
+
+	if(dev->long_frame) {
+		buff[len++] = HART_FRAME_STX | HART_DELIM_LONG_ADDR;
+		buff[len++] = dev->master | dev->long_address[0];
+		for(i = 1; i < HART_LONG_ADDR_SIZE; i++)
+			buff[len++] = dev->long_address[i];
+	} else {
+		buff[len++] = HART_FRAME_STX;
+		buff[len++] = dev->master | dev->poll_address;
+	}
+	buff[len++] = command;
+	buff[len++] = size;
+	for(i = 0; i < size; i++)
+		buff[len++] = data[i];
+
+	for(i = start; i < len; i++)
+		checksum ^= buff[i];
+	buff[len++] = checksum;
+
+	return len;
+}
+
+/**
+ * Check if a response comes from the addressed field device and is meant for
+ * this master.
+ *
+ * @param [in] dev   - The device structure.
+ * @param [in] frame - The received frame.
+ *
+ * @return true if the addresses match, false otherwise.
+ */
+static bool hart_address_match(struct hart_dev *dev, struct hart_frame *frame)
+{
+	if((frame->address[0] & HART_ADDR_PRIMARY_MASTER) != dev->master)
+		return false;
+
+	if(!dev->long_frame)
+		return !(frame->delimiter & HART_DELIM_LONG_ADDR) &&
+		       ((frame->address[0] & HART_ADDR_MASK) == dev->poll_address);
+
+	if(!(frame->delimiter & HART_DELIM_LONG_ADDR) ||
+	    ((frame->address[0] & HART_ADDR_MASK) != dev->long_address[0]))
+		return false;
+
+	return memcmp(&frame->address[1], &dev->long_address[1],
+		      HART_LONG_ADDR_SIZE - 1) == 0;
+}
+
+/**
+ * Keep a burst frame received from the field device.
+ *
+ * @param [in] dev   - The device structure.
+ * @param [in] frame - The received frame.
+ *
+ * @return none
+ */
+static void hart_store_burst(struct hart_dev *dev, struct hart_frame *frame)
+{
+	memcpy(&dev->burst, frame, sizeof(dev->burst));
+	dev->burst_frames++;
+}
+
+/**
+ * Wait for the response to a command.
+ *
+ * The response must start within HART_RESPONSE_TIMEOUT. Inside a frame a
+ * silence longer than HART_GAP_TIMEOUT means the frame was truncated. After
+ * a character error or a checksum error the rest of the transmission is
+ * dropped and the function returns once the line is quiet, so a retry does
+ * not collide with the field device. Burst frames received meanwhile are kept
+ * and frames for other devices or masters are ignored.
+ *
+ * @param [in] dev     - The device structure.
+ * @param [in] command - The command of the expected response.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t hart_receive(struct hart_dev *dev, uint8_t command)
+{
+	struct hart_frame *frame = &dev->response;
+	uint32_t start, last, now;
+	int32_t ret, error = HART_SUCCESS;
+	uint8_t byte;
+
+	hart_parser_reset(&dev->parser);
+	start = dev->ops->get_ms();
+	last = start;
+
+	while(true) {
+		ret = dev->ops->get_char(dev->phy, &byte);
+		now = dev->ops->get_ms();
+
+		if(ret == HART_PHY_NO_DATA) {
+			if((error != HART_SUCCESS) ||
+			    (dev->parser.state != HART_PARSE_PREAMBLE)) {
+				if((now - last) <= HART_GAP_TIMEOUT)
+					continue;
+				if(error == HART_SUCCESS) {
+					dev->frame_errors++;
+					error = HART_ERR_FRAME;
+				}
+				hart_parser_reset(&dev->parser);
+
+				return error;
+			}
+			if((now - start) > HART_RESPONSE_TIMEOUT) {
+				dev->timeouts++;
+
+				return HART_ERR_TIMEOUT;
+			}
+			continue;
+		}
+		last = now;
+
+		if(error != HART_SUCCESS)
+			continue;
+
+		if(ret < 0) {
+			if(dev->parser.state != HART_PARSE_PREAMBLE) {
+				dev->frame_errors++;
+				error = HART_ERR_FRAME;
+			}
+			dev->parser.preamble_count = 0;
+			continue;
+		}
+
+		ret = hart_parse_byte(&dev->parser, frame, byte);
+		if(ret == HART_PENDING)
+			continue;
+		if(ret != HART_SUCCESS) {
+			dev->checksum_errors++;
+			error = ret;
+			continue;
+		}
+		dev->rx_frames++;
+
+		if(HART_DELIM_FRAME_TYPE(frame->delimiter) == HART_FRAME_BACK) {
+			hart_store_burst(dev, frame);
+			continue;
+		}
+		if((HART_DELIM_FRAME_TYPE(frame->delimiter) == HART_FRAME_ACK) &&
+		    (frame->command == command) && hart_address_match(dev, frame))
+			return HART_SUCCESS;
+	}
+}
+
+/**
+ * Send a command and wait for the response.
+ *
+ * The transaction is repeated up to the configured number of retries if there
+ * is no response, the response is corrupted, the field device reports a
+ * communication error or answers busy.
+ *
+ * @param [in] dev       - The device structure.
+ * @param [in] command   - Command number.
+ * @param [in] data      - Request data.
+ * @param [in] size      - Request data size.
+ * @param [out] response - Pointer to the last response. The first two data
+ *                         bytes are the status bytes.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t hart_command(struct hart_dev *dev, uint8_t command, uint8_t *data,
+		     uint8_t size, struct hart_frame **response)
+{
+	int32_t ret = HART_ERR_TIMEOUT;
+	uint32_t len;
+	uint8_t i;
+
+	*response = &dev->response;
+
+	len = hart_build_frame(dev, command, data, size, dev->tx_buff);
+
+	for(i = 0; i <= dev->retries; i++) {
+		if(i != 0)
+			dev->retry_count++;
+
+		ret = dev->ops->transmit(dev->phy, dev->tx_buff, len);
+		if(ret != HART_SUCCESS)
+			return ret;
+		dev->tx_frames++;
+
+		ret = hart_receive(dev, command);
+		if(ret != HART_SUCCESS)
+			continue;
+
+		if(dev->response.byte_count < 2) {
+			dev->frame_errors++;
+			ret = HART_ERR_FRAME;
+		} else if(dev->response.data[0] & HART_COMM_ERROR) {
+			ret = HART_ERR_COMM;
+		} else if(dev->response.data[0] == HART_RC_BUSY) {
+			ret = HART_ERR_RESPONSE;
+		} else {
+			break;
+		}
+	}
+
+	return ret;
+}
+
+/**
+ * Look for burst frames in a buffer received outside of a transaction.
+ *
+ * The frames are parsed apart, so the last burst frame is replaced only by a
+ * complete burst frame with a valid checksum. Other frames, corrupted frames
+ * and a frame truncated at the end of the buffer leave it untouched.
+ *
+ * @param [in] dev  - The device structure.
+ * @param [in] data - The received bytes.
+ * @param [in] size - Number of received bytes.
+ *
+ * @return 0 if a burst frame was found, HART_PENDING if not, HART_ERR_CHECKSUM
+ *         if the only frames found were corrupted.
+ */
+int32_t hart_capture(struct hart_dev *dev, uint8_t *data, uint32_t size)
+{
+	struct hart_frame frame;
+	int32_t ret, found = HART_PENDING;
+	uint32_t i;
+
+	hart_parser_reset(&dev->parser);
+
+	for(i = 0; i < size; i++) {
+		ret = hart_parse_byte(&dev->parser, &frame, data[i]);
+		if(ret == HART_PENDING)
+			continue;
+		if(ret != HART_SUCCESS) {
+			dev->checksum_errors++;
+			if(found != HART_SUCCESS)
+				found = ret;
+			continue;
+		}
+		dev->rx_frames++;
+		if(HART_DELIM_FRAME_TYPE(frame.delimiter) == HART_FRAME_BACK) {
+			hart_store_burst(dev, &frame);
+			found = HART_SUCCESS;
+		}
+	}
+
+	return found;
+}
+
+/**
+ * Get a description of the status bytes of a response.
+ *
+ * @param [in] response - The response frame.
+ *
+ * @return The description of the communication error or the response code.
+ */
+const char *hart_response_str(struct hart_frame *response)
+{
+	uint8_t status;
+
+	if(response->byte_count < 2)
+		return "No status";
+
+	status = response->data[0];
+	if(status & HART_COMM_ERROR) {
+		if(status & HART_COMM_PARITY)
+			return "Vertical parity error";
+		if(status & HART_COMM_OVERRUN)
+			return "Overrun error";
+		if(status & HART_COMM_FRAMING)
+			return "Framing error";
+		if(status & HART_COMM_CHECKSUM)
+			return "Longitudinal parity error";
+		if(status & HART_COMM_RX_OVERFLOW)
+			return "Buffer overflow";
+
+		return "Communication error";
+	}
+
+	switch(status) {
+	case HART_RC_SUCCESS:
+		return "Success";
+	case 2:
+		return "Invalid selection";
+	case 3:
+		return "Passed parameter too large";
+	case 4:
+		return "Passed parameter too small";
+	case 5:
+		return "Too few data bytes received";
+	case 6:
+		return "Device-specific command error";
+	case 7:
+		return "In write protect mode";
+	case 16:
+		return "Access restricted";
+	case HART_RC_BUSY:
+		return "Device is busy";
+	case 33:
+		return "Delayed response initiated";
+	case 34:
+		return "Delayed response running";
+	case 35:
+		return "Delayed response dead";
+	case 64:
+		return "Command not implemented";
+	default:
+		return "Command specific response";
+	}
+}
+
+/**
+ * Send a command without request data and check the size of the response.
+ *
+ * @param [in] dev      - The device structure.
+ * @param [in] command  - Command number.
+ * @param [in] min_size - Minimum number of data bytes after the status bytes.
+ * @param [out] data    - Pointer to the data after the status bytes.
+ * @param [out] size    - Number of data bytes after the status bytes.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t hart_read_command(struct hart_dev *dev, uint8_t command,
+				 uint8_t min_size, uint8_t **data,
+				 uint8_t *size)
+{
+	struct hart_frame *response;
+	int32_t ret;
+
+	ret = hart_command(dev, command, NULL, 0, &response);
+	if(ret != HART_SUCCESS)
+		return ret;
+
+	/* Error responses carry no data */
+	if(response->byte_count < (min_size + 2)) {
+		if(response->data[0] != HART_RC_SUCCESS)
+			return HART_ERR_RESPONSE;
+
+		return HART_ERR_SIZE;
+	}
+
+	*data = &response->data[2];
+	*size = response->byte_count - 2;
+
+	return HART_SUCCESS;
+}
+
+/**
+ * Get a big endian IEEE 754 float from a response.
+ *
+ * @param [in] data - Pointer to the first byte.
+ *
+ * @return The float value.
+ */
+static float hart_get_float(uint8_t *data)
+{
+	uint32_t raw;
+	float value;
+
+	raw = ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+	      ((uint32_t)data[2] << 8) | data[3];
+	memcpy(&value, &raw, sizeof(value));
+
+	return value;
+}
+
+/**
+ * Command 0. Read the unique identifier of the field device.
+ *
+ * On success the following commands are sent with long frames to the unique
+ * address of the device, and the preamble is made at least as long as the
+ * device requires.
+ *
+ * @param [in] dev - The device structure.
+ * @param [out] id - The identification data.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t hart_read_unique_id(struct hart_dev *dev, struct hart_unique_id *id)
+{
+	uint8_t *data, size;
+	int32_t ret;
+
+	ret = hart_read_command(dev, HART_CMD_READ_UNIQUE_ID, 12, &data, &size);
+	if(ret != HART_SUCCESS)
+		return ret;
+
+	id->manufacturer_id = data[1];
+	id->device_type = data[2];
+	id->preambles = data[3];
+	id->universal_rev = data[4];
+	id->device_rev = data[5];
+	id->software_rev = data[6];
+	id->hardware_rev = data[7];
+	id->flags = data[8];
+	id->device_id = ((uint32_t)data[9] << 16) | ((uint32_t)data[10] << 8) |
+			data[11];
+
+	id->long_address[0] = data[1] & HART_ADDR_MASK;
+	id->long_address[1] = data[2];
+	id->long_address[2] = data[9];
+	id->long_address[3] = data[10];
+	id->long_address[4] = data[11];
+	hart_set_long_address(dev, id->long_address);
+
+	if((id->preambles > dev->preamble_size) &&
+	    (id->preambles <= HART_MAX_PREAMBLE))
+		dev->preamble_size = id->preambles;
+
+	return HART_SUCCESS;
+}
+
+/**
+ * Command 1. Read the primary variable.
+ *
+ * @param [in] dev    - The device structure.
+ * @param [out] units - Units code of the primary variable.
+ * @param [out] value - Value of the primary variable.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t hart_read_pv(struct hart_dev *dev, uint8_t *units, float *value)
+{
+	uint8_t *data, size;
+	int32_t ret;
+
+	ret = hart_read_command(dev, HART_CMD_READ_PV, 5, &data, &size);
+	if(ret != HART_SUCCESS)
+		return ret;
+
+	*units = data[0];
+	*value = hart_get_float(&data[1]);
+
+	return HART_SUCCESS;
+}
+
+/**
+ * Command 2. Read the loop current and the percent of range.
+ *
+ * @param [in] dev      - The device structure.
+ * @param [out] current - Loop current in mA.
+ * @param [out] percent - Primary variable in percent of range.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t hart_read_current_percent(struct hart_dev *dev, float *current,
+				  float *percent)
+{
+	uint8_t *data, size;
+	int32_t ret;
+
+	ret = hart_read_command(dev, HART_CMD_READ_CURRENT_PERCENT, 8, &data,
+				&size);
+	if(ret != HART_SUCCESS)
+		return ret;
+
+	*current = hart_get_float(&data[0]);
+	*percent = hart_get_float(&data[4]);
+
+	return HART_SUCCESS;
+}
+
+/**
+ * Command 3. Read the dynamic variables and the loop current. Devices return
+ * between one and four variables.
+ *
+ * @param [in] dev   - The device structure.
+ * @param [out] vars - The loop current and the variables.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t hart_read_dynamic_vars(struct hart_dev *dev,
+			       struct hart_dynamic_vars *vars)
+{
+	uint8_t *data, size, i;
+	int32_t ret;
+
+	ret = hart_read_command(dev, HART_CMD_READ_DYNAMIC_VARS, 9, &data, &size);
+	if(ret != HART_SUCCESS)
+		return ret;
+
+	vars->current = hart_get_float(&data[0]);
+	vars->count = (size - 4) / 5;
+	if(vars->count > HART_MAX_DYNAMIC_VARS)
+		vars->count = HART_MAX_DYNAMIC_VARS;
+	for(i = 0; i < vars->count; i++) {
+		vars->units[i] = data[4 + 5 * i];
+		vars->value[i] = hart_get_float(&data[5 + 5 * i]);
+	}
+
+	return HART_SUCCESS;
+}
+
+/**
+ * Command 48. Read the additional device status.
+ *
+ * @param [in] dev     - The device structure.
+ * @param [out] status - The status bytes.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t hart_read_additional_status(struct hart_dev *dev,
+				    struct hart_additional_status *status)
+{
+	uint8_t *data, size;
+	int32_t ret;
+
+	ret = hart_read_command(dev, HART_CMD_READ_ADDITIONAL_STATUS, 1, &data,
+				&size);
+	if(ret != HART_SUCCESS)
+		return ret;
+
+	status->size = size;
+	if(status->size > HART_MAX_ADDITIONAL_STATUS)
+		status->size = HART_MAX_ADDITIONAL_STATUS;
+	memcpy(status->data, data, status->size);
+
+	return HART_SUCCESS;
+}
@@ -0,0 +1,279 @@
+/***************************************************************************//**
+*   @file   hart.h
+*   @brief  HART master data link layer header.
+********************************************************************************
+* Copyright 2019(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef HART_H_
+#define HART_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+#define HART_SUCCESS 0
+/* Frame not complete yet */
+#define HART_PENDING 1
+/* No response from the field device */
+#define HART_ERR_TIMEOUT -2
+/* Longitudinal parity (checksum) error */
+#define HART_ERR_CHECKSUM -3
+/* Truncated frame or character received with errors */
+#define HART_ERR_FRAME -4
+/* The field device reported a communication error */
+#define HART_ERR_COMM -5
+/* The field device answered with an error response code */
+#define HART_ERR_RESPONSE -6
+/* The response is too short for the command */
+#define HART_ERR_SIZE -7
+
+/* Return value of get_char() when no character is available */
+#define HART_PHY_NO_DATA 1
+
+#define HART_PREAMBLE_BYTE 0xFF
+#define HART_MIN_PREAMBLE 2
+#define HART_MAX_PREAMBLE 20
+#define HART_DEFAULT_PREAMBLE 5
+#define HART_DEFAULT_RETRIES 3
+#define HART_MAX_DATA 255
+#define HART_LONG_ADDR_SIZE 5
+/* Delimiter, long address, 3 expansion bytes, command, byte count, checksum */
+#define HART_MAX_HEADER 12
+
+/* Time the master waits for the start of a response (RT1), in ms */
+#define HART_RESPONSE_TIMEOUT 305
+/* Longest silence allowed inside a frame, in ms */
+#define HART_GAP_TIMEOUT 20
+
+/* Delimiter fields */
+#define HART_DELIM_LONG_ADDR 0x80
+#define HART_DELIM_EXP_BYTES(x) (((x) >> 5) & 0x03)
+#define HART_DELIM_PHY_TYPE(x) (((x) >> 3) & 0x03)
+#define HART_DELIM_FRAME_TYPE(x) ((x) & 0x07)
+#define HART_FRAME_BACK 0x01 /* Burst frame */
+#define HART_FRAME_STX 0x02 /* Master to field device */
+#define HART_FRAME_ACK 0x06 /* Field device to master */
+
+/* Address fields */
+#define HART_ADDR_PRIMARY_MASTER 0x80
+#define HART_ADDR_BURST 0x40
+#define HART_ADDR_MASK 0x3F
+
+/* First status byte. When bit 7 is set the byte holds communication errors,
+ * otherwise it holds the command response code. */
+#define HART_COMM_ERROR 0x80
+#define HART_COMM_PARITY 0x40
+#define HART_COMM_OVERRUN 0x20
+#define HART_COMM_FRAMING 0x10
+#define HART_COMM_CHECKSUM 0x08
+#define HART_COMM_RX_OVERFLOW 0x02
+#define HART_RC_SUCCESS 0
+#define HART_RC_BUSY 32
+
+/* Universal commands */
+#define HART_CMD_READ_UNIQUE_ID 0
+#define HART_CMD_READ_PV 1
+#define HART_CMD_READ_CURRENT_PERCENT 2
+#define HART_CMD_READ_DYNAMIC_VARS 3
+#define HART_CMD_READ_ADDITIONAL_STATUS 48
+
+#define HART_MAX_DYNAMIC_VARS 4
+#define HART_MAX_ADDITIONAL_STATUS 25
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/* Physical layer access used by the link layer */
+struct hart_phy_ops {
+	/* Transmit a whole frame. Returns after the last byte is sent. */
+	int32_t (*transmit)(void *phy, uint8_t *data, uint32_t size);
+	/* Get a received character. Returns 0, HART_PHY_NO_DATA or a negative
+	 * value if the character was received with a parity or framing error. */
+	int32_t (*get_char)(void *phy, uint8_t *byte);
+	/* Millisecond time stamp */
+	uint32_t (*get_ms)(void);
+};
+
+/* HART frame */
+struct hart_frame {
+	uint8_t delimiter;
+	uint8_t address[HART_LONG_ADDR_SIZE];
+	uint8_t command;
+	uint8_t byte_count;
+	/* For responses the first two bytes are the status bytes */
+	uint8_t data[HART_MAX_DATA];
+};
+
+/* Frame parser states */
+enum hart_parse_state {
+	HART_PARSE_PREAMBLE,
+	HART_PARSE_ADDRESS,
+	HART_PARSE_EXPANSION,
+	HART_PARSE_COMMAND,
+	HART_PARSE_BYTE_COUNT,
+	HART_PARSE_DATA,
+	HART_PARSE_CHECKSUM
+};
+
+/* Frame parser */
+struct hart_parser {
+	enum hart_parse_state state;
+	uint8_t preamble_count;
+	uint8_t index;
+	uint8_t checksum;
+};
+
+/* Response to command 0 */
+struct hart_unique_id {
+	uint8_t manufacturer_id;
+	uint8_t device_type;
+	uint8_t preambles; /* Preambles required from the master */
+	uint8_t universal_rev;
+	uint8_t device_rev;
+	uint8_t software_rev;
+	uint8_t hardware_rev;
+	uint8_t flags;
+	uint32_t device_id;
+	uint8_t long_address[HART_LONG_ADDR_SIZE];
+};
+
+/* Response to command 3 */
+struct hart_dynamic_vars {
+	float current; /* Loop current in mA */
+	uint8_t count; /* Number of variables in the response */
+	uint8_t units[HART_MAX_DYNAMIC_VARS];
+	float value[HART_MAX_DYNAMIC_VARS];
+};
+
+/* Response to command 48 */
+struct hart_additional_status {
+	uint8_t size;
+	uint8_t data[HART_MAX_ADDITIONAL_STATUS];
+};
+
+/* HART master link layer initialization parameters */
+struct hart_init_param {
+	const struct hart_phy_ops *ops;
+	void *phy;
+	uint8_t preamble_size;
+	uint8_t retries;
+};
+
+/* HART master link layer descriptor */
+struct hart_dev {
+	const struct hart_phy_ops *ops;
+	void *phy;
+	uint8_t preamble_size;
+	uint8_t retries; /* Retries after a failed transaction */
+	uint8_t master; /* Master address bit */
+	/* Field device address */
+	uint8_t long_frame;
+	uint8_t poll_address;
+	uint8_t long_address[HART_LONG_ADDR_SIZE];
+	struct hart_parser parser;
+	struct hart_frame response; /* Last response */
+	struct hart_frame burst; /* Last burst frame */
+	uint8_t tx_buff[HART_MAX_PREAMBLE + HART_MAX_HEADER + HART_MAX_DATA];
+	/* Link statistics */
+	uint32_t tx_frames;
+	uint32_t rx_frames;
+	uint32_t burst_frames;
+	uint32_t timeouts;
+	uint32_t checksum_errors;
+	uint32_t frame_errors;
+	uint32_t retry_count;
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/* Initialize the HART master link layer. */
+int32_t hart_init(struct hart_dev **device, struct hart_init_param *init_param);
+
+/* Free the resources allocated by hart_init(). */
+int32_t hart_remove(struct hart_dev *dev);
+
+/* Address the field device with short frames and the given polling address. */
+void hart_set_poll_address(struct hart_dev *dev, uint8_t poll_address);
+
+/* Address the field device with long frames and the given unique address. */
+void hart_set_long_address(struct hart_dev *dev, uint8_t *long_address);
+
+/* Reset the frame parser to hunt for a new preamble. */
+void hart_parser_reset(struct hart_parser *parser);
+
+/* Feed one received byte to the frame parser. */
+int32_t hart_parse_byte(struct hart_parser *parser, struct hart_frame *frame,
+			uint8_t byte);
+
+/* Build a frame from the master to the field device. */
+uint32_t hart_build_frame(struct hart_dev *dev, uint8_t command, uint8_t *data,
+			  uint8_t size, uint8_t *buff);
+
+/* Send a command and wait for the response, with retries. */
+int32_t hart_command(struct hart_dev *dev, uint8_t command, uint8_t *data,
+		     uint8_t size, struct hart_frame **response);
+
+/* Look for burst frames in a buffer received outside of a transaction. */
+int32_t hart_capture(struct hart_dev *dev, uint8_t *data, uint32_t size);
+
+/* Get a description of the status bytes of a response. */
+const char *hart_response_str(struct hart_frame *response);
+
+/* Command 0. Read the unique identifier and switch to long frames. */
+int32_t hart_read_unique_id(struct hart_dev *dev, struct hart_unique_id *id);
+
+/* Command 1. Read the primary variable. */
+int32_t hart_read_pv(struct hart_dev *dev, uint8_t *units, float *value);
+
+/* Command 2. Read the loop current and the percent of range. */
+int32_t hart_read_current_percent(struct hart_dev *dev, float *current,
+				  float *percent);
+
+/* Command 3. Read the dynamic variables and the loop current. */
+int32_t hart_read_dynamic_vars(struct hart_dev *dev,
+			       struct hart_dynamic_vars *vars);
+
+/* Command 48. Read the additional device status. */
+int32_t hart_read_additional_status(struct hart_dev *dev,
+				    struct hart_additional_status *status);
+
+#endif /* HART_H_ */
@@ -108,12 +108,312 @@ int32_t memory_remove(struct memory_desc *dev)
 	return ret;
 }
 
+/**
+ * Get the job at the head of the queue, the one being processed.
+ *
+ * @param [in] dev - The device structure.
+ *
+ * @return Pointer to the current job.
+ */
+static struct memory_job *memory_current_job(struct memory_desc *dev)
+{
+	return &dev->queue[dev->queue_tail % MEMORY_QUEUE_SIZE];
+}
+
+/**
+ * Start the next I2C transfer of the current job.
+ *
+ * The memory address is sent as the transfer prologue so the user buffer is
+ * used directly. Writes are cut at page boundaries. When a write job has no
+ * data left an address only write is started to poll the end of the last
+ * write cycle.
+ *
+ * @param [in] dev - The device structure.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t memory_start_transfer(struct memory_desc *dev)
+{
+	struct memory_job *job = memory_current_job(dev);
+	int32_t ret;
+
+	dev->address_buff[0] = (job->address & 0xff00) >> 8;
+	dev->address_buff[1] = (job->address & 0x00ff) >> 0;
+
+	if(job->type == MEMORY_JOB_READ) {
+		/* The whole read is one sequential read */
+		dev->chunk = job->size;
+		ret = i2c_transfer_nonblocking(dev->i2c_dev, dev->address_buff, 2,
+					       job->data, dev->chunk, true);
+	} else if(job->size == 0) {
+		dev->chunk = 0;
+		ret = i2c_transfer_nonblocking(dev->i2c_dev, dev->address_buff, 1,
+					       &dev->address_buff[1], 1, false);
+	} else {
+		dev->chunk = WRITE_SIZE_LIMIT - (job->address % WRITE_SIZE_LIMIT);
+		if(dev->chunk > job->size)
+			dev->chunk = job->size;
+		ret = i2c_transfer_nonblocking(dev->i2c_dev, dev->address_buff, 2,
+					       job->data, dev->chunk, false);
+	}
+
+	dev->transfer_pending = (ret == MEMORY_SUCCESS);
+
+	return ret;
+}
+
+/**
+ * End the current job, remove it from the queue and call its callback.
+ *
+ * @param [in] dev    - The device structure.
+ * @param [in] status - Result of the job.
+ *
+ * @return The status of the job.
+ */
+static int32_t memory_end_job(struct memory_desc *dev, int32_t status)
+{
+	struct memory_job *job = memory_current_job(dev);
+	memory_callback callback = job->callback;
+	void *ctx = job->ctx;
+
+	dev->queue_tail++;
+	dev->transfer_pending = false;
+	dev->write_cycle = false;
+	dev->polls = 0;
+
+	if(callback)
+		callback(ctx, status);
+
+	return status;
+}
+
+/**
+ * Add a job at the end of the queue.
+ *
+ * @param [in] dev      - The device structure.
+ * @param [in] type     - Read or write job.
+ * @param [in] address  - Absolute address in memory of the first byte.
+ * @param [in] data     - Data buffer. Must stay valid until the job ends.
+ * @param [in] size     - Size of the data array.
+ * @param [in] callback - Function called when the job ends, may be NULL.
+ * @param [in] ctx      - Parameter passed to the callback.
+ *
+ * @return 0 in case of success, MEMORY_BUSY_ERROR if the queue is full.
+ */
+static int32_t memory_queue_job(struct memory_desc *dev,
+				enum memory_job_type type, uint16_t address,
+				uint8_t *data, uint32_t size,
+				memory_callback callback, void *ctx)
+{
+	struct memory_job *job;
+
+	if((uint8_t)(dev->queue_head - dev->queue_tail) >= MEMORY_QUEUE_SIZE)
+		return MEMORY_BUSY_ERROR;
+
+	job = &dev->queue[dev->queue_head % MEMORY_QUEUE_SIZE];
+	job->type = type;
+	job->address = address;
+	job->data = data;
+	job->size = size;
+	job->callback = callback;
+	job->ctx = ctx;
+	dev->queue_head++;
+
+	return MEMORY_SUCCESS;
+}
+
+/**
+ * Advance the memory jobs. Must be called periodically, typically from the main
+ * loop.
+ *
+ * Only one I2C transfer runs at a time and the function never waits for it.
+ * After a page is written the memory does not acknowledge its address until
+ * the internal write cycle ends, so a not acknowledged transfer is started
+ * again until the memory answers or MEMORY_POLL_LIMIT is reached. The next
+ * page write is used as the poll, only the last page needs an address only
+ * write.
+ *
+ * @param [in] dev - The device structure.
+ *
+ * @return 0 if no job ended with an error, negative error code otherwise.
+ */
+int32_t memory_process(struct memory_desc *dev)
+{
+	struct memory_job *job;
+	bool done;
+	int32_t ret;
+
+	if(!memory_busy(dev))
+		return MEMORY_SUCCESS;
+
+	job = memory_current_job(dev);
+
+	if(!dev->transfer_pending) {
+		ret = memory_start_transfer(dev);
+		if(ret != MEMORY_SUCCESS)
+			return memory_end_job(dev, ret);
+
+		return MEMORY_SUCCESS;
+	}
+
+	ret = i2c_transfer_done(dev->i2c_dev, &done);
+	if((ret == MEMORY_SUCCESS) && !done)
+		return MEMORY_SUCCESS;
+	dev->transfer_pending = false;
+
+	if(ret != MEMORY_SUCCESS) {
+		/* Not acknowledged while a write cycle may still be running */
+		if(!dev->write_cycle || (dev->polls >= MEMORY_POLL_LIMIT))
+			return memory_end_job(dev, ret);
+		dev->polls++;
+		dev->busy_polls++;
+		ret = memory_start_transfer(dev);
+		if(ret != MEMORY_SUCCESS)
+			return memory_end_job(dev, ret);
+
+		return MEMORY_SUCCESS;
+	}
+
+	dev->polls = 0;
+	job->address += dev->chunk;
+	job->data += dev->chunk;
+	job->size -= dev->chunk;
+
+	/* Reads and acknowledged end of write cycle polls end the job */
+	if((job->type == MEMORY_JOB_READ) || (dev->chunk == 0))
+		return memory_end_job(dev, MEMORY_SUCCESS);
+
+	dev->write_cycle = true;
+	ret = memory_start_transfer(dev);
+	if(ret != MEMORY_SUCCESS)
+		return memory_end_job(dev, ret);
+
+	return MEMORY_SUCCESS;
+}
+
+/**
+ * Check if the memory has any job queued or running.
+ *
+ * @param [in] dev - The device structure.
+ *
+ * @return true if a job is queued or running, false otherwise.
+ */
+bool memory_busy(struct memory_desc *dev)
+{
+	return dev->queue_head != dev->queue_tail;
+}
+
+/**
+ * Queue a write of any number of bytes in EEPROM memory. The write is split at
+ * page boundaries and the function returns immediately, the pages are written
+ * by memory_process().
+ *
+ * @param [in] dev      - The device structure.
+ * @param [in] address  - Address in memory where the first byte is written.
+ * @param [in] data     - Pointer to data to be written. Must stay valid until
+ *                        the job ends.
+ * @param [in] size     - Size of the data array.
+ * @param [in] callback - Function called with the result when the write ends,
+ *                        may be NULL.
+ * @param [in] ctx      - Parameter passed to the callback.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t memory_write_async(struct memory_desc *dev, uint16_t address,
+			   uint8_t *data, uint32_t size,
+			   memory_callback callback, void *ctx)
+{
+	uint16_t shifted_address;
+
+	/* The shifter address is address after the protected memory in which the
+	 * user data can be written */
+	shifted_address = MEMORY_PROTECTED_SIZE + address;
+	if((shifted_address + size) > MEMORY_SIZE_BYTES)
+		return WRITE_SIZE_ERROR;
+
+	return memory_queue_job(dev, MEMORY_JOB_WRITE, shifted_address, data,
+				size, callback, ctx);
+}
+
+/**
+ * Queue a read of any number of bytes from EEPROM memory. The data is read
+ * with a single sequential read by memory_process().
+ *
+ * @param [in] dev      - The device structure.
+ * @param [in] address  - Address in memory of the first byte read.
+ * @param [out] data    - Pointer to the buffer for the read data. Must stay
+ *                        valid until the job ends.
+ * @param [in] size     - Size of the data array.
+ * @param [in] callback - Function called with the result when the read ends,
+ *                        may be NULL.
+ * @param [in] ctx      - Parameter passed to the callback.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t memory_read_async(struct memory_desc *dev, uint16_t address,
+			  uint8_t *data, uint32_t size,
+			  memory_callback callback, void *ctx)
+{
+	uint16_t shifted_address;
+
+	/* The shifter address is address after the protected memory in which the
+	 * user data can be written */
+	shifted_address = MEMORY_PROTECTED_SIZE + address;
+	if((shifted_address + size) > MEMORY_SIZE_BYTES)
+		size = MEMORY_SIZE_BYTES - shifted_address;
+
+	return memory_queue_job(dev, MEMORY_JOB_READ, shifted_address, data, size,
+				callback, ctx);
+}
+
+/**
+ * Callback of the blocking functions, saves the job result.
+ *
+ * @param [in] ctx    - Pointer to the result variable.
+ * @param [in] status - Result of the job.
+ *
+ * @return void
+ */
+static void memory_sync_callback(void *ctx, int32_t status)
+{
+	*(int32_t *)ctx = status;
+}
+
+/**
+ * Queue a job and process the memory until it ends.
+ *
+ * @param [in] dev     - The device structure.
+ * @param [in] type    - Read or write job.
+ * @param [in] address - Absolute address in memory of the first byte.
+ * @param [in] data    - Data buffer.
+ * @param [in] size    - Size of the data array.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+static int32_t memory_run_job(struct memory_desc *dev,
+			      enum memory_job_type type, uint16_t address,
+			      uint8_t *data, uint32_t size)
+{
+	volatile int32_t status = MEMORY_BUSY_ERROR;
+	int32_t ret;
+
+	ret = memory_queue_job(dev, type, address, data, size,
+			       memory_sync_callback, (void *)&status);
+	if(ret != MEMORY_SUCCESS)
+		return ret;
+
+	while(status == MEMORY_BUSY_ERROR)
+		memory_process(dev);
+
+	return status;
+}
+
 /**
  * Writes a number of bytes to memory provided the data does not exceed page
- * boundaries. At the start of the buffer is placed the address at which the
- * write will take place. The write size cannot exceed remaining page size.
- * Maximum page size is 32 bytes. If the size of the write would exceed the
- * remaining size of the page, the function exits with negative error code.
+ * boundaries. The write size cannot exceed remaining page size. Maximum page
+ * size is 32 bytes. If the size of the write would exceed the remaining size
+ * of the page, the function exits with negative error code. The function
+ * returns after the memory ended its write cycle.
  *
  * @param [in] dev     - The device structure.
  * @param [in] address - Address in memory where the first byte is written.
@@ -125,8 +425,6 @@ int32_t memory_remove(struct memory_desc *dev)
 int32_t memory_write_within_page(struct memory_desc *dev, uint16_t address,
 				 uint8_t *data, uint32_t size)
 {
-	int32_t ret;
-	uint8_t *transmit_array, i;
 	uint32_t page_remainder;
 
 	/* If the write would exceed page bounds return to avoid corrupting
@@ -136,32 +434,13 @@ int32_t memory_write_within_page(struct memory_desc *dev, uint16_t address,
 	if(page_remainder < size)
 		return WRITE_SIZE_ERROR;
 
-	transmit_array = calloc(size + 2, sizeof(uint8_t));
-	if (!transmit_array)
-		return -1;
-
-	transmit_array[0] = (address & 0xff00) >> 8;
-	transmit_array[1] = (address & 0x00ff) >> 0;
-
-	for(i = 0; i < size; i++)
-		transmit_array[i + 2] = data[i];
-
-	/* Do not test if ret is equal to zero faster than the end of the function
-	 * because the "catch" branch would have been the same as the success one */
-	ret = i2c_write(dev->i2c_dev, transmit_array, size + 2, true);
-
-	free(transmit_array);
-
-	mdelay(5);
-
-	return ret;
+	return memory_run_job(dev, MEMORY_JOB_WRITE, address, data, size);
 }
 
 /**
- * Writes any number of bytes in EEPROM memory. This function utilizes the
- * memory_write_within_page function and instead of exiting if the write size is
- * too big it splits the write in multiple writes so that it is correctly
- * written in the memory.
+ * Writes any number of bytes in EEPROM memory. The write is split in page
+ * writes so that it is correctly written in the memory. The function returns
+ * after the memory ended the last write cycle.
  *
  * @param [in] dev     - The device structure.
  * @param [in] address - Address in memory where the first byte is written.
@@ -173,9 +452,6 @@ int32_t memory_write_within_page(struct memory_desc *dev, uint16_t address,
 int32_t memory_write(struct memory_desc *dev, uint16_t address, uint8_t *data,
 		     uint32_t size)
 {
-	int32_t ret;
-	uint32_t page_remainder;
-	uint8_t done = 0;
 	uint16_t shifted_address;
 
 	/* The shifter address is address after the protected memory in which the
@@ -184,36 +460,17 @@ int32_t memory_write(struct memory_desc *dev, uint16_t address, uint8_t *data,
 	if((shifted_address + size) > MEMORY_SIZE_BYTES)
 		return WRITE_SIZE_ERROR;
 
-	do {
-		page_remainder = shifted_address % WRITE_SIZE_LIMIT;
-		page_remainder = WRITE_SIZE_LIMIT - page_remainder;
-
-		if(page_remainder > size) {
-			ret = memory_write_within_page(dev, shifted_address, data, size);
-			if(ret != MEMORY_SUCCESS)
-				return ret;
-			done = 1;
-		} else {
-			ret = memory_write_within_page(dev, shifted_address, data,
-						       page_remainder);
-			if(ret != MEMORY_SUCCESS)
-				return ret;
-			data += page_remainder;
-			shifted_address += page_remainder;
-			size -= page_remainder;
-		}
-	} while(done == 0);
-
-	return ret;
+	return memory_run_job(dev, MEMORY_JOB_WRITE, shifted_address, data,
+			      size);
 }
 
 /**
  * Read any number of bytes from EEPROM memory. The read can be any number of
- * bytes. Before the read is done the memory index must be placed at the desired
- * location using a write with a repead start then a read.
+ * bytes. The memory index is placed at the desired location by the transfer
+ * prologue, followed by a repeated start and a sequential read.
  *
  * @param [in] dev     - The device structure.
- * @param [in] address - Address in memory where the first byte is written.
+ * @param [in] address - Address in memory of the first byte read.
  * @param [out] data   - Pointer to the buffer for the read data.
  * @param [in] size    - Size of the data array.
  *
@@ -222,8 +479,6 @@ int32_t memory_write(struct memory_desc *dev, uint16_t address, uint8_t *data,
 int32_t memory_read(struct memory_desc *dev, uint16_t address, uint8_t *data,
 		    uint32_t size)
 {
-	int32_t ret;
-	uint8_t *transmit_array;
 	uint16_t shifted_address;
 
 	/* The shifter address is address after the protected memory in which the
@@ -232,23 +487,7 @@ int32_t memory_read(struct memory_desc *dev, uint16_t address, uint8_t *data,
 	if((shifted_address + size) > MEMORY_SIZE_BYTES)
 		size = MEMORY_SIZE_BYTES - shifted_address;
 
-	transmit_array = calloc(2, sizeof(uint8_t));
-	if (!transmit_array)
-		return -1;
-
-	transmit_array[0] = (shifted_address & 0xff00) >> 8;
-	transmit_array[1] = (shifted_address & 0x00ff) >> 0;
-
-	ret = i2c_write(dev->i2c_dev, transmit_array, 2, false);
-	if(ret != MEMORY_SUCCESS)
-		goto finish;
-
-	ret = i2c_read(dev->i2c_dev, data, size, true);
-
-finish:
-	free(transmit_array);
-
-	return ret;
+	return memory_run_job(dev, MEMORY_JOB_READ, shifted_address, data, size);
 }
 
 /**
@@ -257,10 +496,14 @@ finish:
  * @param [in] dev     - The device structure.
  * @param [in] address - New I2C address.
  *
- * @return 0 in case of success, negative error code otherwise.
+ * @return 0 in case of success, MEMORY_BUSY_ERROR if a job is queued or
+ *         running, negative error code otherwise.
  */
 int32_t memory_change_i2c_address(struct memory_desc *dev, uint8_t address)
 {
+	if(memory_busy(dev))
+		return MEMORY_BUSY_ERROR;
+
 	dev->i2c_address = 0x50 | address;
 	return i2c_set_address(dev->i2c_dev, dev->i2c_address);
 }
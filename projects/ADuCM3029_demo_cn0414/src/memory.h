@@ -44,12 +44,20 @@
 /***************************** Include Files **********************************/
 /******************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "platform_drivers.h"
 
 #define WRITE_SIZE_LIMIT 32
 #define WRITE_SIZE_ERROR -2
 #define MEMORY_SIZE_BYTES 4096
 #define MEMORY_PROTECTED_SIZE 2048
+#define MEMORY_BUSY_ERROR -3
+
+/* Number of jobs that can wait in the memory queue */
+#define MEMORY_QUEUE_SIZE 4
+/* Address polls before a write cycle is considered failed. At 400 kHz a poll
+ * takes about 70 us, so this is well above the 5 ms maximum write cycle. */
+#define MEMORY_POLL_LIMIT 500
 
 #define A0_VDD 0x1
 #define A1_VDD 0x2
@@ -63,9 +71,34 @@
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
+typedef void (*memory_callback)(void *ctx, int32_t status);
+
+enum memory_job_type {
+	MEMORY_JOB_WRITE,
+	MEMORY_JOB_READ
+};
+
+struct memory_job {
+	enum memory_job_type type;
+	uint16_t address; /* Absolute address of the next byte */
+	uint8_t *data;
+	uint32_t size; /* Bytes left to transfer */
+	memory_callback callback; /* Called when the job ends, may be NULL */
+	void *ctx;
+};
+
 struct memory_desc {
 	struct i2c_desc *i2c_dev;
 	uint8_t i2c_address; /* Address of the slave */
+	struct memory_job queue[MEMORY_QUEUE_SIZE];
+	uint8_t queue_head;
+	uint8_t queue_tail;
+	bool transfer_pending; /* An I2C transfer of the current job is running */
+	bool write_cycle; /* The memory may be busy with an internal write cycle */
+	uint8_t address_buff[2]; /* Prologue of the running transfer */
+	uint16_t chunk; /* Size of the running transfer */
+	uint16_t polls; /* Address polls of the current write cycle */
+	uint32_t busy_polls; /* Total address polls not acknowledged */
 };
 
 struct memory_init_param {
@@ -97,6 +130,22 @@ int32_t memory_write(struct memory_desc *dev, uint16_t address, uint8_t *data,
 int32_t memory_read(struct memory_desc *dev, uint16_t address, uint8_t *data,
 		    uint32_t size);
 
+/* Queue a write of any number of bytes in EEPROM memory. */
+int32_t memory_write_async(struct memory_desc *dev, uint16_t address,
+			   uint8_t *data, uint32_t size,
+			   memory_callback callback, void *ctx);
+
+/* Queue a read of any number of bytes from EEPROM memory. */
+int32_t memory_read_async(struct memory_desc *dev, uint16_t address,
+			  uint8_t *data, uint32_t size,
+			  memory_callback callback, void *ctx);
+
+/* Advance the memory jobs. Must be called periodically. */
+int32_t memory_process(struct memory_desc *dev);
+
+/* Check if the memory has any job queued or running. */
+bool memory_busy(struct memory_desc *dev);
+
 /* Change the I2C address used in comunication with the memory. */
 int32_t memory_change_i2c_address(struct memory_desc *dev, uint8_t address);
 
@@ -201,6 +201,17 @@ int32_t i2c_read(i2c_desc *desc,
 /* Set address that the device is sending before a transaction. */
 int32_t i2c_set_address(i2c_desc *desc, uint8_t new_address);
 
+/* Start a transfer with a slave device without waiting for it to end. */
+int32_t i2c_transfer_nonblocking(i2c_desc *desc,
+				 uint8_t *prologue,
+				 uint8_t prologue_size,
+				 uint8_t *data,
+				 uint16_t bytes_number,
+				 bool read);
+
+/* Check if the transfer started by i2c_transfer_nonblocking() is done. */
+int32_t i2c_transfer_done(i2c_desc *desc, bool *done);
+
 /* Initialize the SPI communication peripheral. */
 int32_t spi_init(spi_desc **desc,
 		 const spi_init_param *param);
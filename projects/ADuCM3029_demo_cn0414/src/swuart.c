@@ -50,49 +50,169 @@
 /******************************************************************************/
 extern uint8_t gpio_init_flag;
 extern uint8_t mem_gpio_handler[ADI_GPIO_MEMORY_SIZE];
-volatile bool rec_flag = false; /* HART receive flag */
-volatile uint32_t delay_flag = 0;
 
 /******************************************************************************/
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
 /**
- * Delay for half of the software UART baudrate period using the timer assigned
- * to the software UART. Load the timer, start counting, wait vfor the timer
- * interrupt and then deactivate the timer.
+ * Advance the RX state machine by one oversampling tick.
+ *
+ * In idle the line is checked on every tick for the falling edge of the start
+ * bit. The start bit is checked again half a bit later, to reject glitches,
+ * and from there every bit is sampled once per bit period, in its middle. The
+ * byte is stored in the RX FIFO together with the parity and framing error
+ * flags.
+ *
+ * @param [in] dev   - The device structure.
+ * @param [in] level - Level of the RX line.
+ *
+ * @return none
+ */
+static void swuart_rx_tick(struct swuart_dev *dev, uint8_t level)
+{
+	switch(dev->rx_state) {
+	case SWUART_IDLE:
+		if(level == 0) {
+			dev->rx_ticks = SWUART_OVERSAMPLE / 2;
+			dev->rx_state = SWUART_START;
+		}
+		return;
+	case SWUART_BREAK:
+		if(level != 0)
+			dev->rx_state = SWUART_IDLE;
+		return;
+	default:
+		break;
+	}
+
+	if(--dev->rx_ticks != 0)
+		return;
+	dev->rx_ticks = SWUART_OVERSAMPLE;
+
+	switch(dev->rx_state) {
+	case SWUART_START:
+		if(level != 0) {
+			dev->rx_state = SWUART_IDLE;
+			break;
+		}
+		dev->rx_shift = 0;
+		dev->rx_bit = 0;
+		dev->rx_parity = (dev->parity == UART_ODD_PARITY) ? 1 : 0;
+		dev->rx_state = SWUART_DATA;
+		break;
+	case SWUART_DATA:
+		if(level != 0) {
+			dev->rx_shift |= (1 << dev->rx_bit);
+			dev->rx_parity++;
+		}
+		dev->rx_bit++;
+		if(dev->rx_bit == dev->no_of_bits) {
+			if(dev->parity == UART_NO_PARITY)
+				dev->rx_state = SWUART_STOP;
+			else
+				dev->rx_state = SWUART_PARITY;
+		}
+		break;
+	case SWUART_PARITY:
+		if((level != 0) != ((dev->rx_parity & 0x01) != 0)) {
+			dev->rx_shift |= SWUART_PARITY_ERROR;
+			dev->parity_errors++;
+		}
+		dev->rx_state = SWUART_STOP;
+		break;
+	case SWUART_STOP:
+		/* The next start bit may come in the second half of the stop bit */
+		dev->rx_state = SWUART_IDLE;
+		if(level == 0) {
+			dev->rx_shift |= SWUART_FRAMING_ERROR;
+			dev->framing_errors++;
+			dev->rx_state = SWUART_BREAK;
+		}
+		if((dev->rx_head - dev->rx_tail) == SWUART_FIFO_SIZE) {
+			dev->overruns++;
+			break;
+		}
+		dev->rx_fifo[dev->rx_head & (SWUART_FIFO_SIZE - 1)] = dev->rx_shift;
+		dev->rx_head++;
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * Advance the TX state machine by one oversampling tick.
+ *
+ * When idle the next byte is taken from the TX FIFO and the whole frame, start
+ * bit, data bits LSB first, parity and stop bit, is built in a shift register
+ * that is then shifted out one bit every bit period.
  *
  * @param [in] dev - The device structure.
  *
- * @return 0 in case of success, negative error code otherwise.
+ * @return The level to drive on the TX line.
  */
-static inline void swuart_delay(struct swuart_dev *dev, uint32_t usec)
+static uint8_t swuart_tx_tick(struct swuart_dev *dev)
 {
-	NVIC_EnableIRQ(TMR1_EVT_IRQn);
-	delay_flag = usec;
-	while(delay_flag != 0);
-	NVIC_DisableIRQ(TMR1_EVT_IRQn);
+	uint8_t data, parity, i;
+
+	if(dev->tx_state != SWUART_IDLE) {
+		if(--dev->tx_ticks != 0)
+			return dev->tx_shift & 0x01;
+		dev->tx_shift >>= 1;
+		dev->tx_bits--;
+		if(dev->tx_bits != 0) {
+			dev->tx_ticks = SWUART_OVERSAMPLE;
+			return dev->tx_shift & 0x01;
+		}
+		dev->tx_state = SWUART_IDLE;
+	}
+
+	if(dev->tx_head == dev->tx_tail)
+		return 1;
+
+	data = dev->tx_fifo[dev->tx_tail & (SWUART_FIFO_SIZE - 1)];
+	dev->tx_tail++;
+
+	dev->tx_shift = (data & ((1 << dev->no_of_bits) - 1)) << 1;
+	dev->tx_bits = dev->no_of_bits + 2;
+	if(dev->parity != UART_NO_PARITY) {
+		parity = (dev->parity == UART_ODD_PARITY) ? 1 : 0;
+		for(i = 0; i < dev->no_of_bits; i++)
+			parity += (data >> i) & 0x01;
+		dev->tx_shift |= (parity & 0x01) << (dev->no_of_bits + 1);
+		dev->tx_bits++;
+	}
+	dev->tx_shift |= 1 << (dev->tx_bits - 1);
+	dev->tx_ticks = SWUART_OVERSAMPLE;
+	dev->tx_state = SWUART_DATA;
+
+	return dev->tx_shift & 0x01;
 }
 
 /**
- * Software UART RX interrupt callback function. This interrupt is associated
- * with the Group A GPIOs, which is set to include the RX pin. The interrupt is
- * used to wait for the start bit in the read function.
+ * Advance the TX and RX bit state machines by one oversampling tick.
  *
- * @param [in] pCBParam - Pointer to callback parameter list.
- * @param [in] nEvent   - Interrupt source identifier.
- * @param [in/out] pArg - Random argument list.(chosen by the application)
+ * This is the hardware independent part of the driver, called from the timer
+ * interrupt. Feeding it a recorded RX waveform, one sample per tick, replays
+ * the reception exactly as it happens on the board.
  *
- * @return none
+ * @param [in] dev      - The device structure.
+ * @param [in] rx_level - Level of the RX line.
+ *
+ * @return The level to drive on the TX line.
  */
-static void software_uart_callback(void *pCBParam, uint32_t nEvent, void *pArg)
+uint8_t swuart_tick(struct swuart_dev *dev, uint8_t rx_level)
 {
-	rec_flag = true;
+	dev->ticks++;
+	swuart_rx_tick(dev, rx_level);
+
+	return swuart_tx_tick(dev);
 }
 
 /**
- * Software UART timer interrupt callback function. The timer is used to
- * implement the timing for the protocol.
+ * Software UART timer interrupt callback function. The timer runs at
+ * SWUART_OVERSAMPLE times the baudrate and clocks the bit state machines.
  *
  * @param [in] pCBParam - Pointer to callback parameter list.
  * @param [in] nEvent   - Interrupt source identifier.
@@ -100,10 +220,27 @@ static void software_uart_callback(void *pCBParam, uint32_t nEvent, void *pArg)
  *
  * @return none
  */
-static void timer0_delay_callback(void *pCBParam, uint32_t nEvent, void *pArg)
+static void swuart_timer_callback(void *pCBParam, uint32_t nEvent, void *pArg)
 {
-	if(delay_flag != 0)
-		delay_flag--;
+	struct swuart_dev *dev = pCBParam;
+	uint16_t val;
+	uint8_t level;
+
+	adi_gpio_GetData(dev->rx_port_pin.port_number,
+			 dev->rx_port_pin.pin_number, &val);
+
+	level = swuart_tick(dev, (val != 0));
+
+	/* Only touch the pin on a change so it can be driven by hand when idle */
+	if(level == dev->tx_level)
+		return;
+	if(level)
+		adi_gpio_SetHigh(dev->tx_port_pin.port_number,
+				 dev->tx_port_pin.pin_number);
+	else
+		adi_gpio_SetLow(dev->tx_port_pin.port_number,
+				dev->tx_port_pin.pin_number);
+	dev->tx_level = level;
 }
 
 /**
@@ -119,7 +256,6 @@ int32_t swuart_init(struct swuart_dev **device, struct swuart_init *init_param)
 {
 	int32_t ret;
 	struct swuart_dev *dev;
-	uint16_t val = 0;
 	ADI_TMR_CONFIG delay_timer_config;
 
 	dev = calloc(1, sizeof *dev);
@@ -136,7 +272,11 @@ int32_t swuart_init(struct swuart_dev **device, struct swuart_init *init_param)
 	dev->no_of_bits = init_param->no_of_bits;
 	dev->parity = init_param->parity;
 	dev->delay_timer = init_param->delay_timer;
-	dev->half_period = (uint16_t)((SECOND_LOAD_TIMER / dev->baudrate) / 2);
+	dev->tick_load = (uint16_t)(SWUART_TIMER_CLK /
+				    (dev->baudrate * SWUART_OVERSAMPLE));
+	dev->rx_state = SWUART_IDLE;
+	dev->tx_state = SWUART_IDLE;
+	dev->tx_level = 1;
 
 	if(gpio_init_flag == 0) {
 		ret = adi_gpio_Init(mem_gpio_handler, ADI_GPIO_MEMORY_SIZE);
@@ -146,16 +286,6 @@ int32_t swuart_init(struct swuart_dev **device, struct swuart_init *init_param)
 
 	gpio_init_flag++;
 
-	ret = adi_gpio_RegisterCallback(ADI_GPIO_INTA_IRQ, software_uart_callback,
-					NULL);
-	if(ret != ADI_GPIO_SUCCESS)
-		goto error;
-
-	ret = adi_gpio_SetGroupInterruptPolarity(dev->rx_port_pin.port_number,
-			~dev->rx_port_pin.pin_number);
-	if(ret != ADI_GPIO_SUCCESS)
-		goto error;
-
 	ret = adi_gpio_InputEnable(dev->rx_port_pin.port_number,
 				   dev->rx_port_pin.pin_number, true);
 	if(ret != ADI_GPIO_SUCCESS)
@@ -176,20 +306,7 @@ int32_t swuart_init(struct swuart_dev **device, struct swuart_init *init_param)
 	if(ret != ADI_GPIO_SUCCESS)
 		goto error;
 
-	ret = adi_gpio_GetGroupInterruptPins(dev->rx_port_pin.port_number,
-					     ADI_GPIO_INTA_IRQ,  &val);
-	if(ret != ADI_GPIO_SUCCESS)
-		goto error;
-	val |= dev->rx_port_pin.pin_number;
-	ret = adi_gpio_SetGroupInterruptPins(dev->rx_port_pin.port_number,
-					     ADI_GPIO_INTA_IRQ, val);
-	if(ret != ADI_GPIO_SUCCESS)
-		goto error;
-
-	/* Disable interrupt */
-	NVIC_DisableIRQ(RX_INT);
-
-	ret = adi_tmr_Init(dev->delay_timer, timer0_delay_callback, dev, true);
+	ret = adi_tmr_Init(dev->delay_timer, swuart_timer_callback, dev, true);
 	if(ret != ADI_TMR_SUCCESS)
 		goto error;
 
@@ -199,21 +316,19 @@ int32_t swuart_init(struct swuart_dev **device, struct swuart_init *init_param)
 	delay_timer_config.bReloading = false;
 	delay_timer_config.bSyncBypass = true;
 	delay_timer_config.eClockSource = ADI_TMR_CLOCK_PCLK;
-	delay_timer_config.nLoad = 260;
-	delay_timer_config.nAsyncLoad = 260;
+	delay_timer_config.nLoad = dev->tick_load;
+	delay_timer_config.nAsyncLoad = dev->tick_load;
 	delay_timer_config.ePrescaler = 0;
 
-	/* Configure delay timer */
+	/* Configure bit timer */
 	ret = adi_tmr_ConfigTimer(dev->delay_timer, &delay_timer_config);
 	if(ret != ADI_TMR_SUCCESS)
-		return ret;
-
-	NVIC_DisableIRQ(TMR1_EVT_IRQn);
+		goto error;
 
-	/* Configure delay timer */
+	/* The bit timer runs all the time to catch the start bits */
 	ret = adi_tmr_Enable(dev->delay_timer, true);
 	if(ret != ADI_TMR_SUCCESS)
-		return ret;
+		goto error;
 
 	*device = dev;
 
@@ -236,6 +351,10 @@ int32_t swuart_remove(struct swuart_dev *dev)
 {
 	int32_t ret;
 
+	ret = adi_tmr_Enable(dev->delay_timer, false);
+	if(ret != ADI_TMR_SUCCESS)
+		return ret;
+
 	gpio_init_flag--;
 
 	/* If this is the first GPIO initialize GPIO controller */
@@ -251,201 +370,129 @@ int32_t swuart_remove(struct swuart_dev *dev)
 }
 
 /**
- * The function implements a read/write operation through software UART started
- * by the application. The UART transmit considers the parameters number of bits
- * per byte and parity.
+ * Queue a character for transmission. The character is sent in the background
+ * by the timer interrupt. The function waits only if the TX FIFO is full.
  *
- * @param [in] dev	     - The device structure.
- * @param [in/out] sbyte - Pointer to the byte to be transmitted and replaced
- *                         with the received one.
+ * @param [in] dev	 - The device structure.
+ * @param [in] sbyte - Pointer to the byte to be transmitted.
  *
  * @return 0 in case of success, negative error code otherwise.
  */
 int32_t swuart_write_char(struct swuart_dev *dev, uint8_t *sbyte)
 {
-	uint16_t val = 0;
-	int32_t ret = 0;
-	uint8_t parity_tx, parity_rx, i;
-
-	/* Parity initialize */
-	if(dev->parity == UART_EVEN_PARITY) {
-		parity_tx = 0;
-		parity_rx = 0;
-	} else {
-		parity_tx = 1;
-		parity_rx = 1;
-	}
+	while((dev->tx_head - dev->tx_tail) == SWUART_FIFO_SIZE);
 
-	/* Transmit a byte and receive one full-duplex */
-	adi_gpio_SetLow(dev->tx_port_pin.port_number, dev->tx_port_pin.pin_number);
-	swuart_delay(dev, dev->half_period);
-	swuart_delay(dev, dev->half_period);
-	for(i = 0; i < dev->no_of_bits; i++) {
-		if((*sbyte & 0x01) == 0x01) {
-			adi_gpio_SetHigh(dev->tx_port_pin.port_number,
-					 dev->tx_port_pin.pin_number);
-			parity_tx += 1;
-		} else {
-			adi_gpio_SetLow(dev->tx_port_pin.port_number,
-					dev->tx_port_pin.pin_number);
-		}
-		*sbyte = *sbyte >> 1;
-		*sbyte &= 0x7F;
-		swuart_delay(dev, dev->half_period);
-
-		adi_gpio_GetData(dev->rx_port_pin.port_number,
-				 dev->rx_port_pin.pin_number, &val);
-		if(val == 0) {
-			*sbyte |= 0x00;
-		} else {
-			*sbyte |= 0x80;
-			parity_rx += 1;
-		}
-		swuart_delay(dev, dev->half_period);
-	}
+	dev->tx_fifo[dev->tx_head & (SWUART_FIFO_SIZE - 1)] = *sbyte;
+	dev->tx_head++;
 
-	if(dev->parity != UART_NO_PARITY) {
-		if(parity_tx & 0x01)
-			adi_gpio_SetHigh(dev->tx_port_pin.port_number,
-					 dev->tx_port_pin.pin_number);
-		else
-			adi_gpio_SetLow(dev->tx_port_pin.port_number,
-					dev->tx_port_pin.pin_number);
-		swuart_delay(dev, dev->half_period);
-		/* Get parity and check it */
-		adi_gpio_GetData(dev->rx_port_pin.port_number,
-				 dev->rx_port_pin.pin_number, &val);
-		if(((val == 0) && ((parity_rx & 0x01) != 0)) ||
-		    ((val != 0) && ((parity_rx & 0x01) == 0)))
-			ret |= -1;
-		swuart_delay(dev, dev->half_period);
-	}
+	return 0;
+}
+
+/**
+ * Get a received character from the RX FIFO without waiting.
+ *
+ * @param [in] dev     - The device structure.
+ * @param [out] rbyte - Pointer to the received byte.
+ *
+ * @return 0 in case of success, SWUART_NO_DATA if the FIFO is empty, -1 if the
+ *         character was received with a parity or framing error.
+ */
+int32_t swuart_get_char(struct swuart_dev *dev, uint8_t *rbyte)
+{
+	uint16_t data;
 
-	adi_gpio_SetHigh(dev->tx_port_pin.port_number,
-			 dev->tx_port_pin.pin_number);
+	if(dev->rx_head == dev->rx_tail)
+		return SWUART_NO_DATA;
 
-	*sbyte = *sbyte >> (8 - dev->no_of_bits);
+	data = dev->rx_fifo[dev->rx_tail & (SWUART_FIFO_SIZE - 1)];
+	dev->rx_tail++;
 
-	return ret;
+	*rbyte = data & 0xFF;
+	if(data & (SWUART_PARITY_ERROR | SWUART_FRAMING_ERROR))
+		return -1;
+
+	return 0;
 }
 
 /**
- * The function implements a read/write operation through software UART started
- * by another device and not the application. The UART transmit considers the
- * parameters number of bits per byte and parity. The main difference is that
- * this transmission waits for the start bit of the other participant before
- * giving it's own.
+ * Wait for a received character or until SWUART_READ_TIMEOUT bit periods pass.
  *
- * @param [in] dev	     - The device structure.
- * @param [in/out] sbyte - Pointer to the byte to be transmitted and replaced
- *                         with the received one.
+ * @param [in] dev     - The device structure.
+ * @param [out] rbyte - Pointer to the received byte.
  *
- * @return 0 in case of success, negative error code otherwise.
+ * @return 0 in case of success, SWUART_NO_DATA on timeout, -1 if the character
+ *         was received with a parity or framing error.
  */
 int32_t swuart_read_char(struct swuart_dev *dev, uint8_t *rbyte)
 {
-	int32_t ret = 0;
-	uint32_t timeout = 1370;
-	uint16_t val;
-	uint8_t parity_tx, parity_rx, i;
-
-	if(dev->parity == UART_EVEN_PARITY) {
-		parity_tx = 0;
-		parity_rx = 0;
-	} else {
-		parity_tx = 1;
-		parity_rx = 1;
-	}
-
-	rec_flag = false;
-
-	/* Disable interrupt */
-	NVIC_EnableIRQ(RX_INT);
+	int32_t ret;
+	uint32_t start = dev->ticks;
 
-	/* Wait for the start bit or timeout */
 	do {
-		swuart_delay(dev, 1);
-		timeout--;
-	} while((rec_flag == false) && (timeout != 0));
-	/* Error if no transmission */
-	if(timeout == 0) {
-		ret = 1;
-		goto finish;
-	}
-
-	adi_gpio_SetLow(dev->tx_port_pin.port_number,
-			dev->tx_port_pin.pin_number);
-	/* Do transmission */
-	swuart_delay(dev, dev->half_period);
-	adi_gpio_GetData(dev->rx_port_pin.port_number,
-			 dev->rx_port_pin.pin_number,
-			 &val);
-	if(val) {
-		ret = 1;
-		goto finish;
-	}
-	swuart_delay(dev, dev->half_period);
-	for(i = 0; i < dev->no_of_bits; i++) {
-		if((*rbyte & 0x01) == 0x01) {
-			adi_gpio_SetHigh(dev->tx_port_pin.port_number,
-					 dev->tx_port_pin.pin_number);
-			parity_tx += 1;
-		} else {
-			adi_gpio_SetLow(dev->tx_port_pin.port_number,
-					dev->tx_port_pin.pin_number);
-		}
-		*rbyte = *rbyte >> 1;
-		*rbyte &= 0x7F;
-		swuart_delay(dev, dev->half_period);
-		adi_gpio_GetData(dev->rx_port_pin.port_number,
-				 dev->rx_port_pin.pin_number,
-				 &val);
-		if(val == 0) {
-			*rbyte |= 0x00;
-		} else {
-			*rbyte |= 0x80;
-			parity_rx += 1;
-		}
-		swuart_delay(dev, dev->half_period);
-	}
+		ret = swuart_get_char(dev, rbyte);
+		if(ret != SWUART_NO_DATA)
+			return ret;
+	} while((dev->ticks - start) <
+		(SWUART_READ_TIMEOUT * SWUART_OVERSAMPLE));
 
-	if(dev->parity != UART_NO_PARITY) {
-		if(parity_tx & 0x01)
-			/* Transmit parity */
-			adi_gpio_SetHigh(dev->tx_port_pin.port_number,
-					 dev->tx_port_pin.pin_number);
-		else
-			adi_gpio_SetLow(dev->tx_port_pin.port_number,
-					dev->tx_port_pin.pin_number);
-		swuart_delay(dev, dev->half_period);
-		/* Get parity and check it */
-		adi_gpio_GetData(dev->rx_port_pin.port_number,
-				 dev->rx_port_pin.pin_number, &val);
-		if(((val == 0) && ((parity_rx & 0x01) != 0)) ||
-		    ((val != 0) && ((parity_rx & 0x01) == 0)))
-			ret |= -1;
-		swuart_delay(dev, dev->half_period);
-	}
+	return SWUART_NO_DATA;
+}
 
-	*rbyte = *rbyte >> (8 - dev->no_of_bits);
+/**
+ * Get the number of characters waiting in the RX FIFO.
+ *
+ * @param [in] dev - The device structure.
+ *
+ * @return The number of characters.
+ */
+uint32_t swuart_rx_available(struct swuart_dev *dev)
+{
+	return dev->rx_head - dev->rx_tail;
+}
 
-finish:
-	adi_gpio_SetHigh(dev->tx_port_pin.port_number,
-			 dev->tx_port_pin.pin_number);
+/**
+ * Check if a character is being received.
+ *
+ * @param [in] dev - The device structure.
+ *
+ * @return true if the RX state machine is inside a character, false otherwise.
+ */
+bool swuart_rx_busy(struct swuart_dev *dev)
+{
+	return (dev->rx_state != SWUART_IDLE) && (dev->rx_state != SWUART_BREAK);
+}
 
-	/* Disable interrupt */
-	NVIC_DisableIRQ(RX_INT);
+/**
+ * Check if there are characters left to transmit.
+ *
+ * @param [in] dev - The device structure.
+ *
+ * @return true until the stop bit of the last queued character is sent.
+ */
+bool swuart_tx_busy(struct swuart_dev *dev)
+{
+	return (dev->tx_head != dev->tx_tail) || (dev->tx_state != SWUART_IDLE);
+}
 
-	return ret;
+/**
+ * Drop all the characters in the RX FIFO.
+ *
+ * @param [in] dev - The device structure.
+ *
+ * @return none
+ */
+void swuart_rx_flush(struct swuart_dev *dev)
+{
+	dev->rx_tail = dev->rx_head;
 }
 
 /**
- * Write a string of bytes through the software UART.
+ * Write a string of bytes through the software UART and wait until the last
+ * stop bit is sent, so the caller can release the line right after.
  *
- * @param [in] dev        - The device structure.
- * @param [in/out] string - Pointer to the string to be transmitted and replaced
- *                          with the received one.
- * @param [in] size	      - The device structure.
+ * @param [in] dev    - The device structure.
+ * @param [in] string - Pointer to the string to be transmitted.
+ * @param [in] size   - Number of bytes to transmit.
  *
  * @return 0 in case of success, negative error code otherwise.
  */
@@ -459,20 +506,19 @@ int32_t swuart_write_string(struct swuart_dev *dev, uint8_t *string,
 		check = swuart_write_char(dev, &string[i]);
 		if(check != 0)
 			return check;
-		swuart_delay(dev, dev->half_period);
-		swuart_delay(dev, dev->half_period);
 	}
 
-	return check;
+	while(swuart_tx_busy(dev));
+
+	return 0;
 }
 
 /**
  * Read a string of bytes through the software UART.
  *
- * @param [in] dev        - The device structure.
- * @param [in/out] string - Pointer to the string to be transmitted and replaced
- *                          with the received one.
- * @param [in] size	      - The device structure.
+ * @param [in] dev     - The device structure.
+ * @param [out] string - Pointer to the buffer for the received bytes.
+ * @param [in] size    - Number of bytes to read.
  *
  * @return 0 in case of success, negative error code otherwise.
  */
@@ -480,7 +526,7 @@ int32_t swuart_read_string(struct swuart_dev *dev, uint8_t *string,
 			   uint32_t size)
 {
 	uint32_t i;
-	int32_t check;
+	int32_t check = 0;
 
 	for(i = 0; i < size; i++) {
 		check = swuart_read_char(dev, &string[i]);
@@ -46,9 +46,26 @@
 #include "drivers/gpio/adi_gpio.h"
 #include "drivers/tmr/adi_tmr.h"
 #include <stdint.h>
+#include <stdbool.h>
 
 #define udelay timer_sleep
-#define SECOND_LOAD_TIMER 100000
+
+/* Clock of the bit timer */
+#define SWUART_TIMER_CLK 26000000
+/* Bit timer ticks per bit. Start bits are detected within 1/8 of a bit and the
+ * data is sampled in the middle of the bit. */
+#define SWUART_OVERSAMPLE 8
+/* Size of the TX and RX FIFOs. Must be a power of 2. */
+#define SWUART_FIFO_SIZE 128
+/* Time swuart_read_char() waits for a character, in bit periods */
+#define SWUART_READ_TIMEOUT 16
+
+/* Receive error flags stored with every byte in the RX FIFO */
+#define SWUART_PARITY_ERROR  (1 << 8)
+#define SWUART_FRAMING_ERROR (1 << 9)
+
+/* Return value of the non-blocking read when no character is available */
+#define SWUART_NO_DATA 1
 
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
@@ -92,6 +109,17 @@ enum uart_parity {
 	UART_NO_PARITY
 };
 
+/* Software UART bit state machine states */
+enum swuart_state {
+	SWUART_IDLE,
+	SWUART_START,
+	SWUART_DATA,
+	SWUART_PARITY,
+	SWUART_STOP,
+	/* Wait for the line to return to idle after a framing error */
+	SWUART_BREAK
+};
+
 /* UART number of bits */
 enum uart_bit_no {
 	UART_5_BITS = 5,
@@ -137,8 +165,32 @@ struct swuart_dev {
 	uint32_t baudrate;
 	enum uart_parity parity;
 	uint8_t no_of_bits; /* Number of bits per byte */
-	ADI_TMR_DEVICE delay_timer; /* ID of the timer used for the delay */
-	uint16_t half_period;
+	ADI_TMR_DEVICE delay_timer; /* ID of the timer used for the bit timing */
+	uint16_t tick_load; /* Timer load value for one oversampling tick */
+	/* RX state machine */
+	volatile enum swuart_state rx_state;
+	uint8_t rx_ticks; /* Ticks left until the next sample */
+	uint8_t rx_bit; /* Number of data bits received */
+	uint8_t rx_parity; /* Parity accumulator */
+	uint16_t rx_shift; /* Received bits, LSB first */
+	/* TX state machine */
+	volatile enum swuart_state tx_state;
+	uint8_t tx_ticks; /* Ticks left until the next bit */
+	uint8_t tx_bits; /* Bits left in the frame */
+	uint8_t tx_level; /* Level currently driven on the TX pin */
+	uint16_t tx_shift; /* Frame being sent, start bit first */
+	/* Byte FIFOs shared with the timer interrupt */
+	uint8_t tx_fifo[SWUART_FIFO_SIZE];
+	volatile uint32_t tx_head;
+	volatile uint32_t tx_tail;
+	uint16_t rx_fifo[SWUART_FIFO_SIZE]; /* Data and receive error flags */
+	volatile uint32_t rx_head;
+	volatile uint32_t rx_tail;
+	volatile uint32_t ticks; /* Free running tick counter */
+	/* Error counters */
+	uint32_t parity_errors;
+	uint32_t framing_errors;
+	uint32_t overruns;
 };
 
 /******************************************************************************/
@@ -151,19 +203,33 @@ int32_t swuart_init(struct swuart_dev **device, struct swuart_init *init_param);
 /* Free the resources allocated by swuart_init(). */
 int32_t swuart_remove(struct swuart_dev *dev);
 
-/* The function implements a read/write operation through software UART started
- * by the application. The UART transmit considers the parameters number of bits
- * per byte and parity. */
+/* Advance the TX and RX bit state machines by one oversampling tick. */
+uint8_t swuart_tick(struct swuart_dev *dev, uint8_t rx_level);
+
+/* Queue a character for transmission. Waits only if the TX FIFO is full. */
 int32_t swuart_write_char(struct swuart_dev *dev, uint8_t *sbyte);
 
-/* The function implements a read/write operation through software UART started
- * by another device and not the application. The UART transmit considers the
- * parameters number of bits per byte and parity. The main difference is that
- * this transmission waits for the start bit of the other participant before
- * giving it's own. */
+/* Wait for a received character or until SWUART_READ_TIMEOUT bit periods
+ * pass. */
 int32_t swuart_read_char(struct swuart_dev *dev, uint8_t *rbyte);
 
-/* Write a string of bytes through the software UART. */
+/* Get a received character from the RX FIFO without waiting. */
+int32_t swuart_get_char(struct swuart_dev *dev, uint8_t *rbyte);
+
+/* Get the number of characters waiting in the RX FIFO. */
+uint32_t swuart_rx_available(struct swuart_dev *dev);
+
+/* Check if a character is being received. */
+bool swuart_rx_busy(struct swuart_dev *dev);
+
+/* Check if there are characters left to transmit. */
+bool swuart_tx_busy(struct swuart_dev *dev);
+
+/* Drop all the characters in the RX FIFO. */
+void swuart_rx_flush(struct swuart_dev *dev);
+
+/* Write a string of bytes through the software UART and wait until the last
+ * stop bit is sent. */
 int32_t swuart_write_string(struct swuart_dev *dev, uint8_t *string,
 			    uint32_t size);
 
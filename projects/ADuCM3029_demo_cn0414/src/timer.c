@@ -54,6 +54,7 @@
 /******************************************************************************/
 
 static volatile  uint32_t timer_delayCount = 0;
+static volatile  uint32_t timer_msCount = 0;
 volatile uint32_t universal_delay_flag = 0;
 
 /******************************************************************************/
@@ -165,6 +166,20 @@ void timer_sleep(uint32_t ticks)
 	while (timer_delayCount != 0u);
 }
 
+/**
+ * Get the number of milliseconds since timer_start().
+ *
+ * Used for timeouts that must not block the program.
+ *
+ * @params void
+ *
+ * @return The millisecond counter.
+ */
+uint32_t timer_get_ms(void)
+{
+	return timer_msCount;
+}
+
 /**
  * ISR for SysTick timer.
  *
@@ -176,6 +191,8 @@ void timer_sleep(uint32_t ticks)
  */
 void SysTick_Handler(void)
 {
+	timer_msCount++;
+
 	/* Decrement to zero the counter used by the delay routine. */
 	if (timer_delayCount != 0u)
 		--timer_delayCount;
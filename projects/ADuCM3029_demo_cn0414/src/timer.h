@@ -53,4 +53,7 @@ void timer_sleep(uint32_t ticks);
 /* Delay function of 10us or more. */
 void timer2_delay(uint32_t usec);
 
+/* Get the number of milliseconds since timer_start(). */
+uint32_t timer_get_ms(void);
+
 #endif /* TIMER_H_ */
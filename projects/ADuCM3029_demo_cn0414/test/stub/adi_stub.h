@@ -0,0 +1,62 @@
+/* Host declarations of the ADuCM3029 device drivers used by swuart.c */
+
+#ifndef ADI_STUB_H_
+#define ADI_STUB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef void (*ADI_CALLBACK)(void *cb_param, uint32_t event, void *arg);
+
+/* GPIO, modeled by the test */
+#define ADI_GPIO_MEMORY_SIZE	16
+#define ADI_GPIO_SUCCESS	0
+
+typedef enum {
+	ADI_GPIO_PORT0,
+	ADI_GPIO_PORT1,
+	ADI_GPIO_PORT2
+} ADI_GPIO_PORT;
+
+typedef uint16_t ADI_GPIO_DATA;
+
+int adi_gpio_Init(void *mem, uint32_t size);
+int adi_gpio_UnInit(void);
+int adi_gpio_InputEnable(ADI_GPIO_PORT port, ADI_GPIO_DATA pins, bool enable);
+int adi_gpio_PullUpEnable(ADI_GPIO_PORT port, ADI_GPIO_DATA pins, bool enable);
+int adi_gpio_OutputEnable(ADI_GPIO_PORT port, ADI_GPIO_DATA pins, bool enable);
+int adi_gpio_SetHigh(ADI_GPIO_PORT port, ADI_GPIO_DATA pins);
+int adi_gpio_SetLow(ADI_GPIO_PORT port, ADI_GPIO_DATA pins);
+int adi_gpio_GetData(ADI_GPIO_PORT port, ADI_GPIO_DATA pins, uint16_t *value);
+
+/* Timer, modeled by the test */
+#define ADI_TMR_SUCCESS		0
+
+typedef enum {
+	ADI_TMR_DEVICE_GP0,
+	ADI_TMR_DEVICE_GP1,
+	ADI_TMR_DEVICE_GP2
+} ADI_TMR_DEVICE;
+
+typedef enum {
+	ADI_TMR_CLOCK_PCLK
+} ADI_TMR_CLOCK_SOURCE;
+
+typedef struct {
+	bool bCountingUp;
+	bool bPeriodic;
+	uint32_t ePrescaler;
+	ADI_TMR_CLOCK_SOURCE eClockSource;
+	uint16_t nLoad;
+	uint16_t nAsyncLoad;
+	bool bReloading;
+	bool bSyncBypass;
+} ADI_TMR_CONFIG;
+
+int adi_tmr_Init(ADI_TMR_DEVICE dev, ADI_CALLBACK cb, void *cb_param,
+		 bool enable_int);
+int adi_tmr_ConfigTimer(ADI_TMR_DEVICE dev, ADI_TMR_CONFIG *config);
+int adi_tmr_Enable(ADI_TMR_DEVICE dev, bool enable);
+
+#endif /* ADI_STUB_H_ */
@@ -0,0 +1,411 @@
+/* Host test of the HART master link layer against a simulated field device
+ *
+ * The physical layer is replaced by a slave model with a millisecond clock.
+ * The slave parses the request frames of the master and queues its response
+ * one character every 9 ms, as at 1200 baud, after a turnaround delay. Each
+ * response can be scripted to be corrupted, truncated, cut by a character
+ * error, busy, sent from another address, preceded by a burst frame or left
+ * out. Received buffers with burst frames are checked with hart_capture().
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "hart.h"
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+#define CHAR_MS		9
+#define TURNAROUND_MS	20
+
+enum fault {
+	FAULT_NONE,
+	FAULT_CHECKSUM,
+	FAULT_TRUNCATE,
+	FAULT_CHAR_ERROR,
+	FAULT_SILENT,
+	FAULT_BUSY,
+	FAULT_OTHER_ADDRESS,
+	FAULT_BURST
+};
+
+/* Field device model */
+static struct {
+	uint8_t poll_address;
+	uint8_t long_address[HART_LONG_ADDR_SIZE];
+	uint8_t units;
+	uint8_t pv[4];
+	uint32_t requests;
+	uint32_t bad_requests;
+	enum fault faults[8];
+	uint32_t nfaults;
+	/* Characters sent to the master */
+	uint8_t tx[4096];
+	uint8_t tx_error[4096];
+	uint32_t tx_at[4096];
+	uint32_t tx_head;
+	uint32_t tx_tail;
+} slave = {
+	.poll_address = 0,
+	.long_address = { 0x26, 0x81, 0x12, 0x34, 0x56 },
+	.units = 39,
+	/* 12.5 */
+	.pv = { 0x41, 0x48, 0x00, 0x00 }
+};
+
+static uint32_t now_ms;
+
+static uint32_t get_ms(void)
+{
+	return now_ms;
+}
+
+static int32_t get_char(void *phy, uint8_t *byte)
+{
+	uint32_t i = slave.tx_tail;
+
+	now_ms++;
+	if (i == slave.tx_head || slave.tx_at[i] > now_ms)
+		return HART_PHY_NO_DATA;
+	slave.tx_tail++;
+	*byte = slave.tx[i];
+
+	return slave.tx_error[i] ? -1 : 0;
+}
+
+/* Build a frame from the field device, preamble included */
+static uint32_t build_frame(uint8_t *buff, uint8_t type, bool long_frame,
+			    uint8_t command, uint8_t *data, uint8_t size)
+{
+	uint32_t len = 0, start, i;
+	uint8_t checksum = 0;
+
+	for (i = 0; i < 5; i++)
+		buff[len++] = HART_PREAMBLE_BYTE;
+	start = len;
+	if (long_frame) {
+		buff[len++] = type | HART_DELIM_LONG_ADDR;
+		buff[len++] = HART_ADDR_PRIMARY_MASTER | slave.long_address[0];
+		for (i = 1; i < HART_LONG_ADDR_SIZE; i++)
+			buff[len++] = slave.long_address[i];
+	} else {
+		buff[len++] = type;
+		buff[len++] = HART_ADDR_PRIMARY_MASTER | slave.poll_address;
+	}
+	buff[len++] = command;
+	buff[len++] = size;
+	for (i = 0; i < size; i++)
+		buff[len++] = data[i];
+	for (i = start; i < len; i++)
+		checksum ^= buff[i];
+	buff[len++] = checksum;
+
+	return len;
+}
+
+static void queue(uint8_t *buff, uint32_t len, uint32_t error_at)
+{
+	static uint32_t at;
+	uint32_t i, j;
+
+	if (at < now_ms + TURNAROUND_MS)
+		at = now_ms + TURNAROUND_MS;
+	for (i = 0; i < len; i++) {
+		j = slave.tx_head++;
+		slave.tx[j] = buff[i];
+		slave.tx_error[j] = (i == error_at);
+		slave.tx_at[j] = at;
+		at += CHAR_MS;
+	}
+}
+
+static uint8_t burst_data[] = { 0x00, 0x00, 39, 0x42, 0x28, 0x00, 0x00 };
+
+static int32_t transmit(void *phy, uint8_t *data, uint32_t size)
+{
+	struct hart_parser parser;
+	struct hart_frame request;
+	uint8_t payload[32], frame[64], len = 0;
+	enum fault fault = FAULT_NONE;
+	bool long_frame;
+	uint32_t i, flen;
+	int32_t ret = HART_PENDING;
+
+	/* 1200 baud */
+	now_ms += size * CHAR_MS;
+	slave.requests++;
+
+	hart_parser_reset(&parser);
+	for (i = 0; i < size && ret == HART_PENDING; i++)
+		ret = hart_parse_byte(&parser, &request, data[i]);
+	if (ret != HART_SUCCESS || i != size ||
+	    HART_DELIM_FRAME_TYPE(request.delimiter) != HART_FRAME_STX ||
+	    !(request.address[0] & HART_ADDR_PRIMARY_MASTER)) {
+		slave.bad_requests++;
+		return HART_SUCCESS;
+	}
+	long_frame = request.delimiter & HART_DELIM_LONG_ADDR;
+	if (long_frame) {
+		if ((request.address[0] & HART_ADDR_MASK) !=
+		    slave.long_address[0] ||
+		    memcmp(&request.address[1], &slave.long_address[1],
+			   HART_LONG_ADDR_SIZE - 1))
+			return HART_SUCCESS;
+	} else if ((request.address[0] & HART_ADDR_MASK) !=
+		   slave.poll_address) {
+		return HART_SUCCESS;
+	}
+
+	if (slave.nfaults) {
+		fault = slave.faults[0];
+		slave.nfaults--;
+		memmove(&slave.faults[0], &slave.faults[1],
+			slave.nfaults * sizeof(slave.faults[0]));
+	}
+
+	payload[len++] = 0;
+	payload[len++] = 0;
+	switch (request.command) {
+	case HART_CMD_READ_UNIQUE_ID:
+		payload[len++] = 254;
+		payload[len++] = slave.long_address[0];
+		payload[len++] = slave.long_address[1];
+		payload[len++] = 8;
+		payload[len++] = 7;
+		payload[len++] = 1;
+		payload[len++] = 2;
+		payload[len++] = 3;
+		payload[len++] = 0;
+		payload[len++] = slave.long_address[2];
+		payload[len++] = slave.long_address[3];
+		payload[len++] = slave.long_address[4];
+		break;
+	case HART_CMD_READ_PV:
+		payload[len++] = slave.units;
+		memcpy(&payload[len], slave.pv, 4);
+		len += 4;
+		break;
+	default:
+		/* Command not implemented */
+		payload[0] = 64;
+		break;
+	}
+
+	switch (fault) {
+	case FAULT_SILENT:
+		return HART_SUCCESS;
+	case FAULT_BUSY:
+		payload[0] = HART_RC_BUSY;
+		len = 2;
+		break;
+	case FAULT_OTHER_ADDRESS:
+		slave.poll_address ^= 1;
+		slave.long_address[4] ^= 1;
+		break;
+	case FAULT_BURST:
+		flen = build_frame(frame, HART_FRAME_BACK, long_frame,
+				   HART_CMD_READ_PV, burst_data,
+				   sizeof(burst_data));
+		queue(frame, flen, -1);
+		break;
+	default:
+		break;
+	}
+
+	flen = build_frame(frame, HART_FRAME_ACK, long_frame, request.command,
+			   payload, len);
+	if (fault == FAULT_OTHER_ADDRESS) {
+		slave.poll_address ^= 1;
+		slave.long_address[4] ^= 1;
+	}
+
+	switch (fault) {
+	case FAULT_CHECKSUM:
+		frame[flen - 1] ^= 0x5A;
+		break;
+	case FAULT_TRUNCATE:
+		flen -= 4;
+		break;
+	default:
+		break;
+	}
+	queue(frame, flen, (fault == FAULT_CHAR_ERROR) ? flen / 2 : -1);
+
+	return HART_SUCCESS;
+}
+
+static const struct hart_phy_ops ops = {
+	.transmit = transmit,
+	.get_char = get_char,
+	.get_ms = get_ms
+};
+
+static void script(enum fault f0, enum fault f1, enum fault f2, enum fault f3)
+{
+	slave.faults[0] = f0;
+	slave.faults[1] = f1;
+	slave.faults[2] = f2;
+	slave.faults[3] = f3;
+	slave.nfaults = 4;
+}
+
+static void test_parser(void)
+{
+	static uint8_t one_preamble[] = { 0xFF, 0x06, 0x80, 0x01, 0x00, 0x87 };
+	static uint8_t expansion[] = {
+		0xFF, 0xFF, 0xC6, 0x80, 1, 2, 3, 4, 0xEE, 0xDD, 0x01, 0x00,
+		0xC6 ^ 0x80 ^ 1 ^ 2 ^ 3 ^ 4 ^ 0xEE ^ 0xDD ^ 0x01
+	};
+	struct hart_parser parser;
+	struct hart_frame frame;
+	int32_t ret = HART_PENDING;
+	uint32_t i;
+
+	/* One preamble byte is not enough */
+	hart_parser_reset(&parser);
+	for (i = 0; i < sizeof(one_preamble); i++)
+		ret = hart_parse_byte(&parser, &frame, one_preamble[i]);
+	CHECK(ret == HART_PENDING && parser.state == HART_PARSE_PREAMBLE);
+
+	/* Long address and expansion bytes */
+	hart_parser_reset(&parser);
+	for (i = 0; i < sizeof(expansion); i++)
+		ret = hart_parse_byte(&parser, &frame, expansion[i]);
+	CHECK(ret == HART_SUCCESS);
+	CHECK(frame.command == 1 && frame.byte_count == 0);
+	CHECK(frame.address[4] == 4);
+}
+
+static void test_capture(void)
+{
+	struct hart_init_param init = { .ops = &ops, .retries = 3 };
+	struct hart_dev *dev;
+	uint8_t buff[512], frame[64], good[] = { 0, 0, 12, 1, 2, 3, 4 };
+	uint32_t len, flen;
+
+	CHECK(hart_init(&dev, &init) == HART_SUCCESS);
+
+	len = build_frame(buff, HART_FRAME_BACK, false, 1, good, sizeof(good));
+	CHECK(hart_capture(dev, buff, len) == HART_SUCCESS);
+	CHECK(dev->burst_frames == 1);
+	CHECK(dev->burst.byte_count == 7 && dev->burst.data[6] == 4);
+
+	/* Corrupted burst frame */
+	burst_data[2] = 99;
+	len = build_frame(buff, HART_FRAME_BACK, false, 1, burst_data,
+			  sizeof(burst_data));
+	buff[len - 2] ^= 0x01;
+	CHECK(hart_capture(dev, buff, len) == HART_ERR_CHECKSUM);
+	CHECK(dev->checksum_errors == 1);
+
+	/* A response to another master and a request */
+	len = build_frame(buff, HART_FRAME_ACK, false, 3, burst_data,
+			  sizeof(burst_data));
+	len += build_frame(&buff[len], HART_FRAME_STX, true, 48, NULL, 0);
+	CHECK(hart_capture(dev, buff, len) == HART_PENDING);
+
+	/* Burst frame cut short at the end of the buffer */
+	len = build_frame(buff, HART_FRAME_BACK, true, 2, burst_data,
+			  sizeof(burst_data));
+	CHECK(hart_capture(dev, buff, len - 3) == HART_PENDING);
+
+	/* The last good burst frame is kept through all of the above */
+	CHECK(dev->burst_frames == 1);
+	CHECK(dev->burst.delimiter == HART_FRAME_BACK);
+	CHECK(dev->burst.command == 1 && dev->burst.byte_count == 7);
+	CHECK(memcmp(dev->burst.data, good, sizeof(good)) == 0);
+
+	/* A corrupted frame followed by a good one */
+	len = build_frame(buff, HART_FRAME_BACK, false, 1, good, sizeof(good));
+	buff[len - 1] ^= 0xFF;
+	flen = build_frame(frame, HART_FRAME_BACK, true, 2, burst_data,
+			   sizeof(burst_data));
+	memcpy(&buff[len], frame, flen);
+	len += flen;
+	CHECK(hart_capture(dev, buff, len) == HART_SUCCESS);
+	CHECK(dev->burst_frames == 2);
+	CHECK(dev->burst.command == 2 && dev->burst.data[2] == 99);
+	CHECK(dev->burst.delimiter & HART_DELIM_LONG_ADDR);
+	burst_data[2] = 39;
+
+	hart_remove(dev);
+}
+
+static void test_transactions(void)
+{
+	struct hart_init_param init = { .ops = &ops, .retries = 3 };
+	struct hart_unique_id id;
+	struct hart_dev *dev;
+	uint8_t units;
+	float pv;
+
+	CHECK(hart_init(&dev, &init) == HART_SUCCESS);
+
+	CHECK(hart_read_unique_id(dev, &id) == HART_SUCCESS);
+	CHECK(id.preambles == 8 && dev->preamble_size == 8);
+	CHECK(memcmp(id.long_address, slave.long_address,
+		     HART_LONG_ADDR_SIZE) == 0);
+	CHECK(dev->long_frame);
+
+	CHECK(hart_read_pv(dev, &units, &pv) == HART_SUCCESS);
+	CHECK(units == 39 && pv == 12.5f);
+	CHECK(dev->retry_count == 0);
+
+	/* Corrupted, truncated and broken responses are retried */
+	script(FAULT_CHECKSUM, FAULT_TRUNCATE, FAULT_CHAR_ERROR, FAULT_NONE);
+	units = 0;
+	CHECK(hart_read_pv(dev, &units, &pv) == HART_SUCCESS);
+	CHECK(units == 39 && pv == 12.5f);
+	CHECK(dev->retry_count == 3);
+	CHECK(dev->checksum_errors == 1 && dev->frame_errors == 2);
+
+	/* The field device does not answer */
+	script(FAULT_SILENT, FAULT_SILENT, FAULT_SILENT, FAULT_SILENT);
+	CHECK(hart_read_pv(dev, &units, &pv) == HART_ERR_TIMEOUT);
+	CHECK(dev->timeouts == 4 && dev->retry_count == 6);
+
+	/* Busy all the time */
+	script(FAULT_BUSY, FAULT_BUSY, FAULT_BUSY, FAULT_BUSY);
+	CHECK(hart_read_pv(dev, &units, &pv) == HART_ERR_RESPONSE);
+
+	/* Responses from another device are ignored */
+	script(FAULT_OTHER_ADDRESS, FAULT_NONE, FAULT_NONE, FAULT_NONE);
+	CHECK(hart_read_pv(dev, &units, &pv) == HART_SUCCESS);
+	CHECK(dev->timeouts == 5);
+
+	/* A burst frame ahead of the response is kept */
+	script(FAULT_BURST, FAULT_NONE, FAULT_NONE, FAULT_NONE);
+	CHECK(hart_read_pv(dev, &units, &pv) == HART_SUCCESS);
+	CHECK(pv == 12.5f);
+	CHECK(dev->burst_frames == 1 && dev->burst.data[2] == 39);
+	CHECK(dev->burst.data[3] == 0x42);
+	slave.nfaults = 0;
+
+	/* A command the device does not implement */
+	CHECK(hart_command(dev, 200, NULL, 0, &(struct hart_frame *){ 0 }) ==
+	      HART_SUCCESS);
+	CHECK(dev->response.data[0] == 64);
+
+	/* All the requests were well formed */
+	CHECK(slave.bad_requests == 0);
+
+	hart_remove(dev);
+}
+
+int main(void)
+{
+	test_parser();
+	test_capture();
+	test_transactions();
+
+	printf(failures ? "FAILED\n" : "OK\n");
+
+	return failures ? 1 : 0;
+}
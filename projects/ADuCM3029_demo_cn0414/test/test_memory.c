@@ -0,0 +1,370 @@
+/* Host test of the EEPROM job queue against a 24LC32A model
+ *
+ * The I2C transfer functions are replaced by a model of the memory on a
+ * 400 kHz bus with a nanosecond clock: 4096 bytes, 32 byte pages whose
+ * address counter wraps inside the page, and a write cycle after every page
+ * write during which the memory does not acknowledge its address. Each poll
+ * of i2c_transfer_done() costs one pass of the main loop.
+ *
+ * Besides the functional checks the test prints the time a write takes with
+ * acknowledge polling and with the fixed 5 ms delay after every page the
+ * driver used before, for a few write cycle times.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "memory.h"
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+/* 400 kHz */
+#define BIT_NS		2500ull
+/* Eight bits and the acknowledge */
+#define BYTE_NS		(9 * BIT_NS)
+/* One pass of the main loop */
+#define LOOP_NS		2000ull
+/* Fixed delay after every page of the previous driver */
+#define OLD_DELAY_NS	5000000ull
+
+/* 24LC32A model */
+static struct {
+	uint8_t mem[MEMORY_SIZE_BYTES];
+	uint8_t i2c_address;
+	uint16_t pointer;
+	uint64_t write_cycle_ns;
+	uint64_t busy_until;
+	bool stuck;
+	uint32_t page_writes;
+	uint32_t page_wraps;
+	uint32_t naks;
+} eeprom;
+
+/* Bus */
+static uint64_t now;
+static bool active;
+static uint64_t end;
+static int32_t result;
+
+int32_t i2c_init(struct i2c_desc **desc, const struct i2c_init_param *param)
+{
+	*desc = calloc(1, sizeof(**desc));
+	return *desc ? 0 : -1;
+}
+
+int32_t i2c_remove(struct i2c_desc *desc)
+{
+	free(desc);
+	return 0;
+}
+
+int32_t i2c_set_address(struct i2c_desc *desc, uint8_t new_address)
+{
+	desc->slave_address = new_address;
+	return 0;
+}
+
+int32_t i2c_transfer_nonblocking(i2c_desc *desc, uint8_t *prologue,
+				 uint8_t prologue_size, uint8_t *data,
+				 uint16_t bytes_number, bool read)
+{
+	uint8_t buff[2 + MEMORY_SIZE_BYTES];
+	uint32_t size = prologue_size, i;
+	uint16_t page;
+
+	CHECK(!active);
+	active = true;
+	/* Start condition and address byte */
+	end = now + BIT_NS + BYTE_NS;
+
+	if (desc->slave_address != eeprom.i2c_address || eeprom.stuck ||
+	    now < eeprom.busy_until) {
+		eeprom.naks++;
+		result = -1;
+		end += BIT_NS;
+		return 0;
+	}
+	result = 0;
+
+	memcpy(buff, prologue, prologue_size);
+	if (!read) {
+		memcpy(&buff[size], data, bytes_number);
+		size += bytes_number;
+	}
+	end += size * BYTE_NS;
+	if (size >= 2)
+		eeprom.pointer = ((buff[0] << 8) | buff[1]) %
+				 MEMORY_SIZE_BYTES;
+
+	if (read) {
+		/* Repeated start, address byte and sequential read */
+		end += BIT_NS + BYTE_NS + bytes_number * BYTE_NS;
+		for (i = 0; i < bytes_number; i++) {
+			data[i] = eeprom.mem[eeprom.pointer];
+			eeprom.pointer = (eeprom.pointer + 1) %
+					 MEMORY_SIZE_BYTES;
+		}
+	} else if (size > 2) {
+		/* Page write, the address counter wraps inside the page */
+		page = eeprom.pointer & ~(WRITE_SIZE_LIMIT - 1);
+		if ((eeprom.pointer % WRITE_SIZE_LIMIT) + size - 2 >
+		    WRITE_SIZE_LIMIT)
+			eeprom.page_wraps++;
+		for (i = 2; i < size; i++) {
+			eeprom.mem[page | (eeprom.pointer % WRITE_SIZE_LIMIT)] =
+				buff[i];
+			eeprom.pointer = page |
+					 ((eeprom.pointer + 1) % WRITE_SIZE_LIMIT);
+		}
+		eeprom.page_writes++;
+		eeprom.busy_until = end + BIT_NS + eeprom.write_cycle_ns;
+	}
+	/* Stop condition */
+	end += BIT_NS;
+
+	return 0;
+}
+
+int32_t i2c_transfer_done(i2c_desc *desc, bool *done)
+{
+	now += LOOP_NS;
+	*done = now >= end;
+	if (*done)
+		active = false;
+
+	return *done ? result : 0;
+}
+
+static void reset_eeprom(uint64_t write_cycle_ns)
+{
+	memset(eeprom.mem, 0xFF, sizeof(eeprom.mem));
+	eeprom.write_cycle_ns = write_cycle_ns;
+	eeprom.busy_until = 0;
+	eeprom.page_writes = 0;
+	eeprom.page_wraps = 0;
+	eeprom.naks = 0;
+}
+
+static struct memory_desc *open_memory(void)
+{
+	struct memory_init_param init = { .i2c_address = A0_VDD };
+	struct memory_desc *dev;
+
+	eeprom.i2c_address = 0x50 | A0_VDD;
+	CHECK(memory_setup(&dev, &init) == MEMORY_SUCCESS);
+
+	return dev;
+}
+
+/* Time of a write with the previous driver: a blocking page write followed by
+ * a fixed delay, for every page */
+static uint64_t old_write_ns(uint16_t address, uint32_t size)
+{
+	uint64_t ns = 0;
+	uint32_t chunk;
+
+	address += MEMORY_PROTECTED_SIZE;
+	while (size) {
+		chunk = WRITE_SIZE_LIMIT - (address % WRITE_SIZE_LIMIT);
+		if (chunk > size)
+			chunk = size;
+		ns += 3 * BIT_NS + (3 + chunk) * BYTE_NS + OLD_DELAY_NS;
+		address += chunk;
+		size -= chunk;
+	}
+
+	return ns;
+}
+
+static void fill(uint8_t *data, uint32_t size, uint32_t seed)
+{
+	uint32_t i;
+
+	for (i = 0; i < size; i++)
+		data[i] = (uint8_t)((i * 131 + seed * 7 + 1) ^ (i >> 3));
+}
+
+static void test_write_read(void)
+{
+	struct memory_desc *dev = open_memory();
+	uint8_t data[1024], back[1024];
+	uint64_t start;
+
+	reset_eeprom(3000000);
+
+	/* Unaligned write over several pages: 22 + 32 + 32 + 14 bytes */
+	fill(data, 100, 1);
+	start = now;
+	CHECK(memory_write(dev, 10, data, 100) == MEMORY_SUCCESS);
+	CHECK(eeprom.page_writes == 4 && eeprom.page_wraps == 0);
+	CHECK(memcmp(&eeprom.mem[MEMORY_PROTECTED_SIZE + 10], data, 100) == 0);
+	CHECK(eeprom.mem[MEMORY_PROTECTED_SIZE + 9] == 0xFF);
+	CHECK(eeprom.mem[MEMORY_PROTECTED_SIZE + 110] == 0xFF);
+	/* The write returns after the last write cycle ended */
+	CHECK(now >= eeprom.busy_until);
+	CHECK(now - eeprom.busy_until < 100000);
+	CHECK(now - start < old_write_ns(10, 100));
+	/* The polls are the not acknowledged transfers */
+	CHECK(dev->busy_polls == eeprom.naks && eeprom.naks > 0);
+
+	memset(back, 0, sizeof(back));
+	CHECK(memory_read(dev, 10, back, 100) == MEMORY_SUCCESS);
+	CHECK(memcmp(back, data, 100) == 0);
+
+	/* Whole user area, the read is cut at the end of the memory */
+	fill(data, 1024, 2);
+	CHECK(memory_write(dev, 1024, data, 1024) == MEMORY_SUCCESS);
+	CHECK(eeprom.page_writes == 4 + 32 && eeprom.page_wraps == 0);
+	memset(back, 0, sizeof(back));
+	CHECK(memory_read(dev, 1024, back, 1024) == MEMORY_SUCCESS);
+	CHECK(memcmp(back, data, 1024) == 0);
+	CHECK(memory_read(dev, 2040, back, 16) == MEMORY_SUCCESS);
+	CHECK(memcmp(back, &data[1016], 8) == 0);
+
+	/* Size errors */
+	CHECK(memory_write(dev, 2040, data, 9) == WRITE_SIZE_ERROR);
+	CHECK(memory_write_within_page(dev, 30, data, 3) == WRITE_SIZE_ERROR);
+	CHECK(memory_write_within_page(dev, 29, data, 3) == MEMORY_SUCCESS);
+	CHECK(memcmp(&eeprom.mem[29], data, 3) == 0);
+	CHECK(eeprom.page_wraps == 0);
+
+	/* Wrong address: not acknowledged outside of a write cycle fails at
+	 * once */
+	CHECK(memory_change_i2c_address(dev, A1_VDD) == MEMORY_SUCCESS);
+	CHECK(memory_read(dev, 0, back, 4) < 0);
+	CHECK(memory_write(dev, 0, data, 4) < 0);
+	CHECK(memory_change_i2c_address(dev, A0_VDD) == MEMORY_SUCCESS);
+
+	memory_remove(dev);
+}
+
+struct job_result {
+	int order;
+	int32_t status;
+};
+
+static int job_order;
+
+static void job_done(void *ctx, int32_t status)
+{
+	struct job_result *res = ctx;
+
+	res->order = ++job_order;
+	res->status = status;
+}
+
+static void test_queue(void)
+{
+	struct memory_desc *dev = open_memory();
+	struct job_result res[MEMORY_QUEUE_SIZE + 1];
+	uint8_t a[40], b[70], back_a[40], back_b[70];
+	uint32_t i;
+
+	reset_eeprom(4000000);
+	memset(res, 0, sizeof(res));
+	fill(a, sizeof(a), 3);
+	fill(b, sizeof(b), 4);
+
+	/* The reads see the data of the writes queued before them */
+	CHECK(memory_write_async(dev, 100, a, sizeof(a), job_done, &res[0]) ==
+	      MEMORY_SUCCESS);
+	CHECK(memory_read_async(dev, 100, back_a, sizeof(back_a), job_done,
+				&res[1]) == MEMORY_SUCCESS);
+	CHECK(memory_write_async(dev, 130, b, sizeof(b), job_done, &res[2]) ==
+	      MEMORY_SUCCESS);
+	CHECK(memory_read_async(dev, 130, back_b, sizeof(back_b), job_done,
+				&res[3]) == MEMORY_SUCCESS);
+	CHECK(memory_write_async(dev, 0, a, 1, job_done, &res[4]) ==
+	      MEMORY_BUSY_ERROR);
+	CHECK(memory_write_async(dev, 2040, a, 9, NULL, NULL) ==
+	      WRITE_SIZE_ERROR);
+	CHECK(memory_busy(dev));
+	CHECK(memory_change_i2c_address(dev, A1_VDD) == MEMORY_BUSY_ERROR);
+
+	while (memory_busy(dev))
+		CHECK(memory_process(dev) == MEMORY_SUCCESS);
+
+	for (i = 0; i < MEMORY_QUEUE_SIZE; i++)
+		CHECK(res[i].order == (int)i + 1 && res[i].status == 0);
+	CHECK(res[4].order == 0);
+	CHECK(memcmp(back_a, a, sizeof(a)) == 0);
+	/* The first write overlapped the second one at 130..139 */
+	CHECK(memcmp(back_b, b, sizeof(b)) == 0);
+	CHECK(eeprom.page_wraps == 0);
+
+	/* A memory that stays busy fails the job after MEMORY_POLL_LIMIT
+	 * polls and the queue goes on */
+	memset(res, 0, sizeof(res));
+	job_order = 0;
+	CHECK(memory_write_async(dev, 300, a, 8, job_done, &res[0]) ==
+	      MEMORY_SUCCESS);
+	CHECK(memory_read_async(dev, 300, back_a, 8, job_done, &res[1]) ==
+	      MEMORY_SUCCESS);
+	eeprom.naks = 0;
+	/* Stuck right after the first page write */
+	i = eeprom.page_writes;
+	while (eeprom.page_writes == i)
+		memory_process(dev);
+	eeprom.stuck = true;
+	while (res[0].order == 0)
+		memory_process(dev);
+	CHECK(res[0].status < 0);
+	CHECK(eeprom.naks == MEMORY_POLL_LIMIT + 1);
+	eeprom.stuck = false;
+	while (memory_busy(dev))
+		memory_process(dev);
+	CHECK(res[1].order == 2 && res[1].status == 0);
+	CHECK(memcmp(back_a, a, 8) == 0);
+
+	memory_remove(dev);
+}
+
+static void test_timing(void)
+{
+	static const uint32_t sizes[] = { 16, 64, 256, 1024 };
+	static const uint64_t cycles[] = { 1500000, 3000000, 5000000 };
+	struct memory_desc *dev = open_memory();
+	uint8_t data[1024];
+	uint64_t start, new_ns, old_ns;
+	uint32_t s, c;
+
+	fill(data, sizeof(data), 5);
+	printf("bytes  tWC(ms)  fixed delay(ms)  ack polling(ms)\n");
+	for (c = 0; c < 3; c++) {
+		for (s = 0; s < 4; s++) {
+			reset_eeprom(cycles[c]);
+			start = now;
+			CHECK(memory_write(dev, 0, data, sizes[s]) ==
+			      MEMORY_SUCCESS);
+			new_ns = now - start;
+			old_ns = old_write_ns(0, sizes[s]);
+			printf("%5u  %7.1f  %15.2f  %15.2f\n", sizes[s],
+			       cycles[c] / 1e6, old_ns / 1e6, new_ns / 1e6);
+			/* With the longest write cycle only the final address
+			 * poll is added */
+			CHECK(new_ns < old_ns + old_ns / 50);
+			if (cycles[c] < OLD_DELAY_NS)
+				CHECK(new_ns < old_ns);
+		}
+	}
+
+	memory_remove(dev);
+}
+
+int main(void)
+{
+	test_write_read();
+	test_queue();
+	test_timing();
+
+	printf(failures ? "FAILED\n" : "OK\n");
+
+	return failures ? 1 : 0;
+}
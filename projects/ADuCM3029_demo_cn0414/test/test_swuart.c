@@ -0,0 +1,430 @@
+/* Host test of the software UART bit state machines
+ *
+ * The GPIO and timer drivers are replaced by a model: every call of tick()
+ * sets the level of the RX pin and runs the timer callback once, as the
+ * oversampling timer interrupt does on the board, and the level driven on the
+ * TX pin is recorded. Waveforms are built one bit per SWUART_OVERSAMPLE ticks,
+ * optionally with a baudrate error and a phase offset, and replayed through
+ * the driver.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "swuart.h"
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+uint8_t gpio_init_flag;
+uint8_t mem_gpio_handler[ADI_GPIO_MEMORY_SIZE];
+
+/* GPIO model */
+static uint8_t rx_level = 1;
+static uint8_t tx_level = 1;
+static uint32_t tx_writes;
+
+int adi_gpio_Init(void *mem, uint32_t size) { return 0; }
+int adi_gpio_UnInit(void) { return 0; }
+int adi_gpio_InputEnable(ADI_GPIO_PORT port, ADI_GPIO_DATA pins, bool enable) { return 0; }
+int adi_gpio_PullUpEnable(ADI_GPIO_PORT port, ADI_GPIO_DATA pins, bool enable) { return 0; }
+int adi_gpio_OutputEnable(ADI_GPIO_PORT port, ADI_GPIO_DATA pins, bool enable) { return 0; }
+
+int adi_gpio_SetHigh(ADI_GPIO_PORT port, ADI_GPIO_DATA pins)
+{
+	tx_level = 1;
+	tx_writes++;
+	return 0;
+}
+
+int adi_gpio_SetLow(ADI_GPIO_PORT port, ADI_GPIO_DATA pins)
+{
+	tx_level = 0;
+	tx_writes++;
+	return 0;
+}
+
+int adi_gpio_GetData(ADI_GPIO_PORT port, ADI_GPIO_DATA pins, uint16_t *value)
+{
+	*value = rx_level ? pins : 0;
+	return 0;
+}
+
+/* Timer model */
+static ADI_TMR_DEVICE tmr_dev = ADI_TMR_DEVICE_GP0;
+static ADI_CALLBACK tmr_cb;
+static void *tmr_param;
+static bool tmr_int;
+static bool tmr_enabled;
+static uint16_t tmr_load;
+
+int adi_tmr_Init(ADI_TMR_DEVICE dev, ADI_CALLBACK cb, void *cb_param,
+		 bool enable_int)
+{
+	tmr_dev = dev;
+	tmr_cb = cb;
+	tmr_param = cb_param;
+	tmr_int = enable_int;
+	return 0;
+}
+
+int adi_tmr_ConfigTimer(ADI_TMR_DEVICE dev, ADI_TMR_CONFIG *config)
+{
+	CHECK(dev == tmr_dev);
+	tmr_load = config->nLoad;
+	return 0;
+}
+
+int adi_tmr_Enable(ADI_TMR_DEVICE dev, bool enable)
+{
+	CHECK(dev == tmr_dev);
+	tmr_enabled = enable;
+	return 0;
+}
+
+static void tick(uint8_t level)
+{
+	rx_level = level;
+	if (tmr_enabled && tmr_int)
+		tmr_cb(tmr_param, 0, NULL);
+}
+
+/* Waveform, one entry per bit */
+static uint8_t wave[16384];
+static uint32_t wave_len;
+
+static void add_bits(uint8_t level, uint32_t count)
+{
+	while (count--)
+		wave[wave_len++] = level;
+}
+
+static void add_frame(struct swuart_dev *dev, uint16_t data, bool bad_parity,
+		      bool bad_stop)
+{
+	uint8_t parity = (dev->parity == UART_ODD_PARITY) ? 1 : 0;
+	uint8_t i;
+
+	add_bits(0, 1);
+	for (i = 0; i < dev->no_of_bits; i++) {
+		add_bits((data >> i) & 1, 1);
+		parity += (data >> i) & 1;
+	}
+	if (dev->parity != UART_NO_PARITY)
+		add_bits((parity & 1) ^ bad_parity, 1);
+	add_bits(!bad_stop, 1);
+}
+
+/* Replay the waveform with the given bit period in ticks. The first sample is
+ * taken phase ticks after the start of the first bit. */
+static void play(double period, double phase)
+{
+	uint32_t t, bit;
+
+	for (t = 0; ; t++) {
+		bit = (uint32_t)floor((t + phase) / period);
+		if (bit >= wave_len)
+			break;
+		tick(wave[bit]);
+	}
+	wave_len = 0;
+}
+
+static struct swuart_dev *open_uart(enum uart_parity parity, uint8_t bits)
+{
+	struct swuart_init init = {
+		.id = 0,
+		.type = ADICUP3029_SWUART,
+		.rx_port_pin = { ADI_GPIO_PORT0, 1 << 12 },
+		.tx_port_pin = { ADI_GPIO_PORT0, 1 << 13 },
+		.baudrate = 1200,
+		.parity = parity,
+		.no_of_bits = bits,
+		.delay_timer = ADI_TMR_DEVICE_GP2
+	};
+	struct swuart_dev *dev = NULL;
+
+	rx_level = 1;
+	tx_level = 1;
+	CHECK(swuart_init(&dev, &init) == 0);
+	/* The driver runs on the timer it is given, with its interrupt */
+	CHECK(tmr_dev == ADI_TMR_DEVICE_GP2);
+	CHECK(tmr_int && tmr_enabled);
+	CHECK(tmr_load == SWUART_TIMER_CLK / (1200 * SWUART_OVERSAMPLE));
+
+	return dev;
+}
+
+static void close_uart(struct swuart_dev *dev)
+{
+	CHECK(swuart_remove(dev) == 0);
+	CHECK(!tmr_enabled);
+}
+
+static void test_bytes(void)
+{
+	struct swuart_dev *dev = open_uart(UART_NO_PARITY, UART_8_BITS);
+	uint8_t b;
+	uint32_t i, bad = 0;
+
+	/* All the values, back to back, read after each stop bit */
+	for (i = 0; i < 256; i++) {
+		add_frame(dev, i, false, false);
+		play(SWUART_OVERSAMPLE, 0);
+		if (swuart_get_char(dev, &b) != 0 || b != i)
+			bad++;
+	}
+	CHECK(bad == 0);
+	CHECK(swuart_get_char(dev, &b) == SWUART_NO_DATA);
+	CHECK(dev->parity_errors == 0 && dev->framing_errors == 0);
+
+	/* 5 bit characters */
+	close_uart(dev);
+	dev = open_uart(UART_NO_PARITY, UART_5_BITS);
+	for (i = 0; i < 32; i++)
+		add_frame(dev, i, false, false);
+	play(SWUART_OVERSAMPLE, 0);
+	CHECK(swuart_rx_available(dev) == 32);
+	for (i = 0; i < 32; i++)
+		if (swuart_get_char(dev, &b) != 0 || b != i)
+			bad++;
+	CHECK(bad == 0);
+	close_uart(dev);
+}
+
+static void test_tolerance(void)
+{
+	static const double error[] = { -0.03, 0.03 };
+	static const double phase[] = { 0, 0.25, 0.5, 0.75 };
+	static const uint8_t data[] = { 0x55, 0xAA, 0x00, 0xFF, 0x0F, 0x81 };
+	struct swuart_dev *dev = open_uart(UART_EVEN_PARITY, UART_8_BITS);
+	uint32_t e, p, i, bad = 0;
+	uint8_t b;
+
+	/* Back to back frames from a transmitter 3% off */
+	for (e = 0; e < 2; e++) {
+		for (p = 0; p < 4; p++) {
+			for (i = 0; i < sizeof(data); i++)
+				add_frame(dev, data[i], false, false);
+			add_bits(1, 2);
+			play(SWUART_OVERSAMPLE * (1 + error[e]), phase[p]);
+			CHECK(swuart_rx_available(dev) == sizeof(data));
+			for (i = 0; i < sizeof(data); i++)
+				if (swuart_get_char(dev, &b) != 0 ||
+				    b != data[i])
+					bad++;
+		}
+	}
+	CHECK(bad == 0);
+	CHECK(dev->parity_errors == 0 && dev->framing_errors == 0);
+	close_uart(dev);
+}
+
+static void test_mid_bit(void)
+{
+	struct swuart_dev *dev = open_uart(UART_NO_PARITY, UART_8_BITS);
+	uint8_t data = 0x5A, b, bit, i, j;
+
+	/* Every data bit is valid only around the middle of the bit period and
+	 * inverted elsewhere, so only a sample in the middle gets the byte */
+	for (j = 0; j < SWUART_OVERSAMPLE; j++)
+		tick(0);
+	for (i = 0; i < 8; i++) {
+		bit = (data >> i) & 1;
+		for (j = 0; j < SWUART_OVERSAMPLE; j++) {
+			if (j >= SWUART_OVERSAMPLE / 2 - 1 &&
+			    j <= SWUART_OVERSAMPLE / 2 + 1)
+				tick(bit);
+			else
+				tick(!bit);
+		}
+	}
+	for (j = 0; j < SWUART_OVERSAMPLE * 2; j++)
+		tick(1);
+	CHECK(swuart_get_char(dev, &b) == 0 && b == data);
+	close_uart(dev);
+}
+
+static void test_glitch(void)
+{
+	struct swuart_dev *dev = open_uart(UART_NO_PARITY, UART_8_BITS);
+	uint8_t width, b, j;
+
+	/* Low pulses up to half a bit are not start bits */
+	for (width = 1; width <= SWUART_OVERSAMPLE / 2; width++) {
+		for (j = 0; j < width; j++)
+			tick(0);
+		CHECK(swuart_rx_busy(dev));
+		for (j = 0; j < SWUART_OVERSAMPLE; j++)
+			tick(1);
+		CHECK(!swuart_rx_busy(dev));
+	}
+	CHECK(swuart_rx_available(dev) == 0);
+
+	/* The receiver is still in step */
+	add_frame(dev, 0xC3, false, false);
+	play(SWUART_OVERSAMPLE, 0);
+	CHECK(swuart_get_char(dev, &b) == 0 && b == 0xC3);
+	CHECK(dev->framing_errors == 0);
+	close_uart(dev);
+}
+
+static void test_parity(void)
+{
+	struct swuart_dev *dev = open_uart(UART_EVEN_PARITY, UART_7_BITS);
+	uint32_t i, bad = 0;
+	uint8_t b;
+
+	for (i = 0; i < 128; i++) {
+		add_frame(dev, i, false, false);
+		play(SWUART_OVERSAMPLE, 0);
+		if (swuart_get_char(dev, &b) != 0 || b != i)
+			bad++;
+	}
+	CHECK(bad == 0);
+	add_frame(dev, 0x41, true, false);
+	play(SWUART_OVERSAMPLE, 0);
+	CHECK(dev->rx_fifo[dev->rx_tail & (SWUART_FIFO_SIZE - 1)] ==
+	      (0x41 | SWUART_PARITY_ERROR));
+	CHECK(swuart_get_char(dev, &b) == -1 && b == 0x41);
+	CHECK(dev->parity_errors == 1 && dev->framing_errors == 0);
+	close_uart(dev);
+
+	dev = open_uart(UART_ODD_PARITY, UART_8_BITS);
+	add_frame(dev, 0x00, false, false);
+	add_frame(dev, 0x01, false, false);
+	add_frame(dev, 0xFE, true, false);
+	play(SWUART_OVERSAMPLE, 0);
+	CHECK(swuart_get_char(dev, &b) == 0 && b == 0x00);
+	CHECK(swuart_get_char(dev, &b) == 0 && b == 0x01);
+	CHECK(swuart_get_char(dev, &b) == -1 && b == 0xFE);
+	CHECK(dev->parity_errors == 1);
+	close_uart(dev);
+}
+
+static void test_framing(void)
+{
+	struct swuart_dev *dev = open_uart(UART_NO_PARITY, UART_8_BITS);
+	uint8_t b;
+
+	/* Missing stop bit */
+	add_frame(dev, 0x7E, false, true);
+	add_bits(1, 1);
+	add_frame(dev, 0x12, false, false);
+	play(SWUART_OVERSAMPLE, 0.5);
+	CHECK(swuart_get_char(dev, &b) == -1 && b == 0x7E);
+	CHECK(swuart_get_char(dev, &b) == 0 && b == 0x12);
+	CHECK(dev->framing_errors == 1);
+
+	/* A break is one character with a framing error, however long */
+	add_frame(dev, 0x00, false, true);
+	add_bits(0, 40);
+	CHECK(!swuart_rx_busy(dev));
+	play(SWUART_OVERSAMPLE, 0);
+	CHECK(!swuart_rx_busy(dev));
+	CHECK(swuart_rx_available(dev) == 1);
+	CHECK(dev->rx_fifo[dev->rx_tail & (SWUART_FIFO_SIZE - 1)] ==
+	      SWUART_FRAMING_ERROR);
+	CHECK(swuart_get_char(dev, &b) == -1 && b == 0x00);
+	CHECK(dev->framing_errors == 2);
+
+	/* The line returns to idle and the next character is received */
+	add_bits(1, 1);
+	add_frame(dev, 0xA5, false, false);
+	play(SWUART_OVERSAMPLE, 0);
+	CHECK(swuart_get_char(dev, &b) == 0 && b == 0xA5);
+	CHECK(swuart_get_char(dev, &b) == SWUART_NO_DATA);
+	close_uart(dev);
+}
+
+static void test_overrun(void)
+{
+	struct swuart_dev *dev = open_uart(UART_NO_PARITY, UART_8_BITS);
+	uint32_t i, bad = 0;
+	uint8_t b;
+
+	for (i = 0; i < SWUART_FIFO_SIZE + 3; i++)
+		add_frame(dev, i, false, false);
+	play(SWUART_OVERSAMPLE, 0);
+	CHECK(swuart_rx_available(dev) == SWUART_FIFO_SIZE);
+	CHECK(dev->overruns == 3);
+	for (i = 0; i < SWUART_FIFO_SIZE; i++)
+		if (swuart_get_char(dev, &b) != 0 || b != i)
+			bad++;
+	CHECK(bad == 0);
+	CHECK(swuart_get_char(dev, &b) == SWUART_NO_DATA);
+
+	swuart_rx_flush(dev);
+	add_frame(dev, 0x99, false, false);
+	play(SWUART_OVERSAMPLE, 0);
+	CHECK(swuart_get_char(dev, &b) == 0 && b == 0x99);
+	close_uart(dev);
+}
+
+static void test_tx(void)
+{
+	static const uint8_t data[] = { 0x55, 0xA3, 0x00, 0xFF };
+	struct swuart_dev *dev = open_uart(UART_EVEN_PARITY, UART_8_BITS);
+	uint32_t i, t, ticks, edges = 0, bad = 0;
+	uint8_t b;
+
+	for (i = 0; i < sizeof(data); i++)
+		CHECK(swuart_write_char(dev, (uint8_t *)&data[i]) == 0);
+	CHECK(swuart_tx_busy(dev));
+
+	/* Expected line levels, one bit every SWUART_OVERSAMPLE ticks from the
+	 * first tick */
+	for (i = 0; i < sizeof(data); i++)
+		add_frame(dev, data[i], false, false);
+	ticks = wave_len * SWUART_OVERSAMPLE;
+	for (i = 1; i < wave_len; i++)
+		edges += wave[i] != wave[i - 1];
+	edges += wave[0] != 1;
+
+	/* Loop TX back to RX */
+	tx_writes = 0;
+	for (t = 0; t < ticks; t++) {
+		tick(tx_level);
+		if (tx_level != wave[t / SWUART_OVERSAMPLE])
+			bad++;
+	}
+	wave_len = 0;
+	CHECK(bad == 0);
+	CHECK(tx_level == 1);
+	/* The pin is written only on a change */
+	CHECK(tx_writes == edges);
+
+	/* The last stop bit ends, and is sampled by the RX side, one tick
+	 * later */
+	CHECK(swuart_tx_busy(dev));
+	tick(tx_level);
+	CHECK(!swuart_tx_busy(dev));
+	CHECK(swuart_rx_available(dev) == sizeof(data));
+	for (i = 0; i < sizeof(data); i++)
+		if (swuart_get_char(dev, &b) != 0 || b != data[i])
+			bad++;
+	CHECK(bad == 0);
+	close_uart(dev);
+}
+
+int main(void)
+{
+	test_bytes();
+	test_tolerance();
+	test_mid_bit();
+	test_glitch();
+	test_parity();
+	test_framing();
+	test_overrun();
+	test_tx();
+
+	printf(failures ? "FAILED\n" : "OK\n");
+
+	return failures ? 1 : 0;
+}
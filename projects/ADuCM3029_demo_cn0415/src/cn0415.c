@@ -143,6 +143,10 @@ uint8_t command_size[] = {5, 2, 10, 2, 11, 2, 9, 2, 16, 3, 14, 3, 17, 3, 17, 3,
 			  13, 4, 11, 4, 8, 3, 11, 3, 11, 3, 11, 3, 11, 3, 16, 5, 17, 5, 11,
 			  5, 12, 5, 13, 4, 6, 4, 7, 5, 10, 4, 1};
 
+/* Command lookup table, built on the first search */
+static uint8_t cmd_hash[CMD_HASH_SIZE];
+static bool cmd_hash_valid = false;
+
 float offset_err, gain_err = 0;
 
 /******************************************************************************/
@@ -1772,7 +1776,9 @@ int32_t cn0415_process(struct cn0415_dev *dev)
 			uart_previous_line[i] = uart_current_line[i];
 		} while(uart_current_line[i++] != '\0');
 		/* Find needed function based on typed command */
-		cn0415_find_command(dev, uart_current_line, &func);
+		ret = cn0415_find_command(dev, uart_current_line, &func);
+		if(ret != CN415_SUCCESS)
+			return ret;
 
 		/* Check if there is a valid command */
 		if (func) {
@@ -1835,35 +1841,92 @@ int32_t cn0415_process(struct cn0415_dev *dev)
 	return ret;
 }
 
+/**
+ * Compute the lookup table slot of a command.
+ *
+ * Only the command name is hashed, up to the first space, so a typed line
+ * with arguments lands in the same slot as its command call.
+ *
+ * @param [in] command - Command name or typed line.
+ *
+ * @return Slot index in the lookup table.
+ */
+static uint8_t cn0415_cmd_hash(const char *command)
+{
+	uint32_t hash = 5381;
+
+	while(*command != '\0' && *command != ' ')
+		hash = (hash * 33) ^ (uint8_t)*command++;
+
+	return hash & (CMD_HASH_SIZE - 1);
+}
+
+/**
+ * Build the command lookup table from the command calls.
+ *
+ * Open addressing with linear probing. Each used slot holds the index of the
+ * command call plus one, so 0 marks an empty slot.
+ *
+ * @return 0 in case of success, negative error code if there are more command
+ *         calls than CMD_HASH_SIZE - 1.
+ */
+static int32_t cn0415_build_cmd_hash(void)
+{
+	uint8_t i, slot;
+
+	memset(cmd_hash, 0, sizeof(cmd_hash));
+
+	for(i = 0; v_cmd_fun[i / 2] != NULL; i++) {
+		/* Keep at least one slot empty to end the probing */
+		if(i >= CMD_HASH_SIZE - 1)
+			return CN415_FAILURE;
+		slot = cn0415_cmd_hash(cmd_commands[i]);
+		while(cmd_hash[slot] != 0)
+			slot = (slot + 1) & (CMD_HASH_SIZE - 1);
+		cmd_hash[slot] = i + 1;
+	}
+
+	cmd_hash_valid = true;
+
+	return CN415_SUCCESS;
+}
+
 /**
  * Get the CLI commands and correlate them to functions.
  *
+ * The command is looked up in a hash table built from the command calls the
+ * first time a command is searched.
+ *
  * @param [in]  dev      - The device structure.
  * @param [in]  command  - Command received from the CLI.
  * @param [out] function - Pointer to the corresponding function.
  *
- * @return void
+ * @return 0 in case of success, negative error code otherwise.
  */
-void cn0415_find_command(struct cn0415_dev *dev, uint8_t *command,
-			 cmd_func* function)
+int32_t cn0415_find_command(struct cn0415_dev *dev, uint8_t *command,
+			    cmd_func* function)
 {
-	uint8_t i = 0;
+	uint8_t slot, i;
+	int32_t ret;
 
-	while (v_cmd_fun[i/2] != NULL) {
-		if(strncmp((char *)command,
-			   (char *)cmd_commands[i],
-			   command_size[i]) == 0 ||
-		    strncmp((char *)command,
-			    (char *)cmd_commands[i + 1],
-			    command_size[i+1]) == 0) {
-			if(command_size == 0) {
-				break;
-			}
+	if(!cmd_hash_valid) {
+		ret = cn0415_build_cmd_hash();
+		if(ret != CN415_SUCCESS)
+			return ret;
+	}
+
+	slot = cn0415_cmd_hash((char *)command);
+	while(cmd_hash[slot] != 0) {
+		i = cmd_hash[slot] - 1;
+		if(strncmp((char *)command, cmd_commands[i],
+			   command_size[i]) == 0) {
 			*function = v_cmd_fun[i / 2];
 			break;
 		}
-		i += 2;
+		slot = (slot + 1) & (CMD_HASH_SIZE - 1);
 	}
+
+	return CN415_SUCCESS;
 }
 
 /**
@@ -56,6 +56,10 @@
 #define FLASH_PARAM_SIZE 16
 #define SAMPLE_NO 50
 
+/* Size of the command lookup table. Must be a power of 2 and greater than
+ * the number of command calls (long and short names). */
+#define CMD_HASH_SIZE 64
+
 /* GPIOs */
 #define GPIO_FAULT_DETECT 0x0F
 #define GPIO_OC_RESET 0x09
@@ -207,8 +211,8 @@ int32_t cn0415_parse(struct cn0415_dev *dev);
 int32_t cn0415_process(struct cn0415_dev *dev);
 
 /* Get the CLI commands and correlate them to functions. */
-void cn0415_find_command(struct cn0415_dev *dev, uint8_t *command,
-			 cmd_func* function);
+int32_t cn0415_find_command(struct cn0415_dev *dev, uint8_t *command,
+			    cmd_func* function);
 
 /* Display command prompt for the user on the CLI at the beginning of the
  * program. */
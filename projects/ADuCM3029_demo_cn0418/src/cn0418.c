@@ -1853,6 +1853,9 @@ int32_t cn0418_process(struct cn0418_dev *dev)
 		cn0418_cmd_prompt(dev);
 	}
 
+	/* Advance the queued EEPROM jobs */
+	memory_process(dev->memory_device);
+
 	if(modem_rec_flag == true) {
 		ret = cn0418_process_hart_int_rec(dev);
 		if(ret < 0)
@@ -297,6 +297,68 @@ int32_t i2c_set_address(i2c_desc *desc, uint8_t new_address)
 	return adi_i2c_SetSlaveAddress(master_i2c_dev, new_address);
 }
 
+/**
+ * Start a transfer with a slave device without waiting for it to end.
+ *
+ * The prologue is sent first, then the data is written or read. For reads a
+ * repeated start is generated between the prologue and the data. Only one
+ * transfer can be pending, i2c_transfer_done() must report it as done before
+ * the next one is started.
+ *
+ * @param [in] desc          - The I2C descriptor.
+ * @param [in] prologue      - Bytes sent before the data. Must stay valid
+ *                             until the transfer is done.
+ * @param [in] prologue_size - Number of bytes in the prologue.
+ * @param [in,out] data      - Buffer with the data to write or for the read
+ *                             data. Must stay valid until the transfer is done.
+ * @param [in] bytes_number  - Number of bytes to write or read.
+ * @param [in] read          - true to read the data, false to write it.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t i2c_transfer_nonblocking(i2c_desc *desc, uint8_t *prologue,
+				 uint8_t prologue_size, uint8_t *data,
+				 uint16_t bytes_number, bool read)
+{
+	static ADI_I2C_TRANSACTION trans;
+
+	trans.bReadNotWrite = read;
+	trans.bRepeatStart = read;
+	trans.nDataSize = bytes_number;
+	trans.nPrologueSize = prologue_size;
+	trans.pData = data;
+	trans.pPrologue = prologue;
+
+	return adi_i2c_SubmitBuffer(master_i2c_dev, &trans);
+}
+
+/**
+ * Check if the transfer started by i2c_transfer_nonblocking() is done.
+ *
+ * When the transfer is done the controller is released and the result of the
+ * transfer is returned, a slave that did not acknowledge is reported as an
+ * error.
+ *
+ * @param [in] desc  - The I2C descriptor.
+ * @param [out] done - true if the transfer is done, false if it is still
+ *                     running.
+ *
+ * @return 0 in case of success, negative error code otherwise.
+ */
+int32_t i2c_transfer_done(i2c_desc *desc, bool *done)
+{
+	uint32_t error;
+	int32_t ret;
+
+	ret = adi_i2c_IsBufferAvailable(master_i2c_dev, done);
+	if(ret != 0)
+		return ret;
+	if(!*done)
+		return 0;
+
+	return adi_i2c_GetBuffer(master_i2c_dev, &error);
+}
+
 /**
  * Initialize the SPI communication peripheral.
  *
@@ -0,0 +1,4 @@
+/* Host replacement of the GPIO driver header included by platform_drivers.h */
+
+#include <stdint.h>
+#include <stdbool.h>
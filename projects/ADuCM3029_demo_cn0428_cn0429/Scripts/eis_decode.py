@@ -0,0 +1,84 @@
+"""Decode the binary EIS frames sent by the readeisbin command.
+
+Frames are read either from a serial port or from a file holding a
+recorded capture, and printed as CSV, one line per frequency point.
+
+Usage:
+    python eis_decode.py COM5          (send readeisbin [a] on the board)
+    python eis_decode.py capture.bin
+"""
+
+import os
+import struct
+import sys
+
+SYNC = b'\xa5\x5a'
+HDR = struct.Struct('<BB')             # site, number of points
+POINT = struct.Struct('<f6iff')        # freq, 6 x DFT, magnitude, phase
+FEAT = struct.Struct('<fff')           # Rs, Rct, fpeak
+CSUM = struct.Struct('<H')
+DFT_NAMES = ('Rsens+Rload_real', 'Rsens+Rload_imag', 'Rload_real',
+             'Rload_imag', 'Rcal_real', 'Rcal_imag')
+
+
+def frame_size(points):
+    """Return the size of a frame with the given number of points."""
+    return (len(SYNC) + HDR.size + points * POINT.size + FEAT.size +
+            CSUM.size)
+
+
+def decode_frames(data):
+    """Yield (site, points, features, end) for every valid frame in data."""
+    pos = data.find(SYNC)
+    while pos >= 0 and pos + len(SYNC) + HDR.size <= len(data):
+        site, npoints = HDR.unpack_from(data, pos + len(SYNC))
+        end = pos + frame_size(npoints)
+        if end > len(data):
+            break
+        body = data[pos + len(SYNC):end - CSUM.size]
+        (csum,) = CSUM.unpack_from(data, end - CSUM.size)
+        if sum(body) & 0xFFFF != csum:
+            pos = data.find(SYNC, pos + 1)
+            continue
+        off = pos + len(SYNC) + HDR.size
+        points = []
+        for _ in range(npoints):
+            points.append(POINT.unpack_from(data, off))
+            off += POINT.size
+        yield site, points, FEAT.unpack_from(data, off), end
+        pos = data.find(SYNC, end)
+
+
+def print_frames(data):
+    """Print all frames in data as CSV and return the unused tail."""
+    consumed = 0
+    for site, points, (rs, rct, fpeak), end in decode_frames(data):
+        print('Site %d: Rs = %.3f ohm, Rct = %.3f ohm, fpeak = %.3f Hz' %
+              (site, rs, rct, fpeak))
+        print('Frequency, ' + ', '.join(DFT_NAMES) + ', Mag_Rsens, Phase')
+        for point in points:
+            print('%f, %d, %d, %d, %d, %d, %d, %f, %f' % point)
+        consumed = end
+    return data[consumed:]
+
+
+def main():
+    """Decode a capture file or frames arriving on a serial port."""
+    if len(sys.argv) != 2:
+        print(__doc__)
+        sys.exit(1)
+
+    if os.path.isfile(sys.argv[1]):
+        with open(sys.argv[1], 'rb') as capture:
+            print_frames(capture.read())
+        return
+
+    import serial
+    port = serial.Serial(sys.argv[1], 115200, timeout=1)
+    data = b''
+    while True:
+        data = print_frames(data + port.read(1024))
+
+
+if __name__ == '__main__':
+    main()
@@ -108,8 +108,11 @@ bool eisTestInProgress = false;
 extern Gas_Sensor *pGasSensor;
 extern uint8_t uiDefaultAddress;
 
-/* used for timing the data update rate when in STREAM state */
-uint16_t tickCnt = 0;
+/* millisecond time base, incremented by SysTick */
+volatile uint32_t msTicks = 0;
+
+/* time [ms] at which the next stream readout is due when in STREAM state */
+uint32_t streamNextMs = 0;
 
 /* used as configuration parameter for data update rate in STREAM mode
  *	default value is 1, i.e. 1 second update rate
@@ -122,6 +125,18 @@ eFSM_State FSM_State = INIT;
  *	FUNCTIONS
  */
 
+/* SysTick interrupt handler - 1 ms time base */
+extern "C" void SysTick_Handler(void)
+{
+	msTicks++;
+}
+
+/* Milliseconds elapsed since the time base was started */
+uint32_t GetMsTicks(void)
+{
+	return msTicks;
+}
+
 /* UART Callback handler */
 static void uartCallback(void *pAppHandle, uint32_t nEvent, void *pArg)
 {
@@ -294,6 +309,36 @@ GResult UART_TX_DIR(const char *initialcmd)
 	return result;
 }
 
+/*!
+ * @brief      Binary UART Transmit function
+ *
+ * @details    Transmit a raw byte buffer which may contain zeros. Waits for the transfer to
+ * 			   complete so the caller can reuse the buffer.
+ */
+GResult UART_TX_BIN(const uint8_t *data, uint16_t len)
+{
+	uint32_t timeout = 0x00989680; /* 10*10^6 */
+
+	while (TXcompleteFlag == 0) {
+		timeout--;
+		if (timeout == 0)
+			break;
+	}
+	TXcompleteFlag = 0;
+	if ((adi_uart_SubmitTxBuffer(hDevice, (void*) data, len, 0u))
+	    != ADI_UART_SUCCESS)
+		return Failure;
+
+	timeout = 0x00989680;
+	while (TXcompleteFlag == 0) {
+		timeout--;
+		if (timeout == 0)
+			return Failure;
+	}
+
+	return Success;
+}
+
 /**
  @brief Perform initialization of sensors.
  @return none
@@ -359,7 +404,7 @@ void DataDisplayFSM(void)
 			pulseTestInProgress = false;
 			eisTestInProgress = false;
 			delay_ms(250);
-			if (pGasSensor->SensorInit(uiDefaultAddress) == SENSOR_ERROR_NONE) {
+			if (CN0429_WaitTestDone() == SENSOR_ERROR_NONE) {
 				UART_TX("Test finished! Results ready." _EOS);
 			}
 		}
@@ -444,6 +489,9 @@ int main(int argc, char *argv[])
 		return (ePwrResult);
 	}
 
+	/* Start the 1 ms time base used to pace the data stream */
+	SysTick_Config(SYSTICK_RELOAD_1MS);
+
 	delay_ms(1000);
 
 	/* Initialize GPIO */
@@ -471,11 +519,14 @@ int main(int argc, char *argv[])
 		}
 
 		if (FSM_State == STREAM_GAS) {
-			tickCnt++;
-			if (tickCnt >= ((100 * streamTickCfg) - 25)) {
-				/* -25 to account for delays in readout */
+			/* Fixed-rate schedule: the period does not depend on
+			 * the time spent reading out the sensors. */
+			if ((int32_t)(GetMsTicks() - streamNextMs) >= 0) {
+				streamNextMs += 1000u * streamTickCfg;
+				/* Resynchronize if a readout overran the period */
+				if ((int32_t)(GetMsTicks() - streamNextMs) >= 0)
+					streamNextMs = GetMsTicks() + 1000u * streamTickCfg;
 				DataDisplayFSM();
-				tickCnt = 0;
 			}
 		} else {
 			DataDisplayFSM();
@@ -114,7 +114,11 @@
 EXTERNC void delay_ms(uint32_t mSec);
 EXTERNC void delay_us(uint32_t uSec);
 
-EXTERNC uint16_t streamTickCnt;
+/* SysTick reload for a 1 ms tick with HCLK = 26 MHz */
+#define SYSTICK_RELOAD_1MS	26000u
+
+EXTERNC uint32_t GetMsTicks(void);
+
 EXTERNC uint16_t streamTickCfg;
 
 #endif /* __ADUCM3029_DEMO_CN0428_CN0429_H__ */
@@ -115,6 +115,8 @@ public:
 	virtual SENSOR_RESULT I2CReadWrite(uint8_t RW, uint8_t RegAddr,
 					   uint8_t *pData, uint16_t size) = 0;
 
+	virtual SENSOR_RESULT SelectSensor(uint8_t sensor_address) = 0;
+
 	/*!
 	 * @brief	Opens the gas sensor and configures it.
 	 *
@@ -65,6 +65,16 @@ SENSOR_RESULT M355_GAS::open(uint8_t sensor_address)
 	this->m_i2c_address = sensor_address;
 	return this->InitI2C();
 }
+
+/*
+ * Address another sensor on the already opened I2C bus
+ */
+SENSOR_RESULT M355_GAS::SelectSensor(uint8_t sensor_address)
+{
+	this->m_i2c_address = sensor_address;
+	return SENSOR_ERROR_NONE;
+}
+
 /*
  * Starts measurement
  */
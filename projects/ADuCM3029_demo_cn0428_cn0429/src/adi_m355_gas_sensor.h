@@ -91,6 +91,9 @@
 #define PULSE_DURATION_MAX		200u
 #define PULSE_DURATION_DEFAULT	100u
 
+/* Time the slave needs to prepare the answer to a read command */
+#define RESPONSE_DELAY_MS		50u
+
 typedef enum {
 	READ = 0,
 	WRITE
@@ -117,6 +120,7 @@ public:
 	virtual SENSOR_RESULT open(uint8_t sensor_address);
 	virtual SENSOR_RESULT I2CReadWrite(uint8_t RW, uint8_t RegAddr,
 					   uint8_t *pData, uint16_t size);
+	virtual SENSOR_RESULT SelectSensor(uint8_t sensor_address);
 	virtual SENSOR_RESULT SensorInit(uint8_t sensor_address);
 	virtual SENSOR_RESULT SetI2CAddr(uint8_t new_I2C_address);
 	virtual SENSOR_RESULT ReadTemperature(int16_t *pSensData);
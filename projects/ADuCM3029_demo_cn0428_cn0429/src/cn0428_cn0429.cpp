@@ -44,6 +44,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <math.h>
 
 /*
  *	Variables
@@ -69,8 +70,15 @@ uint8_t gBuff[64] = { 0 };					/* general use buffer */
 uint8_t pulseResultBuffer[6144] = { 0 };	/* buffer holding pulse test result */
 uint8_t EISResponseBuff[1024] = { 0 };		/* buffer holding EIS results */
 uint32_t EISresults[256] = { 0 };			/* array of EIS results */
+
+SiteReadings siteReadings[NUM_SENSORS] = { };	/* last readings of each site */
+SiteConfig siteConfig[NUM_SENSORS] = { };		/* cached config of each site */
+uint32_t streamStartMs = 0;					/* time base of the stream timestamps */
 int32_t EISpartialDFTresult[8] = { 0 };		/* array of partial results (DFT impedance) of EIS */
 double EISpartialresult[12] = { 0 };		/* array of partial (one line) EIS results */
+EISPoint EISsweep[EIS_NUM_FREQ];			/* decoded EIS sweep */
+uint8_t EISFrameBuff[EIS_FRAME_SIZE];		/* binary EIS frame sent over UART */
+bool eisAllSites = false;					/* EIS test started on all sites */
 
 extern bool pulseTestInProgress;
 extern bool eisTestInProgress;
@@ -90,7 +98,7 @@ const char* rload[] = { "0R", "10R", "30R", "50R", "100R", "1k6", "3k1", "3k6" }
 const bool no_sensors[NUM_SENSORS] = { };
 extern bool detected_sensors[];
 
-extern uint16_t tickCnt;
+extern uint32_t streamNextMs;
 extern uint16_t streamTickCfg;
 
 extern eFSM_State FSM_State;
@@ -116,6 +124,7 @@ char const *CmdCommands[] = {
 	"runeis",
 	"readeis",
 	"readeisfull",
+	"readeisbin",
 	"readrcal",
 	"runpulse",
 	"readpulse",
@@ -144,6 +153,7 @@ cmdFunc CmdFun[] = {
 	CN0429_RunEIS,
 	CN0429_RdEIS,
 	CN0429_RdEISfull,
+	CN0429_RdEISbin,
 	CN0429_RdRcal,
 	CN0429_RunPulse,
 	CN0429_ReadPulse,
@@ -191,11 +201,15 @@ void CN0429_CmdHelp(uint8_t *args)
 	UART_TX("setsensitivity <sens>          -Configure sensitivity" _EOS);
 	UART_TX("                                  <sens> = sensitivity in nA/ppm"
 		_EOS);
-	UART_TX("runeis                         -Run impedance spectroscopy" _EOS);
+	UART_TX("runeis [a]                     -Run impedance spectroscopy" _EOS);
+	UART_TX("                                  a = on all sites at once" _EOS);
 	UART_TX("readeis                        -Read impedance spectroscopy results"
 		_EOS);
 	UART_TX("readeisfull                    -Read impedance spectroscopy FULL results"
 		_EOS);
+	UART_TX("readeisbin [a]                 -Send impedance spectroscopy results as binary frame"
+		_EOS);
+	UART_TX("                                  a = one frame for each site" _EOS);
 	UART_TX("readrcal                       -Read 200R calibration resistor" _EOS);
 	UART_TX("runpulse                       -Run pulse test. Set amplitude and duration first!"
 		_EOS);
@@ -383,94 +397,184 @@ void CN0429_SwitchSns(uint8_t *args)
 }
 
 /*!
- * @brief      Reads sensor config
+ * @brief      Returns the site index (0 based) of a sensor address
  *
- * @details    Reads sensor config of the sensor with address specified in input parameter
+ * @details    Returns NUM_SENSORS if the address does not belong to any site.
  */
-SENSOR_RESULT CN0429_GetSensorCfg(uint8_t sensor_address)
+uint8_t CN0429_SiteIndex(uint8_t sensor_address)
 {
-	uint8_t pBuff[8] = { 0 };
-	int16_t sigVal = 0;
-	uint16_t unsigVal = 0;
-	uint32_t unsiglVal = 0;
+	uint8_t i;
 
-	eSensorResult = pGasSensor->open(sensor_address);
+	for (i = 0; i < NUM_SENSORS; i++)
+		if (sensor_address == sensor_addresses[i])
+			break;
+
+	return i;
+}
+
+/*!
+ * @brief      Reads sensor config into the config cache
+ *
+ * @details    Reads the configuration of the sensor on the given site (0 based) and stores
+ * 				it in siteConfig[] so later requests are answered without I2C traffic.
+ */
+SENSOR_RESULT CN0429_ReadSensorCfg(uint8_t site)
+{
+	SiteConfig *cfg = &siteConfig[site];
+
+	cfg->valid = false;
+
+	eSensorResult = pGasSensor->open(sensor_addresses[site]);
 	if (eSensorResult != SENSOR_ERROR_NONE)
 		return eSensorResult;
 	delay_ms(5);
 
-	for (uint8_t i = 0; i < NUM_SENSORS; i++) {
-		if (sensor_address == sensor_addresses[i])
-			snprintf((char*) &TXbuff, 256,
-				"Config of sensor on site %d:%s", i + 1,
-				_EOS);
+	eSensorResult = pGasSensor->ReadTIAGain(&cfg->rtia);
+	if (eSensorResult != SENSOR_ERROR_NONE)
+		goto close;
+	eSensorResult = pGasSensor->ReadRload(&cfg->rload);
+	if (eSensorResult != SENSOR_ERROR_NONE)
+		goto close;
+	eSensorResult = pGasSensor->ReadSensorBias(&cfg->vbias);
+	if (eSensorResult != SENSOR_ERROR_NONE)
+		goto close;
+	eSensorResult = pGasSensor->ReadSensorSensitivity(&cfg->sensitivity);
+	if (eSensorResult != SENSOR_ERROR_NONE)
+		goto close;
+	eSensorResult = pGasSensor->ReadMeasurementTime(&cfg->measTime);
+	if (eSensorResult != SENSOR_ERROR_NONE)
+		goto close;
+
+	cfg->valid = true;
+
+close:
+	pGasSensor->close();
+	delay_ms(5);
+
+	return eSensorResult;
+}
+
+/*!
+ * @brief      Marks the cached config of a sensor as stale
+ *
+ * @details    Must be called after any setting of the sensor is changed.
+ */
+void CN0429_InvalidateSensorCfg(uint8_t sensor_address)
+{
+	uint8_t site = CN0429_SiteIndex(sensor_address);
+
+	if (site < NUM_SENSORS)
+		siteConfig[site].valid = false;
+}
+
+/*!
+ * @brief      Reads sensor config
+ *
+ * @details    Prints the config of the sensor with address specified in input parameter.
+ * 				The sensor is only accessed if its cached config is not valid.
+ */
+SENSOR_RESULT CN0429_GetSensorCfg(uint8_t sensor_address)
+{
+	uint8_t site = CN0429_SiteIndex(sensor_address);
+	SiteConfig *cfg;
+
+	if (site >= NUM_SENSORS)
+		return SENSOR_ERROR_GAS;
+	cfg = &siteConfig[site];
+
+	if (!cfg->valid) {
+		eSensorResult = CN0429_ReadSensorCfg(site);
+		if (eSensorResult != SENSOR_ERROR_NONE)
+			return eSensorResult;
 	}
 
+	snprintf((char*) TXbuff, 256, "Config of sensor on site %d:%s", site + 1,
+		_EOS);
 	UART_TX((const char*) TXbuff);
-	delay_ms(5);
 
-	flushBuff(pBuff, sizeof(pBuff));
-	eSensorResult = pGasSensor->ReadTIAGain(pBuff);
-	if (eSensorResult != SENSOR_ERROR_NONE)
-		return eSensorResult;
-	flushBuff(TXbuff, sizeof(TXbuff));
-	snprintf((char*) TXbuff, 256, "RTIA = %s ohm%s", rtia[pBuff[0]], _EOS);
+	snprintf((char*) TXbuff, 256, "RTIA = %s ohm%s", rtia[cfg->rtia], _EOS);
 	UART_TX((const char*) TXbuff);
-	delay_ms(5);
 
-	flushBuff(pBuff, sizeof(pBuff));
-	eSensorResult = pGasSensor->ReadRload(pBuff);
-	if (eSensorResult != SENSOR_ERROR_NONE)
-		return eSensorResult;
-	flushBuff(TXbuff, sizeof(TXbuff));
-	snprintf((char*) TXbuff, 256, "Rload = %s ohm%s", rload[pBuff[0]], _EOS);
+	snprintf((char*) TXbuff, 256, "Rload = %s ohm%s", rload[cfg->rload], _EOS);
 	UART_TX((const char*) TXbuff);
-	delay_ms(5);
 
-	eSensorResult = pGasSensor->ReadSensorBias(&sigVal);
-	if (eSensorResult != SENSOR_ERROR_NONE)
-		return eSensorResult;
-	flushBuff(TXbuff, sizeof(TXbuff));
-	snprintf((char*) TXbuff, 256, "Vbias = %d mV%s", sigVal, _EOS);
+	snprintf((char*) TXbuff, 256, "Vbias = %d mV%s", cfg->vbias, _EOS);
 	UART_TX((const char*) TXbuff);
-	delay_ms(5);
 
-	eSensorResult = pGasSensor->ReadSensorSensitivity(&unsiglVal);
-	if (eSensorResult != SENSOR_ERROR_NONE)
-		return eSensorResult;
-	flushBuff(TXbuff, sizeof(TXbuff));
 	snprintf((char*) TXbuff, 256, "Sensitivity = %.2f nA/ppm%s",
-		(unsiglVal / 100.0), _EOS);
+		(cfg->sensitivity / 100.0), _EOS);
 	UART_TX((const char*) TXbuff);
-	delay_ms(5);
 
-	eSensorResult = pGasSensor->ReadMeasurementTime(&unsigVal);
-	if (eSensorResult != SENSOR_ERROR_NONE)
-		return eSensorResult;
-	flushBuff(TXbuff, sizeof(TXbuff));
-	snprintf((char*) TXbuff, 256, "Measurement Time = %d msec%s", unsigVal, _EOS);
+	snprintf((char*) TXbuff, 256, "Measurement Time = %d msec%s",
+		cfg->measTime, _EOS);
 	UART_TX((const char*) TXbuff);
-	delay_ms(5);
-
-	eSensorResult = pGasSensor->close();
-	delay_ms(5);
 
-	return eSensorResult;
+	return SENSOR_ERROR_NONE;
 }
 
 /*!
- * @brief      Reads averaged ppb value from gas sensor
+ * @brief      Reads ppb, temperature and humidity from all detected sensors
  *
- * @details    Reads sensor data utilizing custom gas sensor I2C library and sends this data over UART.
+ * @details    The M355 answers a read command only after it had time to prepare the data,
+ * 				so every read is issued twice with RESPONSE_DELAY_MS in between. Instead of
+ * 				waiting once per site and per value, the command is first issued to all
+ * 				sites, the delay is waited once and then the results are collected from all
+ * 				sites. The I2C driver is opened once for the whole cycle.
  */
-int32_t CN0429_SensorReadoutPPB(uint8_t sensor_address)
+SENSOR_RESULT CN0429_ReadAllSites(void)
 {
-	int32_t PPB_Gas_Reading = 0;
-	eSensorResult = pGasSensor->open(sensor_address);
-	eSensorResult = pGasSensor->ReadDataPPB(&PPB_Gas_Reading);
-	eSensorResult = pGasSensor->close();
-	delay_ms(10);
-	return PPB_Gas_Reading;
+	const uint8_t cmd[3] = { READ_AVG_PPB, READ_TEMPERATURE, READ_HUMIDITY };
+	const uint8_t len[3] = { 4, 2, 2 };
+	uint8_t pBuff[4];
+	uint8_t i, j;
+	SENSOR_RESULT Result;
+
+	Result = pGasSensor->open(uiDefaultAddress);
+	if (Result != SENSOR_ERROR_NONE)
+		return Result;
+
+	for (i = 0; i < NUM_SENSORS; i++)
+		siteReadings[i].valid = detected_sensors[i];
+
+	for (j = 0; j < 3; j++) {
+		/* Issue the command to all sites */
+		for (i = 0; i < NUM_SENSORS; i++) {
+			if (!siteReadings[i].valid)
+				continue;
+			pGasSensor->SelectSensor(sensor_addresses[i]);
+			if (pGasSensor->I2CReadWrite(READ, cmd[j], pBuff, len[j]) !=
+			    SENSOR_ERROR_NONE)
+				siteReadings[i].valid = false;
+		}
+
+		delay_ms(RESPONSE_DELAY_MS);
+
+		/* Collect the prepared data */
+		for (i = 0; i < NUM_SENSORS; i++) {
+			if (!siteReadings[i].valid)
+				continue;
+			pGasSensor->SelectSensor(sensor_addresses[i]);
+			if (pGasSensor->I2CReadWrite(READ, cmd[j], pBuff, len[j]) !=
+			    SENSOR_ERROR_NONE) {
+				siteReadings[i].valid = false;
+				continue;
+			}
+			switch (cmd[j]) {
+			case READ_AVG_PPB:
+				siteReadings[i].ppb = (pBuff[0] << 24) | (pBuff[1] << 16) |
+						      (pBuff[2] << 8) | pBuff[3];
+				break;
+			case READ_TEMPERATURE:
+				siteReadings[i].temperature = (pBuff[0] << 8) | pBuff[1];
+				break;
+			default:
+				siteReadings[i].humidity = (pBuff[0] << 8) | pBuff[1];
+				break;
+			}
+		}
+	}
+
+	return pGasSensor->close();
 }
 
 /**
@@ -585,6 +689,7 @@ void CN0429_CfgMeasTime(uint8_t *args)
 	eSensorResult = pGasSensor->open(uiDefaultAddress);
 	flushBuff(TXbuff, sizeof(TXbuff));
 	eSensorResult = pGasSensor->SetMeasurementTime(value);
+	CN0429_InvalidateSensorCfg(uiDefaultAddress);
 	if (eSensorResult != SENSOR_ERROR_NONE) {
 		UART_TX("ERROR!" _EOS);
 	} else {
@@ -635,6 +740,7 @@ void CN0429_CfgRtia(uint8_t *args)
 	eSensorResult = pGasSensor->open(uiDefaultAddress);
 	flushBuff(TXbuff, sizeof(TXbuff));
 	eSensorResult = pGasSensor->SetTIAGain(value);
+	CN0429_InvalidateSensorCfg(uiDefaultAddress);
 	if (eSensorResult != SENSOR_ERROR_NONE) {
 		UART_TX("ERROR!" _EOS);
 	} else {
@@ -687,6 +793,7 @@ void CN0429_CfgVbias(uint8_t *args)
 	eSensorResult = pGasSensor->open(uiDefaultAddress);
 	flushBuff(TXbuff, sizeof(TXbuff));
 	eSensorResult = pGasSensor->SetSensorBias(value);
+	CN0429_InvalidateSensorCfg(uiDefaultAddress);
 	if (eSensorResult != SENSOR_ERROR_NONE) {
 		UART_TX("ERROR!" _EOS);
 	} else {
@@ -749,6 +856,7 @@ void CN0429_CfgSens(uint8_t *args)
 	eSensorResult = pGasSensor->open(uiDefaultAddress);
 	flushBuff(TXbuff, sizeof(TXbuff));
 	eSensorResult = pGasSensor->SetSensorSensitivity(value * 100);
+	CN0429_InvalidateSensorCfg(uiDefaultAddress);
 	if (eSensorResult != SENSOR_ERROR_NONE) {
 		UART_TX("ERROR!" _EOS);
 	} else {
@@ -767,28 +875,72 @@ void CN0429_CfgSens(uint8_t *args)
  **/
 void CN0429_RunEIS(uint8_t *args)
 {
-	eSensorResult = pGasSensor->open(uiDefaultAddress);
-	flushBuff(TXbuff, sizeof(TXbuff));
-	eSensorResult = pGasSensor->RunEISMeasurement();
-	if (eSensorResult != SENSOR_ERROR_NONE) {
-		UART_TX("ERROR!" _EOS);
+	uint8_t *p = args;
+	char arg[17] = "";
+
+	/* Check if this function gets an argument */
+	while (*(p = FindArgv(p)) != '\0') {
+		/* Save site parameter */
+		GetArgv(arg, p);
+	}
+
+	eisAllSites = (strncmp(arg, "a", 2) == 0);
+
+	for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+		if (eisAllSites) {
+			if (!detected_sensors[i])
+				continue;
+			eSensorResult = pGasSensor->open(sensor_addresses[i]);
+		} else {
+			if (i > 0)
+				break;
+			eSensorResult = pGasSensor->open(uiDefaultAddress);
+		}
+		eSensorResult = pGasSensor->RunEISMeasurement();
 		pGasSensor->close();
-		return;
-	} else {
-		snprintf((char*) TXbuff, 256, "EIS test started. Depending on the frequency range,%s", _EOS);
-		UART_TX((const char*) TXbuff);
-		flushBuff(TXbuff, sizeof(TXbuff));
-		snprintf((char*) TXbuff, 256, "this can take several minutes. Don't enter additional%s", _EOS);
-		UART_TX((const char*) TXbuff);
-		flushBuff(TXbuff, sizeof(TXbuff));
-		snprintf((char*) TXbuff, 256, "commands until the test is finished.%s", _EOS);
-		UART_TX((const char*) TXbuff);
+		if (eSensorResult != SENSOR_ERROR_NONE) {
+			UART_TX("ERROR!" _EOS);
+			eisAllSites = false;
+			return;
+		}
 	}
-	pGasSensor->close();
+
+	flushBuff(TXbuff, sizeof(TXbuff));
+	snprintf((char*) TXbuff, 256, "EIS test started. Depending on the frequency range,%s", _EOS);
+	UART_TX((const char*) TXbuff);
+	flushBuff(TXbuff, sizeof(TXbuff));
+	snprintf((char*) TXbuff, 256, "this can take several minutes. Don't enter additional%s", _EOS);
+	UART_TX((const char*) TXbuff);
+	flushBuff(TXbuff, sizeof(TXbuff));
+	snprintf((char*) TXbuff, 256, "commands until the test is finished.%s", _EOS);
+	UART_TX((const char*) TXbuff);
 
 	eisTestInProgress = true;
 }
 
+/*!
+ * @brief      Waits until the running pulse or EIS test is finished
+ *
+ * @details    SensorInit() only returns once the ADuCM355 is idle again. After an EIS test
+ * 				started on all sites every detected sensor is checked.
+ */
+SENSOR_RESULT CN0429_WaitTestDone(void)
+{
+	SENSOR_RESULT Result = SENSOR_ERROR_NONE;
+
+	if (!eisAllSites)
+		return pGasSensor->SensorInit(uiDefaultAddress);
+
+	for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+		if (detected_sensors[i] &&
+		    pGasSensor->SensorInit(sensor_addresses[i]) != SENSOR_ERROR_NONE)
+			Result = SENSOR_ERROR_GAS;
+	}
+	eisAllSites = false;
+
+	return Result;
+}
+
 /**
  @brief Read electrochemical impedance spectroscopy results
  @param args - pointer to the arguments on the command line.
@@ -903,6 +1055,172 @@ void CN0429_RdEISfull(uint8_t *args)
 	pGasSensor->close();
 }
 
+/*!
+ * @brief      Reads a full EIS sweep and computes the sensor impedance
+ *
+ * @details    For every frequency the M355 sends the raw DFT results of the Rsens+Rload,
+ * 				Rload and Rcal measurements. The impedance of each path is obtained
+ * 				ratiometrically against Rcal, Z = Rcal * DFT(Rcal) / DFT(Z), and the sensor
+ * 				impedance is the difference of the two paths. All math is done in single
+ * 				precision.
+ */
+SENSOR_RESULT CN0429_ReadEISSweep(uint8_t sensor_address, EISPoint *points)
+{
+	const uint32_t *word;
+	float zr[2], zi[2];
+	float re, im, den;
+
+	eSensorResult = pGasSensor->open(sensor_address);
+	if (eSensorResult != SENSOR_ERROR_NONE)
+		return eSensorResult;
+	memset(EISResponseBuff, 0, sizeof(EISResponseBuff));
+	eSensorResult = pGasSensor->ReadEISResultsFull(EISResponseBuff);
+	pGasSensor->close();
+	if (eSensorResult != SENSOR_ERROR_NONE)
+		return eSensorResult;
+
+	memcpy(EISresults, EISResponseBuff,
+	       EIS_NUM_FREQ * EIS_FULL_WORDS * sizeof(EISresults[0]));
+
+	for (uint8_t j = 0; j < EIS_NUM_FREQ; j++) {
+		word = &EISresults[j * EIS_FULL_WORDS];
+		memcpy(&points[j].freq, &word[0], sizeof(float));
+		memcpy(points[j].dft, &word[1], sizeof(points[j].dft));
+
+		/* Z = Rcal * (rcal_re + j*rcal_im) / (re + j*im) for both paths */
+		for (uint8_t k = 0; k < 2; k++) {
+			re = (float) points[j].dft[2 * k];
+			im = (float) points[j].dft[2 * k + 1];
+			den = re * re + im * im;
+			if (den == 0.0f) {
+				zr[k] = 0.0f;
+				zi[k] = 0.0f;
+				continue;
+			}
+			zr[k] = EIS_RCAL_OHM * ((float) points[j].dft[4] * re +
+						(float) points[j].dft[5] * im) / den;
+			zi[k] = EIS_RCAL_OHM * ((float) points[j].dft[5] * re -
+						(float) points[j].dft[4] * im) / den;
+		}
+
+		points[j].real = zr[0] - zr[1];
+		points[j].imag = zi[0] - zi[1];
+		points[j].mag = sqrtf(points[j].real * points[j].real +
+				      points[j].imag * points[j].imag);
+		points[j].phase = atan2f(points[j].imag, points[j].real) *
+				  (180.0f / 3.14159265f);
+	}
+
+	return SENSOR_ERROR_NONE;
+}
+
+/*!
+ * @brief      Extracts Randles equivalent circuit features from an EIS sweep
+ *
+ * @details    Rs is the real part at the highest frequency, Rs + Rct the real part at the
+ * 				lowest frequency and fpeak the frequency of the largest capacitive phase.
+ */
+void CN0429_EISFeatures(const EISPoint *points, EISFeatures *feat)
+{
+	uint8_t lo = 0, hi = 0, pk = 0;
+
+	for (uint8_t j = 1; j < EIS_NUM_FREQ; j++) {
+		if (points[j].freq < points[lo].freq)
+			lo = j;
+		if (points[j].freq > points[hi].freq)
+			hi = j;
+		if (fabsf(points[j].phase) > fabsf(points[pk].phase))
+			pk = j;
+	}
+
+	feat->rs = points[hi].real;
+	feat->rct = points[lo].real - points[hi].real;
+	feat->fpeak = points[pk].freq;
+}
+
+/*!
+ * @brief      Builds the binary EIS frame
+ *
+ * @details    Layout, little endian: 0xA5 0x5A, site, number of points, then for each point
+ * 				frequency (float), 6 raw DFT values (int32), magnitude and phase (float),
+ * 				then Rs, Rct and fpeak (float) and a 16 bit sum of all bytes after the sync.
+ * 				Returns the frame length.
+ */
+uint16_t CN0429_EISFrame(uint8_t site, const EISPoint *points,
+			 const EISFeatures *feat, uint8_t *frame)
+{
+	uint16_t len = 0;
+	uint16_t sum = 0;
+
+	frame[len++] = EIS_FRAME_SYNC0;
+	frame[len++] = EIS_FRAME_SYNC1;
+	frame[len++] = site;
+	frame[len++] = EIS_NUM_FREQ;
+
+	for (uint8_t j = 0; j < EIS_NUM_FREQ; j++) {
+		memcpy(&frame[len], &points[j].freq, 4);
+		len += 4;
+		memcpy(&frame[len], points[j].dft, sizeof(points[j].dft));
+		len += sizeof(points[j].dft);
+		memcpy(&frame[len], &points[j].mag, 4);
+		len += 4;
+		memcpy(&frame[len], &points[j].phase, 4);
+		len += 4;
+	}
+
+	memcpy(&frame[len], &feat->rs, 4);
+	len += 4;
+	memcpy(&frame[len], &feat->rct, 4);
+	len += 4;
+	memcpy(&frame[len], &feat->fpeak, 4);
+	len += 4;
+
+	for (uint16_t i = 2; i < len; i++)
+		sum += frame[i];
+	frame[len++] = sum & 0xFF;
+	frame[len++] = sum >> 8;
+
+	return len;
+}
+
+/**
+ @brief Send electrochemical impedance spectroscopy results as binary frames
+ @param args - pointer to the arguments on the command line.
+ a: send one frame for each detected site, back to back
+ @return none
+ **/
+void CN0429_RdEISbin(uint8_t *args)
+{
+	uint8_t *p = args;
+	char arg[17] = "";
+	EISFeatures feat;
+	uint16_t len;
+
+	/* Check if this function gets an argument */
+	while (*(p = FindArgv(p)) != '\0') {
+		/* Save site parameter */
+		GetArgv(arg, p);
+	}
+
+	for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+		if (strncmp(arg, "a", 2) == 0) {
+			if (!detected_sensors[i])
+				continue;
+		} else if (sensor_addresses[i] != uiDefaultAddress) {
+			continue;
+		}
+
+		if (CN0429_ReadEISSweep(sensor_addresses[i], EISsweep) !=
+		    SENSOR_ERROR_NONE) {
+			UART_TX("ERROR!" _EOS);
+			return;
+		}
+		CN0429_EISFeatures(EISsweep, &feat);
+		len = CN0429_EISFrame(i + 1, EISsweep, &feat, EISFrameBuff);
+		UART_TX_BIN(EISFrameBuff, len);
+	}
+}
+
 /**
  @brief Read the value of the 200R calibration resistor
  @param args - pointer to the arguments on the command line.
@@ -1117,6 +1435,7 @@ void CN0429_CfgRload(uint8_t *args)
 	eSensorResult = pGasSensor->open(uiDefaultAddress);
 	flushBuff(TXbuff, sizeof(TXbuff));
 	eSensorResult = pGasSensor->SetRload((uint8_t) value);
+	CN0429_InvalidateSensorCfg(uiDefaultAddress);
 	if (eSensorResult != SENSOR_ERROR_NONE) {
 		UART_TX("ERROR!" _EOS);
 	} else {
@@ -1128,23 +1447,25 @@ void CN0429_CfgRload(uint8_t *args)
 }
 
 /**
- @brief Read ppb value of all sensors
+ @brief Read ppb value, temperature and humidity of all sensors
  @param args - pointer to the arguments on the command line.
  @return none
  **/
 void CN0429_RdSensors(uint8_t *args)
 {
 	flushBuff(TXbuff, sizeof(TXbuff));
-	if (detected_sensors[0])
-		strcat((char*) TXbuff, "Sensor 1[ppb], ");
-	if (detected_sensors[1])
-		strcat((char*) TXbuff, "Sensor 2[ppb], ");
-	if (detected_sensors[2])
-		strcat((char*) TXbuff, "Sensor 3[ppb], ");
-	if (detected_sensors[3])
-		strcat((char*) TXbuff, "Sensor 4[ppb], ");
+	strcat((char*) TXbuff, "Time[ms], ");
+	for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+		if (detected_sensors[i]) {
+			snprintf((char*) gBuff, 64,
+				"Sensor %d[ppb], T%d[degC], RH%d[%%], ", i + 1, i + 1,
+				i + 1);
+			strcat((char*) TXbuff, (char*) gBuff);
+		}
+	}
 	UART_TX((const char*) TXbuff);
-	tickCnt = (100 * streamTickCfg);	// force immediate readout after stream enabled
+	streamStartMs = GetMsTicks();
+	streamNextMs = streamStartMs;	/* force immediate readout after stream enabled */
 	FSM_State = STREAM_GAS;
 }
 
@@ -1156,7 +1477,6 @@ void CN0429_RdSensors(uint8_t *args)
 void CN0429_StopRd(uint8_t *args)
 {
 	FSM_State = COMMAND;
-	tickCnt = 0;
 	UART_TX("Data reading interrupted!" _EOS);
 }
 
@@ -1209,14 +1529,24 @@ void CN0429_CfgUpdateRate(uint8_t *args)
  **/
 void CN0429_StreamData(void)
 {
+	uint32_t timestamp = GetMsTicks() - streamStartMs;
+
+	CN0429_ReadAllSites();
+
 	flushBuff(TXbuff, sizeof(TXbuff));
+	snprintf((char*) TXbuff, 256, "%lu, ", timestamp);
 	for (uint8_t i = 0; i < NUM_SENSORS; i++) {
-		if (detected_sensors[i]) {
-			flushBuff(gBuff, sizeof(gBuff));
-			snprintf((char*) gBuff, 64, "%ld, ",
-				CN0429_SensorReadoutPPB(sensor_addresses[i]));
-			strcat((char*) TXbuff, (char*) gBuff);
-		}
+		if (!detected_sensors[i])
+			continue;
+		flushBuff(gBuff, sizeof(gBuff));
+		if (siteReadings[i].valid)
+			snprintf((char*) gBuff, 64, "%ld, %2.2f, %2.2f, ",
+				siteReadings[i].ppb,
+				siteReadings[i].temperature / 100.0,
+				siteReadings[i].humidity / 100.0);
+		else
+			strcpy((char*) gBuff, "ERR, ERR, ERR, ");
+		strcat((char*) TXbuff, (char*) gBuff);
 	}
 	UART_TX((const char*) TXbuff);
 }
@@ -77,6 +77,20 @@ using namespace adi_sensor_swpack;
 
 #define NUM_SENSORS		4
 
+/* EIS sweep layout and binary transfer frame */
+#define EIS_NUM_FREQ		12	/* frequency points in one sweep */
+#define EIS_FULL_WORDS		17	/* 32 bit words per point in FULL results */
+#define EIS_NUM_DFT		6	/* real/imag DFT pairs: Rsens+Rload, Rload, Rcal */
+#define EIS_RCAL_OHM		200.0f	/* calibration resistor of the sensor board */
+#define EIS_FRAME_SYNC0		0xA5
+#define EIS_FRAME_SYNC1		0x5A
+#define EIS_FRAME_HDR_SIZE	4	/* sync, sync, site, number of points */
+#define EIS_FRAME_POINT_SIZE	36	/* freq, 6 x DFT, magnitude, phase */
+#define EIS_FRAME_FEAT_SIZE	12	/* Rs, Rct, peak phase frequency */
+#define EIS_FRAME_SIZE		(EIS_FRAME_HDR_SIZE + \
+				 EIS_NUM_FREQ * EIS_FRAME_POINT_SIZE + \
+				 EIS_FRAME_FEAT_SIZE + 2)
+
 /* CN0428 command for how many bytes to read from slave */
 #define BYTES_TO_READ		0x61
 
@@ -92,6 +106,41 @@ EXTERNC uint8_t cmdInString[64];
 
 EXTERNC struct RingBuf RX, TX;
 
+/* Readings collected from one site during a stream cycle */
+typedef struct {
+	bool valid;
+	int32_t ppb;
+	int16_t temperature;	/* degC * 100 */
+	int16_t humidity;	/* %RH * 100 */
+} SiteReadings;
+
+/* Cached configuration of one site, refreshed only after a setting changes */
+typedef struct {
+	bool valid;
+	uint8_t rtia;
+	uint8_t rload;
+	int16_t vbias;		/* mV */
+	uint32_t sensitivity;	/* nA/ppm * 100 */
+	uint16_t measTime;	/* msec */
+} SiteConfig;
+
+/* One frequency point of an EIS sweep */
+typedef struct {
+	float freq;			/* Hz */
+	int32_t dft[EIS_NUM_DFT];	/* raw DFT results as sent by the M355 */
+	float real;			/* sensor impedance, ohm */
+	float imag;
+	float mag;
+	float phase;			/* degrees */
+} EISPoint;
+
+/* Simple Randles circuit features extracted from one EIS sweep */
+typedef struct {
+	float rs;			/* series (solution) resistance, ohm */
+	float rct;			/* charge transfer resistance, ohm */
+	float fpeak;			/* frequency of the phase peak, Hz */
+} EISFeatures;
+
 typedef enum {
 	INIT = 0,
 	COMMAND,
@@ -125,6 +174,12 @@ void CN0429_CfgSens(uint8_t *args);
 void CN0429_RunEIS(uint8_t *args);
 void CN0429_RdEIS(uint8_t *args);
 void CN0429_RdEISfull(uint8_t *args);
+void CN0429_RdEISbin(uint8_t *args);
+SENSOR_RESULT CN0429_ReadEISSweep(uint8_t sensor_address, EISPoint *points);
+void CN0429_EISFeatures(const EISPoint *points, EISFeatures *feat);
+uint16_t CN0429_EISFrame(uint8_t site, const EISPoint *points,
+			 const EISFeatures *feat, uint8_t *frame);
+SENSOR_RESULT CN0429_WaitTestDone(void);
 void CN0429_RdRcal(uint8_t *args);
 void CN0429_RunPulse(uint8_t *args);
 void CN0429_ReadPulse(uint8_t *args);
@@ -134,6 +189,10 @@ void CN0429_RdSensors(uint8_t *args);
 void CN0429_StopRd(uint8_t *args);
 void CN0429_CfgUpdateRate(uint8_t *args);
 void CN0429_StreamData(void);
+uint8_t CN0429_SiteIndex(uint8_t sensor_address);
+SENSOR_RESULT CN0429_ReadSensorCfg(uint8_t site);
+void CN0429_InvalidateSensorCfg(uint8_t sensor_address);
+SENSOR_RESULT CN0429_ReadAllSites(void);
 
 /*
  *	CN0428 Function Declarations
@@ -154,8 +213,10 @@ double Ieee754ConvertToDouble(uint8_t s[32]);
 
 EXTERNC void delay_ms(uint32_t mSec);
 EXTERNC void delay_us(uint32_t uSec);
+EXTERNC uint32_t GetMsTicks(void);
 
 EXTERNC GResult UART_TX(const char *initialcmd);
 EXTERNC GResult UART_TX_DIR(const char *initialcmd);
+EXTERNC GResult UART_TX_BIN(const uint8_t *data, uint16_t len);
 
 #endif /* CN0428_CN0429_H_ */
@@ -0,0 +1,99 @@
+"""Generate eis_capture.bin and eis_capture.csv for test_eis_decode.py.
+
+The capture holds readeisbin frames for Randles cells (Rs in series with
+Rct || Cdl). The raw DFT values are those the M355 reports for the
+Rsens+Rload, Rload and Rcal paths, DFT = K * exp(j * theta) / Z with an
+arbitrary phase theta per frequency, rounded to integers. Magnitude, phase
+and features follow the single precision math of CN0429_ReadEISSweep() and
+CN0429_EISFeatures(). The expected CSV holds the exact impedances of the
+modeled cells.
+
+Usage:
+    python3 make_eis_capture.py
+"""
+
+import cmath
+import math
+import struct
+
+FREQS = (20000.0, 10000.0, 5000.0, 2000.0, 1000.0, 500.0, 200.0, 100.0,
+         50.0, 20.0, 10.0, 5.0)
+RCAL = 200.0
+RLOAD = 10.0
+K = 4.0e6
+# site, Rs, Rct, Cdl
+CELLS = ((1, 50.0, 500.0, 10e-6), (2, 120.0, 2000.0, 2e-6))
+
+
+def f32(x):
+    """Round to single precision."""
+    return struct.unpack('<f', struct.pack('<f', x))[0]
+
+
+def cell_z(rs, rct, cdl, freq):
+    """Impedance of a Randles cell."""
+    w = 2 * math.pi * freq
+    return rs + rct / complex(1, w * rct * cdl)
+
+
+def dft(z, theta):
+    """DFT result of a path of impedance z."""
+    v = K * cmath.exp(1j * theta) / z
+    return int(round(v.real)), int(round(v.imag))
+
+
+def sweep(rs, rct, cdl):
+    """Return the points (freq, dft, real, imag, mag, phase) of one sweep."""
+    points = []
+    for i, freq in enumerate(FREQS):
+        theta = 0.37 * i - 1.1
+        d = (dft(cell_z(rs, rct, cdl, freq) + RLOAD, theta) +
+             dft(RLOAD, theta) + dft(RCAL, theta))
+        zr, zi = [], []
+        for k in range(2):
+            re, im = f32(d[2 * k]), f32(d[2 * k + 1])
+            den = f32(f32(re * re) + f32(im * im))
+            zr.append(f32(f32(RCAL * f32(f32(d[4] * re) + f32(d[5] * im))) / den))
+            zi.append(f32(f32(RCAL * f32(f32(d[5] * re) - f32(d[4] * im))) / den))
+        real, imag = f32(zr[0] - zr[1]), f32(zi[0] - zi[1])
+        mag = f32(math.sqrt(f32(f32(real * real) + f32(imag * imag))))
+        phase = f32(math.atan2(imag, real) * f32(180.0 / 3.14159265))
+        points.append((f32(freq), d, real, imag, mag, phase))
+    return points
+
+
+def frame(site, points):
+    """Build the frame of CN0429_EISFrame()."""
+    lo = min(range(len(points)), key=lambda j: points[j][0])
+    hi = max(range(len(points)), key=lambda j: points[j][0])
+    pk = max(range(len(points)), key=lambda j: abs(points[j][5]))
+    body = struct.pack('<BB', site, len(points))
+    for freq, d, _, _, mag, phase in points:
+        body += struct.pack('<f6iff', freq, *d, mag, phase)
+    body += struct.pack('<fff', points[hi][2],
+                        f32(points[lo][2] - points[hi][2]), points[pk][0])
+    return b'\xa5\x5a' + body + struct.pack('<H', sum(body) & 0xFFFF)
+
+
+def main():
+    """Write the capture and the expected impedances."""
+    frames = {site: frame(site, sweep(rs, rct, cdl))
+              for site, rs, rct, cdl in CELLS}
+    corrupt = bytearray(frames[2])
+    corrupt[100] ^= 0x10
+    capture = (b'>readeisbin a\r\n' + frames[1] + bytes(corrupt) +
+               frames[2] + frames[1][:120])
+    with open('eis_capture.bin', 'wb') as out:
+        out.write(capture)
+    with open('eis_capture.csv', 'w') as out:
+        out.write('site, freq, real, imag, mag, phase\n')
+        for site, rs, rct, cdl in CELLS:
+            for freq in FREQS:
+                z = cell_z(rs, rct, cdl, freq)
+                out.write('%d, %g, %.6f, %.6f, %.6f, %.6f\n' %
+                          (site, freq, z.real, z.imag, abs(z),
+                           math.degrees(cmath.phase(z))))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,102 @@
+"""Known-answer test of eis_decode.py on a readeisbin capture.
+
+eis_capture.bin holds the frames of two sites, a corrupted frame between
+them and a truncated frame at the end. eis_capture.csv holds the exact
+impedances of the cells the frames were made from (see make_eis_capture.py).
+"""
+
+import contextlib
+import io
+import math
+import os
+import sys
+import unittest
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(HERE, '..', 'Scripts'))
+
+import eis_decode  # noqa: E402
+
+RCAL = 200.0
+# Rs, Rct of the modeled cells
+CELLS = {1: (50.0, 500.0), 2: (120.0, 2000.0)}
+
+
+def load_expected():
+    """Return {site: [(freq, real, imag, mag, phase)]} from the CSV."""
+    expected = {}
+    with open(os.path.join(HERE, 'eis_capture.csv')) as csv:
+        next(csv)
+        for line in csv:
+            values = [float(v) for v in line.split(',')]
+            expected.setdefault(int(values[0]), []).append(tuple(values[1:]))
+    return expected
+
+
+def sensor_z(point):
+    """Sensor impedance from the raw DFT values, in double precision."""
+    dft = point[1:7]
+    rcal = complex(dft[4], dft[5])
+    paths = [RCAL * rcal / complex(dft[2 * k], dft[2 * k + 1])
+             for k in range(2)]
+    return paths[0] - paths[1]
+
+
+class EisDecodeTest(unittest.TestCase):
+
+    def setUp(self):
+        with open(os.path.join(HERE, 'eis_capture.bin'), 'rb') as capture:
+            self.data = capture.read()
+        self.expected = load_expected()
+
+    def test_frames(self):
+        frames = list(eis_decode.decode_frames(self.data))
+        # the corrupted frame is skipped, the truncated one is not complete
+        self.assertEqual([f[0] for f in frames], [1, 2])
+        for site, points, _, end in frames:
+            self.assertEqual(len(points), 12)
+            start = end - eis_decode.frame_size(12)
+            self.assertEqual(self.data[start:start + 3],
+                             eis_decode.SYNC + bytes([site]))
+
+    def test_impedance(self):
+        for site, points, _, _ in eis_decode.decode_frames(self.data):
+            for point, exp in zip(points, self.expected[site]):
+                freq, real, imag, mag, phase = exp
+                self.assertEqual(point[0], freq)
+                # magnitude and phase computed on the board
+                self.assertAlmostEqual(point[7] / mag, 1.0, delta=1e-3)
+                self.assertAlmostEqual(point[8], phase, delta=0.05)
+                # the raw DFT values give the same impedance
+                z = sensor_z(point)
+                self.assertAlmostEqual(z.real, real, delta=1e-3 * mag)
+                self.assertAlmostEqual(z.imag, imag, delta=1e-3 * mag)
+
+    def test_features(self):
+        for site, _, (rs, rct, fpeak), _ in eis_decode.decode_frames(self.data):
+            exp = self.expected[site]
+            hi = max(exp, key=lambda p: p[0])
+            lo = min(exp, key=lambda p: p[0])
+            peak = max(exp, key=lambda p: abs(p[4]))
+            self.assertAlmostEqual(rs, hi[1], delta=0.05)
+            self.assertAlmostEqual(rct, lo[1] - hi[1], delta=0.5)
+            self.assertEqual(fpeak, peak[0])
+            # close to the cell values for this frequency range
+            self.assertAlmostEqual(rs, CELLS[site][0], delta=0.01 * CELLS[site][0])
+            self.assertLess(abs(rct - CELLS[site][1]), 0.05 * CELLS[site][1])
+
+    def test_print_tail(self):
+        out = io.StringIO()
+        with contextlib.redirect_stdout(out):
+            tail = eis_decode.print_frames(self.data)
+        # the truncated frame is kept for the next read
+        self.assertTrue(tail.startswith(eis_decode.SYNC))
+        self.assertLess(len(tail), eis_decode.frame_size(12))
+        lines = out.getvalue().splitlines()
+        self.assertEqual(len(lines), 2 * (2 + 12))
+        self.assertTrue(lines[0].startswith('Site 1: Rs = 50.'))
+        self.assertTrue(math.isclose(float(lines[2].split(',')[0]), 20000.0))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -57,6 +57,12 @@
 #include "spi_extra.h"
 #include "app_config.h"
 
+#if CN0503_FLASH_KV_ADDR + CN0503_FLASH_KV_PAGES * 0x800 > \
+	CN0503_FLASH_FLUO_CALIB_ADDR - \
+	(CN0503_FLASH_FLUO_SLOTS * CN0503_FLASH_FLUO_MAX_PAGES - 1) * 0x800
+#error "The flash key/value store overlaps the fluorescence calibration slots."
+#endif
+
 /******************************************************************************/
 /************************** Variable Definitions ******************************/
 /******************************************************************************/
@@ -1858,6 +1864,57 @@ int32_t cn0503_flash_swbuff_clear(struct cn0503_dev *dev, uint8_t *arg)
 	return SUCCESS;
 }
 
+/**
+ * @brief Load the user defaults from the key/value store. The buffer is saved
+ *        in chunks, missing chunks are erased.
+ * @param [in] dev - The device structure.
+ * @param [out] buff - Buffer of CN0503_FLASH_BUFF_SIZE words.
+ * @return void
+ */
+static void cn0503_flash_uu_load(struct cn0503_dev *dev, uint32_t *buff)
+{
+	uint16_t i, j, size;
+
+	for (i = 0; i < CN0503_FLASH_BUFF_SIZE; i += CN0503_KV_UU_CHUNK_SIZE) {
+		size = CN0503_KV_UU_CHUNK_SIZE;
+		if (flash_kv_read(dev->kv_handler,
+				  CN0503_KV_UU_KEY + i / CN0503_KV_UU_CHUNK_SIZE,
+				  &buff[i], &size) == SUCCESS)
+			continue;
+		for (j = 0; j < CN0503_KV_UU_CHUNK_SIZE; j++)
+			buff[i + j] = 0xFFFFFFFF;
+	}
+}
+
+/**
+ * @brief Save the user defaults in the key/value store. Only the chunks that
+ *        changed are written and erased chunks are deleted.
+ * @param [in] dev - The device structure.
+ * @param [in] buff - Buffer of CN0503_FLASH_BUFF_SIZE words.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t cn0503_flash_uu_save(struct cn0503_dev *dev, uint32_t *buff)
+{
+	uint16_t i, j, key;
+	int32_t ret;
+
+	for (i = 0; i < CN0503_FLASH_BUFF_SIZE; i += CN0503_KV_UU_CHUNK_SIZE) {
+		key = CN0503_KV_UU_KEY + i / CN0503_KV_UU_CHUNK_SIZE;
+		for (j = 0; j < CN0503_KV_UU_CHUNK_SIZE; j++)
+			if (buff[i + j] != 0xFFFFFFFF)
+				break;
+		if (j == CN0503_KV_UU_CHUNK_SIZE)
+			ret = flash_kv_delete(dev->kv_handler, key);
+		else
+			ret = flash_kv_write(dev->kv_handler, key, &buff[i],
+					     CN0503_KV_UU_CHUNK_SIZE);
+		if (ret != SUCCESS)
+			return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
 /**
  * @brief CLI command to load the flash software buffer from the flash memory.
  * @param [in] dev - The device structure.
@@ -1874,8 +1931,7 @@ int32_t cn0503_flash_swbuff_load(struct cn0503_dev *dev, uint8_t *arg)
 					(uint8_t*) "Argument error.\n");
 
 	if (opt == 0) {
-		flash_read(dev->flash_handler, dev->uu_flash_page_addr,
-			   dev->sw_flash_buffer, CN0503_FLASH_BUFF_SIZE);
+		cn0503_flash_uu_load(dev, dev->sw_flash_buffer);
 		cli_write_string(dev->cli_handler,
 				 (uint8_t*)"RESP: FL_LOAD 0\n");
 	} else if (opt == 1) {
@@ -1908,8 +1964,7 @@ int32_t cn0503_flash_program(struct cn0503_dev *dev, uint8_t *arg)
 					(uint8_t*) "Argument error.\n");
 
 	if (opt == 0) {
-		ret = flash_write(dev->flash_handler, dev->uu_flash_page_addr,
-				  dev->sw_flash_buffer, CN0503_FLASH_BUFF_SIZE);
+		ret = cn0503_flash_uu_save(dev, dev->sw_flash_buffer);
 		if (ret != SUCCESS)
 			return FAILURE;
 		cli_write_string(dev->cli_handler,
@@ -1951,8 +2006,7 @@ int32_t cn0503_flash_erase(struct cn0503_dev *dev, uint8_t *arg)
 		temp_buff[i] = 0xFFFFFFFF;
 
 	if (opt == 0) {
-		ret = flash_write(dev->flash_handler, dev->uu_flash_page_addr,
-				  temp_buff, CN0503_FLASH_BUFF_SIZE);
+		ret = cn0503_flash_uu_save(dev, temp_buff);
 		if (ret != SUCCESS)
 			return FAILURE;
 		cli_write_string(dev->cli_handler,
@@ -4657,7 +4711,8 @@ int32_t cn0503_fluo_decay_calibrate(struct cn0503_dev *dev, uint8_t *arg)
 	if (ret != SUCCESS)
 		goto rollback_return;
 
-	if (impresp->calib_slot != 1 && impresp->calib_slot != 2) {
+	if (impresp->calib_slot < 1 ||
+	    impresp->calib_slot > CN0503_FLASH_FLUO_SLOTS) {
 		cli_write_string(dev->cli_handler,
 				 (uint8_t *)
 				 "FLUO DECAY ERROR: Invalid calibration slot. Must be 1 or 2.\n");
@@ -4845,7 +4900,8 @@ int32_t cn0503_fluo_decay_measure(struct cn0503_dev *dev, uint8_t *arg)
 	impresp->nb_samples = ceil(acquisition_width / impresp->sample_period) + 1;
 	impresp->chann_no--;
 	if (!impresp->skip_calib) {
-		if (impresp->calib_slot != 1 && impresp->calib_slot != 2) {
+		if (impresp->calib_slot < 1 ||
+		    impresp->calib_slot > CN0503_FLASH_FLUO_SLOTS) {
 			cli_write_string(dev->cli_handler,
 					 (uint8_t *)
 					 "FLUO DECAY ERROR: Invalid calibration slot. Must be 1 or 2.\n");
@@ -5718,6 +5774,8 @@ void cn0503_get_config(struct cn0503_init_param *init_param)
 	init_param->md_flash_page_addr = CN0503_FLASH_MD_ADDR;
 	init_param->uu_flash_page_addr = CN0503_FLASH_UU_ADDR;
 	init_param->fluo_calib_flash_page_addr = CN0503_FLASH_FLUO_CALIB_ADDR;
+	init_param->kv_param.start_addr = CN0503_FLASH_KV_ADDR;
+	init_param->kv_param.pages = CN0503_FLASH_KV_PAGES;
 
 	init_param->irq_param.irq_ctrl_id = 0;
 	init_param->irq_param.extra = NULL;
@@ -5972,6 +6030,32 @@ int32_t cn0503_calibrate_hfo(struct cn0503_dev *dev)
 	return SUCCESS;
 }
 
+/**
+ * @brief Move the user defaults saved by older firmware in the User Defaults
+ *        flash page to the key/value store and erase the page.
+ * @param [in] dev - The device structure.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t cn0503_init_flash_uu_migrate(struct cn0503_dev *dev)
+{
+	int32_t ret;
+	uint16_t i;
+
+	flash_read(dev->flash_handler, dev->uu_flash_page_addr,
+		   dev->sw_flash_buffer, CN0503_FLASH_BUFF_SIZE);
+	for (i = 0; i < CN0503_FLASH_BUFF_SIZE; i++)
+		if (dev->sw_flash_buffer[i] != 0xFFFFFFFF)
+			break;
+	if (i == CN0503_FLASH_BUFF_SIZE)
+		return SUCCESS;
+
+	ret = cn0503_flash_uu_save(dev, dev->sw_flash_buffer);
+	if (ret != SUCCESS)
+		return FAILURE;
+
+	return flash_erase_page(dev->flash_handler, dev->uu_flash_page_addr);
+}
+
 /**
  * @brief Check and update the Manufacturer Defaults flash page.
  * @param [in] dev - The device structure.
@@ -6342,6 +6426,15 @@ int32_t cn0503_init(struct cn0503_dev **device,
 	if(ret != SUCCESS)
 		goto error_dlpf;
 
+	init_param->kv_param.flash = dev->flash_handler;
+	ret = flash_kv_init(&dev->kv_handler, &init_param->kv_param);
+	if(ret != SUCCESS)
+		goto error_dlpf;
+
+	ret = cn0503_init_flash_uu_migrate(dev);
+	if(ret != SUCCESS)
+		goto error_dlpf;
+
 	ret = cn0503_init_flash_md_check(dev);
 	if(ret != SUCCESS)
 		goto error_dlpf;
@@ -6407,6 +6500,10 @@ int32_t cn0503_remove(struct cn0503_dev *dev)
 	for(i = 0; i < CN0503_RAT_NO; i++)
 		free(dev->arat_flt_data[i]);
 
+	ret = flash_kv_remove(dev->kv_handler);
+	if(ret != SUCCESS)
+		return FAILURE;
+
 	free(dev);
 
 	return SUCCESS;
@@ -46,6 +46,7 @@
 #include <stdint.h>
 #include "cli.h"
 #include "flash.h"
+#include "flash_kv.h"
 #include "irq.h"
 #include "adpd410x.h"
 
@@ -71,6 +72,14 @@
 #define CN0503_FLASH_FLUO_CALIB_ADDR 0x3D800
 #define CN0503_FLASH_FLUO_PARAM_SIZE 3
 #define CN0503_FLASH_FLUO_MAX_PAGES  5
+#define CN0503_FLASH_FLUO_SLOTS	     2
+/* Fluorescence calibration slots grow downward from
+ * CN0503_FLASH_FLUO_CALIB_ADDR, CN0503_FLASH_FLUO_MAX_PAGES pages each. The
+ * key/value store sits below them, leaving one slot of margin. */
+#define CN0503_FLASH_KV_ADDR	     0x34800
+#define CN0503_FLASH_KV_PAGES	     4
+#define CN0503_KV_UU_KEY	     0x0100
+#define CN0503_KV_UU_CHUNK_SIZE	     64
 
 #define CN0503_FLUO_DEFAULT_LED_OFF  52
 #define CN0503_IMPRESP_MAX_SAMPLES   1950
@@ -115,6 +124,8 @@ struct cn0503_init_param {
 	uint32_t uu_flash_page_addr;
 	/** User default flash page address for fluorescence calibration data */
 	uint32_t fluo_calib_flash_page_addr;
+	/** Key/value store initialization structure */
+	struct flash_kv_init_param kv_param;
 };
 
 /**
@@ -128,6 +139,8 @@ struct cn0503_dev {
 	struct adpd410x_dev *adpd4100_handler;
 	/** Flash controller handler */
 	struct flash_dev *flash_handler;
+	/** Key/value store handler holding the user defaults */
+	struct flash_kv_desc *kv_handler;
 	/** Interrupt controller handler */
 	struct irq_ctrl_desc *irq_handler;
 	/** Pointer to the CLI commands vector */
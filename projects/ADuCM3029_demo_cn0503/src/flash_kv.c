@@ -0,0 +1,646 @@
+/***************************************************************************//**
+*   @file   flash_kv.c
+*   @brief  Wear leveled flash key/value store.
+********************************************************************************
+* Copyright 2020(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "flash_kv.h"
+#include "flash_extra.h"
+#include "error.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/*
+ * Every page starts with a header of two words, the magic number XOR the
+ * sequence number of the page, then the sequence number. Pages are filled in
+ * ring order and the sequence number grows with every page opened, so it
+ * orders the pages from the oldest to the newest. A header left half erased
+ * by a reset does not check out, so the page is not taken for the newest one.
+ *
+ * Records are appended after the page header. A record is a header of two
+ * words, the key and value size in words followed by a CRC-32 of the first
+ * word and the value, then the value padded to a double word. A record with no
+ * value deletes the key. The record header is programmed before the value, so
+ * a record cut by a reset fails the CRC and is skipped.
+ *
+ * The page after the active one is kept erased. When the active page is full
+ * the store moves to the erased page and copies in it the newest records still
+ * living in the oldest page, then erases the oldest page.
+ */
+#define FLASH_KV_MAGIC		0x4B563031
+#define FLASH_KV_HDR_WORDS	2
+#define FLASH_KV_HDR_BYTES	(FLASH_KV_HDR_WORDS * sizeof(uint32_t))
+#define FLASH_KV_BUFF_WORDS	64
+
+/******************************************************************************/
+/************************ Variable Declarations *******************************/
+/******************************************************************************/
+
+/** Buffer for the data moved between flash and RAM */
+static uint32_t flash_kv_buff[FLASH_KV_BUFF_WORDS];
+
+/******************************************************************************/
+/************************ Functions Definitions *******************************/
+/******************************************************************************/
+
+/**
+ * @brief Update a CRC-32 with a number of words.
+ * @param crc - Current CRC value.
+ * @param data - Pointer to the words.
+ * @param size - Number of words.
+ * @return The updated CRC.
+ */
+static uint32_t flash_kv_crc(uint32_t crc, const uint32_t *data, uint32_t size)
+{
+	static const uint32_t crc_nibble[16] = {
+		0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+		0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+		0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+		0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+	};
+	uint32_t word;
+	uint8_t i;
+
+	while (size--) {
+		word = *data++;
+		for (i = 0; i < 8; i++) {
+			crc = (crc >> 4) ^ crc_nibble[(crc ^ word) & 0xF];
+			word >>= 4;
+		}
+	}
+
+	return crc;
+}
+
+/**
+ * @brief Get the start address of a store page.
+ * @param dev - The store descriptor.
+ * @param page - Page index.
+ * @return The page address.
+ */
+static uint32_t flash_kv_page_addr(struct flash_kv_desc *dev, uint8_t page)
+{
+	return dev->start_addr + page * FLASH_PAGE_SIZE_BYTES;
+}
+
+/**
+ * @brief Check if a flash area is erased.
+ * @param dev - The store descriptor.
+ * @param addr - Start address of the area.
+ * @param size - Size of the area in words.
+ * @return true if all the words are erased, false otherwise.
+ */
+static bool flash_kv_blank(struct flash_kv_desc *dev, uint32_t addr,
+			   uint32_t size)
+{
+	uint32_t chunk, i;
+
+	while (size) {
+		chunk = (size > FLASH_KV_BUFF_WORDS) ? FLASH_KV_BUFF_WORDS : size;
+		flash_read(dev->flash, addr, flash_kv_buff, chunk);
+		for (i = 0; i < chunk; i++)
+			if (flash_kv_buff[i] != 0xFFFFFFFF)
+				return false;
+		addr += chunk * sizeof(uint32_t);
+		size -= chunk;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Find the index entry of a key.
+ * @param dev - The store descriptor.
+ * @param key - The key.
+ * @return Pointer to the entry, NULL if the key is not stored.
+ */
+static struct flash_kv_entry *flash_kv_find(struct flash_kv_desc *dev,
+		uint16_t key)
+{
+	uint8_t i;
+
+	for (i = 0; i < dev->entries; i++)
+		if (dev->index[i].key == key)
+			return &dev->index[i];
+
+	return NULL;
+}
+
+/**
+ * @brief Point the index entry of a key to its newest record.
+ * @param dev - The store descriptor.
+ * @param key - The key.
+ * @param size - Size of the value in words, 0 if the key was deleted.
+ * @param addr - Flash address of the record.
+ * @return SUCCESS in case of success, FAILURE if the index is full.
+ */
+static int32_t flash_kv_index_set(struct flash_kv_desc *dev, uint16_t key,
+				  uint16_t size, uint32_t addr)
+{
+	struct flash_kv_entry *entry = flash_kv_find(dev, key);
+
+	if (size == 0) {
+		if (entry)
+			*entry = dev->index[--dev->entries];
+		return SUCCESS;
+	}
+
+	if (!entry) {
+		if (dev->entries == FLASH_KV_MAX_KEYS)
+			return FAILURE;
+		entry = &dev->index[dev->entries++];
+	}
+	entry->key = key;
+	entry->size = size;
+	entry->addr = addr;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Get the flash size of a record, header and padding included.
+ * @param size - Size of the value in words.
+ * @return The record size in bytes.
+ */
+static uint32_t flash_kv_record_bytes(uint16_t size)
+{
+	return (FLASH_KV_HDR_WORDS + size + (size & 1)) * sizeof(uint32_t);
+}
+
+/**
+ * @brief Compute the CRC of a record with the value stored in flash.
+ * @param dev - The store descriptor.
+ * @param header - First word of the record header.
+ * @param addr - Flash address of the value.
+ * @param size - Size of the value in words.
+ * @return The record CRC.
+ */
+static uint32_t flash_kv_flash_crc(struct flash_kv_desc *dev, uint32_t header,
+				   uint32_t addr, uint16_t size)
+{
+	uint32_t crc, chunk;
+
+	crc = flash_kv_crc(0xFFFFFFFF, &header, 1);
+	while (size) {
+		chunk = (size > FLASH_KV_BUFF_WORDS) ? FLASH_KV_BUFF_WORDS : size;
+		flash_read(dev->flash, addr, flash_kv_buff, chunk);
+		crc = flash_kv_crc(crc, flash_kv_buff, chunk);
+		addr += chunk * sizeof(uint32_t);
+		size -= chunk;
+	}
+
+	return ~crc;
+}
+
+/**
+ * @brief Index the records of a page and find its free space.
+ * @param dev - The store descriptor.
+ * @param page - Page index.
+ * @return Offset of the first free byte of the page.
+ */
+static uint16_t flash_kv_scan_page(struct flash_kv_desc *dev, uint8_t page)
+{
+	uint32_t addr = flash_kv_page_addr(dev, page);
+	uint32_t header[FLASH_KV_HDR_WORDS];
+	uint16_t offset = FLASH_KV_HDR_BYTES;
+	uint16_t key, size;
+
+	while (offset + FLASH_KV_HDR_BYTES <= FLASH_PAGE_SIZE_BYTES) {
+		flash_read(dev->flash, addr + offset, header, FLASH_KV_HDR_WORDS);
+		if (header[0] == 0xFFFFFFFF && header[1] == 0xFFFFFFFF)
+			return offset;
+
+		key = header[0] & 0xFFFF;
+		size = header[0] >> 16;
+		/*
+		 * A header cut by a reset may have any size. Nothing was
+		 * programmed after it, so only the header itself is skipped,
+		 * the space after it is still erased and is used for the next
+		 * records.
+		 */
+		if (offset + flash_kv_record_bytes(size) > FLASH_PAGE_SIZE_BYTES) {
+			offset += FLASH_KV_HDR_BYTES;
+			continue;
+		}
+
+		if (key != FLASH_KV_KEY_INVALID &&
+		    flash_kv_flash_crc(dev, header[0], addr + offset +
+				       FLASH_KV_HDR_BYTES, size) == header[1])
+			flash_kv_index_set(dev, key, size, addr + offset);
+
+		offset += flash_kv_record_bytes(size);
+	}
+
+	return FLASH_PAGE_SIZE_BYTES;
+}
+
+/**
+ * @brief Erase a store page.
+ * @param dev - The store descriptor.
+ * @param page - Page index.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t flash_kv_erase(struct flash_kv_desc *dev, uint8_t page)
+{
+	int32_t ret;
+
+	ret = flash_erase_page(dev->flash, flash_kv_page_addr(dev, page));
+	if (ret != SUCCESS)
+		return FAILURE;
+	dev->seq[page] = 0;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Copy a part of a record value to the RAM buffer.
+ * @param dev - The store descriptor.
+ * @param data - Pointer to the value in RAM, NULL if the value is in flash.
+ * @param flash_addr - Flash address of the value, used if data is NULL.
+ * @param start - Index of the first copied word.
+ * @param size - Number of copied words.
+ * @return void
+ */
+static void flash_kv_stage(struct flash_kv_desc *dev, uint32_t *data,
+			   uint32_t flash_addr, uint32_t start, uint32_t size)
+{
+	if (data)
+		memcpy(flash_kv_buff, &data[start], size * sizeof(uint32_t));
+	else
+		flash_read(dev->flash, flash_addr + start * sizeof(uint32_t),
+			   flash_kv_buff, size);
+}
+
+/**
+ * @brief Append a record to the active page.
+ * @param dev - The store descriptor.
+ * @param key - The key.
+ * @param data - Pointer to the value in RAM, NULL if the value is in flash.
+ * @param flash_addr - Flash address of the value, used if data is NULL.
+ * @param size - Size of the value in words, 0 to delete the key.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t flash_kv_append(struct flash_kv_desc *dev, uint16_t key,
+			       uint32_t *data, uint32_t flash_addr,
+			       uint16_t size)
+{
+	uint32_t addr = flash_kv_page_addr(dev, dev->active) + dev->offset;
+	uint32_t header[FLASH_KV_HDR_WORDS];
+	uint32_t crc, chunk, i;
+	int32_t ret;
+
+	if (dev->offset + flash_kv_record_bytes(size) > FLASH_PAGE_SIZE_BYTES)
+		return FAILURE;
+
+	header[0] = key | ((uint32_t)size << 16);
+	crc = flash_kv_crc(0xFFFFFFFF, &header[0], 1);
+	for (i = 0; i < size; i += chunk) {
+		chunk = size - i;
+		if (chunk > FLASH_KV_BUFF_WORDS)
+			chunk = FLASH_KV_BUFF_WORDS;
+		flash_kv_stage(dev, data, flash_addr, i, chunk);
+		crc = flash_kv_crc(crc, flash_kv_buff, chunk);
+	}
+	header[1] = ~crc;
+
+	ret = flash_program(dev->flash, addr, header, FLASH_KV_HDR_WORDS);
+	if (ret != SUCCESS)
+		return FAILURE;
+
+	/* The value is staged in RAM so it may come from flash and be padded */
+	for (i = 0; i < size; i += chunk) {
+		chunk = size - i;
+		if (chunk > FLASH_KV_BUFF_WORDS)
+			chunk = FLASH_KV_BUFF_WORDS;
+		flash_kv_stage(dev, data, flash_addr, i, chunk);
+		if (chunk & 1)
+			flash_kv_buff[chunk] = 0xFFFFFFFF;
+		ret = flash_program(dev->flash,
+				    addr + FLASH_KV_HDR_BYTES + i * sizeof(uint32_t),
+				    flash_kv_buff, chunk + (chunk & 1));
+		if (ret != SUCCESS)
+			return FAILURE;
+	}
+
+	dev->offset += flash_kv_record_bytes(size);
+
+	return flash_kv_index_set(dev, key, size, addr);
+}
+
+/**
+ * @brief Copy the newest records living in a page to the active page and
+ *        erase the page.
+ * @param dev - The store descriptor.
+ * @param page - Page index.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t flash_kv_collect(struct flash_kv_desc *dev, uint8_t page)
+{
+	uint32_t start = flash_kv_page_addr(dev, page);
+	struct flash_kv_entry *entry;
+	int32_t ret;
+	uint8_t i;
+
+	for (i = 0; i < dev->entries; i++) {
+		entry = &dev->index[i];
+		if (entry->addr < start ||
+		    entry->addr >= start + FLASH_PAGE_SIZE_BYTES)
+			continue;
+		ret = flash_kv_append(dev, entry->key, NULL,
+				      entry->addr + FLASH_KV_HDR_BYTES, entry->size);
+		if (ret != SUCCESS)
+			return FAILURE;
+	}
+
+	return flash_kv_erase(dev, page);
+}
+
+/**
+ * @brief Open the erased page after the active one and free the oldest page.
+ * @param dev - The store descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t flash_kv_next_page(struct flash_kv_desc *dev)
+{
+	uint32_t header[FLASH_KV_HDR_WORDS];
+	uint8_t page = (dev->active + 1) % dev->pages;
+	int32_t ret;
+
+	if (dev->seq[page] != 0)
+		return FAILURE;
+
+	header[1] = dev->seq[dev->active] + 1;
+	header[0] = FLASH_KV_MAGIC ^ header[1];
+	ret = flash_program(dev->flash, flash_kv_page_addr(dev, page), header,
+			    FLASH_KV_HDR_WORDS);
+	if (ret != SUCCESS)
+		return FAILURE;
+	dev->seq[page] = header[1];
+	dev->active = page;
+	dev->offset = FLASH_KV_HDR_BYTES;
+
+	page = (page + 1) % dev->pages;
+	if (dev->seq[page] == 0)
+		return SUCCESS;
+
+	return flash_kv_collect(dev, page);
+}
+
+/**
+ * @brief Mount the store, formatting or repairing it if needed.
+ *
+ * Pages without a valid header are erased, the records of the other pages are
+ * indexed from the oldest page to the newest. If a reset interrupted a page
+ * change the oldest page is collected again.
+ * @param device - The store descriptor.
+ * @param init_param - The initialization structure.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t flash_kv_init(struct flash_kv_desc **device,
+		      struct flash_kv_init_param *init_param)
+{
+	struct flash_kv_desc *dev;
+	uint32_t header[FLASH_KV_HDR_WORDS];
+	uint32_t last_seq = 0, seq;
+	uint8_t i, page;
+	int32_t ret;
+
+	if (init_param->pages < 2 || init_param->pages > FLASH_KV_MAX_PAGES)
+		return FAILURE;
+
+	dev = (struct flash_kv_desc *)calloc(1, sizeof(*dev));
+	if (!dev)
+		return FAILURE;
+
+	dev->flash = init_param->flash;
+	dev->start_addr = init_param->start_addr;
+	dev->pages = init_param->pages;
+
+	for (i = 0; i < dev->pages; i++) {
+		flash_read(dev->flash, flash_kv_page_addr(dev, i), header,
+			   FLASH_KV_HDR_WORDS);
+		if (header[0] == (FLASH_KV_MAGIC ^ header[1]) &&
+		    header[1] != 0 && header[1] != 0xFFFFFFFF) {
+			dev->seq[i] = header[1];
+			continue;
+		}
+		if (flash_kv_blank(dev, flash_kv_page_addr(dev, i),
+				   FLASH_PAGE_SIZE_WORDS))
+			continue;
+		ret = flash_kv_erase(dev, i);
+		if (ret != SUCCESS)
+			goto error;
+	}
+
+	/* Index the pages from the oldest to the newest */
+	while (true) {
+		seq = 0xFFFFFFFF;
+		page = dev->pages;
+		for (i = 0; i < dev->pages; i++) {
+			if (dev->seq[i] > last_seq && dev->seq[i] < seq) {
+				seq = dev->seq[i];
+				page = i;
+			}
+		}
+		if (page == dev->pages)
+			break;
+		dev->active = page;
+		dev->offset = flash_kv_scan_page(dev, page);
+		last_seq = seq;
+	}
+
+	if (last_seq == 0) {
+		/* Empty store */
+		header[1] = 1;
+		header[0] = FLASH_KV_MAGIC ^ header[1];
+		ret = flash_program(dev->flash, flash_kv_page_addr(dev, 0), header,
+				    FLASH_KV_HDR_WORDS);
+		if (ret != SUCCESS)
+			goto error;
+		dev->seq[0] = 1;
+		dev->active = 0;
+		dev->offset = FLASH_KV_HDR_BYTES;
+	}
+
+	/* Finish a page change interrupted by a reset */
+	page = (dev->active + 1) % dev->pages;
+	if (dev->seq[page] != 0) {
+		ret = flash_kv_collect(dev, page);
+		if (ret != SUCCESS)
+			goto error;
+	}
+
+	*device = dev;
+
+	return SUCCESS;
+
+error:
+	free(dev);
+
+	return FAILURE;
+}
+
+/**
+ * @brief Free memory allocated by flash_kv_init().
+ * @param dev - The store descriptor.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t flash_kv_remove(struct flash_kv_desc *dev)
+{
+	if (!dev)
+		return FAILURE;
+
+	free(dev);
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Read the value of a key.
+ * @param dev - The store descriptor.
+ * @param key - The key.
+ * @param data - Pointer to the value container.
+ * @param size - Size of the container in words. Returns the size of the
+ *               stored value, only the words that fit are read.
+ * @return SUCCESS in case of success, FAILURE if the key is not stored.
+ */
+int32_t flash_kv_read(struct flash_kv_desc *dev, uint16_t key, uint32_t *data,
+		      uint16_t *size)
+{
+	struct flash_kv_entry *entry = flash_kv_find(dev, key);
+
+	if (!entry)
+		return FAILURE;
+
+	flash_read(dev->flash, entry->addr + FLASH_KV_HDR_BYTES, data,
+		   (entry->size < *size) ? entry->size : *size);
+	*size = entry->size;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief Append a record, moving to the next pages until it fits.
+ * @param dev - The store descriptor.
+ * @param key - The key.
+ * @param data - Pointer to the value.
+ * @param size - Size of the value in words, 0 to delete the key.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t flash_kv_store(struct flash_kv_desc *dev, uint16_t key,
+			      uint32_t *data, uint16_t size)
+{
+	uint8_t i;
+	int32_t ret;
+
+	if (key == FLASH_KV_KEY_INVALID)
+		return FAILURE;
+	if (flash_kv_record_bytes(size) > FLASH_PAGE_SIZE_BYTES -
+	    FLASH_KV_HDR_BYTES)
+		return FAILURE;
+
+	for (i = 0; i < dev->pages; i++) {
+		if (dev->offset + flash_kv_record_bytes(size) <=
+		    FLASH_PAGE_SIZE_BYTES)
+			return flash_kv_append(dev, key, data, 0, size);
+		ret = flash_kv_next_page(dev);
+		if (ret != SUCCESS)
+			return FAILURE;
+	}
+
+	return FAILURE;
+}
+
+/**
+ * @brief Write the value of a key. Nothing is written if the stored value is
+ *        the same.
+ * @param dev - The store descriptor.
+ * @param key - The key.
+ * @param data - Pointer to the value.
+ * @param size - Size of the value in words, not 0.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t flash_kv_write(struct flash_kv_desc *dev, uint16_t key,
+		       uint32_t *data, uint16_t size)
+{
+	struct flash_kv_entry *entry = flash_kv_find(dev, key);
+	uint32_t addr, chunk, i;
+
+	if (size == 0)
+		return FAILURE;
+
+	if (entry && entry->size == size) {
+		addr = entry->addr + FLASH_KV_HDR_BYTES;
+		for (i = 0; i < size; i += chunk) {
+			chunk = size - i;
+			if (chunk > FLASH_KV_BUFF_WORDS)
+				chunk = FLASH_KV_BUFF_WORDS;
+			flash_read(dev->flash, addr + i * sizeof(uint32_t),
+				   flash_kv_buff, chunk);
+			if (memcmp(flash_kv_buff, &data[i],
+				   chunk * sizeof(uint32_t)) != 0)
+				break;
+		}
+		if (i >= size)
+			return SUCCESS;
+	} else if (!entry && dev->entries == FLASH_KV_MAX_KEYS) {
+		return FAILURE;
+	}
+
+	return flash_kv_store(dev, key, data, size);
+}
+
+/**
+ * @brief Delete a key.
+ * @param dev - The store descriptor.
+ * @param key - The key.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t flash_kv_delete(struct flash_kv_desc *dev, uint16_t key)
+{
+	if (!flash_kv_find(dev, key))
+		return SUCCESS;
+
+	return flash_kv_store(dev, key, NULL, 0);
+}
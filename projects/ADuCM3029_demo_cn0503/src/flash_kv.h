@@ -0,0 +1,135 @@
+/***************************************************************************//**
+*   @file   flash_kv.h
+*   @brief  Wear leveled flash key/value store header.
+********************************************************************************
+* Copyright 2020(c) Analog Devices, Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*  - Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  - Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in
+*    the documentation and/or other materials provided with the
+*    distribution.
+*  - Neither the name of Analog Devices, Inc. nor the names of its
+*    contributors may be used to endorse or promote products derived
+*    from this software without specific prior written permission.
+*  - The use of this software may or may not infringe the patent rights
+*    of one or more patent holders.  This license does not release you
+*    from the requirement that you obtain separate licenses from these
+*    patent holders to use this software.
+*  - Use of the software either in source or binary form, must be run
+*    on or directly connected to an Analog Devices Inc. component.
+*
+* THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT, MERCHANTABILITY
+* AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef FLASH_KV_H_
+#define FLASH_KV_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include "flash.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Maximum number of keys the store can hold */
+#define FLASH_KV_MAX_KEYS	32
+/** Maximum number of flash pages used by the store */
+#define FLASH_KV_MAX_PAGES	8
+/** Key value reserved for erased flash */
+#define FLASH_KV_KEY_INVALID	0xFFFF
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @struct flash_kv_entry
+ * @brief RAM index entry pointing to the newest record of a key.
+ */
+struct flash_kv_entry {
+	/** Record key */
+	uint16_t key;
+	/** Size of the value in words */
+	uint16_t size;
+	/** Flash address of the record header */
+	uint32_t addr;
+};
+
+/**
+ * @struct flash_kv_init_param
+ * @brief Initialization structure for the flash key/value store.
+ */
+struct flash_kv_init_param {
+	/** Flash driver used by the store */
+	struct flash_dev *flash;
+	/** Address of the first page of the store, page aligned */
+	uint32_t start_addr;
+	/** Number of consecutive pages of the store, at least 2 */
+	uint8_t pages;
+};
+
+/**
+ * @struct flash_kv_desc
+ * @brief Flash key/value store descriptor.
+ */
+struct flash_kv_desc {
+	/** Flash driver used by the store */
+	struct flash_dev *flash;
+	/** Address of the first page of the store */
+	uint32_t start_addr;
+	/** Number of pages of the store */
+	uint8_t pages;
+	/** Page records are appended to */
+	uint8_t active;
+	/** Offset of the first free byte in the active page */
+	uint16_t offset;
+	/** Sequence number of each page, 0 if the page is erased */
+	uint32_t seq[FLASH_KV_MAX_PAGES];
+	/** Number of valid entries in the index */
+	uint8_t entries;
+	/** Newest record of each key */
+	struct flash_kv_entry index[FLASH_KV_MAX_KEYS];
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/** Mount the store, formatting or repairing it if needed. */
+int32_t flash_kv_init(struct flash_kv_desc **device,
+		      struct flash_kv_init_param *init_param);
+
+/** Free memory allocated by flash_kv_init(). */
+int32_t flash_kv_remove(struct flash_kv_desc *dev);
+
+/** Read the value of a key. */
+int32_t flash_kv_read(struct flash_kv_desc *dev, uint16_t key, uint32_t *data,
+		      uint16_t *size);
+
+/** Write the value of a key. */
+int32_t flash_kv_write(struct flash_kv_desc *dev, uint16_t key,
+		       uint32_t *data, uint16_t size);
+
+/** Delete a key. */
+int32_t flash_kv_delete(struct flash_kv_desc *dev, uint16_t key);
+
+#endif /* FLASH_KV_H_ */
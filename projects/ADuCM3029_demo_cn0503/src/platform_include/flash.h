@@ -32,6 +32,13 @@ int32_t flash_remove(struct flash_dev *dev);
 int32_t flash_write(struct flash_dev *dev, uint32_t flash_addr,
 		    uint32_t *array, uint32_t array_size);
 
+/** Program data in erased flash memory. */
+int32_t flash_program(struct flash_dev *dev, uint32_t flash_addr,
+		      uint32_t *array, uint32_t array_size);
+
+/** Erase the flash page containing an address. */
+int32_t flash_erase_page(struct flash_dev *dev, uint32_t flash_addr);
+
 /** Read data from the flash memory. */
 void flash_read(struct flash_dev *dev, uint32_t flash_addr, uint32_t *array,
 		uint32_t size);
@@ -8,6 +8,7 @@
 #include <drivers/flash/adi_flash.h>
 #include <drivers/dma/adi_dma.h>
 #include <stdlib.h>
+#include <string.h>
 #include <malloc.h>
 #include "flash.h"
 #include "flash_extra.h"
@@ -90,34 +91,58 @@ int32_t flash_remove(struct flash_dev *dev)
 	return SUCCESS;
 }
 
-//todo: comment flash_write_page
-static int32_t flash_write_page(struct flash_dev *dev, uint32_t flash_addr,
-				uint32_t *array, uint32_t array_size)
+/**
+ * Program data in erased flash memory. The page is not erased first, so every
+ * programmed double word must be erased.
+ *
+ * @param [in] dev        - Pointer to the driver handler.
+ * @param [in] flash_addr - Flash address, double word aligned.
+ * @param [in] array      - Pointer to the data to be written.
+ * @param [in] array_size - Number of words written, must be even.
+ *
+ * @return 0 in case of success, error code otherwise.
+ */
+int32_t flash_program(struct flash_dev *dev, uint32_t flash_addr,
+		      uint32_t *array, uint32_t array_size)
 {
 	ADI_FEE_TRANSACTION transaction;
 	struct adicup_flash_dev *adicup_extra = dev->extra;
-	uint32_t page_nr, fee_hw_error;
-	uint32_t temp_ptr[FLASH_PAGE_SIZE_WORDS] __attribute__ ((aligned (4)));
-	int32_t ret, i;
+	uint32_t fee_hw_error;
+	int32_t ret;
 
 	if ((flash_addr & 0x7) != 0)
 		return FAILURE;
 	if ((array_size % 2) != 0)
 		return FAILURE;
-	if (((flash_addr & 0x7FF) + (array_size * sizeof(uint32_t))) >
-	    0x800)
-		return FAILURE;
+	if (array_size == 0)
+		return SUCCESS;
 
-	flash_read(dev, (flash_addr & (~0x7FF)), temp_ptr,
-		   FLASH_PAGE_SIZE_WORDS);
+	transaction.bUseDma = true;
+	transaction.nSize = array_size * sizeof(uint32_t);
+	transaction.pWriteAddr = (uint32_t *)flash_addr;
+	transaction.pWriteData = array;
 
-	for(i = 0; i < array_size; i++)
-		temp_ptr[(i + (flash_addr & 0x7FF) / 4)] = array[i];
+	ret = adi_fee_Write(adicup_extra->instance, &transaction,
+			    &fee_hw_error);
+	if(ret != SUCCESS)
+		return FAILURE;
 
-	transaction.bUseDma = true;
-	transaction.nSize = FLASH_PAGE_SIZE_BYTES;
-	transaction.pWriteAddr = (uint32_t *)(flash_addr & (~0x7FF));
-	transaction.pWriteData = temp_ptr;
+	return SUCCESS;
+}
+
+/**
+ * Erase the flash page containing an address.
+ *
+ * @param [in] dev        - Pointer to the driver handler.
+ * @param [in] flash_addr - Any address in the erased page.
+ *
+ * @return 0 in case of success, error code otherwise.
+ */
+int32_t flash_erase_page(struct flash_dev *dev, uint32_t flash_addr)
+{
+	struct adicup_flash_dev *adicup_extra = dev->extra;
+	uint32_t page_nr, fee_hw_error;
+	int32_t ret;
 
 	/* Get the page number */
 	ret = adi_fee_GetPageNumber(adicup_extra->instance, flash_addr,
@@ -125,19 +150,53 @@ static int32_t flash_write_page(struct flash_dev *dev, uint32_t flash_addr,
 	if(ret != SUCCESS)
 		return FAILURE;
 
-	/* First erase page */
 	ret = adi_fee_PageErase(adicup_extra->instance, page_nr, page_nr,
 				&fee_hw_error);
 	if(ret != SUCCESS)
 		return FAILURE;
 
-	/* Then write */
-	ret = adi_fee_Write(adicup_extra->instance, &transaction,
-			    &fee_hw_error);
+	return SUCCESS;
+}
+
+/**
+ * Write data inside one flash page. The rest of the page is preserved by
+ * reading it, erasing the page and programming it back.
+ *
+ * @param [in] dev        - Pointer to the driver handler.
+ * @param [in] flash_addr - Flash address, double word aligned.
+ * @param [in] array      - Pointer to the data to be written.
+ * @param [in] array_size - Number of words written, must be even.
+ *
+ * @return 0 in case of success, error code otherwise.
+ */
+static int32_t flash_write_page(struct flash_dev *dev, uint32_t flash_addr,
+				uint32_t *array, uint32_t array_size)
+{
+	uint32_t temp_ptr[FLASH_PAGE_SIZE_WORDS] __attribute__ ((aligned (4)));
+	int32_t ret, i;
+
+	if ((flash_addr & 0x7) != 0)
+		return FAILURE;
+	if ((array_size % 2) != 0)
+		return FAILURE;
+	if (((flash_addr & 0x7FF) + (array_size * sizeof(uint32_t))) >
+	    0x800)
+		return FAILURE;
+
+	flash_read(dev, (flash_addr & (~0x7FF)), temp_ptr,
+		   FLASH_PAGE_SIZE_WORDS);
+
+	for(i = 0; i < array_size; i++)
+		temp_ptr[(i + (flash_addr & 0x7FF) / 4)] = array[i];
+
+	/* First erase page */
+	ret = flash_erase_page(dev, flash_addr);
 	if(ret != SUCCESS)
 		return FAILURE;
 
-	return SUCCESS;
+	/* Then write */
+	return flash_program(dev, (flash_addr & (~0x7FF)), temp_ptr,
+			     FLASH_PAGE_SIZE_WORDS);
 }
 
 //todo: comment flash_write
@@ -155,7 +214,7 @@ int32_t flash_write(struct flash_dev *dev, uint32_t flash_addr,
 				       temp);
 		if (ret != SUCCESS)
 			return FAILURE;
-		flash_addr += temp;
+		flash_addr += temp * sizeof(uint32_t);
 		array_size -= temp;
 		data_index += temp;
 	} while (data_index < initial_size);
@@ -238,9 +297,5 @@ int32_t flash_write(struct flash_dev *dev, uint32_t flash_addr,
 void flash_read(struct flash_dev *dev, uint32_t flash_addr, uint32_t *array,
 		uint32_t size)
 {
-	uint32_t *data_in_flash = (uint32_t *)flash_addr;
-	uint32_t *data		    = array;
-
-	for (uint32_t i = 0; i < size; i++)
-		*data++ = *data_in_flash++;
+	memcpy(array, (void *)flash_addr, size * sizeof(uint32_t));
 }
@@ -0,0 +1,359 @@
+/* Host test of the flash key/value store on a simulated flash
+ *
+ * The flash driver is replaced by a model of the ADuCM3029 flash: 2 kB pages,
+ * programmed in double words that must be erased first, programming only
+ * clears bits. Any violation of these rules fails the test.
+ *
+ * Power cuts are simulated by counting double word programs and page erases
+ * and jumping out of the store at a random one. The operation in progress is
+ * left half done: the double word being programmed gets only some of its bits
+ * cleared and the page being erased is left with a mix of erased, old and
+ * random words. The store is then mounted again and every key must hold
+ * either its value before the interrupted operation or, for the key being
+ * written, the new value.
+ */
+
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "flash_kv.h"
+#include "flash_extra.h"
+#include "error.h"
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+#define KV_ADDR		0x34800
+#define KV_PAGES	4
+#define KV_WORDS	(KV_PAGES * FLASH_PAGE_SIZE_WORDS)
+
+/* Flash model */
+static uint32_t flash[KV_WORDS];
+static uint32_t erase_count[KV_PAGES];
+static uint32_t programs;
+static uint32_t violations;
+/* Double word programs and page erases left before the power cut, 0 for no
+ * cut */
+static uint32_t cut_after;
+static jmp_buf power_cut;
+
+static uint32_t seed = 1;
+
+static uint32_t rnd(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8) & 0xFFFFFF;
+}
+
+static uint32_t rnd32(void)
+{
+	return (rnd() << 8) ^ rnd();
+}
+
+/* Count a flash operation, true if the power is cut during it */
+static bool cut_now(void)
+{
+	if (cut_after == 0)
+		return false;
+
+	return --cut_after == 0;
+}
+
+static uint32_t flash_index(uint32_t addr)
+{
+	if (addr < KV_ADDR || addr >= KV_ADDR + KV_WORDS * 4) {
+		violations++;
+		printf("access out of the store at 0x%x\n", addr);
+		longjmp(power_cut, 2);
+	}
+
+	return (addr - KV_ADDR) / 4;
+}
+
+int32_t flash_program(struct flash_dev *dev, uint32_t flash_addr,
+		      uint32_t *array, uint32_t array_size)
+{
+	uint32_t i, j;
+
+	if ((flash_addr & 0x7) != 0 || (array_size % 2) != 0) {
+		violations++;
+		return FAILURE;
+	}
+
+	for (i = 0; i < array_size; i += 2) {
+		j = flash_index(flash_addr + i * 4);
+		if (flash[j] != 0xFFFFFFFF || flash[j + 1] != 0xFFFFFFFF) {
+			violations++;
+			printf("double word at 0x%x programmed twice\n",
+			       flash_addr + i * 4);
+		}
+		programs++;
+		if (cut_now()) {
+			flash[j] &= array[i] | rnd32();
+			flash[j + 1] &= array[i + 1] | rnd32();
+			longjmp(power_cut, 1);
+		}
+		flash[j] &= array[i];
+		flash[j + 1] &= array[i + 1];
+	}
+
+	return SUCCESS;
+}
+
+int32_t flash_erase_page(struct flash_dev *dev, uint32_t flash_addr)
+{
+	uint32_t page = flash_index(flash_addr) / FLASH_PAGE_SIZE_WORDS;
+	uint32_t *p = &flash[page * FLASH_PAGE_SIZE_WORDS];
+	uint32_t i;
+
+	if (cut_now()) {
+		for (i = 0; i < FLASH_PAGE_SIZE_WORDS; i++) {
+			switch (rnd() % 3) {
+			case 0:
+				p[i] = 0xFFFFFFFF;
+				break;
+			case 1:
+				p[i] |= rnd32();
+				break;
+			default:
+				break;
+			}
+		}
+		longjmp(power_cut, 1);
+	}
+
+	for (i = 0; i < FLASH_PAGE_SIZE_WORDS; i++)
+		p[i] = 0xFFFFFFFF;
+	erase_count[page]++;
+
+	return SUCCESS;
+}
+
+void flash_read(struct flash_dev *dev, uint32_t flash_addr, uint32_t *array,
+		uint32_t size)
+{
+	uint32_t i;
+
+	for (i = 0; i < size; i++)
+		array[i] = flash[flash_index(flash_addr + i * 4)];
+}
+
+static struct flash_dev flash_dev;
+
+static struct flash_kv_desc *mount(void)
+{
+	struct flash_kv_init_param init = {
+		.flash = &flash_dev,
+		.start_addr = KV_ADDR,
+		.pages = KV_PAGES
+	};
+	struct flash_kv_desc *kv = NULL;
+
+	CHECK(flash_kv_init(&kv, &init) == SUCCESS);
+
+	return kv;
+}
+
+/* Reference contents of the store */
+#define KEYS		24
+#define MAX_WORDS	40
+
+static struct {
+	uint16_t size;
+	uint32_t data[MAX_WORDS];
+} ref[KEYS];
+
+static bool same(struct flash_kv_desc *kv, uint16_t key)
+{
+	uint32_t data[MAX_WORDS];
+	uint16_t size = MAX_WORDS;
+
+	if (flash_kv_read(kv, key, data, &size) != SUCCESS)
+		return ref[key].size == 0;
+
+	return size == ref[key].size &&
+	       memcmp(data, ref[key].data, size * 4) == 0;
+}
+
+static uint32_t check_all(struct flash_kv_desc *kv)
+{
+	uint32_t bad = 0;
+	uint16_t key;
+
+	for (key = 0; key < KEYS; key++)
+		bad += !same(kv, key);
+
+	return bad;
+}
+
+static void test_basic(void)
+{
+	struct flash_kv_desc *kv;
+	uint32_t data[MAX_WORDS], i, before, max, min;
+	uint16_t key, size;
+
+	memset(flash, 0xFF, sizeof(flash));
+	memset(ref, 0, sizeof(ref));
+	kv = mount();
+
+	for (key = 0; key < KEYS; key++) {
+		ref[key].size = 1 + key % 7;
+		for (i = 0; i < ref[key].size; i++)
+			ref[key].data[i] = key * 1000 + i;
+		CHECK(flash_kv_write(kv, key, ref[key].data, ref[key].size) ==
+		      SUCCESS);
+	}
+	CHECK(check_all(kv) == 0);
+
+	/* Read into a smaller container */
+	size = 2;
+	CHECK(flash_kv_read(kv, 6, data, &size) == SUCCESS);
+	CHECK(size == 7 && data[0] == 6000 && data[1] == 6001);
+
+	/* Writing the stored value again programs nothing */
+	before = programs;
+	CHECK(flash_kv_write(kv, 5, ref[5].data, ref[5].size) == SUCCESS);
+	CHECK(programs == before);
+
+	/* Delete, invalid key and size */
+	CHECK(flash_kv_delete(kv, 3) == SUCCESS);
+	ref[3].size = 0;
+	CHECK(flash_kv_delete(kv, 3) == SUCCESS);
+	CHECK(flash_kv_write(kv, FLASH_KV_KEY_INVALID, data, 1) == FAILURE);
+	CHECK(flash_kv_write(kv, 1, data, 0) == FAILURE);
+	CHECK(flash_kv_write(kv, 1, data, FLASH_PAGE_SIZE_WORDS) == FAILURE);
+
+	/* Index full */
+	for (key = KEYS; key < FLASH_KV_MAX_KEYS + 1; key++)
+		CHECK(flash_kv_write(kv, key, data, 1) == SUCCESS);
+	CHECK(flash_kv_write(kv, 100, data, 1) == FAILURE);
+	for (key = KEYS; key < FLASH_KV_MAX_KEYS + 1; key++)
+		CHECK(flash_kv_delete(kv, key) == SUCCESS);
+
+	/* The contents survive a remount */
+	flash_kv_remove(kv);
+	kv = mount();
+	CHECK(check_all(kv) == 0);
+
+	/* Many updates go round the pages and wear them evenly */
+	memset(erase_count, 0, sizeof(erase_count));
+	for (i = 0; i < 20000; i++) {
+		key = rnd() % KEYS;
+		ref[key].size = 1 + rnd() % MAX_WORDS;
+		ref[key].data[0] = i;
+		CHECK(flash_kv_write(kv, key, ref[key].data, ref[key].size) ==
+		      SUCCESS);
+	}
+	CHECK(check_all(kv) == 0);
+	max = min = erase_count[0];
+	for (i = 1; i < KV_PAGES; i++) {
+		if (erase_count[i] > max)
+			max = erase_count[i];
+		if (erase_count[i] < min)
+			min = erase_count[i];
+	}
+	CHECK(min > 100 && max - min <= 1);
+	printf("20000 updates, page erases %u..%u\n", min, max);
+
+	flash_kv_remove(kv);
+	kv = mount();
+	CHECK(check_all(kv) == 0);
+	flash_kv_remove(kv);
+	CHECK(violations == 0);
+}
+
+static void test_power_cuts(void)
+{
+	static uint32_t data[MAX_WORDS];
+	struct flash_kv_desc *volatile kv;
+	volatile uint32_t cuts = 0;
+	volatile bool deleting;
+	volatile uint16_t key, size;
+	uint32_t i, run, bad = 0, torn = 0;
+
+	memset(flash, 0xFF, sizeof(flash));
+	memset(ref, 0, sizeof(ref));
+	seed = 12345;
+	kv = mount();
+
+	for (run = 0; run < 20000; run++) {
+		key = rnd() % KEYS;
+		deleting = (rnd() % 8) == 0;
+		size = 1 + rnd() % MAX_WORDS;
+		for (i = 0; i < size; i++)
+			data[i] = rnd32();
+		/* Cut within the flash operations of a record often enough to
+		 * also hit page changes and their page erases */
+		cut_after = (rnd() % 4 == 0) ? 1 + rnd() % 24 : 0;
+
+		if (setjmp(power_cut) == 0) {
+			if (deleting)
+				CHECK(flash_kv_delete(kv, key) == SUCCESS);
+			else
+				CHECK(flash_kv_write(kv, key, data, size) ==
+				      SUCCESS);
+			cut_after = 0;
+			if (deleting) {
+				ref[key].size = 0;
+			} else {
+				ref[key].size = size;
+				memcpy(ref[key].data, data, size * 4);
+			}
+			continue;
+		}
+
+		/* Reset */
+		cut_after = 0;
+		cuts++;
+		flash_kv_remove(kv);
+		kv = mount();
+		if (!kv)
+			break;
+
+		/* The interrupted key holds the old or the new value */
+		if (!same(kv, key)) {
+			if (deleting) {
+				ref[key].size = 0;
+			} else {
+				ref[key].size = size;
+				memcpy(ref[key].data, data, size * 4);
+			}
+			torn++;
+		}
+		bad += check_all(kv);
+		if (violations)
+			break;
+	}
+
+	CHECK(kv != NULL);
+	if (!kv)
+		return;
+	CHECK(bad == 0);
+	CHECK(violations == 0);
+	CHECK(cuts > 1000);
+	printf("%u operations, %u power cuts, %u kept the new value\n",
+	       run, cuts, torn);
+
+	flash_kv_remove(kv);
+	kv = mount();
+	CHECK(check_all(kv) == 0);
+	flash_kv_remove(kv);
+}
+
+int main(void)
+{
+	test_basic();
+	test_power_cuts();
+
+	printf(failures ? "FAILED\n" : "OK\n");
+
+	return failures ? 1 : 0;
+}
@@ -158,6 +158,49 @@ int32_t aducm3029_adc_sample_once(struct aducm3029_adc_desc *dev,
 	return SUCCESS;
 }
 
+/**
+ * @brief Capture several samples of one channel in a single multi-pass
+ *        transfer.
+ *
+ * The ADC is enabled once for the whole capture and the samples are moved to
+ * the buffer by the driver without CPU intervention between conversions.
+ * @param [in] dev - The device structure.
+ * @param [in] channel - Channel mask of the channel to be sampled.
+ * @param [out] buff - Buffer for the samples.
+ * @param [in] samples - Number of samples to capture.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t aducm3029_adc_capture(struct aducm3029_adc_desc *dev,
+			      uint32_t channel, uint16_t *buff,
+			      uint16_t samples)
+{
+	int32_t ret;
+	ADI_ADC_BUFFER buffer, *adcbuffer;
+
+	buffer.nBuffSize = samples * sizeof(*buff);
+	buffer.nChannels = channel;
+	buffer.nNumConversionPasses = samples;
+	buffer.pDataBuffer = buff;
+
+	ret = adi_adc_SubmitBuffer(dev->handler, &buffer);
+	if (ret != ADI_ADC_SUCCESS)
+		return FAILURE;
+
+	ret = adi_adc_Enable(dev->handler, true);
+	if (ret != ADI_ADC_SUCCESS)
+		return FAILURE;
+
+	ret = adi_adc_GetBuffer(dev->handler, &adcbuffer);
+	if (ret != ADI_ADC_SUCCESS)
+		return FAILURE;
+
+	ret = adi_adc_Enable(dev->handler, false);
+	if (ret != ADI_ADC_SUCCESS)
+		return FAILURE;
+
+	return SUCCESS;
+}
+
 //TODO: comment aducm3029_adc_convert_sample
 float aducm3029_adc_convert_sample(struct aducm3029_adc_desc *dev,
 				   uint16_t code)
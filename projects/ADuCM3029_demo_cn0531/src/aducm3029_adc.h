@@ -75,6 +75,11 @@ int32_t aducm3029_adc_remove(struct aducm3029_adc_desc *dev);
 int32_t aducm3029_adc_sample_once(struct aducm3029_adc_desc *dev,
 				  uint32_t channel, uint16_t *code);
 
+/* Capture several samples of one channel in a single multi-pass transfer. */
+int32_t aducm3029_adc_capture(struct aducm3029_adc_desc *dev,
+			      uint32_t channel, uint16_t *buff,
+			      uint16_t samples);
+
 //TODO: comment aducm3029_adc_convert_sample
 float aducm3029_adc_convert_sample(struct aducm3029_adc_desc *dev,
 				   uint16_t code);
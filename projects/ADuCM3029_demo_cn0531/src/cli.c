@@ -58,6 +58,58 @@ extern uint8_t uart_cmd;
 /************************ Functions Definitions *******************************/
 /******************************************************************************/
 
+/**
+ * Compute the lookup table slot of a command.
+ *
+ * Only the command name is hashed, up to the first space, so a typed line
+ * with arguments lands in the same slot as its command call.
+ *
+ * @param [in] command - Command name or typed line.
+ *
+ * @return Slot index in the lookup table.
+ */
+static uint8_t cli_hash(uint8_t *command)
+{
+	uint32_t hash = 5381;
+
+	while(*command != '\0' && *command != ' ')
+		hash = (hash * 33) ^ *command++;
+
+	return hash & (CLI_HASH_SIZE - 1);
+}
+
+/**
+ * Build the command lookup table from the loaded command vectors.
+ *
+ * Open addressing with linear probing. Each used slot holds the index of the
+ * command call plus one, so 0 marks an empty slot.
+ *
+ * @param [in] dev - The device structure.
+ *
+ * @return 0 in case of success, negative error code if there are more command
+ *         calls than CLI_HASH_SIZE - 1.
+ */
+static int32_t cli_build_hash(struct cli_desc *dev)
+{
+	uint8_t i, slot;
+
+	memset(dev->cmd_hash, 0, sizeof(dev->cmd_hash));
+
+	for(i = 0; dev->v_cmd_fun[i / 2] != NULL; i++) {
+		/* Keep at least one slot empty to end the probing */
+		if(i >= CLI_HASH_SIZE - 1)
+			return -1;
+		slot = cli_hash(dev->cmd_commands[i]);
+		while(dev->cmd_hash[slot] != 0)
+			slot = (slot + 1) & (CLI_HASH_SIZE - 1);
+		dev->cmd_hash[slot] = i + 1;
+	}
+
+	dev->cmd_hash_valid = true;
+
+	return 0;
+}
+
 /**
  * Disable the other interrupts aside from the UART interrupt to not interfere
  * with the UART reception.
@@ -222,7 +274,9 @@ int32_t cli_process(struct cli_desc *dev)
 			uart_previous_line[i] = uart_current_line[i];
 		} while(uart_current_line[i++] != '\0');
 		/* Find needed function based on typed command */
-		cli_find_command(dev, uart_current_line, &func);
+		ret = cli_find_command(dev, uart_current_line, &func);
+		if(ret < 0)
+			return ret;
 
 		/* Check if there is a valid command */
 		if (func) {
@@ -254,32 +308,39 @@ int32_t cli_process(struct cli_desc *dev)
 /**
  * Get the CLI commands and correlate them to functions.
  *
+ * The command is looked up in a hash table built from the loaded command
+ * vectors the first time a command is searched after they change.
+ *
  * @param [in] dev       - The device structure.
  * @param [in] command   - Command received from the CLI.
  * @param [out] function - Pointer to the corresponding function.
  *
  * @return 0 in case of success, negative error code otherwise.
  */
-void cli_find_command(struct cli_desc *dev, uint8_t *command,
-		      cmd_func* function)
+int32_t cli_find_command(struct cli_desc *dev, uint8_t *command,
+			 cmd_func* function)
 {
-	uint8_t i = 0;
+	uint8_t slot, i;
+	int32_t ret;
 
-	while (dev->v_cmd_fun[i/2] != NULL) {
-		if(strncmp((char *)command,
-			   (char *)dev->cmd_commands[i],
-			   dev->command_size[i]) == 0 ||
-		    strncmp((char *)command,
-			    (char *)dev->cmd_commands[i + 1],
-			    dev->command_size[i+1]) == 0) {
-			if(dev->command_size == 0) {
-				break;
-			}
+	if(!dev->cmd_hash_valid) {
+		ret = cli_build_hash(dev);
+		if(ret < 0)
+			return ret;
+	}
+
+	slot = cli_hash(command);
+	while(dev->cmd_hash[slot] != 0) {
+		i = dev->cmd_hash[slot] - 1;
+		if(strncmp((char *)command, (char *)dev->cmd_commands[i],
+			   dev->command_size[i]) == 0) {
 			*function = dev->v_cmd_fun[i / 2];
 			break;
 		}
-		i += 2;
+		slot = (slot + 1) & (CLI_HASH_SIZE - 1);
 	}
+
+	return 0;
 }
 
 /**
@@ -350,6 +411,7 @@ int32_t cli_cmd_prompt(struct cli_desc *dev, uint8_t *app_name)
 void cli_load_command_vector(struct cli_desc *dev, cmd_func *command_vector)
 {
 	dev->v_cmd_fun = command_vector;
+	dev->cmd_hash_valid = false;
 }
 
 /**
@@ -365,6 +427,7 @@ void cli_load_command_vector(struct cli_desc *dev, cmd_func *command_vector)
 void cli_load_command_calls(struct cli_desc *dev, uint8_t **command_calls)
 {
 	dev->cmd_commands = command_calls;
+	dev->cmd_hash_valid = false;
 }
 
 /**
@@ -380,6 +443,7 @@ void cli_load_command_calls(struct cli_desc *dev, uint8_t **command_calls)
 void cli_load_command_sizes(struct cli_desc *dev, uint8_t *command_sizes)
 {
 	dev->command_size = command_sizes;
+	dev->cmd_hash_valid = false;
 }
 
 /**
@@ -59,6 +59,10 @@
 #define _SP 32
 #define _HM 2
 
+/* Size of the command lookup table. Must be a power of 2 and greater than
+ * the number of command calls (long and short names). */
+#define CLI_HASH_SIZE 64
+
 /******************************************************************************/
 /*************************** Types Declarations *******************************/
 /******************************************************************************/
@@ -75,6 +79,8 @@ struct cli_desc {
 	cmd_func *v_cmd_fun;
 	void *device_descriptor;
 	uint8_t *command_size;
+	uint8_t cmd_hash[CLI_HASH_SIZE];
+	bool cmd_hash_valid;
 };
 
 /******************************************************************************/
@@ -94,8 +100,8 @@ int32_t cli_parse(struct cli_desc *dev);
 int32_t cli_process(struct cli_desc *dev);
 
 /* Get the CLI commands and correlate them to functions. */
-void cli_find_command(struct cli_desc *dev, uint8_t *command,
-		      cmd_func* function);
+int32_t cli_find_command(struct cli_desc *dev, uint8_t *command,
+			 cmd_func* function);
 
 /* Display command prompt for the user on the CLI at the beginning of the
  * program. */
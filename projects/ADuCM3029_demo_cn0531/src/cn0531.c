@@ -40,6 +40,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 #include "cn0531.h"
 #include "error.h"
 #include "timer.h"
@@ -150,6 +151,9 @@ int32_t cn0531_reg_read(struct cn0531_dev *dev, uint8_t *arg)
 	int32_t val, ret;
 	uint8_t buff[20];
 
+	if (dev->wave_running)
+		return FAILURE;
+
 	addr = strtol((char *)arg, (char **)&err_ptr, 16);
 	if(err_ptr == arg)
 		return FAILURE;
@@ -188,6 +192,9 @@ int32_t cn0531_reg_write(struct cn0531_dev *dev, uint8_t *arg)
 	uint8_t addr, *val_ptr, *err_ptr;
 	int32_t val;
 
+	if (dev->wave_running)
+		return FAILURE;
+
 	addr = strtol((char *)arg, (char **)&val_ptr, 16);
 	if(val_ptr == arg)
 		return FAILURE;
@@ -199,6 +206,29 @@ int32_t cn0531_reg_write(struct cn0531_dev *dev, uint8_t *arg)
 	return ad5791_set_register_value(dev->ad5791_desc, addr, (uint32_t)val);
 }
 
+/**
+ * @brief Convert a voltage to a DAC code.
+ * @param [in] conf_reg - Content of the DAC control register.
+ * @param [in] val - The voltage expressed in volts.
+ * @return The DAC code.
+ */
+static int32_t cn0531_volt_to_code(int32_t conf_reg, float val)
+{
+	const uint8_t dac_bit_no = 20;
+	float dac_ref_pos = CN0531_POSITIVE_REFERENCE,
+	      dac_ref_neg = CN0531_NEGATIVE_REFERENCE, dac_lsb;
+
+	dac_lsb = (dac_ref_pos - dac_ref_neg) / (pow(2, dac_bit_no) - 1);
+
+	if (conf_reg & AD5791_CTRL_RBUF)
+		val = val * 2 - 5;
+
+	if (!(conf_reg & AD5791_CTRL_BIN2SC))
+		return val / dac_lsb;
+	else
+		return (val - dac_ref_neg) / dac_lsb;
+}
+
 /**
  * @brief CLI command to update the output.
  * @param [in] dev - The device structure.
@@ -207,34 +237,363 @@ int32_t cn0531_reg_write(struct cn0531_dev *dev, uint8_t *arg)
  */
 int32_t cn0531_dac_out(struct cn0531_dev *dev, uint8_t *arg)
 {
-	const uint8_t dac_bit_no = 20;
-	float dac_ref_pos = CN0531_POSITIVE_REFERENCE,
-	      dac_ref_neg = CN0531_NEGATIVE_REFERENCE, dac_lsb;
 	float val;
 	uint8_t *err_ptr;
 	int32_t dac_code, conf_reg, ret;
 
+	if (dev->wave_running)
+		return FAILURE;
+
 	val = strtod((char *)arg, (char **)&err_ptr);
 	if(err_ptr == arg)
 		return FAILURE;
 
 	conf_reg = ad5791_get_register_value(dev->ad5791_desc, AD5791_REG_CTRL);
 
-	dac_lsb = (dac_ref_pos - dac_ref_neg) / (pow(2, dac_bit_no) - 1);
+	dac_code = cn0531_volt_to_code(conf_reg, val);
 
-	if (conf_reg & AD5791_CTRL_RBUF)
-		val = val * 2 - 5;
+	ret = ad5791_set_dac_value(dev->ad5791_desc, dac_code);
+	if (ret != SUCCESS)
+		return FAILURE;
 
-	if (!(conf_reg & AD5791_CTRL_BIN2SC))
-		dac_code = val / dac_lsb;
+	return ad5791_soft_instruction(dev->ad5791_desc, AD5791_SOFT_CTRL_LDAC);
+}
+
+/**
+ * @brief Build the SPI frame that writes a code to the DAC register.
+ * @param [out] frame - The frame buffer.
+ * @param [in] code - The DAC code.
+ * @return void
+ */
+static void cn0531_wave_frame(uint8_t *frame, int32_t code)
+{
+	uint32_t spi_word;
+
+	spi_word = AD5791_WRITE | AD5791_ADDR_REG(AD5791_REG_DAC) |
+		   ((uint32_t)code & 0xFFFFF);
+	frame[0] = (spi_word >> 16) & 0xFF;
+	frame[1] = (spi_word >> 8) & 0xFF;
+	frame[2] = spi_word & 0xFF;
+}
+
+/**
+ * @brief Waveform update timer callback.
+ *
+ * Clocks out the next pre-built frame of the waveform table. The SPI transfer
+ * runs in the background; if the previous one is still running when the timer
+ * fires again, the update is skipped and counted as an underrun.
+ * @param [in] param - The device structure.
+ * @param [in] event - Timer event.
+ * @param [in] arg - Not used.
+ * @return void
+ */
+static void cn0531_wave_callback(void *param, uint32_t event, void *arg)
+{
+	struct cn0531_dev *dev = param;
+	bool done;
+
+	if (++dev->wave_prescaler_cnt < dev->wave_timer->sw_prescaler)
+		return;
+	dev->wave_prescaler_cnt = 0;
+
+	if (dev->wave_spi_busy) {
+		if ((spi_write_done(dev->ad5791_desc->spi_desc, &done) != SUCCESS) ||
+		    !done) {
+			dev->wave_underruns++;
+			return;
+		}
+		dev->wave_spi_busy = false;
+	}
+
+	if (spi_write_nonblocking(dev->ad5791_desc->spi_desc,
+				  dev->wave_frames[dev->wave_idx],
+				  CN0531_WAVE_FRAME_SIZE) != SUCCESS) {
+		dev->wave_underruns++;
+		return;
+	}
+	dev->wave_spi_busy = true;
+
+	if (++dev->wave_idx >= dev->wave_len)
+		dev->wave_idx = 0;
+}
+
+/**
+ * @brief Stop the update timer and wait for the last transfer to finish.
+ * @param [in] dev - The device structure.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+static int32_t cn0531_wave_halt(struct cn0531_dev *dev)
+{
+	int32_t ret;
+	bool done;
+
+	if (!dev->wave_running)
+		return SUCCESS;
+
+	ret = timer_counter_activate(dev->wave_timer, false);
+	if (ret != SUCCESS)
+		return FAILURE;
+
+	while (dev->wave_spi_busy) {
+		ret = spi_write_done(dev->ad5791_desc->spi_desc, &done);
+		if (ret != SUCCESS)
+			return FAILURE;
+		if (done)
+			dev->wave_spi_busy = false;
+	}
+	dev->wave_running = false;
+
+	/* Back to LDAC controlled updates */
+	return gpio_set_value(dev->ad5791_desc->gpio_ldac, GPIO_HIGH);
+}
+
+/**
+ * @brief CLI command to append a point to the arbitrary waveform.
+ * @param [in] dev - The device structure.
+ * @param [in] arg - The voltage of the new point in ASCII.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t cn0531_wave_add(struct cn0531_dev *dev, uint8_t *arg)
+{
+	float val;
+	uint8_t *err_ptr;
+	int32_t conf_reg;
+
+	if (dev->wave_running)
+		return FAILURE;
+	if (dev->wave_arb_len >= CN0531_WAVE_MAX_POINTS)
+		return FAILURE;
+
+	val = strtod((char *)arg, (char **)&err_ptr);
+	if(err_ptr == arg)
+		return FAILURE;
+
+	conf_reg = ad5791_get_register_value(dev->ad5791_desc, AD5791_REG_CTRL);
+	if (conf_reg < 0)
+		return FAILURE;
+
+	cn0531_wave_frame(dev->wave_frames[dev->wave_arb_len],
+			  cn0531_volt_to_code(conf_reg, val));
+	dev->wave_arb_len++;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief CLI command to start the waveform generator.
+ *
+ * The whole period is converted to ready to send SPI frames before the timer
+ * is started, so the timer callback only has to start one transfer per
+ * update. The LDAC pin is held low while the generator runs so each frame
+ * updates the output as soon as it is received.
+ * @param [in] dev - The device structure.
+ * @param [in] arg - Shape, update rate and optional amplitude in ASCII.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t cn0531_wave_gen(struct cn0531_dev *dev, uint8_t *arg)
+{
+	struct timer_counter_init timer_init;
+	uint8_t *rate_ptr, *amp_ptr, *err_ptr;
+	int32_t rate, conf_reg, ret;
+	float amp = CN0531_POSITIVE_REFERENCE, val;
+	uint16_t i;
+
+	if (!strncmp((char *)arg, "ramp ", 5) || !strncmp((char *)arg, "sine ", 5))
+		rate_ptr = arg + 5;
+	else if (!strncmp((char *)arg, "arb ", 4))
+		rate_ptr = arg + 4;
 	else
-		dac_code = (val - dac_ref_neg) / dac_lsb;
+		return FAILURE;
 
-	ret = ad5791_set_dac_value(dev->ad5791_desc, dac_code);
+	rate = strtol((char *)rate_ptr, (char **)&amp_ptr, 10);
+	if ((amp_ptr == rate_ptr) || (rate < 1) || (rate > CN0531_WAVE_MAX_RATE))
+		return FAILURE;
+	val = strtod((char *)amp_ptr, (char **)&err_ptr);
+	if (err_ptr != amp_ptr)
+		amp = val;
+
+	ret = cn0531_wave_halt(dev);
 	if (ret != SUCCESS)
 		return FAILURE;
 
-	return ad5791_soft_instruction(dev->ad5791_desc, AD5791_SOFT_CTRL_LDAC);
+	if (arg[0] == 'a') {
+		if (dev->wave_arb_len == 0)
+			return FAILURE;
+		dev->wave_len = dev->wave_arb_len;
+	} else {
+		conf_reg = ad5791_get_register_value(dev->ad5791_desc,
+						     AD5791_REG_CTRL);
+		if (conf_reg < 0)
+			return FAILURE;
+		for (i = 0; i < CN0531_WAVE_MAX_POINTS; i++) {
+			if (arg[0] == 'r')
+				val = -amp + (2 * amp * i) / CN0531_WAVE_MAX_POINTS;
+			else
+				val = amp * sin(2 * M_PI * i / CN0531_WAVE_MAX_POINTS);
+			cn0531_wave_frame(dev->wave_frames[i],
+					  cn0531_volt_to_code(conf_reg, val));
+		}
+		dev->wave_len = CN0531_WAVE_MAX_POINTS;
+		/* The table now holds the ramp/sine, start a new arbitrary one */
+		dev->wave_arb_len = 0;
+	}
+
+	dev->wave_idx = 0;
+	dev->wave_prescaler_cnt = 0;
+	dev->wave_underruns = 0;
+
+	ret = gpio_set_value(dev->ad5791_desc->gpio_ldac, GPIO_LOW);
+	if (ret != SUCCESS)
+		return FAILURE;
+
+	if (!dev->wave_timer) {
+		timer_init.f_update = rate;
+		timer_init.update_timer = CN0531_WAVE_TIMER;
+		timer_init.callback_func_ptr = cn0531_wave_callback;
+		timer_init.callback_param = dev;
+		ret = timer_counter_setup(&dev->wave_timer, &timer_init);
+		if (ret != SUCCESS)
+			return FAILURE;
+		ret = timer_counter_activate(dev->wave_timer, true);
+	} else {
+		ret = timer_counter_set_rate(dev->wave_timer, rate);
+	}
+	if (ret != SUCCESS)
+		return FAILURE;
+	dev->wave_running = true;
+
+	return SUCCESS;
+}
+
+/**
+ * @brief CLI command to stop the waveform generator.
+ * @param [in] dev - The device structure.
+ * @param [in] arg - Not used in this case. It exists to keep the function
+ *                   prototype compatible with the other functions that can be
+ *                   called from the CLI.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t cn0531_wave_stop(struct cn0531_dev *dev, uint8_t *arg)
+{
+	int32_t ret;
+	uint8_t buff[50];
+
+	ret = cn0531_wave_halt(dev);
+	if (ret != SUCCESS)
+		return FAILURE;
+
+	sprintf((char *)buff, "Waveform stopped. Underruns: %lu\n\r",
+		dev->wave_underruns);
+
+	return usr_uart_write_string(dev->cli_desc->uart_device, buff);
+}
+
+/**
+ * @brief CLI command to measure the DAC to ADC loopback linearity.
+ *
+ * The DAC output is stepped over the full range. At each step a multi-pass
+ * ADC capture is averaged, steps where the ADC is saturated are discarded and
+ * a least squares line is fitted through the rest. Only the summary (gain,
+ * offset, maximum INL and noise in ADC LSB) is printed.
+ * @param [in] dev - The device structure.
+ * @param [in] arg - ADC channel, number of steps and samples per step in ASCII.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t cn0531_dac_inl(struct cn0531_dev *dev, uint8_t *arg)
+{
+	uint16_t samples[CN0531_INL_MAX_PASSES];
+	float volt[CN0531_INL_MAX_POINTS], avg[CN0531_INL_MAX_POINTS];
+	float sx = 0, sy = 0, sxx = 0, sxy = 0, gain, offset, inl;
+	float inl_max = 0, noise_max = 0, var;
+	uint8_t *pts_ptr, *pas_ptr, *err_ptr;
+	int32_t channel, points, passes, conf_reg, ret, i, j, used = 0;
+	bool saturated;
+	uint8_t buff[150];
+
+	if (dev->wave_running)
+		return FAILURE;
+
+	channel = strtol((char *)arg, (char **)&pts_ptr, 10);
+	if ((pts_ptr == arg) || (channel < 0) || (channel > 5))
+		return FAILURE;
+	points = strtol((char *)pts_ptr, (char **)&pas_ptr, 10);
+	if ((pas_ptr == pts_ptr) || (points < 2) ||
+	    (points > CN0531_INL_MAX_POINTS))
+		return FAILURE;
+	passes = strtol((char *)pas_ptr, (char **)&err_ptr, 10);
+	if ((err_ptr == pas_ptr) || (passes < 1) ||
+	    (passes > CN0531_INL_MAX_PASSES))
+		return FAILURE;
+
+	conf_reg = ad5791_get_register_value(dev->ad5791_desc, AD5791_REG_CTRL);
+	if (conf_reg < 0)
+		return FAILURE;
+
+	for (i = 0; i < points; i++) {
+		volt[i] = CN0531_NEGATIVE_REFERENCE + i *
+			  (CN0531_POSITIVE_REFERENCE - CN0531_NEGATIVE_REFERENCE) /
+			  (points - 1);
+		ret = ad5791_set_dac_value(dev->ad5791_desc,
+					   cn0531_volt_to_code(conf_reg, volt[i]));
+		if (ret != SUCCESS)
+			return FAILURE;
+		ret = ad5791_soft_instruction(dev->ad5791_desc,
+					      AD5791_SOFT_CTRL_LDAC);
+		if (ret != SUCCESS)
+			return FAILURE;
+
+		ret = aducm3029_adc_capture(dev->platform_adc, 1 << channel,
+					    samples, passes);
+		if (ret != SUCCESS)
+			return FAILURE;
+
+		avg[i] = 0;
+		saturated = false;
+		for (j = 0; j < passes; j++) {
+			avg[i] += samples[j];
+			if ((samples[j] == 0) || (samples[j] >= CN0531_ADC_MAX_CODE))
+				saturated = true;
+		}
+		avg[i] /= passes;
+		if (saturated) {
+			avg[i] = -1;
+			continue;
+		}
+
+		var = 0;
+		for (j = 0; j < passes; j++)
+			var += (samples[j] - avg[i]) * (samples[j] - avg[i]);
+		var = sqrt(var / passes);
+		if (var > noise_max)
+			noise_max = var;
+
+		sx += volt[i];
+		sy += avg[i];
+		sxx += volt[i] * volt[i];
+		sxy += volt[i] * avg[i];
+		used++;
+	}
+
+	if (used < 2)
+		return usr_uart_write_string(dev->cli_desc->uart_device,
+					     (uint8_t*)"Not enough unsaturated steps.\n\r");
+
+	gain = (used * sxy - sx * sy) / (used * sxx - sx * sx);
+	offset = (sy - gain * sx) / used;
+
+	for (i = 0; i < points; i++) {
+		if (avg[i] < 0)
+			continue;
+		inl = fabs(avg[i] - (offset + gain * volt[i]));
+		if (inl > inl_max)
+			inl_max = inl;
+	}
+
+	sprintf((char *)buff, "Steps used: %ld of %ld\n\rGain: %.3f LSB/V\n\r"
+		"Offset: %.3f LSB\n\rMax INL: %.3f LSB\n\rMax noise: %.3f LSB rms\n\r",
+		used, points, gain, offset, inl_max, noise_max);
+
+	return usr_uart_write_string(dev->cli_desc->uart_device, buff);
 }
 
 /**
@@ -266,6 +625,14 @@ static int32_t cn0531_init_cli_load(struct cn0531_dev *dev)
 	dev->cn0531_cmd_calls[5] = (uint8_t *)"drw ";
 	dev->cn0531_cmd_calls[6] = (uint8_t *)"dac_out ";
 	dev->cn0531_cmd_calls[7] = (uint8_t *)"do ";
+	dev->cn0531_cmd_calls[8] = (uint8_t *)"dac_wave_add ";
+	dev->cn0531_cmd_calls[9] = (uint8_t *)"dwa ";
+	dev->cn0531_cmd_calls[10] = (uint8_t *)"dac_wave_gen ";
+	dev->cn0531_cmd_calls[11] = (uint8_t *)"dwg ";
+	dev->cn0531_cmd_calls[12] = (uint8_t *)"dac_wave_stop";
+	dev->cn0531_cmd_calls[13] = (uint8_t *)"dws";
+	dev->cn0531_cmd_calls[14] = (uint8_t *)"dac_inl ";
+	dev->cn0531_cmd_calls[15] = (uint8_t *)"di ";
 
 	dev->cn0531_cmd_func_tab = (cmd_func *)calloc((CN0531_CLI_CMD_NO + 1),
 				   sizeof *dev->cn0531_cmd_func_tab);
@@ -275,6 +642,10 @@ static int32_t cn0531_init_cli_load(struct cn0531_dev *dev)
 	dev->cn0531_cmd_func_tab[1] = (cmd_func)cn0531_reg_read;
 	dev->cn0531_cmd_func_tab[2] = (cmd_func)cn0531_reg_write;
 	dev->cn0531_cmd_func_tab[3] = (cmd_func)cn0531_dac_out;
+	dev->cn0531_cmd_func_tab[4] = (cmd_func)cn0531_wave_add;
+	dev->cn0531_cmd_func_tab[5] = (cmd_func)cn0531_wave_gen;
+	dev->cn0531_cmd_func_tab[6] = (cmd_func)cn0531_wave_stop;
+	dev->cn0531_cmd_func_tab[7] = (cmd_func)cn0531_dac_inl;
 
 	dev->cn0531_cmd_size = (uint8_t *)calloc((CN0531_CLI_CMD_NO * 2 + 1),
 			       sizeof *dev->cn0531_cmd_size);
@@ -288,6 +659,14 @@ static int32_t cn0531_init_cli_load(struct cn0531_dev *dev)
 	dev->cn0531_cmd_size[5] = 4;
 	dev->cn0531_cmd_size[6] = 8;
 	dev->cn0531_cmd_size[7] = 3;
+	dev->cn0531_cmd_size[8] = 13;
+	dev->cn0531_cmd_size[9] = 4;
+	dev->cn0531_cmd_size[10] = 13;
+	dev->cn0531_cmd_size[11] = 4;
+	dev->cn0531_cmd_size[12] = 14;
+	dev->cn0531_cmd_size[13] = 4;
+	dev->cn0531_cmd_size[14] = 8;
+	dev->cn0531_cmd_size[15] = 3;
 
 	return SUCCESS;
 
@@ -395,6 +774,9 @@ int32_t cn0531_remove(struct cn0531_dev *dev)
 	if (!dev)
 		return FAILURE;
 
+	cn0531_wave_halt(dev);
+	if (dev->wave_timer)
+		timer_counter_remove(dev->wave_timer);
 	cn0531_remove_cli_unload(dev);
 	cli_remove(dev->cli_desc);
 	ad5791_remove(dev->ad5791_desc);
@@ -44,14 +44,26 @@
 #include "cli.h"
 #include "ad5791.h"
 #include "aducm3029_adc.h"
+#include "timer.h"
 
-#define CN0531_CLI_CMD_NO 4
+#define CN0531_CLI_CMD_NO 8
 #define HELP_SHORT_COMMAND true
 #define HELP_LONG_COMMAND false
 
 #define CN0531_POSITIVE_REFERENCE (float)5
 #define CN0531_NEGATIVE_REFERENCE (float)-5
 
+/* Waveform generator */
+#define CN0531_WAVE_TIMER		1
+#define CN0531_WAVE_MAX_POINTS		256
+#define CN0531_WAVE_MAX_RATE		10000
+#define CN0531_WAVE_FRAME_SIZE		3
+
+/* Loopback linearity characterization */
+#define CN0531_INL_MAX_POINTS		64
+#define CN0531_INL_MAX_PASSES		64
+#define CN0531_ADC_MAX_CODE		4095
+
 #define CN0531_HELP_DAC_LONG " dac_reg_read <addr>        - Read a DAC register.\n\r" \
 					     "                              <addr> = address of the register to be read in hexadecimal.\n\r" \
 					     "                              Example: dac_reg_read 1\n\r" \
@@ -61,7 +73,23 @@
 					     "                              Example: dac_reg_write 1 18c\n\r" \
 					     " dac_out <volt>             - Update the DAC output voltage.\n\r" \
 					     "                              <volt> = new voltage value expressed in volts.\n\r" \
-					     "                              Example: dac_out 1.4\n\r"
+					     "                              Example: dac_out 1.4\n\r" \
+					     " dac_wave_add <volt>        - Append a point to the arbitrary waveform.\n\r" \
+					     "                              <volt> = voltage of the point expressed in volts.\n\r" \
+					     "                              Example: dac_wave_add -1.5\n\r" \
+					     " dac_wave_gen <s> <r> [<a>] - Start generating a waveform.\n\r" \
+					     "                              <s> = shape: ramp, sine or arb.\n\r" \
+					     "                              <r> = update rate in Hz, 1 to 10000.\n\r" \
+					     "                              <a> = amplitude in volts for ramp and sine, default 5.\n\r" \
+					     "                              Ramp and sine have 256 points per period.\n\r" \
+					     "                              Example: dac_wave_gen sine 1000 2.5\n\r" \
+					     " dac_wave_stop              - Stop the waveform generator.\n\r" \
+					     "                              Example: dac_wave_stop\n\r" \
+					     " dac_inl <ch> <n> <p>       - Measure DAC to ADC loopback linearity.\n\r" \
+					     "                              <ch> = ADC channel, 0 to 5.\n\r" \
+					     "                              <n> = number of DAC steps, 2 to 64.\n\r" \
+					     "                              <p> = ADC samples averaged per step, 1 to 64.\n\r" \
+					     "                              Example: dac_inl 0 32 16\n\r"
 #define CN0531_HELP_DAC_SHORT " drr <addr>       - Read a DAC register.\n\r" \
 					     "                    <addr> = address of the register to be read in hexadecimal.\n\r" \
 					     "                    Example: dac_reg_read 1\n\r" \
@@ -71,12 +99,30 @@
 					     "                    Example: dac_reg_write 1 18c\n\r" \
 					     " do <volt>        - Update the DAC output voltage.\n\r" \
 					     "                    <volt> = new voltage value expressed in volts.\n\r" \
-					     "                    Example: do -2.3\n\r"
+					     "                    Example: do -2.3\n\r" \
+					     " dwa <volt>       - Append a point to the arbitrary waveform.\n\r" \
+					     "                    Example: dwa -1.5\n\r" \
+					     " dwg <s> <r> [<a>]- Start generating a waveform.\n\r" \
+					     "                    Example: dwg ramp 500\n\r" \
+					     " dws              - Stop the waveform generator.\n\r" \
+					     "                    Example: dws\n\r" \
+					     " di <ch> <n> <p>  - Measure DAC to ADC loopback linearity.\n\r" \
+					     "                    Example: di 0 32 16\n\r"
 
 struct cn0531_dev {
 	struct cli_desc *cli_desc;
 	struct ad5791_dev *ad5791_desc;
 	struct aducm3029_adc_desc *platform_adc;
+	struct timer_counter_desc *wave_timer;
+	/* Pre-built DAC register write frames, one per waveform point */
+	uint8_t wave_frames[CN0531_WAVE_MAX_POINTS][CN0531_WAVE_FRAME_SIZE];
+	uint16_t wave_len;
+	uint16_t wave_arb_len;
+	volatile uint16_t wave_idx;
+	volatile uint8_t wave_prescaler_cnt;
+	volatile bool wave_spi_busy;
+	volatile uint32_t wave_underruns;
+	bool wave_running;
 	cmd_func *cn0531_cmd_func_tab;
 	uint8_t **cn0531_cmd_calls;
 	uint8_t *cn0531_cmd_size;
@@ -100,6 +146,18 @@ int32_t cn0531_reg_write(struct cn0531_dev *dev, uint8_t *arg);
 /** CLI command to update the output. */
 int32_t cn0531_dac_out(struct cn0531_dev *dev, uint8_t *arg);
 
+/** CLI command to append a point to the arbitrary waveform. */
+int32_t cn0531_wave_add(struct cn0531_dev *dev, uint8_t *arg);
+
+/** CLI command to start the waveform generator. */
+int32_t cn0531_wave_gen(struct cn0531_dev *dev, uint8_t *arg);
+
+/** CLI command to stop the waveform generator. */
+int32_t cn0531_wave_stop(struct cn0531_dev *dev, uint8_t *arg);
+
+/** CLI command to measure the DAC to ADC loopback linearity. */
+int32_t cn0531_dac_inl(struct cn0531_dev *dev, uint8_t *arg);
+
 /** Application process. Needs to run in a loop. */
 int32_t cn0531_process(struct cn0531_dev *dev);
 
@@ -44,6 +44,7 @@
 /******************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /******************************************************************************/
 /********************** Macros and Constants Definitions **********************/
@@ -107,4 +108,12 @@ int32_t spi_write_and_read(struct spi_desc *desc,
 			   uint8_t *data,
 			   uint8_t bytes_number);
 
+/* Start a non-blocking write to SPI. */
+int32_t spi_write_nonblocking(struct spi_desc *desc,
+			      uint8_t *data,
+			      uint8_t bytes_number);
+
+/* Check if the non-blocking write is done and release the controller. */
+int32_t spi_write_done(struct spi_desc *desc, bool *done);
+
 #endif // SPI_H_
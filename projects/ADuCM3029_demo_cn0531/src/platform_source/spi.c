@@ -236,3 +236,60 @@ int32_t spi_write_and_read(struct spi_desc *desc,
 
 	return bytes_number;
 }
+
+/**
+ * @brief Start a non-blocking write to SPI.
+ *
+ * The transfer is interrupt driven and the function returns immediately, so
+ * it can be called from interrupt context. Only the hardware chip select is
+ * supported. spi_write_done() must report the transfer as done before the
+ * next one is started.
+ * @param desc - The SPI descriptor.
+ * @param data - The buffer with the transmitted data. Must stay valid until
+ *               the transfer is done.
+ * @param bytes_number - Number of bytes to write.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t spi_write_nonblocking(struct spi_desc *desc,
+			      uint8_t *data,
+			      uint8_t bytes_number)
+{
+	ADI_SPI_TRANSCEIVER m_spi_transceive;
+
+	if(desc->chip_select)
+		return FAILURE;
+
+	m_spi_transceive.pTransmitter = data;
+	m_spi_transceive.TransmitterBytes = bytes_number;
+	m_spi_transceive.nTxIncrement = 1;
+	m_spi_transceive.pReceiver = NULL;
+	m_spi_transceive.ReceiverBytes = 0;
+	m_spi_transceive.nRxIncrement = 0;
+	m_spi_transceive.bDMA = false;
+	m_spi_transceive.bRD_CTL = false;
+
+	return adi_spi_MasterSubmitBuffer(h_spi_device, &m_spi_transceive);
+}
+
+/**
+ * @brief Check if the non-blocking write is done and release the controller.
+ *
+ * Must only be called while a transfer started by spi_write_nonblocking() is
+ * pending.
+ * @param desc - The SPI descriptor.
+ * @param done - true if the transfer is done, false if it is still running.
+ * @return SUCCESS in case of success, FAILURE otherwise.
+ */
+int32_t spi_write_done(struct spi_desc *desc, bool *done)
+{
+	uint32_t hw_error;
+	int32_t ret;
+
+	ret = adi_spi_isBufferAvailable(h_spi_device, done);
+	if(ret != SUCCESS)
+		return ret;
+	if(!*done)
+		return SUCCESS;
+
+	return adi_spi_GetBuffer(h_spi_device, &hw_error);
+}
@@ -42,16 +42,100 @@
 #include <stdio.h>
 #include <string.h>
 #include <inttypes.h>
+#include <sys/platform.h>
+#include <drivers/pwr/adi_pwr.h>
 #include "no_os_gpio.h"
 #include "no_os_error.h"
 #include "debug.h"
 
+/* Length in seconds of each enum geiger_window */
+static const uint32_t window_seconds[GEIGER_WINDOW_NB] = {1, 10, 60};
+
+/*
+ * Microseconds since start, from the seconds count and the cycle counter. In
+ * 32 bits it would wrap after 71.6 minutes.
+ */
+static uint64_t get_timestamp(struct geiger_counter *desc)
+{
+	uint32_t seconds;
+	uint32_t cycles;
+
+	/* Retry if the RTC tick changed the time base meanwhile */
+	do {
+		seconds = desc->seconds;
+		cycles = DWT->CYCCNT - desc->tick_cycles;
+	} while (seconds != desc->seconds);
+
+	return (uint64_t)seconds * 1000000u + cycles / desc->cycles_per_us;
+}
+
 /* Called at each geiger pulse */
 void counter_callback(void *ctx, uint32_t event, void *extra)
 {
 	struct geiger_counter *desc = ctx;
 
+	geiger_counter_pulse(desc, get_timestamp(desc));
+}
+
+/* Count one pulse and log its timestamp. Called from the pulse interrupt */
+void geiger_counter_pulse(struct geiger_counter *desc, uint64_t timestamp)
+{
+	uint32_t head = desc->log_head;
+
 	desc->count++;
+	desc->pulses++;
+
+	/* Keep the oldest entries until they are flushed */
+	if (head - desc->log_tail >= GEIGER_LOG_SIZE) {
+		desc->log_lost++;
+		return;
+	}
+	desc->log[head & (GEIGER_LOG_SIZE - 1)] = timestamp;
+	desc->log_head = head + 1;
+}
+
+/*
+ * Close the current second. Called each second from the RTC interrupt, it
+ * moves the running count of every window in constant time.
+ */
+void geiger_counter_tick(struct geiger_counter *desc)
+{
+	uint32_t pulses = desc->pulses;
+	uint32_t new_sample;
+	uint32_t old_idx;
+	uint32_t i;
+
+	new_sample = pulses - desc->last_pulses;
+	desc->last_pulses = pulses;
+
+	for (i = 0; i < GEIGER_WINDOW_NB; i++) {
+		/* Drop the second leaving the window once it is full */
+		if (desc->ring_filled >= window_seconds[i]) {
+			old_idx = (desc->ring_idx + GEIGER_RING_SIZE -
+				   window_seconds[i]) % GEIGER_RING_SIZE;
+			desc->sum[i] -= desc->ring[old_idx];
+		}
+		desc->sum[i] += new_sample;
+	}
+	desc->ring[desc->ring_idx] = new_sample;
+	desc->ring_idx = (desc->ring_idx + 1) % GEIGER_RING_SIZE;
+	if (desc->ring_filled < GEIGER_RING_SIZE)
+		desc->ring_filled++;
+
+	desc->tick_cycles = DWT->CYCCNT;
+	desc->seconds++;
+}
+
+/* Select the averaging window of the CPM */
+int32_t geiger_counter_set_window(struct geiger_counter *desc,
+				  enum geiger_window window)
+{
+	if (!desc || window >= GEIGER_WINDOW_NB)
+		return -EINVAL;
+
+	desc->window = window;
+
+	return SUCCESS;
 }
 
 /* Initialize Geiger counter structure */
@@ -60,9 +144,10 @@ int32_t init_geiger_counter(struct geiger_counter **desc,
 {
 	struct no_os_callback_desc callback_desc;
 	struct geiger_counter *ldesc;
+	uint32_t		hclk;
 	int32_t			ret;
 
-	if (!desc || !param)
+	if (!desc || !param || param->window >= GEIGER_WINDOW_NB)
 		return -EINVAL;
 
 	ldesc =  (struct geiger_counter *)calloc(1, sizeof(*ldesc));
@@ -71,6 +156,20 @@ int32_t init_geiger_counter(struct geiger_counter **desc,
 		return -ENOMEM;
 	}
 
+	/* Fill geiger_counter descriptor */
+	ldesc->window = param->window;
+	ldesc->dead_time = param->dead_time_us / 1000000.0f;
+	ldesc->tube_factor = param->tube_factor;
+	ldesc->ready = false;
+
+	/* Cycle counter used to timestamp the pulses */
+	if (adi_pwr_GetClockFrequency(ADI_CLOCK_HCLK, &hclk) != ADI_PWR_SUCCESS)
+		hclk = 26000000;
+	ldesc->cycles_per_us = hclk / 1000000;
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	ldesc->tick_cycles = DWT->CYCCNT;
+
 	/* Config counter gpio */
 	ret = no_os_gpio_get(&ldesc->counter_gpio, param->gpio_init_param);
 	ON_ERR_PRINT_AND_RET("Unable to get gpio\n", ret);
@@ -93,11 +192,6 @@ int32_t init_geiger_counter(struct geiger_counter **desc,
 	ret = no_os_irq_enable(ldesc->irq_desc, param->irq_id);
 	ON_ERR_PRINT_AND_RET("Counter irq_enable failed\n", ret);
 
-	/* Fill geiger_counter descriptor */
-	memset(ldesc->samples, 0xFF, sizeof(ldesc->samples));
-	ldesc->count = 0;
-	ldesc->count_per_minute = 0;
-	ldesc->ready = false;
 	*desc = ldesc;
 
 	return SUCCESS;
@@ -115,30 +209,38 @@ void delete_geiger_counter(struct geiger_counter *desc)
 /* This function will be called each SAMPLING_PERIOD seconds */
 void calculate_CPM(struct geiger_counter *desc)
 {
+	uint32_t primask;
+	uint32_t seconds;
 	uint32_t sum;
-	uint32_t new_sample;
-	uint32_t i;
+	float rate;
+	float loss;
 
-	new_sample = desc->count - desc->last_count;
-	desc->last_count = desc->count;
+	/* The RTC interrupt updates the window, read it in one go */
+	primask = __get_PRIMASK();
+	__disable_irq();
+	sum = desc->sum[desc->window];
+	seconds = desc->ring_filled;
+	__set_PRIMASK(primask);
 
-	sum = new_sample;
-	if (desc->samples[0] == (uint64_t)(-1)) {//If it is the first read
-		/* Fill samples with the first value */
-		for (i = 0; i < NB_AVARGE_SAMPLES; i++) {
-			desc->samples[i] = new_sample;
-		}
-	}
-	/* Shift samples and calculate sum */
-	for (i = 1; i < NB_AVARGE_SAMPLES; i++) {
-		sum += desc->samples[i];
-		desc->samples[i - 1] = desc->samples[i];
-	}
-	desc->samples[NB_AVARGE_SAMPLES - 1] = new_sample;
+	/* Until the window is full, average over the seconds available */
+	if (seconds > window_seconds[desc->window])
+		seconds = window_seconds[desc->window];
+	if (!seconds)
+		return;
+
+	/*
+	 * Non paralyzable dead time: each recorded pulse blinds the tube for
+	 * dead_time, so the true rate is m / (1 - m * dead_time).
+	 */
+	rate = (float)sum / seconds;
+	loss = rate * desc->dead_time;
+	desc->saturated = loss >= 0.95f;
+	if (desc->saturated)
+		loss = 0.95f;
 
-	desc->count_per_minute = ((float)sum / NB_AVARGE_SAMPLES) *
-				 (60 / SAMPLING_PERIOD);
-	desc->us_per_hour = (float)desc->count_per_minute * CONVERSION_FACTOR;
+	desc->raw_count_per_minute = rate * 60;
+	desc->count_per_minute = rate / (1.0f - loss) * 60;
+	desc->us_per_hour = (float)desc->count_per_minute * desc->tube_factor;
 }
 
 /* Print data in buffer in a more readable format */
@@ -149,3 +251,36 @@ int serialize_data(struct geiger_counter *desc, char *buff, int32_t buff_size)
 			"uSv_per_hour: %3.2f\r\n",
 			desc->count, desc->count_per_minute, desc->us_per_hour);
 }
+
+/*
+ * Move as many logged pulse timestamps as fit into buff and remove them from
+ * the log. Returns 0 when the log is empty.
+ */
+int serialize_log(struct geiger_counter *desc, char *buff, int32_t buff_size)
+{
+	uint32_t head = desc->log_head;
+	uint32_t tail = desc->log_tail;
+	int len;
+	int n;
+
+	if (tail == head)
+		return 0;
+
+	len = snprintf(buff, buff_size, "Pulses lost:%" PRIu32 "; us:",
+		       desc->log_lost);
+	/* Leave room for the line ending */
+	while (tail != head && len < buff_size - 2) {
+		n = snprintf(buff + len, buff_size - 2 - len, " %" PRIu64,
+			     desc->log[tail & (GEIGER_LOG_SIZE - 1)]);
+		if (n >= buff_size - 2 - len)
+			break;
+		len += n;
+		tail++;
+	}
+	if (tail == desc->log_tail)
+		return 0;
+	desc->log_tail = tail;
+	len += snprintf(buff + len, buff_size - len, "\r\n");
+
+	return len;
+}
@@ -43,13 +43,23 @@
 #include "no_os_irq.h"
 #include "irq_extra.h"
 #include <stdint.h>
+#include <stdbool.h>
 
 /* Number of seconds between each measurement */
 #define SAMPLING_PERIOD		10//seconds
-/* Number of measurements used for average filtering */
-#define NB_AVARGE_SAMPLES	5
-/* Conversion factor from counts/minute -> microSieverts/minute */
+/* Averaging window used for the CPM, one of enum geiger_window */
+#define CONFIG_WINDOW		GEIGER_WINDOW_60S
+/* Conversion factor from counts/minute -> microSieverts/hour */
 #define CONVERSION_FACTOR	0.01
+/* Dead time of the tube in microseconds, used for the CPM correction */
+#define DEAD_TIME_US		90
+/* Send the timestamp of each pulse after every measurement */
+#define CONFIG_SEND_PULSE_LOG	0
+
+/* Longest averaging window, in seconds */
+#define GEIGER_RING_SIZE	60
+/* Number of pulse timestamps kept between two flushes, power of 2 */
+#define GEIGER_LOG_SIZE		256
 
 /*
  * Depending of the jumper soldered on the board one of these 3 options is
@@ -73,12 +83,42 @@
 #endif
 
 
+enum geiger_window {
+	GEIGER_WINDOW_1S,
+	GEIGER_WINDOW_10S,
+	GEIGER_WINDOW_60S,
+	GEIGER_WINDOW_NB
+};
+
 struct geiger_counter {
-	uint64_t			count;
-	uint64_t			last_count;
-	uint64_t			samples[NB_AVARGE_SAMPLES];
+	/* Total number of pulses */
+	volatile uint64_t		count;
+	/* Pulses counter used for the per second counts */
+	volatile uint32_t		pulses;
+	uint32_t			last_pulses;
+	/* Counts of the last GEIGER_RING_SIZE seconds */
+	uint32_t			ring[GEIGER_RING_SIZE];
+	uint32_t			ring_idx;
+	uint32_t			ring_filled;
+	/* Running count over each window */
+	uint32_t			sum[GEIGER_WINDOW_NB];
+	enum geiger_window		window;
+	/* Seconds since start and cycle counter value when it changed */
+	volatile uint32_t		seconds;
+	volatile uint32_t		tick_cycles;
+	uint32_t			cycles_per_us;
+	/* Pulse timestamps in microseconds since start */
+	uint64_t			log[GEIGER_LOG_SIZE];
+	volatile uint32_t		log_head;
+	volatile uint32_t		log_tail;
+	volatile uint32_t		log_lost;
+	/* Dead time in seconds and counts/minute -> uSv/hour factor */
+	float				dead_time;
+	float				tube_factor;
+	uint32_t			raw_count_per_minute;
 	uint32_t			count_per_minute;
 	float				us_per_hour;
+	bool				saturated;
 	bool				ready;
 	struct no_os_gpio_desc		*counter_gpio;
 	struct no_os_irq_ctrl_desc	*irq_desc;
@@ -95,12 +135,23 @@ struct geiger_counter_init_param {
 	enum irq_mode			irq_config;
 	/* Gpio init parameter used for the generated interrupt */
 	struct no_os_gpio_init_param	*gpio_init_param;
+	/* Averaging window of the CPM */
+	enum geiger_window		window;
+	/* Dead time of the tube in microseconds */
+	uint32_t			dead_time_us;
+	/* Conversion factor from counts/minute -> microSieverts/hour */
+	float				tube_factor;
 };
 
 int32_t init_geiger_counter(struct geiger_counter **desc,
 			    struct geiger_counter_init_param *param);
 void delete_geiger_counter(struct geiger_counter *desc);
+void geiger_counter_pulse(struct geiger_counter *desc, uint64_t timestamp);
+void geiger_counter_tick(struct geiger_counter *desc);
+int32_t geiger_counter_set_window(struct geiger_counter *desc,
+				  enum geiger_window window);
 void calculate_CPM(struct geiger_counter *desc);
 int serialize_data(struct geiger_counter *desc, char *buff, int32_t buff_size);
+int serialize_log(struct geiger_counter *desc, char *buff, int32_t buff_size);
 
 #endif /* GEIGER_COUNTER_H */
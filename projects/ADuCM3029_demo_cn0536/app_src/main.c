@@ -132,6 +132,7 @@ void rtc_callback(void *ctx, uint32_t data, void *extra)
 {
 	static int	count = 0;
 
+	geiger_counter_tick(ctx);
 	count++;
 	if (count == SAMPLING_PERIOD) {
 		is_ready = true;
@@ -184,7 +185,10 @@ int32_t setup(struct geiger_counter **counter,union comm_desc *comm_desc,
 		.irq_desc = *irq_ctrl,
 		.irq_id = CONFIG_COUNTER_XINT_ID,
 		.irq_config = CONFIG_XINT_EVENT,
-		.gpio_init_param = &gpio_counter_param
+		.gpio_init_param = &gpio_counter_param,
+		.window = CONFIG_WINDOW,
+		.dead_time_us = DEAD_TIME_US,
+		.tube_factor = CONVERSION_FACTOR
 	};
 	ret = init_geiger_counter(counter, &init_param);
 	ON_ERR_PRINT_AND_RET("init_geiger_counter failed\n", ret);
@@ -208,7 +212,7 @@ int32_t setup(struct geiger_counter **counter,union comm_desc *comm_desc,
 	call = (struct no_os_callback_desc) {
 		.legacy_callback = rtc_callback,
 		.legacy_config = &rtc_config,
-		.ctx = NULL
+		.ctx = *counter
 	};
 	ret = no_os_irq_register_callback(*irq_ctrl, ADUCM_RTC_INT_ID, &call);
 	ON_ERR_PRINT_AND_RET("RTC irq_register_callback failed\n", ret);
@@ -257,6 +261,16 @@ int main(int argc, char *argv[])
 			ret = send_data(comm_desc, msg_buff, msg_len);
 			if (NO_OS_IS_ERR_VALUE(ret))
 				break;
+#if CONFIG_SEND_PULSE_LOG
+			while ((msg_len = serialize_log(counter, msg_buff,
+							DATA_BUFF_SIZE)) > 0) {
+				ret = send_data(comm_desc, msg_buff, msg_len);
+				if (NO_OS_IS_ERR_VALUE(ret))
+					break;
+			}
+			if (NO_OS_IS_ERR_VALUE(ret))
+				break;
+#endif
 		}
 	}
 
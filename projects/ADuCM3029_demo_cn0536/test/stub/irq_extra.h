@@ -0,0 +1,14 @@
+/* Host replacement of the ADuCM3029 interrupt header */
+
+#ifndef IRQ_EXTRA_H_
+#define IRQ_EXTRA_H_
+
+enum irq_mode {
+	IRQ_RISING_EDGE,
+	IRQ_FALLING_EDGE,
+	IRQ_EITHER_EDGE,
+	IRQ_HIGH_LEVEL,
+	IRQ_LOW_LEVEL
+};
+
+#endif
@@ -0,0 +1,21 @@
+/* Host replacement of the no-OS GPIO header */
+
+#ifndef NO_OS_GPIO_H_
+#define NO_OS_GPIO_H_
+
+#include <stdint.h>
+
+struct no_os_gpio_init_param {
+	int32_t number;
+};
+
+struct no_os_gpio_desc {
+	int32_t number;
+};
+
+int32_t no_os_gpio_get(struct no_os_gpio_desc **desc,
+		       const struct no_os_gpio_init_param *param);
+int32_t no_os_gpio_remove(struct no_os_gpio_desc *desc);
+int32_t no_os_gpio_direction_input(struct no_os_gpio_desc *desc);
+
+#endif
@@ -0,0 +1,25 @@
+/* Host replacement of the no-OS interrupt header */
+
+#ifndef NO_OS_IRQ_H_
+#define NO_OS_IRQ_H_
+
+#include <stdint.h>
+
+struct no_os_irq_ctrl_desc;
+
+struct no_os_callback_desc {
+	void (*legacy_callback)(void *ctx, uint32_t event, void *extra);
+	void *ctx;
+	void *legacy_config;
+};
+
+int32_t no_os_irq_register_callback(struct no_os_irq_ctrl_desc *desc,
+				    uint32_t irq_id,
+				    struct no_os_callback_desc *callback_desc);
+int32_t no_os_irq_unregister_callback(struct no_os_irq_ctrl_desc *desc,
+				      uint32_t irq_id,
+				      struct no_os_callback_desc *callback_desc);
+int32_t no_os_irq_enable(struct no_os_irq_ctrl_desc *desc, uint32_t irq_id);
+int32_t no_os_irq_disable(struct no_os_irq_ctrl_desc *desc, uint32_t irq_id);
+
+#endif
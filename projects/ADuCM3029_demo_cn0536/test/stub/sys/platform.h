@@ -0,0 +1,34 @@
+/* Host replacement of the core registers used by geiger_counter.c */
+
+#include <stdint.h>
+
+typedef struct {
+	volatile uint32_t CTRL;
+	volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+	volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+/* Defined by the test, which runs the cycle counter */
+extern DWT_Type dwt_model;
+extern CoreDebug_Type core_debug_model;
+
+#define DWT				(&dwt_model)
+#define CoreDebug			(&core_debug_model)
+#define DWT_CTRL_CYCCNTENA_Msk		1u
+#define CoreDebug_DEMCR_TRCENA_Msk	(1u << 24)
+
+static inline uint32_t __get_PRIMASK(void)
+{
+	return 0;
+}
+
+static inline void __set_PRIMASK(uint32_t primask)
+{
+}
+
+static inline void __disable_irq(void)
+{
+}
@@ -0,0 +1,373 @@
+/* Host test of the Geiger counter with simulated pulse trains
+ *
+ * Pulses arrive as a Poisson process of a given true rate and go through a
+ * non paralyzable dead time: after each recorded pulse the tube is blind for
+ * DEAD_TIME_US. Recorded pulses call the interrupt callback with the DWT
+ * cycle counter of the model set to the time of the pulse, and the RTC tick
+ * is called at every whole second, as on the board.
+ *
+ * The test checks the running sums of every window against a brute force sum,
+ * the dead time corrected CPM against the true rate, the statistics of the
+ * simulated train, and the pulse timestamps over more than the 71.6 minutes a
+ * 32 bit microsecond count lasts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/platform.h>
+#include <drivers/pwr/adi_pwr.h>
+#include "no_os_gpio.h"
+#include "no_os_error.h"
+#include "geiger_counter.h"
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+#define HCLK		26000000u
+#define DEAD_TIME	(DEAD_TIME_US * 1e-6)
+
+DWT_Type dwt_model;
+CoreDebug_Type core_debug_model;
+
+static struct no_os_callback_desc pulse_callback;
+
+ADI_PWR_RESULT adi_pwr_GetClockFrequency(ADI_CLOCK_ID clock, uint32_t *freq)
+{
+	*freq = HCLK;
+
+	return ADI_PWR_SUCCESS;
+}
+
+int32_t no_os_gpio_get(struct no_os_gpio_desc **desc,
+		       const struct no_os_gpio_init_param *param)
+{
+	static struct no_os_gpio_desc gpio;
+
+	*desc = &gpio;
+
+	return 0;
+}
+
+int32_t no_os_gpio_remove(struct no_os_gpio_desc *desc)
+{
+	return 0;
+}
+
+int32_t no_os_gpio_direction_input(struct no_os_gpio_desc *desc)
+{
+	return 0;
+}
+
+int32_t no_os_irq_register_callback(struct no_os_irq_ctrl_desc *desc,
+				    uint32_t irq_id,
+				    struct no_os_callback_desc *callback_desc)
+{
+	pulse_callback = *callback_desc;
+
+	return 0;
+}
+
+int32_t no_os_irq_unregister_callback(struct no_os_irq_ctrl_desc *desc,
+				      uint32_t irq_id,
+				      struct no_os_callback_desc *callback_desc)
+{
+	return 0;
+}
+
+int32_t no_os_irq_enable(struct no_os_irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	return 0;
+}
+
+int32_t no_os_irq_disable(struct no_os_irq_ctrl_desc *desc, uint32_t irq_id)
+{
+	return 0;
+}
+
+static uint64_t seed = 1;
+
+/* Uniform in 0 .. 1, never 0 */
+static double rnd_unit(void)
+{
+	seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+
+	return ((seed >> 11) + 1) / 9007199254740993.0;
+}
+
+/* Simulated time, in HCLK cycles from the start */
+static uint64_t now_cycles;
+
+static void set_time(double t)
+{
+	now_cycles = (uint64_t)(t * HCLK);
+	dwt_model.CYCCNT = (uint32_t)now_cycles;
+}
+
+static struct geiger_counter *counter_init(enum geiger_window window)
+{
+	struct geiger_counter_init_param param = {
+		.irq_config = IRQ_RISING_EDGE,
+		.window = window,
+		.dead_time_us = DEAD_TIME_US,
+		.tube_factor = CONVERSION_FACTOR,
+	};
+	struct geiger_counter *counter = NULL;
+
+	set_time(0);
+	CHECK(init_geiger_counter(&counter, &param) == SUCCESS);
+
+	return counter;
+}
+
+/* Length of each window in seconds */
+static const uint32_t window_len[GEIGER_WINDOW_NB] = {1, 10, 60};
+
+/* Counts of every simulated second, for the brute force sums */
+#define MAX_SECONDS	50000
+static uint32_t second_counts[MAX_SECONDS];
+
+struct run_result {
+	uint32_t seconds;
+	uint64_t recorded;
+	/* Mean of the corrected and raw CPM over the measurements */
+	double cpm;
+	double raw_cpm;
+	/* Variance / mean of the counts per second */
+	double dispersion;
+	uint32_t bad_sums;
+	uint32_t bad_stamps;
+	uint64_t stamps;
+	uint32_t lost;
+	bool saturated;
+};
+
+/* Timestamps the log should hold, same size and policy as the log */
+static uint64_t expect[GEIGER_LOG_SIZE];
+static uint32_t expect_head;
+static uint32_t expect_tail;
+
+/* Check the timestamps flushed from the log against the expected ones */
+static void flush_log(struct geiger_counter *counter, struct run_result *res)
+{
+	char buff[512], *p, *end;
+	uint64_t stamp;
+	int len;
+
+	while ((len = serialize_log(counter, buff, sizeof(buff))) > 0) {
+		CHECK(len < (int)sizeof(buff));
+		CHECK(strcmp(buff + len - 2, "\r\n") == 0);
+		p = strstr(buff, "us:");
+		CHECK(p != NULL);
+		if (!p)
+			return;
+		res->lost = strtoul(buff + strlen("Pulses lost:"), NULL, 10);
+		p += 3;
+		for (;;) {
+			stamp = strtoull(p, &end, 10);
+			if (end == p)
+				break;
+			p = end;
+			if (expect_tail == expect_head ||
+			    stamp != expect[expect_tail++ &
+					    (GEIGER_LOG_SIZE - 1)])
+				res->bad_stamps++;
+			res->stamps++;
+		}
+	}
+}
+
+/*
+ * Simulate seconds of pulses at rate, taking a measurement every
+ * SAMPLING_PERIOD seconds once the window is full. With flush_every set, the
+ * log is flushed that often and every timestamp checked.
+ */
+static void run(double rate, uint32_t seconds, enum geiger_window window,
+		uint32_t flush_every, struct run_result *res)
+{
+	struct geiger_counter *counter = counter_init(window);
+	double t = 0, blind = 0, sum = 0, sum2 = 0;
+	uint64_t tick_cycles = 0;
+	uint32_t sec, count, measures = 0, filled, w, i;
+
+	memset(res, 0, sizeof(*res));
+	if (!counter)
+		return;
+
+	expect_head = expect_tail = 0;
+	t = -log(rnd_unit()) / rate;
+	for (sec = 0; sec < seconds; sec++) {
+		count = 0;
+		for (; t < sec + 1; t += -log(rnd_unit()) / rate) {
+			if (t < blind)
+				continue;
+			blind = t + DEAD_TIME;
+			set_time(t);
+			pulse_callback.legacy_callback(pulse_callback.ctx, 0,
+						       NULL);
+			/* What get_timestamp() should read */
+			if (expect_head - expect_tail < GEIGER_LOG_SIZE)
+				expect[expect_head++ & (GEIGER_LOG_SIZE - 1)] =
+					(uint64_t)sec * 1000000 +
+					(now_cycles - tick_cycles) /
+					(HCLK / 1000000);
+			count++;
+		}
+		set_time(sec + 1);
+		tick_cycles = now_cycles;
+		geiger_counter_tick(counter);
+
+		second_counts[sec] = count;
+		res->recorded += count;
+		sum += count;
+		sum2 += (double)count * count;
+
+		/* Running sums against a brute force sum */
+		for (w = 0; w < GEIGER_WINDOW_NB; w++) {
+			filled = (sec + 1 < window_len[w]) ? sec + 1 :
+				 window_len[w];
+			count = 0;
+			for (i = 0; i < filled; i++)
+				count += second_counts[sec - i];
+			res->bad_sums += counter->sum[w] != count;
+		}
+
+		if ((sec + 1) % SAMPLING_PERIOD == 0 &&
+		    sec + 1 >= window_len[window]) {
+			calculate_CPM(counter);
+			res->cpm += counter->count_per_minute;
+			res->raw_cpm += counter->raw_count_per_minute;
+			measures++;
+		}
+
+		if (flush_every && (sec + 1) % flush_every == 0)
+			flush_log(counter, res);
+	}
+
+	res->seconds = seconds;
+	res->cpm /= measures;
+	res->raw_cpm /= measures;
+	res->dispersion = (sum2 / seconds - (sum / seconds) *
+			   (sum / seconds)) / (sum / seconds);
+	res->saturated = counter->saturated;
+	CHECK(counter->count == res->recorded);
+	CHECK(expect_head == expect_tail || !flush_every);
+	delete_geiger_counter(counter);
+}
+
+static void test_dead_time(void)
+{
+	static const double rates[] = {0.5, 5, 50, 500, 2000, 5000};
+	struct run_result res;
+	double m, err, raw_err, sigma;
+	uint32_t i, seconds;
+
+	printf("  true cps   recorded   CPM error   raw error   var/mean "
+	       "(theory)\n");
+	for (i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+		/* Enough seconds for 100000 pulses, at least 20 minutes */
+		seconds = 100000 / rates[i];
+		if (seconds < 1200)
+			seconds = 1200;
+		if (seconds > MAX_SECONDS)
+			seconds = MAX_SECONDS;
+		run(rates[i], seconds, GEIGER_WINDOW_60S, 0, &res);
+
+		/* Recorded rate of a non paralyzable counter */
+		m = rates[i] / (1 + rates[i] * DEAD_TIME);
+		sigma = 1 / sqrt(res.recorded);
+		err = res.cpm / (rates[i] * 60) - 1;
+		raw_err = res.raw_cpm / (rates[i] * 60) - 1;
+		printf("  %8.1f %10.1f %+10.2f%% %+10.2f%% %8.3f (%.3f)\n",
+		       rates[i], (double)res.recorded / res.seconds,
+		       100 * err, 100 * raw_err, res.dispersion,
+		       1 / pow(1 + rates[i] * DEAD_TIME, 2));
+
+		CHECK(res.bad_sums == 0);
+		/* The simulated train itself */
+		CHECK(fabs((double)res.recorded / res.seconds / m - 1) <
+		      4 * sigma);
+		CHECK(fabs(res.dispersion * pow(1 + rates[i] * DEAD_TIME, 2) -
+			   1) < 0.05);
+		/*
+		 * The corrected CPM within the statistics and the rounding of
+		 * the CPM to a whole count
+		 */
+		CHECK(fabs(err) < 4 * sigma + 0.5 / (rates[i] * 60));
+		/* Without the correction the loss shows at high rates */
+		if (rates[i] * DEAD_TIME > 0.1)
+			CHECK(raw_err < -0.08);
+	}
+}
+
+static void test_timestamps(void)
+{
+	struct run_result res;
+
+	/* 5 cps for 2 hours, flushing every 10 s */
+	run(5, 7200, GEIGER_WINDOW_60S, SAMPLING_PERIOD, &res);
+	CHECK(res.bad_stamps == 0 && res.lost == 0);
+	CHECK(res.stamps == res.recorded);
+	printf("%llu timestamps over %u s, %u wrong\n",
+	       (unsigned long long)res.stamps, res.seconds, res.bad_stamps);
+
+	/* 100 cps, the log overflows between two flushes */
+	run(100, 120, GEIGER_WINDOW_10S, SAMPLING_PERIOD, &res);
+	CHECK(res.bad_stamps == 0);
+	CHECK(res.stamps == 12 * GEIGER_LOG_SIZE);
+	CHECK(res.lost > 0 && res.lost == res.recorded - res.stamps);
+}
+
+static void test_windows(void)
+{
+	struct geiger_counter *counter = counter_init(GEIGER_WINDOW_1S);
+	struct run_result res;
+	uint32_t sec, i;
+
+	if (!counter)
+		return;
+
+	CHECK(geiger_counter_set_window(counter, GEIGER_WINDOW_NB) ==
+	      -EINVAL);
+
+	/* 10 pulses per second for 30 s then none */
+	for (sec = 0; sec < 90; sec++) {
+		for (i = 0; sec < 30 && i < 10; i++)
+			geiger_counter_pulse(counter, sec * 1000000ull + i);
+		geiger_counter_tick(counter);
+		if (sec == 4) {
+			/* The 60 s window averages over the 5 s available */
+			CHECK(geiger_counter_set_window(counter,
+						GEIGER_WINDOW_60S) == SUCCESS);
+			calculate_CPM(counter);
+			CHECK(counter->raw_count_per_minute == 600);
+		}
+	}
+	/* Last 60 s: 30 s without pulses, the window still holds 0 */
+	calculate_CPM(counter);
+	CHECK(counter->raw_count_per_minute == 0);
+	CHECK(counter->count == 300);
+	delete_geiger_counter(counter);
+
+	/* Saturated tube */
+	run(1e6, SAMPLING_PERIOD, GEIGER_WINDOW_1S, 0, &res);
+	CHECK(res.raw_cpm > 0.9 * 60 / DEAD_TIME && res.saturated);
+}
+
+int main(void)
+{
+	test_dead_time();
+	test_timestamps();
+	test_windows();
+
+	printf(failures ? "FAILED\n" : "OK\n");
+
+	return failures ? 1 : 0;
+}
@@ -38,6 +38,7 @@
 *******************************************************************************/
 
 #include <sys/platform.h>
+#include <string.h>
 #include "adi_initialize.h"
 #include "no_os_spi.h"
 #include "spi_extra.h"
@@ -49,6 +50,123 @@
 #include "platform_init.h"
 #include "no_os_util.h"
 #include "app_config.h"
+#include "iio_stream.h"
+
+/** Number of AD7798 input channels */
+#define CN0548_NB_CH		3
+/** Sample sets in each half of the stream double buffer */
+#define STREAM_HALF_SIZE	32
+/** Producer rate, above the update rate of all channels together */
+#define STREAM_POLL_HZ		100
+
+static uint32_t in_buff[STREAM_HALF_SIZE * CN0548_NB_CH];
+
+/**
+ * @struct cn0548_stream
+ * @brief State of the channel round robin
+ */
+struct cn0548_stream {
+	struct ad7799_dev *dev;
+	/** Channels enabled by the client */
+	uint32_t mask;
+	/** Channel being converted */
+	uint8_t ch;
+	/** Sample set being assembled */
+	uint32_t set[CN0548_NB_CH];
+};
+
+/**
+ * @brief Get the enabled channel following ch.
+ * @param [in] stream - The round robin state.
+ * @param [in] ch - Current channel.
+ * @return Next enabled channel, ch if it is the only one.
+ */
+static uint8_t cn0548_stream_next_ch(struct cn0548_stream *stream, uint8_t ch)
+{
+	uint8_t i;
+
+	for (i = 1; i <= CN0548_NB_CH; i++)
+		if (stream->mask & (1u << ((ch + i) % CN0548_NB_CH)))
+			return (ch + i) % CN0548_NB_CH;
+
+	return ch;
+}
+
+/**
+ * @brief Start continuous conversions on the first enabled channel.
+ * @param [in] dev - The round robin state.
+ * @param [in] mask - Channels enabled by the client.
+ * @return 0 in case of success, negative code otherwise.
+ */
+static int32_t cn0548_stream_start(void *dev, uint32_t mask)
+{
+	struct cn0548_stream *stream = dev;
+	int32_t ret;
+
+	if (!mask)
+		return -EINVAL;
+
+	stream->mask = mask;
+	stream->ch = cn0548_stream_next_ch(stream, CN0548_NB_CH - 1);
+
+	ret = ad7799_set_channel(stream->dev, stream->ch);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	return ad7799_set_mode(stream->dev, AD7799_MODE_CONT);
+}
+
+/**
+ * @brief Stop conversions.
+ * @param [in] dev - The round robin state.
+ * @return 0 in case of success, negative code otherwise.
+ */
+static int32_t cn0548_stream_stop(void *dev)
+{
+	struct cn0548_stream *stream = dev;
+
+	return ad7799_set_mode(stream->dev, AD7799_MODE_IDLE);
+}
+
+/**
+ * @brief Read the conversion if ready and move to the next enabled channel.
+ * @param [in] dev - The round robin state.
+ * @param [out] set - One word for each channel.
+ * @return 1 if the last enabled channel completed a set, 0 if not,
+ *         negative code otherwise.
+ */
+static int32_t cn0548_stream_poll(void *dev, uint32_t *set)
+{
+	struct cn0548_stream *stream = dev;
+	uint32_t status;
+	uint8_t next;
+	int32_t ret;
+
+	ret = ad7799_read(stream->dev, AD7799_REG_STAT, &status);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+	if (status & AD7799_STAT_RDY)
+		return 0;
+
+	ret = ad7799_read(stream->dev, AD7799_REG_DATA,
+			  &stream->set[stream->ch]);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	next = cn0548_stream_next_ch(stream, stream->ch);
+	if (next != stream->ch) {
+		ret = ad7799_set_channel(stream->dev, next);
+		if (NO_OS_IS_ERR_VALUE(ret))
+			return ret;
+	}
+	/* Wrapping around means all enabled channels were converted */
+	ret = next <= stream->ch;
+	stream->ch = next;
+	if (ret)
+		memcpy(set, stream->set, sizeof(stream->set));
+
+	return ret;
+}
 
 int main(int argc, char *argv[])
 {
@@ -93,10 +211,36 @@ int main(int argc, char *argv[])
 	if (NO_OS_IS_ERR_VALUE(ret))
 		return ret;
 
+	struct cn0548_stream cn0548_stream = {
+		.dev = ad7799_device
+	};
+
+	struct iio_stream_init_param stream_param = {
+		.dev = &cn0548_stream,
+		.descriptor = &ad7799_iio_descriptor,
+		.nb_ch = CN0548_NB_CH,
+		.half_size = STREAM_HALF_SIZE,
+		.poll_hz = STREAM_POLL_HZ,
+		.start = cn0548_stream_start,
+		.stop = cn0548_stream_stop,
+		.poll = cn0548_stream_poll
+	};
+
+	struct iio_stream *stream;
+
+	ret = iio_stream_init(&stream, &stream_param);
+	if (NO_OS_IS_ERR_VALUE(ret))
+		return ret;
+
+	struct iio_data_buffer rd_buf = {
+		.buff = in_buff,
+		.size = sizeof(in_buff)
+	};
+
 	struct iio_app_device devices[] = {
 		IIO_APP_DEVICE("AD7799", ad7799_device,
-			       &ad7799_iio_descriptor,
-			       NULL, NULL)
+			       &stream->descriptor,
+			       &rd_buf, NULL)
 	};
 
 	return iio_app_run(devices, NO_OS_ARRAY_SIZE(devices));
@@ -0,0 +1,176 @@
+/***************************************************************************//**
+ *   @file   iio_stream.h
+ *   @brief  Buffered IIO streaming header file
+********************************************************************************
+ * Copyright 2021(c) Analog Devices, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *  - Neither the name of Analog Devices, Inc. nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *  - The use of this software may or may not infringe the patent rights
+ *    of one or more patent holders.  This license does not release you
+ *    from the requirement that you obtain separate licenses from these
+ *    patent holders to use this software.
+ *  - Use of the software either in source or binary form, must be run
+ *    on or directly connected to an Analog Devices Inc. component.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ANALOG DEVICES "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, NON-INFRINGEMENT,
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ANALOG DEVICES BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, INTELLECTUAL PROPERTY RIGHTS, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef IIO_STREAM_H_
+#define IIO_STREAM_H_
+
+/******************************************************************************/
+/***************************** Include Files **********************************/
+/******************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "iio_types.h"
+
+/******************************************************************************/
+/********************** Macros and Constants Definitions **********************/
+/******************************************************************************/
+
+/** Maximum number of words in a sample set */
+#define IIO_STREAM_MAX_CH	8
+
+/******************************************************************************/
+/*************************** Types Declarations *******************************/
+/******************************************************************************/
+
+/**
+ * @enum iio_stream_half_state
+ * @brief State of each half of the double buffer
+ */
+enum iio_stream_half_state {
+	/** Owned by the producer, being filled */
+	IIO_STREAM_FILLING,
+	/** Full, waiting for the consumer */
+	IIO_STREAM_READY,
+	/** Emptied by the consumer */
+	IIO_STREAM_FREE
+};
+
+/**
+ * @struct iio_stream_init_param
+ * @brief Stream initialization structure
+ */
+struct iio_stream_init_param {
+	/** Device passed to the callbacks below */
+	void *dev;
+	/** IIO descriptor of the device, read_dev is replaced by the stream */
+	struct iio_device *descriptor;
+	/** Number of words in a sample set, one per IIO channel */
+	uint32_t nb_ch;
+	/** Number of sample sets in each half of the double buffer */
+	uint32_t half_size;
+	/** Rate of the producer interrupt, 25 to 1000 Hz */
+	uint32_t poll_hz;
+	/** Start conversions on the channels in mask */
+	int32_t (*start)(void *dev, uint32_t mask);
+	/** Stop conversions */
+	int32_t (*stop)(void *dev);
+	/**
+	 * Read one sample set if the device has one ready. Called from the
+	 * producer interrupt, returns 1 when set was filled, 0 when no data is
+	 * ready, negative code on error.
+	 */
+	int32_t (*poll)(void *dev, uint32_t *set);
+};
+
+/**
+ * @struct iio_stream
+ * @brief Stream handler structure
+ */
+struct iio_stream {
+	/** Copy of the device descriptor with the buffered callbacks */
+	struct iio_device descriptor;
+	/** Device and callbacks */
+	void *dev;
+	int32_t (*start)(void *dev, uint32_t mask);
+	int32_t (*stop)(void *dev);
+	int32_t (*poll)(void *dev, uint32_t *set);
+	uint32_t nb_ch;
+	uint32_t half_size;
+	uint32_t poll_hz;
+	/** Double buffer, half_size sample sets of nb_ch words each */
+	uint32_t *half[2];
+	volatile enum iio_stream_half_state state[2];
+	/** Timestamp in microseconds of the first sample set of each half */
+	volatile uint32_t timestamp[2];
+	/** Half and position written by the producer */
+	uint32_t wr_half;
+	uint32_t wr_pos;
+	/** Half and position read by the consumer */
+	uint32_t rd_half;
+	uint32_t rd_pos;
+	/** Channels enabled by the client */
+	uint32_t mask;
+	volatile bool running;
+	/** Times the producer found no free half */
+	volatile uint32_t overruns;
+	/** Sample sets lost because of overruns */
+	volatile uint32_t dropped;
+	/** Failed poll() calls */
+	volatile uint32_t errors;
+	/** Extension of the cycle counter to 64 bits */
+	uint32_t cycles_hi;
+	uint32_t cycles_last;
+	uint32_t cycles_per_us;
+	/** Device attributes followed by the stream ones */
+	struct iio_attribute *attributes;
+	/** Copy of the device channels, with their attributes in ch_attributes */
+	struct iio_channel *channels;
+	struct iio_attribute *ch_attributes;
+	/** Device and channel attributes wrapped by the stream, by priv */
+	struct iio_attribute **dev_attr;
+	/** Device register access, only called while the producer is stopped */
+	int32_t (*debug_reg_read)(void *dev, uint32_t reg, uint32_t *readval);
+	int32_t (*debug_reg_write)(void *dev, uint32_t reg, uint32_t writeval);
+};
+
+/******************************************************************************/
+/************************ Functions Declarations ******************************/
+/******************************************************************************/
+
+/** Allocate a stream and its double buffer. */
+int32_t iio_stream_init(struct iio_stream **stream,
+			struct iio_stream_init_param *param);
+
+/** Free memory allocated by iio_stream_init(). */
+int32_t iio_stream_remove(struct iio_stream *stream);
+
+/** Start the producer on the channels in mask. */
+int32_t iio_stream_start(struct iio_stream *stream, uint32_t mask);
+
+/** Stop the producer. */
+int32_t iio_stream_stop(struct iio_stream *stream);
+
+/** Move the sample sets ready in the device to the double buffer. */
+void iio_stream_produce(struct iio_stream *stream, uint32_t timestamp);
+
+/** Copy nb_samples sample sets of the enabled channels to buff. */
+int32_t iio_stream_read(struct iio_stream *stream, uint32_t *buff,
+			uint32_t nb_samples);
+
+#endif /* IIO_STREAM_H_ */
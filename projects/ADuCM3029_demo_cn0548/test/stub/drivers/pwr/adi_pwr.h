@@ -0,0 +1,16 @@
+/* Host replacement of the power driver header */
+
+#include <stdint.h>
+
+typedef enum {
+	ADI_PWR_SUCCESS,
+	ADI_PWR_FAILURE
+} ADI_PWR_RESULT;
+
+typedef enum {
+	ADI_CLOCK_HCLK,
+	ADI_CLOCK_PCLK
+} ADI_CLOCK_ID;
+
+ADI_PWR_RESULT adi_pwr_GetClockFrequency(ADI_CLOCK_ID clock,
+					 uint32_t *freq);
@@ -0,0 +1,49 @@
+/* Host replacement of the GP timer driver header */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef void (*ADI_CALLBACK)(void *param, uint32_t event, void *arg);
+
+typedef enum {
+	ADI_TMR_SUCCESS,
+	ADI_TMR_DEVICE_BUSY,
+	ADI_TMR_BAD_DEVICE_NUM
+} ADI_TMR_RESULT;
+
+typedef enum {
+	ADI_TMR_DEVICE_GP0,
+	ADI_TMR_DEVICE_GP1,
+	ADI_TMR_DEVICE_GP2
+} ADI_TMR_DEVICE;
+
+typedef enum {
+	ADI_TMR_PRESCALER_1,
+	ADI_TMR_PRESCALER_16,
+	ADI_TMR_PRESCALER_64,
+	ADI_TMR_PRESCALER_256
+} ADI_TMR_PRESCALER;
+
+typedef enum {
+	ADI_TMR_CLOCK_PCLK,
+	ADI_TMR_CLOCK_HFOSC,
+	ADI_TMR_CLOCK_LFOSC,
+	ADI_TMR_CLOCK_LFXTAL
+} ADI_TMR_CLOCK_SOURCE;
+
+typedef struct {
+	bool bCountingUp;
+	bool bPeriodic;
+	ADI_TMR_PRESCALER ePrescaler;
+	ADI_TMR_CLOCK_SOURCE eClockSource;
+	uint16_t nLoad;
+	uint16_t nAsyncLoad;
+	bool bReloading;
+	bool bSyncBypass;
+} ADI_TMR_CONFIG;
+
+ADI_TMR_RESULT adi_tmr_Init(ADI_TMR_DEVICE eDevice, ADI_CALLBACK pfCallback,
+			    void *pCBParam, bool bEnableInt);
+ADI_TMR_RESULT adi_tmr_ConfigTimer(ADI_TMR_DEVICE eDevice,
+				   ADI_TMR_CONFIG *pConfig);
+ADI_TMR_RESULT adi_tmr_Enable(ADI_TMR_DEVICE eDevice, bool bEnable);
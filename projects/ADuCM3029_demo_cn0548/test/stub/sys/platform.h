@@ -0,0 +1,30 @@
+/* Host replacement of the core registers used by iio_stream.c */
+
+#include <stdint.h>
+
+typedef struct {
+	volatile uint32_t CTRL;
+	volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+	volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef enum {
+	TMR1_EVT_IRQn = 4
+} IRQn_Type;
+
+/* Defined by the test, which runs the cycle counter */
+extern DWT_Type dwt_model;
+extern CoreDebug_Type core_debug_model;
+
+#define DWT				(&dwt_model)
+#define CoreDebug			(&core_debug_model)
+#define DWT_CTRL_CYCCNTENA_Msk		1u
+#define CoreDebug_DEMCR_TRCENA_Msk	(1u << 24)
+#define __NVIC_PRIO_BITS		3
+
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority)
+{
+}
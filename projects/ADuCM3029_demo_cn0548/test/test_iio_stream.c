@@ -0,0 +1,465 @@
+/* Host loopback test of the IIO stream double buffer with an AD7798 model
+ *
+ * The device is a model of the AD7798 in continuous conversion mode, with the
+ * enabled channels read in turn like cn0548_stream_poll() does: a conversion
+ * is ready one update period after the channel is selected, and a sample set
+ * is complete when the round robin wraps around. The producer runs from the
+ * GP timer callback at the rate programmed in the timer, with a model of the
+ * DWT cycle counter for the timestamps. The client reads one half of the
+ * double buffer at a time through read_dev, then spends the time the UART
+ * needs to send it.
+ *
+ * Every conversion carries the number of its round, so the test checks that
+ * the client gets whole sets in order and that every set missing is counted
+ * in stream_dropped. It prints the throughput for a few update rates, channel
+ * masks and baud rates.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/platform.h>
+#include <drivers/tmr/adi_tmr.h>
+#include <drivers/pwr/adi_pwr.h>
+#include "no_os_error.h"
+#include "iio_stream.h"
+
+static int failures;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while (0)
+
+#define HCLK		26000000u
+/* Same settings as cn0548.c */
+#define NB_CH		3
+#define HALF_SIZE	32
+#define POLL_HZ		100
+/* IIO command and response header around each block, in bytes */
+#define BLOCK_OVERHEAD	40
+
+DWT_Type dwt_model;
+CoreDebug_Type core_debug_model;
+
+/* Simulated time in microseconds, it goes on from one test to the next */
+static uint64_t now;
+
+ADI_PWR_RESULT adi_pwr_GetClockFrequency(ADI_CLOCK_ID clock, uint32_t *freq)
+{
+	*freq = HCLK;
+
+	return ADI_PWR_SUCCESS;
+}
+
+/* GP timer model */
+static ADI_CALLBACK tmr_callback;
+static void *tmr_param;
+static uint32_t tmr_period_us;
+static bool tmr_enabled;
+
+ADI_TMR_RESULT adi_tmr_Init(ADI_TMR_DEVICE eDevice, ADI_CALLBACK pfCallback,
+			    void *pCBParam, bool bEnableInt)
+{
+	CHECK(eDevice == ADI_TMR_DEVICE_GP1);
+	tmr_callback = pfCallback;
+	tmr_param = pCBParam;
+
+	return ADI_TMR_SUCCESS;
+}
+
+ADI_TMR_RESULT adi_tmr_ConfigTimer(ADI_TMR_DEVICE eDevice,
+				   ADI_TMR_CONFIG *pConfig)
+{
+	CHECK(pConfig->ePrescaler == ADI_TMR_PRESCALER_16 &&
+	      pConfig->eClockSource == ADI_TMR_CLOCK_HFOSC);
+	tmr_period_us = pConfig->nLoad * 16 / (HCLK / 1000000);
+
+	return ADI_TMR_SUCCESS;
+}
+
+ADI_TMR_RESULT adi_tmr_Enable(ADI_TMR_DEVICE eDevice, bool bEnable)
+{
+	tmr_enabled = bEnable;
+
+	return ADI_TMR_SUCCESS;
+}
+
+/* AD7798 model */
+struct device {
+	/* Update period in microseconds */
+	uint32_t period_us;
+	/* Time the conversion of the selected channel is ready */
+	uint64_t ready_at;
+	uint32_t mask;
+	uint8_t ch;
+	/* Round of the next set and set being assembled */
+	uint32_t seq;
+	uint32_t set[NB_CH];
+	bool sampling;
+	uint32_t reg;
+};
+
+static uint8_t dev_next_ch(struct device *d, uint8_t ch)
+{
+	uint8_t i;
+
+	for (i = 1; i <= NB_CH; i++)
+		if (d->mask & (1u << ((ch + i) % NB_CH)))
+			return (ch + i) % NB_CH;
+
+	return ch;
+}
+
+/* Selecting a channel restarts the conversion */
+static void dev_select(struct device *d, uint8_t ch)
+{
+	d->ch = ch;
+	d->ready_at = now + d->period_us;
+}
+
+static int32_t dev_start(void *dev, uint32_t mask)
+{
+	struct device *d = dev;
+
+	if (!mask)
+		return -EINVAL;
+
+	d->mask = mask;
+	dev_select(d, dev_next_ch(d, NB_CH - 1));
+	d->sampling = true;
+
+	return 0;
+}
+
+static int32_t dev_stop(void *dev)
+{
+	struct device *d = dev;
+
+	d->sampling = false;
+
+	return 0;
+}
+
+static int32_t dev_poll(void *dev, uint32_t *set)
+{
+	struct device *d = dev;
+	uint8_t next;
+	int32_t ret;
+
+	if (!d->sampling || now < d->ready_at)
+		return 0;
+
+	d->set[d->ch] = d->seq * NB_CH + d->ch;
+	next = dev_next_ch(d, d->ch);
+	ret = next <= d->ch;
+	if (next != d->ch)
+		dev_select(d, next);
+	else
+		/* Conversions missed between two polls are overwritten */
+		d->ready_at += ((now - d->ready_at) / d->period_us + 1) *
+			       d->period_us;
+	if (ret) {
+		memcpy(set, d->set, sizeof(d->set));
+		d->seq++;
+	}
+
+	return ret;
+}
+
+static int dev_attr_show(void *device, char *buf, uint32_t len,
+			 const struct iio_ch_info *channel, intptr_t priv)
+{
+	return snprintf(buf, len, "%d", (int)priv);
+}
+
+static int dev_attr_store(void *device, char *buf, uint32_t len,
+			  const struct iio_ch_info *channel, intptr_t priv)
+{
+	return len;
+}
+
+static int32_t dev_reg_read(void *dev, uint32_t reg, uint32_t *readval)
+{
+	*readval = ((struct device *)dev)->reg;
+
+	return 0;
+}
+
+static struct iio_attribute dev_attributes[] = {
+	{ .name = "sampling_frequency", .priv = 7, .show = dev_attr_show,
+	  .store = dev_attr_store },
+	{ .name = NULL }
+};
+
+static struct iio_attribute ch_attributes[] = {
+	{ .name = "raw", .priv = 9, .show = dev_attr_show },
+	{ .name = NULL }
+};
+
+static struct iio_channel channels[NB_CH];
+
+static struct iio_device descriptor = {
+	.num_ch = NB_CH,
+	.channels = channels,
+	.attributes = dev_attributes,
+	.debug_reg_read = dev_reg_read,
+};
+
+static struct device device;
+
+static struct iio_stream *stream_init(void)
+{
+	struct iio_stream_init_param param = {
+		.dev = &device,
+		.descriptor = &descriptor,
+		.nb_ch = NB_CH,
+		.half_size = HALF_SIZE,
+		.poll_hz = POLL_HZ,
+		.start = dev_start,
+		.stop = dev_stop,
+		.poll = dev_poll
+	};
+	struct iio_stream *stream = NULL;
+	uint32_t i;
+
+	for (i = 0; i < NB_CH; i++) {
+		channels[i].channel = i;
+		channels[i].attributes = ch_attributes;
+	}
+	CHECK(iio_stream_init(&stream, &param) == 0);
+
+	return stream;
+}
+
+static struct iio_attribute *find_attr(struct iio_attribute *attr,
+				       const char *name)
+{
+	for (; attr->name; attr++)
+		if (!strcmp(attr->name, name))
+			return attr;
+
+	return NULL;
+}
+
+static uint32_t read_attr(struct iio_stream *stream, const char *name)
+{
+	struct iio_attribute *attr = find_attr(stream->descriptor.attributes,
+					       name);
+	char buf[16];
+
+	CHECK(attr && attr->show(&device, buf, sizeof(buf), NULL,
+				 attr->priv) > 0);
+
+	return attr ? strtoul(buf, NULL, 10) : 0;
+}
+
+struct result {
+	uint32_t delivered;
+	uint32_t dropped;
+	uint32_t overruns;
+	uint32_t missing;
+	uint32_t disorder;
+	uint32_t bad_stamps;
+};
+
+/*
+ * Stream for seconds at rate conversions per second to a client reading the
+ * channels in mask over a UART at baud.
+ */
+static void loopback(struct iio_stream *stream, uint32_t rate, uint32_t baud,
+		     uint32_t mask, uint32_t seconds, struct result *res)
+{
+	static uint32_t buff[HALF_SIZE * NB_CH];
+	struct iio_device *desc = &stream->descriptor;
+	uint64_t t, end = now + seconds * 1000000ull;
+	uint64_t next_tick, client_free = now;
+	uint32_t nb_en = __builtin_popcount(mask);
+	uint32_t expect = device.seq, stamp, last_stamp = 0;
+	uint32_t i, ch, seq, block_us, max_age;
+
+	memset(res, 0, sizeof(*res));
+	device.period_us = 1000000 / rate;
+	CHECK(desc->prepare_transfer(&device, mask) == 0);
+	CHECK(tmr_enabled && tmr_period_us == 1000000 / POLL_HZ);
+	next_tick = now + tmr_period_us;
+	block_us = (uint64_t)(HALF_SIZE * nb_en * 4 + BLOCK_OVERHEAD) * 10 *
+		   1000000 / baud;
+	/*
+	 * Filling a half takes a conversion and a poll period per channel and
+	 * set at most. When the client is slow the next half starts while the
+	 * ready one waits for it, so the client may take two block times more.
+	 */
+	max_age = HALF_SIZE * nb_en * (device.period_us + tmr_period_us) +
+		  2 * block_us;
+
+	for (t = now; t < end; t++) {
+		now = t;
+		dwt_model.CYCCNT = (uint32_t)(t * (HCLK / 1000000));
+		if (t == next_tick) {
+			if (tmr_enabled)
+				tmr_callback(tmr_param, 0, NULL);
+			next_tick += tmr_period_us;
+		}
+		if (t < client_free ||
+		    stream->state[stream->rd_half] != IIO_STREAM_READY)
+			continue;
+
+		/* The client takes one half and sends it */
+		stamp = read_attr(stream, "stream_timestamp_us");
+		if (stamp < last_stamp || stamp > t || stamp + max_age < t)
+			res->bad_stamps++;
+		last_stamp = stamp;
+		CHECK(desc->read_dev(&device, buff, HALF_SIZE) == HALF_SIZE);
+		for (i = 0; i < HALF_SIZE; i++) {
+			seq = buff[i * nb_en] / NB_CH;
+			for (ch = 0; ch < NB_CH; ch++)
+				if (mask & (1u << ch))
+					res->disorder += *(buff + i * nb_en +
+						__builtin_popcount(mask &
+						((1u << ch) - 1))) !=
+						seq * NB_CH + ch;
+			if (seq < expect)
+				res->disorder++;
+			else
+				res->missing += seq - expect;
+			expect = seq + 1;
+		}
+		res->delivered += HALF_SIZE;
+		client_free = t + block_us;
+	}
+
+	now = end;
+	res->dropped = read_attr(stream, "stream_dropped");
+	res->overruns = read_attr(stream, "stream_overruns");
+	CHECK(desc->end_transfer(&device) == 0);
+	CHECK(!tmr_enabled && !device.sampling);
+
+	/*
+	 * Every set missing at the client was counted as dropped, and the
+	 * sets polled after the last one delivered were dropped or are still
+	 * buffered
+	 */
+	CHECK(res->missing <= res->dropped);
+	CHECK(device.seq - expect >= res->dropped - res->missing);
+	CHECK(device.seq - expect - (res->dropped - res->missing) <=
+	      2 * HALF_SIZE);
+	CHECK(res->disorder == 0);
+	CHECK(res->bad_stamps == 0);
+	CHECK(stream->errors == 0);
+}
+
+static void test_throughput(struct iio_stream *stream)
+{
+	static const uint32_t rates[] = {17, 123, 470};
+	static const uint32_t masks[] = {0x1, 0x7};
+	static const uint32_t bauds[] = {115200, 2400};
+	const uint32_t seconds = 30;
+	const uint32_t tick_us = 1000000 / POLL_HZ;
+	struct result res;
+	uint32_t i, j, k, nb_en, ticks;
+	double sets, bits, uart;
+
+	printf("  rate mask   baud  delivered/s  dropped  overruns\n");
+	for (i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+		for (j = 0; j < sizeof(masks) / sizeof(masks[0]); j++) {
+			for (k = 0; k < sizeof(bauds) / sizeof(bauds[0]); k++) {
+				loopback(stream, rates[i], bauds[k], masks[j],
+					 seconds, &res);
+				printf("%6u  0x%x %6u %12.1f %8u %9u\n",
+				       rates[i], masks[j], bauds[k],
+				       (double)res.delivered / seconds,
+				       res.dropped, res.overruns);
+
+				/*
+				 * Sets per second the device gives: a single
+				 * channel converts continuously and one result
+				 * is read per poll at most, each channel
+				 * change waits for a whole conversion
+				 */
+				nb_en = __builtin_popcount(masks[j]);
+				if (nb_en == 1) {
+					sets = rates[i] < POLL_HZ ?
+					       rates[i] : POLL_HZ;
+				} else {
+					ticks = (1000000 / rates[i] +
+						 tick_us - 1) / tick_us;
+					sets = 1e6 / (ticks * tick_us) / nb_en;
+				}
+				/* Sets per second the UART carries */
+				bits = (nb_en * 4 +
+					(double)BLOCK_OVERHEAD / HALF_SIZE) * 10;
+				uart = bauds[k] / bits;
+
+				if (sets < uart) {
+					CHECK(res.dropped == 0 &&
+					      res.overruns == 0);
+					CHECK(res.delivered + 2 * HALF_SIZE >=
+					      sets * seconds);
+					CHECK(res.delivered <=
+					      sets * seconds + 1);
+				} else {
+					/* The client gets what the UART can
+					 * carry */
+					CHECK(res.dropped > 0);
+					CHECK(res.delivered >=
+					      0.9 * uart * seconds);
+				}
+			}
+		}
+	}
+}
+
+static void test_access(struct iio_stream *stream)
+{
+	struct iio_device *desc = &stream->descriptor;
+	struct iio_attribute *attr;
+	uint32_t val;
+	char buf[16];
+
+	/* Stream attributes are appended to the device ones */
+	attr = find_attr(desc->attributes, "sampling_frequency");
+	CHECK(attr != NULL);
+	CHECK(find_attr(desc->attributes, "stream_overruns") != NULL);
+	CHECK(find_attr(desc->channels[2].attributes, "raw") != NULL);
+	if (!attr)
+		return;
+
+	/* The device is reached while stopped only */
+	CHECK(attr->show(&device, buf, sizeof(buf), NULL, attr->priv) > 0);
+	CHECK(strcmp(buf, "7") == 0);
+	device.reg = 0x55;
+	CHECK(desc->debug_reg_read(&device, 0, &val) == 0 && val == 0x55);
+
+	CHECK(desc->prepare_transfer(&device, 0x1) == 0);
+	CHECK(attr->show(&device, buf, sizeof(buf), NULL, attr->priv) ==
+	      -EBUSY);
+	CHECK(attr->store(&device, buf, 1, NULL, attr->priv) == -EBUSY);
+	CHECK(desc->debug_reg_read(&device, 0, &val) == -EBUSY);
+	attr = find_attr(desc->channels[2].attributes, "raw");
+	CHECK(attr->show(&device, buf, sizeof(buf), NULL, attr->priv) ==
+	      -EBUSY);
+	CHECK(desc->end_transfer(&device) == 0);
+	CHECK(attr->show(&device, buf, sizeof(buf), NULL, attr->priv) > 0);
+	CHECK(strcmp(buf, "9") == 0);
+
+	/* read_dev does not wait for a stopped stream */
+	CHECK(desc->read_dev(&device, buf, 1) == -EIO);
+}
+
+int main(void)
+{
+	struct iio_stream *stream = stream_init();
+
+	if (stream) {
+		test_access(stream);
+		test_throughput(stream);
+		CHECK(iio_stream_remove(stream) == 0);
+	}
+
+	printf(failures ? "FAILED\n" : "OK\n");
+
+	return failures ? 1 : 0;
+}